@@ -80,6 +80,32 @@ conscience_get_types (const char *ns, GSList **out)
 	return NULL;
 }
 
+static struct service_info_s *
+_registration_to_service_info(const char *ns, const char *type,
+		const struct oio_cs_registration_s *reg, int put_score, int get_score)
+{
+	struct service_info_s *si = g_malloc0 (sizeof(struct service_info_s));
+	g_strlcpy (si->ns_name, ns, sizeof(si->ns_name));
+	if (oio_str_is_set(reg->type)) {
+		g_strlcpy(si->type, reg->type, sizeof(si->type));
+	} else {
+		g_strlcpy(si->type, type, sizeof(si->type));
+	}
+	si->tags = g_ptr_array_new ();
+	si->put_score.value = put_score;
+	si->get_score.value = get_score;
+	service_tag_set_value_string (service_info_ensure_tag (
+				si->tags, "tag.service_id"), reg->id);
+	grid_string_to_addrinfo (reg->url, &si->addr);
+	for (const char * const *pp = reg->kv_tags;
+			reg->kv_tags && *pp && *(pp+1);
+			pp += 2) {
+		service_tag_set_value_string (service_info_ensure_tag(
+					si->tags, *pp), *(pp+1));
+	}
+	return si;
+}
+
 GError *
 conscience_get_services (const char *ns, const char *type, gboolean full,
 		GSList **out, gint64 deadline UNUSED)
@@ -93,26 +119,8 @@ conscience_get_services (const char *ns, const char *type, gboolean full,
 	GSList *l = NULL;
 	void _on_reg (const struct oio_cs_registration_s *reg, int put_score,
 			int get_score) {
-		struct service_info_s *si = g_malloc0 (sizeof(struct service_info_s));
-		g_strlcpy (si->ns_name, ns, sizeof(si->ns_name));
-		if (oio_str_is_set(reg->type)) {
-			g_strlcpy(si->type, reg->type, sizeof(si->type));
-		} else {
-			g_strlcpy(si->type, type, sizeof(si->type));
-		}
-		si->tags = g_ptr_array_new ();
-		si->put_score.value = put_score;
-		si->get_score.value = get_score;
-		service_tag_set_value_string (service_info_ensure_tag (
-					si->tags, "tag.service_id"), reg->id);
-		grid_string_to_addrinfo (reg->url, &si->addr);
-		for (const char * const *pp = reg->kv_tags;
-				reg->kv_tags && *pp && *(pp+1);
-				pp += 2) {
-			service_tag_set_value_string (service_info_ensure_tag(
-						si->tags, *pp), *(pp+1));
-		}
-		l = g_slist_prepend (l, si);
+		l = g_slist_prepend (l,
+				_registration_to_service_info(ns, type, reg, put_score, get_score));
 	}
 	GError *err = oio_cs_client__list_services (cs, type, full, _on_reg);
 	oio_cs_client__destroy (cs);
@@ -124,6 +132,51 @@ conscience_get_services (const char *ns, const char *type, gboolean full,
 	return NULL;
 }
 
+GError *
+conscience_get_services_since (const char *ns, const char *type,
+		gboolean full, const char *epoch, gint64 since,
+		struct service_delta_s *out)
+{
+	g_assert (ns != NULL);
+	g_assert (type != NULL);
+	g_assert (out != NULL);
+	memset(out, 0, sizeof(*out));
+
+	struct oio_cs_client_s *cs = oio_cs_client__create_proxied (ns);
+	struct oio_cs_generation_s gen = {
+		.epoch = g_strdup(epoch),
+		.generation = since,
+		.complete = FALSE,
+	};
+	GSList *l = NULL;
+	GPtrArray *removed = g_ptr_array_new ();
+	void _on_reg (const struct oio_cs_registration_s *reg, int put_score,
+			int get_score) {
+		l = g_slist_prepend (l,
+				_registration_to_service_info(ns, type, reg, put_score, get_score));
+	}
+	void _on_removed (const char *url) {
+		g_ptr_array_add (removed, g_strdup(url));
+	}
+	GError *err = oio_cs_client__list_services_since (cs, type, full, &gen,
+			_on_reg, _on_removed);
+	oio_cs_client__destroy (cs);
+	g_ptr_array_add (removed, NULL);
+
+	if (err) {
+		g_slist_free_full (l, (GDestroyNotify)service_info_clean);
+		g_strfreev ((gchar**) g_ptr_array_free (removed, FALSE));
+		oio_str_clean (&gen.epoch);
+		return err;
+	}
+	out->epoch = gen.epoch;
+	out->generation = gen.generation;
+	out->complete = gen.complete;
+	out->changed = l;
+	out->removed = (gchar**) g_ptr_array_free (removed, FALSE);
+	return NULL;
+}
+
 GError *
 conscience_locate_meta0(const char *ns, gchar ***result, gint64 dl)
 {
@@ -29,6 +29,14 @@ GError* conscience_get_namespace (const char *ns, struct namespace_info_s **out)
 GError* conscience_get_services (const char *ns, const char *type,
 		gboolean full, GSList **out, gint64 deadline);
 
+/* Get the services of the <type> changed since the generation <since> of
+ * the conscience identified by <epoch>. Clean <out> with
+ * service_delta_clean(). */
+struct service_delta_s;
+GError* conscience_get_services_since (const char *ns, const char *type,
+		gboolean full, const char *epoch, gint64 since,
+		struct service_delta_s *out);
+
 GError* conscience_get_types (const char *ns, GSList **out);
 
 /* Variant of conscience_get_services() dedicated to meta0 and suitable
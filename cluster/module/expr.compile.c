@@ -0,0 +1,384 @@
+/*
+OpenIO SDS metautils
+Copyright (C) 2025 OVH SAS
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 3.0 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+*/
+
+#include <math.h>
+
+#include <metautils/lib/metautils.h>
+#include "expr.h"
+
+#define FPcmp(ret,d1,d2) do {\
+	if (d1<d2) { ret=-1; }\
+	else if (d1>d2) { ret=1; }\
+	else { ret=0;  }\
+} while (0);
+
+#define FPBOOL(D) ((D>0.0)||(D<0.0))
+
+/* The opcodes are the types of the nodes of the expression. VAL_NUM_ET
+ * pushes a constant, ACC_ET pushes the value of a slot, the operators
+ * pop their operands and push their result. NB_ET makes the result
+ * undefined. */
+struct expr_insn_s
+{
+	enum expr_type_e op;
+	unsigned int slot;
+	gboolean has_fallback;
+	double num;  /* the constant, or the fallback of the slot */
+};
+
+struct expr_program_s
+{
+	unsigned int nb_slots;
+	gchar *slots[EXPR_PROGRAM_MAX_SLOTS];
+	unsigned int nb_insn;
+	struct expr_insn_s insn[];
+};
+
+struct expr_builder_s
+{
+	GArray *insn;
+	GPtrArray *slots;
+	const char * const *bases;
+	unsigned int depth;
+};
+
+static gboolean
+_emit(struct expr_builder_s *b, struct expr_insn_s *insn,
+		unsigned int popped)
+{
+	g_array_append_vals(b->insn, insn, 1);
+	b->depth = b->depth - popped + 1;
+	return b->depth <= EXPR_PROGRAM_MAX_DEPTH;
+}
+
+static gboolean
+_emit_num(struct expr_builder_s *b, double num)
+{
+	struct expr_insn_s insn = {.op = VAL_NUM_ET, .num = num};
+	return _emit(b, &insn, 0);
+}
+
+static gboolean
+_emit_load(struct expr_builder_s *b, struct expr_s *pE)
+{
+	if (!pE->expr.acc.base || !pE->expr.acc.field)
+		return FALSE;
+
+	/* As expr_evaluate() does with a base it has no accessor for: the
+	 * result is undefined, but with a fallback the value is left as is,
+	 * i.e. zero. */
+	if (!b->bases || !g_strv_contains((const gchar * const *) b->bases,
+				pE->expr.acc.base)) {
+		if (pE->expr.acc.fallback)
+			return _emit_num(b, 0.0);
+		struct expr_insn_s insn = {.op = NB_ET};
+		return _emit(b, &insn, 0);
+	}
+
+	gchar *name = g_strconcat(pE->expr.acc.base, ".", pE->expr.acc.field, NULL);
+	struct expr_insn_s insn = {.op = ACC_ET};
+	for (insn.slot = 0; insn.slot < b->slots->len; insn.slot++) {
+		if (!strcmp(name, b->slots->pdata[insn.slot]))
+			break;
+	}
+	if (insn.slot < b->slots->len) {
+		g_free(name);
+	} else if (b->slots->len >= EXPR_PROGRAM_MAX_SLOTS) {
+		g_free(name);
+		return FALSE;
+	} else {
+		g_ptr_array_add(b->slots, name);
+	}
+
+	/* A fallback that is not a number behaves like no fallback */
+	if (pE->expr.acc.fallback) {
+		gchar *end = NULL;
+		insn.num = strtod(pE->expr.acc.fallback, &end);
+		insn.has_fallback = (end != pE->expr.acc.fallback);
+	}
+	return _emit(b, &insn, 0);
+}
+
+static gboolean
+_compile(struct expr_builder_s *b, struct expr_s *pE)
+{
+	if (!pE)
+		return FALSE;
+	CHK_TYPE(pE->type, return FALSE);
+
+	struct expr_insn_s insn = {.op = pE->type};
+	switch (pE->type) {
+	case VAL_NUM_ET:
+		return _emit_num(b, pE->expr.num);
+
+	case UN_STRNUM_ET: {
+			struct expr_s *pU = pE->expr.unary;
+			if (!pU)
+				return FALSE;
+			if (pU->type == VAL_NUM_ET)
+				return _emit_num(b, pU->expr.num);
+			if (pU->type == VAL_STR_ET) {
+				gchar *end = NULL;
+				double num = strtod(pU->expr.str, &end);
+				if (end == pU->expr.str)
+					return FALSE;
+				return _emit_num(b, num);
+			}
+			if (pU->type == ACC_ET)
+				return _emit_load(b, pU);
+			return _compile(b, pU);
+		}
+
+	case UN_NUMSUP_ET:
+	case UN_NUMINF_ET:
+	case UN_NUMNOT_ET:
+		return _compile(b, pE->expr.unary) && _emit(b, &insn, 1);
+
+	case BIN_NUMCMP_ET:
+	case BIN_NUMEQ_ET:
+	case BIN_NUMNEQ_ET:
+	case BIN_NUMLT_ET:
+	case BIN_NUMLE_ET:
+	case BIN_NUMGT_ET:
+	case BIN_NUMGE_ET:
+	case BIN_NUMADD_ET:
+	case BIN_NUMSUB_ET:
+	case BIN_NUMMUL_ET:
+	case BIN_NUMDIV_ET:
+	case BIN_NUMMOD_ET:
+	case BIN_NUMAND_ET:
+	case BIN_NUMXOR_ET:
+	case BIN_NUMOR_ET:
+	case BIN_POW_ET:
+	case BIN_ROOT_ET:
+		return _compile(b, pE->expr.bin.p1)
+			&& _compile(b, pE->expr.bin.p2)
+			&& _emit(b, &insn, 2);
+
+	case TER_NUMCLAMP_ET:
+		return _compile(b, pE->expr.ter.p1)
+			&& _compile(b, pE->expr.ter.p2)
+			&& _compile(b, pE->expr.ter.p3)
+			&& _emit(b, &insn, 3);
+
+	/* Work on strings */
+	case VAL_STR_ET:
+	case ACC_ET:
+	case UN_STRLEN_ET:
+	case BIN_STRCMP_ET:
+	case NB_ET:
+		return FALSE;
+	}
+
+	return FALSE;
+}
+
+struct expr_program_s*
+expr_compile(struct expr_s *pE, const char * const *bases)
+{
+	struct expr_builder_s b = {
+		.insn = g_array_new(FALSE, FALSE, sizeof(struct expr_insn_s)),
+		.slots = g_ptr_array_new_with_free_func(g_free),
+		.bases = bases,
+		.depth = 0,
+	};
+
+	struct expr_program_s *prog = NULL;
+	if (_compile(&b, pE) && b.depth == 1) {
+		prog = g_malloc0(sizeof(struct expr_program_s)
+				+ b.insn->len * sizeof(struct expr_insn_s));
+		prog->nb_insn = b.insn->len;
+		memcpy(prog->insn, b.insn->data,
+				b.insn->len * sizeof(struct expr_insn_s));
+		prog->nb_slots = b.slots->len;
+		for (guint i = 0; i < b.slots->len; i++)
+			prog->slots[i] = g_strdup(b.slots->pdata[i]);
+	}
+
+	g_array_free(b.insn, TRUE);
+	g_ptr_array_free(b.slots, TRUE);
+	return prog;
+}
+
+void
+expr_program_clean(struct expr_program_s *prog)
+{
+	if (!prog)
+		return;
+	for (guint i = 0; i < prog->nb_slots; i++)
+		g_free(prog->slots[i]);
+	g_free(prog);
+}
+
+unsigned int
+expr_program_count_slots(const struct expr_program_s *prog)
+{
+	return prog ? prog->nb_slots : 0;
+}
+
+const char*
+expr_program_get_slot(const struct expr_program_s *prog, unsigned int slot)
+{
+	if (!prog || slot >= prog->nb_slots)
+		return NULL;
+	return prog->slots[slot];
+}
+
+int
+expr_program_evaluate(double *pResult, const struct expr_program_s *prog,
+		const struct expr_env_s *env)
+{
+	if (!pResult || !prog || !env)
+		return EXPR_EVAL_ERROR;
+
+	/* The checks done at compile time guarantee the stack neither
+	 * overflows nor underflows */
+	double stack[EXPR_PROGRAM_MAX_DEPTH];
+	unsigned int top = 0;
+	int ret;
+
+	for (const struct expr_insn_s *insn = prog->insn,
+			*end = prog->insn + prog->nb_insn; insn < end; insn++) {
+		double d1, d2, d3;
+		switch (insn->op) {
+		case VAL_NUM_ET:
+			stack[top++] = insn->num;
+			continue;
+
+		case ACC_ET:
+			if (!(env->present & (1u << insn->slot))) {
+				if (!insn->has_fallback) {
+					VARIABLE_PERIOD_DECLARE();
+					if (VARIABLE_PERIOD_SKIP(60)) {
+						GRID_DEBUG("%s is missing", prog->slots[insn->slot]);
+					} else {
+						/* once per minute */
+						GRID_WARN("%s is missing", prog->slots[insn->slot]);
+					}
+					return EXPR_EVAL_UNDEF;
+				}
+				stack[top++] = insn->num;
+			} else if (env->invalid & (1u << insn->slot)) {
+				return EXPR_EVAL_UNDEF;
+			} else {
+				stack[top++] = env->values[insn->slot];
+			}
+			continue;
+
+		case NB_ET:
+			return EXPR_EVAL_UNDEF;
+
+		case UN_NUMSUP_ET:
+			stack[top-1] = ceil(stack[top-1]);
+			continue;
+		case UN_NUMINF_ET:
+			stack[top-1] = floor(stack[top-1]);
+			continue;
+		case UN_NUMNOT_ET:
+			stack[top-1] = ((int) stack[top-1]) ? 0 : 1;
+			continue;
+
+		case TER_NUMCLAMP_ET:
+			d3 = stack[--top];
+			d2 = stack[--top];
+			d1 = stack[--top];
+			stack[top++] = CLAMP(d1, d2, d3);
+			continue;
+
+		default:
+			break;
+		}
+
+		/* Binary operators */
+		d2 = stack[--top];
+		d1 = stack[--top];
+		double *pD = stack + (top++);
+		switch (insn->op) {
+		case BIN_NUMCMP_ET:
+			FPcmp(*pD, d1, d2);
+			break;
+		case BIN_NUMEQ_ET:
+			FPcmp(ret, d1, d2);
+			*pD = (ret == 0);
+			break;
+		case BIN_NUMNEQ_ET:
+			FPcmp(ret, d1, d2);
+			*pD = (ret != 0);
+			break;
+		case BIN_NUMLT_ET:
+			FPcmp(ret, d1, d2);
+			*pD = (ret < 0);
+			break;
+		case BIN_NUMLE_ET:
+			FPcmp(ret, d1, d2);
+			*pD = (ret <= 0);
+			break;
+		case BIN_NUMGT_ET:
+			FPcmp(ret, d1, d2);
+			*pD = (ret > 0);
+			break;
+		case BIN_NUMGE_ET:
+			FPcmp(ret, d1, d2);
+			*pD = (ret >= 0);
+			break;
+		case BIN_NUMADD_ET:
+			*pD = d1 + d2;
+			break;
+		case BIN_NUMSUB_ET:
+			*pD = d1 - d2;
+			break;
+		case BIN_NUMMUL_ET:
+			*pD = d1 * d2;
+			break;
+		case BIN_NUMDIV_ET:
+			FPcmp(ret, d2, 0);
+			*pD = ret ? d1 / d2 : 0.0;
+			break;
+		case BIN_NUMMOD_ET:
+			/* The interpreter crashes on a null divisor */
+			*pD = (d1 < 0 || d2 < 0 || !(int) d2) ?
+				0.0 : (double) ((int) d1 % (int) d2);
+			break;
+		case BIN_NUMAND_ET:
+			*pD = FPBOOL(d1) && FPBOOL(d2);
+			break;
+		case BIN_NUMXOR_ET:
+			*pD = (int) d1 ^ (int) d2;
+			break;
+		case BIN_NUMOR_ET:
+			*pD = d1 + d2;
+			break;
+		case BIN_POW_ET:
+		case BIN_ROOT_ET:
+			FPcmp(ret, d1, 0);
+			if (ret == 0)
+				return EXPR_EVAL_UNDEF;
+			FPcmp(ret, d2, 0);
+			if (ret == 0)
+				*pD = 0.0;
+			else
+				*pD = pow(d2, insn->op == BIN_POW_ET ? d1 : 1 / d1);
+			break;
+		default:
+			return EXPR_EVAL_ERROR;
+		}
+	}
+
+	*pResult = stack[0];
+	return EXPR_EVAL_DEF;
+}
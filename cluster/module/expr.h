@@ -94,4 +94,46 @@ int expr_parse(const char *pBuf, struct expr_s **pE);
 
 int expr_evaluate(double *pResult, struct expr_s *pExpr, env_f pEnv);
 
+/* Compiled expressions ---------------------------------------------------- */
+
+/* Maximum number of distinct accessors (e.g. "stat.cpu") in a program */
+#define EXPR_PROGRAM_MAX_SLOTS 32
+
+/* Maximum depth of the stack of the evaluation of a program */
+#define EXPR_PROGRAM_MAX_DEPTH 64
+
+struct expr_program_s;
+
+/* The values of the accessors of a program, indexed by slot */
+struct expr_env_s
+{
+	/* bit <i> set if the value of slot <i> is known */
+	unsigned int present;
+	/* bit <i> set if the value of slot <i> is known but is not a number */
+	unsigned int invalid;
+	double values[EXPR_PROGRAM_MAX_SLOTS];
+};
+
+/* Flatten the expression into a postfix program working on doubles only,
+ * with the accessors resolved to slots. `bases` is the NULL-terminated list
+ * of the bases the environment of expr_evaluate() knows (e.g. "stat"), the
+ * accessors to other bases are undefined. Returns NULL if the expression
+ * cannot be compiled, i.e. if it works on strings (anything else than
+ * "num base.field"): it must then be evaluated with expr_evaluate(). */
+struct expr_program_s* expr_compile(struct expr_s *pE,
+		const char * const *bases);
+
+void expr_program_clean(struct expr_program_s *prog);
+
+unsigned int expr_program_count_slots(const struct expr_program_s *prog);
+
+/* Get the name of the accessor of a slot, e.g. "stat.cpu" */
+const char* expr_program_get_slot(const struct expr_program_s *prog,
+		unsigned int slot);
+
+/* Same result as expr_evaluate() on the expression the program has been
+ * compiled from, without any allocation. */
+int expr_program_evaluate(double *pResult, const struct expr_program_s *prog,
+		const struct expr_env_s *env);
+
 #endif /*OIO_SDS__metautils__lib__expr_h*/
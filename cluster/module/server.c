@@ -112,6 +112,13 @@ static gint64 srv_cache_interval = 250 * G_TIME_SPAN_MILLISECOND;
 static gchar *statsd_host = NULL;
 static gint statsd_port = 8125;
 
+/** Identifies this instance of the conscience in the deltas it replies,
+ * the generations of two instances cannot be compared. */
+static gchar cs_epoch[17] = {0};
+/** How many removals are remembered per service type, to be replied in
+ * the deltas. Clients older than the oldest one get a complete list. */
+static guint cs_delta_max_removed = 4096;
+
 /* ------------------------------------------------------------------------- */
 
 # ifndef LIMIT_LENGTH_SRVDESCR
@@ -138,6 +145,11 @@ struct conscience_srv_s {
 	time_t tags_mtime;
 	time_t lock_mtime;
 
+	/* Generation of the service type at the last change of the service */
+	gint64 generation;
+	/* What the deltas carry for the load balancers, as of that generation */
+	gchar *lb_state;
+
 	/*a ring by service type */
 	struct conscience_srv_s *next;
 	struct conscience_srv_s *prev;
@@ -146,6 +158,12 @@ struct conscience_srv_s {
 	gchar service_id[LIMIT_LENGTH_SERVICE_ID];
 };
 
+/* A service removed from a type, remembered to be replied in the deltas */
+struct conscience_removed_s {
+	addr_info_t addr;
+	gint64 generation;
+};
+
 enum score_type_e
 {
 	PUT = 1 << 0,
@@ -158,8 +176,18 @@ struct conscience_srvtype_s
 	gchar *get_score_expr_str;
 	struct expr_s *put_score_expr;
 	struct expr_s *get_score_expr;
+	/* Compiled forms of the expressions, NULL when they work on strings */
+	struct expr_program_s *put_score_prog;
+	struct expr_program_s *get_score_prog;
 	GHashTable *services_ht;  /**<Maps (addr_info_t*) to (conscience_srv_s*)*/
 
+	/* Incremented at each change of a service of the type */
+	gint64 generation;
+	/* Array of struct conscience_removed_s, by increasing generation */
+	GArray *removed;
+	/* Deltas since a generation before this one cannot be computed */
+	gint64 removed_horizon;
+
 	GRWLock rw_lock;
 
 	time_t alert_frequency_limit;
@@ -202,6 +230,8 @@ conscience_srv_destroy(struct conscience_srv_s *service)
 		g_byte_array_unref(gba);
 	}
 
+	g_free(service->lb_state);
+
 	/*remove from the ring */
 	if (service->prev)
 		service->prev->next = service->next;
@@ -212,6 +242,49 @@ conscience_srv_destroy(struct conscience_srv_s *service)
 	g_free(service);
 }
 
+/* The bases getAcc() knows in conscience_srv_compute_score() */
+static const char * const score_bases[] = {"stat", "tag", NULL};
+
+/* Fill the slots of a compiled score expression with the tags of the
+ * service, without formatting them as strings. */
+static void
+conscience_srv_load_env(struct conscience_srv_s *service,
+		struct expr_program_s *prog, struct expr_env_s *env)
+{
+	env->present = env->invalid = 0;
+	const guint max = expr_program_count_slots(prog);
+	for (guint i = 0; i < max; i++) {
+		const char *name = expr_program_get_slot(prog, i);
+		struct service_tag_s *pTag = service_info_get_tag(service->tags, name);
+		if (!pTag)
+			continue;
+		env->present |= 1u << i;
+		const gchar *str = NULL;
+		switch (pTag->type) {
+		case STVT_I64:
+			env->values[i] = pTag->value.i;
+			continue;
+		case STVT_REAL:
+			env->values[i] = pTag->value.r;
+			continue;
+		case STVT_BOOL:
+			env->values[i] = pTag->value.b ? 1 : 0;
+			continue;
+		case STVT_STR:
+			str = pTag->value.s;
+			break;
+		case STVT_BUF:
+			str = pTag->value.buf;
+			break;
+		}
+		gchar *end = NULL;
+		if (str)
+			env->values[i] = strtod(str, &end);
+		if (!str || end == str)
+			env->invalid |= 1u << i;
+	}
+}
+
 static gboolean
 conscience_srv_compute_score(struct conscience_srv_s *service, enum score_type_e score_type)
 {
@@ -259,12 +332,19 @@ conscience_srv_compute_score(struct conscience_srv_s *service, enum score_type_e
 		}
 	}
 
-	gboolean compute_score(gint32 *pResult, struct expr_s *pExpr, gint32 old_score)
+	gboolean compute_score(gint32 *pResult, struct expr_s *pExpr,
+			struct expr_program_s *prog, gint32 old_score)
 	{
 		EXTRA_ASSERT(pExpr != NULL);
 		gdouble d = 0.0;
-		if (expr_evaluate(&d, pExpr, getAcc))
+		if (prog) {
+			struct expr_env_s env;
+			conscience_srv_load_env(service, prog, &env);
+			if (expr_program_evaluate(&d, prog, &env))
+				return FALSE;
+		} else if (expr_evaluate(&d, pExpr, getAcc)) {
 			return FALSE;
+		}
 
 		gint32 current = isnan(d) ? 0 : floor(d);
 
@@ -285,10 +365,12 @@ conscience_srv_compute_score(struct conscience_srv_s *service, enum score_type_e
 
 	gboolean ret = TRUE;
 	if (score_type & PUT && !service->put_locked) {
-		ret = compute_score(&service->put_score.value, srvtype->put_score_expr, service->put_score.value);
+		ret = compute_score(&service->put_score.value, srvtype->put_score_expr,
+				srvtype->put_score_prog, service->put_score.value);
 	}
 	if (score_type & GET && !service->get_locked) {
-		ret &= compute_score(&service->get_score.value, srvtype->get_score_expr, service->get_score.value);
+		ret &= compute_score(&service->get_score.value, srvtype->get_score_expr,
+				srvtype->get_score_prog, service->get_score.value);
 	}
 	return ret;
 }
@@ -362,11 +444,48 @@ _conscience_srv_serialize(struct conscience_srv_s *srv)
 	return gba;
 }
 
+/* The tags read by the consumers of the deltas: the load balancers and the
+ * down hosts of the clients. */
+static const char * const lb_tags[] = {
+	NAME_TAGNAME_UP, NAME_TAGNAME_LOC, NAME_TAGNAME_SLOTS, NAME_TAGNAME_TLS,
+	NAME_TAGNAME_INTERNAL_PORT, "tag.service_id", NULL
+};
+
+static gchar *
+_conscience_srv_lb_state(struct conscience_srv_s *srv)
+{
+	GString *gs = g_string_sized_new(128);
+	g_string_append_printf(gs, "%"G_GINT32_FORMAT",%"G_GINT32_FORMAT",%d,%d",
+			srv->put_score.value, srv->get_score.value,
+			srv->put_locked ? 1 : 0, srv->get_locked ? 1 : 0);
+	for (const char * const *pname = lb_tags; *pname; pname++) {
+		struct service_tag_s *tag = service_info_get_tag(srv->tags, *pname);
+		g_string_append_c(gs, '\n');
+		if (tag) {
+			gchar value[1024];
+			service_tag_to_string(tag, value, sizeof(value));
+			g_string_append(gs, value);
+		}
+	}
+	return g_string_free(gs, FALSE);
+}
+
 static void
 _conscience_srv_prepare_cache(struct conscience_srv_s *srv)
 {
 	conscience_srv_clean_udata(srv);
 	srv->cache = _conscience_srv_serialize(srv);
+	/* Called at each refresh of the service, it will be in the next deltas
+	 * only if what the load balancers read has changed. The stats alone
+	 * are refreshed at each push. */
+	gchar *lb_state = _conscience_srv_lb_state(srv);
+	if (srv->lb_state && !strcmp(srv->lb_state, lb_state)) {
+		g_free(lb_state);
+	} else {
+		g_free(srv->lb_state);
+		srv->lb_state = lb_state;
+		srv->generation = ++ srv->srvtype->generation;
+	}
 #ifdef HAVE_ENBUG
 	g_usleep(cs_enbug_serialize_delay);
 #endif
@@ -399,8 +518,13 @@ conscience_srvtype_set_type_expression(struct conscience_srvtype_s * srvtype,
 			g_free(srvtype->put_score_expr_str);
 		if (srvtype->put_score_expr)
 			expr_clean(srvtype->put_score_expr);
+		expr_program_clean(srvtype->put_score_prog);
 		srvtype->put_score_expr_str = g_strdup(expr_str);
 		srvtype->put_score_expr = pE;
+		srvtype->put_score_prog = expr_compile(pE, score_bases);
+		if (!srvtype->put_score_prog)
+			GRID_INFO("[SRVTYPE=%s] put score expression interpreted: %s",
+					srvtype->type_name, expr_str);
 	}
 	if (score_type & GET)
 	{
@@ -415,8 +539,13 @@ conscience_srvtype_set_type_expression(struct conscience_srvtype_s * srvtype,
 			g_free(srvtype->get_score_expr_str);
 		if (srvtype->get_score_expr)
 			expr_clean(srvtype->get_score_expr);
+		expr_program_clean(srvtype->get_score_prog);
 		srvtype->get_score_expr_str = g_strdup(expr_str);
 		srvtype->get_score_expr = pE;
+		srvtype->get_score_prog = expr_compile(pE, score_bases);
+		if (!srvtype->get_score_prog)
+			GRID_INFO("[SRVTYPE=%s] get score expression interpreted: %s",
+					srvtype->type_name, expr_str);
 	}
 	return TRUE;
 }
@@ -443,6 +572,8 @@ conscience_srvtype_create(const char *type)
 
 	srvtype->services_ht = g_hash_table_new_full(hash_service_id,
 			addr_info_equal, NULL, NULL);
+	srvtype->removed = g_array_new(FALSE, FALSE,
+			sizeof(struct conscience_removed_s));
 
 	if (type)
 		g_strlcpy(srvtype->type_name, type, sizeof(srvtype->type_name));
@@ -467,6 +598,10 @@ conscience_srvtype_flush(struct conscience_srvtype_s *srvtype)
 		counter++;
 	}
 
+	/* Too many removals to remember, the clients must reload everything */
+	g_array_set_size(srvtype->removed, 0);
+	srvtype->removed_horizon = ++ srvtype->generation;
+
 	GRID_DEBUG("Service type [%s] flushed, [%u] services removed",
 		srvtype->type_name, counter);
 }
@@ -481,14 +616,18 @@ conscience_srvtype_destroy(struct conscience_srvtype_s *srvtype)
 
 	if (srvtype->services_ht)
 		g_hash_table_destroy(srvtype->services_ht);
+	if (srvtype->removed)
+		g_array_free(srvtype->removed, TRUE);
 	if (srvtype->put_score_expr)
 		expr_clean(srvtype->put_score_expr);
+	expr_program_clean(srvtype->put_score_prog);
 	if (srvtype->put_score_expr_str) {
 		*(srvtype->put_score_expr_str) = '\0';
 		g_free(srvtype->put_score_expr_str);
 	}
 	if (srvtype->get_score_expr)
 		expr_clean(srvtype->get_score_expr);
+	expr_program_clean(srvtype->get_score_prog);
 	if (srvtype->get_score_expr_str) {
 		*(srvtype->get_score_expr_str) = '\0';
 		g_free(srvtype->get_score_expr_str);
@@ -498,6 +637,25 @@ conscience_srvtype_destroy(struct conscience_srvtype_s *srvtype)
 	g_free(srvtype);
 }
 
+static void
+conscience_srvtype_remember_removed(struct conscience_srvtype_s *srvtype,
+		const addr_info_t *srvid)
+{
+	if (srvtype->removed->len >= MAX(1, cs_delta_max_removed)) {
+		/* Forget the oldest half at once, not to move the array at
+		 * each removal. */
+		const guint dropped = (srvtype->removed->len + 1) / 2;
+		srvtype->removed_horizon = g_array_index(srvtype->removed,
+				struct conscience_removed_s, dropped - 1).generation;
+		g_array_remove_range(srvtype->removed, 0, dropped);
+	}
+	struct conscience_removed_s removed;
+	memset(&removed, 0, sizeof(removed));
+	memcpy(&removed.addr, srvid, sizeof(addr_info_t));
+	removed.generation = ++ srvtype->generation;
+	g_array_append_vals(srvtype->removed, &removed, 1);
+}
+
 static void
 conscience_srvtype_remove_srv(struct conscience_srvtype_s *srvtype,
 		const addr_info_t *srvid, time_t mtime)
@@ -516,6 +674,7 @@ conscience_srvtype_remove_srv(struct conscience_srvtype_s *srvtype,
 		srv->next->prev = srv->prev;
 		srv->next = srv->prev = NULL;
 		conscience_srv_destroy(srv);
+		conscience_srvtype_remember_removed(srvtype, srvid);
 	}
 }
 
@@ -576,19 +735,28 @@ conscience_srvtype_zero_expired(struct conscience_srvtype_s * srvtype,
 	while (g_hash_table_iter_next(&iter, &key, &value)) {
 		struct conscience_srv_s *p_srv = value;
 		if (p_srv->put_score.timestamp < oldest || p_srv->get_score.timestamp < oldest) {
+			gboolean changed = FALSE;
 			if (p_srv->put_score.value > 0 && !p_srv->put_locked) {
 				p_srv->put_score.value = 0;
 				p_srv->put_score.timestamp = now;
+				changed = TRUE;
 			}
 			if (p_srv->get_score.value > 0 && !p_srv->get_locked) {
 				p_srv->get_score.value = 0;
 				p_srv->get_score.timestamp = now;
+				changed = TRUE;
 			}
 			p_srv->tags_mtime = now * G_TIME_SPAN_SECOND;
 			struct service_tag_s *tag =
 					service_info_ensure_tag(p_srv->tags, NAME_TAGNAME_UP);
+			gboolean up = TRUE;
+			if (!service_tag_get_value_boolean(tag, &up, NULL) || up)
+				changed = TRUE;
 			service_tag_set_value_boolean(tag, FALSE);
-			_conscience_srv_prepare_cache(p_srv);
+			/* A service already expired stays as it is, don't send it
+			 * again in the deltas. */
+			if (changed)
+				_conscience_srv_prepare_cache(p_srv);
 			if (callback)
 				callback(p_srv, u);
 			count++;
@@ -615,6 +783,39 @@ conscience_srvtype_run_all(struct conscience_srvtype_s * srvtype,
 	return TRUE;
 }
 
+/* Recompute at once the scores of the services of a type, with the
+ * expressions and the variation bound currently configured. The scores
+ * of locked services and of services tagged DOWN are left untouched. */
+static void
+conscience_srvtype_rescore(struct conscience_srvtype_s *srvtype,
+		enum score_type_e score_type)
+{
+	guint count = 0;
+	gint64 start = oio_ext_monotonic_time();
+	g_rw_lock_writer_lock(&srvtype->rw_lock);
+	const struct conscience_srv_s *beacon = &(srvtype->services_ring);
+	for (struct conscience_srv_s *srv = beacon->next;
+			srv && srv != beacon;
+			srv = srv->next) {
+		gboolean is_up = TRUE;
+		struct service_tag_s *tag_up = service_info_get_tag(
+				srv->tags, NAME_TAGNAME_UP);
+		if (tag_up && service_tag_get_value_boolean(tag_up, &is_up, NULL)
+				&& !is_up)
+			continue;
+		if (conscience_srv_compute_score(srv, score_type)) {
+			_conscience_srv_prepare_cache(srv);
+			count++;
+		}
+	}
+	g_rw_lock_writer_unlock(&srvtype->rw_lock);
+	if (count > 0) {
+		GRID_INFO("[SRVTYPE=%s] %u services rescored in %"G_GINT64_FORMAT"us",
+				srvtype->type_name, count,
+				oio_ext_monotonic_time() - start);
+	}
+}
+
 static void
 conscience_update_srv(gboolean first, time_t now, gint32 si_score,
 		enum score_type_e score_type, struct conscience_srv_s *p_srv)
@@ -1451,6 +1652,117 @@ _prepare_cached(struct conscience_srv_s *srv, gpointer u)
 	}
 }
 
+struct cs_delta_s {
+	GByteArray *body;
+	GString *removed;
+	gint64 since;
+	gint64 generation;
+	gboolean complete;
+	gboolean full;
+	guint count;
+};
+
+static gboolean
+_prepare_delta(struct conscience_srv_s *srv, gpointer u)
+{
+	struct cs_delta_s *delta = u;
+	if (!delta->complete && srv->generation <= delta->since)
+		return TRUE;
+	delta->count ++;
+	return (delta->full ? _prepare_full : _prepare_cached)(srv, delta->body);
+}
+
+/* Serialize the services of the type changed since the generation asked
+ * by the client, and the addresses of those removed since then. When the
+ * removals since that generation have been forgotten, serialize all the
+ * services instead. */
+static GError *
+conscience_srvtype_delta(const gchar *type, struct cs_delta_s *delta)
+{
+	struct conscience_srvtype_s *srvtype = conscience_get_srvtype(type, FALSE);
+	if (!srvtype)
+		return BADSRVTYPE(type);
+
+	g_rw_lock_reader_lock(&srvtype->rw_lock);
+	delta->generation = srvtype->generation;
+	delta->complete = delta->since <= 0
+			|| delta->since < srvtype->removed_horizon
+			|| delta->since > srvtype->generation;
+	if (!delta->complete) {
+		for (guint i = srvtype->removed->len; i > 0; i--) {
+			struct conscience_removed_s *removed = &g_array_index(
+					srvtype->removed, struct conscience_removed_s, i - 1);
+			if (removed->generation <= delta->since)
+				break;
+			gchar addr[STRLEN_ADDRINFO];
+			grid_addrinfo_to_string(&removed->addr, addr, sizeof(addr));
+			if (delta->removed->len)
+				g_string_append_c(delta->removed, ',');
+			g_string_append(delta->removed, addr);
+		}
+	}
+	gboolean rc = conscience_srvtype_run_all(srvtype, _prepare_delta, delta);
+	g_rw_lock_reader_unlock(&srvtype->rw_lock);
+
+	if (!rc)
+		return SYSERR("Configuration error with [%s]", type);
+	return NULL;
+}
+
+/* The client tells the epoch and the generation of the last list it got,
+ * and receives the services that changed since then. */
+static gboolean
+_cs_dispatch_SRV_delta(struct gridd_reply_ctx_s *reply,
+		const gchar *strtype, gboolean full, gint64 since)
+{
+	GError *err = NULL;
+	gchar epoch[sizeof(cs_epoch)] = {0};
+	struct cs_delta_s delta = {0};
+	delta.full = full;
+	delta.since = since;
+
+	/* Another instance of the conscience replied the last time */
+	metautils_message_extract_string_noerror(reply->request,
+			NAME_MSGKEY_EPOCH, epoch, sizeof(epoch));
+	if (strcmp(epoch, cs_epoch))
+		delta.since = 0;
+
+	delta.body = g_byte_array_sized_new(8192);
+	delta.removed = g_string_sized_new(64);
+	g_byte_array_append(delta.body, header, 2);
+	err = conscience_srvtype_delta(strtype, &delta);
+
+	if (err) {
+		g_byte_array_free(delta.body, TRUE);
+		reply->send_error(0, err);
+	} else {
+		reply->subject("delta:%s\tsrv_type:%s\tsince:%"G_GINT64_FORMAT
+				"\tchanged:%u%s",
+				delta.complete ? "NO" : "YES", strtype, delta.since,
+				delta.count, full ? "\top_type:full" : "");
+		reply->add_header(NAME_MSGKEY_EPOCH,
+				metautils_gba_from_string(cs_epoch));
+		gchar generation[24];
+		g_snprintf(generation, sizeof(generation),
+				"%"G_GINT64_FORMAT, delta.generation);
+		reply->add_header(NAME_MSGKEY_GENERATION,
+				metautils_gba_from_string(generation));
+		if (!delta.complete) {
+			reply->add_header(NAME_MSGKEY_DELTA,
+					metautils_gba_from_string("1"));
+			if (delta.removed->len)
+				reply->add_header(NAME_MSGKEY_REMOVED,
+						metautils_gba_from_string(delta.removed->str));
+		}
+		g_byte_array_append(delta.body, footer, 2);
+		reply->add_body(delta.body);
+		reply->send_reply(200, "OK");
+	}
+
+	g_string_free(delta.removed, TRUE);
+	return TRUE;
+}
+
 static gboolean
 _cs_dispatch_SRV(struct gridd_reply_ctx_s *reply,
 	 gpointer g UNUSED, gpointer h UNUSED)
@@ -1474,6 +1786,17 @@ _cs_dispatch_SRV(struct gridd_reply_ctx_s *reply,
 	const gboolean full = metautils_message_extract_flag(
 			reply->request, NAME_MSGKEY_FULL, FALSE);
 
+	gint64 since = -1;
+	if (strcmp(strtype, "all") != 0)
+		err = metautils_message_extract_strint64(reply->request,
+				NAME_MSGKEY_SINCE, FALSE, &since);
+	if (err) {
+		reply->send_error(0, err);
+		return TRUE;
+	}
+	if (since >= 0)
+		return _cs_dispatch_SRV_delta(reply, strtype, full, since);
+
 	/* Take a reference to the cache, so it's not freed while we use it.
 	 * There is a race condition if someone calls g_hash_table_unref
 	 * while we are calling g_hash_table_ref, hence the lock. */
@@ -1774,10 +2097,11 @@ _task_expire (gpointer p UNUSED)
 	for (gchar **ptype=typev; typev && *ptype ;++ptype) {
 		struct conscience_srvtype_s *srvtype = conscience_get_srvtype(*ptype, FALSE);
 		EXTRA_ASSERT(srvtype != NULL);
-		g_rw_lock_reader_lock(&srvtype->rw_lock);
+		/* The services are modified, and their serialized form replaced */
+		g_rw_lock_writer_lock(&srvtype->rw_lock);
 		guint count = conscience_srvtype_zero_expired(srvtype,
 				service_expiration_notifier, NULL);
-		g_rw_lock_reader_unlock(&srvtype->rw_lock);
+		g_rw_lock_writer_unlock(&srvtype->rw_lock);
 
 		if (count)
 			GRID_NOTICE("Expired [%u] [%s] services", count, *ptype);
@@ -2198,6 +2522,11 @@ _cs_configure_with_file(const char *path UNUSED)
 			"Plugin.conscience", "synchronize_at_startup", NULL);
 	synchronize_at_startup = oio_str_parse_bool(tmp, FALSE);
 	g_free(tmp);
+	if (g_key_file_has_key(
+			gkf, "Plugin.conscience", "service_delta.max_removed", NULL)) {
+		cs_delta_max_removed = MAX(1, g_key_file_get_integer(gkf,
+				"Plugin.conscience", "service_delta.max_removed", NULL));
+	}
 	tmp = g_key_file_get_value(gkf,
 			"Plugin.conscience", "flush_stats_on_refresh", NULL);
 	flush_stats_on_refresh = oio_str_parse_bool(tmp, FALSE);
@@ -2365,11 +2694,13 @@ _configure_srvtype(GError ** err, const gchar * type, const gchar * what, const
 		GRID_INFO("[NS=%s][SRVTYPE=%s] score variation bound set to [%d]",
 				nsinfo->name, srvtype->type_name,
 				srvtype->score_variation_bound);
+		conscience_srvtype_rescore(srvtype, PUT | GET);
 		return TRUE;
 	} else if (g_ascii_strcasecmp(what, KEY_SCORE_EXPR) == 0) {
 		if (conscience_srvtype_set_type_expression(srvtype, err, value, PUT | GET)) {
 			GRID_INFO("[NS=%s][SRVTYPE=%s] score expression set to [%s]",
 					nsinfo->name, srvtype->type_name, value);
+			conscience_srvtype_rescore(srvtype, PUT | GET);
 			return TRUE;
 		}
 		return FALSE;
@@ -2377,6 +2708,7 @@ _configure_srvtype(GError ** err, const gchar * type, const gchar * what, const
 		if (conscience_srvtype_set_type_expression(srvtype, err, value, PUT)) {
 			GRID_INFO("[NS=%s][SRVTYPE=%s] put score expression set to [%s]",
 					nsinfo->name, srvtype->type_name, value);
+			conscience_srvtype_rescore(srvtype, PUT);
 			return TRUE;
 		}
 		return FALSE;
@@ -2384,6 +2716,7 @@ _configure_srvtype(GError ** err, const gchar * type, const gchar * what, const
 		if (conscience_srvtype_set_type_expression(srvtype, err, value, GET)) {
 			GRID_INFO("[NS=%s][SRVTYPE=%s] get score expression set to [%s]",
 					nsinfo->name, srvtype->type_name, value);
+			conscience_srvtype_rescore(srvtype, GET);
 			return TRUE;
 		}
 		return FALSE;
@@ -2698,6 +3031,7 @@ _cs_set_defaults(void)
 
 	g_mutex_init(&srv_lists_lock);
 	g_rw_lock_init(&rwlock_srv);
+	oio_str_randomize(cs_epoch, sizeof(cs_epoch), "0123456789ABCDEF");
 	srvtypes = g_tree_new_full(metautils_strcmp3, NULL,
 			g_free, (GDestroyNotify) conscience_srvtype_destroy);
 
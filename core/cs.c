@@ -103,6 +103,19 @@ oio_cs_client__list_services (struct oio_cs_client_s *self,
 	CS_CALL(self,list_services)(self,in_type,full,on_reg);
 }
 
+GError *
+oio_cs_client__list_services_since (struct oio_cs_client_s *self,
+		const char *in_type, gboolean full, struct oio_cs_generation_s *gen,
+		void (*on_reg) (const struct oio_cs_registration_s *, int, int),
+		void (*on_removed) (const char *))
+{
+	if (!in_type || !*in_type)
+		return BADREQ("Missing srvtype");
+	if (!gen)
+		return BADREQ("Missing generation");
+	CS_CALL(self,list_services_since)(self,in_type,full,gen,on_reg,on_removed);
+}
+
 GError *
 oio_cs_client__list_types (struct oio_cs_client_s *self,
 		void (*on_type) (const char *))
@@ -240,6 +253,12 @@ static GError * _cs_PROXY__list_services (struct oio_cs_client_s *self,
 static GError * _cs_PROXY__list_types (struct oio_cs_client_s *self,
 		void (*on_type) (const char *srvtype));
 
+static GError * _cs_PROXY__list_services_since (struct oio_cs_client_s *self,
+		const char *in_type, gboolean full, struct oio_cs_generation_s *gen,
+		void (*on_reg) (const struct oio_cs_registration_s *reg, int put_score,
+			int get_score),
+		void (*on_removed) (const char *url));
+
 static struct oio_cs_client_vtable_s vtable_PROXY =
 {
 	_cs_PROXY__destroy,
@@ -249,7 +268,8 @@ static struct oio_cs_client_vtable_s vtable_PROXY =
 	_cs_PROXY__flush_services,
 	_cs_PROXY__unlock_service,
 	_cs_PROXY__list_services,
-	_cs_PROXY__list_types
+	_cs_PROXY__list_types,
+	_cs_PROXY__list_services_since
 };
 
 void
@@ -428,6 +448,89 @@ _cs_PROXY__list_services (struct oio_cs_client_s *self,
 	return err;
 }
 
+GError *
+_cs_PROXY__list_services_since (struct oio_cs_client_s *self,
+		const char *in_type, gboolean full, struct oio_cs_generation_s *gen,
+		void (*on_reg) (const struct oio_cs_registration_s *, int, int),
+		void (*on_removed) (const char *))
+{
+	EXTRA_ASSERT (self != NULL);
+	struct oio_cs_client_PROXY_s *cs = (struct oio_cs_client_PROXY_s*) self;
+	EXTRA_ASSERT (cs->vtable == &vtable_PROXY);
+
+	if (!in_type || !*in_type)
+		return BADREQ("Missing srvtype");
+
+	GString *body = g_string_new ("");
+	gchar **headers = NULL;
+
+	CURL *h = _curl_get_handle_proxy ();
+	GError *err = oio_proxy_call_conscience_list_since (h, cs->ns, in_type,
+			full, gen->epoch, gen->generation, body, &headers);
+	curl_easy_cleanup (h);
+
+	if (!err && !body->len)
+		err = NEWERROR(CODE_PLATFORM_ERROR, "proxy: empty reply");
+
+	if (!err) {
+		/* A proxy unaware of the deltas replies the complete list, without
+		 * any generation: the next call will ask everything again. */
+		gchar *epoch = NULL;
+		gint64 generation = 0;
+		gboolean complete = TRUE;
+		for (gchar **p = headers; p && *p && *(p+1); p += 2) {
+			if (!g_ascii_strcasecmp(*p, "cs-epoch"))
+				oio_str_replace (&epoch, *(p+1));
+			else if (!g_ascii_strcasecmp(*p, "cs-generation"))
+				generation = g_ascii_strtoll(*(p+1), NULL, 10);
+			else if (!g_ascii_strcasecmp(*p, "cs-delta"))
+				complete = !oio_str_parse_bool(*(p+1), FALSE);
+		}
+
+		json_tokener *parser = json_tokener_new ();
+		json_object *jbody = json_tokener_parse_ex (parser, body->str, body->len);
+		if (json_tokener_success != json_tokener_get_error (parser))
+			err = NEWERROR(CODE_PLATFORM_ERROR, "proxy: invalid JSON");
+		else if (!jbody || !json_object_is_type (jbody, json_type_array))
+			err = NEWERROR(CODE_PLATFORM_ERROR, "proxy:  unexpected JSON");
+		else for (int i=json_object_array_length(jbody); i>0 && !err ;i--) {
+			json_object *item = json_object_array_get_idx (jbody, i-1);
+			json_object *jremoved = NULL, *jaddr = NULL;
+			if (!json_object_is_type(item, json_type_object))
+				err = NEWERROR(CODE_PLATFORM_ERROR, "proxy:  unexpected item");
+			else if (json_object_object_get_ex(item, "removed", &jremoved)
+					&& json_object_get_boolean(jremoved)) {
+				if (!json_object_object_get_ex(item, "addr", &jaddr)
+						|| !json_object_is_type(jaddr, json_type_string))
+					err = NEWERROR(CODE_PLATFORM_ERROR, "proxy:  unexpected item");
+				else if (on_removed)
+					(on_removed)(json_object_get_string(jaddr));
+			} else {
+				int put_score = 0;
+				int get_score = 0;
+				struct oio_cs_registration_s reg = {0};
+				err = _unpack_registration (item, &reg, &put_score, &get_score);
+				if (!err && on_reg)
+					(on_reg)(&reg, put_score, get_score);
+				_clean_registration(&reg);
+			}
+		}
+		if (jbody) json_object_put (jbody);
+		json_tokener_free (parser);
+
+		if (!err) {
+			oio_str_replace (&gen->epoch, epoch);
+			gen->generation = generation;
+			gen->complete = complete;
+		}
+		oio_str_clean (&epoch);
+	}
+
+	g_strfreev (headers);
+	g_string_free (body, TRUE);
+	return err;
+}
+
 GError *
 _cs_PROXY__list_types (struct oio_cs_client_s *self,
 		void (*on_type) (const char *))
@@ -52,6 +52,12 @@ struct oio_cs_client_vtable_s
 
 	GError * (*list_types) (struct oio_cs_client_s *self,
 			void (*on_type) (const char *srvtype));
+
+	GError * (*list_services_since) (struct oio_cs_client_s *self,
+			const char *in_type, gboolean full, struct oio_cs_generation_s *gen,
+			void (*on_reg) (const struct oio_cs_registration_s *reg,
+				int put_score, int get_score),
+			void (*on_removed) (const char *url));
 };
 
 struct oio_cs_client_abstract_s
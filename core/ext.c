@@ -198,6 +198,7 @@ struct oio_ext_local_s {
 	gint64 db_wait;
 	gchar reqid[LIMIT_LENGTH_REQID];
 	GHashTable *perfdata;
+	GHashTable *perfdata_counts;
 	guint8 allow_long_timeout;
 
 	GPtrArray *urlerrorv;
@@ -223,6 +224,10 @@ static void _local_free(gpointer p) {
 		g_hash_table_destroy(l->perfdata);
 		l->perfdata = NULL;
 	}
+	if (l->perfdata_counts) {
+		g_hash_table_destroy(l->perfdata_counts);
+		l->perfdata_counts = NULL;
+	}
 	if (l->urlerrorv) {
 		g_ptr_array_unref(l->urlerrorv);
 	}
@@ -488,9 +493,13 @@ GHashTable *oio_ext_enable_perfdata(gboolean enabled) {
 	if (enabled && !l->perfdata) {
 		l->perfdata = g_hash_table_new_full(
 				g_str_hash, g_str_equal, g_free, NULL);
+		l->perfdata_counts = g_hash_table_new_full(
+				g_str_hash, g_str_equal, g_free, NULL);
 	} else if (!enabled && l->perfdata) {
 		g_hash_table_destroy(l->perfdata);
 		l->perfdata = NULL;
+		g_hash_table_destroy(l->perfdata_counts);
+		l->perfdata_counts = NULL;
 	}
 	return l->perfdata;
 }
@@ -504,6 +513,21 @@ void oio_ext_add_perfdata(const gchar *key, gint64 value) {
 	}
 }
 
+void oio_ext_add_perfdata_count(const gchar *key, gint64 value) {
+	struct oio_ext_local_s *l = _local_ensure();
+	if (l->perfdata) {
+		oio_ext_add_perfdata(key, value);
+		if (!g_hash_table_contains(l->perfdata_counts, key))
+			g_hash_table_add(l->perfdata_counts, g_strdup(key));
+	}
+}
+
+gboolean oio_ext_is_perfdata_count(const gchar *key) {
+	struct oio_ext_local_s *l = _local_ensure();
+	return l->perfdata_counts
+		&& g_hash_table_contains(l->perfdata_counts, key);
+}
+
 gboolean oio_ext_is_allowed_to_do_long_timeout(void) {
 	const struct oio_ext_local_s *l = _local_ensure ();
 	return BOOL(l->allow_long_timeout);
@@ -95,6 +95,13 @@ GError * oio_proxy_call_conscience_unlock (CURL *h, const char *ns,
 GError * oio_proxy_call_conscience_list (CURL *h, const char *ns,
 		const char *srvtype, gboolean full, GString *out);
 
+/* Like oio_proxy_call_conscience_list(), but only the services changed since
+ * the generation <since> of the conscience with the given <epoch>. The
+ * x-oio-cs-* reply headers are returned (without their prefix) in <hout>. */
+GError * oio_proxy_call_conscience_list_since (CURL *h, const char *ns,
+		const char *srvtype, gboolean full, const char *epoch, gint64 since,
+		GString *out, gchar ***hout);
+
 GError * oio_proxy_call_conscience_list_types (CURL *h, const char *ns,
 		GString *out);
 
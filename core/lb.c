@@ -281,6 +281,32 @@ struct _slot_item_s
 	generation_t generation;
 };
 
+/* Number of entries of a location counter that stay embedded in the
+ * counter itself, i.e. on the stack of the pollers. 64 entries are enough
+ * for the 32 distinct locations of the widest pools. */
+#define LB_LOC_COUNTERS_INLINE 64
+
+struct _loc_count_s
+{
+	/* The location masked at the level of the counter, plus one. 0 marks
+	 * an empty entry. */
+	oio_location_t key;
+	guint32 count;
+};
+
+/* Count how often each location has been seen, at a given level.
+ * It is an open-addressing table (linear probing) that never loads more
+ * than the half of its entries, and from which keys are never removed. */
+struct _loc_counters_s
+{
+	/* log2 of the number of entries */
+	guint bits;
+	/* number of distinct keys */
+	guint len;
+	struct _loc_count_s *tab;
+	struct _loc_count_s inline_tab[LB_LOC_COUNTERS_INLINE];
+};
+
 /* Set of services matching the same macro "everything-but-the-location"
  * criteria. */
 struct oio_lb_slot_s
@@ -300,7 +326,7 @@ struct oio_lb_slot_s
 
 	/* Total number of items per location, for each level.
 	 * We do not use level 0 at the moment. */
-	GData *items_by_loc[OIO_LB_LOC_LEVELS];
+	struct _loc_counters_s items_by_loc[OIO_LB_LOC_LEVELS];
 
 	/* Total number of different locations for each level. */
 	guint locs_by_level[OIO_LB_LOC_LEVELS];
@@ -320,7 +346,55 @@ struct oio_lb_slot_s
 
 	guint8 flag_rehash_on_update : 1;
 
+	/* Has the slot been rehashed since its last snapshot */
+	guint8 flag_dirty_snapshot : 1;
+
 	guint64 jump;
+
+	/* What the pollers see of the slot, as of its last rehash */
+	struct _slot_snapshot_s *snapshot;
+};
+
+/* An item as seen by the pollers: a copy of the service and of its position
+ * in the slot, taken when the slot has been rehashed. */
+struct _snapshot_item_s
+{
+	struct oio_lb_item_s item;
+	oio_weight_acc_t acc_weight;
+	/* Number of items of the slot sharing the location of this item, for
+	 * each level. We do not use level 0 at the moment. */
+	guint32 items_at_loc[OIO_LB_LOC_LEVELS];
+};
+
+/* Immutable copy of a clean slot, the only part of a slot read while
+ * polling. Shared by the snapshots of the world until the slot changes. */
+struct _slot_snapshot_s
+{
+	gint refcount;
+	gchar *name;
+	oio_weight_acc_t sum_weight;
+	guint64 jump;
+	guint locs_by_level[OIO_LB_LOC_LEVELS];
+	guint n_items;
+	guint n_zero_scored;
+	/* Points after the last of the <n_items> items */
+	struct _snapshot_item_s *zero_scored_items;
+	/* <n_items> items sorted by location, followed by the <n_zero_scored>
+	 * unavailable items, sorted by location too. */
+	struct _snapshot_item_s items[];
+};
+
+/* What the pollers see of the world. Never modified once published, a new
+ * snapshot is published instead. */
+struct _world_snapshot_s
+{
+	gint refcount;
+	/* Unique among all the worlds */
+	gsize id;
+	/* The world that published the snapshot, never dereferenced */
+	const struct oio_lb_world_s *world;
+	guint16 abs_max_dist;
+	GHashTable *slots;  /* <gchar*, struct _slot_snapshot_s*> */
 };
 
 /* All the load-balancing information:
@@ -336,6 +410,16 @@ struct oio_lb_world_s
 	GTree *items;
 	generation_t generation;
 	guint16 abs_max_dist;
+
+	/* Has a slot been rehashed, created or removed since the last snapshot */
+	guint8 flag_dirty_snapshot;
+
+	/* The last snapshot published for the pollers, and its ID. The lock is
+	 * only held to replace the snapshot or to take a reference on it, the
+	 * ID may be checked without it. */
+	GMutex snapshot_lock;
+	struct _world_snapshot_s *snapshot;
+	gsize snapshot_id;
 };
 
 /* A pool describes a preset configuration for the polling of several services.
@@ -375,10 +459,30 @@ struct oio_lb_pool_LOCAL_s
 	guint8 fair_max_items[OIO_LB_LOC_LEVELS];
 };
 
+/* State shared by the placements polled in the same batch. */
+struct polling_batch_s
+{
+	/* Count how often each location has been chosen by the placements
+	 * already polled in the batch. */
+	struct _loc_counters_s counters[OIO_LB_LOC_LEVELS];
+
+	/* Number of placements already polled in the batch. */
+	guint done;
+
+	/* Selection of the current placement, recycled for the next one.
+	 * Array<struct oio_lb_selected_item_s *> */
+	GPtrArray *selection;
+
+	/* Selected items of all the placements, in order.
+	 * Array<struct oio_lb_selected_item_s *> */
+	GPtrArray *out;
+};
+
 struct polling_ctx_s
 {
 	/* Locations that should be avoided. */
 	const oio_location_t * avoids;
+	guint n_avoids;
 	/* Locations that have already been selected
 	 * (before or during the request). */
 	const oio_location_t * polled;
@@ -391,7 +495,7 @@ struct polling_ctx_s
 	guint n_targets;
 
 	/* Count how often each location has been chosen. */
-	GData *counters[OIO_LB_LOC_LEVELS];
+	struct _loc_counters_s counters[OIO_LB_LOC_LEVELS];
 
 	/* Result from the selection of services.
 	 * Array<struct oio_lb_selected_item_s *> */
@@ -421,6 +525,9 @@ struct polling_ctx_s
 	/* Number of services per location level that will trigger, when surpassed,
 	 * a placement improvement. */
 	const guint8 *fair_max_items;
+
+	/* The batch the current placement belongs to, if any. */
+	struct polling_batch_s *batch;
 };
 
 static void _local__destroy (struct oio_lb_pool_s *self);
@@ -461,6 +568,8 @@ _item_make (oio_location_t location, const char *id, const char *addr, const cha
 void
 oio_lb_selected_item_free(struct oio_lb_selected_item_s *sel)
 {
+	if (!sel)
+		return;
 	g_free(sel->item);
 	g_free(sel->expected_slot);
 	g_free(sel->final_slot);
@@ -481,7 +590,7 @@ _item_dup(const struct oio_lb_selected_item_s *sel)
 }
 
 static struct oio_lb_selected_item_s *
-_item_select(const struct _lb_item_s *src)
+_item_select(const struct oio_lb_item_s *src)
 {
 	struct oio_lb_selected_item_s *res =  g_malloc0(sizeof *res);
 	if (src != NULL) {
@@ -525,6 +634,8 @@ static guint _search_first_at_location(GArray *tab,
 		const oio_location_t needle, const enum oio_loc_proximity_level_e lvl,
 		const guint start, const guint end);
 
+static void _slot_snapshot_unref(struct _slot_snapshot_s *snap);
+
 guint32
 djb_hash_str0(const gchar *str)
 {
@@ -553,19 +664,6 @@ djb_hash_buf(const guint8 * b, register gsize bs)
 	return h;
 }
 
-/** Gets the number of elements in a GData. */
-static guint
-oio_ext_gdatalist_length(GData **datalist)
-{
-	guint counter = 0;
-	void _datalist_count(GQuark key_id UNUSED,
-			gpointer data UNUSED, gpointer udata UNUSED) {
-		counter++;
-	}
-	g_datalist_foreach(datalist, _datalist_count, NULL);
-	return counter;
-}
-
 uint32_t
 key_from_loc_level(oio_location_t loc, int level)
 {
@@ -576,6 +674,104 @@ key_from_loc_level(oio_location_t loc, int level)
 	return key;
 }
 
+/* Unlike key_from_loc_level(), the key keeps all the bits of the location,
+ * there is no collision. */
+static inline oio_location_t
+_loc_counters_key(const oio_location_t loc, const int level)
+{
+	EXTRA_ASSERT(level > 0);
+	return (loc >> (level * OIO_LB_BITS_PER_LOC_LEVEL)) + 1;
+}
+
+/* Prepare the counter for <expected> distinct keys. Up to the half of
+ * LB_LOC_COUNTERS_INLINE keys, no allocation is done. */
+static void
+_loc_counters_init(struct _loc_counters_s *c, const guint expected)
+{
+	guint bits = 3;
+	while ((1u << bits) < 2 * expected)
+		bits++;
+	c->bits = bits;
+	c->len = 0;
+	if ((1u << bits) <= LB_LOC_COUNTERS_INLINE) {
+		c->tab = c->inline_tab;
+		memset(c->tab, 0, sizeof(struct _loc_count_s) << bits);
+	} else {
+		c->tab = g_malloc0(sizeof(struct _loc_count_s) << bits);
+	}
+}
+
+static void
+_loc_counters_clear(struct _loc_counters_s *c)
+{
+	if (c->tab != c->inline_tab)
+		g_free(c->tab);
+	c->tab = NULL;
+	c->bits = 0;
+	c->len = 0;
+}
+
+static inline guint
+_loc_counters_hash(const struct _loc_counters_s *c, const oio_location_t key)
+{
+	return (key * G_GUINT64_CONSTANT(0x9E3779B97F4A7C15)) >> (64 - c->bits);
+}
+
+static struct _loc_count_s *
+_loc_counters_lookup(const struct _loc_counters_s *c, const oio_location_t key)
+{
+	const guint mask = (1u << c->bits) - 1;
+	for (guint i = _loc_counters_hash(c, key); ; i = (i + 1) & mask) {
+		struct _loc_count_s *e = c->tab + i;
+		if (e->key == key || !e->key)
+			return e;
+	}
+}
+
+static guint32
+_loc_counters_get(const struct _loc_counters_s *c, const oio_location_t key)
+{
+	if (!c->tab)
+		return 0;
+	return _loc_counters_lookup(c, key)->count;
+}
+
+static void
+_loc_counters_add(struct _loc_counters_s *c, const oio_location_t key,
+		const guint32 count)
+{
+	if (unlikely(!c->tab)) {
+		_loc_counters_init(c, 0);
+	} else if (unlikely(2 * (c->len + 1) > (1u << c->bits))) {
+		struct _loc_counters_s old = *c;
+		if (old.tab == c->inline_tab)
+			old.tab = old.inline_tab;
+		_loc_counters_init(c, c->len + 1);
+		for (guint i = 0; i < (1u << old.bits); i++) {
+			if (old.tab[i].key)
+				_loc_counters_add(c, old.tab[i].key, old.tab[i].count);
+		}
+		_loc_counters_clear(&old);
+	}
+
+	struct _loc_count_s *e = _loc_counters_lookup(c, key);
+	if (!e->key) {
+		e->key = key;
+		c->len ++;
+	}
+	e->count += count;
+}
+
+static void
+_loc_counters_foreach(const struct _loc_counters_s *c,
+		void (*cb)(oio_location_t loc, guint32 count, gpointer u), gpointer u)
+{
+	for (guint i = 0; c->tab && i < (1u << c->bits); i++) {
+		if (c->tab[i].key)
+			cb(c->tab[i].key - 1, c->tab[i].count, u);
+	}
+}
+
 static void
 _print_items_tab(GString *inout, guint8 *tab)
 {
@@ -600,110 +796,81 @@ _dist_to_bit_shift(guint16 dist, gboolean nearby_mode)
 	return (dist - (!nearby_mode)) * OIO_LB_BITS_PER_LOC_LEVEL;
 }
 
+static guint
+_locations_count(const oio_location_t *tab)
+{
+	guint n = 0;
+	for (; tab && tab[n]; n++) {}
+	return n;
+}
+
+/* The distance checks scan the <n> first locations of the array, without
+ * any branch: the compiler is free to vectorize the loops. The array is
+ * terminated by 0 but may be shorter than <n>. */
 static gboolean
-_item_is_too_close(const oio_location_t * avoids,
+_item_is_too_close(const oio_location_t *avoids, const guint n,
 		const oio_location_t item, const guint16 distance)
 {
 	if (!avoids || distance == 0)
 		return FALSE;
 	const guint16 bit_shift = _dist_to_bit_shift(distance, FALSE);
 	const oio_location_t loc = item >> bit_shift;
-	for (const oio_location_t *pp=avoids; *pp; ++pp) {
-		if (loc == (*pp >> bit_shift))
-			return TRUE;
-	}
-	return FALSE;
+	guint hits = 0;
+	for (guint i = 0; i < n; i++)
+		hits |= (avoids[i] != 0) & (loc == (avoids[i] >> bit_shift));
+	return hits != 0;
 }
 
 static gboolean
-_item_is_too_far(const oio_location_t *known,
+_item_is_too_far(const oio_location_t *known, const guint n,
 		const oio_location_t item, const guint16 distance)
 {
 	if (!known || distance > OIO_LB_LOC_LEVELS)
 		return FALSE;
 	const guint16 bit_shift = _dist_to_bit_shift(distance, TRUE);
 	const oio_location_t loc = item >> bit_shift;
-	for (const oio_location_t *pp=known; *pp; ++pp) {
-		if (loc != (*pp >> bit_shift))
-			return TRUE;
-	}
-	return FALSE;
+	guint misses = 0;
+	for (guint i = 0; i < n; i++)
+		misses |= (known[i] != 0) & (loc != (known[i] >> bit_shift));
+	return misses != 0;
 }
 
+/* The distance to a location is the number of levels from which the
+ * locations differ, the closest known location gives the result. */
 static guint16
-_find_min_dist(const oio_location_t *known,
+_find_min_dist(const oio_location_t *known, const guint n,
 		const oio_location_t item, guint16 max_dist)
 {
 	guint16 dist = max_dist;
-	while (_item_is_too_close(known, item, dist)) {
-		dist--;
+	for (guint i = 0; i < n; i++) {
+		const oio_location_t diff = item ^ known[i];
+		guint16 d = 0;
+		for (int level = 0; level < OIO_LB_LOC_LEVELS; level++)
+			d += (diff >> (level * OIO_LB_BITS_PER_LOC_LEVEL)) != 0;
+		dist = MIN(dist, known[i] ? d : max_dist);
 	}
 	return dist;
 }
 
-static void
-__attribute__ ((format (printf, 1, 2)))
-_warn_dirty_poll(const char *fmt, ...)
-{
-	/* Initiate the mutex */
-	static volatile guint lazy_init = 1;
-	static GMutex lock = {};
-	if (lazy_init) {
-		if (g_atomic_int_compare_and_exchange(&lazy_init, 1, 0))
-			g_mutex_init(&lock);
-	}
-
-	if (g_mutex_trylock(&lock)) {
-		/* If the mutex is already held by another thread, an alert is maybe
-		 * going to be sent. No need to check if we need a strong level, that
-		 * check will be performed by the other thread, and there is even no
-		 * need to send any trace... */
-		static volatile gint64 last_alert = 0;
-		const gint64 now = oio_ext_monotonic_time();
-
-		GLogLevelFlags lvl = GRID_LOGLVL_DEBUG;
-		if (last_alert < OLDEST(now, 5 * G_TIME_SPAN_MINUTE))
-			lvl = GRID_LOGLVL_WARN;
-		last_alert = now;
-		g_mutex_unlock(&lock);
-
-		va_list va;
-		va_start(va, fmt);
-		g_logv(G_LOG_DOMAIN, lvl, fmt, va);
-		va_end(va);
-	}
-}
-
 static gboolean
-_item_is_too_popular(struct polling_ctx_s *ctx, const oio_location_t item,
-		struct oio_lb_slot_s *slot, guint8 *popularity_by_level,
-		guint8 *max_by_level)
+_item_is_too_popular(struct polling_ctx_s *ctx,
+		const struct _snapshot_item_s *si, const struct _slot_snapshot_s *slot,
+		guint8 *popularity_by_level, guint8 *max_by_level)
 {
 	EXTRA_ASSERT(popularity_by_level != NULL);
 	EXTRA_ASSERT(max_by_level != NULL);
 
+	const oio_location_t item = si->item.location;
 	// Level 0 is storage device, level 3 is datacenter (usually)
 	max_by_level[0] = 1;
 	for (int level = 1; level <= 3; level++) {
-		GQuark key = key_from_loc_level(item, level);
+		const oio_location_t key = _loc_counters_key(item, level);
 		// How many different items there is under this level
-		guint32 n_leafs = GPOINTER_TO_UINT(
-				g_datalist_id_get_data(&(slot->items_by_loc[level]), key));
-		if (unlikely(n_leafs == 0)) {
-			_warn_dirty_poll("BUG: %s: LB reload not followed by rehash, "
-					"item %"OIO_LOC_FORMAT" not found at level %d",
-					__FUNCTION__, item, level);
-			n_leafs = 1;
-		} else if (unlikely(n_leafs > slot->items->len)) {
-			_warn_dirty_poll("BUG: %s: LB reload not followed by rehash, "
-					"more different locations than items in the slot %s "
-					"(%u/%u)",
-					__FUNCTION__, slot->name, n_leafs, slot->items->len);
-			n_leafs = slot->items->len;
-		}
+		guint32 n_leafs = si->items_at_loc[level];
+		EXTRA_ASSERT(n_leafs > 0);
+		EXTRA_ASSERT(n_leafs <= slot->n_items);
 		// How often the location has been chosen
-		guint32 popularity = GPOINTER_TO_UINT(
-				g_datalist_id_get_data(ctx->counters + level, key));
+		guint32 popularity = _loc_counters_get(ctx->counters + level, key);
 		popularity_by_level[level] = (guint8) MIN(popularity, 255);
 		// Maximum number of elements with this location that we can take
 		guint32 max = (ctx->force_fair_constraints)?
@@ -713,8 +880,8 @@ _item_is_too_popular(struct polling_ctx_s *ctx, const oio_location_t item,
 			// this subtree represents compared to the whole cluster, and
 			// allow to choose the same proportion of "targets".
 			// If we were using floats, this could be rewritten as:
-			// max = ctx->n_targets * (n_leafs / slot->items->len)
-			max = 1 + (ctx->n_targets - 1) / (slot->items->len / n_leafs);
+			// max = ctx->n_targets * (n_leafs / slot->n_items)
+			max = 1 + (ctx->n_targets - 1) / (slot->n_items / n_leafs);
 		}
 		max_by_level[level] = (guint8) MIN(max, 255);
 
@@ -722,12 +889,28 @@ _item_is_too_popular(struct polling_ctx_s *ctx, const oio_location_t item,
 		// but is not resilient to service failures.
 		//guint32 max = 1 + (ctx->n_targets - 1) / slot->locs_by_level[level];
 
-		GRID_TRACE("At level %d, %08X has popularity: %u, leafs: %u, max: %u",
-				level, key, popularity, n_leafs, max);
+		GRID_TRACE("At level %d, %"OIO_LOC_FORMAT" has popularity: %u, "
+				"leafs: %u, max: %u",
+				level, key - 1, popularity, n_leafs, max);
 		if (popularity >= max) {
 			// TODO: return the level to optimize the next jump
 			return TRUE;
 		}
+
+		// When looking for an ideal placement in a batch, also spread the
+		// load on the whole batch, as if all its placements were one.
+		if (ctx->batch && ctx->force_fair_constraints) {
+			const guint32 shots = ctx->batch->done + 1;
+			guint32 batch_max = ctx->fair_max_items[level] * shots;
+			if (batch_max == 0) {
+				batch_max = 1 + (ctx->n_targets * shots - 1)
+						/ (slot->n_items / n_leafs);
+			}
+			guint32 batch_popularity = popularity +
+					_loc_counters_get(ctx->batch->counters + level, key);
+			if (batch_popularity >= batch_max)
+				return TRUE;
+		}
 	}
 	return FALSE;
 }
@@ -760,6 +943,8 @@ _slot_flush(struct oio_lb_slot_s *slot)
 	}
 	_slot_items_flush(slot->items);
 	_slot_items_flush(slot->zero_scored_items);
+	/* Let the next rehash reset the weights and the locations */
+	slot->flag_dirty_order = 1;
 }
 
 static void
@@ -778,20 +963,15 @@ _slot_destroy (struct oio_lb_slot_s *slot)
 		slot->zero_scored_items = NULL;
 	}
 	for (int level = 1; level < OIO_LB_LOC_LEVELS; level++) {
-		g_datalist_clear(&(slot->items_by_loc[level]));
+		_loc_counters_clear(&(slot->items_by_loc[level]));
 	}
+	_slot_snapshot_unref(slot->snapshot);
+	slot->snapshot = NULL;
 	oio_str_clean (&slot->name);
 	slot->world = NULL;
 	g_free (slot);
 }
 
-
-static const struct _lb_item_s *
-_slot_get(struct oio_lb_slot_s *slot, const int i)
-{
-	return SLOT_ITEM(slot, i).item;
-}
-
 static inline gboolean
 _slot_needs_rehash (const struct oio_lb_slot_s * const slot)
 {
@@ -800,17 +980,24 @@ _slot_needs_rehash (const struct oio_lb_slot_s * const slot)
 }
 
 static void
-_level_datalist_incr_loc(GData **counters, oio_location_t loc)
+_level_counters_incr_loc(struct _loc_counters_s *counters, oio_location_t loc)
 {
-	for (int level = 1; level < OIO_LB_LOC_LEVELS; level++) {
-		GData **counter = counters + level;
-		GQuark key = key_from_loc_level(loc, level);
-		// Will be 0 (NULL) if key does not exist
-		guint32 count = GPOINTER_TO_UINT(
-				g_datalist_id_get_data(counter, key));
-		count++;
-		g_datalist_id_set_data(counter, key, GUINT_TO_POINTER(count));
-	}
+	for (int level = 1; level < OIO_LB_LOC_LEVELS; level++)
+		_loc_counters_add(counters + level, _loc_counters_key(loc, level), 1);
+}
+
+static void
+_level_counters_init(struct _loc_counters_s *counters, guint expected)
+{
+	for (int level = 1; level < OIO_LB_LOC_LEVELS; level++)
+		_loc_counters_init(counters + level, expected);
+}
+
+static void
+_level_counters_clear(struct _loc_counters_s *counters)
+{
+	for (int level = 1; level < OIO_LB_LOC_LEVELS; level++)
+		_loc_counters_clear(counters + level);
 }
 
 static void
@@ -821,30 +1008,25 @@ _slot_rehash(struct oio_lb_slot_s *slot)
 		slot->flag_dirty_weights = 1;
 		g_array_sort(slot->items, _compare_stored_items_by_location);
 
-		for (int level = 1; level < OIO_LB_LOC_LEVELS; level++) {
-			g_datalist_clear(&(slot->items_by_loc[level]));
-			// No need to call g_datalist_init()
-		}
+		_level_counters_clear(slot->items_by_loc);
+		_level_counters_init(slot->items_by_loc, slot->items->len);
 		for (guint i = 0; i < slot->items->len; i++) {
 			struct _slot_item_s *si = &SLOT_ITEM(slot, i);
-			_level_datalist_incr_loc(slot->items_by_loc, si->item->location);
+			_level_counters_incr_loc(slot->items_by_loc, si->item->location);
 		}
 		for (int level = 1; level < OIO_LB_LOC_LEVELS; level++) {
-			slot->locs_by_level[level] =
-					oio_ext_gdatalist_length(&(slot->items_by_loc[level]));
+			slot->locs_by_level[level] = slot->items_by_loc[level].len;
 		}
 
 # ifdef HAVE_EXTRA_DEBUG
 		if (unlikely(GRID_TRACE_ENABLED())) {
-			void _display(GQuark k, gpointer data, gpointer u) {
+			void _display(oio_location_t loc, guint32 count, gpointer u) {
 				guint level = GPOINTER_TO_UINT(u);
-				oio_location_t loc = (GPOINTER_TO_UINT(k) - 1);
 				GRID_TRACE("%0*lX prefix has %u services",
-						4 * (OIO_LB_LOC_LEVELS - level),
-						loc, GPOINTER_TO_UINT(data));
+						4 * (OIO_LB_LOC_LEVELS - level), loc, count);
 			}
 			for (int i = 1; i < OIO_LB_LOC_LEVELS; i++)
-				g_datalist_foreach(
+				_loc_counters_foreach(
 						&slot->items_by_loc[i], _display, GUINT_TO_POINTER(i));
 		}
 #endif
@@ -887,6 +1069,208 @@ _slot_rehash(struct oio_lb_slot_s *slot)
 			break;
 		}
 	}
+
+	slot->flag_dirty_snapshot = 1;
+	slot->world->flag_dirty_snapshot = 1;
+}
+
+static void
+_snapshot_item_fill(struct _snapshot_item_s *out,
+		const struct _slot_item_s *si,
+		const struct _loc_counters_s *items_by_loc)
+{
+	const struct _lb_item_s *item = si->item;
+	out->item.location = item->location;
+	out->item.put_weight = item->put_weight;
+	out->item.get_weight = item->get_weight;
+	g_strlcpy(out->item.addr, item->addr, sizeof(out->item.addr));
+	g_strlcpy(out->item.internal_addr, item->internal_addr,
+			sizeof(out->item.internal_addr));
+	g_strlcpy(out->item.id, item->id, sizeof(out->item.id));
+	g_strlcpy(out->item.tls, item->tls, sizeof(out->item.tls));
+	out->acc_weight = si->acc_weight;
+	for (int level = 1; items_by_loc && level < OIO_LB_LOC_LEVELS; level++) {
+		out->items_at_loc[level] = _loc_counters_get(items_by_loc + level,
+				_loc_counters_key(item->location, level));
+	}
+}
+
+/* Copy the slot, that must have been rehashed, in one flat block */
+static struct _slot_snapshot_s *
+_slot_snapshot_build(struct oio_lb_slot_s *slot)
+{
+	EXTRA_ASSERT(!_slot_needs_rehash(slot));
+	const guint n = slot->items->len;
+	const guint nz = slot->zero_scored_items->len;
+	struct _slot_snapshot_s *snap = g_malloc0(sizeof(*snap)
+			+ (n + nz) * sizeof(struct _snapshot_item_s));
+	snap->refcount = 1;
+	snap->name = g_strdup(slot->name);
+	snap->sum_weight = slot->sum_weight;
+	snap->jump = slot->jump;
+	memcpy(snap->locs_by_level, slot->locs_by_level,
+			sizeof(snap->locs_by_level));
+	snap->n_items = n;
+	snap->n_zero_scored = nz;
+	snap->zero_scored_items = snap->items + n;
+	for (guint i = 0; i < n; i++)
+		_snapshot_item_fill(snap->items + i, &SLOT_ITEM(slot, i),
+				slot->items_by_loc);
+	for (guint i = 0; i < nz; i++)
+		_snapshot_item_fill(snap->zero_scored_items + i,
+				&ZERO_SCORED_ITEM(slot, i), NULL);
+	return snap;
+}
+
+static struct _slot_snapshot_s *
+_slot_snapshot_ref(struct _slot_snapshot_s *snap)
+{
+	g_atomic_int_inc(&snap->refcount);
+	return snap;
+}
+
+static void
+_slot_snapshot_unref(struct _slot_snapshot_s *snap)
+{
+	if (snap && g_atomic_int_dec_and_test(&snap->refcount)) {
+		g_free(snap->name);
+		g_free(snap);
+	}
+}
+
+static void
+_world_snapshot_unref(struct _world_snapshot_s *snap)
+{
+	if (snap && g_atomic_int_dec_and_test(&snap->refcount)) {
+		g_hash_table_destroy(snap->slots);
+		g_free(snap);
+	}
+}
+
+/* Source of the IDs of the snapshots of all the worlds */
+static gsize world_snapshot_last_id = 0;
+
+/* Publish a new snapshot of the world for the pollers. Only the slots
+ * rehashed since the last publication are copied, the other slots share
+ * their previous snapshot. A slot still waiting for its rehash also keeps
+ * its previous snapshot: the pollers never see a slot half-fed.
+ * Must be called with the writer lock held. */
+static void
+_world_publish_unlocked(struct oio_lb_world_s *self)
+{
+	if (self->snapshot && !self->flag_dirty_snapshot)
+		return;
+
+	struct _world_snapshot_s *snap = g_malloc0(sizeof(*snap));
+	snap->refcount = 1;
+	snap->id = 1 + (gsize) g_atomic_pointer_add(&world_snapshot_last_id, 1);
+	snap->world = self;
+	snap->abs_max_dist = self->abs_max_dist;
+	snap->slots = g_hash_table_new_full(g_str_hash, g_str_equal,
+			NULL, (GDestroyNotify)_slot_snapshot_unref);
+
+	gboolean _on_slot(gpointer k UNUSED, struct oio_lb_slot_s *slot,
+			gpointer u UNUSED) {
+		if (slot->flag_dirty_snapshot && !_slot_needs_rehash(slot)) {
+			_slot_snapshot_unref(slot->snapshot);
+			slot->snapshot = _slot_snapshot_build(slot);
+			slot->flag_dirty_snapshot = 0;
+		}
+		if (slot->snapshot) {
+			g_hash_table_insert(snap->slots, slot->snapshot->name,
+					_slot_snapshot_ref(slot->snapshot));
+		}
+		return FALSE;
+	}
+	g_tree_foreach(self->slots, (GTraverseFunc)_on_slot, NULL);
+	self->flag_dirty_snapshot = 0;
+
+	g_mutex_lock(&self->snapshot_lock);
+	struct _world_snapshot_s *old = self->snapshot;
+	self->snapshot = snap;
+	g_atomic_pointer_set(&self->snapshot_id, snap->id);
+	g_mutex_unlock(&self->snapshot_lock);
+
+	_world_snapshot_unref(old);
+}
+
+#define LB_SNAPSHOT_CACHE_SIZE 8
+
+/* References held by a thread on the last snapshots it used, so that the
+ * lock of a world is only taken once per publication. */
+struct _snapshot_cache_s
+{
+	struct _world_snapshot_s *tab[LB_SNAPSHOT_CACHE_SIZE];
+};
+
+static void
+_snapshot_cache_free(struct _snapshot_cache_s *cache)
+{
+	for (guint i = 0; i < LB_SNAPSHOT_CACHE_SIZE; i++)
+		_world_snapshot_unref(cache->tab[i]);
+	g_free(cache);
+}
+
+static GPrivate snapshot_cache =
+		G_PRIVATE_INIT((GDestroyNotify)_snapshot_cache_free);
+
+/* Get the current snapshot of the world. No lock is taken as long as the
+ * calling thread already got the last snapshot published. The snapshot
+ * belongs to the cache of the thread, it remains valid until the next call
+ * for the same world in the same thread. */
+static const struct _world_snapshot_s *
+_world_snapshot_get(struct oio_lb_world_s *self)
+{
+	struct _snapshot_cache_s *cache = g_private_get(&snapshot_cache);
+	if (unlikely(!cache)) {
+		cache = g_malloc0(sizeof(*cache));
+		g_private_set(&snapshot_cache, cache);
+	}
+
+	struct _world_snapshot_s **pcached = cache->tab +
+			((GPOINTER_TO_SIZE(self) >> 4) % LB_SNAPSHOT_CACHE_SIZE);
+	struct _world_snapshot_s *cached = *pcached;
+	if (likely(cached && cached->world == self
+			&& cached->id == (gsize) g_atomic_pointer_get(&self->snapshot_id)))
+		return cached;
+
+	g_mutex_lock(&self->snapshot_lock);
+	struct _world_snapshot_s *current = self->snapshot;
+	g_atomic_int_inc(&current->refcount);
+	g_mutex_unlock(&self->snapshot_lock);
+
+	*pcached = current;
+	_world_snapshot_unref(cached);
+	return current;
+}
+
+static const struct _slot_snapshot_s *
+_world_snapshot_get_slot(const struct _world_snapshot_s *snap,
+		const char *name)
+{
+	EXTRA_ASSERT(oio_str_is_set(name));
+	return g_hash_table_lookup(snap->slots, name);
+}
+
+/* return the position of the first item with the same location as the
+ * value of <needle> at the given proximity level */
+static guint
+_snapshot_search_first_at_location(const struct _snapshot_item_s *tab,
+		const guint len, const oio_location_t needle,
+		const enum oio_loc_proximity_level_e lvl)
+{
+	const oio_location_t masked = oio_location_mask_after(needle, lvl);
+	guint low = 0, high = len;
+	while (low < high) {
+		const guint i_pivot = low + (high - low) / 2;
+		if (oio_location_mask_after(tab[i_pivot].item.location, lvl) < masked)
+			low = i_pivot + 1;
+		else
+			high = i_pivot;
+	}
+	if (low < len && masked == oio_location_mask_after(tab[low].item.location, lvl))
+		return low;
+	return (guint)-1;
 }
 
 static guint
@@ -906,15 +1290,13 @@ _count_similar_target_slots(struct oio_lb_pool_LOCAL_s *lb,
 /* return the position of the stored_item with the closest <acc_weight> to
  * the value of <needle> */
 static int
-_search_closest_weight (GArray *tab, const guint32 needle,
-		const guint start, const guint end)
+_search_closest_weight (const struct _snapshot_item_s *tab,
+		const guint32 needle, const guint start, const guint end)
 {
-	EXTRA_ASSERT (start < tab->len);
-	EXTRA_ASSERT (end < tab->len);
 	if (start >= end)
 		return end;
 	const guint i_pivot = start + ((end - start) / 2);
-	const guint32 w_pivot = TAB_ITEM(tab,i_pivot).acc_weight;
+	const guint32 w_pivot = tab[i_pivot].acc_weight;
 	GRID_TRACE2("%s needle=%"G_GUINT32_FORMAT" start=%u end=%u"
 			" i=%d w_pivot=%"G_GUINT32_FORMAT,
 			__FUNCTION__, needle, start, end, i_pivot, w_pivot);
@@ -926,10 +1308,11 @@ _search_closest_weight (GArray *tab, const guint32 needle,
 }
 
 static struct oio_lb_selected_item_s *
-_accept_item(struct oio_lb_slot_s *slot, const guint16 distance,
+_accept_item(const struct _slot_snapshot_s *slot, const guint16 distance,
 		struct polling_ctx_s *ctx, guint i)
 {
-	const struct _lb_item_s *item = _slot_get (slot, i);
+	const struct _snapshot_item_s *si = slot->items + i;
+	const struct oio_lb_item_s *item = &si->item;
 	const oio_location_t loc = item->location;
 	/* If ctx->strict_max_items is zero, max_by_level will be computed by
 	 * _item_is_too_popular(), otherwise it will be a copy of
@@ -938,21 +1321,21 @@ _accept_item(struct oio_lb_slot_s *slot, const guint16 distance,
 	guint8 pop_by_level[OIO_LB_LOC_LEVELS] = {0};
 
 	// Check the item is not in "avoids" list
-	if (_item_is_too_close(ctx->avoids, loc, 1))
+	if (_item_is_too_close(ctx->avoids, ctx->n_avoids, loc, 1))
 		return NULL;
 	if (ctx->adjacent_mode){
 		// Check the item is adjacent
-		if (_item_is_too_far(ctx->avoids, loc, distance)){
+		if (_item_is_too_far(ctx->avoids, ctx->n_avoids, loc, distance)){
 			return NULL;
 		}
 	}
 
 	// Check the item is not too close to already polled items
-	if (_item_is_too_close(ctx->polled, loc,
+	if (_item_is_too_close(ctx->polled, ctx->n_targets, loc,
 			ctx->check_distance? distance : 1))
 		return NULL;
 	// Check the item has not been chosen too much already
-	if (_item_is_too_popular(ctx, loc, slot, pop_by_level, max_by_level))
+	if (_item_is_too_popular(ctx, si, slot, pop_by_level, max_by_level))
 		return NULL;
 
 	GRID_TRACE("Accepting item %s (0x%"OIO_LOC_FORMAT") from slot %s",
@@ -983,13 +1366,13 @@ _accept_item(struct oio_lb_slot_s *slot, const guint16 distance,
 	if (ctx->check_distance) {
 		selected->final_dist = distance;
 	} else {
-		selected->final_dist = _find_min_dist(ctx->polled,
+		selected->final_dist = _find_min_dist(ctx->polled, ctx->n_targets,
 				selected->item->location, ctx->max_dist);
 	}
 
 	*(ctx->next_polled) = loc;
 
-	_level_datalist_incr_loc(ctx->counters, loc);
+	_level_counters_incr_loc(ctx->counters, loc);
 
 	return selected;
 }
@@ -1000,19 +1383,16 @@ _accept_item(struct oio_lb_slot_s *slot, const guint16 distance,
  * The purpose of the shuffled lookup is to jump to an item with
  * a distant location. */
 static struct oio_lb_selected_item_s *
-_local_slot__poll(struct oio_lb_slot_s *slot, guint16 distance,
+_local_slot__poll(const struct _slot_snapshot_s *slot, guint16 distance,
 		struct polling_ctx_s *ctx, guint n_targets)
 {
-	if (unlikely(_slot_needs_rehash(slot)))
-		_warn_dirty_poll("BUG: %s: LB reload not followed by rehash", __FUNCTION__);
-
 	GRID_TRACE2(
 			"%s slot=%s sum=%"G_GUINT32_FORMAT
-			" items=%d dist=%"G_GUINT16_FORMAT,
-			__FUNCTION__, slot->name, slot->sum_weight, slot->items->len,
+			" items=%u dist=%"G_GUINT16_FORMAT,
+			__FUNCTION__, slot->name, slot->sum_weight, slot->n_items,
 			distance);
 
-	if (slot->items->len == 0) {
+	if (slot->n_items == 0) {
 		GRID_TRACE2("%s slot empty", __FUNCTION__);
 		return NULL;
 	}
@@ -1046,11 +1426,11 @@ _local_slot__poll(struct oio_lb_slot_s *slot, guint16 distance,
 		/* get the closest */
 		guint32 random_weight = oio_ext_rand_int_range(0, slot->sum_weight);
 		i = _search_closest_weight(slot->items, random_weight, 0,
-				slot->items->len - 1);
+				slot->n_items - 1);
 		GRID_TRACE2("%s random_weight=%"G_GUINT32_FORMAT" at %d",
 				__FUNCTION__, random_weight, i);
 		EXTRA_ASSERT(i >= 0);
-		EXTRA_ASSERT((guint)i < slot->items->len);
+		EXTRA_ASSERT((guint)i < slot->n_items);
 		if ((selected =
 				_accept_item(slot, distance, ctx, i))) {
 			return selected;
@@ -1059,8 +1439,8 @@ _local_slot__poll(struct oio_lb_slot_s *slot, guint16 distance,
 
 	/* Shuffled lookup */
 	guint iter = 0;
-	while (iter++ < slot->items->len) {
-		i = (i + slot->jump) % slot->items->len;
+	while (iter++ < slot->n_items) {
+		i = (i + slot->jump) % slot->n_items;
 		if ((selected =
 				_accept_item(slot, distance, ctx, i))) {
 			return selected;
@@ -1073,6 +1453,7 @@ _local_slot__poll(struct oio_lb_slot_s *slot, guint16 distance,
 
 static struct oio_lb_selected_item_s *
 _local_target__poll(struct oio_lb_pool_LOCAL_s *lb,
+		const struct _world_snapshot_s *snap,
 		const char *target, guint16 distance, struct polling_ctx_s *ctx)
 {
 	GRID_TRACE2("%s pool=%s dist=%u target=%s",
@@ -1086,8 +1467,8 @@ _local_target__poll(struct oio_lb_pool_LOCAL_s *lb,
 	 * The other slots are fallbacks. */
 	guint n_targets = _count_similar_target_slots(lb, target);
 	for (const char *name = target; *name; name += 1+strlen(name)) {
-		struct oio_lb_slot_s *slot = oio_lb_world__get_slot_unlocked(
-				lb->world, name);
+		const struct _slot_snapshot_s *slot =
+				_world_snapshot_get_slot(snap, name);
 		if (!slot) {
 			GRID_DEBUG ("Slot [%s] not ready", name);
 		} else if ((selected =
@@ -1118,7 +1499,7 @@ _local__poll (struct oio_lb_pool_s *self,
 }
 
 static struct oio_lb_selected_item_s*
-_local_target__is_satisfied(struct oio_lb_pool_LOCAL_s *lb,
+_local_target__is_satisfied(const struct _world_snapshot_s *snap,
 		const char *target, struct polling_ctx_s *ctx,
 		gboolean strict)
 {
@@ -1139,26 +1520,21 @@ _local_target__is_satisfied(struct oio_lb_pool_LOCAL_s *lb,
 	/* Iterate over the slots of the target to find if one of the
 	** already known locations is inside, and thus satisfies the target. */
 	for (const char *name = target; *name; name += strlen(name)+1) {
-		struct oio_lb_slot_s *slot = oio_lb_world__get_slot_unlocked(
-				lb->world, name);
+		const struct _slot_snapshot_s *slot =
+				_world_snapshot_get_slot(snap, name);
 		if (!slot) {
 			GRID_DEBUG ("Slot [%s] not ready", name);
 			continue;
 		}
-		if (unlikely(_slot_needs_rehash(slot))) {
-			_warn_dirty_poll("BUG: %s: LB reload not followed by rehash",
-					__FUNCTION__);
-		}
 		// FIXME(FVE): input should be service IDs, not locations.
 		oio_location_t *known = ctx->next_polled;
 		do {
-			guint pos = _search_first_at_location(slot->items,
-					*known, OIO_LOC_PROX_VOLUME,
-					0, slot->items->len-1);
+			guint pos = _snapshot_search_first_at_location(slot->items,
+					slot->n_items, *known, OIO_LOC_PROX_VOLUME);
 			if (pos == (guint)-1 && strict) {
-				pos = _search_first_at_location(slot->zero_scored_items,
-						*known, OIO_LOC_PROX_VOLUME,
-						0, slot->zero_scored_items->len-1);
+				pos = _snapshot_search_first_at_location(
+						slot->zero_scored_items, slot->n_zero_scored,
+						*known, OIO_LOC_PROX_VOLUME);
 			}
 			if (pos != (guint)-1) {
 				/* The current item is in a slot referenced by our target.
@@ -1189,12 +1565,13 @@ _local_target__is_satisfied(struct oio_lb_pool_LOCAL_s *lb,
 
 static void
 _match_known_services_with_targets(struct oio_lb_pool_LOCAL_s *lb,
+		const struct _world_snapshot_s *snap,
 		struct polling_ctx_s *ctx, gchar **unmatched)
 {
 	EXTRA_ASSERT(unmatched != NULL);
 	for (gchar **ptarget = lb->targets; *ptarget; ++ptarget) {
 		struct oio_lb_selected_item_s *selected = NULL;
-		selected = _local_target__is_satisfied(lb, *ptarget, ctx, TRUE);
+		selected = _local_target__is_satisfied(snap, *ptarget, ctx, TRUE);
 		if (selected) {
 			++(ctx->next_polled);
 			g_ptr_array_add(ctx->selection, selected);
@@ -1208,15 +1585,17 @@ _match_known_services_with_targets(struct oio_lb_pool_LOCAL_s *lb,
 
 static gboolean
 _match_item_with_targets(struct oio_lb_pool_LOCAL_s *lb,
+		const struct _world_snapshot_s *snap,
 		struct oio_lb_selected_item_s *selected)
 {
 	for (gchar **ptarget = lb->targets; *ptarget; ++ptarget) {
 		// Lookup only the first slot of each target.
-		struct oio_lb_slot_s *slot = oio_lb_world__get_slot_unlocked(
-				lb->world, *ptarget);
-		guint pos = _search_first_at_location(slot->items,
-				selected->item->location, OIO_LOC_PROX_VOLUME,
-				0, slot->items->len-1);
+		const struct _slot_snapshot_s *slot =
+				_world_snapshot_get_slot(snap, *ptarget);
+		if (!slot)
+			continue;
+		guint pos = _snapshot_search_first_at_location(slot->items,
+				slot->n_items, selected->item->location, OIO_LOC_PROX_VOLUME);
 		if (pos != (guint)-1) {
 			oio_str_replace(&(selected->expected_slot), *ptarget);
 			oio_str_replace(&(selected->final_slot), *ptarget);
@@ -1230,15 +1609,13 @@ static void
 _debug_service_selection(struct polling_ctx_s *ctx)
 {
 	// FIXME: there is similar code in _slot_rehash()
-	void _display(GQuark k, gpointer data, gpointer u) {
+	void _display(oio_location_t loc, guint32 count, gpointer u) {
 		guint level = GPOINTER_TO_UINT(u);
-		oio_location_t loc = (GPOINTER_TO_UINT(k) - 1);
 		GRID_DEBUG("%0*" G_GINT64_MODIFIER "X selected %u times",
-				4 * (OIO_LB_LOC_LEVELS - level),
-				loc, GPOINTER_TO_UINT(data));
+				4 * (OIO_LB_LOC_LEVELS - level), loc, count);
 	}
 	for (int level = 1; level < OIO_LB_LOC_LEVELS; level++)
-		g_datalist_foreach(&(ctx->counters[level]),
+		_loc_counters_foreach(&(ctx->counters[level]),
 				_display, GUINT_TO_POINTER(level));
 	guint i = 0;
 	void _display_selected(gpointer element, gpointer udata UNUSED) {
@@ -1254,8 +1631,19 @@ _debug_service_selection(struct polling_ctx_s *ctx)
 	g_ptr_array_foreach(ctx->selection, _display_selected, NULL);
 }
 
+/* Take the ownership of an item selected for the current placement
+ * of the batch. */
+static void
+_polling_batch_add(struct polling_batch_s *batch,
+		struct oio_lb_selected_item_s *sel)
+{
+	_level_counters_incr_loc(batch->counters, sel->item->location);
+	g_ptr_array_add(batch->out, sel);
+}
+
 static GError*
 __local__patch(struct oio_lb_pool_s *self,
+		const struct _world_snapshot_s *snap, struct polling_batch_s *batch,
 		const oio_location_t *avoids, const oio_location_t *known,
 		oio_lb_on_id_f on_id, gboolean force_fair_constraints,
 		gboolean adjacent_mode, gboolean *flawed)
@@ -1290,10 +1678,11 @@ __local__patch(struct oio_lb_pool_s *self,
 	/* Distance starts high, because we want services far from
 	 * each other. Then we reduce the distance and thus
 	 * have more chances to find services matching the other criteria. */
-	guint16 max_dist = MIN(lb->world->abs_max_dist, lb->initial_dist);
+	guint16 max_dist = MIN(snap->abs_max_dist, lb->initial_dist);
 
 	struct polling_ctx_s ctx = {
 		.avoids = avoids,
+		.n_avoids = _locations_count(avoids),
 		.polled = (const oio_location_t *) polled,
 		.next_polled = polled,
 		.n_targets = count_targets,
@@ -1301,37 +1690,37 @@ __local__patch(struct oio_lb_pool_s *self,
 		.force_fair_constraints = force_fair_constraints,
 		.max_dist = max_dist,
 		.min_dist = lb->min_dist,
-		.selection = g_ptr_array_new_with_free_func(
+		.selection = batch ? batch->selection : g_ptr_array_new_with_free_func(
 			(GDestroyNotify)oio_lb_selected_item_free),
 		.strict_max_items = lb->strict_max_items,
 		.fair_max_items = lb->fair_max_items,
 		.adjacent_mode = adjacent_mode,
+		.batch = batch,
 	};
 
-	for (int level = 1; level < OIO_LB_LOC_LEVELS; level++) {
-		g_datalist_init(&ctx.counters[level]);
-	}
+	_level_counters_init(ctx.counters, count_targets);
 	// If the locations are already known, update the counters
 	if (ctx.polled) {
 		for (const oio_location_t *loc = ctx.polled; *loc; loc++) {
-			_level_datalist_incr_loc(ctx.counters, *loc);
+			_level_counters_incr_loc(ctx.counters, *loc);
 		}
 	}
 
-	g_rw_lock_reader_lock(&lb->world->lock);
 	gchar *unmatched_targets[count_targets+1];
-	_match_known_services_with_targets(lb, &ctx, unmatched_targets);
+	_match_known_services_with_targets(lb, snap, &ctx, unmatched_targets);
 
 	guint count = 0;
 	GError *err = NULL;
 	for (gchar **ptarget = unmatched_targets; *ptarget; ++ptarget) {
 		struct oio_lb_selected_item_s *selected = NULL;
-		selected = _local_target__is_satisfied(lb, *ptarget, &ctx, FALSE);
+		selected = _local_target__is_satisfied(snap, *ptarget, &ctx, FALSE);
 		guint16 dist;
 		for (dist = max_dist; !selected && dist >= lb->min_dist; dist -= 1) {
-			selected = _local_target__poll(lb, *ptarget, dist, &ctx);
+			selected = _local_target__poll(lb, snap, *ptarget, dist, &ctx);
 		}
 		if (!selected) {
+			const struct _slot_snapshot_s *slot =
+					_world_snapshot_get_slot(snap, *ptarget);
 			GString *max_items = g_string_sized_new(32);
 			_print_items_tab(max_items,
 					force_fair_constraints ? lb->fair_max_items : lb->strict_max_items);
@@ -1347,8 +1736,7 @@ __local__patch(struct oio_lb_pool_s *self,
 					*ptarget,
 					count, count_targets - count_known_targets,
 					count_known_targets,
-					oio_lb_world__count_slot_items_unlocked(
-						lb->world, *ptarget),
+					slot ? slot->n_items : 0,
 					lb->min_dist,
 					force_fair_constraints ? "fair" : "strict",
 					max_items->str
@@ -1360,7 +1748,6 @@ __local__patch(struct oio_lb_pool_s *self,
 		++count;
 		g_ptr_array_add(ctx.selection, selected);
 	}
-	g_rw_lock_reader_unlock(&lb->world->lock);
 
 	gboolean _flawed = FALSE;
 	void _set_dists(gpointer element, guint cur) {
@@ -1373,7 +1760,7 @@ __local__patch(struct oio_lb_pool_s *self,
 			oio_location_t old = ctx.polled[cur];
 			polled[cur] = (oio_location_t)-1;
 			sel->final_dist = _find_min_dist(
-					polled, sel->item->location, ctx.max_dist);
+					polled, count_targets, sel->item->location, ctx.max_dist);
 			polled[cur] = old;
 
 			if (sel->final_dist <= lb->warn_dist) {
@@ -1395,29 +1782,38 @@ __local__patch(struct oio_lb_pool_s *self,
 		_debug_service_selection(&ctx);
 	}
 
-	for (int level = 1; level < OIO_LB_LOC_LEVELS; level++) {
-		g_datalist_clear(&ctx.counters[level]);
-	}
+	_level_counters_clear(ctx.counters);
 	if (err != NULL) {
 		GRID_WARN("%s", err->message);
 	} else {
 		if (flawed) {
 			*flawed = _flawed;
 		}
-		void _forward(struct oio_lb_selected_item_s *sel, gpointer u UNUSED) {
-			if (sel->item)
-				on_id(sel, NULL);
+		for (i = 0; i < ctx.selection->len; i++) {
+			struct oio_lb_selected_item_s *sel = ctx.selection->pdata[i];
 			// Do not forward "known" items (sel->item == NULL)
+			if (!sel->item)
+				continue;
+			if (batch) {
+				_polling_batch_add(batch, sel);
+				ctx.selection->pdata[i] = NULL;
+			} else {
+				// FIXME(FVE): change signature, specify last parameter
+				on_id(sel, NULL);
+			}
 		}
-		// FIXME(FVE): change signature, specify last parameter
-		g_ptr_array_foreach(ctx.selection, (GFunc)_forward, NULL);
 	}
-	g_ptr_array_free(ctx.selection, TRUE);
+	if (batch) {
+		g_ptr_array_remove_range(ctx.selection, 0, ctx.selection->len);
+	} else {
+		g_ptr_array_free(ctx.selection, TRUE);
+	}
 	return err;
 }
 
 static GError*
-_local__patch(struct oio_lb_pool_s *self,
+_local__patch_snapshot(struct oio_lb_pool_s *self,
+		const struct _world_snapshot_s *snap, struct polling_batch_s *batch,
 		const oio_location_t *avoids, const oio_location_t *known,
 		oio_lb_on_id_f on_id, gboolean force_fair_constraints,
 		gboolean adjacent_mode, gboolean *flawed)
@@ -1432,8 +1828,8 @@ _local__patch(struct oio_lb_pool_s *self,
 	if (oio_lb_try_fair_constraints_first && !force_fair_constraints
 			&& lb->fair_max_items[0]) {
 		// Quick attempt to find an ideal solution
-		GError *err = __local__patch(self, avoids, known, on_id, TRUE,
-				adjacent_mode, flawed);
+		GError *err = __local__patch(self, snap, batch, avoids, known, on_id,
+				TRUE, adjacent_mode, flawed);
 		if (!err) {
 			return NULL;
 		}
@@ -1442,8 +1838,24 @@ _local__patch(struct oio_lb_pool_s *self,
 				oio_ext_get_reqid(), err->code, err->message);
 		g_error_free(err);
 	}
-	return __local__patch(self, avoids, known, on_id, force_fair_constraints,
-			adjacent_mode, flawed);
+	return __local__patch(self, snap, batch, avoids, known, on_id,
+			force_fair_constraints, adjacent_mode, flawed);
+}
+
+/* The pollers work on the last snapshot of the world, and never wait for
+ * the world to be reloaded. */
+static GError*
+_local__patch(struct oio_lb_pool_s *self,
+		const oio_location_t *avoids, const oio_location_t *known,
+		oio_lb_on_id_f on_id, gboolean force_fair_constraints,
+		gboolean adjacent_mode, gboolean *flawed)
+{
+	struct oio_lb_pool_LOCAL_s *lb = (struct oio_lb_pool_LOCAL_s *) self;
+	EXTRA_ASSERT(lb != NULL);
+	EXTRA_ASSERT(lb->world != NULL);
+	return _local__patch_snapshot(self, _world_snapshot_get(lb->world), NULL,
+			avoids, known, on_id, force_fair_constraints, adjacent_mode,
+			flawed);
 }
 
 struct oio_lb_item_s *
@@ -1645,6 +2057,7 @@ oio_lb_local__create_world (void)
 {
 	struct oio_lb_world_s *self = g_malloc0 (sizeof(*self));
 	g_rw_lock_init(&self->lock);
+	g_mutex_init(&self->snapshot_lock);
 	self->slots = g_tree_new_full (oio_str_cmp3, NULL,
 			g_free, (GDestroyNotify) _slot_destroy);
 	self->items = g_tree_new_full (oio_str_cmp3, NULL,
@@ -1657,13 +2070,18 @@ oio_lb_local__create_world (void)
 # else
 	/* Keep it 0, we will increase it when adding items. */
 # endif
+
+	/* The pollers always find a snapshot */
+	_world_publish_unlocked(self);
 	return self;
 }
 
 static gboolean
 _slot_flush_cb(gpointer k UNUSED, gpointer value, gpointer u UNUSED)
 {
-	_slot_flush((struct oio_lb_slot_s*)value);
+	struct oio_lb_slot_s *slot = value;
+	_slot_flush(slot);
+	_slot_rehash(slot);
 	return FALSE;
 }
 
@@ -1685,6 +2103,7 @@ oio_lb_world__flush(struct oio_lb_world_s *self)
 				g_free, g_free);
 	}
 	_oio_service_id_cache_flush();
+	_world_publish_unlocked(self);
 
 	g_rw_lock_writer_unlock(&self->lock);
 }
@@ -1705,6 +2124,11 @@ oio_lb_world__destroy (struct oio_lb_world_s *self)
 	}
 	g_rw_lock_writer_unlock(&self->lock);
 	g_rw_lock_clear(&self->lock);
+
+	/* The threads that polled the world may still reference the snapshot */
+	_world_snapshot_unref(self->snapshot);
+	self->snapshot = NULL;
+	g_mutex_clear(&self->snapshot_lock);
 	g_free (self);
 
 	_oio_service_id_cache_flush();
@@ -1737,13 +2161,13 @@ _world_create_slot (struct oio_lb_world_s *self, const char *name)
 		slot->name = g_strdup(name);
 		slot->items = g_array_new(FALSE, TRUE, sizeof(struct _slot_item_s));
 		slot->zero_scored_items = g_array_new(FALSE, TRUE, sizeof(struct _slot_item_s));
-		for (int level = 1; level < OIO_LB_LOC_LEVELS; level++) {
-			g_datalist_init(&(slot->items_by_loc[level]));
-		}
 		slot->jump = OIO_LB_SHUFFLE_JUMP;
+		slot->flag_dirty_snapshot = 1;
 		GRID_INFO("Creating service slot [%s]", name);
 		g_rw_lock_writer_lock(&self->lock);
 		g_tree_replace(self->slots, g_strdup(name), slot);
+		self->flag_dirty_snapshot = 1;
+		_world_publish_unlocked(self);
 		g_rw_lock_writer_unlock(&self->lock);
 	} else {
 		GRID_TRACE("Slot [%s] already exists", name);
@@ -2039,6 +2463,7 @@ oio_lb_world__feed_slot_unlocked(struct oio_lb_world_s *self,
 	guint16 max_dist = 1 + (n_bits - 1) / OIO_LB_BITS_PER_LOC_LEVEL;
 	if (self->abs_max_dist < max_dist) {
 		self->abs_max_dist = max_dist;
+		self->flag_dirty_snapshot = 1;
 		GRID_DEBUG("Absolute max_dist set to %u", max_dist);
 	}
 # endif
@@ -2053,6 +2478,7 @@ oio_lb_world__feed_slot (struct oio_lb_world_s *self, const char *name,
 	struct oio_lb_slot_s *slot = oio_lb_world__get_slot_unlocked(self, name);
 	if (slot)
 		oio_lb_world__feed_slot_unlocked(self, slot, item);
+	_world_publish_unlocked(self);
 	g_rw_lock_writer_unlock(&self->lock);
 }
 
@@ -2070,6 +2496,55 @@ oio_lb_world__feed_slot_with_list(struct oio_lb_world_s *self,
 		}
 		_slot_rehash(slot);
 	}
+	_world_publish_unlocked(self);
+	g_rw_lock_writer_unlock(&self->lock);
+}
+
+static gboolean
+_slot_remove_item(struct oio_lb_slot_s *slot, struct _lb_item_s *item0)
+{
+	gboolean removed = FALSE;
+	guint i = _find_slot_item(slot->items, slot->flag_dirty_order, item0);
+	if (i != (guint)-1) {
+		-- item0->refcount;
+		g_array_remove_index_fast(slot->items, i);
+		slot->flag_dirty_order = 1;
+		slot->flag_dirty_weights = 1;
+		removed = TRUE;
+	}
+	i = _find_slot_item(slot->zero_scored_items,
+			slot->flag_zero_scored_dirty_order, item0);
+	if (i != (guint)-1) {
+		-- item0->refcount;
+		g_array_remove_index_fast(slot->zero_scored_items, i);
+		slot->flag_zero_scored_dirty_order = 1;
+		removed = TRUE;
+	}
+	return removed;
+}
+
+void
+oio_lb_world__remove_item(struct oio_lb_world_s *self, const char *id)
+{
+	EXTRA_ASSERT(self != NULL);
+	EXTRA_ASSERT(oio_str_is_set(id));
+
+	g_rw_lock_writer_lock(&self->lock);
+	struct _lb_item_s *item0 = g_tree_lookup(self->items, id);
+	if (item0 && item0->refcount > 0) {
+		gboolean _on_slot(gpointer k UNUSED, struct oio_lb_slot_s *slot,
+				gpointer u UNUSED) {
+			if (_slot_remove_item(slot, item0)) {
+				GRID_DEBUG("LB removed %s from slot %s", item0->id, slot->name);
+				if (slot->flag_rehash_on_update)
+					_slot_rehash(slot);
+			}
+			/* Stop as soon as the item is in no other slot */
+			return item0->refcount == 0;
+		}
+		g_tree_foreach(self->slots, (GTraverseFunc)_on_slot, NULL);
+	}
+	_world_publish_unlocked(self);
 	g_rw_lock_writer_unlock(&self->lock);
 }
 
@@ -2148,7 +2623,8 @@ _world_rehash_slots(struct oio_lb_world_s *self)
 		return FALSE;
 	}
 	WRITER_LOCK_DO(&self->lock,
-			g_tree_foreach(self->slots, (GTraverseFunc)_on_slot_rehash, self));
+			g_tree_foreach(self->slots, (GTraverseFunc)_on_slot_rehash, self);
+			_world_publish_unlocked(self));
 }
 
 static guint
@@ -2196,7 +2672,8 @@ _world_purge_slot_items(struct oio_lb_world_s *self, guint32 age)
 
 
 	WRITER_LOCK_DO(&self->lock, g_tree_foreach(self->slots,
-			(GTraverseFunc)_on_slot_purge_inside, self));
+			(GTraverseFunc)_on_slot_purge_inside, self);
+			_world_publish_unlocked(self));
 }
 
 static void
@@ -2218,7 +2695,9 @@ _world_purge_slots(struct oio_lb_world_s *self, guint32 age)
 		_slot_flush(slot);
 		GRID_DEBUG("LB removed slot %s", slot->name);
 		g_tree_remove(self->slots, slot->name);
+		self->flag_dirty_snapshot = 1;
 	}
+	_world_publish_unlocked(self);
 	g_rw_lock_writer_unlock(&self->lock);
 
 	g_slist_free(slots);
@@ -2364,46 +2843,26 @@ _unique_slotnames(gchar **targets)
 }
 
 static GPtrArray *
-_unique_services(struct oio_lb_pool_LOCAL_s *lb, gchar **slots, oio_location_t pin)
+_unique_services(const struct _world_snapshot_s *snap, gchar **slots,
+		oio_location_t pin)
 {
 	pin = oio_location_mask_after(pin, OIO_LOC_DIST_HOST);
 
 	GTree *t = g_tree_new_full(oio_str_cmp3, NULL, NULL, NULL);
 	for (gchar **pname = slots; *pname; ++pname) {
-		struct oio_lb_slot_s *slot =
-			oio_lb_world__get_slot_unlocked(lb->world, *pname);
+		const struct _slot_snapshot_s *slot =
+				_world_snapshot_get_slot(snap, *pname);
 		if (!slot)
 			continue;
-		if (slot->flag_dirty_order) {
-			// Linear total collection of items
-			for (guint i=0; i < slot->items->len; ++i) {
-				struct _lb_item_s *item = SLOT_ITEM(slot,i).item;
-				if (pin == oio_location_mask_after(item->location, OIO_LOC_DIST_HOST))
-					g_tree_replace(t, item->addr, item);
-			}
-		} else {
-			// Binary lookup of the first item. If not found, it returns -1,
-			// e.g. the biggest integer possible that will prevent the loop.
-			guint i = _search_first_at_location(slot->items,
-					pin, OIO_LOC_PROX_HOST, 0, slot->items->len-1);
-
-#ifdef HAVE_EXTRA_ASSERT
-#define CHECK_HLOC(pin,op,i) g_assert_cmpuint(pin, op, \
-		oio_location_mask_after(SLOT_ITEM(slot,(i)).item->location, OIO_LOC_DIST_HOST))
-			if (i != (guint)-1) {
-				// check this is well the first item of its slice
-				if (i > 0)
-					CHECK_HLOC(pin, !=, i-1);
-				CHECK_HLOC(pin, ==, i);
-			}
-#endif
-
-			for (; i < slot->items->len; ++i) {
-				struct _lb_item_s *item = SLOT_ITEM(slot, i).item;
-				if (pin != oio_location_mask_after(item->location, OIO_LOC_DIST_HOST))
-					break;
-				g_tree_replace(t, item->id, item);
-			}
+		// Binary lookup of the first item. If not found, it returns -1,
+		// e.g. the biggest integer possible that will prevent the loop.
+		guint i = _snapshot_search_first_at_location(slot->items,
+				slot->n_items, pin, OIO_LOC_PROX_HOST);
+		for (; i < slot->n_items; ++i) {
+			const struct oio_lb_item_s *item = &slot->items[i].item;
+			if (pin != oio_location_mask_after(item->location, OIO_LOC_DIST_HOST))
+				break;
+			g_tree_replace(t, (gpointer)item->id, (gpointer)item);
 		}
 	}
 
@@ -2419,6 +2878,7 @@ _unique_services(struct oio_lb_pool_LOCAL_s *lb, gchar **slots, oio_location_t p
 
 static GError*
 _local__poll_around(struct oio_lb_pool_s *self,
+		const struct _world_snapshot_s *snap, struct polling_batch_s *batch,
 		const oio_location_t pin, int mode,
 		oio_lb_on_id_f on_id, gboolean *flawed)
 {
@@ -2436,8 +2896,6 @@ _local__poll_around(struct oio_lb_pool_s *self,
 	GPtrArray *selection = g_ptr_array_new_with_free_func(
 			(GDestroyNotify)oio_lb_selected_item_free);
 
-	g_rw_lock_reader_lock(&lb->world->lock);
-
 	// First we collect all the unique targets names in the pool
 	GPtrArray *suspects = NULL;
 	do {
@@ -2445,7 +2903,7 @@ _local__poll_around(struct oio_lb_pool_s *self,
 #ifdef HAVE_EXTRA_DEBUG
 		count_slots = g_strv_length(slotnames);
 #endif
-		suspects = _unique_services(lb, slotnames, pin);
+		suspects = _unique_services(snap, slotnames, pin);
 		g_free(slotnames);
 	} while (0);
 
@@ -2459,7 +2917,7 @@ _local__poll_around(struct oio_lb_pool_s *self,
 		oio_str_randomize(slot + sizeof(PREFIX_SLOT_SKEW) - 1,
 				sizeof(SUFFIX_SLOT_SKEW) - 1, HEXA);
 
-		guint16 max_dist = MIN(lb->world->abs_max_dist, lb->initial_dist);
+		guint16 max_dist = MIN(snap->abs_max_dist, lb->initial_dist);
 		guint i = max_suspects > 1
 			? oio_ext_rand_int_range(0, max_suspects) : 0;
 		if (mode == 1) {
@@ -2467,7 +2925,7 @@ _local__poll_around(struct oio_lb_pool_s *self,
 			// OSEF the weight -> the other chunks will respect a weighted random
 			struct oio_lb_selected_item_s *selected = \
 					_item_select(suspects->pdata[i]);
-			if (!_match_item_with_targets(lb, selected)) {
+			if (!_match_item_with_targets(lb, snap, selected)) {
 				selected->expected_slot = g_strdup("rawx");
 				selected->final_slot = g_strdup(slot);
 			}
@@ -2483,7 +2941,7 @@ _local__poll_around(struct oio_lb_pool_s *self,
 						_item_select(suspects->pdata[i]);
 				// FIXME(FVE): this is broken since we may match several times
 				// the same target (which should be matched only once).
-				if (!_match_item_with_targets(lb, selected)) {
+				if (!_match_item_with_targets(lb, snap, selected)) {
 					selected->expected_slot = g_strdup("rawx");
 					selected->final_slot = g_strdup(slot);
 				}
@@ -2496,8 +2954,6 @@ _local__poll_around(struct oio_lb_pool_s *self,
 		}
 	}
 
-	g_rw_lock_reader_unlock(&lb->world->lock);
-
 	const guint nb_locals = selection->len;
 	GRID_TRACE("%s pin=%" G_GINT64_MODIFIER "x mode=%d targets=%u slots=%u suspects=%u locals=%u",
 			__FUNCTION__, pin, mode,
@@ -2518,7 +2974,7 @@ _local__poll_around(struct oio_lb_pool_s *self,
 		}
 		known[selection->len] = 0;
 		gboolean force_fair_constraints = FALSE;
-		err = _local__patch(self, NULL, known, _select,
+		err = _local__patch_snapshot(self, snap, NULL, NULL, known, _select,
 				force_fair_constraints, FALSE, flawed);
 	}
 
@@ -2526,8 +2982,14 @@ _local__poll_around(struct oio_lb_pool_s *self,
 		*flawed = TRUE;
 
 	// If no error occurred, we can upstream the polled services
-	for (guint i=0; !err && i < selection->len; ++i)
-		on_id(selection->pdata[i], NULL);
+	for (guint i=0; !err && i < selection->len; ++i) {
+		if (batch) {
+			_polling_batch_add(batch, selection->pdata[i]);
+			selection->pdata[i] = NULL;
+		} else {
+			on_id(selection->pdata[i], NULL);
+		}
+	}
 
 	g_ptr_array_free(selection, TRUE);
 	g_ptr_array_free(suspects, TRUE);
@@ -2547,11 +3009,89 @@ oio_lb__poll_pool_around(struct oio_lb_s *lb, const char *name,
 
 	GRID_TRACE("%s pin=%"G_GINT64_MODIFIER"x mode=%d", __FUNCTION__, pin, mode);
 
+	GError *res = NULL;
+	g_rw_lock_reader_lock(&lb->lock);
+	struct oio_lb_pool_s *pool = g_hash_table_lookup(lb->pools, name);
+	if (pool) {
+		struct oio_lb_pool_LOCAL_s *local = (struct oio_lb_pool_LOCAL_s *) pool;
+		res = _local__poll_around(pool, _world_snapshot_get(local->world), NULL,
+				pin, mode, on_id, flawed);
+	} else {
+		res = BADREQ("pool [%s] not found", name);
+	}
+	g_rw_lock_reader_unlock(&lb->lock);
+	return res;
+}
+
+static GError*
+_local__poll_many(struct oio_lb_pool_s *self, guint shots,
+		const oio_location_t pin, int mode,
+		GPtrArray **out, gboolean *flawed)
+{
+	struct oio_lb_pool_LOCAL_s *lb = (struct oio_lb_pool_LOCAL_s *) self;
+	EXTRA_ASSERT(lb != NULL);
+	EXTRA_ASSERT(lb->vtable == &vtable_LOCAL);
+	EXTRA_ASSERT(lb->world != NULL);
+
+	/* All the placements are polled from the same snapshot */
+	const struct _world_snapshot_s *snap = _world_snapshot_get(lb->world);
+	const guint count_targets = oio_lb_world__count_pool_targets(self);
+	struct polling_batch_s batch = {
+		.done = 0,
+		.selection = g_ptr_array_sized_new(count_targets),
+		.out = g_ptr_array_sized_new(shots * count_targets),
+	};
+	g_ptr_array_set_free_func(batch.selection,
+			(GDestroyNotify)oio_lb_selected_item_free);
+	g_ptr_array_set_free_func(batch.out,
+			(GDestroyNotify)oio_lb_selected_item_free);
+	_level_counters_init(batch.counters, count_targets);
+
+	GError *err = NULL;
+	gboolean _flawed = FALSE;
+	for (; !err && batch.done < shots; batch.done++) {
+		gboolean shot_flawed = FALSE;
+		if (pin && mode) {
+			err = _local__poll_around(self, snap, &batch, pin, mode,
+					NULL, &shot_flawed);
+		} else {
+			err = _local__patch_snapshot(self, snap, &batch, NULL, NULL,
+					NULL, FALSE, FALSE, &shot_flawed);
+		}
+		if (err)
+			g_prefix_error(&err, "placement %u/%u: ", batch.done + 1, shots);
+		_flawed |= shot_flawed;
+	}
+
+	_level_counters_clear(batch.counters);
+	g_ptr_array_free(batch.selection, TRUE);
+	if (err) {
+		g_ptr_array_free(batch.out, TRUE);
+	} else {
+		*out = batch.out;
+		if (flawed)
+			*flawed = _flawed;
+	}
+	return err;
+}
+
+GError*
+oio_lb__poll_pool_many(struct oio_lb_s *lb, const char *name, guint shots,
+		const oio_location_t pin, int mode,
+		GPtrArray **out, gboolean *flawed)
+{
+	EXTRA_ASSERT(lb != NULL);
+	EXTRA_ASSERT(oio_str_is_set(name));
+	EXTRA_ASSERT(out != NULL);
+
+	GRID_TRACE("%s shots=%u pin=%"G_GINT64_MODIFIER"x mode=%d",
+			__FUNCTION__, shots, pin, mode);
+
 	GError *res = NULL;
 	g_rw_lock_reader_lock(&lb->lock);
 	struct oio_lb_pool_s *pool = g_hash_table_lookup(lb->pools, name);
 	if (pool)
-		res = _local__poll_around(pool, pin, mode, on_id, flawed);
+		res = _local__poll_many(pool, shots, pin, mode, out, flawed);
 	else
 		res = BADREQ("pool [%s] not found", name);
 	g_rw_lock_reader_unlock(&lb->lock);
@@ -0,0 +1,410 @@
+/*
+OpenIO SDS core library
+Copyright (C) 2025 OVH SAS
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 3.0 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+*/
+
+#include "lruhash.h"
+#include "oioext.h"
+#include "internals.h"
+
+struct _hnode_s
+{
+	struct _hnode_s *prev;
+	struct _hnode_s *next;
+
+	gint64 atime;
+	gboolean referenced;
+	gpointer k;
+	gpointer v;
+};
+
+struct _shard_s
+{
+	GMutex lock;
+
+	/* Maps the key of each node to the node, the key is borrowed */
+	GHashTable *nodes;
+
+	/* The ring of the CLOCK: new items are pushed at the front, the hand
+	 * sweeps from the back. */
+	struct _hnode_s *first;
+	struct _hnode_s *last;
+
+	gint64 count;
+};
+
+struct lru_hash_s
+{
+	GHashFunc khash;
+	GDestroyNotify kfree;
+	GDestroyNotify vfree;
+	guint32 flags;
+
+	guint mask;
+	struct _shard_s shards[];
+};
+
+/* Nodes handling ---------------------------------------------------------- */
+
+static void
+_node_destroy(struct lru_hash_s *lh, struct _hnode_s *node)
+{
+	if (lh->vfree && node->v)
+		lh->vfree(node->v);
+	if (lh->kfree && node->k)
+		lh->kfree(node->k);
+	g_slice_free(struct _hnode_s, node);
+}
+
+static void
+_node_deq_extract(struct _shard_s *s, struct _hnode_s *node)
+{
+	if (s->first == node)
+		s->first = node->next;
+	if (s->last == node)
+		s->last = node->prev;
+	if (node->prev)
+		node->prev->next = node->next;
+	if (node->next)
+		node->next->prev = node->prev;
+	node->next = node->prev = NULL;
+}
+
+static void
+_node_deq_push_front(struct _shard_s *s, struct _hnode_s *node)
+{
+	node->prev = NULL;
+	node->next = s->first;
+	if (s->first)
+		s->first->prev = node;
+	else
+		s->last = node;
+	s->first = node;
+}
+
+/* Shards handling --------------------------------------------------------- */
+
+static struct _shard_s *
+_shard(struct lru_hash_s *lh, gconstpointer k)
+{
+	guint h = lh->khash(k);
+	/* The low bits are also used by the hash table of the shard */
+	h ^= h >> 16;
+	return lh->shards + (h & lh->mask);
+}
+
+/* Unlinks the node, the caller is responsible for freeing it */
+static void
+_shard_unlink(struct _shard_s *s, struct _hnode_s *node)
+{
+	g_hash_table_remove(s->nodes, node->k);
+	_node_deq_extract(s, node);
+	-- s->count;
+}
+
+static guint
+_shard_remove_matching(struct lru_hash_s *lh, struct _shard_s *s,
+		gboolean (*filter) (struct _hnode_s *node, gpointer u), gpointer u)
+{
+	guint removed = 0;
+	for (struct _hnode_s *node = s->first; node; ) {
+		struct _hnode_s *next = node->next;
+		if (filter(node, u)) {
+			_shard_unlink(s, node);
+			_node_destroy(lh, node);
+			++ removed;
+		}
+		node = next;
+	}
+	return removed;
+}
+
+static guint
+_shard_remove_exceeding(struct lru_hash_s *lh, struct _shard_s *s,
+		gint64 count)
+{
+	guint removed = 0;
+	/* Each marked item is moved back to the front once, unmarked. So the
+	 * loop ends after at most two sweeps of the ring. */
+	while (s->last && s->count > count) {
+		struct _hnode_s *node = s->last;
+		if (node->referenced) {
+			node->referenced = FALSE;
+			_node_deq_extract(s, node);
+			_node_deq_push_front(s, node);
+		} else {
+			_shard_unlink(s, node);
+			_node_destroy(lh, node);
+			++ removed;
+		}
+	}
+	return removed;
+}
+
+/* Main structure handling ------------------------------------------------- */
+
+struct lru_hash_s*
+lru_hash_create(GHashFunc hash, GEqualFunc equal,
+		GDestroyNotify kfree, GDestroyNotify vfree, guint32 options,
+		guint shards)
+{
+	EXTRA_ASSERT(hash != NULL);
+	EXTRA_ASSERT(equal != NULL);
+
+	guint nb = 1;
+	while (nb < shards && nb < 4096)
+		nb <<= 1;
+
+	struct lru_hash_s *lh = g_malloc0(sizeof(struct lru_hash_s)
+			+ nb * sizeof(struct _shard_s));
+	lh->khash = hash;
+	lh->kfree = kfree;
+	lh->vfree = vfree;
+	lh->flags = options;
+	lh->mask = nb - 1;
+	for (guint i = 0; i < nb; i++) {
+		struct _shard_s *s = lh->shards + i;
+		g_mutex_init(&s->lock);
+		s->nodes = g_hash_table_new(hash, equal);
+	}
+	return lh;
+}
+
+void
+lru_hash_destroy(struct lru_hash_s *lh)
+{
+	if (!lh)
+		return;
+
+	for (guint i = 0; i <= lh->mask; i++) {
+		struct _shard_s *s = lh->shards + i;
+		while (s->first) {
+			struct _hnode_s *node = s->first;
+			s->first = node->next;
+			_node_destroy(lh, node);
+		}
+		g_hash_table_destroy(s->nodes);
+		g_mutex_clear(&s->lock);
+	}
+	g_free(lh);
+}
+
+void
+lru_hash_insert_merge(struct lru_hash_s *lh, gpointer k, gpointer v,
+		void (*merge) (gpointer v, gconstpointer previous))
+{
+	EXTRA_ASSERT(lh != NULL);
+	EXTRA_ASSERT(k != NULL);
+	EXTRA_ASSERT(v != NULL);
+
+	gpointer old_k = NULL, old_v = NULL;
+	const gint64 now = oio_ext_monotonic_time();
+	struct _shard_s *s = _shard(lh, k);
+
+	g_mutex_lock(&s->lock);
+	struct _hnode_s *node = g_hash_table_lookup(s->nodes, k);
+	if (!node) {
+		node = g_slice_new0(struct _hnode_s);
+		node->k = k;
+		node->v = v;
+		node->atime = now;
+		g_hash_table_insert(s->nodes, k, node);
+		_node_deq_push_front(s, node);
+		++ s->count;
+	} else {
+		if (merge)
+			merge(v, node->v);
+		/* The keys are equal, keep the one already indexed */
+		old_k = k;
+		old_v = node->v;
+		node->v = v;
+		if (!(lh->flags & LTO_NOUTIME)) {
+			node->atime = now;
+			node->referenced = TRUE;
+		}
+	}
+	g_mutex_unlock(&s->lock);
+
+	/* Free out of the critical section */
+	if (old_v && lh->vfree)
+		lh->vfree(old_v);
+	if (old_k && lh->kfree)
+		lh->kfree(old_k);
+}
+
+void
+lru_hash_insert(struct lru_hash_s *lh, gpointer k, gpointer v)
+{
+	lru_hash_insert_merge(lh, k, v, NULL);
+}
+
+gpointer
+lru_hash_get(struct lru_hash_s *lh, gconstpointer k, GBoxedCopyFunc copy)
+{
+	EXTRA_ASSERT(lh != NULL);
+	EXTRA_ASSERT(k != NULL);
+
+	gpointer result = NULL;
+	struct _shard_s *s = _shard(lh, k);
+
+	g_mutex_lock(&s->lock);
+	struct _hnode_s *node = g_hash_table_lookup(s->nodes, k);
+	if (node) {
+		if (!(lh->flags & LTO_NOATIME)) {
+			node->atime = oio_ext_monotonic_time();
+			node->referenced = TRUE;
+		}
+		result = copy ? copy(node->v) : node->v;
+	}
+	g_mutex_unlock(&s->lock);
+
+	return result;
+}
+
+gboolean
+lru_hash_remove(struct lru_hash_s *lh, gconstpointer k)
+{
+	EXTRA_ASSERT(lh != NULL);
+	EXTRA_ASSERT(k != NULL);
+
+	struct _shard_s *s = _shard(lh, k);
+
+	g_mutex_lock(&s->lock);
+	struct _hnode_s *node = g_hash_table_lookup(s->nodes, k);
+	if (node)
+		_shard_unlink(s, node);
+	g_mutex_unlock(&s->lock);
+
+	if (!node)
+		return FALSE;
+	_node_destroy(lh, node);
+	return TRUE;
+}
+
+void
+lru_hash_foreach(struct lru_hash_s *lh, GTraverseFunc h, gpointer hdata)
+{
+	EXTRA_ASSERT(lh != NULL);
+	EXTRA_ASSERT(h != NULL);
+
+	gboolean stop = FALSE;
+	for (guint i = 0; !stop && i <= lh->mask; i++) {
+		struct _shard_s *s = lh->shards + i;
+		g_mutex_lock(&s->lock);
+		for (struct _hnode_s *node = s->first; !stop && node;
+				node = node->next)
+			stop = h(node->k, node->v, hdata);
+		g_mutex_unlock(&s->lock);
+	}
+}
+
+void
+lru_hash_foreach_steal(struct lru_hash_s *lh,
+		GTraverseFunc func, gpointer hdata)
+{
+	EXTRA_ASSERT(lh != NULL);
+	EXTRA_ASSERT(func != NULL);
+
+	for (guint i = 0; i <= lh->mask; i++) {
+		struct _shard_s *s = lh->shards + i;
+
+		g_mutex_lock(&s->lock);
+		struct _hnode_s *node = s->first;
+		s->first = s->last = NULL;
+		s->count = 0;
+		g_hash_table_remove_all(s->nodes);
+		g_mutex_unlock(&s->lock);
+
+		while (node) {
+			struct _hnode_s *next = node->next;
+			func(node->k, node->v, hdata);
+			g_slice_free(struct _hnode_s, node);
+			node = next;
+		}
+	}
+}
+
+guint
+lru_hash_remove_older(struct lru_hash_s *lh, gint64 oldest)
+{
+	EXTRA_ASSERT(lh != NULL);
+
+	gboolean _older(struct _hnode_s *node, gpointer u UNUSED) {
+		return node->atime < oldest;
+	}
+
+	guint removed = 0;
+	for (guint i = 0; i <= lh->mask; i++) {
+		struct _shard_s *s = lh->shards + i;
+		g_mutex_lock(&s->lock);
+		removed += _shard_remove_matching(lh, s, _older, NULL);
+		g_mutex_unlock(&s->lock);
+	}
+	return removed;
+}
+
+guint
+lru_hash_remove_exceeding(struct lru_hash_s *lh, guint count)
+{
+	EXTRA_ASSERT(lh != NULL);
+
+	const guint nb = lh->mask + 1;
+	guint removed = 0;
+	for (guint i = 0; i < nb; i++) {
+		struct _shard_s *s = lh->shards + i;
+		const gint64 quota = count / nb + (i < count % nb ? 1 : 0);
+		g_mutex_lock(&s->lock);
+		removed += _shard_remove_exceeding(lh, s, quota);
+		g_mutex_unlock(&s->lock);
+	}
+	return removed;
+}
+
+guint
+lru_hash_remove_matching(struct lru_hash_s *lh,
+		GTraverseFunc filter, gpointer fdata)
+{
+	EXTRA_ASSERT(lh != NULL);
+	EXTRA_ASSERT(filter != NULL);
+
+	gboolean _match(struct _hnode_s *node, gpointer u UNUSED) {
+		return filter(node->k, node->v, fdata);
+	}
+
+	guint removed = 0;
+	for (guint i = 0; i <= lh->mask; i++) {
+		struct _shard_s *s = lh->shards + i;
+		g_mutex_lock(&s->lock);
+		removed += _shard_remove_matching(lh, s, _match, NULL);
+		g_mutex_unlock(&s->lock);
+	}
+	return removed;
+}
+
+gint64
+lru_hash_count(struct lru_hash_s *lh)
+{
+	EXTRA_ASSERT(lh != NULL);
+
+	gint64 total = 0;
+	for (guint i = 0; i <= lh->mask; i++) {
+		struct _shard_s *s = lh->shards + i;
+		g_mutex_lock(&s->lock);
+		total += s->count;
+		g_mutex_unlock(&s->lock);
+	}
+	return total;
+}
@@ -0,0 +1,100 @@
+/*
+OpenIO SDS core library
+Copyright (C) 2025 OVH SAS
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 3.0 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+*/
+
+#ifndef OIO_SDS__core__lruhash_h
+# define OIO_SDS__core__lruhash_h 1
+
+# include <glib.h>
+# include <core/lrutree.h>
+
+/* A hash-partitioned cache, safe for concurrent use without any external
+ * lock. Each shard has its own lock, so that lookups of keys living in
+ * different shards never contend. The eviction is a CLOCK (second chance)
+ * approximation of the LRU: a lookup only marks the item, it never moves
+ * it, and the marked items survive one more sweep of the hand.
+ *
+ * The options are the LTO_* flags of the lru_tree_s. */
+
+#define LRU_HASH_SHARDS_DEFAULT 32
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct lru_hash_s;
+
+/**
+ * @param hash
+ * @param equal
+ * @param kfree
+ * @param vfree
+ * @param options a binary OR'ed combination of LTO_* flags.
+ * @param shards the number of partitions, rounded up to a power of two.
+ * @return a valid lru_hash_s ready to be used
+ */
+struct lru_hash_s* lru_hash_create(GHashFunc hash, GEqualFunc equal,
+		GDestroyNotify kfree, GDestroyNotify vfree, guint32 options,
+		guint shards);
+
+/* Destroys the cache and calls the liberation hooks for each stored pair. */
+void lru_hash_destroy(struct lru_hash_s *lh);
+
+/* Takes the ownership of both 'k' and 'v'. */
+void lru_hash_insert(struct lru_hash_s *lh, gpointer k, gpointer v);
+
+/* Like lru_hash_insert(), but when an item was already present, 'merge' is
+ * called with the new and the previous values, before the previous value is
+ * freed, and with the lock of the shard held. */
+void lru_hash_insert_merge(struct lru_hash_s *lh, gpointer k, gpointer v,
+		void (*merge) (gpointer v, gconstpointer previous));
+
+/* Returns a copy of the value made by 'copy' while the lock of the shard is
+ * held, or the value itself if 'copy' is NULL. The latter is only safe when
+ * the values are never freed (e.g. integers stored as pointers). */
+gpointer lru_hash_get(struct lru_hash_s *lh, gconstpointer k,
+		GBoxedCopyFunc copy);
+
+/* Returns TRUE if the item keyed with 'k' has been removed. */
+gboolean lru_hash_remove(struct lru_hash_s *lh, gconstpointer k);
+
+/* Stop as soon as 'h' returns TRUE. The shards are locked one at a time,
+ * 'h' must not call any other function on the cache. */
+void lru_hash_foreach(struct lru_hash_s *lh, GTraverseFunc h, gpointer hdata);
+
+/* Remove all the items and call 'func' on each of them. `func` is
+ * responsible for freeing both key and value. */
+void lru_hash_foreach_steal(struct lru_hash_s *lh,
+		GTraverseFunc func, gpointer hdata);
+
+guint lru_hash_remove_older(struct lru_hash_s *lh, gint64 oldest);
+
+/* Evict the items in the order of the CLOCK, until there are at most
+ * 'count' items in total. Each shard is trimmed to its share of 'count'. */
+guint lru_hash_remove_exceeding(struct lru_hash_s *lh, guint count);
+
+/** Remove elements for which the filter returns TRUE. */
+guint lru_hash_remove_matching(struct lru_hash_s *lh,
+		GTraverseFunc filter, gpointer fdata);
+
+gint64 lru_hash_count(struct lru_hash_s *lh);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*OIO_SDS__core__lruhash_h*/
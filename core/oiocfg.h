@@ -123,6 +123,13 @@ extern "C" {
 /* Version Id of the object being manipulated */
 #define PROXYD_HEADER_VERSION_ID PROXYD_HEADER_PREFIX "version-id"
 
+/* Epoch and generation of the conscience that listed services, to be
+ * passed back as "epoch" and "since" to get only the next changes */
+#define PROXYD_HEADER_CS_EPOCH PROXYD_HEADER_PREFIX "cs-epoch"
+#define PROXYD_HEADER_CS_GENERATION PROXYD_HEADER_PREFIX "cs-generation"
+/* Boolean telling the list of services only holds changes */
+#define PROXYD_HEADER_CS_DELTA PROXYD_HEADER_PREFIX "cs-delta"
+
 /* in oio_ext_monotonic_time() precision */
 # ifndef PROXYD_DEFAULT_TTL_SERVICES
 #  define PROXYD_DEFAULT_TTL_SERVICES G_TIME_SPAN_HOUR
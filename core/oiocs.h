@@ -62,6 +62,24 @@ GError * oio_cs_client__list_services (struct oio_cs_client_s *self,
 GError * oio_cs_client__list_types (struct oio_cs_client_s *self,
 		void (*on_type) (const char *srvtype));
 
+/* Position of a client in the history of the services of a conscience */
+struct oio_cs_generation_s
+{
+	gchar *epoch; /* identifies the conscience and its restarts */
+	gint64 generation;
+	gboolean complete; /* when all the services have been listed */
+};
+
+/* Lists the services changed since the generation in <gen>, and the URL of
+ * those removed. <gen> is then updated with the position reached. When
+ * <gen->complete> is TRUE after the call, the services not listed are gone.
+ * The caller owns <gen->epoch>. */
+GError * oio_cs_client__list_services_since (struct oio_cs_client_s *self,
+		const char *in_type, gboolean full, struct oio_cs_generation_s *gen,
+		void (*on_reg) (const struct oio_cs_registration_s *reg, int put_score,
+			int get_score),
+		void (*on_removed) (const char *url));
+
 /* -------------------------------------------------------------------------- */
 
 struct oio_cs_client_s * oio_cs_client__create_proxied (const char *ns);
@@ -177,6 +177,13 @@ GHashTable *oio_ext_get_perfdata(void);
  * When called several times with the same key, add values. */
 void oio_ext_add_perfdata(const gchar *key, gint64 value);
 
+/** Same as oio_ext_add_perfdata(), but the metric is a count of items,
+ * not a duration in microseconds. */
+void oio_ext_add_perfdata_count(const gchar *key, gint64 value);
+
+/** Tells if the metric has been added with oio_ext_add_perfdata_count(). */
+gboolean oio_ext_is_perfdata_count(const gchar *key);
+
 gboolean oio_ext_is_allowed_to_do_long_timeout(void);
 
 void oio_ext_allow_long_timeout(const gboolean allow_long_timeout);
@@ -157,6 +157,11 @@ void oio_lb_world__feed_slot (struct oio_lb_world_s *self, const char *slot,
 void oio_lb_world__feed_slot_with_list(struct oio_lb_world_s *self,
 		const char *slot, GSList *items);
 
+/* Remove the given service from all the slots it belongs to. The item stays
+ * known by the world (as after a purge), the slots are left dirty if they
+ * are not rehashed on update. */
+void oio_lb_world__remove_item(struct oio_lb_world_s *self, const char *id);
+
 /* Create a world-based implementation of a service pool. */
 struct oio_lb_pool_s * oio_lb_world__create_pool (
 		struct oio_lb_world_s *world, const char *name);
@@ -231,6 +236,16 @@ GError *oio_lb__poll_pool_around(struct oio_lb_s *lb, const char *name,
 		const oio_location_t pin, int mode,
 		oio_lb_on_id_f on_id, gboolean *flawed);
 
+/** Poll `shots` independent placements from the pool `name` in one pass,
+ * focused on `pin` like oio_lb__poll_pool_around(). The fair location
+ * constraints are applied on the whole batch. On success, `out` is set to
+ * a flat array of `struct oio_lb_selected_item_s*` where the placements
+ * follow each other, each with as many items as the targets of the pool.
+ * The array must be freed with g_ptr_array_free(). Thread-safe. */
+GError *oio_lb__poll_pool_many(struct oio_lb_s *lb, const char *name,
+		guint shots, const oio_location_t pin, int mode,
+		GPtrArray **out, gboolean *flawed);
+
 /** Calls oio_lb_pool__patch() on the pool `name`. Thread-safe. */
 GError *oio_lb__patch_with_pool(struct oio_lb_s *lb, const char *name,
 		const oio_location_t *avoids, const oio_location_t *known,
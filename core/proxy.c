@@ -1022,6 +1022,40 @@ oio_proxy_call_conscience_list (CURL *h, const char *ns,
 	return err;
 }
 
+GError *
+oio_proxy_call_conscience_list_since (CURL *h, const char *ns,
+		const char *srvtype, gboolean full, const char *epoch, gint64 since,
+		GString *out, gchar ***hout)
+{
+	GString *http_url = _curl_conscience_url (ns, "list");
+	if (!http_url) return BADNS();
+
+	gchar str_since[24];
+	g_snprintf(str_since, sizeof(str_since), "%"G_GINT64_FORMAT, MAX(0, since));
+	_append (http_url, '?', "type", srvtype);
+	_append (http_url, '&', "since", str_since);
+	if (oio_str_is_set(epoch))
+		_append (http_url, '&', "epoch", epoch);
+	gchar *hdrin[] = {
+		g_strdup(PROXYD_HEADER_MODE),
+		g_strdup(full ? "full" : NULL),
+		NULL,
+	};
+
+	struct http_ctx_s i = { .headers = hdrin, .body = NULL };
+	struct http_ctx_s o = {
+		.headers = hout ? g_malloc0(sizeof(gchar*)) : NULL,
+		.body = out
+	};
+	GError *err = _proxy_call (h, "GET", http_url->str, &i, &o);
+
+	_ptrv_free_content (i.headers);
+	if (hout)
+		*hout = o.headers;
+	g_string_free(http_url, TRUE);
+	return err;
+}
+
 GError *
 oio_proxy_call_conscience_list_types (CURL *h, const char *ns,
 		GString *out)
@@ -20,6 +20,7 @@ License along with this library.
 #include <core/oiostr.h>
 
 #include <errno.h>
+#include <string.h>
 
 #include <oioext.h>
 
@@ -356,48 +357,64 @@ void oio_str_lower(register gchar *s) {
 		*s = g_ascii_tolower(*s);
 }
 
+/* The bytes that cannot be copied as-is in a JSON string. The bytes of the
+ * UTF-8 sequences are copied as-is, even the invalid ones: the client deals
+ * with them. */
+static const guint8 json_escaped[256] = {
+	[0x00 ... 0x1F] = 1, ['"'] = 1, ['\\'] = 1, ['/'] = 1,
+};
+
+#define WORD_ONES  0x0101010101010101ULL
+#define WORD_HIGHS 0x8080808080808080ULL
+
+/* Tells if none of the 8 bytes of <w> needs an escape sequence, without
+ * looking at each byte. */
+static inline gboolean
+_json_word_is_plain(const guint64 w)
+{
+	const guint64 quote = w ^ (WORD_ONES * '"');
+	const guint64 bslash = w ^ (WORD_ONES * '\\');
+	const guint64 slash = w ^ (WORD_ONES * '/');
+	const guint64 hits =
+		((w - WORD_ONES * ' ') & ~w) |
+		((quote - WORD_ONES) & ~quote) |
+		((bslash - WORD_ONES) & ~bslash) |
+		((slash - WORD_ONES) & ~slash);
+	return !(hits & WORD_HIGHS);
+}
+
 void oio_str_gstring_append_json_blob(GString *base, const char *s0, int len) {
-	for (const char *s = s0; (len < 0 && *s) || (s - s0) < len ;) {
-		if (*s & (const char)0x80) {  // (part of a) unicode character
-			gunichar c = g_utf8_get_char_validated(s, -1);
-			if (c == (gunichar)-1) {
-				// something wrong happened, let the client deal with it
-				g_string_append_c(base, *(s++));
-			} else if (c == (gunichar)-2) {
-				// middle of a unicode character
-				char *end = g_utf8_next_char(s);
-				while (s < end && *s)
-					g_string_append_c(base, *(s++));
-			} else {
-				g_string_append_unichar(base, c);
-				s = g_utf8_next_char(s);
-			}
-		} else if (*s < ' ') {  // control character
-			g_string_append_c(base, '\\');
-			switch (*s) {
-			case '\b':
-			case '\t':
-			case '\n':
-			case '\f':
-			case '\r':
-				g_string_append_c(base, json_basic_translations[(int)*(s++)]);
-				break;
-			default:
-				g_string_append_printf(base, "u%04x", *(s++));
-				break;
-			}
-		} else {  // printable ASCII character
-			switch (*s) {
-			case '"':
-			case '\\':
-			case '/':
-				g_string_append_c(base, '\\');
-				/* FALLTHROUGH */
-			default:
-				g_string_append_c(base, *(s++));
+	const guint8 *s = (const guint8*) s0;
+	const guint8 *end = s + (len < 0 ? strlen(s0) : (gsize)len);
+
+	while (s < end) {
+		/* Find the longest run of bytes to be copied as-is, 8 bytes at a
+		 * time then byte per byte, and copy it at once */
+		const guint8 *run = s;
+		while (end - s >= 8) {
+			guint64 w;
+			memcpy(&w, s, sizeof(w));
+			if (!_json_word_is_plain(w))
 				break;
-			}
+			s += 8;
+		}
+		while (s < end && !json_escaped[*s])
+			s++;
+		if (s > run)
+			g_string_append_len(base, (const gchar*) run, s - run);
+		if (s >= end)
+			break;
+
+		g_string_append_c(base, '\\');
+		if (*s >= ' ') {
+			g_string_append_c(base, *s);
+		} else if (*s < sizeof(json_basic_translations)
+				&& json_basic_translations[*s]) {
+			g_string_append_c(base, json_basic_translations[*s]);
+		} else {
+			g_string_append_printf(base, "u%04x", *s);
 		}
+		s++;
 	}
 }
 
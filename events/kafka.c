@@ -16,6 +16,8 @@ You should have received a copy of the GNU Lesser General Public
 License along with this library.
 */
 
+#include <string.h>
+
 #include "kafka.h"
 
 
@@ -69,7 +71,37 @@ void on_kafka_delivery_report(rd_kafka_t* rk UNUSED,
 	// Retrieve context
 	struct kafka_callback_ctx *ctx = (struct kafka_callback_ctx*)opaque;
 
+	if (ctx->delivered_func) {
+		ctx->delivered_func(MAX(0, rd_kafka_message_latency(rkmessage)));
+	}
+
 	rd_kafka_resp_err_t err = rkmessage->err;
+	if (rkmessage->_private) {
+		// Tracked by kafka_publish_tracked(), the caller decides
+		const guint64 seq = GPOINTER_TO_SIZE(rkmessage->_private);
+		if (err == RD_KAFKA_RESP_ERR_NO_ERROR) {
+			ctx->tracked_func(seq, NULL, NULL, NULL);
+			return;
+		}
+		const char* topic_name = rd_kafka_topic_name(rkmessage->rkt);
+		GError *e = NULL;
+		/* A purged message has not been sent, it is not lost yet */
+		if (message_should_be_dropped(err)
+				&& err != RD_KAFKA_RESP_ERR__PURGE_QUEUE
+				&& err != RD_KAFKA_RESP_ERR__PURGE_INFLIGHT) {
+			e = BADREQ("Failed to deliver to topic %s: %s, dropped",
+					topic_name, rd_kafka_err2str(err));
+		} else {
+			e = BUSY("Failed to deliver to topic %s: %s, retry later",
+					topic_name, rd_kafka_err2str(err));
+		}
+		// tracked_func takes ownership of the error, key and msg
+		ctx->tracked_func(seq, e,
+				rkmessage->key ?
+					g_strndup(rkmessage->key, rkmessage->key_len) : NULL,
+				g_strndup(rkmessage->payload, rkmessage->len));
+		return;
+	}
 	if (err == RD_KAFKA_RESP_ERR_NO_ERROR) {
 		return;
 	}
@@ -106,6 +138,7 @@ kafka_create(const gchar *endpoint,
 		const gchar *topic,
 		void (*requeue_fn)(gchar*, gchar*),
 		void (*drop_fn)(const gchar*, gchar*, gchar*),
+		void (*delivered_fn)(gint64),
 		struct kafka_s **out,
 		const gboolean sync)
 {
@@ -119,9 +152,10 @@ kafka_create(const gchar *endpoint,
 	out1.producer = NULL;
 	out1.topic = g_strdup(topic);
 	if (!sync) {
-		out1.callback_ctx = g_malloc(sizeof(struct kafka_callback_ctx));
+		out1.callback_ctx = g_malloc0(sizeof(struct kafka_callback_ctx));
 		out1.callback_ctx->drop_func = drop_fn;
 		out1.callback_ctx->requeue_func = requeue_fn;
+		out1.callback_ctx->delivered_func = delivered_fn;
 	} else {
 		out1.callback_ctx = NULL;
 	}
@@ -148,6 +182,28 @@ kafka_create(const gchar *endpoint,
 		}
 	}
 
+	if (!err) {
+		// Batching, overridden by the sync mode below
+		gchar linger[32], batch[32];
+		g_snprintf(linger, sizeof(linger), "%"G_GINT64_FORMAT,
+				oio_events_kafka_linger / G_TIME_SPAN_MILLISECOND);
+		g_snprintf(batch, sizeof(batch), "%u", oio_events_kafka_batch_size);
+		const gchar *batching[] = {
+			"linger.ms", linger,
+			"batch.num.messages", batch,
+			"compression.type", oio_events_kafka_compression,
+			NULL
+		};
+		for (const gchar **kv = batching; !err && *kv; kv += 2) {
+			GRID_INFO("Setting option %s=%s", kv[0], kv[1]);
+			kafka_err = rd_kafka_conf_set(
+				out1.conf, kv[0], kv[1], errstr, sizeof(errstr));
+			if (kafka_err) {
+				err = BADREQ("Invalid option: %s", errstr);
+			}
+		}
+	}
+
 	if (!err) {
 		// Extra options
 		options = g_strsplit(oio_events_kafka_options, ";", -1);
@@ -175,6 +231,34 @@ kafka_create(const gchar *endpoint,
 		}
 	}
 
+	if (!err) {
+		// Extra options of this very topic, as "topic/key=value"
+		g_strfreev(options);
+		options = g_strsplit(oio_events_kafka_topic_options, ";", -1);
+		for (gchar** option = options; options && *option; option++) {
+			const gchar *slash = strchr(*option, '/');
+			if (!slash || (size_t)(slash - *option) != strlen(topic)
+					|| strncmp(*option, topic, slash - *option) != 0) {
+				continue;
+			}
+			gchar** key_value = g_strsplit(slash + 1, "=", 2);
+			if (key_value[0] == NULL || key_value[1] == NULL) {
+				err = BADREQ("Invalid kafka topic option '%s'", *option);
+				g_strfreev(key_value);
+				break;
+			}
+			GRID_INFO("Setting option %s=%s for topic %s",
+					key_value[0], key_value[1], topic);
+			kafka_err = rd_kafka_conf_set(
+				out1.conf, key_value[0], key_value[1], errstr, sizeof(errstr));
+			g_strfreev(key_value);
+			if (kafka_err) {
+				err = BADREQ("Invalid option: %s", errstr);
+				break;
+			}
+		}
+	}
+
 	// Install callbacks for async mode
 	if (!err && !sync) {
 		// Logger redirection
@@ -282,6 +366,15 @@ kafka_poll(struct kafka_s *kafka)
 	return NULL;
 }
 
+GError*
+kafka_poll_wait(struct kafka_s *kafka, gint64 delay)
+{
+	if (kafka->producer) {
+		rd_kafka_poll(kafka->producer, delay / G_TIME_SPAN_MILLISECOND);
+	}
+	return NULL;
+}
+
 GError*
 kafka_publish_message(struct kafka_s *kafka,
 		void* key, size_t keylen,
@@ -315,9 +408,15 @@ kafka_publish_message(struct kafka_s *kafka,
 			err = BUSY("Failed to produce to topic %s: %s, retry later", topic,
 				rd_kafka_err2str(rc));
 		}
-	} else {
-		rd_kafka_flush(kafka->producer,
-			oio_events_kafka_timeout_flush / G_TIME_SPAN_MILLISECOND);
+	} else if (!sync) {
+		if (oio_events_kafka_flush) {
+			/* Send now, whatever the linger */
+			rd_kafka_flush(kafka->producer,
+				oio_events_kafka_timeout_flush / G_TIME_SPAN_MILLISECOND);
+		} else {
+			/* Only serve the delivery reports of the previous batches */
+			rd_kafka_poll(kafka->producer, 0);
+		}
 	}
 
 	if (!err && sync) {
@@ -338,6 +437,45 @@ kafka_publish_message(struct kafka_s *kafka,
 	return err;
 }
 
+GError*
+kafka_publish_tracked(struct kafka_s *kafka,
+		void* key, size_t keylen,
+		void* msg, size_t msglen,
+		const gchar* topic, guint64 seq)
+{
+	EXTRA_ASSERT(seq != 0);
+	if (!kafka || !kafka->producer || !kafka->callback_ctx
+			|| !kafka->callback_ctx->tracked_func) {
+		return BADREQ("Try to publish message without producer");
+	}
+
+	rd_kafka_resp_err_t rc = rd_kafka_producev(kafka->producer,
+		RD_KAFKA_V_TOPIC(topic),
+		RD_KAFKA_V_MSGFLAGS(RD_KAFKA_MSG_F_COPY),
+		RD_KAFKA_V_KEY(key, keylen),
+		RD_KAFKA_V_VALUE(msg, msglen),
+		RD_KAFKA_V_OPAQUE(GSIZE_TO_POINTER(seq)),
+		RD_KAFKA_V_END);
+
+	if (rc == RD_KAFKA_RESP_ERR_MSG_SIZE_TOO_LARGE) {
+		return BADREQ("Failed to produce to topic %s: %s, dropped", topic,
+			rd_kafka_err2str(rc));
+	} else if (rc != RD_KAFKA_RESP_ERR_NO_ERROR) {
+		return BUSY("Failed to produce to topic %s: %s, retry later", topic,
+			rd_kafka_err2str(rc));
+	}
+
+	if (oio_events_kafka_flush) {
+		/* Send now, whatever the linger */
+		rd_kafka_flush(kafka->producer,
+			oio_events_kafka_timeout_flush / G_TIME_SPAN_MILLISECOND);
+	} else {
+		/* Only serve the delivery reports of the previous batches */
+		rd_kafka_poll(kafka->producer, 0);
+	}
+	return NULL;
+}
+
 GError*
 kafka_flush(struct kafka_s *kafka)
 {
@@ -30,6 +30,15 @@ struct kafka_callback_ctx
 {
 	void (*requeue_func)(gchar*, gchar*);
 	void (*drop_func)(const gchar*, gchar*, gchar*);
+	/* Called for each delivery report, successful or not, with the time
+	 * elapsed since the message has been produced (microseconds). */
+	void (*delivered_func)(gint64);
+	/* Called instead of requeue_func and drop_func for the delivery report
+	 * of a message produced by kafka_publish_tracked(), with its tracking
+	 * number. On failure, it also gets an error (a retry code, unless the
+	 * message must be dropped) and the ownership of a copy of the key and of
+	 * the message. */
+	void (*tracked_func)(guint64, GError*, gchar*, gchar*);
 };
 
 struct kafka_s
@@ -41,12 +50,16 @@ struct kafka_s
 };
 
 
-/** Create a Kafka connector, tied to the specified exchange. */
+/** Create a Kafka connector, tied to the specified exchange.
+ * In asynchronous mode, the messages are batched as configured by
+ * events.kafka.linger, events.kafka.batch_size and events.kafka.compression,
+ * possibly overridden for the topic by events.kafka.topic_options. */
 GError* kafka_create(
 	const gchar *endpoint,
 	const gchar *topic,
 	void (*requeue_fn)(gchar*, gchar*),
 	void (*drop_fn)(const gchar*, gchar*, gchar*),
+	void (*delivered_fn)(gint64),
 	struct kafka_s **out,
 	const gboolean sync);
 
@@ -57,13 +70,23 @@ GError* kafka_connect(struct kafka_s *kafka);
 /** Send a message to the previously configured queue.
  * If sync is TRUE, then the function is blocking until the message is "acked" (or
  * a timeout is reached). It requires to use "kafka_create" with "sync" at TRUE too.
- * If sync is FALSE, then the message is buffered and will be sent asynchronously.
- * The asynchronous mode is the preferred mode. */
+ * If sync is FALSE, then the message is buffered and will be sent asynchronously,
+ * with the next batch (unless events.kafka.flush is set). The asynchronous mode
+ * is the preferred mode. */
 GError* kafka_publish_message(struct kafka_s *kafka,
 		void* key, size_t keylen,
 		void* msg, size_t msglen,
 		const gchar* topic, const gboolean sync);
 
+/** Send a message with the asynchronous connector, batched as the others.
+ * Its delivery report is given to the tracked_func of the callback context,
+ * with `seq` (not 0): the message is neither requeued nor dropped by the
+ * connector, it is up to the caller. */
+GError* kafka_publish_tracked(struct kafka_s *kafka,
+		void* key, size_t keylen,
+		void* msg, size_t msglen,
+		const gchar* topic, guint64 seq);
+
 /** Check if producer encountered a fatal error.
  * If so, the producer should be restarted **/
 GError* kafka_check_fatal_error(struct kafka_s *kafka);
@@ -72,6 +95,10 @@ GError* kafka_check_fatal_error(struct kafka_s *kafka);
  **/
 GError* kafka_poll(struct kafka_s *kafka);
 
+/** Poll the kafka producer, waiting at most `delay` (microseconds) for a
+ * delivery report. */
+GError* kafka_poll_wait(struct kafka_s *kafka, gint64 delay);
+
 /** Close producer **/
 GError* kafka_close(struct kafka_s *kafka);
 
@@ -121,6 +121,16 @@ oio_events_queue__get_health(struct oio_events_queue_s *self)
 	return 100;
 }
 
+gboolean
+oio_events_queue__get_spool_backlog(struct oio_events_queue_s *self,
+		guint64 *pbytes, gint64 *page)
+{
+	if (VTABLE_HAS(self,struct oio_events_queue_abstract_s*,get_spool_backlog)) {
+		EVTQ_CALL(self,get_spool_backlog)(self,pbytes,page);
+	}
+	return FALSE;
+}
+
 void
 oio_events_queue__set_buffering (struct oio_events_queue_s *self,
 		gint64 delay)
@@ -294,31 +304,42 @@ struct _prom_stat_in_out {
 };
 
 static void
-_stat_append_to_str(const gchar *key,
-		struct oio_events_queue_s *queue, struct _prom_stat_in_out *in_out)
+_stat_append_name(const gchar *name, const gchar *key,
+		struct _prom_stat_in_out *in_out)
 {
-	g_string_append_static(in_out->out,
-			"meta_event_sent_total{service_id=\"");
+	g_string_append(in_out->out, name);
+	g_string_append_static(in_out->out, "{service_id=\"");
 	g_string_append(in_out->out, in_out->service_id);
 	g_string_append_static(in_out->out, "\",event_type=\"");
 	g_string_append(in_out->out, key);
 	g_string_append_static(in_out->out, "\",namespace=\"");
 	g_string_append(in_out->out, in_out->namespace);
 	g_string_append_static(in_out->out, "\"} ");
+}
+
+static void
+_stat_append_to_str(const gchar *key,
+		struct oio_events_queue_s *queue, struct _prom_stat_in_out *in_out)
+{
+	_stat_append_name("meta_event_sent_total", key, in_out);
 	guint64 events = oio_events_queue__get_total_sent_events(queue);
 	g_string_append_printf(in_out->out, "%"G_GUINT64_FORMAT"\n", events);
 
-	g_string_append_static(in_out->out,
-			"meta_event_send_time_seconds_total{service_id=\"");
-	g_string_append(in_out->out, in_out->service_id);
-	g_string_append_static(in_out->out, "\",event_type=\"");
-	g_string_append(in_out->out, key);
-	g_string_append_static(in_out->out, "\",namespace=\"");
-	g_string_append(in_out->out, in_out->namespace);
-	g_string_append_static(in_out->out, "\"} ");
+	_stat_append_name("meta_event_send_time_seconds_total", key, in_out);
 	guint64 time_us = oio_events_queue__get_total_send_time(queue);
 	double time_s = (double)time_us / (double)G_TIME_SPAN_SECOND;
 	g_string_append_printf(in_out->out, "%.6f\n", time_s);
+
+	guint64 spool_bytes = 0;
+	gint64 spool_age = 0;
+	if (oio_events_queue__get_spool_backlog(queue, &spool_bytes, &spool_age)) {
+		_stat_append_name("meta_event_spool_bytes", key, in_out);
+		g_string_append_printf(in_out->out, "%"G_GUINT64_FORMAT"\n",
+				spool_bytes);
+		_stat_append_name("meta_event_spool_age_seconds", key, in_out);
+		g_string_append_printf(in_out->out, "%.6f\n",
+				(double)spool_age / (double)G_TIME_SPAN_SECOND);
+	}
 }
 
 void
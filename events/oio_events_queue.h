@@ -58,6 +58,12 @@ guint64 oio_events_queue__get_total_sent_events(struct oio_events_queue_s *self)
 /* Get a health metric for the events queue, from 0 (bad) to 100 (good). */
 gint64 oio_events_queue__get_health(struct oio_events_queue_s *self);
 
+/* Get the size of the events spooled on disk and not sent yet, and the age
+ * (in microseconds) of the oldest of them. Returns FALSE if the queue has no
+ * spool (see events.spool.dir). */
+gboolean oio_events_queue__get_spool_backlog(struct oio_events_queue_s *self,
+		guint64 *pbytes, gint64 *page);
+
 void oio_events_queue__set_buffering (struct oio_events_queue_s *self,
 		gint64 delay);
 
@@ -33,6 +33,7 @@ License along with this library.
 #include "oio_events_queue_beanstalkd.h"
 #include "oio_events_queue_buffer.h"
 #include "oio_events_queue_shared.h"
+#include "oio_events_spool.h"
 
 
 static GError * _q_start (struct oio_events_queue_s *self);
@@ -49,6 +50,7 @@ static struct oio_events_queue_vtable_s vtable_BEANSTALKD =
 	.set_buffering = _q_set_buffering,
 	.start = _q_start,
 	.flush_overwritable = _q_flush_overwritable,
+	.get_spool_backlog = _q_get_spool_backlog,
 };
 
 #ifdef HAVE_EXTRA_DEBUG
@@ -134,7 +136,13 @@ _q_manage_message(struct _queue_with_endpoint_s *q, struct _running_ctx_s *ctx)
 	EXTRA_ASSERT(ctx->beanstalkd != NULL && ctx->beanstalkd->fd >= 0);
 
 	gboolean rc = TRUE;
-	gchar* msg = g_async_queue_timeout_pop (q->queue, 200 * G_TIME_SPAN_MILLISECOND);
+	gboolean from_spool = FALSE;
+	guint64 seq = 0;
+	gchar* msg = NULL;
+	if (!q->spool)
+		msg = g_async_queue_timeout_pop (q->queue, 200 * G_TIME_SPAN_MILLISECOND);
+	else if (!(msg = g_async_queue_try_pop(q->queue)))
+		from_spool = _q_spool_read(q, &seq, NULL, &msg);
 	if (!msg) goto exit;
 	if (!*msg) goto exit;
 
@@ -157,8 +165,14 @@ _q_manage_message(struct _queue_with_endpoint_s *q, struct _running_ctx_s *ctx)
 		if (CODE_IS_RETRY(err->code) || CODE_IS_NETWORK_ERROR(err->code)) {
 			GRID_NOTICE("Beanstalkd recoverable error with [%s]: (%d) %s",
 					q->endpoint, err->code, err->message);
-			g_async_queue_push_front(q->queue, msg);
-			msg = NULL;
+			if (from_spool) {
+				/* Still spooled, it will be read again */
+				oio_events_spool_rewind(q->spool);
+				from_spool = FALSE;
+			} else {
+				g_async_queue_push_front(q->queue, msg);
+				msg = NULL;
+			}
 			ctx->attempts_put += 1;
 			rc = FALSE;
 		} else {
@@ -171,6 +185,8 @@ _q_manage_message(struct _queue_with_endpoint_s *q, struct _running_ctx_s *ctx)
 	}
 
 exit:
+	if (from_spool)
+		oio_events_spool_ack(q->spool, seq);
 	oio_str_clean (&msg);
 	return rc;
 }
@@ -325,6 +341,7 @@ _q_start (struct oio_events_queue_s *self)
 
 	GError *err = NULL;
 
+	_q_spool_open(q);
 	q->running = TRUE;
 	q->healthy = TRUE;
 	q->worker = g_thread_try_new("event|beanstalk", _q_worker, q, &err);
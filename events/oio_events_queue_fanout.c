@@ -51,6 +51,8 @@ static gboolean _q_send_overwritable(struct oio_events_queue_s *self, gchar *tag
 static void _q_flush_overwritable(struct oio_events_queue_s *self, gchar *tag);
 static gboolean _q_is_stalled (struct oio_events_queue_s *self);
 static gint64 _q_get_health(struct oio_events_queue_s *self);
+static gboolean _q_get_spool_backlog(struct oio_events_queue_s *self,
+		guint64 *pbytes, gint64 *page);
 
 static void _q_set_buffering (struct oio_events_queue_s *self, gint64 v);
 static GError * _q_start (struct oio_events_queue_s *self);
@@ -62,6 +64,7 @@ static struct oio_events_queue_vtable_s vtable_FANOUT =
 	.send_overwritable = _q_send_overwritable,
 	.is_stalled = _q_is_stalled,
 	.get_health = _q_get_health,
+	.get_spool_backlog = _q_get_spool_backlog,
 	.set_buffering = _q_set_buffering,
 	.start = _q_start,
 	.flush_overwritable = _q_flush_overwritable,
@@ -321,3 +324,29 @@ _q_get_health(struct oio_events_queue_s *self)
 	}
 	return health;
 }
+
+static gboolean
+_q_get_spool_backlog(struct oio_events_queue_s *self,
+		guint64 *pbytes, gint64 *page)
+{
+	struct _queue_FANOUT_s *q = (struct _queue_FANOUT_s*) self;
+	EXTRA_ASSERT(q != NULL && q->vtable == &vtable_FANOUT);
+
+	gboolean spooled = FALSE;
+	guint64 bytes = 0;
+	gint64 age = 0;
+	for (guint i=0; i < q->output_nb; ++i) {
+		guint64 b0 = 0;
+		gint64 a0 = 0;
+		if (oio_events_queue__get_spool_backlog(q->output_tab[i], &b0, &a0)) {
+			spooled = TRUE;
+			bytes += b0;
+			age = MAX(age, a0);
+		}
+	}
+	if (pbytes)
+		*pbytes = bytes;
+	if (page)
+		*page = age;
+	return spooled;
+}
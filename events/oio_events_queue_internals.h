@@ -38,6 +38,8 @@ struct oio_events_queue_vtable_s
 	void (*set_buffering) (struct oio_events_queue_s *self, gint64 v);
 	GError * (*start) (struct oio_events_queue_s *self);
 	void (*flush_overwritable)(struct oio_events_queue_s *self, gchar *tag);
+	gboolean (*get_spool_backlog) (struct oio_events_queue_s *self,
+			guint64 *pbytes, gint64 *page);
 };
 
 struct oio_events_queue_abstract_s
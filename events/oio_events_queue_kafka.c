@@ -29,6 +29,7 @@ License along with this library.
 #include "oio_events_queue_kafka.h"
 #include "oio_events_queue_buffer.h"
 #include "oio_events_queue_shared.h"
+#include "oio_events_spool.h"
 
 static GError * _q_start (struct oio_events_queue_s *self);
 static gboolean _q_send_ext(struct oio_events_queue_s *self,
@@ -46,6 +47,7 @@ static struct oio_events_queue_vtable_s vtable_KAFKA =
 	.set_buffering = _q_set_buffering,
 	.start = _q_start,
 	.flush_overwritable = _q_flush_overwritable,
+	.get_spool_backlog = _q_get_spool_backlog,
 };
 
 #ifdef HAVE_EXTRA_DEBUG
@@ -55,6 +57,7 @@ static _queue_BEANSTALKD_intercept_error_f intercept_errors = NULL;
 struct oio_kafka_event_s {
 	gchar *key;
 	gchar *msg;
+	guint64 seq;  // of the event in the spool, 0 if kept in memory only
 };
 
 GError *
@@ -110,23 +113,43 @@ _q_manage_message(struct _queue_with_endpoint_s *q, struct _running_ctx_s *ctx)
 	EXTRA_ASSERT(ctx->kafka != NULL);
 
 	gboolean rc = TRUE;
-	struct oio_kafka_event_s *evt = g_async_queue_timeout_pop(
-			q->queue, 200 * G_TIME_SPAN_MILLISECOND);
+	struct oio_kafka_event_s *evt = NULL;
+	if (!q->spool) {
+		evt = g_async_queue_timeout_pop(q->queue, 200 * G_TIME_SPAN_MILLISECOND);
+	} else if (!(evt = g_async_queue_try_pop(q->queue))) {
+		/* Nothing to retry in memory, send the next spooled event, unless
+		 * too many of them still wait for their delivery report */
+		if (oio_events_spool_inflight(q->spool)
+				>= oio_events_spool_max_inflight) {
+			kafka_poll_wait(ctx->kafka, 100 * G_TIME_SPAN_MILLISECOND);
+			goto exit;
+		}
+		guint64 seq = 0;
+		gchar *key = NULL, *msg = NULL;
+		if (_q_spool_read(q, &seq, &key, &msg)) {
+			evt = g_malloc0(sizeof(struct oio_kafka_event_s));
+			evt->key = key;
+			evt->msg = msg;
+			evt->seq = seq;
+		}
+	}
 	if (!evt) goto exit;
-	if (!evt->msg) goto exit;
-	if (!*(evt->msg)) goto exit;
+	if (!evt->msg || !*(evt->msg)) {
+		if (evt->seq)
+			oio_events_spool_ack(q->spool, evt->seq);
+		goto exit;
+	}
 
-	/* forward the event as a beanstalkd job */
+	/* forward the event to the next batch, it is counted by its delivery
+	 * report. A spooled event is acknowledged by its delivery report, so
+	 * that it survives a crash while it lingers in the batch. */
 	const size_t keylen = evt->key ? strlen(evt->key) : 0;
 	const size_t msglen = strlen(evt->msg);
-	gint64 start = oio_ext_monotonic_time();
-	GError *err = kafka_publish_message(ctx->kafka, evt->key, keylen, evt->msg,
-			msglen, q->queue_name, FALSE);
-	gint64 end = oio_ext_monotonic_time();
-	time_t end_seconds = end / G_TIME_SPAN_SECOND;
-	/* count the operation whether it's a success or a failure */
-	grid_single_rrd_add(q->event_send_count, end_seconds, 1);
-	grid_single_rrd_add(q->event_send_time, end_seconds, end - start);
+	GError *err = evt->seq ?
+		kafka_publish_tracked(ctx->kafka, evt->key, keylen, evt->msg,
+				msglen, q->queue_name, evt->seq) :
+		kafka_publish_message(ctx->kafka, evt->key, keylen, evt->msg,
+				msglen, q->queue_name, FALSE);
 #ifdef HAVE_EXTRA_DEBUG
 	if (intercept_errors)
 		(*intercept_errors) (err);
@@ -144,6 +167,8 @@ _q_manage_message(struct _queue_with_endpoint_s *q, struct _running_ctx_s *ctx)
 		} else {
 			GRID_WARN("Kafka unrecoverable error with [%s]: (%d) %s",
 					q->endpoint, err->code, err->message);
+			if (evt->seq)
+				oio_events_spool_ack(q->spool, evt->seq);
 			_drop_event(q->queue_name, evt->key, evt->msg);
 			g_free(evt);
 			evt = NULL;
@@ -243,13 +268,46 @@ _q_run(struct _queue_with_endpoint_s *q)
 		evt_wrapper->msg = msg;
 		g_async_queue_push_front(q->queue, evt_wrapper);
 	};
+	void __delivered_fn(gint64 latency) {
+		/* count the delivery whether it's a success or a failure */
+		time_t now_seconds = oio_ext_monotonic_seconds();
+		grid_single_rrd_add(q->event_send_count, now_seconds, 1);
+		grid_single_rrd_add(q->event_send_time, now_seconds, latency);
+	};
+	/* The spool cursor moves once the events before are delivered too, the
+	 * others are replayed after a restart */
+	void __tracked_fn(guint64 seq, GError *e, gchar *key, gchar *msg) {
+		if (!e) {
+			oio_events_spool_ack(q->spool, seq);
+		} else if (CODE_IS_RETRY(e->code)) {
+			GRID_NOTICE("Kafka recoverable error with [%s]: (%d) %s",
+					q->endpoint, e->code, e->message);
+			struct oio_kafka_event_s *evt_wrapper =
+				g_malloc0(sizeof(struct oio_kafka_event_s));
+			evt_wrapper->key = key;
+			evt_wrapper->msg = msg;
+			evt_wrapper->seq = seq;
+			g_async_queue_push_front(q->queue, evt_wrapper);
+			key = msg = NULL;
+		} else {
+			GRID_WARN("Kafka unrecoverable error with [%s]: (%d) %s",
+					q->endpoint, e->code, e->message);
+			oio_events_spool_ack(q->spool, seq);
+			_drop_event(q->queue_name, key, msg);
+			key = msg = NULL;
+		}
+		g_clear_error(&e);
+		g_free(key);
+		g_free(msg);
+	};
 
-	err = kafka_create(
-			q->endpoint, q->queue_name, __requeue_fn, _drop_event, &(ctx.kafka), FALSE);
+	err = kafka_create(q->endpoint, q->queue_name,
+			__requeue_fn, _drop_event, __delivered_fn, &(ctx.kafka), FALSE);
 
 	if (err){
 		return err;
 	}
+	ctx.kafka->callback_ctx->tracked_func = __tracked_fn;
 
 	/* Loop until the (asked) end or until there is no event */
 	while (_q_is_running(q)) {
@@ -271,6 +329,9 @@ _q_run(struct _queue_with_endpoint_s *q)
 			continue;
 		}
 
+		/* Serve the delivery reports, even when no event is produced */
+		kafka_poll(ctx.kafka);
+
 		if (!_q_manage_message(q, &ctx)) {
 			EXPO_BACKOFF(100 * G_TIME_SPAN_MILLISECOND, ctx.attempts_put, 5);
 		}
@@ -293,22 +354,41 @@ _q_run(struct _queue_with_endpoint_s *q)
 		}
 	}
 
-	// Flush pending
+	// Flush pending, into the spool if any
 	guint count = 0;
 	while (0 < g_async_queue_length(q->queue)) {
 		struct oio_kafka_event_s *evt = g_async_queue_try_pop(q->queue);
-		if (evt) {
-			_drop_event(q->queue_name, evt->key, evt->msg);
+		if (evt && evt->seq) {
+			/* Still in the spool */
+			g_free(evt->key);
+			g_free(evt->msg);
+		} else if (evt) {
+			if (!_q_spool_send(q, evt->key, evt->msg)) {
+				_drop_event(q->queue_name, evt->key, evt->msg);
+				++ count;
+			}
 			g_free(evt);
-			++ count;
 		}
 	}
 	if (count > 0) {
 		GRID_WARN("%u events lost", count);
 	}
 
-	/* close the socket to the kafka broker */
+	/* close the socket to the kafka broker. The spooled events still
+	 * in flight are replayed at the next start. */
 	err = kafka_destroy(ctx.kafka);
+	while (0 < g_async_queue_length(q->queue)) {
+		struct oio_kafka_event_s *evt = g_async_queue_try_pop(q->queue);
+		if (!evt)
+			continue;
+		if (evt->seq) {
+			g_free(evt->key);
+			g_free(evt->msg);
+		} else {
+			_drop_event(q->queue_name, evt->key, evt->msg);
+		}
+		g_free(evt);
+	}
 
 	return err;
 }
@@ -335,6 +415,7 @@ _q_start (struct oio_events_queue_s *self)
 
 	GError *err = NULL;
 
+	_q_spool_open(q);
 	q->running = TRUE;
 	q->healthy = TRUE;
 	q->worker = g_thread_try_new("event|kafka", _q_worker, q, &err);
@@ -349,6 +430,8 @@ gboolean
 _q_send_ext(struct oio_events_queue_s *self, gchar* key, gchar *msg)
 {
 	struct _queue_with_endpoint_s *q = (struct _queue_with_endpoint_s*) self;
+	if (_q_spool_send(q, key, msg))
+		return TRUE;
 	struct oio_kafka_event_s *evt_wrapper = g_malloc0(sizeof(struct oio_kafka_event_s));
 	evt_wrapper->key = key;
 	evt_wrapper->msg = msg;
@@ -236,7 +236,7 @@ _q_start (struct oio_events_queue_s *self)
 	q->healthy = TRUE;
 
 	GError *err = kafka_create(
-		q->endpoint, q->queue_name, NULL, NULL, &q->kafka, TRUE);
+		q->endpoint, q->queue_name, NULL, NULL, NULL, &q->kafka, TRUE);
 
 	if (err){
 		GRID_ERROR("Error while creating sync queue");
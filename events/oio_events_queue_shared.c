@@ -24,6 +24,7 @@ License along with this library.
 #include "oio_events_queue.h"
 #include "oio_events_queue_internals.h"
 #include "oio_events_queue_shared.h"
+#include "oio_events_spool.h"
 
 
 // Internally used functions and structs, shared by several implementations
@@ -66,6 +67,8 @@ _q_destroy(struct oio_events_queue_s *self)
 		q->worker = NULL;
 	}
 
+	oio_events_spool_close(q->spool);
+	q->spool = NULL;
 	g_async_queue_unref(q->queue);
 	oio_str_clean(&q->endpoint);
 	oio_str_clean(&q->username);
@@ -81,7 +84,7 @@ _q_destroy(struct oio_events_queue_s *self)
 }
 
 /**
- * Drain the queue of pending events.
+ * Drain the queue of pending events, into the spool if any.
  * In addition, print a warning that some events have been lost.
  */
 void
@@ -90,7 +93,7 @@ _q_flush_pending(struct _queue_with_endpoint_s *q)
 	guint count = 0;
 	while (0 < g_async_queue_length(q->queue)) {
 		gchar *msg = g_async_queue_try_pop(q->queue);
-		if (msg) {
+		if (msg && !_q_spool_send(q, NULL, msg)) {
 			_drop_event(q->queue_name, NULL, msg);
 			++ count;
 		}
@@ -134,7 +137,8 @@ gboolean
 _q_send(struct oio_events_queue_s *self, gchar* key UNUSED, gchar *msg)
 {
 	struct _queue_with_endpoint_s *q = (struct _queue_with_endpoint_s*) self;
-	g_async_queue_push(q->queue, msg);
+	if (!_q_spool_send(q, NULL, msg))
+		g_async_queue_push(q->queue, msg);
 	return TRUE;
 }
 
@@ -240,3 +244,67 @@ _q_get_health(struct oio_events_queue_s *self)
 	double max_score = ((double)SCORE_MAX);
 	return (gint64) (max_score / (1.0 + log(1.0 + q->pending_events * 0.1)));
 }
+
+gboolean
+_q_get_spool_backlog(struct oio_events_queue_s *self,
+		guint64 *pbytes, gint64 *page)
+{
+	struct _queue_with_endpoint_s *q = (struct _queue_with_endpoint_s*) self;
+	EXTRA_ASSERT(q != NULL && q->vtable != NULL);
+	if (!q->spool)
+		return FALSE;
+	oio_events_spool_get_backlog(q->spool, pbytes, page);
+	return TRUE;
+}
+
+void
+_q_spool_open(struct _queue_with_endpoint_s *q)
+{
+	if (!*oio_events_spool_dir || q->spool)
+		return;
+
+	/* Several queues may share a topic (or a tube), never an endpoint */
+	gchar *name = g_strdup_printf("%s@%s", q->queue_name, q->endpoint);
+	g_strcanon(name, G_CSET_A_2_Z G_CSET_a_2_z G_CSET_DIGITS "@._-", '_');
+	gchar *path = g_build_filename(oio_events_spool_dir, name, NULL);
+	GError *err = oio_events_spool_open(path, &q->spool);
+	if (err) {
+		GRID_WARN("Events spool disabled for [%s]: (%d) %s",
+				path, err->code, err->message);
+		g_clear_error(&err);
+	}
+	g_free(path);
+	g_free(name);
+}
+
+gboolean
+_q_spool_send(struct _queue_with_endpoint_s *q, gchar *key, gchar *msg)
+{
+	if (!q->spool)
+		return FALSE;
+
+	GError *err = oio_events_spool_append(q->spool, key, msg);
+	if (err) {
+		/* A full spool is reported by the stalled queue, behind it */
+		if (err->code != CODE_UNAVAILABLE)
+			GRID_WARN("Events spool error for [%s]: (%d) %s",
+					q->queue_name, err->code, err->message);
+		g_clear_error(&err);
+		return FALSE;
+	}
+	g_free(key);
+	g_free(msg);
+	return TRUE;
+}
+
+gboolean
+_q_spool_read(struct _queue_with_endpoint_s *q, guint64 *pseq,
+		gchar **pkey, gchar **pmsg)
+{
+	EXTRA_ASSERT(q->spool != NULL);
+	oio_events_spool_flush(q->spool, FALSE);
+	if (oio_events_spool_read(q->spool, pseq, pkey, pmsg))
+		return TRUE;
+	oio_events_spool_wait(q->spool, 200 * G_TIME_SPAN_MILLISECOND);
+	return oio_events_spool_read(q->spool, pseq, pkey, pmsg);
+}
@@ -30,6 +30,8 @@ License along with this library.
 	g_usleep((1 << MIN(TRY, MAX_TRIES)) * DELAY); \
 	TRY++
 
+struct oio_events_spool_s;
+
 /* Holds data necessary to connect to an external queue service
  * with a TCP endpoint (Beanstalkd, Kafka, etc.). */
 struct _queue_with_endpoint_s
@@ -49,6 +51,9 @@ struct _queue_with_endpoint_s
 	volatile gboolean healthy;  // used to know if a queue is explicitly unhealthy
 
 	struct oio_events_queue_buffer_s buffer;
+	/* When set (see events.spool.dir), the events are appended there instead
+	 * of the in-memory queue, that only holds the events to retry. */
+	struct oio_events_spool_s *spool;
 	struct grid_single_rrd_s *event_send_count;
 	struct grid_single_rrd_s *event_send_time;
 };
@@ -77,6 +82,8 @@ guint64 _q_get_avg_send_rate(struct oio_events_queue_s *self, gint64 duration);
 guint64 _q_get_avg_send_time(struct oio_events_queue_s *self, gint64 duration);
 /** Get a health metric for the events queue, from 0 (bad) to 100 (good). */
 gint64 _q_get_health(struct oio_events_queue_s *self);
+gboolean _q_get_spool_backlog(struct oio_events_queue_s *self,
+		guint64 *pbytes, gint64 *page);
 guint64 _q_get_total_send_time(struct oio_events_queue_s *self);
 guint64 _q_get_total_sent_events(struct oio_events_queue_s *self);
 gboolean _q_is_empty(struct _queue_with_endpoint_s *q);
@@ -89,5 +96,14 @@ gboolean _q_send(struct oio_events_queue_s *self, gchar* key, gchar *msg);
 gboolean _q_send_overwritable(struct oio_events_queue_s *self, gchar *tag,
 	gchar *msg);
 void _q_set_buffering(struct oio_events_queue_s *self, gint64 v);
+/** Open the spool of the queue, if configured, before its start. */
+void _q_spool_open(struct _queue_with_endpoint_s *q);
+/** Returns TRUE if the event has been spooled (and freed), FALSE if the
+ * queue has no spool or if the spool is full. */
+gboolean _q_spool_send(struct _queue_with_endpoint_s *q, gchar *key, gchar *msg);
+/** Get a copy of the next spooled event, waiting a bit if there is none.
+ * It must be acknowledged with oio_events_spool_ack() once managed. */
+gboolean _q_spool_read(struct _queue_with_endpoint_s *q, guint64 *pseq,
+		gchar **pkey, gchar **pmsg);
 
 #endif /*OIO_SDS__sqlx__oio_events_queue_shared_h*/
@@ -0,0 +1,760 @@
+/*
+OpenIO SDS event queue
+Copyright (C) 2025 OVH SAS
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 3.0 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <zlib.h>
+
+#include <core/oio_core.h>
+#include <core/internals.h>
+#include <events/events_variables.h>
+
+#include "oio_events_spool.h"
+
+/* A frame is made of a header (length of the body, CRC32 of the body) and
+ * of a body (timestamp, length of the key, key, message), all the integers
+ * in little-endian. */
+#define SPOOL_HEAD_SIZE   8
+#define SPOOL_FIXED_SIZE  12
+#define SPOOL_FRAME_MAX   (64 * 1024 * 1024)
+
+#define SPOOL_SEGMENT_SUFFIX ".seg"
+
+/* An event read by the worker, not acknowledged yet */
+struct spool_read_s
+{
+	guint64 seg;
+	guint64 off;
+	guint32 size;
+	gint64 time;
+	gboolean acked;
+};
+
+struct oio_events_spool_s
+{
+	gchar *path;
+	int lock_fd;
+
+	GMutex lock;
+	GCond cond;
+
+	/* Under the lock */
+	int wfd;
+	guint64 wseg;
+	guint64 woff;
+	guint64 wseq;  // count of appends, to wake the worker
+	guint64 backlog;
+	gint64 oldest;
+	gint64 last_sync;
+	gboolean dirty;
+
+	/* Worker only */
+	int rfd;
+	guint64 rseg;  // the cursor: the oldest event not acknowledged
+	guint64 roff;
+	guint64 nseg;  // the next event to read, in the segment open as `rfd`
+	guint64 noff;
+	guint64 rseq;
+	gint64 last_save;
+	gboolean moved;
+
+	/* The events read and not acknowledged yet, from `inflight_head`, in
+	 * the order of the spool. The event at the index `i` has the sequence
+	 * number `inflight_seq + i`. */
+	GArray *inflight;
+	guint inflight_head;
+	guint64 inflight_seq;
+};
+
+static inline void
+_put32(guint8 *p, guint32 v)
+{
+	v = GUINT32_TO_LE(v);
+	memcpy(p, &v, sizeof(v));
+}
+
+static inline void
+_put64(guint8 *p, gint64 v)
+{
+	v = GINT64_TO_LE(v);
+	memcpy(p, &v, sizeof(v));
+}
+
+static inline guint32
+_get32(const guint8 *p)
+{
+	guint32 v;
+	memcpy(&v, p, sizeof(v));
+	return GUINT32_FROM_LE(v);
+}
+
+static inline gint64
+_get64(const guint8 *p)
+{
+	gint64 v;
+	memcpy(&v, p, sizeof(v));
+	return GINT64_FROM_LE(v);
+}
+
+static gchar *
+_segment_path(struct oio_events_spool_s *sp, guint64 seg)
+{
+	return g_strdup_printf("%s/%016"G_GINT64_MODIFIER"x"SPOOL_SEGMENT_SUFFIX,
+			sp->path, seg);
+}
+
+static gint
+_cmp_seg(gconstpointer p0, gconstpointer p1)
+{
+	const guint64 s0 = *(const guint64*)p0, s1 = *(const guint64*)p1;
+	return CMP(s0, s1);
+}
+
+/* Read the frame at `off`. On success, `head` is filled and `*pbody`
+ * receives the body (key and message), NUL-terminated. */
+static gboolean
+_frame_read(int fd, guint64 off, guint8 *head, gchar **pbody)
+{
+	if (pread(fd, head, SPOOL_HEAD_SIZE + SPOOL_FIXED_SIZE, off)
+			!= SPOOL_HEAD_SIZE + SPOOL_FIXED_SIZE)
+		return FALSE;
+
+	const guint32 len = _get32(head);
+	const guint32 klen = _get32(head + SPOOL_HEAD_SIZE + 8);
+	if (len < SPOOL_FIXED_SIZE || len > SPOOL_FRAME_MAX
+			|| klen > len - SPOOL_FIXED_SIZE)
+		return FALSE;
+
+	const gsize vlen = len - SPOOL_FIXED_SIZE;
+	gchar *body = g_malloc(vlen + 1);
+	if (pread(fd, body, vlen, off + SPOOL_HEAD_SIZE + SPOOL_FIXED_SIZE)
+			!= (ssize_t)vlen) {
+		g_free(body);
+		return FALSE;
+	}
+
+	uLong crc = crc32(0L, Z_NULL, 0);
+	crc = crc32(crc, head + SPOOL_HEAD_SIZE, SPOOL_FIXED_SIZE);
+	crc = crc32(crc, (const Bytef*)body, vlen);
+	if ((guint32)crc != _get32(head + 4)) {
+		g_free(body);
+		return FALSE;
+	}
+
+	body[vlen] = '\0';
+	*pbody = body;
+	return TRUE;
+}
+
+/* Find the end of the last complete frame of the segment, from `off` */
+static guint64
+_segment_scan(int fd, guint64 off)
+{
+	guint8 head[SPOOL_HEAD_SIZE + SPOOL_FIXED_SIZE];
+	gchar *body = NULL;
+	while (_frame_read(fd, off, head, &body)) {
+		off += SPOOL_HEAD_SIZE + _get32(head);
+		g_free(body);
+		body = NULL;
+	}
+	return off;
+}
+
+static GError *
+_segment_open(struct oio_events_spool_s *sp, guint64 seg, int *pfd)
+{
+	gchar *path = _segment_path(sp, seg);
+	int fd = open(path, O_RDWR|O_CREAT|O_APPEND|O_CLOEXEC, 0644);
+	GError *err = NULL;
+	if (fd < 0)
+		err = SYSERR("spool segment open(%s): (%d) %s",
+				path, errno, strerror(errno));
+	g_free(path);
+	*pfd = fd;
+	return err;
+}
+
+static void
+_cursor_load(struct oio_events_spool_s *sp)
+{
+	gchar *path = g_strdup_printf("%s/cursor", sp->path);
+	gchar *content = NULL;
+	if (g_file_get_contents(path, &content, NULL, NULL)) {
+		gchar *end = NULL;
+		sp->rseg = g_ascii_strtoull(content, &end, 10);
+		sp->roff = g_ascii_strtoull(end, NULL, 10);
+		g_free(content);
+	}
+	g_free(path);
+}
+
+static void
+_cursor_save(struct oio_events_spool_s *sp)
+{
+	gchar *path = g_strdup_printf("%s/cursor", sp->path);
+	gchar content[64];
+	g_snprintf(content, sizeof(content),
+			"%"G_GUINT64_FORMAT" %"G_GUINT64_FORMAT"\n", sp->rseg, sp->roff);
+	GError *err = NULL;
+	if (!g_file_set_contents(path, content, -1, &err)) {
+		GRID_WARN("Spool [%s] cursor save error: %s", sp->path, err->message);
+		g_clear_error(&err);
+	} else {
+		sp->moved = FALSE;
+	}
+	g_free(path);
+}
+
+static GError *
+_spool_lock(struct oio_events_spool_s *sp)
+{
+	gchar *path = g_strdup_printf("%s/lock", sp->path);
+	GError *err = NULL;
+	sp->lock_fd = open(path, O_RDWR|O_CREAT|O_CLOEXEC, 0644);
+	if (sp->lock_fd < 0)
+		err = SYSERR("spool lock open(%s): (%d) %s",
+				path, errno, strerror(errno));
+	else if (flock(sp->lock_fd, LOCK_EX|LOCK_NB) < 0)
+		err = BUSY("spool [%s] already in use", sp->path);
+	g_free(path);
+	return err;
+}
+
+/* Find the segments left by the previous run, forget those already drained
+ * and repair the last one. */
+static GError *
+_spool_load(struct oio_events_spool_s *sp)
+{
+	GError *err = NULL;
+	struct stat st = {0};
+	guint64 start = 0;
+	GDir *dir = g_dir_open(sp->path, 0, &err);
+	if (!dir) {
+		GError *e = SYSERR("spool [%s] listing: %s", sp->path, err->message);
+		g_clear_error(&err);
+		return e;
+	}
+
+	GArray *segs = g_array_new(FALSE, FALSE, sizeof(guint64));
+	for (const gchar *name; (name = g_dir_read_name(dir));) {
+		if (!g_str_has_suffix(name, SPOOL_SEGMENT_SUFFIX))
+			continue;
+		gchar *end = NULL;
+		const guint64 seg = g_ascii_strtoull(name, &end, 16);
+		if (end == name || strcmp(end, SPOOL_SEGMENT_SUFFIX) != 0)
+			continue;
+		g_array_append_val(segs, seg);
+	}
+	g_dir_close(dir);
+	g_array_sort(segs, _cmp_seg);
+
+	_cursor_load(sp);
+
+	guint i = 0;
+	for (; i < segs->len && g_array_index(segs, guint64, i) < sp->rseg; i++) {
+		gchar *path = _segment_path(sp, g_array_index(segs, guint64, i));
+		g_unlink(path);
+		g_free(path);
+	}
+
+	if (i >= segs->len) {
+		/* Nothing to replay */
+		sp->wseg = sp->rseg;
+		sp->woff = sp->roff = 0;
+		err = _segment_open(sp, sp->wseg, &sp->wfd);
+		if (!err && ftruncate(sp->wfd, 0) < 0)
+			err = SYSERR("spool truncate: (%d) %s", errno, strerror(errno));
+		if (!err)
+			_cursor_save(sp);
+		goto exit;
+	}
+
+	if (g_array_index(segs, guint64, i) > sp->rseg) {
+		sp->rseg = g_array_index(segs, guint64, i);
+		sp->roff = 0;
+	}
+	sp->wseg = g_array_index(segs, guint64, segs->len - 1);
+	if ((err = _segment_open(sp, sp->wseg, &sp->wfd)))
+		goto exit;
+
+	/* The last segment may end with a frame partially written before a
+	 * crash, or with frames never synced. */
+	if (fstat(sp->wfd, &st) < 0) {
+		err = SYSERR("spool stat: (%d) %s", errno, strerror(errno));
+		goto exit;
+	}
+	if (sp->rseg == sp->wseg) {
+		if (sp->roff > (guint64)st.st_size) {
+			GRID_WARN("Spool [%s] cursor beyond the end, rewinding", sp->path);
+			sp->roff = 0;
+		}
+		start = sp->roff;
+	}
+	sp->woff = _segment_scan(sp->wfd, start);
+	if (sp->woff < (guint64)st.st_size) {
+		GRID_WARN("Spool [%s] %"G_GUINT64_FORMAT" bytes discarded at the end"
+				" of segment %"G_GUINT64_FORMAT, sp->path,
+				(guint64)st.st_size - sp->woff, sp->wseg);
+		if (ftruncate(sp->wfd, sp->woff) < 0)
+			err = SYSERR("spool truncate: (%d) %s", errno, strerror(errno));
+	}
+
+	/* Everything between the cursor and the end remains to be sent */
+	for (guint j = i; j < segs->len - 1; j++) {
+		gchar *path = _segment_path(sp, g_array_index(segs, guint64, j));
+		if (g_stat(path, &st) == 0)
+			sp->backlog += st.st_size;
+		g_free(path);
+	}
+	sp->backlog += sp->woff;
+	sp->backlog -= MIN(sp->backlog, sp->roff);
+	if (sp->backlog > 0)
+		GRID_NOTICE("Spool [%s] replaying %"G_GUINT64_FORMAT" bytes of events",
+				sp->path, sp->backlog);
+
+exit:
+	sp->nseg = sp->rseg;
+	sp->noff = sp->roff;
+	g_array_free(segs, TRUE);
+	return err;
+}
+
+static void
+_spool_free(struct oio_events_spool_s *sp)
+{
+	if (sp->rfd >= 0)
+		close(sp->rfd);
+	if (sp->wfd >= 0)
+		close(sp->wfd);
+	/* Also releases the lock */
+	if (sp->lock_fd >= 0)
+		close(sp->lock_fd);
+	g_cond_clear(&sp->cond);
+	g_mutex_clear(&sp->lock);
+	g_array_free(sp->inflight, TRUE);
+	oio_str_clean(&sp->path);
+	g_free(sp);
+}
+
+GError *
+oio_events_spool_open(const char *path, struct oio_events_spool_s **out)
+{
+	EXTRA_ASSERT(path != NULL);
+	EXTRA_ASSERT(out != NULL);
+	*out = NULL;
+
+	if (g_mkdir_with_parents(path, 0755) < 0)
+		return SYSERR("spool mkdir(%s): (%d) %s", path, errno, strerror(errno));
+
+	struct oio_events_spool_s *sp = g_malloc0(sizeof(*sp));
+	sp->path = g_strdup(path);
+	sp->lock_fd = sp->wfd = sp->rfd = -1;
+	g_mutex_init(&sp->lock);
+	g_cond_init(&sp->cond);
+	sp->inflight = g_array_new(FALSE, FALSE, sizeof(struct spool_read_s));
+	/* 0 is never a sequence number */
+	sp->inflight_seq = 1;
+
+	GError *err = _spool_lock(sp);
+	if (!err)
+		err = _spool_load(sp);
+	if (err) {
+		_spool_free(sp);
+		return err;
+	}
+
+	sp->last_sync = sp->last_save = oio_ext_monotonic_time();
+	*out = sp;
+	return NULL;
+}
+
+void
+oio_events_spool_close(struct oio_events_spool_s *sp)
+{
+	if (!sp)
+		return;
+	oio_events_spool_flush(sp, TRUE);
+	_spool_free(sp);
+}
+
+/* Called under the lock, when the current segment is full */
+static GError *
+_spool_roll(struct oio_events_spool_s *sp)
+{
+	int fd = -1;
+	GError *err = _segment_open(sp, sp->wseg + 1, &fd);
+	if (err)
+		return err;
+
+	/* The worker only syncs the current segment, the previous one must be
+	 * complete on the disk before the new one is used. */
+	if (fdatasync(sp->wfd) < 0)
+		GRID_WARN("Spool [%s] sync error: (%d) %s",
+				sp->path, errno, strerror(errno));
+	close(sp->wfd);
+
+	sp->wfd = fd;
+	sp->wseg ++;
+	sp->woff = 0;
+	return NULL;
+}
+
+GError *
+oio_events_spool_append(struct oio_events_spool_s *sp,
+		const gchar *key, const gchar *msg)
+{
+	EXTRA_ASSERT(sp != NULL);
+	EXTRA_ASSERT(msg != NULL);
+
+	const gsize klen = key ? strlen(key) : 0;
+	const gsize mlen = strlen(msg);
+	const gsize len = SPOOL_FIXED_SIZE + klen + mlen;
+	if (len > SPOOL_FRAME_MAX)
+		return BADREQ("event too large for the spool");
+
+	const gint64 now = oio_ext_real_time();
+	guint8 head[SPOOL_HEAD_SIZE + SPOOL_FIXED_SIZE];
+	_put32(head, len);
+	_put64(head + SPOOL_HEAD_SIZE, now);
+	_put32(head + SPOOL_HEAD_SIZE + 8, klen);
+	uLong crc = crc32(0L, Z_NULL, 0);
+	crc = crc32(crc, head + SPOOL_HEAD_SIZE, SPOOL_FIXED_SIZE);
+	if (klen)
+		crc = crc32(crc, (const Bytef*)key, klen);
+	crc = crc32(crc, (const Bytef*)msg, mlen);
+	_put32(head + 4, crc);
+
+	struct iovec iov[3] = {
+		{head, sizeof(head)}, {(void*)key, klen}, {(void*)msg, mlen},
+	};
+	const gsize total = SPOOL_HEAD_SIZE + len;
+
+	GError *err = NULL;
+	g_mutex_lock(&sp->lock);
+	if (oio_events_spool_max_size > 0
+			&& sp->backlog + total > (guint64)oio_events_spool_max_size)
+		err = BUSY("spool full");
+	if (!err && sp->woff > 0
+			&& sp->woff + total > (guint64)oio_events_spool_segment_size)
+		err = _spool_roll(sp);
+	if (!err) {
+		const ssize_t w = writev(sp->wfd, iov, 3);
+		if (w != (ssize_t)total) {
+			err = SYSERR("spool write: (%d) %s", errno, strerror(errno));
+			/* Never leave a partial frame in the middle of the segment */
+			if (w > 0 && ftruncate(sp->wfd, sp->woff) < 0)
+				GRID_ERROR("Spool [%s] truncate error: (%d) %s",
+						sp->path, errno, strerror(errno));
+		}
+	}
+	if (!err) {
+		if (!sp->backlog)
+			sp->oldest = now;
+		sp->backlog += total;
+		sp->woff += total;
+		sp->wseq ++;
+		sp->dirty = TRUE;
+		g_cond_signal(&sp->cond);
+	}
+	g_mutex_unlock(&sp->lock);
+	return err;
+}
+
+static void
+_reader_close(struct oio_events_spool_s *sp)
+{
+	if (sp->rfd >= 0) {
+		close(sp->rfd);
+		sp->rfd = -1;
+	}
+}
+
+static guint
+_inflight_count(struct oio_events_spool_s *sp)
+{
+	return sp->inflight->len - sp->inflight_head;
+}
+
+/* Move the cursor to the oldest event not acknowledged, or to the next
+ * event to read if all of them are, deleting the segments drained. */
+static void
+_cursor_advance(struct oio_events_spool_s *sp)
+{
+	guint64 freed = 0;
+	while (_inflight_count(sp) > 0) {
+		struct spool_read_s *r = &g_array_index(
+				sp->inflight, struct spool_read_s, sp->inflight_head);
+		if (!r->acked)
+			break;
+		freed += r->size;
+		sp->inflight_head ++;
+	}
+
+	guint64 seg = sp->nseg, off = sp->noff;
+	gint64 oldest = 0;
+	if (_inflight_count(sp) > 0) {
+		struct spool_read_s *r = &g_array_index(
+				sp->inflight, struct spool_read_s, sp->inflight_head);
+		seg = r->seg;
+		off = r->off;
+		oldest = r->time;
+	}
+	/* Forget the events acknowledged, from time to time */
+	if (!_inflight_count(sp) || (sp->inflight_head >= 1024
+				&& sp->inflight_head >= sp->inflight->len / 2)) {
+		sp->inflight_seq += sp->inflight_head;
+		g_array_remove_range(sp->inflight, 0, sp->inflight_head);
+		sp->inflight_head = 0;
+	}
+
+	for (; sp->rseg < seg; sp->rseg ++) {
+		gchar *path = _segment_path(sp, sp->rseg);
+		if (g_unlink(path) < 0 && errno != ENOENT)
+			GRID_WARN("Spool [%s] unlink(%s) error: (%d) %s",
+					sp->path, path, errno, strerror(errno));
+		g_free(path);
+		sp->roff = 0;
+		sp->moved = TRUE;
+	}
+	if (sp->roff != off) {
+		sp->roff = off;
+		sp->moved = TRUE;
+	}
+
+	if (freed || oldest) {
+		g_mutex_lock(&sp->lock);
+		sp->backlog -= MIN(sp->backlog, freed);
+		if (oldest)
+			sp->oldest = oldest;
+		g_mutex_unlock(&sp->lock);
+	}
+}
+
+/* Move to the next segment. It is deleted once its events are all
+ * acknowledged. */
+static void
+_reader_next_segment(struct oio_events_spool_s *sp)
+{
+	_reader_close(sp);
+	sp->nseg ++;
+	sp->noff = 0;
+	_cursor_advance(sp);
+}
+
+/* Forget the rest of the current segment, that cannot be read */
+static void
+_reader_skip(struct oio_events_spool_s *sp, guint64 wseg, guint64 woff)
+{
+	guint64 end = woff;
+	struct stat st = {0};
+	if (sp->nseg < wseg)
+		end = fstat(sp->rfd, &st) == 0 ? (guint64)st.st_size : sp->noff;
+	GRID_ERROR("Spool [%s] corrupted in segment %"G_GUINT64_FORMAT
+			" at %"G_GUINT64_FORMAT", %"G_GUINT64_FORMAT" bytes of events lost",
+			sp->path, sp->nseg, sp->noff, end - MIN(end, sp->noff));
+
+	g_mutex_lock(&sp->lock);
+	sp->backlog -= MIN(sp->backlog, end - MIN(end, sp->noff));
+	g_mutex_unlock(&sp->lock);
+
+	if (sp->nseg < wseg) {
+		_reader_next_segment(sp);
+	} else {
+		sp->noff = woff;
+		_cursor_advance(sp);
+	}
+}
+
+gboolean
+oio_events_spool_read(struct oio_events_spool_s *sp, guint64 *pseq,
+		gchar **pkey, gchar **pmsg)
+{
+	EXTRA_ASSERT(sp != NULL);
+	EXTRA_ASSERT(pseq != NULL);
+	EXTRA_ASSERT(pmsg != NULL);
+
+	for (;;) {
+		g_mutex_lock(&sp->lock);
+		const guint64 wseg = sp->wseg, woff = sp->woff;
+		sp->rseq = sp->wseq;
+		g_mutex_unlock(&sp->lock);
+
+		if (sp->nseg == wseg && sp->noff >= woff)
+			return FALSE;
+
+		if (sp->rfd < 0) {
+			gchar *path = _segment_path(sp, sp->nseg);
+			sp->rfd = open(path, O_RDONLY|O_CLOEXEC);
+			const int errsv = errno;
+			g_free(path);
+			if (sp->rfd < 0) {
+				if (errsv == ENOENT && sp->nseg < wseg) {
+					_reader_next_segment(sp);
+					continue;
+				}
+				GRID_WARN("Spool [%s] segment %"G_GUINT64_FORMAT
+						" open error: (%d) %s",
+						sp->path, sp->nseg, errsv, strerror(errsv));
+				return FALSE;
+			}
+		}
+
+		guint8 head[SPOOL_HEAD_SIZE + SPOOL_FIXED_SIZE];
+		gchar *body = NULL;
+		if (!_frame_read(sp->rfd, sp->noff, head, &body)) {
+			struct stat st = {0};
+			if (sp->nseg < wseg && fstat(sp->rfd, &st) == 0
+					&& sp->noff >= (guint64)st.st_size) {
+				/* End of a segment left by the writer */
+				_reader_next_segment(sp);
+			} else {
+				_reader_skip(sp, wseg, woff);
+			}
+			continue;
+		}
+
+		const guint32 klen = _get32(head + SPOOL_HEAD_SIZE + 8);
+		if (pkey)
+			*pkey = klen ? g_strndup(body, klen) : NULL;
+		*pmsg = g_strdup(body + klen);
+		g_free(body);
+
+		struct spool_read_s r = {0};
+		r.seg = sp->nseg;
+		r.off = sp->noff;
+		r.size = SPOOL_HEAD_SIZE + _get32(head);
+		r.time = _get64(head + SPOOL_HEAD_SIZE);
+		if (!_inflight_count(sp)) {
+			g_mutex_lock(&sp->lock);
+			sp->oldest = r.time;
+			g_mutex_unlock(&sp->lock);
+		}
+		g_array_append_val(sp->inflight, r);
+		*pseq = sp->inflight_seq + sp->inflight->len - 1;
+		sp->noff += r.size;
+		return TRUE;
+	}
+}
+
+void
+oio_events_spool_ack(struct oio_events_spool_s *sp, guint64 seq)
+{
+	EXTRA_ASSERT(sp != NULL);
+	/* Ignore the events forgotten by a rewind */
+	if (seq < sp->inflight_seq + sp->inflight_head
+			|| seq >= sp->inflight_seq + sp->inflight->len)
+		return;
+
+	g_array_index(sp->inflight, struct spool_read_s,
+			seq - sp->inflight_seq).acked = TRUE;
+	_cursor_advance(sp);
+}
+
+void
+oio_events_spool_rewind(struct oio_events_spool_s *sp)
+{
+	EXTRA_ASSERT(sp != NULL);
+	if (sp->nseg != sp->rseg)
+		_reader_close(sp);
+	sp->nseg = sp->rseg;
+	sp->noff = sp->roff;
+	sp->inflight_seq += sp->inflight->len;
+	g_array_set_size(sp->inflight, 0);
+	sp->inflight_head = 0;
+}
+
+guint
+oio_events_spool_inflight(struct oio_events_spool_s *sp)
+{
+	EXTRA_ASSERT(sp != NULL);
+	return _inflight_count(sp);
+}
+
+void
+oio_events_spool_wait(struct oio_events_spool_s *sp, gint64 delay)
+{
+	EXTRA_ASSERT(sp != NULL);
+	const gint64 deadline = g_get_monotonic_time() + delay;
+	g_mutex_lock(&sp->lock);
+	while (sp->wseq == sp->rseq) {
+		if (!g_cond_wait_until(&sp->cond, &sp->lock, deadline))
+			break;
+	}
+	g_mutex_unlock(&sp->lock);
+}
+
+void
+oio_events_spool_flush(struct oio_events_spool_s *sp, gboolean force)
+{
+	EXTRA_ASSERT(sp != NULL);
+	const gint64 now = oio_ext_monotonic_time();
+
+	/* Sync a duplicate of the descriptor, out of the lock, so that the
+	 * appenders never wait for the disk, even if they roll the segment
+	 * meanwhile. */
+	int fd = -1;
+	g_mutex_lock(&sp->lock);
+	if (sp->dirty && sp->wfd >= 0
+			&& (force || now - sp->last_sync >= oio_events_spool_sync_period)) {
+		if ((fd = dup(sp->wfd)) >= 0) {
+			sp->dirty = FALSE;
+			sp->last_sync = now;
+		}
+	}
+	g_mutex_unlock(&sp->lock);
+
+	if (fd >= 0) {
+		if (fdatasync(fd) < 0)
+			GRID_WARN("Spool [%s] sync error: (%d) %s",
+					sp->path, errno, strerror(errno));
+		close(fd);
+	}
+
+	/* Saved after the sync: the cursor never points to events that are not
+	 * on the disk yet. */
+	if (sp->moved
+			&& (force || now - sp->last_save >= oio_events_spool_sync_period)) {
+		sp->last_save = now;
+		_cursor_save(sp);
+	}
+}
+
+void
+oio_events_spool_get_backlog(struct oio_events_spool_s *sp,
+		guint64 *pbytes, gint64 *page)
+{
+	EXTRA_ASSERT(sp != NULL);
+	const gint64 now = oio_ext_real_time();
+	g_mutex_lock(&sp->lock);
+	const guint64 bytes = sp->backlog;
+	const gint64 age = (bytes && sp->oldest) ? MAX(0, now - sp->oldest) : 0;
+	g_mutex_unlock(&sp->lock);
+	if (pbytes)
+		*pbytes = bytes;
+	if (page)
+		*page = age;
+}
@@ -0,0 +1,86 @@
+/*
+OpenIO SDS event queue
+Copyright (C) 2025 OVH SAS
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 3.0 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+*/
+
+#ifndef OIO_SDS__events__oio_events_spool_h
+# define OIO_SDS__events__oio_events_spool_h 1
+
+#include <glib.h>
+
+/* A spool is an append-only log of events kept in a directory, as a
+ * sequence of numbered segment files. Each event is a frame checked with
+ * a CRC32. Any thread may append, a single worker reads the frames in
+ * order and acknowledges them once sent, possibly out of order, with
+ * several of them in flight. The position of the oldest event not
+ * acknowledged is saved in a "cursor" file, so that the events not
+ * acknowledged yet are replayed after a restart (at least once). The
+ * drained segments are deleted.
+ *
+ * The appenders never wait for the disk: the writes are synced by the
+ * worker, in batch, with oio_events_spool_flush(). */
+struct oio_events_spool_s;
+
+/* Open (or create) the spool in `path`. The directory is locked, it cannot
+ * be opened twice, even by another process. The torn frame possibly left
+ * at the end of the spool by a crash is discarded. */
+GError * oio_events_spool_open(const char *path,
+		struct oio_events_spool_s **out);
+
+/* Sync the spool and close it. The events not acknowledged stay in it. */
+void oio_events_spool_close(struct oio_events_spool_s *sp);
+
+/* Append an event. `key` may be NULL. The ownership of the strings is not
+ * taken. Fails when the spool is full (events.spool.max_size) or on an I/O
+ * error: the caller is expected to fall back on the in-memory queue. */
+GError * oio_events_spool_append(struct oio_events_spool_s *sp,
+		const gchar *key, const gchar *msg);
+
+/* Get a copy of the next event, after those already read, and its
+ * sequence number (never 0). The event stays in the spool until it is
+ * acknowledged. Returns FALSE if there is none. `pkey` may be NULL.
+ * Reserved to the worker thread. */
+gboolean oio_events_spool_read(struct oio_events_spool_s *sp,
+		guint64 *pseq, gchar **pkey, gchar **pmsg);
+
+/* Consume the event read with the sequence number `seq`. The cursor moves
+ * over the events acknowledged, up to the oldest one that is not.
+ * Reserved to the worker thread. */
+void oio_events_spool_ack(struct oio_events_spool_s *sp, guint64 seq);
+
+/* Read again from the oldest event not acknowledged. The events read until
+ * now are forgotten, their sequence numbers are ignored by
+ * oio_events_spool_ack(). Reserved to the worker thread. */
+void oio_events_spool_rewind(struct oio_events_spool_s *sp);
+
+/* Count the events read and not acknowledged yet. Reserved to the worker
+ * thread. */
+guint oio_events_spool_inflight(struct oio_events_spool_s *sp);
+
+/* Wait at most `delay` for an event to be appended, if there is none. */
+void oio_events_spool_wait(struct oio_events_spool_s *sp, gint64 delay);
+
+/* Sync the appended events and save the cursor, if events.spool.sync_period
+ * has elapsed since the last time or if `force` is set. Reserved to the
+ * worker thread. */
+void oio_events_spool_flush(struct oio_events_spool_s *sp, gboolean force);
+
+/* Get the size of the events not acknowledged yet, and the age (in
+ * microseconds) of the oldest of them. */
+void oio_events_spool_get_backlog(struct oio_events_spool_s *sp,
+		guint64 *pbytes, gint64 *page);
+
+#endif /*OIO_SDS__events__oio_events_spool_h*/
@@ -188,7 +188,8 @@ __info_user(struct sqlx_sqlite3_s *sq3, struct oio_url_s *url, gboolean ac,
 
 retry:
 	/* Prepare the statement */
-	sqlite3_prepare_debug(rc, sq3->db, "SELECT account,user FROM users WHERE cid = ?", -1, &stmt, NULL);
+	rc = sqlx_sqlite3_prepare(sq3,
+			"SELECT account,user FROM users WHERE cid = ?", -1, &stmt);
 	if (rc != SQLITE_OK)
 		return M1_SQLITE_GERROR(sq3->db, rc);
 	(void) sqlite3_bind_blob(stmt, 1, oio_url_get_id (url), oio_url_get_id_size (url), NULL);
@@ -212,7 +213,7 @@ retry:
 		g_prefix_error(&err, "DB error: ");
 	}
 
-	sqlite3_finalize_debug(rc,stmt);
+	sqlx_sqlite3_release(sq3, stmt, err);
 	stmt = NULL;
 
 	if (err) {
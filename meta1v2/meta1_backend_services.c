@@ -340,16 +340,16 @@ __get_container_all_services(struct sqlx_sqlite3_s *sq3, struct oio_url_s *url,
 
 	/* Prepare the statement */
 	if (srvtype && *srvtype) {
-		sqlite3_prepare_debug(rc, sq3->db,
-				"SELECT seq,srvtype,url,args FROM services WHERE cid = ? AND srvtype = ?", -1, &stmt, NULL);
+		rc = sqlx_sqlite3_prepare(sq3,
+				"SELECT seq,srvtype,url,args FROM services WHERE cid = ? AND srvtype = ?", -1, &stmt);
 		if (rc != SQLITE_OK)
 			return M1_SQLITE_GERROR(sq3->db, rc);
 		(void) sqlite3_bind_blob(stmt, 1, oio_url_get_id(url), oio_url_get_id_size(url), NULL);
 		(void) sqlite3_bind_text(stmt, 2, srvtype, -1, NULL);
 	}
 	else {
-		sqlite3_prepare_debug(rc, sq3->db,
-				"SELECT seq,srvtype,url,args FROM services WHERE cid = ?", -1, &stmt, NULL);
+		rc = sqlx_sqlite3_prepare(sq3,
+				"SELECT seq,srvtype,url,args FROM services WHERE cid = ?", -1, &stmt);
 		if (rc != SQLITE_OK)
 			return M1_SQLITE_GERROR(sq3->db, rc);
 		(void) sqlite3_bind_blob(stmt, 1, oio_url_get_id(url), oio_url_get_id_size(url), NULL);
@@ -370,7 +370,7 @@ __get_container_all_services(struct sqlx_sqlite3_s *sq3, struct oio_url_s *url,
 
 	if (rc != SQLITE_DONE && rc != SQLITE_OK)
 		err = M1_SQLITE_GERROR(sq3->db, rc);
-	sqlite3_finalize_debug(rc, stmt);
+	sqlx_sqlite3_release(sq3, stmt, err);
 
 	if (err) {
 		gpa_str_free(gpa);
@@ -1212,13 +1212,15 @@ __notify_services_by_cid(struct meta1_backend_s *m1, struct sqlx_sqlite3_s *sq3,
 		struct oio_url_s *url)
 {
 	struct oio_url_s **urls = NULL;
-	sqlx_exec (sq3->db, "BEGIN");
+	/* Do not end the transaction that a replication group may hold */
+	sqlx_exec (sq3->db, "SAVEPOINT notify");
 	GError *err = __info_user(sq3, url, FALSE, &urls);
 	if (!err) {
 		oio_url_set (urls[0], OIOURL_NS, m1->ns_name);
 		err = __notify_services(m1, sq3, url);
 	}
-	sqlx_exec (sq3->db, "ROLLBACK");
+	sqlx_exec (sq3->db, "ROLLBACK TO notify");
+	sqlx_exec (sq3->db, "RELEASE notify");
 	oio_url_cleanv (urls);
 
 	if (err) {
@@ -76,17 +76,155 @@ _gba_assign(GByteArray *base, GByteArray *gba)
 	return base;
 }
 
-/* -------------------------------------------------------------------------- */
+/* Bean pools --------------------------------------------------------------- */
+
+/* The fields bigger than this are not kept in a pool */
+#define BEAN_POOL_MAX_FIELD 4096
+
+struct bean_pool_s
+{
+	/* <descr*, GPtrArray*> the beans cleaned, ready to be reused */
+	GHashTable *shells;
+	guint depth;
+	gint64 mallocs;
+	gint64 reused;
+};
+
+static void _bean_pool_free(gpointer p);
+
+static GPrivate th_bean_pool = G_PRIVATE_INIT(_bean_pool_free);
+
+static void _bean_free(gpointer bean);
+
+static void
+_bean_shells_free(gpointer p)
+{
+	GPtrArray *shells = p;
+	for (guint i = 0; i < shells->len; i++)
+		_bean_free(shells->pdata[i]);
+	g_ptr_array_free(shells, TRUE);
+}
+
+static void
+_bean_pool_free(gpointer p)
+{
+	struct bean_pool_s *pool = p;
+	if (!pool)
+		return;
+	g_hash_table_destroy(pool->shells);
+	g_free(pool);
+}
 
 void
-_bean_clean(gpointer bean)
+_bean_pool_begin(void)
+{
+	struct bean_pool_s *pool = g_private_get(&th_bean_pool);
+	if (!pool) {
+		pool = g_malloc0(sizeof(*pool));
+		pool->shells = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+				NULL, _bean_shells_free);
+		g_private_set(&th_bean_pool, pool);
+	}
+	pool->depth ++;
+}
+
+void
+_bean_pool_report(void)
+{
+	struct bean_pool_s *pool = g_private_get(&th_bean_pool);
+	if (!pool)
+		return;
+	oio_ext_add_perfdata_count("bean_malloc_count", pool->mallocs);
+	oio_ext_add_perfdata_count("bean_reuse_count", pool->reused);
+	pool->mallocs = pool->reused = 0;
+}
+
+void
+_bean_pool_end(void)
+{
+	struct bean_pool_s *pool = g_private_get(&th_bean_pool);
+	if (!pool || --pool->depth > 0)
+		return;
+	/* Detach the pool first, so that the shells are really freed */
+	g_private_set(&th_bean_pool, NULL);
+	_bean_pool_free(pool);
+}
+
+/* Restore <bean> as it is when just created, but with the buffers of its
+ * fields. */
+static void
+_bean_reset(gpointer bean)
 {
-	size_t offset_fields;
 	const struct field_descriptor_s *fd;
 
+	for (fd=DESCR(bean)->fields; fd->type ;fd++) {
+		gpointer pf = FIELD(bean, fd->position);
+		switch (fd->type) {
+			case FT_BOOL:
+				*((gboolean*)pf) = FALSE;
+				break;
+			case FT_INT:
+				*((gint64*)pf) = 0;
+				break;
+			case FT_REAL:
+				*((gdouble*)pf) = 0.0;
+				break;
+			case FT_TEXT:
+				if (GSTR(pf) && GSTR(pf)->allocated_len > BEAN_POOL_MAX_FIELD) {
+					g_string_free(GSTR(pf), TRUE);
+					GSTR(pf) = NULL;
+				}
+				if (GSTR(pf))
+					g_string_set_size(GSTR(pf), 0);
+				else
+					GSTR(pf) = g_string_sized_new(8);
+				break;
+			case FT_BLOB:
+				if (GBA(pf) && GBA(pf)->len > BEAN_POOL_MAX_FIELD) {
+					g_byte_array_free(GBA(pf), TRUE);
+					GBA(pf) = NULL;
+				}
+				if (GBA(pf))
+					g_byte_array_set_size(GBA(pf), 0);
+				else
+					GBA(pf) = g_byte_array_sized_new(8);
+				break;
+			default:
+				g_assert_not_reached();
+				break;
+		}
+	}
+	HDR(bean)->fields = 0;
+	HDR(bean)->flags = BEAN_FLAG_TRANSIENT|BEAN_FLAG_DIRTY;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void
+_bean_clean(gpointer bean)
+{
 	if (!bean)
 		return;
 
+	struct bean_pool_s *pool = g_private_get(&th_bean_pool);
+	if (!pool)
+		return _bean_free(bean);
+
+	_bean_reset(bean);
+	GPtrArray *shells = g_hash_table_lookup(pool->shells, DESCR(bean));
+	if (!shells) {
+		shells = g_ptr_array_new();
+		g_hash_table_insert(pool->shells, (gpointer)DESCR(bean), shells);
+	}
+	g_ptr_array_add(shells, bean);
+}
+
+static void
+_bean_free(gpointer bean)
+{
+	size_t offset_fields;
+	const struct field_descriptor_s *fd;
+
 	offset_fields = DESCR(bean)->offset_fields;
 	for (fd=DESCR(bean)->fields; fd->type ;fd++) {
 		gpointer pf = ((guint8*)bean) + offset_fields + fd->offset;
@@ -302,6 +440,17 @@ _bean_create(const struct bean_descriptor_s *descr)
 	gpointer result;
 
 	EXTRA_ASSERT(descr != NULL);
+
+	struct bean_pool_s *pool = g_private_get(&th_bean_pool);
+	if (pool) {
+		GPtrArray *shells = g_hash_table_lookup(pool->shells, descr);
+		if (shells && shells->len > 0) {
+			pool->reused ++;
+			return g_ptr_array_remove_index_fast(shells, shells->len - 1);
+		}
+		pool->mallocs ++;
+	}
+
 	result = g_malloc0(descr->struct_size);
 	HDR(result)->descr = descr;
 	HDR(result)->flags = BEAN_FLAG_TRANSIENT|BEAN_FLAG_DIRTY;
@@ -317,9 +466,11 @@ _bean_create(const struct bean_descriptor_s *descr)
 				break;
 			case FT_TEXT:
 				GSTR(pf) = g_string_sized_new(8);
+				if (pool) pool->mallocs += 2;
 				break;
 			case FT_BLOB:
 				GBA(pf) = g_byte_array_sized_new(8);
+				if (pool) pool->mallocs += 2;
 				break;
 			default:
 				g_assert_not_reached();
@@ -428,6 +579,21 @@ _bean_set_field_value(gpointer bean, guint pos, gpointer pv)
 	}
 }
 
+void
+_bean_set_field_text(gpointer bean, guint pos, const gchar *v, gsize vlen)
+{
+	EXTRA_ASSERT(DESCR(bean)->fields[pos].type == FT_TEXT);
+
+	_bean_set_field(bean, pos);
+	HDR(bean)->flags |= BEAN_FLAG_DIRTY;
+
+	gpointer pf = FIELD(bean, pos);
+	if (!GSTR(pf))
+		GSTR(pf) = g_string_sized_new(vlen);
+	g_string_set_size(GSTR(pf), 0);
+	g_string_append_len(GSTR(pf), v, vlen);
+}
+
 gpointer
 _bean_dup(gpointer bean)
 {
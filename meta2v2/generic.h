@@ -129,6 +129,19 @@ struct fk_descriptor_s
 	const char name[64];
 };
 
+/* Between _bean_pool_begin() and _bean_pool_end(), the beans cleaned by the
+ * current thread are not freed but kept with the buffers of their fields,
+ * and reused by the next _bean_create() of the same type on that thread.
+ * The pool never owns a bean in use: a bean that outlives the request (in
+ * an event, a cache, another thread) is a plain heap bean, cleaned as any
+ * other. The pooled beans are freed by the last _bean_pool_end(). */
+void _bean_pool_begin(void);
+void _bean_pool_end(void);
+
+/* Adds to the perfdata the beans allocated and reused since the previous
+ * report, as "bean_malloc_count" (allocations) and "bean_reuse_count". */
+void _bean_pool_report(void);
+
 void _bean_clean(gpointer bean);
 void _bean_cleanv(gpointer *beanv);
 void _bean_cleanv2(GPtrArray *v);
@@ -192,6 +205,9 @@ gpointer _bean_dup(gpointer bean);
 
 void _bean_set_field_value(gpointer bean, guint pos, gpointer pv);
 
+/** Copies the 'vlen' first bytes of 'v' into the text field at 'pos'. */
+void _bean_set_field_text(gpointer bean, guint pos, const gchar *v, gsize vlen);
+
 /** Appends the bean into 'gpa'.  */
 void _bean_buffer_cb(gpointer gpa, gpointer bean);
 
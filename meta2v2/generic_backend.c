@@ -454,15 +454,17 @@ _stmt_apply_GV_parameters(sqlite3_stmt *stmt, GVariant **params)
 }
 
 static GError *
-_db_prepare_statement(sqlite3 *db, const gchar *sql, int len, sqlite3_stmt **result)
+_db_prepare_statement(struct sqlx_sqlite3_s *sq3, const gchar *sql, int len,
+		sqlite3_stmt **result)
 {
-	gint rc;
 	sqlite3_stmt *stmt = NULL;
 
-	sqlite3_prepare_debug(rc, db, sql, len, &stmt, NULL);
+	/* The statements are short and very repetitive, they are reused from
+	 * the cache of the base as often as possible. */
+	gint rc = sqlx_sqlite3_prepare(sq3, sql, len, &stmt);
 
 	if (rc != SQLITE_OK && rc != SQLITE_ROW)
-		return M2_SQLITE_GERROR(db,rc);
+		return M2_SQLITE_GERROR(sq3->db,rc);
 	EXTRA_ASSERT(stmt != NULL);
 
 	*result = stmt;
@@ -479,7 +481,7 @@ _db_execute(struct sqlx_sqlite3_s *sq3, const gchar *query, int len,
 	sqlite3_stmt *stmt = NULL;
 	gint rc;
 
-	err = _db_prepare_statement(sq3->db, query, len, &stmt);
+	err = _db_prepare_statement(sq3, query, len, &stmt);
 	if (NULL != err) {
 		g_prefix_error(&err, "Prepare error: ");
 		return err;
@@ -495,7 +497,7 @@ _db_execute(struct sqlx_sqlite3_s *sq3, const gchar *query, int len,
 		}
 	}
 
-	sqlx_sqlite3_finalize(sq3, stmt, err);
+	sqlx_sqlite3_release(sq3, stmt, err);
 	return err;
 }
 
@@ -562,14 +564,14 @@ _db_get_bean(const struct bean_descriptor_s *descr,
 	EXTRA_ASSERT(cb != NULL);
 
 	if (!clause || !*clause)
-		err = _db_prepare_statement(sq3->db, descr->sql_select,
+		err = _db_prepare_statement(sq3, descr->sql_select,
 				descr->sql_select_len, &stmt);
 	else {
 		GString *sql = g_string_sized_new(128 + descr->sql_select_len);
 		g_string_append_len (sql, descr->sql_select, descr->sql_select_len);
 		g_string_append_static (sql, " WHERE ");
 		g_string_append (sql, clause);
-		err = _db_prepare_statement(sq3->db, sql->str, sql->len, &stmt);
+		err = _db_prepare_statement(sq3, sql->str, sql->len, &stmt);
 		g_string_free(sql, TRUE);
 	}
 
@@ -588,7 +590,7 @@ _db_get_bean(const struct bean_descriptor_s *descr,
 		}
 	}
 
-	sqlx_sqlite3_finalize(sq3, stmt, err);
+	sqlx_sqlite3_release(sq3, stmt, err);
 	return err;
 }
 
@@ -606,14 +608,14 @@ _db_count_bean(const struct bean_descriptor_s *descr,
 	EXTRA_ASSERT(pcount != NULL);
 
 	if (!clause || !*clause)
-		err = _db_prepare_statement(sq3->db, descr->sql_count,
+		err = _db_prepare_statement(sq3, descr->sql_count,
 				descr->sql_count_len, &stmt);
 	else {
 		GString *sql = g_string_sized_new(128 + descr->sql_count_len);
 		g_string_append_len (sql, descr->sql_count, descr->sql_count_len);
 		g_string_append_static (sql, " WHERE ");
 		g_string_append (sql, clause);
-		err = _db_prepare_statement(sq3->db, sql->str, sql->len, &stmt);
+		err = _db_prepare_statement(sq3, sql->str, sql->len, &stmt);
 		g_string_free(sql, TRUE);
 	}
 
@@ -633,7 +635,7 @@ _db_count_bean(const struct bean_descriptor_s *descr,
 		}
 	}
 
-	sqlx_sqlite3_finalize(sq3, stmt, err);
+	sqlx_sqlite3_release(sq3, stmt, err);
 	return err;
 }
 
@@ -614,9 +614,17 @@ class Generator(object):
                     )
                     out.write("\tEXTRA_ASSERT(bean != NULL);\n")
                     out.write("\tEXTRA_ASSERT(v != NULL);\n")
-                    out.write("\tGString *gs = g_string_new(v);\n")
-                    out.write("\t" + t.c_name + "_set_" + f.name + "(bean, gs);\n")
-                    out.write("\tg_string_free(gs, TRUE);\n")
+                    out.write(
+                        "\tEXTRA_ASSERT(DESCR(bean) == &descr_struct_"
+                        + t.c_name
+                        + ");\n"
+                    )
+                    # The value is copied, no need for a temporary GString
+                    out.write(
+                        "\t_bean_set_field_text(bean, "
+                        + str(f.position)
+                        + ", v, strlen(v));\n"
+                    )
                     out.write("}\n\n")
                 if isinstance(f, Blob):
                     out.write(
@@ -38,6 +38,21 @@ GByteArray* bean_sequence_marshall(GSList *beans);
 
 GSList* bean_sequence_unmarshall(const guint8 *buf, gsize buf_len);
 
+/* Decodes both the DER and the compact encodings */
 gint bean_sequence_decoder(GSList **l, const void *buf, gsize len, GError **err);
 
+/* Value of NAME_MSGKEY_BEAN_FORMAT asking for the compact encoding
+ * of the beans in the replies. */
+#define BEAN_FORMAT_COMPACT "compact"
+
+/* Flat, columnar encoding of the beans, with a table of the strings.
+ * Cheaper to produce and to read than the DER encoding. */
+GByteArray* bean_sequence_marshall_compact(GSList *beans);
+
+gboolean bean_sequence_is_compact(const void *buf, gsize len);
+
+/* Still builds one bean per entry, only the ASN.1 decoding is spared */
+gint bean_sequence_decoder_compact(GSList **l, const void *buf, gsize len,
+		GError **err);
+
 #endif /*OIO_SDS__meta2v2__meta2_bean_h*/
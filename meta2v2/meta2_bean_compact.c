@@ -0,0 +1,442 @@
+/*
+OpenIO SDS meta2v2
+Copyright (C) 2025 OVH SAS
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as
+published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+
+#include <metautils/lib/metautils.h>
+
+#include <meta2v2/generic.h>
+#include <meta2v2/autogen.h>
+#include <meta2v2/meta2_bean.h>
+
+/* Compact encoding of a sequence of beans.
+ *
+ *   magic           "M2B" + version byte
+ *   strings         varint count, then (varint length, bytes) each
+ *   kinds           varint count of beans, then one byte per bean telling
+ *                   its type (index in <compact_types>), in list order
+ *   columns         for each type present: type byte, varint count of
+ *                   beans, byte count of fields, one type byte per field,
+ *                   then for each field a bitmap of the beans having it,
+ *                   and the values of those beans only.
+ *
+ * Integers are zigzag varints, reals are 8 bytes little-endian, texts are
+ * indexes in the string table (so that the repeated policies, mime-types
+ * and chunk methods are sent once) and blobs are inline. The types of the
+ * fields are sent so that a peer knowing less fields skips the others. */
+
+#define COMPACT_MAGIC       "M2B"
+#define COMPACT_VERSION     1
+#define COMPACT_MAGIC_SIZE  4
+
+static const struct bean_descriptor_s *compact_types[] = {
+	&descr_struct_ALIASES,
+	&descr_struct_CONTENTS_HEADERS,
+	&descr_struct_CHUNKS,
+	&descr_struct_PROPERTIES,
+	&descr_struct_SHARD_RANGE,
+	NULL
+};
+
+#define COMPACT_TYPES (sizeof(compact_types) / sizeof(compact_types[0]) - 1)
+
+static gint
+_compact_type(gconstpointer bean)
+{
+	for (guint i = 0; compact_types[i]; i++) {
+		if (DESCR(bean) == compact_types[i])
+			return i;
+	}
+	return -1;
+}
+
+/* Writer ------------------------------------------------------------------- */
+
+static void
+_put_varint(GByteArray *gba, guint64 v)
+{
+	guint8 buf[10];
+	guint len = 0;
+	while (v >= 0x80) {
+		buf[len++] = (guint8)(v | 0x80);
+		v >>= 7;
+	}
+	buf[len++] = (guint8)v;
+	g_byte_array_append(gba, buf, len);
+}
+
+static void
+_put_i64(GByteArray *gba, gint64 v)
+{
+	_put_varint(gba, ((guint64)v << 1) ^ (guint64)(v >> 63));
+}
+
+static void
+_put_u8(GByteArray *gba, guint8 v)
+{
+	g_byte_array_append(gba, &v, 1);
+}
+
+struct compact_strings_s
+{
+	GHashTable *index;
+	GPtrArray *all;
+};
+
+static guint
+_string_index(struct compact_strings_s *st, GString *s)
+{
+	gpointer pi = NULL;
+	if (g_hash_table_lookup_extended(st->index, s->str, NULL, &pi))
+		return GPOINTER_TO_UINT(pi);
+	const guint i = st->all->len;
+	g_ptr_array_add(st->all, s);
+	g_hash_table_insert(st->index, s->str, GUINT_TO_POINTER(i));
+	return i;
+}
+
+static void
+_put_column(GByteArray *out, struct compact_strings_s *st,
+		GPtrArray *beans, const struct field_descriptor_s *fd)
+{
+	const guint bitmap = out->len;
+	g_byte_array_set_size(out, bitmap + (beans->len + 7) / 8);
+	memset(out->data + bitmap, 0, (beans->len + 7) / 8);
+
+	for (guint i = 0; i < beans->len; i++) {
+		gpointer bean = beans->pdata[i];
+		if (!_bean_has_field(bean, fd->position))
+			continue;
+		out->data[bitmap + i / 8] |= 1 << (i % 8);
+		gpointer pf = FIELD(bean, fd->position);
+		switch (fd->type) {
+			case FT_BOOL:
+				_put_u8(out, *((gboolean*)pf) ? 1 : 0);
+				break;
+			case FT_INT:
+				_put_i64(out, *((gint64*)pf));
+				break;
+			case FT_REAL: {
+				union { gdouble d; guint64 u; } r = { .d = *((gdouble*)pf) };
+				r.u = GUINT64_TO_LE(r.u);
+				g_byte_array_append(out, (guint8*)&r.u, 8);
+				break;
+			}
+			case FT_TEXT:
+				_put_varint(out, _string_index(st, GSTR(pf)));
+				break;
+			case FT_BLOB:
+				_put_varint(out, GBA(pf)->len);
+				g_byte_array_append(out, GBA(pf)->data, GBA(pf)->len);
+				break;
+			default:
+				g_assert_not_reached();
+				break;
+		}
+	}
+}
+
+GByteArray*
+bean_sequence_marshall_compact(GSList *beans)
+{
+	GPtrArray *by_type[COMPACT_TYPES] = {NULL};
+	GByteArray *kinds = g_byte_array_new();
+	GByteArray *columns = g_byte_array_new();
+	struct compact_strings_s st = {
+		.index = g_hash_table_new(g_str_hash, g_str_equal),
+		.all = g_ptr_array_new(),
+	};
+
+	for (GSList *l = beans; l; l = l->next) {
+		if (!l->data)
+			continue;
+		gint t = _compact_type(l->data);
+		if (t < 0) {
+			GRID_WARN("Unexpected bean type [%s], skipped",
+					_bean_get_typename(l->data));
+			continue;
+		}
+		if (!by_type[t])
+			by_type[t] = g_ptr_array_new();
+		g_ptr_array_add(by_type[t], l->data);
+		_put_u8(kinds, t);
+	}
+
+	for (guint t = 0; t < COMPACT_TYPES; t++) {
+		if (!by_type[t])
+			continue;
+		const struct bean_descriptor_s *descr = compact_types[t];
+		_put_u8(columns, t);
+		_put_varint(columns, by_type[t]->len);
+		_put_u8(columns, descr->count_fields);
+		for (guint f = 0; f < descr->count_fields; f++)
+			_put_u8(columns, descr->fields[f].type);
+		for (guint f = 0; f < descr->count_fields; f++)
+			_put_column(columns, &st, by_type[t], descr->fields + f);
+		g_ptr_array_free(by_type[t], TRUE);
+	}
+
+	GByteArray *out = g_byte_array_sized_new(
+			COMPACT_MAGIC_SIZE + 16 + kinds->len + columns->len);
+	g_byte_array_append(out, (guint8*)COMPACT_MAGIC, COMPACT_MAGIC_SIZE - 1);
+	_put_u8(out, COMPACT_VERSION);
+	_put_varint(out, st.all->len);
+	for (guint i = 0; i < st.all->len; i++) {
+		GString *s = st.all->pdata[i];
+		_put_varint(out, s->len);
+		g_byte_array_append(out, (guint8*)s->str, s->len);
+	}
+	_put_varint(out, kinds->len);
+	g_byte_array_append(out, kinds->data, kinds->len);
+	g_byte_array_append(out, columns->data, columns->len);
+
+	g_hash_table_destroy(st.index);
+	g_ptr_array_free(st.all, TRUE);
+	g_byte_array_free(kinds, TRUE);
+	g_byte_array_free(columns, TRUE);
+	return out;
+}
+
+/* Reader ------------------------------------------------------------------- */
+
+/* The strings are not copied out of the buffer, only their final copy into
+ * the beans is made. */
+struct compact_reader_s
+{
+	const guint8 *p;
+	const guint8 *end;
+	guint nb_strings;
+	const guint8 **str;
+	guint32 *str_len;
+};
+
+static gboolean
+_get_varint(struct compact_reader_s *r, guint64 *pv)
+{
+	guint64 v = 0;
+	for (guint shift = 0; shift < 64 && r->p < r->end; shift += 7) {
+		const guint8 b = *(r->p++);
+		v |= (guint64)(b & 0x7F) << shift;
+		if (!(b & 0x80)) {
+			*pv = v;
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+static gboolean
+_get_i64(struct compact_reader_s *r, gint64 *pv)
+{
+	guint64 u = 0;
+	if (!_get_varint(r, &u))
+		return FALSE;
+	*pv = (gint64)(u >> 1) ^ -(gint64)(u & 1);
+	return TRUE;
+}
+
+static gboolean
+_get_bytes(struct compact_reader_s *r, gsize len, const guint8 **pb)
+{
+	if ((gsize)(r->end - r->p) < len)
+		return FALSE;
+	*pb = r->p;
+	r->p += len;
+	return TRUE;
+}
+
+/* Read one value of the given type. When <bean> is NULL, the value is only
+ * skipped. */
+static gboolean
+_get_value(struct compact_reader_s *r, guint8 type, gpointer bean,
+		const struct field_descriptor_s *fd)
+{
+	gpointer pf = bean ? FIELD(bean, fd->position) : NULL;
+	const guint8 *b = NULL;
+	guint64 u = 0;
+	gint64 i = 0;
+
+	switch (type) {
+		case FT_BOOL:
+			if (!_get_bytes(r, 1, &b))
+				return FALSE;
+			if (pf)
+				*((gboolean*)pf) = (*b != 0);
+			break;
+		case FT_INT:
+			if (!_get_i64(r, &i))
+				return FALSE;
+			if (pf)
+				*((gint64*)pf) = i;
+			break;
+		case FT_REAL:
+			if (!_get_bytes(r, 8, &b))
+				return FALSE;
+			if (pf) {
+				union { gdouble d; guint64 u; } real;
+				memcpy(&real.u, b, 8);
+				real.u = GUINT64_FROM_LE(real.u);
+				*((gdouble*)pf) = real.d;
+			}
+			break;
+		case FT_TEXT:
+			if (!_get_varint(r, &u) || u >= r->nb_strings)
+				return FALSE;
+			if (pf)
+				g_string_append_len(GSTR(pf),
+						(const gchar*)r->str[u], r->str_len[u]);
+			break;
+		case FT_BLOB:
+			if (!_get_varint(r, &u) || !_get_bytes(r, u, &b))
+				return FALSE;
+			if (pf)
+				g_byte_array_append(GBA(pf), b, u);
+			break;
+		default:
+			return FALSE;
+	}
+	if (bean)
+		_bean_set_field(bean, fd->position);
+	return TRUE;
+}
+
+static gboolean
+_get_columns(struct compact_reader_s *r, GPtrArray *beans,
+		const struct bean_descriptor_s *descr)
+{
+	const guint8 *types = NULL, *bitmap = NULL;
+	guint64 nb_fields = 0;
+
+	if (!_get_bytes(r, 1, &types))
+		return FALSE;
+	nb_fields = *types;
+	if (!_get_bytes(r, nb_fields, &types))
+		return FALSE;
+
+	for (guint f = 0; f < nb_fields; f++) {
+		/* A field unknown locally, or with another type, is skipped */
+		const struct field_descriptor_s *fd = NULL;
+		if (f < descr->count_fields && descr->fields[f].type == types[f])
+			fd = descr->fields + f;
+		if (!_get_bytes(r, (beans->len + 7) / 8, &bitmap))
+			return FALSE;
+		for (guint i = 0; i < beans->len; i++) {
+			if (!(bitmap[i / 8] & (1 << (i % 8))))
+				continue;
+			if (!_get_value(r, types[f], fd ? beans->pdata[i] : NULL, fd))
+				return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+gboolean
+bean_sequence_is_compact(const void *buf, gsize len)
+{
+	return buf && len >= COMPACT_MAGIC_SIZE
+		&& !memcmp(buf, COMPACT_MAGIC, COMPACT_MAGIC_SIZE - 1);
+}
+
+/* Only the DER trees are saved: each bean is still built, because the
+ * proxy merges, filters and sorts the beans of every reply before it
+ * renders them as JSON. */
+gint
+bean_sequence_decoder_compact(GSList **l, const void *buf, gsize len,
+		GError **err)
+{
+	struct compact_reader_s r = {
+		.p = (const guint8*)buf + COMPACT_MAGIC_SIZE,
+		.end = (const guint8*)buf + len,
+	};
+	GPtrArray *by_type[COMPACT_TYPES] = {NULL};
+	guint count[COMPACT_TYPES] = {0}, cursor[COMPACT_TYPES] = {0};
+	const guint8 *kinds = NULL;
+	guint64 nb = 0, nb_beans = 0;
+	GSList *beans = NULL;
+	gboolean ok = FALSE;
+
+	EXTRA_ASSERT(l != NULL);
+	if (!bean_sequence_is_compact(buf, len)) {
+		GSETERROR(err, "Not a compact sequence of beans");
+		return -1;
+	}
+	if (((const guint8*)buf)[COMPACT_MAGIC_SIZE - 1] != COMPACT_VERSION) {
+		GSETERROR(err, "Unsupported compact sequence version %u",
+				((const guint8*)buf)[COMPACT_MAGIC_SIZE - 1]);
+		return -1;
+	}
+
+	/* The string table points into the buffer */
+	if (!_get_varint(&r, &nb) || nb > len)
+		goto end;
+	r.nb_strings = nb;
+	r.str = g_malloc0(sizeof(guint8*) * (nb + 1));
+	r.str_len = g_malloc0(sizeof(guint32) * (nb + 1));
+	for (guint i = 0; i < r.nb_strings; i++) {
+		guint64 slen = 0;
+		if (!_get_varint(&r, &slen) || !_get_bytes(&r, slen, r.str + i))
+			goto end;
+		r.str_len[i] = slen;
+	}
+
+	if (!_get_varint(&r, &nb_beans) || !_get_bytes(&r, nb_beans, &kinds))
+		goto end;
+	for (guint i = 0; i < nb_beans; i++) {
+		if (kinds[i] >= COMPACT_TYPES)
+			goto end;
+		count[kinds[i]] ++;
+	}
+
+	while (r.p < r.end) {
+		const guint8 *t = NULL;
+		if (!_get_bytes(&r, 1, &t) || *t >= COMPACT_TYPES || by_type[*t])
+			goto end;
+		if (!_get_varint(&r, &nb) || nb != count[*t])
+			goto end;
+		by_type[*t] = g_ptr_array_new_full(nb, NULL);
+		for (guint i = 0; i < nb; i++)
+			g_ptr_array_add(by_type[*t], _bean_create(compact_types[*t]));
+		if (!_get_columns(&r, by_type[*t], compact_types[*t]))
+			goto end;
+	}
+	for (guint t = 0; t < COMPACT_TYPES; t++) {
+		if (count[t] && !by_type[t])
+			goto end;
+	}
+
+	/* Same order as bean_sequence_decoder(), i.e. reversed */
+	for (guint i = 0; i < nb_beans; i++) {
+		const guint8 t = kinds[i];
+		beans = g_slist_prepend(beans, by_type[t]->pdata[cursor[t]]);
+		by_type[t]->pdata[cursor[t]++] = NULL;
+	}
+	*l = beans;
+	ok = TRUE;
+
+end:
+	for (guint t = 0; t < COMPACT_TYPES; t++)
+		_bean_cleanv2(by_type[t]);
+	g_free(r.str);
+	g_free(r.str_len);
+	if (!ok) {
+		GSETERROR(err, "Invalid compact sequence of beans (offset %"
+				G_GSIZE_FORMAT")", (gsize)(r.p - (const guint8*)buf));
+		return -1;
+	}
+	return (gint)len;
+}
@@ -158,6 +158,8 @@ bean_sequence_decoder(GSList **l, const void *buf, gsize len, GError **err)
 		GRID_DEBUG("Invalid parameter, nothing to unmarshall");
 		return -1;
 	}
+	if (bean_sequence_is_compact(buf, len))
+		return bean_sequence_decoder_compact(l, buf, len, err);
 
 	codecCtx.max_stack_size = ASN1C_MAX_STACK;
 	decRet = ber_decode(&codecCtx, &asn_DEF_M2V2BeanSequence, &(result), buf, len);
@@ -57,11 +57,21 @@ _on_bean_ctx_send_list(struct on_bean_ctx_s *obc)
 {
 	if (NULL != obc->l) {
 		obc->l = g_slist_reverse (obc->l);
-		obc->reply->add_body(bean_sequence_marshall(obc->l));
+		/* Callers that know the compact encoding ask for it */
+		gchar format[16] = {0};
+		GError *err = metautils_message_extract_string(obc->reply->request,
+				NAME_MSGKEY_BEAN_FORMAT, FALSE, format, sizeof(format));
+		if (err)
+			g_clear_error(&err);
+		if (!strcmp(format, BEAN_FORMAT_COMPACT))
+			obc->reply->add_body(bean_sequence_marshall_compact(obc->l));
+		else
+			obc->reply->add_body(bean_sequence_marshall(obc->l));
 		_bean_cleanl2 (obc->l);
 		obc->l = NULL;
 	}
 
+	_bean_pool_report();
 	obc->reply->send_reply(CODE_FINAL_OK, "OK");
 }
 
@@ -97,6 +107,7 @@ meta2_filter_reply_fail(struct gridd_filter_ctx_s *ctx,
 	GError *e = NULL;
 
 	TRACE_FILTER();
+	_bean_pool_report();
 	e = meta2_filter_ctx_get_error(ctx);
 	if(NULL != e) {
 		GRID_DEBUG("Error defined by KO execution filter, return it");
@@ -116,6 +127,7 @@ meta2_filter_reply_success(struct gridd_filter_ctx_s *ctx,
 {
 	TRACE_FILTER();
 	(void) ctx;
+	_bean_pool_report();
 	reply->send_reply(CODE_FINAL_OK, "OK");
 	return FILTER_OK;
 }
@@ -34,6 +34,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <meta2v2/meta2_gridd_dispatcher.h>
 #include <meta2v2/meta2_filters.h>
 #include <meta2v2/meta2_filter_context.h>
+#include <meta2v2/meta2_variables.h>
+#include <meta2v2/generic.h>
 
 #define PTR(p) ((gpointer)(p))
 
@@ -59,6 +61,10 @@ meta2_dispatch_all(struct gridd_reply_ctx_s *reply,
 	oio_ext_set_user_agent(NULL);
 	oio_ext_allow_long_timeout(FALSE);
 
+	const gboolean pooled = meta2_flag_bean_pool;
+	if (pooled)
+		_bean_pool_begin();
+
 	ctx = meta2_filter_ctx_new();
 	meta2_filter_ctx_set_backend(ctx, (struct meta2_backend_s *) gdata);
 
@@ -87,6 +93,8 @@ meta2_dispatch_all(struct gridd_reply_ctx_s *reply,
 	}
 
 	meta2_filter_ctx_clean(ctx);
+	if (pooled)
+		_bean_pool_end();
 	oio_ext_set_admin(FALSE);
 	oio_ext_set_force_master(FALSE);
 	oio_ext_set_force_versioning(NULL);
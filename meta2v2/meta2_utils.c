@@ -1049,26 +1049,256 @@ _list_params_to_sql_clause(struct list_params_s *lp, GString *clause,
 	return (GVariant**) g_ptr_array_free (params, FALSE);
 }
 
+/* How many aliases of a listing get their headers, chunks and properties
+ * loaded by the same queries. It keeps the number of variables bound to
+ * a query under the SQLite default limit (999). */
+#define LIST_BATCH_SIZE 256
+
+struct list_pending_s
+{
+	struct bean_ALIASES_s *alias;
+	/* The alias stands for a sub-prefix, neither its content nor its
+	 * properties are needed. */
+	gboolean name_only;
+};
+
+struct list_content_s
+{
+	struct bean_CONTENTS_HEADERS_s *header;
+	GPtrArray *chunks;
+	/* How many aliases of the batch still have to receive the content.
+	 * All but the last one receive a copy. */
+	guint refs;
+};
+
 static void
-_load_fk_by_name(struct sqlx_sqlite3_s *sq3, struct bean_ALIASES_s *alias,
-		const gchar *fk_name, m2_onbean_cb cb, gpointer udata)
+_list_content_free(struct list_content_s *lc)
 {
-	EXTRA_ASSERT(sq3 != NULL);
-	EXTRA_ASSERT(alias != NULL);
-	EXTRA_ASSERT(fk_name != NULL);
-	EXTRA_ASSERT(cb != NULL);
+	if (lc->header)
+		_bean_clean(lc->header);
+	if (lc->chunks)
+		_bean_cleanv2(lc->chunks);
+	g_free(lc);
+}
+
+static gint
+_list_content_cmp(gconstpointer a, gconstpointer b, gpointer u UNUSED)
+{
+	return metautils_gba_cmp(a, b);
+}
+
+static void
+_append_clause_in(GString *clause, const gchar *column, guint count)
+{
+	g_string_append_printf(clause, " %s IN (", column);
+	for (guint i = 0; i < count; i++)
+		g_string_append(clause, i ? ",?" : "?");
+	g_string_append_c(clause, ')');
+}
+
+/* Load the contents (and their chunks if `deeper`) of all the aliases of
+ * the batch with two set-based queries instead of two per alias. */
+static GTree *
+_list_load_contents(struct sqlx_sqlite3_s *sq3, GArray *pending,
+		gboolean deeper)
+{
+	GTree *contents = g_tree_new_full(_list_content_cmp, NULL, NULL,
+			(GDestroyNotify)_list_content_free);
+	GPtrArray *params = g_ptr_array_new();
+	GPtrArray *beans = g_ptr_array_new();
+	GString *clause = g_string_sized_new(64 + 2 * pending->len);
+	GError *err = NULL;
+
+	for (guint i = 0; i < pending->len; i++) {
+		struct list_pending_s *lp = &g_array_index(pending,
+				struct list_pending_s, i);
+		if (!lp->name_only)
+			g_ptr_array_add(params,
+					_gba_to_gvariant(ALIASES_get_content(lp->alias)));
+	}
+	if (!params->len)
+		goto exit;
+	g_ptr_array_add(params, NULL);
+
+	_append_clause_in(clause, "id", params->len - 1);
+	err = CONTENTS_HEADERS_load(sq3, clause->str,
+			(GVariant**)params->pdata, _bean_buffer_cb, beans);
+	for (guint i = 0; i < beans->len; i++) {
+		struct list_content_s *lc = g_malloc0(sizeof(*lc));
+		lc->header = beans->pdata[i];
+		g_tree_replace(contents, CONTENTS_HEADERS_get_id(lc->header), lc);
+	}
+	g_ptr_array_set_size(beans, 0);
+
+	if (!err && deeper) {
+		g_string_set_size(clause, 0);
+		_append_clause_in(clause, "content", params->len - 1);
+		err = CHUNKS_load(sq3, clause->str,
+				(GVariant**)params->pdata, _bean_buffer_cb, beans);
+		for (guint i = 0; i < beans->len; i++) {
+			struct bean_CHUNKS_s *chunk = beans->pdata[i];
+			struct list_content_s *lc =
+				g_tree_lookup(contents, CHUNKS_get_content(chunk));
+			if (!lc) {
+				_bean_clean(chunk);
+				continue;
+			}
+			if (!lc->chunks)
+				lc->chunks = g_ptr_array_new();
+			g_ptr_array_add(lc->chunks, chunk);
+		}
+		g_ptr_array_set_size(beans, 0);
+	}
 
-	GPtrArray *t0 = g_ptr_array_new();
-	GError *err = _db_get_FK_by_name_buffered(alias, fk_name, sq3, t0);
 	if (err) {
-		GRID_WARN("Failed to load FK '%s' for alias [%s]: (%d) %s", fk_name,
-				ALIASES_get_alias(alias)->str, err->code, err->message);
+		GRID_WARN("Failed to load the contents of %u aliases: (%d) %s",
+				params->len - 1, err->code, err->message);
 		g_clear_error(&err);
-	} else {
-		for (guint i = 0; i < t0->len; i++)
-			cb(udata, t0->pdata[i]);
 	}
-	g_ptr_array_free(t0, TRUE);
+
+	for (guint i = 0; i < pending->len; i++) {
+		struct list_pending_s *lp = &g_array_index(pending,
+				struct list_pending_s, i);
+		struct list_content_s *lc = lp->name_only ? NULL
+			: g_tree_lookup(contents, ALIASES_get_content(lp->alias));
+		if (lc)
+			lc->refs ++;
+	}
+
+exit:
+	metautils_gvariant_unrefv((GVariant**)params->pdata);
+	g_ptr_array_free(params, TRUE);
+	g_ptr_array_free(beans, TRUE);
+	g_string_free(clause, TRUE);
+	return contents;
+}
+
+/* Load the properties of all the aliases of the batch at once. The query
+ * may return the properties of versions that are not listed, they are
+ * ignored when the results are stitched to the aliases. */
+static GTree *
+_list_load_properties(struct sqlx_sqlite3_s *sq3, GArray *pending)
+{
+	GTree *props = g_tree_new_full(metautils_strcmp3, NULL,
+			g_free, (GDestroyNotify)_bean_cleanv2);
+	GPtrArray *params = g_ptr_array_new();
+	GPtrArray *beans = g_ptr_array_new();
+	GString *clause = g_string_sized_new(64 + 4 * pending->len);
+	guint nb_names = 0;
+
+	for (guint i = 0; i < pending->len; i++) {
+		struct list_pending_s *lp = &g_array_index(pending,
+				struct list_pending_s, i);
+		if (lp->name_only)
+			continue;
+		g_ptr_array_add(params, g_variant_new_string(
+					ALIASES_get_alias(lp->alias)->str));
+		nb_names ++;
+	}
+	if (!nb_names)
+		goto exit;
+	for (guint i = 0; i < pending->len; i++) {
+		struct list_pending_s *lp = &g_array_index(pending,
+				struct list_pending_s, i);
+		if (!lp->name_only)
+			g_ptr_array_add(params, g_variant_new_int64(
+						ALIASES_get_version(lp->alias)));
+	}
+	g_ptr_array_add(params, NULL);
+
+	_append_clause_in(clause, "alias", nb_names);
+	g_string_append_static(clause, " AND");
+	_append_clause_in(clause, "version", nb_names);
+	GError *err = PROPERTIES_load(sq3, clause->str,
+			(GVariant**)params->pdata, _bean_buffer_cb, beans);
+	if (err) {
+		GRID_WARN("Failed to load the properties of %u aliases: (%d) %s",
+				nb_names, err->code, err->message);
+		g_clear_error(&err);
+	}
+	for (guint i = 0; i < beans->len; i++) {
+		struct bean_PROPERTIES_s *prop = beans->pdata[i];
+		const gchar *name = PROPERTIES_get_alias(prop)->str;
+		GPtrArray *v = g_tree_lookup(props, name);
+		if (!v) {
+			v = g_ptr_array_new();
+			g_tree_insert(props, g_strdup(name), v);
+		}
+		g_ptr_array_add(v, prop);
+	}
+
+exit:
+	metautils_gvariant_unrefv((GVariant**)params->pdata);
+	g_ptr_array_free(params, TRUE);
+	g_ptr_array_free(beans, TRUE);
+	g_string_free(clause, TRUE);
+	return props;
+}
+
+/* Send the aliases of the batch, each one preceded by its content header,
+ * chunks and properties as requested, in the same order as if they had
+ * been loaded alias by alias. */
+static void
+_list_send_batch(struct sqlx_sqlite3_s *sq3, struct list_params_s *lp,
+		GArray *pending, m2_onbean_cb cb, gpointer u)
+{
+	GTree *contents = NULL, *props = NULL;
+
+	if (!pending->len)
+		return;
+	if (lp->flag_headers)
+		contents = _list_load_contents(sq3, pending, lp->flag_recursion);
+	if (lp->flag_properties)
+		props = _list_load_properties(sq3, pending);
+
+	for (guint i = 0; i < pending->len; i++) {
+		struct list_pending_s *p = &g_array_index(pending,
+				struct list_pending_s, i);
+		struct bean_ALIASES_s *alias = p->alias;
+
+		if (!p->name_only && contents) {
+			GByteArray *id = ALIASES_get_content(alias);
+			struct list_content_s *lc = g_tree_lookup(contents, id);
+			if (lc && --lc->refs > 0) {
+				for (guint j = 0; lc->chunks && j < lc->chunks->len; j++)
+					cb(u, _bean_dup(lc->chunks->pdata[j]));
+				cb(u, _bean_dup(lc->header));
+			} else if (lc) {
+				/* The last alias gets the beans themselves. They leave the
+				 * tree first, as it is keyed by the ID of the header. */
+				struct bean_CONTENTS_HEADERS_s *header = lc->header;
+				GPtrArray *chunks = lc->chunks;
+				lc->header = NULL;
+				lc->chunks = NULL;
+				g_tree_remove(contents, id);
+				for (guint j = 0; chunks && j < chunks->len; j++)
+					cb(u, chunks->pdata[j]);
+				if (chunks)
+					g_ptr_array_free(chunks, TRUE);
+				cb(u, header);
+			}
+		}
+
+		if (!p->name_only && props) {
+			GPtrArray *v = g_tree_lookup(props, ALIASES_get_alias(alias)->str);
+			const gint64 version = ALIASES_get_version(alias);
+			for (guint j = 0; v && j < v->len; j++) {
+				struct bean_PROPERTIES_s *prop = v->pdata[j];
+				if (prop && PROPERTIES_get_version(prop) == version) {
+					cb(u, prop);
+					v->pdata[j] = NULL;
+				}
+			}
+		}
+
+		cb(u, alias);
+	}
+	g_array_set_size(pending, 0);
+
+	if (contents)
+		g_tree_destroy(contents);
+	if (props)
+		g_tree_destroy(props);
 }
 
 GError*
@@ -1087,6 +1317,8 @@ m2db_list_aliases(struct sqlx_sqlite3_s *sq3, struct list_params_s *lp0,
 	gboolean done = FALSE;
 	gboolean added = FALSE;
 	GPtrArray *cur_aliases = NULL;
+	GArray *pending = g_array_sized_new(FALSE, FALSE,
+			sizeof(struct list_pending_s), LIST_BATCH_SIZE);
 	guint prefix_len = 0;
 	guint delimiter_len = 0;
 
@@ -1113,15 +1345,15 @@ m2db_list_aliases(struct sqlx_sqlite3_s *sq3, struct list_params_s *lp0,
 			}
 			// The alias (name) is enough.
 			// Content and properties will not be used.
-		} else {
-			if (lp.flag_headers)
-				_manage_alias(sq3, alias, lp.flag_recursion, cb, u);
-			if (lp.flag_properties)
-				_load_fk_by_name(sq3, alias, "properties", cb, u);
 		}
 		g_free(last_added);
 		last_added = g_strdup(name);
-		cb(u, alias);
+		/* The content and the properties are loaded later, for a whole
+		 * batch of aliases at once. */
+		struct list_pending_s p = {alias, suffix != NULL};
+		g_array_append_val(pending, p);
+		if (pending->len >= LIST_BATCH_SIZE)
+			_list_send_batch(sq3, &lp, pending, cb, u);
 		count_aliases++;
 		return TRUE;
 	}
@@ -1273,10 +1505,13 @@ m2db_list_aliases(struct sqlx_sqlite3_s *sq3, struct list_params_s *lp0,
 			}
 		}
 
+		_list_send_batch(sq3, &lp, pending, cb, u);
 		cleanup();
 	}
 
 label_end:
+	_list_send_batch(sq3, &lp, pending, cb, u);
+	g_array_free(pending, TRUE);
 	cleanup();
 	g_free(last_alias_name);
 	g_free(last_alias_version);
@@ -395,29 +395,31 @@ _m2_generate_chunks(struct gen_ctx_s *ctx,
 
 	_m2_generate_alias_header(ctx);
 
-	guint pos = ctx->params->pos;
-	gint64 esize = MAX(ctx->params->size, 1);
-	for (gint64 s = 0; s < esize && !err; s += mcs, ++pos) {
-		int i = 0;
-		void _on_id(struct oio_lb_selected_item_s *sel, gpointer u UNUSED)
-		{
-			_gen_chunk(ctx, sel, ctx->params->chunk_size, pos, subpos? i : -1);
-			i++;
-		}
-		const char *pool = storage_policy_get_service_pool(ctx->params->pol);
-		// FIXME(FVE): set last argument
-
-		err = oio_lb__poll_pool_around(ctx->params->lb, pool,
-				ctx->params->pin, ctx->params->mode, _on_id, flawed);
+	const guint pos = ctx->params->pos;
+	const gint64 esize = MAX(ctx->params->size, 1);
+	const guint shots = (esize + mcs - 1) / mcs;
+	const char *pool = storage_policy_get_service_pool(ctx->params->pol);
+
+	/* Poll the services of all the metachunks at once */
+	GPtrArray *selection = NULL;
+	err = oio_lb__poll_pool_many(ctx->params->lb, pool, shots,
+			ctx->params->pin, ctx->params->mode, &selection, flawed);
+	if (err != NULL) {
+		g_prefix_error(&err, "from position %u: did not find enough "
+				"services matching the criteria for pool [%s]: ",
+				pos, pool);
+		return err;
+	}
 
-		if (err != NULL) {
-			g_prefix_error(&err, "at position %u: did not find enough "
-					"services matching the criteria for pool [%s]: ",
-					pos, pool);
-		}
+	/* Each metachunk got the same number of services */
+	const guint per_shot = selection->len / shots;
+	for (guint i = 0; i < selection->len; i++) {
+		_gen_chunk(ctx, selection->pdata[i], ctx->params->chunk_size,
+				pos + i / per_shot, subpos ? (gint)(i % per_shot) : -1);
 	}
+	g_ptr_array_free(selection, TRUE);
 
-	return err;
+	return NULL;
 }
 
 GError*
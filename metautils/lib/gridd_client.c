@@ -26,6 +26,7 @@ License along with this library.
 #include <strings.h>
 #include <errno.h>
 #include <sys/types.h>
+#include <sys/socket.h>
 
 #include "metautils.h"
 
@@ -61,6 +62,7 @@ struct gridd_client_s
 
 	gint64 tv_connect; /* timestamp of the last connection */
 	gint64 tv_start; /* timestamp of the last startup */
+	gint64 tv_established; /* when the current connection was established */
 
 	gint64 delay_connect; /* max delay for a connection to be established */
 	gint64 delay_single; /* max delay for a single request, without redirection */
@@ -80,6 +82,8 @@ struct gridd_client_s
 	guint8 keepalive : 1;
 	guint8 forbid_redirect : 1;
 	guint8 avoidance_onoff : 1;
+	guint8 cnx_reused : 1;
+	guint8 idempotent : 1;
 
 	gchar orig_url[URL_MAXLEN];
 	gchar url[URL_MAXLEN];
@@ -93,6 +97,17 @@ static GTree *tree_errors = NULL;  /* <gchar*> -> <rrd*> */
 static GRWLock lock_down;
 static GTree *tree_down = NULL;  /* <gchar*> -> <constant> */
 
+struct cnx_pooled_s
+{
+	int fd;
+	gint64 tv_established;
+	gint64 tv_released;
+};
+
+static GMutex lock_cnx;
+static GHashTable *pool_cnx = NULL;  /* <gchar*> -> <GQueue<cnx_pooled_s*>> */
+static struct gridd_client_cnx_pool_stats_s stats_cnx = {0};
+
 void  _oio_cache_of_errors_constructor (void);
 
 void __attribute__ ((constructor))
@@ -106,6 +121,9 @@ _oio_cache_of_errors_constructor (void)
 					g_free, (GDestroyNotify) grid_single_rrd_destroy);
 			g_rw_lock_init(&lock_down);
 			tree_down = g_tree_new_full(metautils_strcmp3, NULL, g_free, NULL);
+			g_mutex_init(&lock_cnx);
+			pool_cnx = g_hash_table_new_full(g_str_hash, g_str_equal,
+					g_free, NULL);
 		}
 	}
 }
@@ -165,6 +183,150 @@ _count_network_error (const char *url, const GError *err)
 	g_mutex_unlock(&lock_errors);
 }
 
+/* Pool of established connections ----------------------------------------- */
+
+static void
+_cnx_pooled_close(struct cnx_pooled_s *cnx)
+{
+	metautils_pclose(&(cnx->fd));
+	g_free(cnx);
+}
+
+/* An idle connection must have nothing to read: EOF means the peer closed
+ * it, and pending data would desynchronize the next reply. */
+static gboolean
+_cnx_is_healthy(int fd)
+{
+	guint8 b = 0;
+	ssize_t r = recv(fd, &b, 1, MSG_PEEK|MSG_DONTWAIT);
+	return r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+}
+
+static gboolean
+_cnx_is_expired(struct cnx_pooled_s *cnx, gint64 now)
+{
+	return cnx->tv_released < OLDEST(now, oio_client_cnx_pool_max_idle)
+		|| cnx->tv_established < OLDEST(now, oio_client_cnx_pool_max_age);
+}
+
+/* Must be called with lock_cnx held */
+static void
+_cnx_pool_close_queue(GQueue *q)
+{
+	struct cnx_pooled_s *cnx;
+	while ((cnx = g_queue_pop_head(q))) {
+		_cnx_pooled_close(cnx);
+		stats_cnx.evictions ++;
+		stats_cnx.idle --;
+	}
+}
+
+/* Pops the most recently released healthy connection toward `url`, and
+ * closes the stale ones met on the way. */
+static int
+_cnx_pool_acquire(const char *url, gint64 *established)
+{
+	const gint64 now = oio_ext_monotonic_time();
+	int fd = -1;
+
+	g_mutex_lock(&lock_cnx);
+	GQueue *q = g_hash_table_lookup(pool_cnx, url);
+	struct cnx_pooled_s *cnx;
+	while (fd < 0 && q && (cnx = g_queue_pop_head(q))) {
+		stats_cnx.idle --;
+		if (_cnx_is_expired(cnx, now) || !_cnx_is_healthy(cnx->fd)) {
+			_cnx_pooled_close(cnx);
+			stats_cnx.evictions ++;
+		} else {
+			fd = cnx->fd;
+			*established = cnx->tv_established;
+			g_free(cnx);
+		}
+	}
+	if (fd >= 0)
+		stats_cnx.hits ++;
+	else
+		stats_cnx.misses ++;
+	g_mutex_unlock(&lock_cnx);
+
+	return fd;
+}
+
+static void
+_cnx_pool_release(const char *url, int fd, gint64 established)
+{
+	const gint64 now = oio_ext_monotonic_time();
+	struct cnx_pooled_s *cnx = g_malloc0(sizeof(*cnx));
+	cnx->fd = fd;
+	cnx->tv_established = established;
+	cnx->tv_released = now;
+
+	g_mutex_lock(&lock_cnx);
+	GQueue *q = g_hash_table_lookup(pool_cnx, url);
+	if (!q) {
+		q = g_queue_new();
+		g_hash_table_insert(pool_cnx, g_strdup(url), q);
+	}
+	g_queue_push_head(q, cnx);
+	stats_cnx.idle ++;
+	while (g_queue_get_length(q) > oio_client_cnx_pool_max_per_peer) {
+		_cnx_pooled_close(g_queue_pop_tail(q));
+		stats_cnx.evictions ++;
+		stats_cnx.idle --;
+	}
+	g_mutex_unlock(&lock_cnx);
+}
+
+/* Close all the idle connections toward `url`, e.g. after a network error */
+static void
+_cnx_pool_forget(const char *url)
+{
+	g_mutex_lock(&lock_cnx);
+	GQueue *q = g_hash_table_lookup(pool_cnx, url);
+	if (q)
+		_cnx_pool_close_queue(q);
+	g_mutex_unlock(&lock_cnx);
+}
+
+void
+gridd_client_cnx_pool_purge(gboolean all)
+{
+	const gint64 now = oio_ext_monotonic_time();
+
+	g_mutex_lock(&lock_cnx);
+	GHashTableIter iter;
+	gpointer k, v;
+	g_hash_table_iter_init(&iter, pool_cnx);
+	while (g_hash_table_iter_next(&iter, &k, &v)) {
+		GQueue *q = v;
+		if (all || gridd_client_is_down_host(k)) {
+			_cnx_pool_close_queue(q);
+		} else {
+			/* The oldest releases are at the tail */
+			struct cnx_pooled_s *cnx;
+			while ((cnx = g_queue_peek_tail(q)) && _cnx_is_expired(cnx, now)) {
+				_cnx_pooled_close(g_queue_pop_tail(q));
+				stats_cnx.evictions ++;
+				stats_cnx.idle --;
+			}
+		}
+		if (g_queue_is_empty(q)) {
+			g_queue_free(q);
+			g_hash_table_iter_remove(&iter);
+		}
+	}
+	g_mutex_unlock(&lock_cnx);
+}
+
+void
+gridd_client_cnx_pool_stats(struct gridd_client_cnx_pool_stats_s *out)
+{
+	EXTRA_ASSERT(out != NULL);
+	g_mutex_lock(&lock_cnx);
+	memcpy(out, &stats_cnx, sizeof(*out));
+	g_mutex_unlock(&lock_cnx);
+}
+
 /* ------------------------------------------------------------------------- */
 
 static void
@@ -181,10 +343,11 @@ _client_reset_reply(struct gridd_client_s *client)
  * alongside with the initiation sequence.
  */
 static GError*
-_client_connect(struct gridd_client_s *client)
+_client_connect_fresh(struct gridd_client_s *client)
 {
 	GError *err = NULL;
 	gsize sent = client->request ? client->request->len : 0;
+	client->cnx_reused = 0;
 	client->fd = sock_connect_and_send(client->url, &err,
 			sent ? client->request->data : NULL, &sent);
 	if (client->fd < 0) {
@@ -194,7 +357,7 @@ _client_connect(struct gridd_client_s *client)
 	}
 
 	EXTRA_ASSERT(err == NULL);
-	client->tv_connect = oio_ext_monotonic_time ();
+	client->tv_connect = client->tv_established = oio_ext_monotonic_time ();
 	client->sent_bytes = sent;
 	if (client->sent_bytes >= client->request->len) {
 		_client_reset_reply(client);
@@ -206,6 +369,69 @@ _client_connect(struct gridd_client_s *client)
 	return NULL;
 }
 
+static GError*
+_client_connect(struct gridd_client_s *client)
+{
+	if (oio_client_cnx_pool_enabled && client->request) {
+		gint64 established = 0;
+		int fd = _cnx_pool_acquire(client->url, &established);
+		if (fd >= 0) {
+			client->fd = fd;
+			client->cnx_reused = 1;
+			client->tv_connect = oio_ext_monotonic_time ();
+			client->tv_established = established;
+			client->sent_bytes = 0;
+			client->step = REQ_SENDING;
+			return NULL;
+		}
+	}
+	return _client_connect_fresh(client);
+}
+
+/* Called once a reply has been entirely read: the connection is clean and
+ * may serve another request, so it is given to the pool instead of being
+ * closed. */
+static void
+_client_release_cnx(struct gridd_client_s *client)
+{
+	if (client->fd < 0)
+		return;
+
+	const gint64 now = oio_ext_monotonic_time();
+	if (!oio_client_cnx_pool_enabled
+			|| !oio_client_cnx_pool_max_per_peer
+			|| client->tv_established < OLDEST(now, oio_client_cnx_pool_max_age)
+			|| gridd_client_is_down_host(client->url)) {
+		metautils_pclose(&(client->fd));
+		return;
+	}
+
+	_cnx_pool_release(client->url, client->fd, client->tv_established);
+	client->fd = -1;
+}
+
+/* A pooled connection may have been closed by the peer while it was idle.
+ * The request is sent again on a new connection if the peer cannot have
+ * received it, i.e. nothing has been written yet. Once written, the peer may
+ * have executed the request before closing, so it is sent again only if the
+ * caller told it is idempotent, and as long as nothing has been received. */
+static gboolean
+_client_should_reconnect(struct gridd_client_s *client, GError *err)
+{
+	if (!client->cnx_reused || !client->request)
+		return FALSE;
+	if (err->code != CODE_NETWORK_ERROR)
+		return FALSE;
+	if (client->step == REQ_SENDING && client->sent_bytes == 0)
+		return TRUE;
+	if (!client->idempotent)
+		return FALSE;
+	if (client->step == REQ_SENDING)
+		return TRUE;
+	return client->step == REP_READING_SIZE
+		&& (!client->reply || client->reply->len == 0);
+}
+
 static void
 _client_reset_request(struct gridd_client_s *client)
 {
@@ -216,6 +442,7 @@ _client_reset_request(struct gridd_client_s *client)
 	client->on_reply = NULL;
 	client->sent_bytes = 0;
 	client->nb_redirects = 0;
+	client->idempotent = 0;
 }
 
 static void
@@ -289,7 +516,7 @@ _client_manage_reply(struct gridd_client_s *client, MESSAGE reply)
 		client->step = (status==CODE_FINAL_OK) ? STATUS_OK : REP_READING_SIZE;
 		if (client->step == STATUS_OK) {
 			if (!client->keepalive)
-				metautils_pclose(&(client->fd));
+				_client_release_cnx(client);
 		} else {
 			_client_reset_reply(client);
 		}
@@ -318,6 +545,7 @@ _client_manage_reply(struct gridd_client_s *client, MESSAGE reply)
 	if (status == CODE_REDIRECT && !client->forbid_redirect) {
 		/* Reset the context */
 		_client_reset_reply(client);
+		_client_release_cnx(client);
 		_client_reset_cnx(client);
 		client->sent_bytes = 0;
 
@@ -349,8 +577,10 @@ _client_manage_reply(struct gridd_client_s *client, MESSAGE reply)
 		return err;
 	}
 
-	if (!client->keepalive)
+	if (!client->keepalive) {
+		_client_release_cnx(client);
 		_client_reset_cnx(client);
+	}
 	_client_reset_reply(client);
 
 	if (status == CODE_REDIRECT_SHARD && client->on_reply) {
@@ -549,6 +779,18 @@ retry:
 				&& client->reply->len >= 4)
 				goto retry;
 	} else {
+		if (_client_should_reconnect(client, err)) {
+			GRID_DEBUG("Pooled connection to %s lost, reconnecting: (%d) %s",
+					client->url, err->code, err->message);
+			g_clear_error(&err);
+			_client_reset_cnx(client);
+			_client_reset_reply(client);
+			_cnx_pool_forget(client->url);
+			if (!(err = _client_connect_fresh(client)))
+				return;
+		}
+		if (CODE_IS_NETWORK_ERROR(err->code))
+			_cnx_pool_forget(client->url);
 		_client_reset_request(client);
 		_client_reset_reply(client);
 		_client_reset_cnx(client);
@@ -1015,3 +1257,10 @@ gridd_client_set_avoidance (struct gridd_client_s *c, gboolean onoff)
 	c->avoidance_onoff = BOOL(onoff);
 }
 
+void
+gridd_client_set_idempotent (struct gridd_client_s *c, gboolean onoff)
+{
+	if (unlikely(!c)) return;
+	c->idempotent = BOOL(onoff);
+}
+
@@ -95,6 +95,30 @@ void gridd_client_no_redirect (struct gridd_client_s *c);
 /* Only works with clients of the default type */
 void gridd_client_set_avoidance (struct gridd_client_s *c, gboolean on);
 
+/* Tell the request may be executed twice without harm, so that it is sent
+ * again if a pooled connection breaks after it has been written (until a
+ * byte of the reply is received). To be called after gridd_client_request().
+ * Only works with clients of the default type */
+void gridd_client_set_idempotent (struct gridd_client_s *c, gboolean on);
+
+/* ------------------------------------------------------------------------- */
+
+/* Counters of the process-wide pool of connections to 'meta' services */
+struct gridd_client_cnx_pool_stats_s
+{
+	guint64 hits;       /* connections reused from the pool */
+	guint64 misses;     /* connections that had to be established */
+	guint64 evictions;  /* pooled connections closed before any reuse */
+	guint64 idle;       /* connections currently waiting in the pool */
+};
+
+/* Copy the current counters of the pool of connections into `out` */
+void gridd_client_cnx_pool_stats(struct gridd_client_cnx_pool_stats_s *out);
+
+/* Close the pooled connections that have been idle for too long, that are
+ * too old, or whose peer is marked down. If `all` is set, close them all. */
+void gridd_client_cnx_pool_purge(gboolean all);
+
 /* ------------------------------------------------------------------------- */
 
 typedef GTree* down_hosts_t;
@@ -241,6 +241,12 @@ retry:
 
 GError *
 gridd_clients_step(struct gridd_client_s **clients)
+{
+	return gridd_clients_step_timeout(clients, 100);
+}
+
+GError *
+gridd_clients_step_timeout(struct gridd_client_s **clients, int ms)
 {
 	struct gridd_client_s ** _lookup_client(int fd, struct gridd_client_s **ppc) {
 		struct gridd_client_s *c;
@@ -271,7 +277,7 @@ gridd_clients_step(struct gridd_client_s **clients)
 
 retry:
 	/* Wait for an event to happen */
-	rc = metautils_syscall_poll (pfd, j, 100);
+	rc = metautils_syscall_poll (pfd, j, ms);
 	if (rc == 0) {
 		_clients_expire(clients, oio_ext_monotonic_time ());
 		return NULL;
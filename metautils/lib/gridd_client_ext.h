@@ -86,6 +86,9 @@ void gridd_clients_start(struct gridd_client_s **clients);
 // if a non-error event occured.
 GError * gridd_clients_step(struct gridd_client_s **clients);
 
+// Same as gridd_clients_step(), but waits at most `ms` milliseconds.
+GError * gridd_clients_step_timeout(struct gridd_client_s **clients, int ms);
+
 // Wraps gridd_clients_step() and gridd_clients_finished()
 GError * gridd_clients_loop(struct gridd_client_s **clients);
 
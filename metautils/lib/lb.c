@@ -102,6 +102,17 @@ oio_lb_world__feed_service_info_list(struct oio_lb_world_s *lbw,
 	g_hash_table_destroy(slots);
 }
 
+void
+oio_lb_world__remove_service_info_list(struct oio_lb_world_s *lbw,
+		GSList *services)
+{
+	for (GSList *l = services; l; l = l->next) {
+		gchar *key = service_info_key(l->data);
+		oio_lb_world__remove_item(lbw, key);
+		g_free(key);
+	}
+}
+
 void
 oio_lb_world__feed_from_string(struct oio_lb_world_s *self,
 		const gchar *main_slot, const gchar *file_contents)
@@ -400,3 +411,139 @@ oio_lb_world__check_repartition(struct oio_lb_world_s *world,
 	if (under_selected)
 		GRID_WARN("%d/%d services under selected", under_selected, services);
 }
+
+/* -- Incremental reloads -------------------------------------------------- */
+
+void
+service_delta_clean(struct service_delta_s *delta)
+{
+	if (!delta)
+		return;
+	oio_str_clean(&delta->epoch);
+	g_slist_free_full(delta->changed, (GDestroyNotify)service_info_clean);
+	delta->changed = NULL;
+	g_strfreev(delta->removed);
+	delta->removed = NULL;
+	delta->generation = 0;
+	delta->complete = FALSE;
+}
+
+struct service_sync_s *
+service_sync_create(void)
+{
+	struct service_sync_s *sync = g_malloc0(sizeof(struct service_sync_s));
+	sync->services = g_hash_table_new_full(g_str_hash, g_str_equal,
+			g_free, (GDestroyNotify)service_info_clean);
+	return sync;
+}
+
+void
+service_sync_destroy(struct service_sync_s *sync)
+{
+	if (!sync)
+		return;
+	oio_str_clean(&sync->epoch);
+	g_hash_table_destroy(sync->services);
+	g_free(sync);
+}
+
+void
+service_sync_reset(struct service_sync_s *sync)
+{
+	EXTRA_ASSERT(sync != NULL);
+	oio_str_clean(&sync->epoch);
+	sync->generation = 0;
+	g_hash_table_remove_all(sync->services);
+}
+
+/* Tell if the LB item built from the new version of a service would not
+ * replace the item built from the old one, in the same slots. */
+static gboolean
+_service_moved(const struct service_info_s *old, const struct service_info_s *si)
+{
+	if (g_strcmp0(service_info_get_tag_value(old, NAME_TAGNAME_SLOTS, NULL),
+			service_info_get_tag_value(si, NAME_TAGNAME_SLOTS, NULL)))
+		return TRUE;
+	gchar *k0 = service_info_key(old), *k1 = service_info_key(si);
+	gboolean moved = strcmp(k0, k1) != 0;
+	g_free(k0);
+	g_free(k1);
+	return moved;
+}
+
+void
+service_sync_apply(struct service_sync_s *sync, struct service_delta_s *delta,
+		GSList **out_changed, GSList **out_gone)
+{
+	EXTRA_ASSERT(sync != NULL);
+	EXTRA_ASSERT(delta != NULL);
+	EXTRA_ASSERT(out_changed != NULL);
+	EXTRA_ASSERT(out_gone != NULL);
+	gchar addr[STRLEN_ADDRINFO];
+
+	GHashTable *previous = NULL;
+	if (delta->complete) {
+		previous = sync->services;
+		sync->services = g_hash_table_new_full(g_str_hash, g_str_equal,
+				g_free, (GDestroyNotify)service_info_clean);
+	} else {
+		/* The removals happened before the changes of the same delta, a
+		 * service removed then registered again is in both. */
+		for (gchar **p = delta->removed; p && *p; p++) {
+			gpointer k = NULL, v = NULL;
+			if (g_hash_table_lookup_extended(sync->services, *p, &k, &v)) {
+				g_hash_table_steal(sync->services, *p);
+				*out_gone = g_slist_prepend(*out_gone, v);
+				g_free(k);
+			}
+		}
+	}
+
+	for (GSList *l = delta->changed; l; l = l->next) {
+		struct service_info_s *si = l->data;
+		grid_addrinfo_to_string(&si->addr, addr, sizeof(addr));
+		GHashTable *origin = previous ? previous : sync->services;
+		gpointer k = NULL, v = NULL;
+		if (g_hash_table_lookup_extended(origin, addr, &k, &v)) {
+			g_hash_table_steal(origin, addr);
+			g_free(k);
+			if (_service_moved(v, si))
+				*out_gone = g_slist_prepend(*out_gone, v);
+			else
+				service_info_clean(v);
+		}
+		g_hash_table_replace(sync->services, g_strdup(addr), si);
+	}
+	*out_changed = delta->changed;
+	delta->changed = NULL;
+
+	if (previous) {
+		/* What remains was absent from the complete list */
+		GHashTableIter iter;
+		gpointer k = NULL, v = NULL;
+		g_hash_table_iter_init(&iter, previous);
+		while (g_hash_table_iter_next(&iter, &k, &v)) {
+			g_hash_table_iter_steal(&iter);
+			*out_gone = g_slist_prepend(*out_gone, v);
+			g_free(k);
+		}
+		g_hash_table_destroy(previous);
+	}
+
+	oio_str_reuse(&sync->epoch, delta->epoch);
+	delta->epoch = NULL;
+	sync->generation = delta->generation;
+}
+
+GSList *
+service_sync_list(struct service_sync_s *sync)
+{
+	EXTRA_ASSERT(sync != NULL);
+	GSList *out = NULL;
+	GHashTableIter iter;
+	gpointer v = NULL;
+	g_hash_table_iter_init(&iter, sync->services);
+	while (g_hash_table_iter_next(&iter, NULL, &v))
+		out = g_slist_prepend(out, v);
+	return out;
+}
@@ -30,6 +30,10 @@ struct namespace_info_s;
 void oio_lb_world__feed_service_info_list(struct oio_lb_world_s *lbw,
 		GSList *services);
 
+/** Remove a list of services from all the slots of a LB world */
+void oio_lb_world__remove_service_info_list(struct oio_lb_world_s *lbw,
+		GSList *services);
+
 /** Insert or update a list of services in a LB world.
  * Each line of the string should contain a service ID (or address),
  * and optionally (space separated):
@@ -76,4 +80,43 @@ struct oio_lb_pool_s *oio_lb_pool__from_service_policy(
 void oio_lb_pool__poll_many(struct oio_lb_pool_s *pool, int iterations,
 		GHashTable *services, int *unbalanced_situations);
 
+/* -- Incremental reloads -------------------------------------------------- */
+
+/** What the conscience replied about the services of a type: all of them,
+ * or only the changes since the generation asked. */
+struct service_delta_s {
+	gchar *epoch;       /* identifies the conscience instance */
+	gint64 generation;  /* to be asked in the next request */
+	gboolean complete;  /* the services not in <changed> are gone */
+	GSList *changed;    /* <struct service_info_s*> */
+	gchar **removed;    /* addresses of the services removed */
+};
+
+void service_delta_clean(struct service_delta_s *delta);
+
+/** The services of a type, as last synchronized with the conscience. */
+struct service_sync_s {
+	gchar *epoch;
+	gint64 generation;  /* 0 until a first list has been applied */
+	GHashTable *services;  /* <gchar* addr, struct service_info_s*> */
+};
+
+struct service_sync_s * service_sync_create(void);
+
+void service_sync_destroy(struct service_sync_s *sync);
+
+/** Forget all the services, the next request will ask a complete list. */
+void service_sync_reset(struct service_sync_s *sync);
+
+/** Apply the delta, whose changed services are stolen by <sync> and listed
+ * in <out_changed> (free the list only). The services that must leave the
+ * slots of the LB worlds (removed, or moved to other slots) are prepended
+ * to <out_gone>, the caller frees them. */
+void service_sync_apply(struct service_sync_s *sync,
+		struct service_delta_s *delta, GSList **out_changed,
+		GSList **out_gone);
+
+/** List the services known, still owned by <sync>. */
+GSList * service_sync_list(struct service_sync_s *sync);
+
 #endif /*OIO_SDS__metautils__lib__lb_h*/
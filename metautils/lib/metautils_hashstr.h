@@ -52,6 +52,13 @@ gint hashstr_quick_cmp(const hashstr_t *hs1, const hashstr_t *hs2);
  * containers. */
 gint hashstr_quick_cmpdata(gconstpointer p1, gconstpointer p2, gpointer u);
 
+/** Returns the precomputed hash, useful with GHashTable */
+guint hashstr_quick_hash(gconstpointer p);
+
+/** Compares the hash and the length before the content, useful with
+ * GHashTable */
+gboolean hashstr_quick_equal(gconstpointer p1, gconstpointer p2);
+
 #define HASHSTR_PREFIX offsetof(struct hashstr_s, s0)
 
 #define HASHSTR_ALLOCA(R,S) do { \
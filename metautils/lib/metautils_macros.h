@@ -52,20 +52,25 @@ License along with this library.
 #define NAME_MSGKEY_BASENAME           "BNAME"
 #define NAME_MSGKEY_BASETYPE           "BTYPE"
 #define NAME_MSGKEY_BASESUFFIX         "BSUFFIX"
+#define NAME_MSGKEY_BEAN_FORMAT        "BEAN_FORMAT"
 #define NAME_MSGKEY_BYPASS_GOVERNANCE  "BYPASS_GOVERNANCE"
 #define NAME_MSGKEY_CHANGE_POLICY      "CHANGE_POLICY"
 #define NAME_MSGKEY_CHECK_TYPE         "CHECK_TYPE"
 #define NAME_MSGKEY_CHUNKED            "CHUNKED"
+#define NAME_MSGKEY_COMPRESSION        "COMPRESSION"
 #define NAME_MSGKEY_CONTAINERID        "CID"
 #define NAME_MSGKEY_CONTENTLENGTH      "CL"
 #define NAME_MSGKEY_CONTENTPATH        "CP"
 #define NAME_MSGKEY_CONTENTID          "CI"
 #define NAME_MSGKEY_DELETE_MARKER      "DELETE_MARKER"
+#define NAME_MSGKEY_DELTA              "DELTA"
 #define NAME_MSGKEY_DELIMITER          "DELIMITER"
 #define NAME_MSGKEY_DRYRUN             "DRYRUN"
 #define NAME_MSGKEY_DST                "DST"
+#define NAME_MSGKEY_EPOCH              "EPOCH"
 #define NAME_MSGKEY_EVENT              "E"
 #define NAME_MSGKEY_EXTEND             "EXT"
+#define NAME_MSGKEY_EXTENT             "EXTENT"
 #define NAME_MSGKEY_EXTRA_COUNTERS     "X_COUNTERS"
 #define NAME_MSGKEY_FLAGS              "FLAGS"
 #define NAME_MSGKEY_FLUSH              "FLUSH"
@@ -74,6 +79,7 @@ License along with this library.
 #define NAME_MSGKEY_FORMAT             "FORMAT"
 #define NAME_MSGKEY_FROZEN             "FROZEN"
 #define NAME_MSGKEY_FULL               "FULL"
+#define NAME_MSGKEY_GENERATION         "GEN"
 #define NAME_MSGKEY_KEY                "K"
 #define NAME_MSGKEY_LIMIT              "LIMIT"
 #define NAME_MSGKEY_LOCAL              "LOCAL"
@@ -96,6 +102,7 @@ License along with this library.
 #define NAME_MSGKEY_PROPAGATE_SHARDS   "PROP_SHARDS"
 #define NAME_MSGKEY_QUERY              "Q"
 #define NAME_MSGKEY_RECOMPUTE          "RECOMPUTE"
+#define NAME_MSGKEY_REMOVED            "REMOVED"
 #define NAME_MSGKEY_REGION             "REGION"
 #define NAME_MSGKEY_REJOIN             "REJOIN"
 #define NAME_MSGKEY_REPLI_DESTS        "REPLI_DESTS"
@@ -109,6 +116,7 @@ License along with this library.
 #define NAME_MSGKEY_SKIP_DATA_MOVE     "SKIP_DATA_MOVE"
 #define NAME_MSGKEY_SLO_MANIFEST       "SLO_MANIFEST"
 #define NAME_MSGKEY_SIM_VER            "SIM_VER"
+#define NAME_MSGKEY_SINCE              "SINCE"
 #define NAME_MSGKEY_SPARE              "SPARE"
 #define NAME_MSGKEY_SRC                "SRC"
 #define NAME_MSGKEY_SRC_BASE           "SRC_BASE"
@@ -118,3 +118,18 @@ hashstr_quick_cmpdata(gconstpointer p1, gconstpointer p2, gpointer u)
 	(void) u;
 	return hashstr_quick_cmp(p1, p2);
 }
+
+guint
+hashstr_quick_hash(gconstpointer p)
+{
+	return ((const hashstr_t*)p)->hl.h;
+}
+
+gboolean
+hashstr_quick_equal(gconstpointer p1, gconstpointer p2)
+{
+	const hashstr_t *hs1 = p1, *hs2 = p2;
+	return hs1->hl.h == hs2->hl.h
+		&& hs1->hl.l == hs2->hl.l
+		&& !memcmp(hs1->s0, hs2->s0, hs1->hl.l);
+}
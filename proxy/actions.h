@@ -85,6 +85,9 @@ enum http_rc_e action_container_destroy (struct req_args_s *args);
 enum http_rc_e action_container_drain(struct req_args_s *args);
 enum http_rc_e action_container_show (struct req_args_s *args);
 enum http_rc_e action_container_list (struct req_args_s *args);
+/* Run by <list_prefetch_pool>, sends a listing request prefetched by
+ * action_container_list() */
+void list_prefetch_worker(gpointer data, gpointer udata);
 enum http_rc_e action_container_prop_get (struct req_args_s *args);
 enum http_rc_e action_container_prop_set (struct req_args_s *args);
 enum http_rc_e action_container_prop_del (struct req_args_s *args);
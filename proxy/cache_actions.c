@@ -62,6 +62,7 @@ action_cache_flush_local (struct req_args_s *args)
 {
 	oio_lb_world__flush(lb_world);
 	oio_lb_world__flush(lb_world_rawx);
+	lb_cache_forget();
 	hc_resolver_flush_csm0 (resolver);
 	hc_resolver_flush_services(resolver);
 	shard_resolver_flush(shard_resolver);
@@ -57,16 +57,14 @@ validate_srvtype(const char *srvtype)
 gboolean
 service_is_ok (gconstpointer k)
 {
-	gpointer v;
-	SRV_READ(v = lru_tree_get (srv_down, k));
-	return v == NULL;
+	return NULL == lru_hash_get(srv_down, k, NULL);
 }
 
 void
 service_invalidate (gconstpointer k)
 {
 	gchar *k0 = g_strdup((const char *)k);
-	SRV_WRITE(lru_tree_insert (srv_down, k0, GINT_TO_POINTER(1)));
+	lru_hash_insert(srv_down, k0, GINT_TO_POINTER(1));
 	if (GRID_DEBUG_ENABLED())
 		GRID_DEBUG("invalid at %lu %s", oio_ext_monotonic_seconds(), (const char*)k);
 }
@@ -74,20 +72,18 @@ service_invalidate (gconstpointer k)
 static gboolean
 service_is_slave (const char *obj, const char *master)
 {
-	gboolean rc;
-	MASTER_READ(
-		gchar *v = lru_tree_get(srv_master, obj);
-		rc = (v != NULL) && strcmp(v, master));
+	gchar *v = lru_hash_get(srv_master, obj, (GBoxedCopyFunc)g_strdup);
+	gboolean rc = (v != NULL) && strcmp(v, master);
+	g_free(v);
 	return rc;
 }
 
 static gboolean
 service_is_master (const char *obj, const char *master)
 {
-	gboolean rc;
-	MASTER_READ(
-		gchar *v = lru_tree_get(srv_master, obj);
-		rc = (v != NULL) && !strcmp(v, master));
+	gchar *v = lru_hash_get(srv_master, obj, (GBoxedCopyFunc)g_strdup);
+	gboolean rc = (v != NULL) && !strcmp(v, master);
+	g_free(v);
 	return rc;
 }
 
@@ -95,13 +91,13 @@ static void
 service_learn_master (const char *obj, const char *master)
 {
 	gchar *k = g_strdup (obj), *v = g_strdup (master);
-	MASTER_WRITE(lru_tree_insert(srv_master, k, v));
+	lru_hash_insert(srv_master, k, v);
 }
 
 static void
 service_forget_master(const char *obj)
 {
-	MASTER_WRITE(lru_tree_remove(srv_master, obj));
+	lru_hash_remove(srv_master, obj);
 }
 
 const char *
@@ -306,6 +302,462 @@ cache_flush_user(struct req_args_s *args, struct client_ctx_s *ctx)
 	g_free(k);
 }
 
+/* -------------------------------------------------------------------------- */
+
+/* Bucket i counts the durations in ]2^(i-1), 2^i] milliseconds, the last
+ * bucket counts everything above. */
+#define LATENCY_BUCKETS 16
+
+/* Below that number of samples, the quantiles are not reported */
+#define LATENCY_MIN_SAMPLES 64
+
+/* Past that number of samples, the recent counts are halved so that the
+ * quantiles follow the latest trend. */
+#define LATENCY_DECAY 8192
+
+struct latency_histogram_s
+{
+	const char *name;
+	GMutex lock;
+	guint64 recent[LATENCY_BUCKETS + 1];
+	guint64 nb_recent;
+	GQuark gq_bucket[LATENCY_BUCKETS + 1];
+	GQuark gq_count;
+	GQuark gq_time;
+};
+
+static struct latency_histogram_s latencies[PROXY_LATENCY_MAX] = {
+	[PROXY_LATENCY_PEER] = {.name = "peer"},
+	[PROXY_LATENCY_SERIAL] = {.name = "serial"},
+	[PROXY_LATENCY_HEDGED] = {.name = "hedged"},
+	[PROXY_LATENCY_FANOUT] = {.name = "fanout"},
+};
+
+void
+proxy_latency_init(void)
+{
+	gchar tmp[128];
+	for (guint i = 0; i < PROXY_LATENCY_MAX; i++) {
+		struct latency_histogram_s *h = latencies + i;
+		for (guint b = 0; b <= LATENCY_BUCKETS; b++) {
+			if (b < LATENCY_BUCKETS)
+				g_snprintf(tmp, sizeof(tmp), "counter sub.%s.lat_%ums",
+						h->name, 1u << b);
+			else
+				g_snprintf(tmp, sizeof(tmp), "counter sub.%s.lat_inf",
+						h->name);
+			h->gq_bucket[b] = g_quark_from_string(tmp);
+			oio_stats_set(h->gq_bucket[b], 0, 0, 0, 0, 0, 0, 0);
+		}
+		g_snprintf(tmp, sizeof(tmp), "counter sub.%s.count", h->name);
+		h->gq_count = g_quark_from_string(tmp);
+		g_snprintf(tmp, sizeof(tmp), "counter sub.%s.time", h->name);
+		h->gq_time = g_quark_from_string(tmp);
+		oio_stats_set(h->gq_count, 0, h->gq_time, 0, 0, 0, 0, 0);
+	}
+}
+
+void
+proxy_latency_record(enum proxy_latency_e which, gint64 duration)
+{
+	EXTRA_ASSERT(which < PROXY_LATENCY_MAX);
+	struct latency_histogram_s *h = latencies + which;
+
+	guint b = 0;
+	while (b < LATENCY_BUCKETS && (G_TIME_SPAN_MILLISECOND << b) < duration)
+		b++;
+
+	g_mutex_lock(&h->lock);
+	if (h->nb_recent >= LATENCY_DECAY) {
+		h->nb_recent = 0;
+		for (guint i = 0; i <= LATENCY_BUCKETS; i++)
+			h->nb_recent += (h->recent[i] /= 2);
+	}
+	h->recent[b] ++;
+	h->nb_recent ++;
+	g_mutex_unlock(&h->lock);
+
+	oio_stats_add(h->gq_bucket[b], 1, h->gq_count, 1,
+			h->gq_time, MAX(duration, 0), 0, 0);
+}
+
+gint64
+proxy_latency_quantile(enum proxy_latency_e which, gdouble q)
+{
+	EXTRA_ASSERT(which < PROXY_LATENCY_MAX);
+	struct latency_histogram_s *h = latencies + which;
+	gint64 result = -1;
+
+	g_mutex_lock(&h->lock);
+	if (h->nb_recent >= LATENCY_MIN_SAMPLES) {
+		const guint64 threshold = q * h->nb_recent;
+		guint64 total = 0;
+		for (guint b = 0; b <= LATENCY_BUCKETS; b++) {
+			total += h->recent[b];
+			if (total >= threshold) {
+				result = G_TIME_SPAN_MILLISECOND << b;
+				break;
+			}
+		}
+	}
+	g_mutex_unlock(&h->lock);
+	return result;
+}
+
+void
+proxy_latency_dump(GString *out)
+{
+	static const guint quantiles[] = {50, 95, 99};
+	for (guint i = 0; i < PROXY_LATENCY_MAX; i++) {
+		for (guint j = 0; j < G_N_ELEMENTS(quantiles); j++) {
+			gint64 v = proxy_latency_quantile(i, quantiles[j] / 100.0);
+			if (v >= 0)
+				g_string_append_printf(out,
+						"gauge sub.%s.p%u %"G_GINT64_FORMAT"\n",
+						latencies[i].name, quantiles[j], v);
+		}
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* What the hedged and the parallel modes need to start a request to a peer */
+struct replicated_run_s
+{
+	struct client_ctx_s *ctx;
+	request_packer_f *pack;
+	const struct sqlx_name_s *name;
+	const gchar **headers;
+	const char *election_key;
+	gint64 deadline;
+	gboolean bypass_down;
+
+	/* output, one item per peer that answered (or failed) */
+	GPtrArray *urlv, *errorv, *bodyv, *urlerrorv;
+};
+
+struct replicated_attempt_s
+{
+	const char *url;
+	struct gridd_client_s *client;
+	GByteArray *body;
+	GError *err;
+	gint64 start;
+	gint64 end;
+};
+
+static void
+_attempt_start(struct replicated_run_s *run, struct replicated_attempt_s *a,
+		const char *url)
+{
+	struct client_ctx_s *ctx = run->ctx;
+
+	a->url = url;
+	a->start = oio_ext_monotonic_time();
+	a->client = gridd_client_create_empty();
+	if ((a->err = gridd_client_connect_url(a->client, url))) {
+		GRID_WARN("Invalid peer [%s] (reqid=%s)", url, oio_ext_get_reqid());
+		a->err->code = ERRCODE_CONN_NOROUTE;
+	} else {
+		GByteArray *packed = run->pack(run->name, run->headers);
+		a->err = gridd_client_request(a->client, packed, &a->body, _on_reply);
+		g_byte_array_unref(packed);
+	}
+	if (a->err)
+		return;
+
+	if (ctx->which == CLIENT_RUN_ALL || ctx->which == CLIENT_SPECIFIED)
+		gridd_client_no_redirect(a->client);
+	gridd_client_set_timeout(a->client,
+			oio_clamp_timeout(proxy_timeout_common, run->deadline));
+	if (run->bypass_down)
+		gridd_client_set_avoidance(a->client, FALSE);
+	/* A request a SLAVE may serve is a read */
+	if (ctx->which == CLIENT_PREFER_SLAVE)
+		gridd_client_set_idempotent(a->client, TRUE);
+	gridd_client_start(a->client);
+}
+
+/* Tells if the attempt just finished, and then collects its outcome */
+static gboolean
+_attempt_check(struct replicated_attempt_s *a, gint64 now)
+{
+	if (a->end > 0)
+		return FALSE;
+	if (!a->err) {
+		if (!gridd_client_finished(a->client))
+			return FALSE;
+		a->err = gridd_client_error(a->client);
+	}
+	a->end = now;
+	if (!a->err)
+		proxy_latency_record(PROXY_LATENCY_PEER, a->end - a->start);
+	return TRUE;
+}
+
+/* Ensure an output for that attempt: each array (url, body, error) must
+ * contain the corresponding item. */
+static void
+_attempt_push(struct replicated_run_s *run, struct replicated_attempt_s *a)
+{
+	if (a->err) {
+		GRID_DEBUG("ERROR %s -> (%d) %s", a->url, a->err->code, a->err->message);
+		g_ptr_array_add(run->errorv, g_error_copy(a->err));
+		g_ptr_array_add(run->urlerrorv, g_strdup(a->url));
+		if (!a->body)
+			a->body = g_byte_array_new();
+		else
+			g_byte_array_set_size(a->body, 0);
+	} else {
+		g_ptr_array_add(run->errorv, NEWERROR(CODE_FINAL_OK, "OK"));
+		if (!a->body)
+			a->body = g_byte_array_new();
+	}
+	g_ptr_array_add(run->bodyv, a->body);
+	g_ptr_array_add(run->urlv, g_strdup(a->url));
+	a->body = NULL;
+}
+
+static void
+_attempts_free(struct replicated_attempt_s *attempts, guint nb)
+{
+	for (guint i = 0; i < nb; i++) {
+		struct replicated_attempt_s *a = attempts + i;
+		if (a->client)
+			gridd_client_free(a->client);
+		if (a->body)
+			g_byte_array_unref(a->body);
+		if (a->err)
+			g_clear_error(&a->err);
+	}
+	g_free(attempts);
+}
+
+static gboolean
+_error_is_late(GError *err, gint64 deadline, gint64 now)
+{
+	return (err->code == ERRCODE_CONN_TIMEOUT
+			|| err->code == ERRCODE_READ_TIMEOUT)
+		&& now >= deadline;
+}
+
+/* Returns the delay before sending a hedged request to the next peer */
+static gint64
+_hedge_delay(void)
+{
+	if (proxy_request_hedge_delay > 0)
+		return proxy_request_hedge_delay;
+	gint64 p95 = proxy_latency_quantile(PROXY_LATENCY_PEER, 0.95);
+	if (p95 < 0)
+		return proxy_request_hedge_delay_max;
+	return CLAMP(p95, proxy_request_hedge_delay_min,
+			proxy_request_hedge_delay_max);
+}
+
+/* Send the request to the best peer, then to the next one each time the
+ * hedge delay elapses without any answer, or as soon as the pending attempts
+ * failed with a network error. The first definitive answer (a success or an
+ * error coming from the service) wins, the other attempts are abandoned and
+ * not reported. */
+static GError *
+_request_hedged(struct replicated_run_s *run, gchar **m1uv)
+{
+	const guint nb = g_strv_length(m1uv);
+	const gint64 delay = _hedge_delay();
+	struct replicated_attempt_s *attempts = g_malloc0_n(nb, sizeof(*attempts));
+	struct gridd_client_s **active = g_malloc0_n(nb + 1, sizeof(void*));
+	struct replicated_attempt_s *winner = NULL, *last = NULL;
+	GError *err = NULL;
+	gint64 next_launch = 0;
+	guint launched = 0;
+
+	for (;;) {
+		gint64 now = oio_ext_monotonic_time();
+
+		/* Collect the outcome of the attempts that just finished */
+		for (guint i = 0; i < launched && !winner; i++) {
+			struct replicated_attempt_s *a = attempts + i;
+			if (!_attempt_check(a, now))
+				continue;
+			last = a;
+			if (!a->err) {
+				winner = a;
+			} else if (CODE_IS_NETWORK_ERROR(a->err->code)) {
+				/* the target service is in bad shape, let's avoid it for
+				 * the subsequent requests, and try the next peer now. */
+				service_invalidate(a->url);
+				next_launch = 0;
+			} else if (error_is_exiting(a->err)) {
+				next_launch = 0;
+			} else {
+				if (CODE_IS_RETRY(a->err->code))
+					service_invalidate(a->url);
+				winner = a;
+			}
+		}
+		if (winner)
+			break;
+
+		guint nb_active = 0;
+		for (guint i = 0; i < launched; i++) {
+			if (attempts[i].end <= 0)
+				active[nb_active++] = attempts[i].client;
+		}
+		active[nb_active] = NULL;
+
+		if (launched < nb && (!nb_active || now >= next_launch)) {
+			if (launched > 0)
+				GRID_DEBUG("Hedging to [%s] after %"G_GINT64_FORMAT"us"
+						" (reqid=%s)", m1uv[launched],
+						now - attempts[0].start, oio_ext_get_reqid());
+			_attempt_start(run, attempts + launched, m1uv[launched]);
+			launched ++;
+			next_launch = now + delay;
+			continue;
+		}
+		if (!nb_active)
+			break;
+
+		gint64 wait = G_TIME_SPAN_MILLISECOND * 100;
+		if (launched < nb)
+			wait = MIN(wait, next_launch - now);
+		if ((err = gridd_clients_step_timeout(active,
+						MAX(1, wait / G_TIME_SPAN_MILLISECOND)))) {
+			g_prefix_error(&err, "(Step) ");
+			break;
+		}
+	}
+
+	/* Report the failed attempts, then the winner, last, as the sequential
+	 * mode would have done. */
+	for (guint i = 0; i < launched; i++) {
+		struct replicated_attempt_s *a = attempts + i;
+		if (a != winner && a->end > 0)
+			_attempt_push(run, a);
+	}
+	if (winner) {
+		_attempt_push(run, winner);
+		if (winner->err)
+			err = g_error_copy(winner->err);
+
+		/* check for a possible redirection to update the cache of master,
+		 * only used when a preference is set, as in the sequential mode */
+		if ((!winner->err || !error_clue_for_decache(winner->err))
+				&& (flag_prefer_master_for_read ||
+					flag_prefer_slave_for_read ||
+					flag_prefer_master_for_write)
+				&& winner->client) {
+			const char *actual = gridd_client_url(winner->client);
+			if (actual && 0 != strcmp(actual, winner->url))
+				service_learn_master(run->election_key, actual);
+		}
+	} else if (!err && last) {
+		if (_error_is_late(last->err, run->deadline, last->end)) {
+			err = NEWERROR(CODE_UNAVAILABLE, "Deadline reached: %s",
+					last->err->message);
+		} else {
+			err = BUSY("No service replied (last error: (%d) %s)",
+					last->err->code, last->err->message);
+		}
+	} else if (!err) {
+		err = BUSY("No service replied");
+	}
+
+	g_free(active);
+	_attempts_free(attempts, nb);
+	return err;
+}
+
+/* Send the request to all the peers at once, then interpret the replies as
+ * the sequential mode would have done. */
+static GError *
+_request_fanout(struct replicated_run_s *run, gchar **m1uv)
+{
+	const guint nb = g_strv_length(m1uv);
+	struct replicated_attempt_s *attempts = g_malloc0_n(nb, sizeof(*attempts));
+	struct gridd_client_s **active = g_malloc0_n(nb + 1, sizeof(void*));
+	GError *err = NULL;
+
+	for (guint i = 0; i < nb; i++)
+		_attempt_start(run, attempts + i, m1uv[i]);
+
+	for (;;) {
+		const gint64 now = oio_ext_monotonic_time();
+		guint nb_active = 0;
+		for (guint i = 0; i < nb; i++) {
+			struct replicated_attempt_s *a = attempts + i;
+			_attempt_check(a, now);
+			if (a->end <= 0)
+				active[nb_active++] = a->client;
+		}
+		active[nb_active] = NULL;
+		if (!nb_active)
+			break;
+		if ((err = gridd_clients_step(active))) {
+			g_prefix_error(&err, "(Step) ");
+			break;
+		}
+	}
+
+	for (guint i = 0; i < nb; i++) {
+		struct replicated_attempt_s *a = attempts + i;
+		if (a->end <= 0) {
+			/* Interrupted by a polling error */
+			a->end = oio_ext_monotonic_time();
+			a->err = g_error_copy(err);
+		}
+		_attempt_push(run, a);
+		if (!a->err)
+			continue;
+
+		GError *final = NULL;
+		if (_error_is_late(a->err, run->deadline, a->end)) {
+			/* We did not give enough time for the request to connect
+			 * then be treated. We must not declare the remote service is
+			 * unavailable, it is just a little late for the deadline. */
+			final = NEWERROR(CODE_UNAVAILABLE, "Deadline reached: %s",
+					a->err->message);
+		} else if (CODE_IS_NETWORK_ERROR(a->err->code)) {
+			service_invalidate(a->url);
+		} else if (error_is_exiting(a->err)) {
+			/* The other peers had to be reached anyway */
+		} else if (CODE_IS_RETRY(a->err->code)) {
+			service_invalidate(a->url);
+			final = g_error_copy(a->err);
+		} else if (run->ctx->which != CLIENT_RUN_ALL
+				&& run->ctx->which != CLIENT_SPECIFIED) {
+			final = g_error_copy(a->err);
+		}
+		/* Keep the first error, as the sequential mode would stop there */
+		if (final && !err)
+			err = final;
+		else if (final)
+			g_error_free(final);
+	}
+
+	g_free(active);
+	_attempts_free(attempts, nb);
+	return err;
+}
+
+static gboolean
+_hedge_allowed(struct client_ctx_s *ctx, gchar **m1uv)
+{
+	return proxy_request_hedge_enabled
+		&& ctx->which == CLIENT_PREFER_SLAVE
+		&& !ctx->decoder
+		&& m1uv[0] && m1uv[1];
+}
+
+static gboolean
+_fanout_allowed(struct client_ctx_s *ctx, gchar **m1uv)
+{
+	return proxy_request_fanout_enabled
+		&& ctx->multi_run
+		&& !ctx->decoder
+		&& m1uv[0] && m1uv[1];
+}
+
 static GError *
 gridd_request_replicated (struct req_args_s *args, struct client_ctx_s *ctx,
 		request_packer_f pack)
@@ -398,7 +850,26 @@ label_retry:
 	NAME2CONST(n, ctx->name);
 	const gchar *headers[4] = {SQLX_ADMIN_PEERS, peers, NULL, NULL};
 
+	enum proxy_latency_e mode = PROXY_LATENCY_SERIAL;
+	struct replicated_run_s run = {
+		.ctx = ctx, .pack = pack, .name = &n, .headers = headers,
+		.election_key = election_key, .deadline = deadline,
+		.bypass_down = oio_str_parse_bool(BYPASS_SERVICE_DOWN(), FALSE),
+		.urlv = urlv, .errorv = errorv, .bodyv = bodyv, .urlerrorv = urlerrorv,
+	};
+
 	gboolean stop = FALSE;
+	if (_fanout_allowed(ctx, m1uv)) {
+		mode = PROXY_LATENCY_FANOUT;
+		err = _request_fanout(&run, m1uv);
+		stop = TRUE;
+	} else if (_hedge_allowed(ctx, m1uv)) {
+		mode = PROXY_LATENCY_HEDGED;
+		err = _request_hedged(&run, m1uv);
+		stop = TRUE;
+	}
+
+	/* Default mode: one peer after the other */
 	for (gchar **pu = m1uv; *pu && !stop; ++pu) {
 		const char *url = pu[0];
 		const char *next_url = pu[1];
@@ -446,10 +917,18 @@ label_retry:
 					// To bypass service check
 					gridd_client_set_avoidance(client, FALSE);
 				}
+				/* A request a SLAVE may serve is a read */
+				if (ctx->which == CLIENT_PREFER_SLAVE) {
+					gridd_client_set_idempotent(client, TRUE);
+				}
+				const gint64 sub_start = oio_ext_monotonic_time();
 				gridd_client_start(client);
 				if (!(err = gridd_client_loop(client))) {
 					err = gridd_client_error(client);
 				}
+				if (!err)
+					proxy_latency_record(PROXY_LATENCY_PEER,
+							oio_ext_monotonic_time() - sub_start);
 #ifdef HAVE_ENBUG
 			}
 #endif
@@ -570,6 +1049,7 @@ label_retry:
 		}
 	}
 	ctx->request_duration = oio_ext_monotonic_time() - resolve_end;
+	proxy_latency_record(mode, ctx->request_duration);
 
 	EXTRA_ASSERT(urlv->len == bodyv->len);
 	EXTRA_ASSERT(urlv->len == errorv->len);
@@ -678,13 +1158,11 @@ gboolean _request_get_flag (struct req_args_s *args, const char *flag) {
 
 void service_learn (const char *key) {
 	gchar *k = g_strdup(key);
-	SRV_WRITE(lru_tree_insert(srv_known, k, GINT_TO_POINTER(1)));
+	lru_hash_insert(srv_known, k, GINT_TO_POINTER(1));
 }
 
 gboolean service_is_known (const char *key) {
-	gboolean known = FALSE;
-	SRV_READ(known = (NULL != lru_tree_get (srv_known, key)));
-	return known;
+	return NULL != lru_hash_get(srv_known, key, NULL);
 }
 
 GBytes **NOLOCK_service_lookup_wanted (const char *type) {
@@ -33,6 +33,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <json-c/json.h>
 
 #include <core/lrutree.h>
+#include <core/lruhash.h>
 #include <core/oioerrors.h>
 #include <core/url_ext.h>
 #include <core/client_variables.h>
@@ -95,18 +96,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define REG_READ(Action)  GUARDED_READ(reg_rwlock,Action)
 #define REG_WRITE(Action) GUARDED_WRITE(reg_rwlock,Action)
 
-#define PUSH_READ(Action)  GUARDED_READ(push_rwlock,Action)
-#define PUSH_WRITE(Action) GUARDED_WRITE(push_rwlock,Action)
-
-#define SRV_READ(Action)  GUARDED_READ(srv_rwlock,Action)
-#define SRV_WRITE(Action) GUARDED_WRITE(srv_rwlock,Action)
-
 #define WANTED_READ(Action)  GUARDED_READ(wanted_rwlock,Action)
 #define WANTED_WRITE(Action) GUARDED_WRITE(wanted_rwlock,Action)
 
-#define MASTER_READ(Action)  GUARDED_READ(master_rwlock,Action)
-#define MASTER_WRITE(Action) GUARDED_WRITE(master_rwlock,Action)
-
 /** Allocate on the stack a shuffled array of Conscience addresses. */
 #define CSURL(C) gchar **C = NULL; do { \
 	C = proxy_get_cs_urlv(); \
@@ -143,6 +135,7 @@ extern struct oio_lb_s *lb;
 
 extern struct hc_resolver_s *resolver;
 extern struct shard_resolver_s *shard_resolver;
+extern GThreadPool *list_prefetch_pool;
 extern oio_location_t location_num;
 
 /* Global NS info */
@@ -173,15 +166,14 @@ GBytes* service_is_wanted (const char *type); /* refcount++ */
 GBytes** NOLOCK_service_lookup_wanted (const char *type); /* refcount iso */
 
 /* Upstream of services registrations. */
-extern GRWLock push_rwlock;
-extern struct lru_tree_s *push_queue;
+extern struct lru_hash_s *push_queue;
 
 extern GRWLock reg_rwlock;
 extern struct lru_tree_s *srv_registered; /* registered srv seen within 5s */
 
-extern GRWLock srv_rwlock;
-extern struct lru_tree_s *srv_down; /* "IP:PORT" that had a problem */
-extern struct lru_tree_s *srv_known; /* services seen since 'ever' */
+/* Sharded caches, they need no external lock */
+extern struct lru_hash_s *srv_down; /* "IP:PORT" that had a problem */
+extern struct lru_hash_s *srv_known; /* services seen since 'ever' */
 
 gboolean service_is_ok (gconstpointer p);
 void service_invalidate (gconstpointer n);
@@ -190,8 +182,7 @@ void service_learn (const char *key);
 gboolean service_is_known (const char *key);
 
 /* Set of items requiring an election, associated to the latest known master */
-extern GRWLock master_rwlock;
-extern struct lru_tree_s *srv_master;
+extern struct lru_hash_s *srv_master;
 
 enum cache_control_e
 {
@@ -320,6 +311,30 @@ typedef GByteArray * (request_packer_f) (const struct sqlx_name_s *,
 GError * gridd_request_replicated_with_retry (struct req_args_s *args,
 		struct client_ctx_s *ctx, request_packer_f pack);
 
+/* Latencies of the requests to the backend services, per execution mode of
+ * gridd_request_replicated_with_retry(). PROXY_LATENCY_PEER measures the
+ * successful calls to a single peer, whatever the mode. */
+enum proxy_latency_e {
+	PROXY_LATENCY_PEER = 0,
+	PROXY_LATENCY_SERIAL,
+	PROXY_LATENCY_HEDGED,
+	PROXY_LATENCY_FANOUT,
+	PROXY_LATENCY_MAX
+};
+
+/** Register the stats of the latency histograms, so that they are reported
+ * even before the first request. */
+void proxy_latency_init(void);
+
+void proxy_latency_record(enum proxy_latency_e which, gint64 duration);
+
+/** @return the upper bound of the bucket holding the q-th quantile of the
+ * recent latencies, or -1 when too few latencies have been observed. */
+gint64 proxy_latency_quantile(enum proxy_latency_e which, gdouble q);
+
+/** Append a few quantiles of each histogram, in the format of the stats. */
+void proxy_latency_dump(GString *out);
+
 GError * KV_read_properties (struct json_object *j, gchar ***out,
 		const char *section, gboolean fail_if_empty);
 
@@ -332,6 +347,9 @@ GError * KV_read_usersys_properties (struct json_object *j, gchar ***out);
  * by the periodically scheduled internal task */
 gboolean lb_cache_reload(void);
 
+/** Forget the services known, the next reload will fetch complete lists */
+void lb_cache_forget(void);
+
 /* -------------------------------------------------------------------------- */
 
 enum http_rc_e _reply_json (struct req_args_s *args, int code, const char * msg, GString * gstr);
@@ -371,6 +389,13 @@ GError * conscience_remote_get_services(struct req_args_s *args, gchar **cs,
 		const char *type, gboolean full, GSList **out,
 		gint64 deadline);
 
+/* Get the services of the type changed since the generation <since> of the
+ * conscience <epoch>, or all of them when the conscience cannot tell. */
+GError * conscience_remote_get_services_since(struct req_args_s *args,
+		gchar **cs, const char *type, gboolean full,
+		const char *epoch, gint64 since, struct service_delta_s *out,
+		gint64 deadline);
+
 GError * conscience_remote_get_types(struct req_args_s *args, gchar **cs,
 		gchar ***out,
 		gint64 deadline);
@@ -116,6 +116,84 @@ conscience_remote_get_services(struct req_args_s *args, gchar **allcs,
 	return _loop_on_allcs_while_neterror(args, allcs, action);
 }
 
+static gboolean
+_on_delta_reply(gpointer ctx, guint status UNUSED, MESSAGE reply)
+{
+	struct service_delta_s *delta = ctx;
+	EXTRA_ASSERT(delta != NULL);
+
+	GSList *l = NULL;
+	GError *e = metautils_message_extract_body_encoded(reply, FALSE, &l,
+			service_info_unmarshall);
+	if (e) {
+		GRID_DEBUG("Callback error: (%d) %s", e->code, e->message);
+		g_clear_error(&e);
+		return FALSE;
+	}
+	delta->changed = metautils_gslist_precat(delta->changed, l);
+
+	/* A conscience unaware of the deltas replies a complete list, with
+	 * neither epoch nor generation: the next request will be complete too */
+	gchar *epoch = metautils_message_extract_string_copy(reply,
+			NAME_MSGKEY_EPOCH);
+	if (epoch)
+		oio_str_reuse(&delta->epoch, epoch);
+	e = metautils_message_extract_strint64(reply, NAME_MSGKEY_GENERATION,
+			FALSE, &delta->generation);
+	if (e) {
+		GRID_WARN("Failed to extract '"NAME_MSGKEY_GENERATION"': (%d) %s",
+				e->code, e->message);
+		g_clear_error(&e);
+		delta->generation = 0;
+	}
+	delta->complete = !metautils_message_extract_flag(reply,
+			NAME_MSGKEY_DELTA, FALSE);
+	gchar *removed = metautils_message_extract_string_copy(reply,
+			NAME_MSGKEY_REMOVED);
+	if (removed) {
+		g_strfreev(delta->removed);
+		delta->removed = g_strsplit(removed, ",", -1);
+		g_free(removed);
+	}
+	return TRUE;
+}
+
+GError *
+conscience_remote_get_services_since(struct req_args_s *args, gchar **allcs,
+		const char *type, gboolean full, const char *epoch, gint64 since,
+		struct service_delta_s *out, gint64 deadline)
+{
+	EXTRA_ASSERT(type != NULL);
+	EXTRA_ASSERT(out != NULL);
+	GError * action (const char *cs) {
+		service_delta_clean(out);
+		MESSAGE req = metautils_message_create_named("CS_SRV",
+				oio_clamp_deadline(proxy_timeout_conscience, deadline));
+		metautils_message_add_field_str(req, NAME_MSGKEY_TYPENAME, type);
+		metautils_message_add_field_strint64(req, NAME_MSGKEY_SINCE,
+				MAX(0, since));
+		if (oio_str_is_set(epoch))
+			metautils_message_add_field_str(req, NAME_MSGKEY_EPOCH, epoch);
+		if (full)
+			metautils_message_add_field_str(req, NAME_MSGKEY_FULL, "1");
+		GByteArray *encoded = message_marshall_gba_and_clean(req);
+		struct gridd_client_s *client = gridd_client_create(cs, encoded,
+				out, _on_delta_reply);
+		g_byte_array_unref(encoded);
+		if (!client)
+			return SYSERR("client creation");
+		gridd_client_set_timeout(client,
+				oio_clamp_timeout(proxy_timeout_conscience, deadline));
+		GError *err = gridd_client_run(client);
+		gridd_client_free(client);
+		return err;
+	}
+	GError *err = _loop_on_allcs_while_neterror(args, allcs, action);
+	if (err)
+		service_delta_clean(out);
+	return err;
+}
+
 GError *
 conscience_remote_get_types(struct req_args_s *args, gchar **allcs,
 		gchar ***out, gint64 deadline)
@@ -541,19 +619,17 @@ _registration_batch(struct req_args_s *args, enum reg_op_e op, GSList *services)
  * is already pending (lock or unlock), we should not lose the
  * special action, so merge the old score (i.e. the action code)
  * in the new services description */
-#define ENQUEUE_SERVICE() { \
-	if (op == REGOP_PUSH) { \
-		struct service_info_s *si0 = lru_tree_get(push_queue, key); \
-		if (si0 && si0->put_score.value != SCORE_UNSET) \
-			si->put_score.value = si0->put_score.value; \
-	} \
-	lru_tree_insert(push_queue, key, si); \
-}
+	void _keep_action(gpointer v, gconstpointer previous) {
+		const struct service_info_s *si0 = previous;
+		if (si0->put_score.value != SCORE_UNSET)
+			((struct service_info_s*)v)->put_score.value = si0->put_score.value;
+	}
 	if (flag_cache_enabled) {
 		for (GSList *l=services; l ;l=l->next) {
 			struct service_info_s *si = l->data;
 			gchar *key = service_info_key(si);
-			PUSH_WRITE(ENQUEUE_SERVICE());
+			lru_hash_insert_merge(push_queue, key, si,
+					op == REGOP_PUSH ? _keep_action : NULL);
 			/* Prevent future 'services' list free from freeing element data.
 			 * It will be freed when leaving 'push_queue'. */
 			l->data = NULL;
@@ -728,12 +804,64 @@ action_local_list (struct req_args_s *args)
 	return _reply_success_json (args, gs);
 }
 
+/* Relay the changes of the services of a type since a generation of the
+ * conscience. The services removed are listed with a "removed" flag. */
+static enum http_rc_e
+_conscience_list_since(struct req_args_s *args, const char *type,
+		gboolean full, const char *epoch, const char *since)
+{
+	gint64 generation = 0;
+	if (!oio_str_is_number(since, &generation) || generation < 0)
+		return _reply_format_error(args, BADREQ("Invalid generation"));
+
+	CSURL(cs);
+	struct service_delta_s delta = {0};
+	GError *err = conscience_remote_get_services_since(args, cs, type, full,
+			epoch, generation, &delta, oio_ext_get_deadline());
+	if (NULL != err) {
+		g_prefix_error (&err, "Conscience error: ");
+		return _reply_common_error (args, err);
+	}
+
+	GString *gstr = g_string_sized_new(2048);
+	g_string_append_c(gstr, '[');
+	for (GSList *l = delta.changed; l; l = l->next) {
+		if (gstr->len > 1)
+			g_string_append_c(gstr, ',');
+		service_info_encode_json(gstr, l->data, full);
+	}
+	for (gchar **p = delta.removed; p && *p; p++) {
+		if (gstr->len > 1)
+			g_string_append_c(gstr, ',');
+		g_string_append_static(gstr, "{\"addr\":");
+		oio_str_gstring_append_json_quote(gstr, *p);
+		g_string_append_static(gstr, ",\"removed\":true}");
+	}
+	g_string_append_c(gstr, ']');
+
+	if (delta.epoch)
+		args->rp->add_header(PROXYD_HEADER_CS_EPOCH, g_strdup(delta.epoch));
+	args->rp->add_header(PROXYD_HEADER_CS_GENERATION,
+			g_strdup_printf("%"G_GINT64_FORMAT, delta.generation));
+	if (!delta.complete)
+		args->rp->add_header(PROXYD_HEADER_CS_DELTA, g_strdup("1"));
+	service_delta_clean(&delta);
+	return _reply_success_json(args, gstr);
+}
+
 // CS{{
-// GET /v3.0/{NS}/conscience/list?type=<services type>[&cs=<conscience addr>]
-// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// GET /v3.0/{NS}/conscience/list?type=<services type>[&cs=<conscience addr>][&since=<generation>&epoch=<epoch>]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 //
 // Get list of services registered
 //
+// With ``since``, only the services changed since that generation of the
+// conscience are listed, and those removed come with ``"removed":true``.
+// The epoch and the generation to ask the next time are replied in the
+// ``x-oio-cs-epoch`` and ``x-oio-cs-generation`` headers. ``x-oio-cs-delta``
+// is absent when all the services are listed (e.g. another conscience
+// replied).
+//
 // .. code-block:: http
 //
 //    GET /v3.0/OPENIO/conscience/list?type=rawx HTTP/1.1
@@ -776,6 +904,10 @@ action_conscience_list (struct req_args_s *args)
 	if (!all && (err = _cs_check_tokens(args)) != NULL)
 		return _reply_common_error(args, err);
 
+	const char *since = OPT("since");
+	if (!all && json_format && oio_str_is_set(since))
+		return _conscience_list_since(args, type, full, OPT("epoch"), since);
+
 	if (!CONSCIENCE() && !all && json_format && flag_cache_enabled) {
 		service_remember_wanted (type);
 		if (!full) {
@@ -0,0 +1,325 @@
+/*
+OpenIO SDS proxy
+Copyright (C) 2024 OVH SAS
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as
+published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+
+#include <metautils/lib/metautils.h>
+
+#include "http_parser.h"
+
+static enum http_parser_rc_e
+_error(struct http_parser_s *parser, int code, const gchar *msg)
+{
+	if (!parser->error)
+		parser->error = NEWERROR(code, "%s", msg);
+	return HPRC_ERROR;
+}
+
+static enum http_parser_rc_e
+_done(struct http_parser_s *parser)
+{
+	parser->step = STEP_DONE;
+	return HPRC_SUCCESS;
+}
+
+static gboolean
+_is_header(const gchar *name, gsize name_len, const gchar *expected,
+		gsize expected_len)
+{
+	return name_len == expected_len
+		&& !g_ascii_strncasecmp(name, expected, name_len);
+}
+
+static gboolean
+_parse_decimal(const gchar *s, gsize len, gint64 *out)
+{
+	gint64 v = 0;
+	if (!len || len > 18)
+		return FALSE;
+	for (const gchar *end = s + len; s < end; s++) {
+		if (!g_ascii_isdigit(*s))
+			return FALSE;
+		v = v * 10 + (*s - '0');
+	}
+	*out = v;
+	return TRUE;
+}
+
+static gboolean
+_parse_chunk_size(const gchar *s, gsize len, gint64 *out)
+{
+	gint64 v = 0;
+	gsize i;
+	for (i = 0; i < len && g_ascii_isxdigit(s[i]); i++) {
+		if (i >= 15)
+			return FALSE;
+		v = (v << 4) | g_ascii_xdigit_value(s[i]);
+	}
+	/* Chunk extensions are ignored */
+	if (!i || (i < len && s[i] != ';' && s[i] != ' ' && s[i] != '\t'))
+		return FALSE;
+	*out = v;
+	return TRUE;
+}
+
+/* Tells if the comma-separated list of codings is exactly "chunked". Empty
+ * elements are allowed in a list (RFC 7230 7). */
+static gboolean
+_is_chunked_only(const gchar *s, gsize len)
+{
+	guint count = 0;
+	gboolean chunked = FALSE;
+	const gchar *end = s + len;
+	while (s < end) {
+		const gchar *comma = memchr(s, ',', end - s);
+		const gchar *tok = s, *tok_end = comma ? comma : end;
+		while (tok < tok_end && (*tok == ' ' || *tok == '\t'))
+			++ tok;
+		while (tok_end > tok && (*(tok_end-1) == ' ' || *(tok_end-1) == '\t'))
+			-- tok_end;
+		if (tok_end > tok) {
+			count ++;
+			chunked = (tok_end - tok == 7)
+				&& !g_ascii_strncasecmp(tok, "chunked", 7);
+		}
+		s = comma ? comma + 1 : end;
+	}
+	return count == 1 && chunked;
+}
+
+static gboolean
+_manage_command(struct http_parser_s *parser, const gchar *line, gsize len)
+{
+	const gchar *end = line + len;
+	const gchar *sel = memchr(line, ' ', len);
+	if (!sel || sel == line)
+		return FALSE;
+	++ sel;
+	const gchar *ver = end;
+	while (ver > sel && *(ver-1) != ' ')
+		-- ver;
+	if (ver <= sel)
+		return FALSE;
+
+	if (parser->command_provider)
+		parser->command_provider(line, sel - line - 1,
+				sel, ver - sel - 1, ver, end - ver);
+	return TRUE;
+}
+
+static gboolean
+_manage_header(struct http_parser_s *parser, const gchar *line, gsize len)
+{
+	const gchar *colon = memchr(line, ':', len);
+	/* No whitespace is allowed around the name (RFC 7230 3.2.4), this also
+	 * denies the obsolete line folding. */
+	if (!colon || colon == line
+			|| g_ascii_isspace(*line) || g_ascii_isspace(*(colon-1)))
+		return FALSE;
+
+	const gsize name_len = colon - line;
+	const gchar *value = colon + 1, *end = line + len;
+	while (value < end && (*value == ' ' || *value == '\t'))
+		++ value;
+	while (end > value && (*(end-1) == ' ' || *(end-1) == '\t'))
+		-- end;
+
+	if (_is_header(line, name_len, "content-length", 14)) {
+		if (!_parse_decimal(value, end - value, &parser->content_length))
+			return FALSE;
+	} else if (_is_header(line, name_len, "transfer-encoding", 17)) {
+		/* Only "chunked" alone is supported, any other coding would be
+		 * left in the body. A second header adds codings to the list. */
+		if (parser->chunked || !_is_chunked_only(value, end - value)) {
+			_error(parser, HTTP_CODE_NOT_IMPLEMENTED,
+					"Transfer-Encoding not implemented");
+			return FALSE;
+		}
+		parser->chunked = TRUE;
+	}
+
+	if (parser->header_provider)
+		parser->header_provider(line, name_len, value, end - value);
+	return TRUE;
+}
+
+static enum http_parser_rc_e
+_manage_line(struct http_parser_s *parser, const gchar *line, gsize len)
+{
+	switch (parser->step) {
+		case STEP_FIRST:
+			/* Tolerate empty lines between two requests */
+			if (!len)
+				return HPRC_MORE;
+			if (!_manage_command(parser, line, len))
+				return _error(parser, HTTP_CODE_BAD_REQUEST,
+						"CMD parsing error");
+			parser->step = STEP_HEADERS;
+			return HPRC_MORE;
+
+		case STEP_HEADERS:
+			if (len > 0) {
+				if (!_manage_header(parser, line, len))
+					return _error(parser, HTTP_CODE_BAD_REQUEST,
+							"HDR parsing error");
+				return HPRC_MORE;
+			}
+			/* End of the headers. A request with both a chunked encoding
+			 * and a Content-Length may be understood differently by the
+			 * next hop (request smuggling), it is denied (RFC 7230 3.3.3) */
+			if (parser->chunked && parser->content_length >= 0)
+				return _error(parser, HTTP_CODE_BAD_REQUEST,
+						"Both Content-Length and Transfer-Encoding");
+			if (parser->chunked) {
+				parser->step = STEP_CHUNK_SIZE;
+				return HPRC_MORE;
+			}
+			if (parser->content_length > 0) {
+				parser->step = STEP_BODY_ASIS;
+				return HPRC_MORE;
+			}
+			return _done(parser);
+
+		case STEP_CHUNK_SIZE:
+			if (!_parse_chunk_size(line, len, &parser->chunk_remaining))
+				return _error(parser, HTTP_CODE_BAD_REQUEST,
+						"Chunk size parsing error");
+			parser->step = parser->chunk_remaining > 0
+				? STEP_CHUNK_DATA : STEP_TRAILERS;
+			return HPRC_MORE;
+
+		case STEP_CHUNK_END:
+			if (len > 0)
+				return _error(parser, HTTP_CODE_BAD_REQUEST,
+						"Chunk parsing error");
+			parser->step = STEP_CHUNK_SIZE;
+			return HPRC_MORE;
+
+		case STEP_TRAILERS:
+			/* The trailers are ignored */
+			return len ? HPRC_MORE : _done(parser);
+
+		default:
+			g_assert_not_reached();
+			return HPRC_ERROR;
+	}
+}
+
+enum http_parser_rc_e
+http_parser_feed(struct http_parser_s *parser, const guint8 *data,
+		gsize available, gsize *consumed)
+{
+	enum http_parser_rc_e rc = HPRC_MORE;
+	gsize pos = 0;
+
+	if (parser->step == STEP_DONE)
+		rc = HPRC_SUCCESS;
+
+	while (rc == HPRC_MORE && pos < available) {
+		gint64 max = available - pos;
+
+		switch (parser->step) {
+			case STEP_BODY_ASIS:
+				max = MIN(max, parser->content_length - parser->content_read);
+				if (parser->body_provider)
+					parser->body_provider(data + pos, max);
+				pos += max;
+				parser->content_read += max;
+				if (parser->content_read >= parser->content_length)
+					rc = _done(parser);
+				continue;
+
+			case STEP_CHUNK_DATA:
+				max = MIN(max, parser->chunk_remaining);
+				if (parser->body_provider)
+					parser->body_provider(data + pos, max);
+				pos += max;
+				parser->content_read += max;
+				if (!(parser->chunk_remaining -= max))
+					parser->step = STEP_CHUNK_END;
+				continue;
+
+			default:
+				break;
+		}
+
+		/* The other steps work line by line. The whole line is given at
+		 * once to the providers, without copy unless it spans several
+		 * buffers. memchr() is vectorized by the C library. */
+		const gchar *line = (const gchar*) data + pos;
+		const gchar *eol = memchr(line, '\n', available - pos);
+		gsize len = eol ? (gsize)(eol - line) : available - pos;
+
+		if (parser->buf->len + len > HTTP_PARSER_MAX_LINE) {
+			rc = _error(parser, HTTP_CODE_BAD_REQUEST, "Line too long");
+			break;
+		}
+		pos += len + (eol ? 1 : 0);
+		if (!eol) {
+			g_string_append_len(parser->buf, line, len);
+			continue;
+		}
+		if (parser->buf->len > 0) {
+			g_string_append_len(parser->buf, line, len);
+			line = parser->buf->str;
+			len = parser->buf->len;
+		}
+		if (len > 0 && line[len-1] == '\r')
+			-- len;
+
+		rc = _manage_line(parser, line, len);
+		g_string_set_size(parser->buf, 0);
+	}
+
+	if (consumed)
+		*consumed = pos;
+	return rc;
+}
+
+void
+http_parser_reset(struct http_parser_s *parser)
+{
+	parser->step = STEP_FIRST;
+	g_string_set_size(parser->buf, 0);
+	parser->content_read = 0;
+	parser->content_length = -1;
+	parser->chunk_remaining = 0;
+	parser->chunked = FALSE;
+	if (parser->error)
+		g_clear_error(&parser->error);
+}
+
+struct http_parser_s*
+http_parser_create(void)
+{
+	struct http_parser_s *parser = g_malloc0(sizeof(struct http_parser_s));
+	parser->buf = g_string_sized_new(256);
+	http_parser_reset(parser);
+	return parser;
+}
+
+void
+http_parser_destroy(struct http_parser_s *parser)
+{
+	if (!parser)
+		return;
+	if (parser->error)
+		g_clear_error(&parser->error);
+	g_string_free(parser->buf, TRUE);
+	g_free(parser);
+}
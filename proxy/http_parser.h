@@ -0,0 +1,83 @@
+/*
+OpenIO SDS proxy
+Copyright (C) 2024 OVH SAS
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as
+published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OIO_SDS__proxy__http_parser_h
+# define OIO_SDS__proxy__http_parser_h 1
+
+# include <glib.h>
+
+/* Longest request line or header line accepted */
+# define HTTP_PARSER_MAX_LINE 65536
+
+enum http_parser_step_e
+{
+	STEP_FIRST,
+	STEP_HEADERS,
+	STEP_BODY_ASIS,
+	STEP_CHUNK_SIZE,
+	STEP_CHUNK_DATA,
+	STEP_CHUNK_END,
+	STEP_TRAILERS,
+	STEP_DONE
+};
+
+enum http_parser_rc_e { HPRC_SUCCESS = 0, HPRC_MORE, HPRC_ERROR };
+
+/* The strings given to the providers are NOT nul-terminated, they point
+ * into the buffer given to http_parser_feed() whenever the line is entirely
+ * in it, and into an internal buffer otherwise. In both cases they are only
+ * valid during the call. */
+struct http_parser_s
+{
+	enum http_parser_step_e step;
+	GError *error;
+
+	/* Beginning of the line being parsed, when it spans several buffers */
+	GString *buf;
+
+	gint64 content_read;
+	gint64 content_length;
+	gint64 chunk_remaining;
+	gboolean chunked;
+
+	void (*command_provider)(const gchar *req, gsize req_len,
+			const gchar *sel, gsize sel_len,
+			const gchar *ver, gsize ver_len);
+	void (*header_provider)(const gchar *name, gsize name_len,
+			const gchar *value, gsize value_len);
+	void (*body_provider)(const guint8 *data, gsize data_len);
+};
+
+struct http_parser_s * http_parser_create(void);
+
+/* Prepare the parser for the next request on the same connection */
+void http_parser_reset(struct http_parser_s *parser);
+
+void http_parser_destroy(struct http_parser_s *parser);
+
+/* Parse the `available` bytes of `data`, and tells in `consumed` how many
+ * have been used. Upon HPRC_SUCCESS the request is complete and the bytes
+ * left belong to the next request (keep-alive pipelining). Upon HPRC_MORE
+ * all the bytes have been consumed. Upon HPRC_ERROR, parser->error is set,
+ * with the HTTP status to reply as its code.
+ * Bodies sent with "Transfer-Encoding: chunked" are given decoded to the
+ * body_provider. */
+enum http_parser_rc_e http_parser_feed(struct http_parser_s *parser,
+		const guint8 *data, gsize available, gsize *consumed);
+
+#endif /*OIO_SDS__proxy__http_parser_h*/
@@ -476,18 +476,19 @@ _serialize_property(struct bean_PROPERTIES_s *prop, GString *gstr)
 	g_string_append_c(gstr, '"');
 }
 
+/* Only the objects are dumped, without the enclosing array, so that the
+ * objects of several pages can follow each other. */
 static void
 _dump_json_aliases_and_headers(struct oio_url_s *url, GString *gstr,
-		GSList *aliases, GTree *headers, GTree *props, GTree *chunks)
+		GSList *aliases, GTree *headers, GTree *props, GTree *chunks,
+		gboolean *pfirst)
 {
 	/* Url will can be altered (if <chunks> is not NULL), so let's use a copy */
 	struct oio_url_s *object_url = oio_url_dup(url);
 	const oio_location_t _loca = oio_proxy_local_patch ? location_num : 0;
 
-	g_string_append_static (gstr, "\"objects\":[");
-	gboolean first = TRUE;
 	for (; aliases ; aliases=aliases->next) {
-		COMA(gstr,first);
+		COMA(gstr,*pfirst);
 
 		struct bean_ALIASES_s *a = aliases->data;
 		struct bean_CONTENTS_HEADERS_s *h =
@@ -613,13 +614,13 @@ _dump_json_aliases_and_headers(struct oio_url_s *url, GString *gstr,
 		}
 		g_string_append_c(gstr, '}');
 	}
-	g_string_append_c (gstr, ']');
 
 	oio_url_clean(object_url);
 }
 
 static void
-_dump_json_beans (struct oio_url_s *url, GString *gstr, GSList *beans)
+_dump_json_beans (struct oio_url_s *url, GString *gstr, GSList *beans,
+		gboolean *pfirst)
 {
 	GSList *aliases = NULL;
 	GTree *headers = g_tree_new ((GCompareFunc)metautils_gba_cmp);
@@ -660,7 +661,8 @@ _dump_json_beans (struct oio_url_s *url, GString *gstr, GSList *beans)
 		}
 	}
 
-	_dump_json_aliases_and_headers(url, gstr, aliases, headers, props, chunks);
+	_dump_json_aliases_and_headers(url, gstr, aliases, headers, props, chunks,
+			pfirst);
 
 	gboolean _cleaner(gpointer key UNUSED,
 			gpointer val, gpointer data UNUSED)
@@ -720,9 +722,11 @@ _dump_json_properties (GString *gstr, GTree *properties)
 	g_string_append_c(gstr, '}');
 }
 
+/* <objects> holds the objects already rendered in JSON, page per page, as
+ * GBytes. They are consumed. */
 static enum http_rc_e
 _reply_list_result (struct req_args_s *args, GError * err,
-		struct list_result_s *out, GTree *tree_prefixes)
+		struct list_result_s *out, GTree *tree_prefixes, GQueue *objects)
 {
 	if (err)
 		return _reply_m2_error (args, err);
@@ -736,11 +740,36 @@ _reply_list_result (struct req_args_s *args, GError * err,
 	_dump_json_prefixes (gstr, tree_prefixes);
 	g_string_append_c(gstr, ',');
 	_dump_json_properties (gstr, out->props);
-	g_string_append_c(gstr, ',');
-	_dump_json_beans (args->url, gstr, out->beans);
-	g_string_append_c(gstr, '}');
+	g_string_append_static(gstr, ",\"objects\":[");
+
+	gsize total = 0;
+	for (GList *l = objects->head; l; l = l->next)
+		total += g_bytes_get_size(l->data);
+
+	GBytes *page = NULL;
+	if (total <= proxy_list_stream_threshold) {
+		while ((page = g_queue_pop_head(objects))) {
+			gsize len = 0;
+			const gchar *data = g_bytes_get_data(page, &len);
+			g_string_append_len(gstr, data, len);
+			g_bytes_unref(page);
+		}
+		g_string_append_static(gstr, "]}");
+		return _reply_success_json (args, gstr);
+	}
 
-	return _reply_success_json (args, gstr);
+	/* Big listings are not copied once more in a single body: each page is
+	 * sent then freed, as soon as the socket accepts it. */
+	args->rp->access_tail("streamed:%"G_GSIZE_FORMAT, total);
+	args->rp->set_status(HTTP_CODE_OK, "OK");
+	args->rp->set_content_type(HTTP_CONTENT_TYPE_JSON);
+	args->rp->set_body_gstr(gstr);
+	args->rp->start_chunked();
+	while ((page = g_queue_pop_head(objects)))
+		args->rp->send_chunk(page);
+	args->rp->send_chunk(g_bytes_new_static("]}", 2));
+	args->rp->finalize();
+	return HTTPRC_DONE;
 }
 
 static enum http_rc_e
@@ -2189,15 +2218,317 @@ _build_next_marker(const char *marker, const char *delimiter,
 	return next_marker;
 }
 
+/* A page of listing requested ahead of time, from a shard that follows the
+ * shard being listed. It is shared between the thread serving the client
+ * and a thread of <list_prefetch_pool>, hence the reference counter. */
+struct list_prefetch_s
+{
+	gint refcount;
+	gint cancelled;
+	gboolean done;
+	GMutex lock;
+	GCond cond;
+
+	/* Context of the client request, copied from the thread-locals */
+	gchar *reqid;
+	gchar *region;
+	gchar *user_agent;
+	gint64 deadline;
+	gboolean admin;
+	gboolean force_master;
+	gboolean upgrade_to_tls;
+	gboolean end_user_request;
+	gboolean simulate_versioning;
+
+	struct oio_url_s *url;
+	enum cache_control_e cache_control;
+	/* All the strings are owned */
+	struct list_params_s in;
+
+	GError *err;
+	struct list_result_s out;
+};
+
+static void
+_list_prefetch_unref(struct list_prefetch_s *pf)
+{
+	if (!g_atomic_int_dec_and_test(&pf->refcount))
+		return;
+	oio_str_clean(&pf->reqid);
+	oio_str_clean(&pf->region);
+	oio_str_clean(&pf->user_agent);
+	oio_url_clean(pf->url);
+	oio_str_clean((gchar**)&pf->in.prefix);
+	oio_str_clean((gchar**)&pf->in.delimiter);
+	oio_str_clean((gchar**)&pf->in.marker_start);
+	oio_str_clean((gchar**)&pf->in.version_marker);
+	oio_str_clean((gchar**)&pf->in.marker_end);
+	if (pf->err)
+		g_clear_error(&pf->err);
+	m2v2_list_result_clean(&pf->out);
+	g_mutex_clear(&pf->lock);
+	g_cond_clear(&pf->cond);
+	g_free(pf);
+}
+
+/* The answers of the prefetched requests never reach the client: they must
+ * not touch the headers of the actual reply. */
+static void
+_list_prefetch_add_header(const gchar *name UNUSED, gchar *v)
+{
+	g_free(v);
+}
+
+static void
+_list_prefetch_run(struct list_prefetch_s *pf)
+{
+	oio_ext_set_reqid(pf->reqid);
+	oio_ext_set_region(pf->region);
+	oio_ext_set_user_agent(pf->user_agent);
+	oio_ext_set_deadline(pf->deadline);
+	oio_ext_set_admin(pf->admin);
+	oio_ext_set_force_master(pf->force_master);
+	oio_ext_set_upgrade_to_tls(pf->upgrade_to_tls);
+	oio_ext_set_end_user_request(pf->end_user_request);
+	oio_ext_set_simulate_versioning(pf->simulate_versioning);
+	oio_ext_set_is_shard_redirection(FALSE);
+	oio_ext_set_shared_properties(NULL);
+
+	struct oio_requri_s req_uri = {0};
+	struct http_request_s rq = {0};
+	struct http_reply_ctx_s rp = {0};
+	rq.tree_headers = g_tree_new_full(metautils_strcmp3, NULL, g_free, g_free);
+	rp.add_header = _list_prefetch_add_header;
+	struct req_args_s args = {0};
+	args.req_uri = &req_uri;
+	args.url = pf->url;
+	args.cache_control = pf->cache_control;
+	args.rq = &rq;
+	args.rp = &rp;
+
+	/* <args.url> is replaced by the URL of the shard while the request
+	 * is sent, it must be read when the request is packed. */
+	PACKER_VOID(_pack) {
+		return m2v2_remote_pack_LIST(args.url, &pf->in, DL());
+	}
+	pf->err = _resolve_meta2(&args, _prefer_slave(), _pack, &pf->out,
+			m2v2_list_result_extract);
+
+	g_tree_destroy(rq.tree_headers);
+	oio_ext_set_reqid(NULL);
+	oio_ext_set_region(NULL);
+	oio_ext_set_user_agent(NULL);
+}
+
+void
+list_prefetch_worker(gpointer data, gpointer udata UNUSED)
+{
+	struct list_prefetch_s *pf = data;
+
+	/* Do not send the request if the page is not expected anymore */
+	if (g_atomic_int_get(&pf->cancelled))
+		pf->err = BUSY("Prefetch cancelled");
+	else
+		_list_prefetch_run(pf);
+
+	g_mutex_lock(&pf->lock);
+	pf->done = TRUE;
+	g_cond_signal(&pf->cond);
+	g_mutex_unlock(&pf->lock);
+	_list_prefetch_unref(pf);
+}
+
+/* Compute the marker and the routing key, as _list_loop() does for each
+ * iteration. */
+static gchar *
+_list_routing_key(const char *prefix, const char *marker_start)
+{
+	if (!(prefix && *prefix) && !(marker_start && *marker_start))
+		return g_strdup("");
+	if (g_strcmp0(prefix, marker_start) > 0)
+		return g_strdup(prefix);
+	/* HACK: "\x01" is the (UTF-8 encoded) first unicode */
+	return g_strdup_printf("%s\x01", marker_start);
+}
+
+static struct list_prefetch_s *
+_list_prefetch_start(struct req_args_s *args, struct list_params_s *in0,
+		const gchar *marker, const gchar *version_marker,
+		const gint64 maxkeys)
+{
+	struct list_prefetch_s *pf = g_malloc0(sizeof(struct list_prefetch_s));
+	pf->refcount = 2;  // one for the listing loop, one for the worker
+	g_mutex_init(&pf->lock);
+	g_cond_init(&pf->cond);
+	m2v2_list_result_init(&pf->out);
+
+	pf->reqid = g_strdup(oio_ext_get_reqid());
+	pf->region = g_strdup(oio_ext_get_region());
+	pf->user_agent = g_strdup(oio_ext_get_user_agent());
+	pf->deadline = oio_ext_get_deadline();
+	pf->admin = oio_ext_is_admin();
+	pf->force_master = oio_ext_has_force_master();
+	pf->upgrade_to_tls = oio_ext_has_upgrade_to_tls();
+	pf->end_user_request = oio_ext_is_end_user_request();
+	pf->simulate_versioning = oio_ext_has_simulate_versioning();
+
+	pf->in = *in0;
+	pf->in.maxkeys = maxkeys;
+	pf->in.prefix = g_strdup(in0->prefix);
+	pf->in.delimiter = g_strdup(in0->delimiter);
+	pf->in.marker_start = g_strdup(marker);
+	pf->in.version_marker = g_strdup(version_marker);
+	pf->in.marker_end = g_strdup(in0->marker_end);
+
+	pf->url = oio_url_dup(args->url);
+	gchar *routing_key = _list_routing_key(pf->in.prefix, pf->in.marker_start);
+	oio_url_set(pf->url, OIOURL_PATH, routing_key);
+	g_free(routing_key);
+	pf->cache_control = args->cache_control;
+
+	/* Even if no new thread could be started, the task is queued and will
+	 * be run by the threads already present. */
+	GError *err = NULL;
+	if (!g_thread_pool_push(list_prefetch_pool, pf, &err)) {
+		GRID_DEBUG("Listing prefetch delayed: (%d) %s (reqid=%s)",
+				err->code, err->message, oio_ext_get_reqid());
+		g_clear_error(&err);
+	}
+	return pf;
+}
+
+static void
+_list_prefetch_cancel(struct list_prefetch_s *pf)
+{
+	g_atomic_int_set(&pf->cancelled, 1);
+	_list_prefetch_unref(pf);
+}
+
+static void
+_list_prefetch_cancel_all(GQueue *prefetches)
+{
+	struct list_prefetch_s *pf;
+	while ((pf = g_queue_pop_head(prefetches)))
+		_list_prefetch_cancel(pf);
+}
+
+/* Wait for the page until the deadline of the request */
+static gboolean
+_list_prefetch_wait(struct list_prefetch_s *pf)
+{
+	gboolean done;
+	g_mutex_lock(&pf->lock);
+	while (!(done = pf->done)) {
+		if (!g_cond_wait_until(&pf->cond, &pf->lock, pf->deadline))
+			break;
+	}
+	g_mutex_unlock(&pf->lock);
+	return done;
+}
+
+/* Tell if the page prefetched is exactly the page the listing loop would
+ * have got with <in>. The prefetch may have been started before the
+ * previous pages were received, with a greater maximum number of items:
+ * the page is still correct if it has not been cut by this limit. */
+static gboolean
+_list_prefetch_usable(struct list_prefetch_s *pf, struct list_params_s *in)
+{
+	if (pf->err)
+		return FALSE;
+	if (pf->in.maxkeys == in->maxkeys)
+		return TRUE;
+	gint64 count = 0;
+	for (GSList *l = pf->out.beans; l; l = l->next) {
+		if (l->data && DESCR(l->data) == &descr_struct_ALIASES)
+			count++;
+	}
+	return in->maxkeys <= 0 || count <= in->maxkeys;
+}
+
+/* When the shard just listed is exhausted, and the shards following it are
+ * known by the shard resolver, start listing them in the background.
+ * <version_marker> is the one the listing loop will send with the next
+ * marker. <prefetches> keeps the pages already started, in the order of the
+ * shards. */
+static void
+_list_prefetch_next_shards(struct req_args_s *args,
+		struct list_params_s *in0, GTree *tree_prefixes,
+		const gchar *routing_key, const gchar *next_marker,
+		const gchar *version_marker, const gint64 maxkeys,
+		GQueue *prefetches)
+{
+	const guint max = proxy_list_prefetch_shards;
+	if (!max || !list_prefetch_pool)
+		return;
+
+	oio_url_set(args->url, OIOURL_PATH, routing_key);
+	GSList *shards = shard_resolver_get_cached_range(
+			shard_resolver, args->url, max + 1);
+	oio_url_unset(args->url, OIOURL_PATH);
+
+	/* The first shard is the one just listed. Its upper bound is returned as
+	 * the next marker once all its objects have been listed. */
+	if (!shards || g_strcmp0(next_marker,
+			SHARD_RANGE_get_upper(shards->data)->str)) {
+		_list_prefetch_cancel_all(prefetches);
+		goto exit;
+	}
+
+	guint started = 0;
+	for (GSList *l = shards->next; l; l = l->next) {
+		const gchar *lower = SHARD_RANGE_get_lower(l->data)->str;
+		if (in0->marker_end && *in0->marker_end
+				&& g_strcmp0(lower, in0->marker_end) >= 0)
+			break;
+		if (in0->prefix && *in0->prefix
+				&& g_strcmp0(lower, in0->prefix) > 0
+				&& !g_str_has_prefix(lower, in0->prefix))
+			break;
+
+		gchar *marker = _build_next_marker(lower, in0->delimiter,
+				in0->prefix, tree_prefixes);
+		if (started < prefetches->length) {
+			struct list_prefetch_s *pf = g_queue_peek_nth(prefetches, started);
+			if (!g_strcmp0(pf->in.marker_start, marker)
+					&& !g_strcmp0(pf->in.version_marker, version_marker)) {
+				/* Already started */
+				g_free(marker);
+				started++;
+				continue;
+			}
+			/* The shards changed since this page has been started */
+			while (prefetches->length > started)
+				_list_prefetch_cancel(g_queue_pop_tail(prefetches));
+		}
+		struct list_prefetch_s *pf = _list_prefetch_start(
+				args, in0, marker, version_marker, maxkeys);
+		g_free(marker);
+		g_queue_push_tail(prefetches, pf);
+		started++;
+	}
+	while (prefetches->length > started)
+		_list_prefetch_cancel(g_queue_pop_tail(prefetches));
+
+exit:
+	g_slist_free_full(shards, _bean_clean);
+}
+
+/* The objects listed are rendered in JSON as soon as their page has been
+ * received, and pushed in <objects> as GBytes. Only the beans of one page
+ * are held at once, the JSON is far more compact. */
 static GError * _list_loop (struct req_args_s *args,
 		struct list_params_s *in0, struct list_result_s *out0,
-		GTree *tree_prefixes, list_packer_f packer) {
+		GTree *tree_prefixes, GQueue *objects, list_packer_f packer,
+		gboolean prefetch) {
 	GError *err = NULL;
 	gboolean stop = FALSE;
+	gboolean first_object = TRUE;
 	gint iterations = 0;
 	// Total number of objects listed so far
 	guint main_count = 0;
 	struct list_params_s in = *in0;
+	// Pages requested ahead to the next shards, in the order of the shards
+	GQueue prefetches = G_QUEUE_INIT;
 
 	GRID_DEBUG("Listing [%s] max=%"G_GINT64_FORMAT" delim=%s prefix=%s"
 			" marker=%s version_marker=%s end=%s",
@@ -2234,37 +2565,47 @@ static GError * _list_loop (struct req_args_s *args,
 
 		/* Build a routing key (object path) so the sharding resolver
 		 * will direct the request to the next shard. */
-		gchar *routing_key = NULL;
-		if (!(in.prefix && *in.prefix)
-				&& !(in.marker_start && *in.marker_start)) {
-			routing_key = g_strdup("");
-		} else if (g_strcmp0(in.prefix, in.marker_start) > 0) {
-			routing_key = g_strdup(in.prefix);
-		} else {
-			/* HACK: "\x01" is the (UTF-8 encoded) first unicode */
-			routing_key = g_strdup_printf("%s\x01", in.marker_start);
+		gchar *routing_key = _list_routing_key(in.prefix, in.marker_start);
+
+		/* Maybe the page has already been requested */
+		struct list_prefetch_s *pf = g_queue_pop_head(&prefetches);
+		if (pf && (g_strcmp0(pf->in.marker_start, in.marker_start)
+				|| g_strcmp0(pf->in.version_marker, in.version_marker))) {
+			/* The listing does not follow the shards anymore */
+			_list_prefetch_cancel(pf);
+			_list_prefetch_cancel_all(&prefetches);
+			pf = NULL;
+		}
+		if (pf) {
+			if (!_list_prefetch_wait(pf) || !_list_prefetch_usable(pf, &in)) {
+				_list_prefetch_cancel(pf);
+				pf = NULL;
+			}
 		}
 
 		/* Action */
-		if (routing_key) {
+		if (pf) {
+			struct list_result_s unused = out;
+			out = pf->out;
+			pf->out = unused;
+			_list_prefetch_unref(pf);
+		} else {
 			oio_url_set(args->url, OIOURL_PATH, routing_key);
-		}
-		enum cache_control_e original_cache_control = args->cache_control;
-		if (g_tree_nnodes(out0->props) == 0) {
-			// Disable sharding resolver to fetch container properties
-			// from root container
-			args->cache_control |= SHARDING_NO_CACHE;
-		}
-		err = _resolve_meta2(args, _prefer_slave(), _pack, &out,
-				m2v2_list_result_extract);
-		args->cache_control = original_cache_control;
-		if (routing_key) {
-			g_free(routing_key);
+			enum cache_control_e original_cache_control = args->cache_control;
+			if (g_tree_nnodes(out0->props) == 0) {
+				// Disable sharding resolver to fetch container properties
+				// from root container
+				args->cache_control |= SHARDING_NO_CACHE;
+			}
+			err = _resolve_meta2(args, _prefer_slave(), _pack, &out,
+					m2v2_list_result_extract);
+			args->cache_control = original_cache_control;
 			oio_url_unset(args->url, OIOURL_PATH);
 		}
 		oio_str_clean((gchar**)&(in.marker_start));
 		oio_str_clean((gchar**)&(in.version_marker));
 		if (err) {
+			g_free(routing_key);
 			if (err->code == CODE_UNAVAILABLE && main_count > 0) {
 				// We reached request deadline, just tell the caller the
 				// listing is truncated, it will call us again with the
@@ -2300,7 +2641,7 @@ static GError * _list_loop (struct req_args_s *args,
 		oio_str_reuse(&out0->next_version_marker, out.next_version_marker);
 		out.next_version_marker = NULL;
 		if (out.beans) {
-			ctx.beans = out0->beans;
+			ctx.beans = NULL;
 			ctx.prefixes = tree_prefixes;
 			ctx.count = main_count;
 			ctx.prefix = in0->prefix;
@@ -2311,7 +2652,15 @@ static GError * _list_loop (struct req_args_s *args,
 
 			out.beans = NULL;
 			main_count = ctx.count;
-			out0->beans = ctx.beans;
+
+			GString *page = g_string_sized_new(4096);
+			_dump_json_beans(args->url, page, ctx.beans, &first_object);
+			_bean_cleanl2(ctx.beans);
+			ctx.beans = NULL;
+			if (page->len > 0)
+				g_queue_push_tail(objects, g_string_free_to_bytes(page));
+			else
+				g_string_free(page, TRUE);
 		}
 
 		if (in0->maxkeys > 0 &&
@@ -2335,9 +2684,20 @@ static GError * _list_loop (struct req_args_s *args,
 			stop = TRUE;
 		}
 
+		if (prefetch && !stop && g_tree_nnodes(out0->props) > 0) {
+			_list_prefetch_next_shards(args, in0, tree_prefixes,
+					routing_key, out0->next_marker,
+					out0->next_version_marker?: in0->version_marker,
+					in0->maxkeys - (main_count + g_tree_nnodes(tree_prefixes)),
+					&prefetches);
+		}
+
+		g_free(routing_key);
 		m2v2_list_result_clean (&out);
 	}
 
+	/* The requests already sent will complete, their pages are dropped */
+	_list_prefetch_cancel_all(&prefetches);
 	return err;
 }
 
@@ -2557,6 +2917,7 @@ enum http_rc_e action_container_list (struct req_args_s *args) {
 	struct list_params_s list_in = {0};
 	GError *err = NULL;
 	GTree *tree_prefixes = NULL;
+	GQueue objects = G_QUEUE_INIT;
 
 	/* Triggers special listings */
 	const char *chunk_id = g_tree_lookup (args->rq->tree_headers,
@@ -2572,6 +2933,9 @@ enum http_rc_e action_container_list (struct req_args_s *args) {
 		content_hash = g_byte_array_free_to_bytes (gba);
 	}
 
+	/* The beans of a page are freed once rendered, the next pages reuse them */
+	_bean_pool_begin();
+
 	/* Init the listing options common to all the modes */
 	list_in.flag_headers = 1;
 	list_in.flag_nodeleted = 1;
@@ -2616,7 +2980,11 @@ enum http_rc_e action_container_list (struct req_args_s *args) {
 						in, content_hash, DL());
 			return m2v2_remote_pack_LIST(args->url, in, DL());
 		}
-		err = _list_loop (args, &list_in, &list_out, tree_prefixes, _pack);
+		/* The special listings are not prefetched, nor the listings
+		 * targeting a specific service. */
+		const gboolean prefetch = !chunk_id && !content_hash && !SERVICE_ID();
+		err = _list_loop (args, &list_in, &list_out, tree_prefixes, &objects,
+				_pack, prefetch);
 	}
 
 	if (!err) {
@@ -2635,11 +3003,15 @@ enum http_rc_e action_container_list (struct req_args_s *args) {
 		}
 	}
 
-	enum http_rc_e rc = _reply_list_result (args, err, &list_out, tree_prefixes);
+	enum http_rc_e rc = _reply_list_result (args, err, &list_out, tree_prefixes,
+			&objects);
 
+	for (GBytes *page; (page = g_queue_pop_head(&objects));)
+		g_bytes_unref(page);
 	if (tree_prefixes) g_tree_destroy (tree_prefixes);
 	if (content_hash) g_bytes_unref (content_hash);
 	m2v2_list_result_clean (&list_out);
+	_bean_pool_end();
 
 	return rc;
 }
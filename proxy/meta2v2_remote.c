@@ -41,6 +41,9 @@ _m2v2_build_request_with_extra_fields(const char *name, struct oio_url_s *url,
 	MESSAGE msg = metautils_message_create_named(name, deadline);
 	metautils_message_add_url (msg, url);
 	metautils_message_add_fields_str(msg, fields);
+	if (flag_compact_beans)
+		metautils_message_add_field_str(msg, NAME_MSGKEY_BEAN_FORMAT,
+				BEAN_FORMAT_COMPACT);
 	if (body)
 		metautils_message_add_body_unref (msg, body);
 	return msg;
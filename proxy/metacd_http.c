@@ -48,6 +48,7 @@ struct oio_lb_s *lb = NULL;
 
 struct hc_resolver_s *resolver = NULL;
 struct shard_resolver_s *shard_resolver = NULL;
+GThreadPool *list_prefetch_pool = NULL;
 
 oio_location_t location_num = 0;
 
@@ -55,8 +56,7 @@ GRWLock csurl_rwlock = {0};
 gchar **csurl = NULL;
 gsize csurl_count = 0;
 
-GRWLock push_rwlock = {0};
-struct lru_tree_s *push_queue = NULL;
+struct lru_hash_s *push_queue = NULL;
 
 GRWLock reg_rwlock = {0};
 struct lru_tree_s *srv_registered = NULL;
@@ -65,12 +65,9 @@ GRWLock nsinfo_rwlock = {0};
 struct namespace_info_s nsinfo = {{0}, 0, 0, 0};
 gchar **srvtypes = NULL;
 
-GRWLock master_rwlock = {0};
-struct lru_tree_s *srv_master = NULL;
-
-GRWLock srv_rwlock = {0};
-struct lru_tree_s *srv_down = NULL;
-struct lru_tree_s *srv_known = NULL;
+struct lru_hash_s *srv_master = NULL;
+struct lru_hash_s *srv_down = NULL;
+struct lru_hash_s *srv_known = NULL;
 
 GRWLock wanted_rwlock = {0};
 gchar **wanted_srvtypes = NULL;
@@ -114,11 +111,13 @@ action_status(struct req_args_s *args)
 	g_string_append_printf(gstr, "gauge cache.srv.max %u\n", s.services.max);
 	g_string_append_printf(gstr, "gauge cache.srv.ttl %lu\n", s.services.ttl);
 
-	gint64 cd, ck;
-	SRV_READ(cd = lru_tree_count(srv_down); ck = lru_tree_count(srv_known));
+	gint64 cd = lru_hash_count(srv_down), ck = lru_hash_count(srv_known);
 	g_string_append_printf(gstr, "gauge down.srv %"G_GINT64_FORMAT"\n", cd);
 	g_string_append_printf(gstr, "gauge known.srv %"G_GINT64_FORMAT"\n", ck);
 
+	/* the latencies of the requests to the backend services */
+	proxy_latency_dump(gstr);
+
 	args->rp->set_body_gstr(gstr);
 	args->rp->set_status(HTTP_CODE_OK, "OK");
 	args->rp->set_content_type("text/x-java-properties");
@@ -353,12 +352,27 @@ handler_action (struct http_request_s *rq, struct http_reply_ctx_s *rp)
 }
 
 static struct lru_tree_s *
-_push_queue_create (void)
+_registered_create (void)
 {
 	return lru_tree_create((GCompareFunc)g_strcmp0, g_free,
 			(GDestroyNotify) service_info_clean, LTO_NOATIME);
 }
 
+static struct lru_hash_s *
+_push_queue_create (void)
+{
+	return lru_hash_create(g_str_hash, g_str_equal, g_free,
+			(GDestroyNotify) service_info_clean, LTO_NOATIME,
+			LRU_HASH_SHARDS_DEFAULT);
+}
+
+static struct lru_hash_s *
+_services_cache_create (GDestroyNotify vfree)
+{
+	return lru_hash_create(g_str_hash, g_str_equal, g_free, vfree,
+			LTO_NOATIME, LRU_HASH_SHARDS_DEFAULT);
+}
+
 // Administrative tasks --------------------------------------------------------
 
 static guint
@@ -372,12 +386,19 @@ _lru_tree_expire (GRWLock *rw, struct lru_tree_s *lru, const gint64 delay)
 	return count;
 }
 
+static guint
+_lru_hash_expire (struct lru_hash_s *lru, const gint64 delay)
+{
+	if (delay <= 0) return 0;
+	const gint64 now = oio_ext_monotonic_time();
+	return lru_hash_remove_older (lru, OLDEST(now,delay));
+}
+
 static void
 _task_expire_services_master (gpointer p UNUSED)
 {
 	gint64 start = oio_ext_monotonic_time();
-	guint count = _lru_tree_expire (&master_rwlock, srv_master,
-			ttl_expire_master_services);
+	guint count = _lru_hash_expire (srv_master, ttl_expire_master_services);
 	gint64 duration = oio_ext_monotonic_time() - start;
 	if (duration > G_TIME_SPAN_SECOND) {
 		GRID_WARN("Expired %u masters in %.6fs",
@@ -391,7 +412,7 @@ static void
 _task_expire_services_known (gpointer p UNUSED)
 {
 	gint64 start = oio_ext_monotonic_time();
-	guint count = _lru_tree_expire (&srv_rwlock, srv_known, ttl_known_services);
+	guint count = _lru_hash_expire (srv_known, ttl_known_services);
 	gint64 duration = oio_ext_monotonic_time() - start;
 	if (count) {
 		GRID_INFO("Forgot %u services, in %.6fs",
@@ -406,7 +427,7 @@ static void
 _task_expire_services_down (gpointer p UNUSED)
 {
 	gint64 start = oio_ext_monotonic_time();
-	guint count = _lru_tree_expire (&srv_rwlock, srv_down, ttl_down_services);
+	guint count = _lru_hash_expire (srv_down, ttl_down_services);
 	gint64 duration = oio_ext_monotonic_time() - start;
 	if (count) {
 		GRID_INFO("Re-enabled %u services in %.6fs",
@@ -512,15 +533,32 @@ _encode_wanted_services (const char *type, GSList *list)
 	return g_string_free_to_bytes(encoded);
 }
 
+/* The services of each type, as last synchronized with the conscience, so
+ * that only their changes are asked. */
+static GMutex lb_sync_lock = {0};
+static GHashTable *lb_sync = NULL;
+
+static struct service_sync_s *
+_lb_sync_get(const char *type)
+{
+	struct service_sync_s *sync = g_hash_table_lookup(lb_sync, type);
+	if (!sync) {
+		sync = service_sync_create();
+		g_hash_table_insert(lb_sync, g_strdup(type), sync);
+	}
+	return sync;
+}
+
 static void
-_reload_srvtype(const char *type, GSList *list)
+_reload_srvtype(const char *type, GSList *list, GSList *changed, GSList *gone,
+		gboolean everything)
 {
 	/* reloads the known services */
 	time_t now = oio_ext_monotonic_seconds ();
-	SRV_WRITE(for (GSList *l=list; l ;l=l->next) {
+	for (GSList *l=list; l ;l=l->next) {
 		gchar *k = service_info_key (l->data);
-		lru_tree_insert (srv_known, k, (void*)now);
-	});
+		lru_hash_insert (srv_known, k, (void*)now);
+	}
 
 	/* updates the score of the local services */
 	if (flag_local_scores && NULL != list) {
@@ -528,19 +566,26 @@ _reload_srvtype(const char *type, GSList *list)
 			REG_WRITE(_NOLOCK_local_score_update(l->data));
 	}
 
-	/* prepares a cache of services wanted by the clients */
-	if (flag_cache_enabled && NULL != list) {
+	/* prepares a cache of services wanted by the clients, unless nothing
+	 * changed since the last time */
+	if (flag_cache_enabled && NULL != list
+			&& (everything || changed || gone)) {
 		GBytes *encoded = _encode_wanted_services (type, list);
 		WANTED_WRITE (encoded = _NOLOCK_precache_list_of_services (type, encoded));
 		g_bytes_unref (encoded);
 	}
 
 	/* reload the LB worlds, all of them #facepalm */
-	if (list) {
-		oio_lb_world__feed_service_info_list(lb_world, list);
+	if (gone) {
+		oio_lb_world__remove_service_info_list(lb_world, gone);
+		oio_lb_world__remove_service_info_list(lb_world_rawx, gone);
+	}
+	GSList *fed = everything ? list : changed;
+	if (fed) {
+		oio_lb_world__feed_service_info_list(lb_world, fed);
 
 		GSList *rlist = NULL;
-		for (GSList *l = list; l; l=l->next) {
+		for (GSList *l = fed; l; l=l->next) {
 			struct service_info_s *si = l->data;
 			if (!si || strcmp(si->type, NAME_SRVTYPE_RAWX)) continue;
 			rlist = g_slist_prepend(rlist, si);
@@ -553,7 +598,8 @@ _reload_srvtype(const char *type, GSList *list)
 static void
 _reload_lb_service_types(
 		struct oio_lb_world_s *lbw, struct oio_lb_s *lb_,
-		gchar **tabtypes, GPtrArray *tabsrv, GPtrArray *taberr)
+		gchar **tabtypes, GPtrArray *tabchanged, GPtrArray *tabgone,
+		GPtrArray *taberr, gboolean everything)
 {
 	struct service_update_policies_s *pols = service_update_policies_create();
 	gchar *pols_cfg = oio_var_get_string(oio_ns_service_update_policy);
@@ -568,8 +614,13 @@ _reload_lb_service_types(
 					oio_lb_pool__from_service_policy(lbw, srvtype, pols));
 		}
 
-		if (!taberr->pdata[i])
-			_reload_srvtype(srvtype, tabsrv->pdata[i]);
+		if (!taberr->pdata[i]) {
+			struct service_sync_s *sync = _lb_sync_get(srvtype);
+			GSList *list = service_sync_list(sync);
+			_reload_srvtype(srvtype, list, tabchanged->pdata[i],
+					tabgone->pdata[i], everything);
+			g_slist_free(list);
+		}
 	}
 
 	service_update_policies_destroy(pols);
@@ -583,6 +634,12 @@ _free_list_of_services(gpointer p)
 	g_slist_free_full((GSList*)p, (GDestroyNotify)service_info_clean);
 }
 
+static void
+_free_list(gpointer p)
+{
+	g_slist_free((GSList*)p);
+}
+
 static void
 _free_error(gpointer p)
 {
@@ -614,6 +671,15 @@ _filter_good_services(GSList *src, GSList **out_garbage)
 	return good;
 }
 
+void
+lb_cache_forget (void)
+{
+	g_mutex_lock(&lb_sync_lock);
+	if (lb_sync)
+		g_hash_table_remove_all(lb_sync);
+	g_mutex_unlock(&lb_sync_lock);
+}
+
 /* If you ever plan to factorize this code with the similar part in
  * sqlx/sqlx_service.c be careful that a lot of context is expected on both
  * sides, and that even the function used to fetch the services cannot be the
@@ -623,8 +689,9 @@ lb_cache_reload (void)
 {
 	struct namespace_info_s *nsi = NULL;
 	gchar **tabtypes = NULL;
-	GPtrArray *tabsrv = NULL, *taberr = NULL;
+	GPtrArray *tabchanged = NULL, *tabgone = NULL, *taberr = NULL;
 	gboolean any_loading_error = FALSE;
+	gboolean everything = FALSE;
 	down_hosts_t down = NULL;
 	guint nb_down = 0;
 
@@ -642,35 +709,58 @@ lb_cache_reload (void)
 
 	oio_ext_set_prefixed_random_reqid("task-reload-srv-");
 
-	/* preload all the services */
-	tabsrv = g_ptr_array_new_full(8, _free_list_of_services);
+	/* The synchronization state is only used by one reload at a time */
+	g_mutex_lock(&lb_sync_lock);
+
+	/* preload the changes of all the services since the last reload */
+	tabchanged = g_ptr_array_new_full(8, _free_list);
+	tabgone = g_ptr_array_new_full(8, _free_list_of_services);
 	taberr = g_ptr_array_new_full(8, _free_error);
 	for (char **pt=tabtypes; *pt ;++pt) {
-		GSList *srv = NULL;
-		GError *e = conscience_remote_get_services(NULL, cs, *pt, FALSE, &srv,
+		struct service_sync_s *sync = _lb_sync_get(*pt);
+		struct service_delta_s delta = {0};
+		GSList *changed = NULL, *gone = NULL;
+		GError *e = conscience_remote_get_services_since(NULL, cs, *pt,
+				FALSE, sync->epoch, sync->generation, &delta,
 				oio_ext_get_deadline());
 		if (e) {
 			GRID_WARN("Failed to load the list of [%s] in NS=%s", *pt, ns_name);
 			any_loading_error = TRUE;
+		} else {
+			GSList *bad = NULL;
+			delta.changed = _filter_good_services(delta.changed, &bad);
+			g_slist_free_full(bad, (GDestroyNotify)service_info_clean);
+
+			/* One complete list is enough to require the whole world to be
+			 * fed again, the generation of the world will be incremented. */
+			if (delta.complete)
+				everything = TRUE;
+			service_sync_apply(sync, &delta, &changed, &gone);
 		}
+		service_delta_clean(&delta);
 
-		GSList *bad = NULL;
-		srv = _filter_good_services(srv, &bad);
-		g_slist_free_full(bad, (GDestroyNotify)service_info_clean);
-
-		g_ptr_array_add(tabsrv, srv);
+		g_ptr_array_add(tabchanged, changed);
+		g_ptr_array_add(tabgone, gone);
 		g_ptr_array_add(taberr, e);
-		nb_down += gridd_client_update_down_hosts(&down, srv);
+
+		GSList *all = service_sync_list(sync);
+		nb_down += gridd_client_update_down_hosts(&down, all);
+		g_slist_free(all);
 	}
 	gridd_client_replace_global_down_hosts(&down, nb_down);
 
+	/* Without a complete list, only the changes are applied: the generation
+	 * of the world is kept, no service would be fed again to be spared by
+	 * the purge. */
 #define reload_lb(W,L) do { \
-	if (!any_loading_error) \
+	const gboolean purge = everything && !any_loading_error; \
+	if (purge) \
 		oio_lb_world__increment_generation(W); \
 	oio_lb_world__reload_pools(W, L, nsi); \
-	_reload_lb_service_types(W, L, tabtypes, tabsrv, taberr); \
+	_reload_lb_service_types(W, L, tabtypes, tabchanged, tabgone, taberr, \
+			everything); \
 	oio_lb_world__reload_storage_policies(W, L, nsi); \
-	if (!any_loading_error) \
+	if (purge) \
 		oio_lb_world__purge_old_generations(W); \
 	else \
 		oio_lb_world__rehash_all_slots(W); \
@@ -680,10 +770,13 @@ lb_cache_reload (void)
 	reload_lb(lb_world, lb);
 	reload_lb(lb_world_rawx, lb_rawx);
 
+	g_mutex_unlock(&lb_sync_lock);
+
 out:
 	if (tabtypes) g_free0 (tabtypes);
 	if (nsi) namespace_info_free(nsi);
-	if (tabsrv) g_ptr_array_free(tabsrv, TRUE);
+	if (tabchanged) g_ptr_array_free(tabchanged, TRUE);
+	if (tabgone) g_ptr_array_free(tabgone, TRUE);
 	if (taberr) g_ptr_array_free(taberr, TRUE);
 	gridd_client_clear_down_hosts(&down);
 	return !any_loading_error;
@@ -807,16 +900,15 @@ _task_reload_srvtypes (gpointer p UNUSED)
 static void
 _task_push (gpointer p UNUSED)
 {
-	struct lru_tree_s *lru = NULL;
 	GSList *tmp = NULL;
 	gboolean _list (gpointer k, gpointer v, gpointer u) {
-		(void) k, (void) u;
+		(void) u;
+		g_free(k);
 		tmp = g_slist_prepend(tmp, v);
 		return FALSE;
 	}
 
-	PUSH_WRITE(lru = push_queue; push_queue = _push_queue_create());
-	lru_tree_foreach(lru, _list, NULL);
+	lru_hash_foreach_steal(push_queue, _list, NULL);
 
 	if (!tmp) {
 		GRID_TRACE("Push: no service to be pushed");
@@ -835,8 +927,7 @@ _task_push (gpointer p UNUSED)
 		}
 	}
 
-	g_slist_free(tmp);
-	lru_tree_destroy(lru);
+	g_slist_free_full(tmp, (GDestroyNotify) service_info_clean);
 }
 
 static void
@@ -1009,6 +1100,11 @@ grid_main_specific_fini (void)
 		network_server_clean (server);
 		server = NULL;
 	}
+	if (list_prefetch_pool) {
+		/* Let the requests in progress reach their deadline */
+		g_thread_pool_free(list_prefetch_pool, FALSE, TRUE);
+		list_prefetch_pool = NULL;
+	}
 	if (path_parser) {
 		path_parser_clean (path_parser);
 		path_parser = NULL;
@@ -1027,6 +1123,10 @@ grid_main_specific_fini (void)
 		oio_lb_world__destroy(lb_world);
 		lb_world = NULL;
 	}
+	if (lb_sync) {
+		g_hash_table_destroy(lb_sync);
+		lb_sync = NULL;
+	}
 	if (resolver) {
 		hc_resolver_destroy (resolver);
 		resolver = NULL;
@@ -1036,19 +1136,19 @@ grid_main_specific_fini (void)
 		shard_resolver = NULL;
 	}
 	if (srv_down) {
-		lru_tree_destroy (srv_down);
+		lru_hash_destroy (srv_down);
 		srv_down = NULL;
 	}
 	if (srv_known) {
-		lru_tree_destroy (srv_known);
+		lru_hash_destroy (srv_known);
 		srv_known = NULL;
 	}
 	if (srv_master) {
-		lru_tree_destroy (srv_master);
+		lru_hash_destroy (srv_master);
 		srv_master = NULL;
 	}
 	if (push_queue) {
-		lru_tree_destroy (push_queue);
+		lru_hash_destroy (push_queue);
 		push_queue = NULL;
 	}
 	if (wanted_srvtypes) {
@@ -1071,11 +1171,9 @@ grid_main_specific_fini (void)
 	oio_str_clean (&ns_name);
 	g_rw_lock_clear(&nsinfo_rwlock);
 	g_rw_lock_clear(&reg_rwlock);
-	g_rw_lock_clear(&push_rwlock);
 	g_rw_lock_clear(&csurl_rwlock);
-	g_rw_lock_clear(&srv_rwlock);
 	g_rw_lock_clear(&wanted_rwlock);
-	g_rw_lock_clear(&master_rwlock);
+	g_mutex_clear(&lb_sync_lock);
 
 	if (csurl)
 		g_strfreev(csurl);
@@ -1320,12 +1418,10 @@ grid_main_configure (int argc, char **argv)
 	const char *cfg_namespace = argv[1];
 
 	g_rw_lock_init (&csurl_rwlock);
-	g_rw_lock_init (&push_rwlock);
 	g_rw_lock_init (&reg_rwlock);
 	g_rw_lock_init (&nsinfo_rwlock);
-	g_rw_lock_init (&srv_rwlock);
 	g_rw_lock_init (&wanted_rwlock);
-	g_rw_lock_init (&master_rwlock);
+	g_mutex_init (&lb_sync_lock);
 
 	g_strlcpy(nsinfo.name, cfg_namespace, sizeof(nsinfo.name));
 	ns_name = g_strdup(cfg_namespace);
@@ -1366,6 +1462,7 @@ grid_main_configure (int argc, char **argv)
 	oio_stats_set(
 			gq_count_all, 0, gq_count_unexpected, 0,
 			gq_time_all, 0, gq_time_unexpected, 0);
+	proxy_latency_init();
 
 	/* Load statsd conf and init statsd client*/
 	if (oio_str_is_set(server_statsd_host)) {
@@ -1379,10 +1476,12 @@ grid_main_configure (int argc, char **argv)
 
 	lb_world = oio_lb_local__create_world();
 	lb = oio_lb__create();
+	lb_sync = g_hash_table_new_full(g_str_hash, g_str_equal,
+			g_free, (GDestroyNotify)service_sync_destroy);
 
-	srv_down = lru_tree_create((GCompareFunc)g_strcmp0, g_free, NULL, LTO_NOATIME);
-	srv_known = lru_tree_create((GCompareFunc)g_strcmp0, g_free, NULL, LTO_NOATIME);
-	srv_master = lru_tree_create((GCompareFunc)g_strcmp0, g_free, g_free, LTO_NOATIME);
+	srv_down = _services_cache_create(NULL);
+	srv_known = _services_cache_create(NULL);
+	srv_master = _services_cache_create(g_free);
 
 	oio_resolver_cache_enabled = BOOL(flag_cache_enabled);
 
@@ -1390,8 +1489,10 @@ grid_main_configure (int argc, char **argv)
 	hc_resolver_qualify (resolver, service_is_ok);
 	hc_resolver_notify (resolver, service_invalidate);
 	shard_resolver = shard_resolver_create();
+	list_prefetch_pool = g_thread_pool_new(list_prefetch_worker, NULL,
+			proxy_list_prefetch_threads, FALSE, NULL);
 
-	srv_registered = _push_queue_create ();
+	srv_registered = _registered_create ();
 
 	upstream_gtq = grid_task_queue_create ("upstream");
 
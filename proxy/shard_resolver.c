@@ -145,6 +145,52 @@ shard_resolver_get_cached(struct shard_resolver_s *resolver,
 	return result;
 }
 
+GSList*
+shard_resolver_get_cached_range(struct shard_resolver_s *resolver,
+		struct oio_url_s *url, guint max)
+{
+	if (!resolver || !resolver->roots || !url || !max) {
+		return NULL;
+	}
+	const gchar *root_cid = oio_url_get(url, OIOURL_HEXID);
+	const gchar *path = oio_url_get(url, OIOURL_PATH);
+	if (!root_cid || !path) {
+		return NULL;
+	}
+
+	GSList *result = NULL;
+	gpointer search = _bean_create(&descr_struct_SHARD_RANGE);
+	SHARD_RANGE_set2_lower(search, path);
+	SHARD_RANGE_set2_upper(search, path);
+
+	g_mutex_lock(&resolver->lock);
+	struct lru_tree_s *shards = lru_tree_get(resolver->roots, root_cid);
+	gpointer shard = shards ? lru_tree_get(shards, search) : NULL;
+	for (guint i = 0; shard && i < max; i++) {
+		result = g_slist_prepend(result, _bean_dup(shard));
+		GString *upper = SHARD_RANGE_get_upper(shard);
+		if (!upper->len) {
+			break;
+		}
+		/* HACK: "\x01" is the (UTF-8 encoded) first unicode, the next shard
+		 * is the one managing the first path after the upper bound. */
+		gchar *next_path = g_strdup_printf("%s\x01", upper->str);
+		SHARD_RANGE_set2_lower(search, next_path);
+		SHARD_RANGE_set2_upper(search, next_path);
+		g_free(next_path);
+		gpointer next = lru_tree_get(shards, search);
+		/* Only follow contiguous ranges */
+		if (next && strcmp(SHARD_RANGE_get_lower(next)->str, upper->str)) {
+			next = NULL;
+		}
+		shard = next;
+	}
+	g_mutex_unlock(&resolver->lock);
+	_bean_clean(search);
+
+	return g_slist_reverse(result);
+}
+
 void
 shard_resolver_store(struct shard_resolver_s *resolver,
 		struct oio_url_s *url, gpointer shard)
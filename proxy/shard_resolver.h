@@ -27,6 +27,12 @@ struct shard_resolver_s* shard_resolver_create(void);
 void shard_resolver_destroy(struct shard_resolver_s *resolver);
 gpointer shard_resolver_get_cached(
 		struct shard_resolver_s *resolver, struct oio_url_s *url);
+/* Get copies of the cached shard managing the path of the URL, followed by
+ * the cached shards contiguous to it, in the order of their ranges. At most
+ * <max> shards are returned, the chain stops at the first gap in the cache.
+ * Returns NULL if the path is not managed by a cached shard. */
+GSList* shard_resolver_get_cached_range(
+		struct shard_resolver_s *resolver, struct oio_url_s *url, guint max);
 void shard_resolver_store(struct shard_resolver_s *resolver,
 		struct oio_url_s *url, gpointer shard);
 void shard_resolver_forget(struct shard_resolver_s *resolver,
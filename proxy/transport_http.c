@@ -22,10 +22,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <metautils/lib/metautils.h>
 #include <metautils/lib/common_variables.h>
+#include <server/server_variables.h>
 #include <server/slab.h>
 #include <server/network_server.h>
 
 #include "transport_http.h"
+#include "http_parser.h"
 
 struct transport_client_context_s
 {
@@ -51,219 +53,6 @@ static int http_notify_input(struct network_client_s *clt);
 
 //------------------------------------------------------------------------------
 
-enum http_parser_step_e
-{
-	STEP_FIRST_R0, STEP_FIRST_N0,
-	STEP_SEP_R0, STEP_SEP_N0,
-	STEP_HEADERS_R0, STEP_HEADERS_N0,
-	STEP_BODY_ASIS
-};
-
-struct http_parser_s
-{
-	enum http_parser_step_e step;
-	GError *error;
-	GString *buf;
-
-	gint64 content_read;
-	gint64 content_length;
-	void (*command_provider)(const gchar *req, const gchar *sel, const gchar *ver);
-	void (*header_provider)(const gchar *name, const gchar *value);
-	void (*body_provider)(const guint8 *data, gsize data_len);
-};
-
-struct http_parsing_result_s
-{
-	enum { HPRC_SUCCESS = 0, HPRC_MORE, HPRC_ERROR } status;
-};
-
-static void
-gstr_chomp(GString *gstr)
-{
-	if (!gstr)
-		return;
-	gchar *start, *end;
-	start = gstr->str;
-	end = start + gstr->len;
-	while (end > start && (*(end-1) == '\n' || *(end-1) == '\r'))
-		*(--end) = '\0';
-}
-
-static gboolean
-_manage_and_renew_command(struct http_parser_s *parser, GString *buf)
-{
-	gchar *cmd, *selector, *version;
-
-	if (!buf->len)
-		return FALSE;
-
-	gstr_chomp(buf);
-	cmd = buf->str;
-	selector = strchr(cmd, ' ');
-	if (!selector)
-		return FALSE;
-	*(selector++) = '\0';
-	version = strrchr(selector, ' ');
-	if (!version)
-		return FALSE;
-	*(version++) = '\0';
-
-	if (parser->command_provider)
-		parser->command_provider(cmd, selector, version);
-
-	g_string_set_size(buf, 0);
-	return TRUE;
-}
-
-static gboolean
-_manage_and_renew_header(struct http_parser_s *parser, GString *buf)
-{
-	if (!buf->len)
-		return TRUE;
-
-	gstr_chomp(buf);
-	gchar *header = buf->str;
-	gchar *sep = strchr(header, ':');
-	if (!sep)
-		return FALSE;
-	*(sep++) = '\0';
-	if (*(sep++) != ' ')
-		return FALSE;
-
-	oio_str_lower (header);
-	if (*header == 'c' && !strcmp(header, "content-length"))
-		parser->content_length = g_ascii_strtoll(sep, NULL, 10);
-
-	if (parser->header_provider)
-		parser->header_provider(header, sep);
-
-	g_string_set_size(buf, 0);
-	return TRUE;
-}
-
-static struct http_parsing_result_s
-http_parse(struct http_parser_s *parser, const guint8 *data, gsize available)
-{
-	gsize consumed = 0;
-
-	struct http_parsing_result_s _build_rc(int status, const gchar *msg) {
-		struct http_parsing_result_s rc;
-		if (msg)
-			parser->error = NEWERROR(0, "%s", msg);
-		rc.status = status;
-		return rc;
-	}
-
-	while (consumed < available) {
-		guint8 d = data[consumed];
-		gint64 max;
-		switch (parser->step) {
-
-			case STEP_FIRST_R0:
-				if (d == '\r')
-					parser->step = STEP_FIRST_N0;
-				else
-					g_string_append_c(parser->buf, d);
-				++ consumed;
-				continue;
-
-			case STEP_FIRST_N0:
-				if (d == '\n') {
-					if (!_manage_and_renew_command(parser, parser->buf))
-						return _build_rc(HPRC_ERROR, "CMD parsing error");
-					parser->step = STEP_SEP_R0;
-					++ consumed;
-					continue;
-				}
-				return _build_rc(HPRC_ERROR, "CMD parsing error");
-
-			case STEP_SEP_R0:
-				if (d == '\r')
-					parser->step = STEP_SEP_N0;
-				else {
-					if (!_manage_and_renew_header(parser, parser->buf))
-						return _build_rc(HPRC_ERROR, "HDR parsing error");
-					g_string_append_c(parser->buf, d);
-					parser->step = STEP_HEADERS_R0;
-				}
-				++ consumed;
-				continue;
-
-			case STEP_SEP_N0:
-				if (d == '\n') {
-					++ consumed;
-					if (!_manage_and_renew_header(parser, parser->buf))
-						return _build_rc(HPRC_ERROR, "HDR parsing error");
-					parser->step = STEP_BODY_ASIS;
-					if (parser->content_read >= parser->content_length)
-						return _build_rc(HPRC_SUCCESS, NULL);
-					continue;
-				}
-				return _build_rc(HPRC_ERROR, "SEP parsing error");
-
-			case STEP_HEADERS_R0:
-				if (d == '\r')
-					parser->step = STEP_HEADERS_N0;
-				else
-					g_string_append_c(parser->buf, d);
-				++ consumed;
-				continue;
-
-			case STEP_HEADERS_N0:
-				if (d == '\n') {
-					parser->step = STEP_SEP_R0;
-					++ consumed;
-					continue;
-				}
-				return _build_rc(HPRC_ERROR, "HDR parsing error");
-
-			case STEP_BODY_ASIS:
-				max = available - consumed;
-				if (max > (parser->content_length - parser->content_read))
-					max = parser->content_length - parser->content_read;
-				if (parser->body_provider)
-					parser->body_provider(data+consumed, max);
-				consumed += max;
-				parser->content_read += max;
-
-				if (parser->content_read >= parser->content_length)
-					return _build_rc(HPRC_SUCCESS, NULL);
-				continue;
-		}
-	}
-
-	return _build_rc(HPRC_MORE, NULL);
-}
-
-static void
-http_parser_reset(struct http_parser_s *parser)
-{
-	parser->step = STEP_FIRST_R0;
-	g_string_set_size(parser->buf, 0);
-	parser->content_read = 0;
-	parser->content_length = -1;
-	if (parser->error)
-		g_clear_error(&parser->error);
-}
-
-static struct http_parser_s*
-http_parser_create(void)
-{
-	struct http_parser_s *parser = g_malloc0(sizeof(struct http_parser_s));
-	parser->buf = g_string_sized_new(1024);
-	http_parser_reset(parser);
-	return parser;
-}
-
-static void
-http_parser_destroy(struct http_parser_s *parser)
-{
-	if (!parser)
-		return;
-	g_string_free(parser->buf, TRUE);
-	g_free(parser);
-}
-
 static struct http_request_s *
 http_request_create(struct network_client_s *client)
 {
@@ -385,6 +174,8 @@ static GError *
 http_manage_request(struct req_ctx_s *r)
 {
 	gboolean finalized = 0;
+	gboolean chunked = FALSE;
+	gsize chunked_len = 0;
 	int code = HTTP_CODE_INTERNAL_ERROR;
 	gchar *msg = NULL, *access = NULL;
 	GTree *headers = NULL;
@@ -434,19 +225,23 @@ http_manage_request(struct req_ctx_s *r)
 		return set_body_bytes (g_string_free_to_bytes (gstr));
 	}
 
-	void finalize(void) {
-		EXTRA_ASSERT(!finalized);
-		finalized = TRUE;
+	gboolean is_http11(void) {
+		return 0 == g_ascii_strcasecmp("HTTP/1.1", r->request->version);
+	}
 
+	/* With no <body_len>, the body is sent in chunks (HTTP/1.1) or until
+	 * the connection is closed (HTTP/1.0) */
+	void send_head(gssize body_len) {
 		GString *buf = g_string_sized_new(256);
 
 		// Set the status line
 		g_string_append_printf(buf, "%s %d %s\r\n", r->request->version, code, msg);
 
-		if (0 == g_ascii_strcasecmp("HTTP/1.1", r->request->version)) {
+		if (is_http11()) {
 			// Manage the "Connection" header of http/1.1
 			gchar *v = g_tree_lookup(r->request->tree_headers, "connection");
-			if (v && 0 == g_ascii_strcasecmp("Keep-Alive", v)) {
+			if (v ? 0 == g_ascii_strcasecmp("Keep-Alive", v)
+					: server_http_keepalive) {
 				g_string_append_static(buf, "Connection: Keep-Alive\r\n");
 				r->close_after_request = FALSE;
 			}
@@ -456,8 +251,6 @@ http_manage_request(struct req_ctx_s *r)
 			}
 		}
 
-		gsize body_len = body ? g_bytes_get_size(body) : 0;
-
 		// Add body-related headers
 		if (body_len) {
 			if (content_type) {
@@ -467,17 +260,78 @@ http_manage_request(struct req_ctx_s *r)
 				g_string_append_static(buf, "\r\n");
 			}
 		}
-		g_string_append_printf(buf, "Content-Length: %"G_GSIZE_FORMAT"\r\n", body_len);
+		if (body_len >= 0) {
+			g_string_append_printf(buf,
+					"Content-Length: %"G_GSSIZE_FORMAT"\r\n", body_len);
+		} else if (is_http11()) {
+			g_string_append_static(buf, "Transfer-Encoding: chunked\r\n");
+		} else {
+			r->close_after_request = TRUE;
+		}
 
 		// Add Custom headers
 		g_tree_foreach(headers, sender, buf);
 
 		// Finalize and send the headers
 		g_string_append_static(buf, "\r\n");
+		network_client_send_slab(r->client, data_slab_make_gstr(buf));
+	}
+
+	void send_chunk(GBytes *gb) {
+		EXTRA_ASSERT(chunked);
+		EXTRA_ASSERT(!finalized);
+		const gsize len = g_bytes_get_size(gb);
+		if (!len) {
+			g_bytes_unref(gb);
+			return;
+		}
+		chunked_len += len;
+		sock_set_cork(r->client->fd, TRUE);
+		if (is_http11()) {
+			gchar size[24];
+			gint l = g_snprintf(size, sizeof(size), "%"G_GSIZE_MODIFIER"x\r\n", len);
+			network_client_send_slab(r->client,
+					data_slab_make_buffer((guint8*)g_memdup(size, l), l));
+		}
+		network_client_send_slab(r->client, data_slab_make_gbytes(gb));
+		if (is_http11()) {
+			network_client_send_slab(r->client,
+					data_slab_make_static_string("\r\n"));
+		}
+		sock_set_cork(r->client->fd, FALSE);
+	}
+
+	void start_chunked(void) {
+		EXTRA_ASSERT(!finalized);
+		EXTRA_ASSERT(!chunked);
+		send_head(-1);
+		chunked = TRUE;
+		if (body) {
+			GBytes *first = body;
+			body = NULL;
+			send_chunk(first);
+		}
+	}
+
+	void finalize(void) {
+		EXTRA_ASSERT(!finalized);
+		finalized = TRUE;
+
+		if (chunked) {
+			if (is_http11()) {
+				network_client_send_slab(r->client,
+						data_slab_make_static_string("0\r\n\r\n"));
+			}
+			_access_log(r, code, chunked_len, access);
+			return;
+		}
+
+		gsize body_len = body ? g_bytes_get_size(body) : 0;
+
 		if (body) {
 			sock_set_cork(r->client->fd, TRUE);
 		}
-		network_client_send_slab(r->client, data_slab_make_gstr(buf));
+		send_head(body_len);
 
 		// Now send the body
 		if (body) {
@@ -510,7 +364,14 @@ http_manage_request(struct req_ctx_s *r)
 	}
 
 	void final_error(int c_, const char *m_) {
-		if (!finalized) {
+		if (!finalized && chunked) {
+			/* The status is already gone, the client can only notice the
+			 * error with the lack of final chunk */
+			finalized = TRUE;
+			r->close_after_request = TRUE;
+			_access_log(r, c_, chunked_len, access);
+			cleanup();
+		} else if (!finalized) {
 			set_body_bytes(NULL);
 			set_status(c_, m_);
 			finalize();
@@ -528,6 +389,8 @@ http_manage_request(struct req_ctx_s *r)
 		.add_header_gstr = add_header_gstr,
 		.set_body_bytes = set_body_bytes,
 		.set_body_gstr = set_body_gstr,
+		.start_chunked = start_chunked,
+		.send_chunk = send_chunk,
 		.finalize = finalize,
 		.access_tail = access_tail,
 		.no_access = no_access,
@@ -567,14 +430,15 @@ http_notify_input(struct network_client_s *clt)
 {
 	struct req_ctx_s r = {0};
 
-	void command_provider(const gchar *c, const gchar *s, const gchar *v) {
-		r.request->cmd = g_ascii_strup(c, -1);
-		r.request->req_uri = g_strdup(s);
-		r.request->version = g_ascii_strup(v, -1);
+	void command_provider(const gchar *c, gsize cl, const gchar *s, gsize sl,
+			const gchar *v, gsize vl) {
+		r.request->cmd = g_ascii_strup(c, cl);
+		r.request->req_uri = g_strndup(s, sl);
+		r.request->version = g_ascii_strup(v, vl);
 	}
-	void header_provider(const gchar *k, const gchar *v) {
-		/* 'k' should be already lowercase */
-		g_tree_replace(r.request->tree_headers, g_strdup(k), g_strdup(v));
+	void header_provider(const gchar *k, gsize kl, const gchar *v, gsize vl) {
+		g_tree_replace(r.request->tree_headers,
+				g_ascii_strdown(k, kl), g_strndup(v, vl));
 	}
 	void body_provider(const guint8 *data, gsize data_len) {
 		g_byte_array_append(r.request->body, data, (guint)data_len);
@@ -603,22 +467,18 @@ http_notify_input(struct network_client_s *clt)
 			continue;
 		}
 
-		guint8 *data = NULL;
-		gsize data_size = G_MAXSIZE;
-
-		if (!data_slab_consume(slab, &data, &data_size)) {
-			data_slab_free(slab);
-			continue;
-		}
-
-		if (!data || !data_size) {
-			data_slab_free(slab);
-			continue;
-		}
+		/* Parse the data in place, and only consume what the parser used:
+		 * the rest may belong to the next request on the connection. */
+		EXTRA_ASSERT(slab->type == STYPE_BUFFER);
+		guint8 *data = slab->data.buffer.buff + slab->data.buffer.start;
+		gsize data_size = data_slab_size(slab);
+		gsize consumed = 0;
 
-		struct http_parsing_result_s rc = http_parse(parser, data, data_size);
+		enum http_parser_rc_e rc =
+			http_parser_feed(parser, data, data_size, &consumed);
+		data_slab_consume(slab, &data, &consumed);
 
-		if (rc.status == HPRC_SUCCESS) {
+		if (rc == HPRC_SUCCESS) {
 
 			// Important times are now known.
 			// First, the last chunk of data received;
@@ -631,6 +491,8 @@ http_notify_input(struct network_client_s *clt)
 			http_parser_reset(parser);
 			http_request_clean(r.request);
 			r.request = r.context->request = http_request_create(r.client);
+			r.close_after_request = TRUE;
+			r.access_disabled = FALSE;
 
 			if (err) {
 				GRID_INFO("Request management error: %d %s",
@@ -647,8 +509,16 @@ http_notify_input(struct network_client_s *clt)
 				done = TRUE;
 			}
 		}
-		else if (rc.status == HPRC_ERROR) {
-			GRID_DEBUG("Request parsing error");
+		else if (rc == HPRC_ERROR) {
+			GRID_DEBUG("Request parsing error: (%d) %s",
+					parser->error->code, parser->error->message);
+			/* Tell the client why, the connection cannot be reused */
+			GString *reply = g_string_sized_new(128);
+			g_string_printf(reply, "HTTP/1.1 %d %s\r\n"
+					"Connection: close\r\n"
+					"Content-Length: 0\r\n\r\n",
+					parser->error->code, parser->error->message);
+			network_client_send_slab(clt, data_slab_make_gstr(reply));
 			network_client_allow_input(clt, FALSE);
 			network_client_close_output(clt, 0);
 			done = TRUE;
@@ -48,6 +48,12 @@ struct http_reply_ctx_s
 	void (*set_body_gstr) (GString *gstr);
 	void (*set_body_bytes) (GBytes *bytes);
 
+	/* Send the status and the headers now, then let the body follow with
+	 * send_chunk() until finalize() is called. The body set before, if
+	 * any, is the first chunk. */
+	void (*start_chunked) (void);
+	void (*send_chunk) (GBytes *bytes);
+
 	void (*finalize) (void);
 	void (*access_tail) (const char *fmt, ...);
 	void (*no_access) (void);
@@ -22,7 +22,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <stdlib.h>
 
 #include <metautils/lib/metautils.h>
-#include <core/lrutree.h>
+#include <core/lruhash.h>
 #include <core/oioerrors.h>
 #include <meta0v2/meta0_remote.h>
 #include <meta1v2/meta1_remote.h>
@@ -30,8 +30,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "hc_resolver.h"
 
-struct lru_tree_s;
-
 struct cached_element_s
 {
 	guint32 count_elements;
@@ -40,9 +38,8 @@ struct cached_element_s
 
 struct hc_resolver_s
 {
-	GMutex lock;
-	struct lru_tree_s *services;
-	struct lru_tree_s *csm0;
+	struct lru_hash_s *services;
+	struct lru_hash_s *csm0;
 	enum hc_resolver_flags_e flags;
 
 	/* called with the IP:PORT string */
@@ -117,15 +114,13 @@ hc_resolver_create(hc_resolver_m0locate_f locate)
 
 	struct hc_resolver_s *resolver = g_malloc0(sizeof(struct hc_resolver_s));
 
-	resolver->csm0 = lru_tree_create((GCompareFunc)hashstr_quick_cmp,
-			g_free, g_free, 0);
+	resolver->csm0 = lru_hash_create(hashstr_quick_hash, hashstr_quick_equal,
+			g_free, g_free, 0, LRU_HASH_SHARDS_DEFAULT);
 
-	resolver->services = lru_tree_create((GCompareFunc)hashstr_quick_cmp,
-			g_free, g_free, 0);
+	resolver->services = lru_hash_create(hashstr_quick_hash,
+			hashstr_quick_equal, g_free, g_free, 0, LRU_HASH_SHARDS_DEFAULT);
 
 	resolver->locate_m0 = locate;
-
-	g_mutex_init(&resolver->lock);
 	return resolver;
 }
 
@@ -160,30 +155,22 @@ hc_resolver_destroy(struct hc_resolver_s *r)
 	if (!r)
 		return;
 	if (r->csm0)
-		lru_tree_destroy(r->csm0);
+		lru_hash_destroy(r->csm0);
 	if (r->services)
-		lru_tree_destroy(r->services);
-	g_mutex_clear(&r->lock);
+		lru_hash_destroy(r->services);
 	g_free(r);
 }
 
 static gchar **
-hc_resolver_get_cached(struct hc_resolver_s *r, struct lru_tree_s *lru,
+hc_resolver_get_cached(struct hc_resolver_s *r UNUSED, struct lru_hash_s *lru,
 		const struct hashstr_s *k)
 {
-	gchar **result = NULL;
-	struct cached_element_s *elt;
-
-	g_mutex_lock(&r->lock);
-	if (NULL != (elt = lru_tree_get(lru, k)))
-		result = hc_resolver_element_extract(elt);
-	g_mutex_unlock(&r->lock);
-
-	return result;
+	/* The element is unpacked under the lock of its shard */
+	return lru_hash_get(lru, k, (GBoxedCopyFunc)hc_resolver_element_extract);
 }
 
 static void
-hc_resolver_store(struct hc_resolver_s *r, struct lru_tree_s *lru,
+hc_resolver_store(struct hc_resolver_s *r UNUSED, struct lru_hash_s *lru,
 		const struct hashstr_s *key, const char * const *v)
 {
 	if (!v || !*v)
@@ -194,20 +181,15 @@ hc_resolver_store(struct hc_resolver_s *r, struct lru_tree_s *lru,
 	struct cached_element_s *elt = hc_resolver_element_create(v);
 	struct hashstr_s *k = hashstr_dup(key);
 
-	g_mutex_lock(&r->lock);
-	lru_tree_insert(lru, k, elt);
-	g_mutex_unlock(&r->lock);
+	lru_hash_insert(lru, k, elt);
 }
 
 static void
-hc_resolver_forget(struct hc_resolver_s *r, struct lru_tree_s *lru,
+hc_resolver_forget(struct hc_resolver_s *r UNUSED, struct lru_hash_s *lru,
 		const struct hashstr_s *k)
 {
-	if (lru) {
-		g_mutex_lock(&r->lock);
-		lru_tree_remove(lru, k);
-		g_mutex_unlock(&r->lock);
-	}
+	if (lru)
+		lru_hash_remove(lru, k);
 }
 
 static gboolean
@@ -217,15 +199,12 @@ _match_prefix(const struct hashstr_s *key, gpointer val UNUSED, const gchar *pre
 }
 
 static void
-hc_resolver_forget_prefix(struct hc_resolver_s *r, struct lru_tree_s *lru,
-		const gchar *prefix)
+hc_resolver_forget_prefix(struct hc_resolver_s *r UNUSED,
+		struct lru_hash_s *lru, const gchar *prefix)
 {
-	if (lru) {
-		g_mutex_lock(&r->lock);
-		lru_tree_remove_matching(
+	if (lru)
+		lru_hash_remove_matching(
 				lru, (GTraverseFunc)_match_prefix, (gpointer)prefix);
-		g_mutex_unlock(&r->lock);
-	}
 }
 
 /* ------------------------------------------------------------------------- */
@@ -604,15 +583,13 @@ hc_decache_reference_type(struct hc_resolver_s *r, const char *srvtype)
 }
 
 static guint
-_LRU_expire(struct hc_resolver_s *r, struct lru_tree_s *l, gint64 ttl)
+_LRU_expire(struct hc_resolver_s *r, struct lru_hash_s *l, gint64 ttl)
 {
 	EXTRA_ASSERT(r != NULL);
 	guint count = 0;
-	g_mutex_lock(&r->lock);
 	const gint64 now = oio_ext_monotonic_time();
 	if (ttl > 0)
-		count = lru_tree_remove_older(l, OLDEST(now, ttl));
-	g_mutex_unlock(&r->lock);
+		count = lru_hash_remove_older(l, OLDEST(now, ttl));
 	return count;
 }
 
@@ -642,13 +619,11 @@ hc_resolver_tell(struct hc_resolver_s *r, struct oio_url_s *url,
 }
 
 static guint
-_LRU_purge(struct hc_resolver_s *r, struct lru_tree_s *l, guint max)
+_LRU_purge(struct hc_resolver_s *r UNUSED, struct lru_hash_s *l, guint max)
 {
 	guint count = 0;
-	g_mutex_lock(&r->lock);
 	if (max > 0)
-		count = lru_tree_remove_exceeding(l, max);
-	g_mutex_unlock(&r->lock);
+		count = lru_hash_remove_exceeding(l, max);
 	return count;
 }
 
@@ -661,28 +636,24 @@ hc_resolver_purge(struct hc_resolver_s *r)
 }
 
 static void
-_lru_flush(struct lru_tree_s *lru)
+_lru_flush(struct lru_hash_s *lru)
 {
 	if (!lru) return;
-	lru_tree_remove_exceeding(lru, 0);
+	lru_hash_remove_exceeding(lru, 0);
 }
 
 void
 hc_resolver_flush_csm0(struct hc_resolver_s *r)
 {
 	EXTRA_ASSERT(r != NULL);
-	g_mutex_lock(&r->lock);
 	_lru_flush(r->csm0);
-	g_mutex_unlock(&r->lock);
 }
 
 void
 hc_resolver_flush_services(struct hc_resolver_s *r)
 {
 	EXTRA_ASSERT(r != NULL);
-	g_mutex_lock(&r->lock);
 	_lru_flush(r->services);
-	g_mutex_unlock(&r->lock);
 }
 
 void
@@ -690,13 +661,11 @@ hc_resolver_info(struct hc_resolver_s *r, struct hc_resolver_stats_s *s)
 {
 	EXTRA_ASSERT(s != NULL);
 	EXTRA_ASSERT(r != NULL);
-	g_mutex_lock(&r->lock);
 	s->csm0.max = oio_resolver_m0cs_default_max;
 	s->csm0.ttl = oio_resolver_m0cs_default_ttl;
-	s->csm0.count = lru_tree_count(r->csm0);
+	s->csm0.count = lru_hash_count(r->csm0);
 	s->services.max = oio_resolver_srv_default_max;
 	s->services.ttl = oio_resolver_srv_default_ttl;
-	s->services.count = lru_tree_count(r->services);
-	g_mutex_unlock(&r->lock);
+	s->services.count = lru_hash_count(r->services);
 }
 
@@ -49,6 +49,11 @@ struct endpoint_s
 	unsigned int magic;
 	int fd;
 	int fd_udp;
+	/* One listening socket per reactor, fdv[0] being fd. Only INET endpoints
+	 * may have several sockets (thanks to SO_REUSEPORT), the other reactors
+	 * have -1 for UNIX endpoints. */
+	int *fdv;
+	guint nb_fdv;
 	int port_real;
 	int port_cfg;
 	guint32 flags;
@@ -57,21 +62,45 @@ struct endpoint_s
 	gchar url[1];
 };
 
+/* An event loop, with its own epoll set, its own listening sockets, its own
+ * clients and its own pool of workers. A connection accepted by a reactor
+ * stays managed by that reactor until it is closed. */
+struct network_reactor_s
+{
+	struct network_server_s *server;
+	guint index;
+
+	struct network_client_s *first;
+
+	GThread *thread;
+	GThreadPool *pool;
+
+	GAsyncQueue *queue_monitor; /* from the workers to the reactor thread */
+
+	int eventfd;
+	int epollfd;
+
+	volatile guint cnx_clients;
+	guint64 events;
+	volatile guint stalls;
+
+	GQuark gq_gauge_queue;
+	GQuark gq_counter_events;
+	GQuark gq_counter_stalls;
+};
+
 struct network_server_s
 {
 	struct endpoint_s **endpointv;
 
-	struct network_client_s *first;
+	struct network_reactor_s **reactorv;
+	guint nb_reactors;
 
 	statsd_link *statsd_client;
 
 	GThread *thread_udp;
-	GThread *thread_tcp;
-	GThreadPool *pool_tcp;
 	GThreadPool *pool_udp;
 
-	GAsyncQueue *queue_monitor; /* from the workers to the events_thread */
-
 	GMutex lock_threads;
 
 	guint64 cnx_accept;
@@ -83,9 +112,11 @@ struct network_server_s
 	GQuark gq_gauge_cnx_current;
 	GQuark gq_counter_cnx_accept;
 	GQuark gq_counter_cnx_close;
+	GQuark gq_counter_cnxpool_hits;
+	GQuark gq_counter_cnxpool_misses;
+	GQuark gq_counter_cnxpool_evictions;
+	GQuark gq_gauge_cnxpool_idle;
 
-	int eventfd;
-	int epollfd;
 	volatile gboolean flag_continue;
 	gboolean udp_allowed;
 
@@ -60,11 +60,12 @@ static gboolean _endpoint_is_INET6 (struct endpoint_s *u);
 static gboolean _endpoint_is_INET4 (struct endpoint_s *u);
 static gboolean _endpoint_is_INET (struct endpoint_s *u);
 
-static GError * _endpoint_open (struct endpoint_s *u, gboolean udp_allowed);
+static GError * _endpoint_open (struct endpoint_s *u, gboolean udp_allowed,
+		guint nb_reactors);
 static void _endpoint_close (struct endpoint_s *u);
 
 static struct network_client_s* _endpoint_accept_one(
-		struct network_server_s *srv, const struct endpoint_s *e);
+		struct network_reactor_s *reactor, const struct endpoint_s *e, int fd);
 
 static void _client_clean(struct network_server_s *srv,
 		struct network_client_s *client);
@@ -75,14 +76,14 @@ static gboolean _client_has_pending_output(struct network_client_s *client);
 
 static gboolean _client_ready_for_output(struct network_client_s *client);
 
-static void _client_remove_from_monitored(struct network_server_s *srv,
+static void _client_remove_from_monitored(struct network_reactor_s *reactor,
 		struct network_client_s *clt);
 
-static void _client_add_to_monitored(struct network_server_s *srv,
+static void _client_add_to_monitored(struct network_reactor_s *reactor,
 		struct network_client_s *clt);
 
 static void _cb_tcp_worker(struct network_client_s *clt,
-		struct network_server_s *srv);
+		struct network_reactor_s *reactor);
 
 static void _manage_udp_task(struct network_client_s *clt,
 		struct network_server_s *srv);
@@ -111,12 +112,14 @@ _client_send_pending_output(struct network_client_s *client)
 }
 
 static int
-_cnx_notify_accept(struct network_server_s *srv)
+_cnx_notify_accept(struct network_reactor_s *reactor)
 {
 	int inxs = EXCESS_NONE;
+	struct network_server_s *srv = reactor->server;
 	g_mutex_lock(&srv->lock_threads);
 	++ srv->cnx_accept;
 	++ srv->cnx_clients;
+	++ reactor->cnx_clients;
 	if (srv->cnx_clients > srv->cnx_max)
 		inxs = EXCESS_HARD;
 	g_mutex_unlock(&srv->lock_threads);
@@ -124,11 +127,14 @@ _cnx_notify_accept(struct network_server_s *srv)
 }
 
 static void
-_cnx_notify_close(struct network_server_s *srv)
+_cnx_notify_close(struct network_reactor_s *reactor)
 {
+	struct network_server_s *srv = reactor->server;
 	g_mutex_lock(&srv->lock_threads);
 	EXTRA_ASSERT(srv->cnx_clients > 0);
+	EXTRA_ASSERT(reactor->cnx_clients > 0);
 	-- srv->cnx_clients;
+	-- reactor->cnx_clients;
 	++ srv->cnx_close;
 	g_mutex_unlock(&srv->lock_threads);
 }
@@ -229,15 +235,42 @@ network_server_reconfigure(struct network_server_s *srv)
 		return (i<=0 || i>G_MAXINT) ? -1 : (gint)i;
 	}
 
-	g_thread_pool_set_max_threads(
-			srv->pool_tcp, _map(server_threadpool_max_tcp), NULL);
+	/* Each reactor gets its share of the TCP workers */
+	guint max_tcp = server_threadpool_max_tcp;
+	if (max_tcp > 0 && srv->nb_reactors > 1)
+		max_tcp = (max_tcp + srv->nb_reactors - 1) / srv->nb_reactors;
+	for (guint i = 0; i < srv->nb_reactors; i++) {
+		struct network_reactor_s *reactor = srv->reactorv[i];
+		if (reactor->pool)
+			g_thread_pool_set_max_threads(reactor->pool, _map(max_tcp), NULL);
+	}
 
 	g_thread_pool_set_max_threads(
 			srv->pool_udp, _map(server_threadpool_max_udp), NULL);
 }
 
-struct network_server_s *
-network_server_init(void)
+static void
+_reactor_clean(struct network_reactor_s *reactor)
+{
+	if (!reactor)
+		return;
+	if (reactor->thread != NULL)
+		g_error("Event thread not joined: reactor %u", reactor->index);
+	if (reactor->pool) {
+		g_thread_pool_free(reactor->pool, FALSE, TRUE);
+		reactor->pool = NULL;
+	}
+	metautils_pclose(&(reactor->eventfd));
+	metautils_pclose(&(reactor->epollfd));
+	if (reactor->queue_monitor) {
+		g_async_queue_unref(reactor->queue_monitor);
+		reactor->queue_monitor = NULL;
+	}
+	g_free(reactor);
+}
+
+static struct network_reactor_s *
+_reactor_create(struct network_server_s *srv, guint index)
 {
 	int efd;
 	if ((efd = eventfd(0, EFD_NONBLOCK)) < 0) {
@@ -246,32 +279,97 @@ network_server_init(void)
 		return NULL;
 	}
 
+	struct network_reactor_s *reactor = g_malloc0(sizeof(*reactor));
+	reactor->server = srv;
+	reactor->index = index;
+	reactor->eventfd = efd;
+	reactor->epollfd = epoll_create1(EPOLL_CLOEXEC);
+	if (reactor->epollfd < 0) {
+		GRID_ERROR("epoll creation failure: (%d) %s",
+				errno, strerror(errno));
+		_reactor_clean(reactor);
+		return NULL;
+	}
+	reactor->queue_monitor = g_async_queue_new();
+
+	gchar tmp[64];
+	g_snprintf(tmp, sizeof(tmp), "gauge reactor.%u.queue", index);
+	reactor->gq_gauge_queue = g_quark_from_string(tmp);
+	g_snprintf(tmp, sizeof(tmp), "counter reactor.%u.events", index);
+	reactor->gq_counter_events = g_quark_from_string(tmp);
+	g_snprintf(tmp, sizeof(tmp), "counter reactor.%u.stalls", index);
+	reactor->gq_counter_stalls = g_quark_from_string(tmp);
+
+	/* no limit at the creation, network_server_reconfigure() will
+	 * supersede it. */
+	reactor->pool = g_thread_pool_new(
+			(GFunc)_cb_tcp_worker, reactor, 0, FALSE, NULL);
+
+	GRID_DEBUG("REACTOR %u ready with epollfd[%d] eventfd[%d]",
+			index, reactor->epollfd, reactor->eventfd);
+	return reactor;
+}
+
+static guint
+_reactors_wanted(void)
+{
+	guint count = server_reactors;
+	if (!count)
+		count = g_get_num_processors();
+	return CLAMP(count, 1, 256);
+}
+
+static GError *
+_srv_create_reactors(struct network_server_s *srv)
+{
+	EXTRA_ASSERT(srv->nb_reactors == 0);
+
+	const guint count = _reactors_wanted();
+	srv->reactorv = g_malloc0(count * sizeof(struct network_reactor_s*));
+	for (guint i = 0; i < count; i++) {
+		struct network_reactor_s *reactor = _reactor_create(srv, i);
+		if (!reactor)
+			return NEWERROR(errno, "reactor creation failure");
+		srv->reactorv[srv->nb_reactors++] = reactor;
+	}
+
+	network_server_reconfigure(srv);
+	return NULL;
+}
+
+struct network_server_s *
+network_server_init(void)
+{
 	struct network_server_s *result = g_malloc0(sizeof(struct network_server_s));
 	result->flag_continue = ~0;
 	result->cnx_max = metautils_syscall_count_maxfd();
-	result->queue_monitor = g_async_queue_new();
 	result->endpointv = g_malloc0(sizeof(struct endpoint_s*));
 	g_mutex_init(&result->lock_threads);
-	result->eventfd = efd;
-	result->epollfd = epoll_create1(EPOLL_CLOEXEC);
 	result->gq_gauge_threads =      g_quark_from_static_string ("gauge thread.active");
 	result->gq_gauge_cnx_current =  g_quark_from_static_string ("gauge cnx.client");
 	result->gq_counter_cnx_accept = g_quark_from_static_string ("counter cnx.accept");
 	result->gq_counter_cnx_close =  g_quark_from_static_string ("counter cnx.close");
+	result->gq_counter_cnxpool_hits =
+		g_quark_from_static_string ("counter cnxpool.hits");
+	result->gq_counter_cnxpool_misses =
+		g_quark_from_static_string ("counter cnxpool.misses");
+	result->gq_counter_cnxpool_evictions =
+		g_quark_from_static_string ("counter cnxpool.evictions");
+	result->gq_gauge_cnxpool_idle =
+		g_quark_from_static_string ("gauge cnxpool.idle");
 
 	g_mutex_init(&result->req_mem_lock);
 
 	/* no limit at the creation ... */
-	result->pool_tcp = g_thread_pool_new(
-			(GFunc)_cb_tcp_worker, result, 0, FALSE, NULL);
 	result->pool_udp = g_thread_pool_new(
 			(GFunc)_manage_udp_task, result, 0, FALSE, NULL);
 
-	/* ... and then supersedes the limits now */
+	/* ... and then supersedes the limits now. The reactors (and their TCP
+	 * pools) are created when the servers are open, once the configuration
+	 * has been loaded. */
 	network_server_reconfigure(result);
 
-	GRID_DEBUG("SERVER ready with epollfd[%d] eventfd[%d]",
-			result->epollfd, result->eventfd);
+	GRID_DEBUG("SERVER ready");
 
 	return result;
 }
@@ -335,9 +433,12 @@ _stop_pools (struct network_server_s *srv)
 		g_thread_pool_free (srv->pool_udp, FALSE, TRUE);
 		srv->pool_udp = NULL;
 	}
-	if (srv->pool_tcp) {
-		g_thread_pool_free (srv->pool_tcp, FALSE, TRUE);
-		srv->pool_tcp = NULL;
+	for (guint i = 0; i < srv->nb_reactors; i++) {
+		struct network_reactor_s *reactor = srv->reactorv[i];
+		if (reactor->pool) {
+			g_thread_pool_free (reactor->pool, FALSE, TRUE);
+			reactor->pool = NULL;
+		}
 	}
 }
 
@@ -345,9 +446,11 @@ void
 network_server_postfork_clean(struct network_server_s *srv)
 {
 	// Threads have not been cloned during fork
-	srv->pool_tcp = NULL;
+	for (guint i = 0; i < srv->nb_reactors; i++) {
+		srv->reactorv[i]->pool = NULL;
+		srv->reactorv[i]->thread = NULL;
+	}
 	srv->pool_udp = NULL;
-	srv->thread_tcp = NULL;
 	srv->thread_udp = NULL;
 
 	network_server_clean(srv);
@@ -360,8 +463,6 @@ network_server_clean(struct network_server_s *srv)
 		return;
 
 	_stop_pools (srv);
-	if (srv->thread_tcp != NULL)
-		g_error("Event thread not joined: %s", "tcp");
 	if (srv->thread_udp != NULL)
 		g_error("Event thread not joined: %s", "udp");
 
@@ -369,6 +470,7 @@ network_server_clean(struct network_server_s *srv)
 
 	if (srv->endpointv) {
 		for (struct endpoint_s **u = srv->endpointv; *u; u++) {
+			g_free((*u)->fdv);
 			g_free(*u);
 			*u = NULL;
 		}
@@ -376,13 +478,11 @@ network_server_clean(struct network_server_s *srv)
 		srv->endpointv = NULL;
 	}
 
-	metautils_pclose(&(srv->eventfd));
-	metautils_pclose(&(srv->epollfd));
-
-	if (srv->queue_monitor) {
-		g_async_queue_unref(srv->queue_monitor);
-		srv->queue_monitor = NULL;
-	}
+	for (guint i = 0; i < srv->nb_reactors; i++)
+		_reactor_clean(srv->reactorv[i]);
+	g_free(srv->reactorv);
+	srv->reactorv = NULL;
+	srv->nb_reactors = 0;
 
 	if (srv->statsd_client) {
 		statsd_finalize(srv->statsd_client);
@@ -470,9 +570,18 @@ network_server_open_servers(struct network_server_s *srv)
 {
 	g_assert(srv != NULL);
 
+	if (!srv->nb_reactors) {
+		GError *err = _srv_create_reactors(srv);
+		if (err) {
+			g_prefix_error(&err, "reactors error: ");
+			return err;
+		}
+	}
+
 	for (struct endpoint_s **u = srv->endpointv; srv->endpointv && *u; u++) {
 		GError *err;
-		if (NULL != (err = _endpoint_open(*u, srv->udp_allowed))) {
+		if (NULL != (err = _endpoint_open(*u, srv->udp_allowed,
+						srv->nb_reactors))) {
 			g_prefix_error(&err, "url open error: ");
 			network_server_close_servers(srv);
 			return err;
@@ -480,8 +589,8 @@ network_server_open_servers(struct network_server_s *srv)
 	}
 
 	for (struct endpoint_s **u = srv->endpointv; srv->endpointv && *u; u++) {
-		GRID_DEBUG("fd=%d port=%d endpoint=%s ready", (*u)->fd,
-				(*u)->port_real, (*u)->url);
+		GRID_DEBUG("fd=%d port=%d endpoint=%s reactors=%u ready", (*u)->fd,
+				(*u)->port_real, (*u)->url, srv->nb_reactors);
 	}
 
 	return NULL;
@@ -516,20 +625,21 @@ epoll2str(int how)
 }
 
 static void
-ARM_WAKER(struct network_server_s *srv, int how)
+ARM_WAKER(struct network_reactor_s *reactor, int how)
 {
 	struct epoll_event ev;
-	ev.data.ptr = &(srv->eventfd);
+	ev.data.ptr = &(reactor->eventfd);
 	ev.events = EPOLLIN|EPOLLET|EPOLLONESHOT;
 
-	if (0 == epoll_ctl(srv->epollfd, how, srv->eventfd, &ev))
+	if (0 == epoll_ctl(reactor->epollfd, how, reactor->eventfd, &ev))
 		return;
-	GRID_DEBUG("WUP epoll_ctl(%d,%d,%s) = (%d) %s", srv->epollfd,
-			srv->eventfd, epoll2str(how), errno, strerror(errno));
+	GRID_DEBUG("WUP epoll_ctl(%d,%d,%s) = (%d) %s", reactor->epollfd,
+			reactor->eventfd, epoll2str(how), errno, strerror(errno));
 }
 
 static void
-ARM_CLIENT(struct network_server_s *srv, struct network_client_s *clt, int how)
+ARM_CLIENT(struct network_reactor_s *reactor, struct network_client_s *clt,
+		int how)
 {
 	struct epoll_event ev;
 	ev.data.ptr = clt;
@@ -537,36 +647,40 @@ ARM_CLIENT(struct network_server_s *srv, struct network_client_s *clt, int how)
 	if (clt->events & CLT_WRITE)
 		ev.events |= EPOLLOUT;
 
-	if (0 == epoll_ctl(srv->epollfd, how, clt->fd, &ev)) {
+	if (0 == epoll_ctl(reactor->epollfd, how, clt->fd, &ev)) {
 		if (how != EPOLL_CTL_DEL)
-			_client_add_to_monitored(srv, clt);
+			_client_add_to_monitored(reactor, clt);
 		return;
 	}
 
-	GRID_WARN("CLT epoll_ctl(%d,%d,%s) = (%d) %s", srv->epollfd,
+	GRID_WARN("CLT epoll_ctl(%d,%d,%s) = (%d) %s", reactor->epollfd,
 			clt->fd, epoll2str(how), errno, strerror(errno));
-	_client_clean(srv, clt);
+	_client_clean(reactor->server, clt);
 }
 
 static void
-ARM_ENDPOINT(struct network_server_s *srv, struct endpoint_s *e, int how)
+ARM_ENDPOINT(struct network_reactor_s *reactor, struct endpoint_s *e, int how)
 {
+	const int fd = e->fdv[reactor->index];
+	if (fd < 0)
+		return;
+
 	struct epoll_event ev;
 	ev.events = EPOLLIN|EPOLLET|EPOLLONESHOT;
 	ev.data.ptr = e;
-	if (0 == epoll_ctl(srv->epollfd, how, e->fd, &ev))
+	if (0 == epoll_ctl(reactor->epollfd, how, fd, &ev))
 		return;
-	GRID_DEBUG("SRV epoll_ctl(%d,%d,%s) = (%d) %s", srv->epollfd,
-			e->fd, epoll2str(how), errno, strerror(errno));
+	GRID_DEBUG("SRV epoll_ctl(%d,%d,%s) = (%d) %s", reactor->epollfd,
+			fd, epoll2str(how), errno, strerror(errno));
 }
 
 static void
-_manage_client_event(struct network_server_s *srv,
+_manage_client_event(struct network_reactor_s *reactor,
 		struct network_client_s *clt, register int ev0)
 {
-	_client_remove_from_monitored(srv, clt);
+	_client_remove_from_monitored(reactor, clt);
 
-	if (!srv->flag_continue)
+	if (!reactor->server->flag_continue)
 		clt->transport.waiting_for_close = TRUE;
 
 	ev0 = MACRO_COND(ev0 & EPOLLIN, CLT_READ, 0)
@@ -578,61 +692,79 @@ _manage_client_event(struct network_server_s *srv,
 		clt->time.evt_in = oio_ext_monotonic_time();
 
 	if (clt->events & CLT_ERROR)
-		ARM_CLIENT(srv, clt, EPOLL_CTL_DEL);
-	metautils_gthreadpool_push("TCP", srv->pool_tcp, clt);
+		ARM_CLIENT(reactor, clt, EPOLL_CTL_DEL);
+	metautils_gthreadpool_push("TCP", reactor->pool, clt);
 }
 
 static void
-_manage_endpoint_event (struct network_server_s *srv, struct endpoint_s *e)
+_manage_endpoint_event (struct network_reactor_s *reactor, struct endpoint_s *e)
 {
+	const int fd = e->fdv[reactor->index];
 	for (guint i=0; i<server_accept_batch_size ;++i) {
-		struct network_client_s *clt = _endpoint_accept_one(srv, e);
+		struct network_client_s *clt = _endpoint_accept_one(reactor, e, fd);
 		if (!clt) break;
 		if (clt->current_error)
-			_client_clean(srv, clt);
+			_client_clean(reactor->server, clt);
 		else {
-			ARM_CLIENT(srv, clt, EPOLL_CTL_ADD);
+			ARM_CLIENT(reactor, clt, EPOLL_CTL_ADD);
 		}
 	}
-	ARM_ENDPOINT(srv, e, EPOLL_CTL_MOD);
+	ARM_ENDPOINT(reactor, e, EPOLL_CTL_MOD);
 }
 
 static void
-_manage_events(struct network_server_s *srv)
+_manage_events(struct network_reactor_s *reactor)
 {
 	int erc;
 	struct epoll_event *pev, allev[server_event_batch_size];
 
-	erc = epoll_wait(srv->epollfd, allev, server_event_batch_size, 500);
+	erc = epoll_wait(reactor->epollfd, allev, server_event_batch_size, 500);
 	if (erc > 0) {
+		reactor->events += erc;
 		while (erc-- > 0) {
 			pev = allev+erc;
-			if (pev->data.ptr == &(srv->eventfd))
+			if (pev->data.ptr == &(reactor->eventfd))
 				continue;
 			if (MAGIC_ENDPOINT == *((unsigned int*)(pev->data.ptr)))
-				_manage_endpoint_event (srv, pev->data.ptr);
+				_manage_endpoint_event (reactor, pev->data.ptr);
 			else
-				_manage_client_event(srv, pev->data.ptr, pev->events);
+				_manage_client_event(reactor, pev->data.ptr, pev->events);
 		}
 	}
 
-	_drain_eventfd(srv->eventfd);
-	ARM_WAKER(srv, EPOLL_CTL_MOD);
+	_drain_eventfd(reactor->eventfd);
+	ARM_WAKER(reactor, EPOLL_CTL_MOD);
 	struct network_client_s *clt;
-	while (NULL != (clt = g_async_queue_try_pop(srv->queue_monitor))) {
+	while (NULL != (clt = g_async_queue_try_pop(reactor->queue_monitor))) {
 		EXTRA_ASSERT(clt->events != 0 && !(clt->events & CLT_ERROR));
-		ARM_CLIENT(srv, clt, EPOLL_CTL_MOD);
+		ARM_CLIENT(reactor, clt, EPOLL_CTL_MOD);
 	}
 }
 
 gboolean
 network_server_has_connections(struct network_server_s *srv)
 {
-	return srv->first != NULL;
+	for (guint i = 0; i < srv->nb_reactors; i++) {
+		if (srv->reactorv[i]->first != NULL)
+			return TRUE;
+	}
+	return FALSE;
+}
+
+guint
+network_server_count_threads(struct network_server_s *srv)
+{
+	guint count = 0;
+	for (guint i = 0; i < srv->nb_reactors; i++) {
+		struct network_reactor_s *reactor = srv->reactorv[i];
+		if (reactor->pool)
+			count += g_thread_pool_get_num_threads(reactor->pool);
+	}
+	return count;
 }
 
 static void
-_server_shutdown_inactive_connections(struct network_server_s *srv)
+_server_shutdown_inactive_connections(struct network_reactor_s *reactor)
 {
 	guint count = 0;
 	gint64 now = oio_ext_monotonic_time ();
@@ -641,22 +773,22 @@ _server_shutdown_inactive_connections(struct network_server_s *srv)
 	const gint64 tp = now - server_cnx_ttl_persist;
 
 	struct network_client_s *clt, *n;
-	for (clt=srv->first ; clt ; clt=n) {
+	for (clt=reactor->first ; clt ; clt=n) {
 		n = clt->next;
 		EXTRA_ASSERT(clt->fd >= 0);
 		if (clt->time.evt_in) {
 			if (clt->time.evt_in < ti) {
 				GRID_DEBUG("cnx %d closed: %s", clt->fd, "idle for too long");
-				_manage_client_event(srv, clt, 0);
+				_manage_client_event(reactor, clt, 0);
 				++ count;
 			} else if (clt->time.cnx < tp) {
 				GRID_DEBUG("cnx %d closed: %s", clt->fd, "open since too long");
-				_manage_client_event(srv, clt, 0);
+				_manage_client_event(reactor, clt, 0);
 				++ count;
 			}
 		} else if (clt->time.cnx < tc) { /* never input */
 			GRID_DEBUG("cnx %d closed: %s", clt->fd, "inactive since too long");
-			_manage_client_event(srv, clt, 0);
+			_manage_client_event(reactor, clt, 0);
 			++ count;
 		}
 	}
@@ -667,12 +799,13 @@ _thread_cb_events(gpointer d)
 {
 	metautils_ignore_signals();
 
-	struct network_server_s *srv = d;
+	struct network_reactor_s *reactor = d;
+	struct network_server_s *srv = reactor->server;
 	for (gint64 next = 0; srv->flag_continue ;) {
-		_manage_events(srv);
+		_manage_events(reactor);
 		gint64 now = oio_ext_monotonic_time ();
 		if (now > next) {
-			_server_shutdown_inactive_connections(srv);
+			_server_shutdown_inactive_connections(reactor);
 			next = now + 30 * G_TIME_SPAN_SECOND;
 		}
 	}
@@ -681,21 +814,21 @@ _thread_cb_events(gpointer d)
 	 * received the exit signal. They will be removed automatically from
 	 * the epoll pool.*/
 
-	GRID_INFO("Server %p waiting for its %u connections",
-			srv, srv->cnx_clients);
+	GRID_INFO("Server %p reactor %u waiting for its %u connections",
+			srv, reactor->index, reactor->cnx_clients);
 	server_cnx_ttl_never = 5 * G_TIME_SPAN_SECOND;
 	server_cnx_ttl_persist = 5 * G_TIME_SPAN_SECOND;
 	server_cnx_ttl_idle = 1 * G_TIME_SPAN_SECOND;
 
-	for (gint64 next = 0; srv->cnx_clients > 0;) {
-		_manage_events(srv);
+	for (gint64 next = 0; reactor->cnx_clients > 0;) {
+		_manage_events(reactor);
 		gint64 now = oio_ext_monotonic_time ();
 		if (now > next) {
-			_server_shutdown_inactive_connections(srv);
+			_server_shutdown_inactive_connections(reactor);
 			next = now + 1 * G_TIME_SPAN_SECOND;
 		}
 	}
-	GRID_INFO("Server %p stopping", srv);
+	GRID_INFO("Server %p reactor %u stopping", srv, reactor->index);
 
 	return d;
 }
@@ -857,22 +990,49 @@ network_server_run(struct network_server_s *srv, void (*on_reload)(void))
 		return NULL;
 	}
 
-	for (pu=srv->endpointv; srv->flag_continue && (u = *pu) ;pu++)
-		ARM_ENDPOINT(srv, u, EPOLL_CTL_ADD);
-	ARM_WAKER(srv, EPOLL_CTL_ADD);
+	for (guint i = 0; i < srv->nb_reactors; i++) {
+		struct network_reactor_s *reactor = srv->reactorv[i];
+		for (pu=srv->endpointv; srv->flag_continue && (u = *pu) ;pu++)
+			ARM_ENDPOINT(reactor, u, EPOLL_CTL_ADD);
+		ARM_WAKER(reactor, EPOLL_CTL_ADD);
+	}
 
 	if (srv->udp_allowed)
 		srv->thread_udp = g_thread_new("udp", _thread_cb_ping, srv);
-	srv->thread_tcp = g_thread_new("tcp", _thread_cb_events, srv);
+	for (guint i = 0; i < srv->nb_reactors; i++) {
+		gchar name[16];
+		g_snprintf(name, sizeof(name), "tcp-%u", i);
+		srv->reactorv[i]->thread =
+			g_thread_new(name, _thread_cb_events, srv->reactorv[i]);
+	}
 
 	while (srv->flag_continue) {
 		g_usleep(1 * G_TIME_SPAN_SECOND);
 		oio_stats_set(
 				srv->gq_gauge_threads,
-				(guint64) g_thread_pool_get_num_threads(srv->pool_tcp),
+				(guint64) network_server_count_threads(srv),
 				srv->gq_gauge_cnx_current, srv->cnx_clients,
 				srv->gq_counter_cnx_accept, srv->cnx_accept,
 				srv->gq_counter_cnx_close, srv->cnx_close);
+		for (guint i = 0; i < srv->nb_reactors; i++) {
+			struct network_reactor_s *reactor = srv->reactorv[i];
+			oio_stats_set(
+					reactor->gq_gauge_queue,
+					(guint64) g_thread_pool_unprocessed(reactor->pool),
+					reactor->gq_counter_events, reactor->events,
+					reactor->gq_counter_stalls, reactor->stalls,
+					0, 0);
+		}
+
+		/* The outgoing connections kept open by the gridd clients */
+		struct gridd_client_cnx_pool_stats_s cnxpool = {0};
+		gridd_client_cnx_pool_purge(FALSE);
+		gridd_client_cnx_pool_stats(&cnxpool);
+		oio_stats_set(
+				srv->gq_counter_cnxpool_hits, cnxpool.hits,
+				srv->gq_counter_cnxpool_misses, cnxpool.misses,
+				srv->gq_counter_cnxpool_evictions, cnxpool.evictions,
+				srv->gq_gauge_cnxpool_idle, cnxpool.idle);
 		if (main_signal_SIGHUP) {
 			main_signal_SIGHUP = FALSE;
 			if (on_reload)
@@ -884,9 +1044,12 @@ network_server_run(struct network_server_s *srv, void (*on_reload)(void))
 	GRID_INFO("Server %p waiting for its threads", srv);
 
 	/* wait for the event threads */
-	if (srv->thread_tcp) {
-		g_thread_join(srv->thread_tcp);
-		srv->thread_tcp = NULL;
+	for (guint i = 0; i < srv->nb_reactors; i++) {
+		struct network_reactor_s *reactor = srv->reactorv[i];
+		if (reactor->thread) {
+			g_thread_join(reactor->thread);
+			reactor->thread = NULL;
+		}
 	}
 	if (srv->thread_udp) {
 		g_thread_join(srv->thread_udp);
@@ -895,7 +1058,8 @@ network_server_run(struct network_server_s *srv, void (*on_reload)(void))
 
 	/* XXX(jfs): seems legit but requires exit critical path to be reviewed.
 	_stop_pools (srv); */
-	ARM_WAKER(srv, EPOLL_CTL_DEL);
+	for (guint i = 0; i < srv->nb_reactors; i++)
+		ARM_WAKER(srv->reactorv[i], EPOLL_CTL_DEL);
 
 	GRID_INFO("Server %p exiting its main loop", srv);
 	return err;
@@ -934,9 +1098,48 @@ _endpoint_close (struct endpoint_s *u)
 	}
 	if (u->fd_udp >= 0)
 		metautils_pclose(&(u->fd_udp));
+	/* The array itself is released with the endpoint, the reactors might
+	 * still be reading it. */
+	for (guint i = 1; u->fdv && i < u->nb_fdv; i++) {
+		if (u->fdv[i] >= 0)
+			metautils_pclose(&(u->fdv[i]));
+	}
+	if (u->fdv)
+		u->fdv[0] = -1;
 	u->port_real = 0;
 }
 
+/* Open the additional listening sockets for the reactors beyond the first.
+ * They share the address of the first socket, the kernel spreads the new
+ * connections among them thanks to SO_REUSEPORT. */
+static GError *
+_endpoint_open_reactors(struct endpoint_s *u, struct sockaddr_storage *ss,
+		socklen_t ss_len)
+{
+	if (_endpoint_is_INET4(u))
+		((struct sockaddr_in*)ss)->sin_port = htons(u->port_real);
+	else
+		((struct sockaddr_in6*)ss)->sin6_port = htons(u->port_real);
+
+	for (guint i = 1; i < u->nb_fdv; i++) {
+		int fd = socket_nonblock(ss->ss_family, SOCK_STREAM, 0);
+		if (fd < 0)
+			return NEWERROR(errno, "socket(tcp) = '%s'", strerror(errno));
+		u->fdv[i] = fd;
+		sock_set_reuseaddr(fd, TRUE);
+		sock_set_reuseport(fd, TRUE);
+		if (0 > bind(fd, (struct sockaddr*)ss, ss_len)) {
+			int errsave = errno;
+			return NEWERROR(errsave, "bind(tcp,%s,reactor=%u) = '%s'",
+					u->url, i, strerror(errsave));
+		}
+		sock_set_fastopen(fd);
+		if (0 > listen(fd, 32768))
+			return NEWERROR(errno, "listen() = '%s'", strerror(errno));
+	}
+	return NULL;
+}
+
 static GError *
 _checked_inet_pton(int af, const char *src, void *dst)
 {
@@ -954,13 +1157,21 @@ _checked_inet_pton(int af, const char *src, void *dst)
 }
 
 static GError *
-_endpoint_open(struct endpoint_s *u, gboolean udp_allowed)
+_endpoint_open(struct endpoint_s *u, gboolean udp_allowed, guint nb_reactors)
 {
 	EXTRA_ASSERT(u != NULL);
+	EXTRA_ASSERT(nb_reactors > 0);
 
-	struct sockaddr_storage ss = {0};
+	struct sockaddr_storage ss = {0}, ss_bind = {0};
 	socklen_t ss_len;
 
+	if (!u->fdv) {
+		u->fdv = g_malloc(nb_reactors * sizeof(int));
+		u->nb_fdv = nb_reactors;
+	}
+	for (guint i = 0; i < u->nb_fdv; i++)
+		u->fdv[i] = -1;
+
 	/* patch some socket preferences that make sense only for INET sockets */
 	if (_endpoint_is_UNIX(u)) {
 		u->port_real = 0;
@@ -1016,6 +1227,7 @@ _endpoint_open(struct endpoint_s *u, gboolean udp_allowed)
 			return err;
 	}
 
+	memcpy(&ss_bind, &ss, sizeof(ss));
 	if (0 > bind(u->fd, (struct sockaddr*)&ss, ss_len)) {
 		int errsave = errno;
 		u->port_real = 0;
@@ -1044,27 +1256,33 @@ _endpoint_open(struct endpoint_s *u, gboolean udp_allowed)
 
 	if (0 > listen(u->fd, 32768))
 		return NEWERROR(errno, "listen() = '%s'", strerror(errno));
+	u->fdv[0] = u->fd;
 
+	/* UNIX sockets cannot be shared, only the first reactor manages them */
+	if (_endpoint_is_INET(u) && u->nb_fdv > 1)
+		return _endpoint_open_reactors(u, &ss_bind, ss_len);
 	return NULL;
 }
 
 static struct network_client_s *
-_endpoint_accept_one(struct network_server_s *srv, const struct endpoint_s *e)
+_endpoint_accept_one(struct network_reactor_s *reactor,
+		const struct endpoint_s *e, int srv_fd)
 {
 	int fd;
 	struct sockaddr_storage ss;
 	socklen_t ss_len;
+	struct network_server_s *srv = reactor->server;
 
 retry:
 	memset(&ss, 0, sizeof(ss));
 	ss_len = sizeof(ss);
-	fd = accept_nonblock(e->fd, (struct sockaddr*)&ss, &ss_len);
+	fd = accept_nonblock(srv_fd, (struct sockaddr*)&ss, &ss_len);
 
 	if (0 > fd) {
 		if (errno == EINTR)
 			goto retry;
 		if (errno != EAGAIN && errno != EWOULDBLOCK)
-			GRID_WARN("fd=%d ACCEPT error ((%d) %s)", e->fd, errno, strerror(errno));
+			GRID_WARN("fd=%d ACCEPT error ((%d) %s)", srv_fd, errno, strerror(errno));
 		return NULL;
 	}
 
@@ -1075,23 +1293,23 @@ retry:
 	struct network_client_s *clt = g_slice_new0(struct network_client_s);
 	if (NULL == clt) {
 		metautils_pclose(&fd);
-		_cnx_notify_close(srv);
 		return NULL;
 	}
 
-	switch (_cnx_notify_accept(srv)) {
+	switch (_cnx_notify_accept(reactor)) {
 		case EXCESS_NONE:
 			break;
 		case EXCESS_HARD:
 			g_slice_free(struct network_client_s, clt);
 			metautils_pclose(&fd);
-			_cnx_notify_close(srv);
+			_cnx_notify_close(reactor);
 			GRID_WARN("Too many inbound connections! (max=%u)",
 					srv->cnx_max);
 			return NULL;
 	}
 
 	clt->server = srv;
+	clt->reactor = reactor;
 	clt->fd = fd;
 	grid_sockaddr_to_string((struct sockaddr*)&ss,
 			clt->peer_name, sizeof(clt->peer_name));
@@ -1110,10 +1328,12 @@ retry:
 /* Server features ---------------------------------------------------------- */
 
 static void
-_cb_tcp_worker(struct network_client_s *clt, struct network_server_s *srv)
+_cb_tcp_worker(struct network_client_s *clt, struct network_reactor_s *reactor)
 {
+	struct network_server_s *srv = reactor->server;
+
 	EXTRA_ASSERT(clt != NULL);
-	EXTRA_ASSERT(clt->server == srv);
+	EXTRA_ASSERT(clt->reactor == reactor);
 
 	if ((clt->events & CLT_ERROR) || !clt->events) {
 		_client_clean(srv, clt);
@@ -1131,6 +1351,7 @@ _cb_tcp_worker(struct network_client_s *clt, struct network_server_s *srv)
 #endif
 		const gint64 now = oio_ext_monotonic_time();
 		if (clt->time.evt_in < OLDEST(now, server_queue_max_delay)) {
+			g_atomic_int_inc(&reactor->stalls);
 			GRID_WARN("A request from %s (fd=%d) has been queued "
 					"for %"G_GINT64_FORMAT"ms (server.queue.max_delay=%"
 					G_GINT64_FORMAT"ms), closing it",
@@ -1141,6 +1362,7 @@ _cb_tcp_worker(struct network_client_s *clt, struct network_server_s *srv)
 			return;
 		}
 		if (clt->time.evt_in < OLDEST(now, server_queue_warn_delay)) {
+			g_atomic_int_inc(&reactor->stalls);
 			GRID_NOTICE("A request from %s (fd=%d) has been queued "
 					"for %"G_GINT64_FORMAT"ms "
 					"(server.queue.warn_delay=%"G_GINT64_FORMAT"ms). "
@@ -1164,9 +1386,9 @@ _cb_tcp_worker(struct network_client_s *clt, struct network_server_s *srv)
 		_client_clean(srv, clt);
 	}
 	else {
-		g_async_queue_push(srv->queue_monitor, clt);
+		g_async_queue_push(reactor->queue_monitor, clt);
 		guint64 evt_count = 1u;
-		ssize_t w = write(srv->eventfd, &evt_count, 8);
+		ssize_t w = write(reactor->eventfd, &evt_count, 8);
 		if (w != 8) {
 			GRID_WARN("event thread notification failed: (%d) %s",
 					errno, strerror(errno));
@@ -1177,15 +1399,15 @@ _cb_tcp_worker(struct network_client_s *clt, struct network_server_s *srv)
 /* Client functions --------------------------------------------------------- */
 
 static void
-_client_remove_from_monitored(struct network_server_s *srv,
+_client_remove_from_monitored(struct network_reactor_s *reactor,
 		struct network_client_s *clt)
 {
-	EXTRA_ASSERT(clt->server == srv);
+	EXTRA_ASSERT(clt->reactor == reactor);
 
-	if (srv->first == clt) {
+	if (reactor->first == clt) {
 		EXTRA_ASSERT(clt->prev == NULL);
-		if (NULL != (srv->first = clt->next))
-			srv->first->prev = NULL;
+		if (NULL != (reactor->first = clt->next))
+			reactor->first->prev = NULL;
 	}
 	else {
 		EXTRA_ASSERT(clt->prev != NULL);
@@ -1197,17 +1419,17 @@ _client_remove_from_monitored(struct network_server_s *srv,
 }
 
 static void
-_client_add_to_monitored(struct network_server_s *srv,
+_client_add_to_monitored(struct network_reactor_s *reactor,
 		struct network_client_s *clt)
 {
-	EXTRA_ASSERT(clt->server == srv);
+	EXTRA_ASSERT(clt->reactor == reactor);
 	EXTRA_ASSERT(clt->prev == NULL);
 	EXTRA_ASSERT(clt->next == NULL);
 	EXTRA_ASSERT(clt->fd >= 0);
 
-	if (NULL != (clt->next = srv->first))
+	if (NULL != (clt->next = reactor->first))
 		clt->next->prev = clt;
-	srv->first = clt;
+	reactor->first = clt;
 }
 
 static gboolean
@@ -1228,7 +1450,7 @@ _client_ready_for_output(struct network_client_s *clt)
 }
 
 static void
-_client_clean(struct network_server_s *srv, struct network_client_s *clt)
+_client_clean(struct network_server_s *srv UNUSED, struct network_client_s *clt)
 {
 	/* Notifies the upper layer the client is being exiting. */
 	if (clt->transport.notify_error)
@@ -1239,7 +1461,7 @@ _client_clean(struct network_server_s *srv, struct network_client_s *clt)
 
 	if (clt->fd >= 0) {
 		metautils_pclose(&(clt->fd));
-		_cnx_notify_close(srv);
+		_cnx_notify_close(clt->reactor);
 	}
 
 	clt->flags = clt->events = 0;
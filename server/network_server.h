@@ -24,6 +24,7 @@ License along with this library.
 # include <server/slab.h>
 
 struct network_server_s;
+struct network_reactor_s;
 struct network_client_s;
 struct network_transport_s;
 
@@ -64,6 +65,7 @@ struct network_client_s
 	int fd;
 	enum network_client_event_e events;
 	struct network_server_s *server;
+	struct network_reactor_s *reactor;
 
 	int flags;
 	struct { /* monotonic timers */
@@ -138,6 +140,10 @@ int network_server_first_udp (struct network_server_s *srv);
 
 void network_server_close_servers(struct network_server_s *srv);
 
+/** Get the number of worker threads currently running, summed over all the
+ * reactors of the server. */
+guint network_server_count_threads(struct network_server_s *srv);
+
 /** Tell if the server has pending connections (active or inactive). */
 gboolean network_server_has_connections(struct network_server_s *srv);
 
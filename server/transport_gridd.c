@@ -265,6 +265,12 @@ network_client_log_access(struct log_item_s *item)
 	if (perfdata) {
 		void __log_perfdata(gpointer key, gpointer val, gpointer udata UNUSED)
 		{
+			/* Counts are not durations */
+			if (oio_ext_is_perfdata_count((char*)key)) {
+				g_string_append_printf(gstr, "\tperfdata_%s_int:%d",
+					(char*)key, GPOINTER_TO_INT(val));
+				return;
+			}
 			double val_seconds = (double)GPOINTER_TO_INT(val)
 					/ (double)G_TIME_SPAN_SECOND;
 			g_string_append_printf(gstr, "\tperfdata_%s_float:%.6lf",
@@ -1003,6 +1009,34 @@ network_server_stats_to_prometheus(GArray *stats, GByteArray *body)
 				g_string_append_printf(labels_suffix, ",type=\"%s\"", tags[1]);
 				goto next;
 			}
+			if (strcmp(tags[0], "cnxpool") == 0) {
+				/* counter cnxpool.<hits|misses|evictions> */
+				if (g_strv_length(tags) != 2) {
+					goto error;
+				}
+				g_string_append_printf(key_suffix,
+						"client_connections_%s_total", tags[1]);
+				goto next;
+			}
+			if (strcmp(tags[0], "stmt_cache") == 0) {
+				/* counter stmt_cache.<hits|misses|evictions> */
+				if (g_strv_length(tags) != 2) {
+					goto error;
+				}
+				g_string_append_printf(key_suffix,
+						"stmt_cache_%s_total", tags[1]);
+				goto next;
+			}
+			if (strcmp(tags[0], "reactor") == 0) {
+				/* counter reactor.<index>.<events|stalls> */
+				if (g_strv_length(tags) != 3) {
+					goto error;
+				}
+				g_string_append_printf(key_suffix, "reactor_%s_total", tags[2]);
+				g_string_append_printf(labels_suffix, ",reactor=\"%s\"",
+						tags[1]);
+				goto next;
+			}
 			goto error;
 		}
 		if (strcmp(stat[0], "gauge") == 0) {
@@ -1014,6 +1048,21 @@ network_server_stats_to_prometheus(GArray *stats, GByteArray *body)
 				g_string_append_static(key_suffix, "connections_active");
 				goto next;
 			}
+			if (strcmp(stat[1], "cnxpool.idle") == 0) {
+				g_string_append_static(key_suffix, "client_connections_idle");
+				goto next;
+			}
+			if (g_str_has_prefix(stat[1], "reactor.")) {
+				/* gauge reactor.<index>.queue */
+				tags = g_strsplit(stat[1], ".", 4);
+				if (g_strv_length(tags) != 3) {
+					goto error;
+				}
+				g_string_append_printf(key_suffix, "reactor_%s_length", tags[2]);
+				g_string_append_printf(labels_suffix, ",reactor=\"%s\"",
+						tags[1]);
+				goto next;
+			}
 			goto error;
 		}
 error:
@@ -45,6 +45,10 @@ License along with this library.
 
 #define BEACON_RESET(B) do { (B)->first = (B)->last = -1; } while (0)
 
+/* A shard smaller than that would often be full while its neighbours are
+ * not, so the small caches are not split that much. */
+#define SQLX_CACHE_MIN_BASES_PER_SHARD 64
+
 struct beacon_s
 {
 	gint first;
@@ -64,18 +68,23 @@ enum sqlx_base_status_e
 	SQLX_BASE_CLOSING_FOR_DELETION, // base being deleted
 };
 
+struct sqlx_cache_shard_s;
+
 struct sqlx_base_s
 {
 	hashstr_t *name; /*!< This is registered in the DB */
 
+	struct sqlx_cache_shard_s *shard; /*!< The shard the base belongs to,
+										set once for all at the startup */
+
 	GThread *owner; /*!< The current owner of the database. Changed under the
-					  global lock */
+					  lock of the shard */
 	GCond cond;
 	GCond cond_prio;
 
 	gpointer handle;
 
-	gint64 last_update; /*!< Changed under the global lock */
+	gint64 last_update; /*!< Changed under the lock of the shard */
 
 	struct {
 		gint prev;
@@ -90,9 +99,16 @@ struct sqlx_base_s
 	guint32 count_waiting; /*!< Counts the number of threads waiting for the
 							base to become available. */
 
+	guint32 count_yielded; /*!< Counts the threads that let the base to others
+							 while they wait for something else, and will
+							 reclaim it. The base stays USED meanwhile. */
+
+	guint32 count_reclaiming; /*!< Counts the threads among the previous
+								that are waiting to get the base back. */
+
 	gint index; /*!< self reference */
 
-	enum sqlx_base_status_e status; /*!< Changed under the global lock */
+	enum sqlx_base_status_e status; /*!< Changed under the lock of the shard */
 
 	struct grid_single_rrd_s *open_attempts;
 	struct grid_single_rrd_s *open_wait_time;
@@ -100,23 +116,40 @@ struct sqlx_base_s
 
 typedef struct sqlx_base_s sqlx_base_t;
 
-struct sqlx_cache_s
+/* The bases are dispatched among the shards by hash of their name, and each
+ * shard owns a contiguous range of the slots. Everything in a shard is
+ * protected by its own lock. */
+struct sqlx_cache_shard_s
 {
 	GMutex lock;
-	GTree *bases_by_name;
-	sqlx_base_t *bases;
-	guint bases_max_soft;
+	GHashTable *bases_by_name;
+	guint bases_first;
 	guint bases_max_hard;
 	guint bases_used;
 
-	gboolean is_running;
-	gint64 last_memory_usage;
-
 	/* Doubly linked lists of tables, one by status */
 	struct beacon_s beacon_free;
 	struct beacon_s beacon_idle;
 	struct beacon_s beacon_idle_hot;
 	struct beacon_s beacon_used;
+};
+
+struct sqlx_cache_s
+{
+	sqlx_base_t *bases;
+	guint bases_max_soft;
+	guint bases_max_hard;
+	/* Bases not FREE in all the shards, the soft limit applies to it */
+	gint bases_used;
+
+	struct sqlx_cache_shard_s *shards;
+	guint nb_shards;
+
+	/* The shard where the next expiration starts */
+	gint expiry_cursor;
+
+	gboolean is_running;
+	gint64 last_memory_usage;
 
 	sqlx_cache_unlock_hook unlock_hook;
 	sqlx_cache_close_hook close_hook;
@@ -275,35 +308,42 @@ SQLX_UNSHIFT(sqlx_cache_t *cache, sqlx_base_t *base,
 	base->last_update = oio_ext_monotonic_time ();
 }
 
+static struct sqlx_cache_shard_s *
+sqlx_shard_by_name(sqlx_cache_t *cache, const hashstr_t *hs)
+{
+	return cache->shards + (hs->hl.h % cache->nb_shards);
+}
+
 static void
-sqlx_save_id(sqlx_cache_t *cache, sqlx_base_t *base)
+sqlx_save_id(struct sqlx_cache_shard_s *shard, sqlx_base_t *base)
 {
 	gpointer pointer_index = GINT_TO_POINTER(base->index + 1);
-	g_tree_replace(cache->bases_by_name, base->name, pointer_index);
+	g_hash_table_replace(shard->bases_by_name, base->name, pointer_index);
 }
 
 static gint
-sqlx_lookup_id(sqlx_cache_t *cache, const hashstr_t *hs)
+sqlx_lookup_id(struct sqlx_cache_shard_s *shard, const hashstr_t *hs)
 {
-	gpointer lookup_result = g_tree_lookup(cache->bases_by_name, hs);
+	gpointer lookup_result = g_hash_table_lookup(shard->bases_by_name, hs);
 	return !lookup_result ? -1 : (GPOINTER_TO_INT(lookup_result) - 1);
 }
 
 static void
 sqlx_base_remove_from_list(sqlx_cache_t *cache, sqlx_base_t *base)
 {
+	struct sqlx_cache_shard_s *shard = base->shard;
 	switch (base->status) {
 		case SQLX_BASE_FREE:
-			SQLX_REMOVE(cache, base, &(cache->beacon_free));
+			SQLX_REMOVE(cache, base, &(shard->beacon_free));
 			return;
 		case SQLX_BASE_IDLE:
-			SQLX_REMOVE(cache, base, &(cache->beacon_idle));
+			SQLX_REMOVE(cache, base, &(shard->beacon_idle));
 			return;
 		case SQLX_BASE_IDLE_HOT:
-			SQLX_REMOVE(cache, base, &(cache->beacon_idle_hot));
+			SQLX_REMOVE(cache, base, &(shard->beacon_idle_hot));
 			return;
 		case SQLX_BASE_USED:
-			SQLX_REMOVE(cache, base, &(cache->beacon_used));
+			SQLX_REMOVE(cache, base, &(shard->beacon_used));
 			return;
 		case SQLX_BASE_CLOSING:
 		case SQLX_BASE_CLOSING_FOR_DELETION:
@@ -317,23 +357,25 @@ static void
 sqlx_base_add_to_list(sqlx_cache_t *cache, sqlx_base_t *base,
 		enum sqlx_base_status_e status)
 {
+	struct sqlx_cache_shard_s *shard = base->shard;
 	EXTRA_ASSERT(base->link.prev < 0);
 	EXTRA_ASSERT(base->link.next < 0);
 
 	switch (status) {
 		case SQLX_BASE_FREE:
-			EXTRA_ASSERT(cache->bases_used > 0);
-			cache->bases_used --;
-			SQLX_UNSHIFT(cache, base, &(cache->beacon_free), SQLX_BASE_FREE);
+			EXTRA_ASSERT(shard->bases_used > 0);
+			shard->bases_used --;
+			g_atomic_int_add(&cache->bases_used, -1);
+			SQLX_UNSHIFT(cache, base, &(shard->beacon_free), SQLX_BASE_FREE);
 			return;
 		case SQLX_BASE_IDLE:
-			SQLX_UNSHIFT(cache, base, &(cache->beacon_idle), SQLX_BASE_IDLE);
+			SQLX_UNSHIFT(cache, base, &(shard->beacon_idle), SQLX_BASE_IDLE);
 			return;
 		case SQLX_BASE_IDLE_HOT:
-			SQLX_UNSHIFT(cache, base, &(cache->beacon_idle_hot), SQLX_BASE_IDLE_HOT);
+			SQLX_UNSHIFT(cache, base, &(shard->beacon_idle_hot), SQLX_BASE_IDLE_HOT);
 			return;
 		case SQLX_BASE_USED:
-			SQLX_UNSHIFT(cache, base, &(cache->beacon_used), SQLX_BASE_USED);
+			SQLX_UNSHIFT(cache, base, &(shard->beacon_used), SQLX_BASE_USED);
 			return;
 		case SQLX_BASE_CLOSING:
 		case SQLX_BASE_CLOSING_FOR_DELETION:
@@ -361,30 +403,64 @@ sqlx_base_move_to_list(sqlx_cache_t *cache, sqlx_base_t *base,
 }
 
 static gboolean
-_has_idle_unlocked(sqlx_cache_t *cache)
+_has_idle_unlocked(struct sqlx_cache_shard_s *shard)
+{
+	return shard->beacon_idle.first != -1 ||
+			shard->beacon_idle_hot.first != -1;
+}
+
+/* Count one more base in use, unless the soft limit of the cache is
+ * reached. */
+static gboolean
+_cache_take_slot(sqlx_cache_t *cache)
+{
+	gint used;
+	do {
+		used = g_atomic_int_get(&cache->bases_used);
+		if ((guint) used >= cache->bases_max_soft)
+			return FALSE;
+	} while (!g_atomic_int_compare_and_exchange(
+				&cache->bases_used, used, used + 1));
+	return TRUE;
+}
+
+static gint sqlx_expire_first_idle_base(sqlx_cache_t *cache,
+		struct sqlx_cache_shard_s *shard, gint64 now);
+
+/* The soft limit is reached while <shard> has no idle base: close an idle
+ * base of another shard. The lock of <shard> being held, the shards whose
+ * lock is busy are skipped. */
+static gboolean
+_expire_idle_base_elsewhere(sqlx_cache_t *cache,
+		struct sqlx_cache_shard_s *shard)
 {
-	return cache->beacon_idle.first != -1 ||
-			cache->beacon_idle_hot.first != -1;
+	for (guint i = 0; i < cache->nb_shards; i++) {
+		struct sqlx_cache_shard_s *other = cache->shards + i;
+		if (other == shard || !g_mutex_trylock(&other->lock))
+			continue;
+		gint rc = sqlx_expire_first_idle_base(cache, other, 0);
+		g_mutex_unlock(&other->lock);
+		if (rc)
+			return TRUE;
+	}
+	return FALSE;
 }
 
 static GError *
-sqlx_base_reserve(sqlx_cache_t *cache, const hashstr_t *hs,
-		sqlx_base_t **result)
+sqlx_base_reserve(sqlx_cache_t *cache, struct sqlx_cache_shard_s *shard,
+		const hashstr_t *hs, sqlx_base_t **result)
 {
 	*result = NULL;
-	if (cache->bases_used >= cache->bases_max_soft) {
-		if (_has_idle_unlocked(cache)) {
+	sqlx_base_t *base = sqlx_get_by_id(cache, shard->beacon_free.first);
+	if (!base || !_cache_take_slot(cache)) {
+		if (_has_idle_unlocked(shard))
 			return NULL;  // No free base but we can recycle an idle one
-		} else {
+		if (!base || !_expire_idle_base_elsewhere(cache, shard)
+				|| !_cache_take_slot(cache))
 			return BUSY("Max bases reached");
-		}
 	}
 
-	sqlx_base_t *base = sqlx_get_by_id(cache, cache->beacon_free.first);
-	if (!base)
-		return NULL;
-
-	cache->bases_used ++;
+	shard->bases_used ++;
 	EXTRA_ASSERT(base->count_open == 0);
 
 	/* base reserved and in PENDING state */
@@ -394,7 +470,7 @@ sqlx_base_reserve(sqlx_cache_t *cache, const hashstr_t *hs,
 	base->handle = NULL;
 	base->owner = g_thread_self();
 	sqlx_base_move_to_list(cache, base, SQLX_BASE_USED);
-	sqlx_save_id(cache, base);
+	sqlx_save_id(shard, base);
 
 	sqlx_base_debug(__FUNCTION__, base);
 	*result = base;
@@ -413,16 +489,17 @@ _signal_base(sqlx_base_t *base)
  * PRE:
  * - The base must be owned by the current thread
  * - it must be opened only once and locked only once
- * - the cache-wide lock must be owned by the current thread
+ * - the lock of the base's shard must be owned by the current thread
  *
  * POST:
  * - The base is returned to the FREE list
  * - the base is not owned by any thread
- * - The cache-wide lock is still owned
+ * - The lock of the shard is still owned
  */
 static void
 _expire_base(sqlx_cache_t *cache, sqlx_base_t *b, gboolean deleted)
 {
+	struct sqlx_cache_shard_s *shard = b->shard;
 	gpointer handle = b->handle;
 
 	sqlx_base_debug("FREEING", b);
@@ -437,10 +514,10 @@ _expire_base(sqlx_cache_t *cache, sqlx_base_t *b, gboolean deleted)
 	 * But this can take a lot of time. So we can release the pool,
 	 * free the handle and unlock the cache */
 	_signal_base(b),
-	g_mutex_unlock(&cache->lock);
+	g_mutex_unlock(&shard->lock);
 	if (cache->close_hook)
 		cache->close_hook(handle);
-	g_mutex_lock(&cache->lock);
+	g_mutex_lock(&shard->lock);
 
 	hashstr_t *n = b->name;
 
@@ -452,7 +529,7 @@ _expire_base(sqlx_cache_t *cache, sqlx_base_t *b, gboolean deleted)
 	b->last_update = 0;
 	sqlx_base_move_to_list(cache, b, SQLX_BASE_FREE);
 
-	g_tree_remove(cache->bases_by_name, n);
+	g_hash_table_remove(shard->bases_by_name, n);
 	g_free(n);
 }
 
@@ -466,7 +543,7 @@ _expire_specific_base(sqlx_cache_t *cache, sqlx_base_t *b,
 			return 0;
 	}
 
-	/* At this point, I have the global lock, and the base is IDLE.
+	/* At this point, I have the lock of the shard, and the base is IDLE.
 	 * We know no one have the lock on it. So we make the base USED
 	 * and we get the lock on it. because we have the lock, it is
 	 * protected from other uses */
@@ -491,15 +568,16 @@ _expire_specific_base(sqlx_cache_t *cache, sqlx_base_t *b,
 }
 
 static gint
-sqlx_expire_first_idle_base(sqlx_cache_t *cache, gint64 now)
+sqlx_expire_first_idle_base(sqlx_cache_t *cache,
+		struct sqlx_cache_shard_s *shard, gint64 now)
 {
 	gint rc = 0, bd_idle;
 
 	/* Poll the next idle base, and respect the increasing order of the 'heat' */
-	if (0 <= (bd_idle = cache->beacon_idle.last))
+	if (0 <= (bd_idle = shard->beacon_idle.last))
 		rc = _expire_specific_base(cache, GET(cache, bd_idle), now,
 				_cache_grace_delay_cool);
-	if (!rc && 0 <= (bd_idle = cache->beacon_idle_hot.last))
+	if (!rc && 0 <= (bd_idle = shard->beacon_idle_hot.last))
 		rc = _expire_specific_base(cache, GET(cache, bd_idle), now,
 				_cache_grace_delay_hot);
 
@@ -549,23 +627,42 @@ sqlx_cache_t *
 sqlx_cache_init(void)
 {
 	sqlx_cache_t *cache = g_malloc0(sizeof(*cache));
-	g_mutex_init(&cache->lock);
-	cache->bases_by_name = g_tree_new_full(hashstr_quick_cmpdata,
-			NULL, NULL, NULL);
-	BEACON_RESET(&(cache->beacon_free));
-	BEACON_RESET(&(cache->beacon_idle));
-	BEACON_RESET(&(cache->beacon_idle_hot));
-	BEACON_RESET(&(cache->beacon_used));
-
-	cache->bases_used = 0;
+
 	cache->bases_max_hard = sqliterepo_repo_max_bases_hard? : 1024;
 	cache->bases_max_soft = CLAMP(sqliterepo_repo_max_bases_soft, 1, cache->bases_max_hard);
 	cache->bases = g_malloc0(cache->bases_max_hard * sizeof(sqlx_base_t));
 
+	cache->nb_shards = CLAMP(
+			cache->bases_max_hard / SQLX_CACHE_MIN_BASES_PER_SHARD,
+			1, MAX(_cache_shards, 1));
+	cache->shards = g_malloc0_n(cache->nb_shards,
+			sizeof(struct sqlx_cache_shard_s));
+	for (guint i = 0, first = 0; i < cache->nb_shards; i++) {
+		struct sqlx_cache_shard_s *shard = cache->shards + i;
+		g_mutex_init(&shard->lock);
+		shard->bases_by_name = g_hash_table_new(
+				hashstr_quick_hash, hashstr_quick_equal);
+		BEACON_RESET(&(shard->beacon_free));
+		BEACON_RESET(&(shard->beacon_idle));
+		BEACON_RESET(&(shard->beacon_idle_hot));
+		BEACON_RESET(&(shard->beacon_used));
+		shard->bases_used = 0;
+		shard->bases_first = first;
+		shard->bases_max_hard = cache->bases_max_hard / cache->nb_shards
+			+ (i < cache->bases_max_hard % cache->nb_shards ? 1 : 0);
+		first += shard->bases_max_hard;
+	}
+
 	time_t now = oio_ext_monotonic_seconds();
 	for (guint i=0; i<cache->bases_max_hard ;i++) {
 		sqlx_base_t *base = cache->bases + i;
 		base->index = i;
+		base->shard = NULL;
+		for (guint s=0; !base->shard; s++) {
+			struct sqlx_cache_shard_s *shard = cache->shards + s;
+			if (i < shard->bases_first + shard->bases_max_hard)
+				base->shard = shard;
+		}
 		base->link.prev = base->link.next = -1;
 		g_cond_init(&base->cond);
 		g_cond_init(&base->cond_prio);
@@ -573,11 +670,11 @@ sqlx_cache_init(void)
 		base->open_wait_time = grid_single_rrd_create(now, 60);
 	}
 
-	/* stack all the bases in the FREE list, so that the first bases are
-	 * preferred. */
+	/* stack all the bases in the FREE list of their shard, so that the first
+	 * bases are preferred. */
 	for (guint i=cache->bases_max_hard; i>0 ;i--) {
 		sqlx_base_t *base = cache->bases + i - 1;
-		SQLX_UNSHIFT(cache, base, &(cache->beacon_free), SQLX_BASE_FREE);
+		SQLX_UNSHIFT(cache, base, &(base->shard->beacon_free), SQLX_BASE_FREE);
 	}
 
 	cache->is_running = TRUE;
@@ -620,9 +717,13 @@ sqlx_cache_clean(sqlx_cache_t *cache)
 		g_free(cache->bases);
 	}
 
-	g_mutex_clear(&cache->lock);
-	if (cache->bases_by_name)
-		g_tree_destroy(cache->bases_by_name);
+	for (guint i = 0; i < cache->nb_shards; i++) {
+		struct sqlx_cache_shard_s *shard = cache->shards + i;
+		g_mutex_clear(&shard->lock);
+		if (shard->bases_by_name)
+			g_hash_table_destroy(shard->bases_by_name);
+	}
+	g_free(cache->shards);
 
 	g_free(cache);
 }
@@ -691,22 +792,23 @@ sqlx_cache_open_and_lock_base(sqlx_cache_t *cache, const hashstr_t *hname,
 			(void*)cache, hname ? hashstr_str(hname) : "NULL",
 			(void*)result, (deadline - start) / G_TIME_SPAN_MILLISECOND);
 
+	struct sqlx_cache_shard_s *shard = sqlx_shard_by_name(cache, hname);
 	gboolean base_has_been_opened = FALSE;
-	g_mutex_lock(&cache->lock);
+	g_mutex_lock(&shard->lock);
 retry:
 	attempts++;
 
 	if (!cache->is_running) {
 		err = BUSY("service exiting");
 	}
-	else if ((bd = sqlx_lookup_id(cache, hname)) < 0) {
-		if (!(err = sqlx_base_reserve(cache, hname, &base))) {
+	else if ((bd = sqlx_lookup_id(shard, hname)) < 0) {
+		if (!(err = sqlx_base_reserve(cache, shard, hname, &base))) {
 			if (base) {
 				bd = base->index;
 				*result = base->index;
 				sqlx_base_debug("OPEN", base);
 			} else {
-				if (sqlx_expire_first_idle_base(cache, 0) >= 0)
+				if (sqlx_expire_first_idle_base(cache, shard, 0) >= 0)
 					goto retry;
 				err = NEWERROR(CODE_UNAVAILABLE, "No idle base in cache");
 			}
@@ -767,9 +869,12 @@ retry:
 				break;
 
 			case SQLX_BASE_USED:
-				EXTRA_ASSERT(base->count_open > 0);
-				EXTRA_ASSERT(base->owner != NULL);
-				if (base->owner != g_thread_self()) {
+				EXTRA_ASSERT(base->count_open > 0 || base->count_yielded > 0);
+				EXTRA_ASSERT(base->owner != NULL || base->count_yielded > 0);
+				/* A base let by its owner is available, unless a thread
+				 * that yielded it wants it back: these ones go first. */
+				if (base->owner != g_thread_self() && (base->owner != NULL
+							|| base->count_reclaiming > 0)) {
 					GRID_DEBUG("Base [%s] in use by another thread (%X), waiting...",
 							hashstr_str(hname), oio_log_thread_id(base->owner));
 
@@ -809,13 +914,13 @@ retry:
 
 					/* The lock is held by another thread/request.
 					   Do not use 'now' because it can be a fake clock */
-					g_cond_wait_until(wait_cond, &cache->lock,
+					g_cond_wait_until(wait_cond, &shard->lock,
 							g_get_monotonic_time() + _cache_period_cond_wait);
 
 					base->count_waiting --;
 					goto retry;
 				}
-				/* Already opened by this thread */
+				/* Already opened by this thread, or yielded by its owner */
 				base->owner = g_thread_self();
 				base->count_open ++;
 				*result = base->index;
@@ -825,7 +930,7 @@ retry:
 				EXTRA_ASSERT(base->owner != NULL);
 				/* Just wait for a notification then retry
 				   Do not use 'now' because it can be a fake clock */
-				g_cond_wait_until(wait_cond, &cache->lock,
+				g_cond_wait_until(wait_cond, &shard->lock,
 						g_get_monotonic_time() + _cache_period_cond_wait);
 				goto retry;
 
@@ -861,7 +966,7 @@ retry:
 		}
 		_signal_base(base);
 	}
-	g_mutex_unlock(&cache->lock);
+	g_mutex_unlock(&shard->lock);
 	return err;
 }
 
@@ -878,9 +983,9 @@ sqlx_cache_unlock_and_close_base(sqlx_cache_t *cache, gint bd, guint32 flags)
 		return NEWERROR(CODE_INTERNAL_ERROR, "invalid base id=%d", bd);
 
 	gint64 lock_time = 0;
-	g_mutex_lock(&cache->lock);
-
-	sqlx_base_t *base; base = GET(cache,bd);
+	sqlx_base_t *base = GET(cache,bd);
+	struct sqlx_cache_shard_s *shard = base->shard;
+	g_mutex_lock(&shard->lock);
 
 	// base->name is no more valid after _expire_base()
 	if (base->name)
@@ -929,7 +1034,13 @@ sqlx_cache_unlock_and_close_base(sqlx_cache_t *cache, gint bd, guint32 flags)
 			}
 			lock_time = oio_ext_monotonic_time() - base->last_update;
 			/* held by the current thread */
-			if (!(-- base->count_open)) {  /* to be closed */
+			if (!(-- base->count_open) && base->count_yielded > 0) {
+				/* Threads that yielded the base will reclaim it, so it
+				 * stays open for them. But the current user is done. */
+				if (cache->unlock_hook)
+					cache->unlock_hook(base->handle);
+				base->owner = NULL;
+			} else if (!base->count_open) {  /* to be closed */
 				if (flags & (SQLX_CLOSE_IMMEDIATELY|SQLX_CLOSE_FOR_DELETION)) {
 					_expire_base(cache, base, flags & SQLX_CLOSE_FOR_DELETION);
 				} else {
@@ -949,8 +1060,8 @@ sqlx_cache_unlock_and_close_base(sqlx_cache_t *cache, gint bd, guint32 flags)
 					 * that will be expired won't return its memory pages to
 					 * the kernel but to the sqlite3 pool. The pages will
 					 * become available to other bases. */
-					if (_ram_exhausted(cache) && _has_idle_unlocked(cache))
-						sqlx_expire_first_idle_base(cache, 0);
+					if (_ram_exhausted(cache) && _has_idle_unlocked(shard))
+						sqlx_expire_first_idle_base(cache, shard, 0);
 				}
 			}
 			break;
@@ -980,10 +1091,68 @@ sqlx_cache_unlock_and_close_base(sqlx_cache_t *cache, gint bd, guint32 flags)
 		}
 	}
 	_signal_base(base),
-	g_mutex_unlock(&cache->lock);
+	g_mutex_unlock(&shard->lock);
+	return err;
+}
+
+GError *
+sqlx_cache_yield_base(sqlx_cache_t *cache, gint bd, guint32 *count_open)
+{
+	GError *err = NULL;
+
+	EXTRA_ASSERT(cache != NULL);
+	EXTRA_ASSERT(count_open != NULL);
+	if (base_id_out(cache, bd))
+		return NEWERROR(CODE_INTERNAL_ERROR, "invalid base id=%d", bd);
+
+	sqlx_base_t *base = GET(cache, bd);
+	struct sqlx_cache_shard_s *shard = base->shard;
+	g_mutex_lock(&shard->lock);
+
+	if (base->status != SQLX_BASE_USED || base->owner != g_thread_self()) {
+		err = NEWERROR(CODE_INTERNAL_ERROR, "base not owned");
+	} else {
+		*count_open = base->count_open;
+		base->count_open = 0;
+		base->count_yielded ++;
+		base->owner = NULL;
+		sqlx_base_debug(__FUNCTION__, base);
+		_signal_base(base);
+	}
+
+	g_mutex_unlock(&shard->lock);
 	return err;
 }
 
+void
+sqlx_cache_reclaim_base(sqlx_cache_t *cache, gint bd, guint32 count_open)
+{
+	EXTRA_ASSERT(cache != NULL);
+	EXTRA_ASSERT(!base_id_out(cache, bd));
+
+	sqlx_base_t *base = GET(cache, bd);
+	struct sqlx_cache_shard_s *shard = base->shard;
+	g_mutex_lock(&shard->lock);
+
+	EXTRA_ASSERT(base->status == SQLX_BASE_USED);
+	EXTRA_ASSERT(base->count_yielded > 0);
+
+	base->count_reclaiming ++;
+	while (base->owner != NULL) {
+		/* Do not use a fake clock there */
+		g_cond_wait_until(&base->cond_prio, &shard->lock,
+				g_get_monotonic_time() + _cache_period_cond_wait);
+	}
+	base->count_reclaiming --;
+
+	base->count_yielded --;
+	base->count_open = count_open;
+	base->owner = g_thread_self();
+	sqlx_base_debug(__FUNCTION__, base);
+
+	g_mutex_unlock(&shard->lock);
+}
+
 void
 sqlx_cache_debug(sqlx_cache_t *cache)
 {
@@ -993,39 +1162,50 @@ sqlx_cache_debug(sqlx_cache_t *cache)
 		return;
 
 	GRID_DEBUG("--- REPO %p -----------------", (void*)cache);
-	GRID_DEBUG(" > used     [%d, %d]",
-			cache->beacon_used.first, cache->beacon_used.last);
-	GRID_DEBUG(" > idle     [%d, %d]",
-			cache->beacon_idle.first, cache->beacon_idle.last);
-	GRID_DEBUG(" > idle_hot [%d, %d]",
-			cache->beacon_idle_hot.first, cache->beacon_idle_hot.last);
-	GRID_DEBUG(" > free     [%d, %d]",
-			cache->beacon_free.first, cache->beacon_free.last);
-
-	/* Dump all the bases */
-	for (guint bd=0; bd < cache->bases_max_hard ;bd++) {
-		sqlx_base_debug(__FUNCTION__, GET(cache,bd));
-	}
+	for (guint i = 0; i < cache->nb_shards; i++) {
+		struct sqlx_cache_shard_s *shard = cache->shards + i;
+		g_mutex_lock(&shard->lock);
+		GRID_DEBUG(" > shard %u [%u, +%u] used %u",
+				i, shard->bases_first, shard->bases_max_hard,
+				shard->bases_used);
+		GRID_DEBUG(" > used     [%d, %d]",
+				shard->beacon_used.first, shard->beacon_used.last);
+		GRID_DEBUG(" > idle     [%d, %d]",
+				shard->beacon_idle.first, shard->beacon_idle.last);
+		GRID_DEBUG(" > idle_hot [%d, %d]",
+				shard->beacon_idle_hot.first, shard->beacon_idle_hot.last);
+		GRID_DEBUG(" > free     [%d, %d]",
+				shard->beacon_free.first, shard->beacon_free.last);
+
+		/* Dump all the bases of the shard */
+		for (guint bd = shard->bases_first;
+				bd < shard->bases_first + shard->bases_max_hard; bd++) {
+			sqlx_base_debug(__FUNCTION__, GET(cache,bd));
+		}
 
-	/* Now dump all te references in the hashtable */
-	gboolean runner(gpointer k, gpointer v, gpointer u) {
-		(void) u;
-		GRID_DEBUG("REF %d <- %s", GPOINTER_TO_INT(v), hashstr_str(k));
-		return FALSE;
+		/* Now dump all te references in the hashtable */
+		void runner(gpointer k, gpointer v, gpointer u) {
+			(void) u;
+			GRID_DEBUG("REF %d <- %s", GPOINTER_TO_INT(v), hashstr_str(k));
+		}
+		g_hash_table_foreach(shard->bases_by_name, runner, NULL);
+		g_mutex_unlock(&shard->lock);
 	}
-	g_tree_foreach(cache->bases_by_name, runner, NULL);
 }
 
 guint
 sqlx_cache_expire_all(sqlx_cache_t *cache)
 {
-	guint nb;
+	guint nb = 0;
 
 	EXTRA_ASSERT(cache != NULL);
 
-	g_mutex_lock(&cache->lock);
-	for (nb=0; sqlx_expire_first_idle_base(cache, 0) ;nb++) { }
-	g_mutex_unlock(&cache->lock);
+	for (guint i = 0; i < cache->nb_shards; i++) {
+		struct sqlx_cache_shard_s *shard = cache->shards + i;
+		g_mutex_lock(&shard->lock);
+		for (; sqlx_expire_first_idle_base(cache, shard, 0) ;nb++) { }
+		g_mutex_unlock(&shard->lock);
+	}
 
 	return nb;
 }
@@ -1038,15 +1218,28 @@ sqlx_cache_expire(sqlx_cache_t *cache, guint max, gint64 duration)
 
 	EXTRA_ASSERT(cache != NULL);
 
-	g_mutex_lock(&cache->lock);
-
-	for (nb=0; !max || nb < max ; nb++) {
-		gint64 now = oio_ext_monotonic_time ();
-		if (now > deadline || !sqlx_expire_first_idle_base(cache, now))
-			break;
+	/* Each call starts with the next shard, so that a small `max` does not
+	 * always drain the same shards. Within a shard, the idle lists keep the
+	 * order of expiration. */
+	const guint first = (guint) g_atomic_int_add(&cache->expiry_cursor, 1);
+	gboolean timeout = FALSE;
+
+	for (guint i = 0; !timeout && i < cache->nb_shards; i++) {
+		struct sqlx_cache_shard_s *shard =
+			cache->shards + ((first + i) % cache->nb_shards);
+		g_mutex_lock(&shard->lock);
+		for (; !max || nb < max ; nb++) {
+			gint64 now = oio_ext_monotonic_time ();
+			if (now > deadline) {
+				timeout = TRUE;
+				break;
+			}
+			if (!sqlx_expire_first_idle_base(cache, shard, now))
+				break;
+		}
+		g_mutex_unlock(&shard->lock);
 	}
 
-	g_mutex_unlock(&cache->lock);
 	return nb;
 }
 
@@ -1077,12 +1270,10 @@ static guint
 _count_beacon(sqlx_cache_t *cache, struct beacon_s *beacon)
 {
 	guint count = 0;
-	g_mutex_lock(&cache->lock);
 	for (gint idx = beacon->first; idx != -1 ;) {
 		++ count;
 		idx = GET(cache, idx)->link.next;
 	}
-	g_mutex_unlock(&cache->lock);
 	return count;
 }
 
@@ -1095,9 +1286,14 @@ sqlx_cache_count(sqlx_cache_t *cache)
 	if (cache) {
 		count.max = cache->bases_max_hard;
 		count.soft_max = cache->bases_max_soft;
-		count.cold = _count_beacon(cache, &cache->beacon_idle);
-		count.hot = _count_beacon(cache, &cache->beacon_idle_hot);
-		count.used = _count_beacon(cache, &cache->beacon_used);
+		for (guint i = 0; i < cache->nb_shards; i++) {
+			struct sqlx_cache_shard_s *shard = cache->shards + i;
+			g_mutex_lock(&shard->lock);
+			count.cold += _count_beacon(cache, &shard->beacon_idle);
+			count.hot += _count_beacon(cache, &shard->beacon_idle_hot);
+			count.used += _count_beacon(cache, &shard->beacon_used);
+			g_mutex_unlock(&shard->lock);
+		}
 	}
 
 	return count;
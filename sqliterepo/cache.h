@@ -64,6 +64,18 @@ GError * sqlx_cache_open_and_lock_base(sqlx_cache_t *cache,
 GError * sqlx_cache_unlock_and_close_base(sqlx_cache_t *cache, gint bd,
 		guint32 flags);
 
+/** Let other threads open and lock the base while the current thread waits
+ * for something that does not need it. The base is kept open meanwhile, it
+ * must be given back with sqlx_cache_reclaim_base() and the value stored
+ * in <count_open>. */
+GError * sqlx_cache_yield_base(sqlx_cache_t *cache, gint bd,
+		guint32 *count_open);
+
+/** Wait for the base yielded with sqlx_cache_yield_base() to be released by
+ * the other threads, then own it again. The threads getting a base back
+ * have precedence over the new openings. */
+void sqlx_cache_reclaim_base(sqlx_cache_t *cache, gint bd, guint32 count_open);
+
 guint sqlx_cache_expire_all(sqlx_cache_t *cache);
 
 /** Check for expired bases, then close them */
@@ -37,7 +37,7 @@ License along with this library.
 #define STATUS_FINAL(e) ((e) >= STEP_SLAVE)
 
 #ifdef HAVE_EXTRA_DEBUG
-#define TRACE_EXECUTION(M) _manager_record_activity((M), __FUNCTION__, __LINE__)
+#define TRACE_EXECUTION(S) _shard_record_activity((S), __FUNCTION__, __LINE__)
 #else
 #define TRACE_EXECUTION(...)
 #endif
@@ -98,6 +98,39 @@ struct activity_trace_element_s
 	int line;
 };
 
+/* The elections are spread among a fixed number of shards, each one with
+ * its own lock, so that the ZK completions and the client requests on
+ * unrelated bases do not contend on a single mutex. The shard is chosen with
+ * the same bits of the key as the ZK shard (see _LOCKED_init_member()) so
+ * that, as long as the number of ZK shards divides ELECTION_SHARDS, a lock
+ * shard only holds elections managed by a single ZK ensemble.
+ * MUST be a power of two. */
+#define ELECTION_SHARDS 16
+
+/* @private */
+struct election_shard_s
+{
+	struct election_manager_s *manager;
+
+	/* GTree<gchar*,GCond*> */
+	GTree *conditions;
+
+	/* Serializes the ZK completions of the elections of the shard */
+	GThreadPool *completions;
+
+	/* GTree<gchar*,struct election_member_s*> */
+	GTree *members_by_key;
+
+	GMutex lock;
+
+	/* Trace of actions while the lock was held */
+	GArray *activity_trace;
+
+	gboolean deferred_peering_notify;
+
+	struct deque_beacon_s members_by_state[STEP_MAX];
+};
+
 /* @private */
 struct election_manager_s
 {
@@ -119,26 +152,14 @@ struct election_manager_s
 	/* do not free or change the fields below */
 	const struct replication_config_s *config;
 
-	/* GTree<gchar*,GCond*> */
-	GTree *conditions;
-
-	GThreadPool *completions;
-
 	GThreadPool *tasks_getpeers;
 
-	/* GTree<gchar*,struct election_member_s*> */
-	GTree *members_by_key;
-
-	GMutex lock;
-
-	/* Trace of actions while the lock was held */
-	GArray *activity_trace;
-
 	gboolean exiting;
 
-	gboolean deferred_peering_notify;
+	/* Index of the shard the next rebalancing will start with */
+	guint balance_cursor;
 
-	struct deque_beacon_s members_by_state[STEP_MAX];
+	struct election_shard_s shards[ELECTION_SHARDS];
 };
 
 /* @private */
@@ -157,6 +178,7 @@ struct election_member_s
 	struct election_member_s *next;
 
 	struct election_manager_s *manager;
+	struct election_shard_s *shard;
 	struct sqlx_sync_s *sync;
 
 	/* Weak pointer to the condition, do not free! */
@@ -396,30 +418,30 @@ _cond_clean (gpointer p)
 #define _ELECTION_MANAGER_LOCKED 0x02
 
 static inline void
-_manager_record_activity(struct election_manager_s *M, const char *fn, int ln)
+_shard_record_activity(struct election_shard_s *S, const char *fn, int ln)
 {
-	if (M->exiting) return;
+	if (S->manager->exiting) return;
 
 	struct activity_trace_element_s item = {};
 	item.when = oio_ext_monotonic_time();
 	item.func = fn;
 	item.line = ln;
-	g_array_append_vals(M->activity_trace, &item, 1);
+	g_array_append_vals(S->activity_trace, &item, 1);
 }
 
 #ifdef HAVE_EXTRA_DEBUG
 
-#define _manager_save_locked(M) do { \
-	g_array_set_size(M->activity_trace, 0); \
-	TRACE_EXECUTION(M); \
+#define _shard_save_locked(S) do { \
+	g_array_set_size(S->activity_trace, 0); \
+	TRACE_EXECUTION(S); \
 } while (0)
 
 static void
-_manage_dump_activity(struct election_manager_s *M)
+_shard_dump_activity(struct election_shard_s *S)
 {
-	if (M->exiting) return;
+	if (S->manager->exiting) return;
 
-	const GArray *ga = M->activity_trace;
+	const GArray *ga = S->activity_trace;
 	EXTRA_ASSERT(ga->len > 0);
 	gint64 _in = g_array_index(ga, struct activity_trace_element_s, 0).when;
 	const gint64 _out = g_array_index(ga, struct activity_trace_element_s, ga->len - 1).when;
@@ -438,26 +460,50 @@ _manage_dump_activity(struct election_manager_s *M)
 	}
 }
 #else
-#define _manager_save_locked(...)
-#define _manage_dump_activity(...)
+#define _shard_save_locked(...)
+#define _shard_dump_activity(...)
 #endif
 
-#define _manager_lock(M) do { \
-	g_mutex_lock(&(M)->lock); \
-	_manager_save_locked(M); \
+#define _shard_lock(S) do { \
+	g_mutex_lock(&(S)->lock); \
+	_shard_save_locked(S); \
 } while (0)
 
-#define _manager_unlock(M) do { \
-	TRACE_EXECUTION(M); \
-	_manage_dump_activity(M); \
-	const gboolean _peering_notify = (M)->deferred_peering_notify; \
-	(M)->deferred_peering_notify = FALSE; \
-	g_mutex_unlock(&M->lock); \
+#define _shard_unlock(S) do { \
+	TRACE_EXECUTION(S); \
+	_shard_dump_activity(S); \
+	const gboolean _peering_notify = (S)->deferred_peering_notify; \
+	(S)->deferred_peering_notify = FALSE; \
+	g_mutex_unlock(&(S)->lock); \
 	if (_peering_notify) { \
-		sqlx_peering__notify((M)->peering); \
+		sqlx_peering__notify((S)->manager->peering); \
 	} \
 } while (0)
 
+/* Extract the 16 bits encoded by the 4 hexadecimal characters that end
+ * at <key> + <end>. */
+static gboolean
+_key_to_uint16(const char *key, const gsize end, guint16 *out)
+{
+	gchar str_uint16[5];
+	if (end < 4)
+		return FALSE;
+	/* The oio_str_bin2hex() requires the source string to be not
+	 * too long. */
+	g_strlcpy(str_uint16, key + end - 4, sizeof(str_uint16));
+	return oio_str_hex2bin(str_uint16, (guint8 *) out, sizeof(*out));
+}
+
+static struct election_shard_s *
+_manager_get_shard(struct election_manager_s *M, const char *key,
+		const gsize len)
+{
+	guint16 id_shard = 0;
+	if (!_key_to_uint16(key, len, &id_shard))
+		id_shard = 0;
+	return M->shards + (id_shard % ELECTION_SHARDS);
+}
+
 static void _completion_router(gpointer p, struct election_manager_s *M);
 static void _worker_getpeers(struct election_member_s *m, struct election_manager_s *M);
 
@@ -468,7 +514,7 @@ _DEQUE_remove (struct election_member_s *m)
 {
 	EXTRA_ASSERT(m != NULL);
 	EXTRA_ASSERT(m->step < STEP_MAX);
-	struct deque_beacon_s *beacon = m->manager->members_by_state + m->step;
+	struct deque_beacon_s *beacon = m->shard->members_by_state + m->step;
 	EXTRA_ASSERT(beacon->count > 0);
 
 	struct election_member_s *prev = m->prev, *next = m->next;
@@ -487,7 +533,7 @@ _DEQUE_add (struct election_member_s *m)
 	EXTRA_ASSERT(m->step < STEP_MAX);
 	EXTRA_ASSERT(m->prev == NULL);
 	EXTRA_ASSERT(m->next == NULL);
-	struct deque_beacon_s *beacon = m->manager->members_by_state + m->step;
+	struct deque_beacon_s *beacon = m->shard->members_by_state + m->step;
 
 	if (beacon->back) {
 		m->prev = beacon->back;
@@ -593,23 +639,30 @@ election_manager_create(struct replication_config_s *config,
 	manager->mux_factor = sqliterepo_zk_mux_factor;
 	manager->nb_shards = 0;
 
-	g_mutex_init(&manager->lock);
+	for (guint i = 0; i < ELECTION_SHARDS; i++) {
+		struct election_shard_s *shard = manager->shards + i;
+		shard->manager = manager;
+
+		g_mutex_init(&shard->lock);
+
+		shard->members_by_key =
+			g_tree_new_full(metautils_strcmp3, NULL, NULL, NULL);
 
-	manager->members_by_key =
-		g_tree_new_full(metautils_strcmp3, NULL, NULL, NULL);
+		shard->conditions =
+			g_tree_new_full(metautils_strcmp3, NULL, g_free, _cond_clean);
 
-	manager->conditions =
-		g_tree_new_full(metautils_strcmp3, NULL, g_free, _cond_clean);
+		/* One thread per shard: the completions of the shard are played
+		 * in the order they arrived, without waiting for the others. */
+		shard->completions =
+			g_thread_pool_new((GFunc)_completion_router, manager, 1, FALSE, NULL);
 
-	manager->completions =
-		g_thread_pool_new((GFunc)_completion_router, manager, 8, FALSE, NULL);
+		shard->activity_trace =
+			g_array_sized_new(FALSE, FALSE, sizeof(struct activity_trace_element_s), 32);
+	}
 
 	manager->tasks_getpeers =
 		g_thread_pool_new((GFunc)_worker_getpeers, manager, 8, FALSE, NULL);
 
-	manager->activity_trace =
-		g_array_sized_new(FALSE, FALSE, sizeof(struct activity_trace_element_s), 32);
-
 	*result = manager;
 	return NULL;
 }
@@ -696,28 +749,43 @@ election_manager_get_mode (const struct election_manager_s *m)
 	return ((struct abstract_election_manager_s*)m)->vtable->get_mode(m);
 }
 
-static struct election_counts_s
-_NOLOCK_count (struct election_manager_s *manager)
+static void
+_NOLOCK_count (struct election_shard_s *shard, struct election_counts_s *out)
 {
 	struct election_counts_s count = {0};
-	count.none = manager->members_by_state[STEP_NONE].count;
-	count.pending += manager->members_by_state[STEP_CREATING].count;
-	count.pending += manager->members_by_state[STEP_WATCHING].count;
-	count.pending += manager->members_by_state[STEP_LISTING].count;
-	count.pending += manager->members_by_state[STEP_ASKING].count;
-	count.pending += manager->members_by_state[STEP_CHECKING_MASTER].count;
-	count.pending += manager->members_by_state[STEP_CHECKING_SLAVES].count;
-	count.pending += manager->members_by_state[STEP_DELAYED_CHECKING_MASTER].count;
-	count.pending += manager->members_by_state[STEP_DELAYED_CHECKING_SLAVES].count;
-	count.pending += manager->members_by_state[STEP_REFRESH_CHECKING_MASTER].count;
-	count.pending += manager->members_by_state[STEP_REFRESH_CHECKING_SLAVES].count;
-	count.pending += manager->members_by_state[STEP_SYNCING].count;
-	count.pending += manager->members_by_state[STEP_LEAVING].count;
-	count.pending += manager->members_by_state[STEP_LEAVING_FAILING].count;
-	count.failed = manager->members_by_state[STEP_FAILED].count;
-	count.slave = manager->members_by_state[STEP_SLAVE].count;
-	count.master = manager->members_by_state[STEP_MASTER].count;
+	count.none = shard->members_by_state[STEP_NONE].count;
+	count.pending += shard->members_by_state[STEP_CREATING].count;
+	count.pending += shard->members_by_state[STEP_WATCHING].count;
+	count.pending += shard->members_by_state[STEP_LISTING].count;
+	count.pending += shard->members_by_state[STEP_ASKING].count;
+	count.pending += shard->members_by_state[STEP_CHECKING_MASTER].count;
+	count.pending += shard->members_by_state[STEP_CHECKING_SLAVES].count;
+	count.pending += shard->members_by_state[STEP_DELAYED_CHECKING_MASTER].count;
+	count.pending += shard->members_by_state[STEP_DELAYED_CHECKING_SLAVES].count;
+	count.pending += shard->members_by_state[STEP_REFRESH_CHECKING_MASTER].count;
+	count.pending += shard->members_by_state[STEP_REFRESH_CHECKING_SLAVES].count;
+	count.pending += shard->members_by_state[STEP_SYNCING].count;
+	count.pending += shard->members_by_state[STEP_LEAVING].count;
+	count.pending += shard->members_by_state[STEP_LEAVING_FAILING].count;
+	count.failed = shard->members_by_state[STEP_FAILED].count;
+	count.slave = shard->members_by_state[STEP_SLAVE].count;
+	count.master = shard->members_by_state[STEP_MASTER].count;
 	count.total = count.none + count.pending + count.master + count.slave + count.failed;
+
+	out->none += count.none;
+	out->pending += count.pending;
+	out->failed += count.failed;
+	out->slave += count.slave;
+	out->master += count.master;
+	out->total += count.total;
+}
+
+static guint
+_NOLOCK_count_step (struct election_manager_s *M, enum election_step_e step)
+{
+	guint count = 0;
+	for (guint i = 0; i < ELECTION_SHARDS; i++)
+		count += M->shards[i].members_by_state[step].count;
 	return count;
 }
 
@@ -727,14 +795,18 @@ election_manager_count(struct election_manager_s *manager)
 	MANAGER_CHECK(manager);
 	EXTRA_ASSERT (manager->vtable == &VTABLE);
 
-	_manager_lock(manager);
-	struct election_counts_s count = _NOLOCK_count (manager);
-	_manager_unlock(manager);
+	struct election_counts_s count = {0};
+	for (guint i = 0; i < ELECTION_SHARDS; i++) {
+		struct election_shard_s *shard = manager->shards + i;
+		_shard_lock(shard);
+		_NOLOCK_count (shard, &count);
+		_shard_unlock(shard);
+	}
 	return count;
 }
 
 static struct election_member_s *
-_LOCKED_get_member (struct election_manager_s *ma, const char *k);
+_LOCKED_get_member (struct election_shard_s *shard, const char *k);
 
 #define member_reset_peers(m) do { \
 	if (m->peers) { \
@@ -749,13 +821,11 @@ _LOCKED_get_member (struct election_manager_s *ma, const char *k);
 } while (0)
 
 static gboolean
-_LOCKED_get_cached_peers(struct election_manager_s *manager,
-		const struct sqlx_name_s *n, gchar ***result)
+_LOCKED_get_cached_peers(struct election_shard_s *shard,
+		const char *key, gchar ***result)
 {
 	gboolean success = FALSE;
-	gchar key[OIO_ELECTION_KEY_LIMIT_LENGTH];
-	sqliterepo_hash_name(n, key, sizeof(key));
-	struct election_member_s *member = _LOCKED_get_member(manager, key);
+	struct election_member_s *member = _LOCKED_get_member(shard, key);
 	if (member) {
 		if (member->peers && *(member->peers)) {
 			*result = g_strdupv(member->peers);
@@ -767,12 +837,10 @@ _LOCKED_get_cached_peers(struct election_manager_s *manager,
 }
 
 static void
-_LOCKED_cache_peers(struct election_manager_s *manager,
-		const struct sqlx_name_s *n, gchar **peers)
+_LOCKED_cache_peers(struct election_shard_s *shard,
+		const char *key, gchar **peers)
 {
-	gchar key[OIO_ELECTION_KEY_LIMIT_LENGTH];
-	sqliterepo_hash_name(n, key, sizeof(key));
-	struct election_member_s *member = _LOCKED_get_member(manager, key);
+	struct election_member_s *member = _LOCKED_get_member(shard, key);
 	if (member) {
 		if (member->peers)
 			member_reset_peers(member);
@@ -783,22 +851,22 @@ _LOCKED_cache_peers(struct election_manager_s *manager,
 }
 
 static gboolean
-_get_cached_peers(struct election_manager_s *manager,
-		const struct sqlx_name_s *n, gchar ***result)
+_get_cached_peers(struct election_shard_s *shard,
+		const char *key, gchar ***result)
 {
-	_manager_lock(manager);
-	gboolean rc = _LOCKED_get_cached_peers(manager, n, result);
-	_manager_unlock(manager);
+	_shard_lock(shard);
+	gboolean rc = _LOCKED_get_cached_peers(shard, key, result);
+	_shard_unlock(shard);
 	return rc;
 }
 
 static void
-_cache_peers(struct election_manager_s *manager,
-		const struct sqlx_name_s *n, gchar **peers)
+_cache_peers(struct election_shard_s *shard,
+		const char *key, gchar **peers)
 {
-	_manager_lock(manager);
-	_LOCKED_cache_peers(manager, n, peers);
-	_manager_unlock(manager);
+	_shard_lock(shard);
+	_LOCKED_cache_peers(shard, key, peers);
+	_shard_unlock(shard);
 }
 
 static GError *
@@ -817,11 +885,14 @@ _election_get_peers(struct election_manager_s *manager,
 	gchar **peers = NULL;
 	gboolean nocache = flags & SQLX_REPO_NOCACHE;
 	gboolean peers_from_election = FALSE;
+	gchar key[OIO_ELECTION_KEY_LIMIT_LENGTH];
+	sqliterepo_hash_name(n, key, sizeof(key));
+	struct election_shard_s *shard = _manager_get_shard(manager, key, strlen(key));
 	if (!nocache) {
 		if (flags & _ELECTION_MANAGER_LOCKED)
-			peers_from_election = _LOCKED_get_cached_peers(manager, n, &peers);
+			peers_from_election = _LOCKED_get_cached_peers(shard, key, &peers);
 		else
-			peers_from_election = _get_cached_peers(manager, n, &peers);
+			peers_from_election = _get_cached_peers(shard, key, &peers);
 	}
 	if (!peers_from_election) {
 		/* Member does not exist yet
@@ -834,9 +905,9 @@ _election_get_peers(struct election_manager_s *manager,
 		if (!peers_from_election) {
 			/* Peers did not come from election, we can cache them. */
 			if (flags & _ELECTION_MANAGER_LOCKED)
-				_LOCKED_cache_peers(manager, n, peers);
+				_LOCKED_cache_peers(shard, key, peers);
 			else
-				_cache_peers(manager, n, peers);
+				_cache_peers(shard, key, peers);
 		}
 		*result = peers;
 	} else {
@@ -853,20 +924,20 @@ _manager_clean(struct election_manager_s *manager)
 	if (!manager)
 		return;
 
-	struct election_counts_s count = _NOLOCK_count(manager);
+	struct election_counts_s count = {0};
+	for (guint i = 0; i < ELECTION_SHARDS; i++)
+		_NOLOCK_count(manager->shards + i, &count);
 	GRID_DEBUG("%d elections still alive at manager shutdown: %d masters, "
 			"%d slaves, %d pending, %d failed, %d exited",
 			count.total, count.master, count.slave, count.pending,
 			count.failed, count.none);
 
-	if (manager->activity_trace) {
-		g_array_free(manager->activity_trace, TRUE);
-		manager->activity_trace = NULL;
-	}
-
-	if (manager->completions) {
-		g_thread_pool_free(manager->completions, FALSE, TRUE);
-		manager->completions = NULL;
+	for (guint i = 0; i < ELECTION_SHARDS; i++) {
+		struct election_shard_s *shard = manager->shards + i;
+		if (shard->completions) {
+			g_thread_pool_free(shard->completions, FALSE, TRUE);
+			shard->completions = NULL;
+		}
 	}
 
 	if (manager->tasks_getpeers) {
@@ -874,29 +945,38 @@ _manager_clean(struct election_manager_s *manager)
 		manager->tasks_getpeers = NULL;
 	}
 
-	if (manager->members_by_key) {
-		g_tree_destroy (manager->members_by_key);
-		manager->members_by_key = NULL;
-	}
+	for (guint s = 0; s < ELECTION_SHARDS; s++) {
+		struct election_shard_s *shard = manager->shards + s;
 
-	/* Ensure all the items are unlinked */
-	for (int i=STEP_NONE; i<STEP_MAX ;++i) {
-		struct deque_beacon_s *beacon = manager->members_by_state + i;
-		while (beacon->front != NULL) {
-			struct election_member_s *m = beacon->front;
-			_DEQUE_remove(m);
-			m->refcount = 0; /* ugly quirk that cope with an assert on refcount */
-			member_destroy (m);
+		if (shard->activity_trace) {
+			g_array_free(shard->activity_trace, TRUE);
+			shard->activity_trace = NULL;
 		}
-		g_assert (beacon->count == 0);
-	}
 
-	if (manager->conditions) {
-		g_tree_destroy(manager->conditions);
-		manager->conditions = NULL;
-	}
+		if (shard->members_by_key) {
+			g_tree_destroy (shard->members_by_key);
+			shard->members_by_key = NULL;
+		}
+
+		/* Ensure all the items are unlinked */
+		for (int i=STEP_NONE; i<STEP_MAX ;++i) {
+			struct deque_beacon_s *beacon = shard->members_by_state + i;
+			while (beacon->front != NULL) {
+				struct election_member_s *m = beacon->front;
+				_DEQUE_remove(m);
+				m->refcount = 0; /* ugly quirk that cope with an assert on refcount */
+				member_destroy (m);
+			}
+			g_assert (beacon->count == 0);
+		}
 
-	g_mutex_clear(&manager->lock);
+		if (shard->conditions) {
+			g_tree_destroy(shard->conditions);
+			shard->conditions = NULL;
+		}
+
+		g_mutex_clear(&shard->lock);
+	}
 
 	g_free(manager->sync_tab);
 	g_free(manager);
@@ -1013,15 +1093,15 @@ member_get_cond(struct election_member_s *m)
 static GMutex*
 member_get_lock(struct election_member_s *m)
 {
-	return &(MMANAGER(m)->lock);
+	return &(m->shard->lock);
 }
 
 #define member_lock(m) do { \
-	_manager_lock(m->manager); \
+	_shard_lock(m->shard); \
 } while (0)
 
 #define member_unlock(m) do { \
-	_manager_unlock(m->manager); \
+	_shard_unlock(m->shard); \
 } while (0)
 
 #define member_signal(m) do { \
@@ -1172,36 +1252,37 @@ member_destroy(struct election_member_s *member)
 }
 
 static struct election_member_s *
-_LOCKED_get_member (struct election_manager_s *M, const char *k)
+_LOCKED_get_member (struct election_shard_s *S, const char *k)
 {
-	struct election_member_s *m = g_tree_lookup (M->members_by_key, k);
+	struct election_member_s *m = g_tree_lookup (S->members_by_key, k);
 	if (m)
 		member_ref (m);
-	TRACE_EXECUTION(M);
+	TRACE_EXECUTION(S);
 	return m;
 }
 
 static GCond *
-_manager_get_condition (struct election_manager_s *m, const char *k)
+_shard_get_condition (struct election_shard_s *S, const char *k)
 {
-	GCond *cond = g_tree_lookup (m->conditions, k);
+	GCond *cond = g_tree_lookup (S->conditions, k);
 	if (!cond) {
 		cond = g_malloc0 (sizeof(GCond));
 		g_cond_init (cond);
-		g_tree_replace (m->conditions, g_strdup(k), cond);
+		g_tree_replace (S->conditions, g_strdup(k), cond);
 	}
 	return cond;
 }
 
 static struct election_member_s *
-_LOCKED_init_member(struct election_manager_s *manager,
+_LOCKED_init_member(struct election_shard_s *shard,
 		const struct sqlx_name_s *n, const char *key,
 		gboolean autocreate, gchar ***peers)
 {
+	struct election_manager_s *manager = shard->manager;
 	MANAGER_CHECK(manager);
 	NAME_CHECK(n);
 
-	struct election_member_s *member = _LOCKED_get_member (manager, key);
+	struct election_member_s *member = _LOCKED_get_member (shard, key);
 	if (!member && autocreate) {
 
 		/* Shard the election on the ZK ensembles, taking into account the
@@ -1212,21 +1293,16 @@ _LOCKED_init_member(struct election_manager_s *manager,
 			sync = manager->sync_tab[0];
 		} else if (manager->sync_nb > 1) {
 			guint16 id_shard = 0, id_mux = 0;
-			gchar str_uint16[5];
 
 			EXTRA_ASSERT(manager->mux_factor * manager->nb_shards == manager->sync_nb);
 
-			/* The oio_str_bin2hex() requires the source string to be not
-			 * too long. */
 			const gsize len = strlen(key);
 			if (manager->nb_shards > 1) {
-				g_strlcpy(str_uint16, key + len - 4, sizeof(str_uint16));
-				if (!oio_str_hex2bin(str_uint16, (guint8 *) &id_shard, sizeof(id_shard)))
+				if (!_key_to_uint16(key, len, &id_shard))
 					return NULL;
 			}
 			if (manager->mux_factor > 1) {
-				g_strlcpy(str_uint16, key + len - 8, sizeof(str_uint16));
-				if (!oio_str_hex2bin(str_uint16, (guint8 *) &id_mux, sizeof(id_mux)))
+				if (!_key_to_uint16(key, len - 4, &id_mux))
 					return NULL;
 			}
 
@@ -1247,6 +1323,7 @@ _LOCKED_init_member(struct election_manager_s *manager,
 		member->sync = sync;
 		member->generation_id = oio_ext_rand_int();
 		member->manager = manager;
+		member->shard = shard;
 		member->last_status = oio_ext_monotonic_time ();
 		g_strlcpy(member->key, key, sizeof(member->key));
 		g_strlcpy(member->inline_name.base, n->base, sizeof(member->inline_name.base));
@@ -1254,17 +1331,17 @@ _LOCKED_init_member(struct election_manager_s *manager,
 		g_strlcpy(member->inline_name.suffix, n->suffix, sizeof(member->inline_name.suffix));
 		g_strlcpy(member->inline_name.ns, n->ns, sizeof(member->inline_name.ns));
 		member->refcount = 2;
-		member->cond = _manager_get_condition(manager, member->key);
+		member->cond = _shard_get_condition(shard, member->key);
 		if (peers && *peers) {
 			member->peers = *peers;
 			*peers = NULL;
 		}
 
 		_DEQUE_add (member);
-		g_tree_replace(manager->members_by_key, member->key, member);
+		g_tree_replace(shard->members_by_key, member->key, member);
 	}
 
-	TRACE_EXECUTION(manager);
+	TRACE_EXECUTION(shard);
 	return member;
 }
 
@@ -1295,7 +1372,7 @@ election_manager_is_operational(struct election_manager_s *manager)
 			manager->vtable != NULL &&
 			manager->peering != NULL &&
 			manager->config != NULL &&
-			manager->members_by_key != NULL);
+			manager->shards[0].members_by_key != NULL);
 }
 
 void
@@ -1313,14 +1390,17 @@ election_manager_exit_all(struct election_manager_s *manager,
 	gint64 deadline = oio_ext_monotonic_time() + duration;
 
 	/* Order the nodes to exit */
-	_manager_lock(manager);
 	manager->exiting = TRUE;
-	g_tree_foreach(manager->members_by_key, _run_exit,
-			leave_cleanly?
-				GINT_TO_POINTER(EVT_LEAVE_REQ)
-				: GINT_TO_POINTER(EVT_DISCONNECTED)
-	);
-	_manager_unlock(manager);
+	for (guint i = 0; i < ELECTION_SHARDS; i++) {
+		struct election_shard_s *shard = manager->shards + i;
+		_shard_lock(shard);
+		g_tree_foreach(shard->members_by_key, _run_exit,
+				leave_cleanly?
+					GINT_TO_POINTER(EVT_LEAVE_REQ)
+					: GINT_TO_POINTER(EVT_DISCONNECTED)
+		);
+		_shard_unlock(shard);
+	}
 
 	guint count = manager_count_active(manager);
 	if (duration <= 0) {
@@ -1424,9 +1504,10 @@ election_manager_whatabout (struct election_manager_s *m,
 
 	gchar key[OIO_ELECTION_KEY_LIMIT_LENGTH];
 	sqliterepo_hash_name(n, key, sizeof(key));
+	struct election_shard_s *shard = _manager_get_shard(m, key, strlen(key));
 
-	_manager_lock(m);
-	struct election_member_s *member = _LOCKED_get_member(m, key);
+	_shard_lock(shard);
+	struct election_member_s *member = _LOCKED_get_member(shard, key);
 	if (member) {
 		member_json (member, out);
 		member_unref (member);
@@ -1436,7 +1517,7 @@ election_manager_whatabout (struct election_manager_s *m,
 		else
 			g_string_append_static (out, "null");
 	}
-	_manager_unlock (m);
+	_shard_unlock (shard);
 }
 
 /* --- Zookeeper callbacks ----------------------------------------------------
@@ -1448,8 +1529,8 @@ election_manager_whatabout (struct election_manager_s *m,
  * them to recover the right election.
  * -------------------------------------------------------------------------- */
 
-#define completion_do_or_defer(M,Ctx) do { \
-	metautils_gthreadpool_push("ZK", (M)->completions, (Ctx)); \
+#define completion_do_or_defer(S,Ctx) do { \
+	metautils_gthreadpool_push("ZK", (S)->completions, (Ctx)); \
 } while (0)
 
 static void
@@ -1497,7 +1578,7 @@ deferred_completion_CREATING(struct exec_later_CREATING_context_s *d)
 	member_lock(d->member);
 	member_log_completion("CREATE", d->zrc, d->member);
 	_thlocal_set_manager (d->member->manager);
-	TRACE_EXECUTION(d->member->manager);
+	TRACE_EXECUTION(d->member->shard);
 
 #ifdef HAVE_ENBUG
 	if (oio_ext_rand_int_range(1,100) > oio_sync_failure_threshold_action) {
@@ -1530,9 +1611,8 @@ completion_CREATING(int zrc, const char *path, const void *d)
 	if (path)
 		_extract_id(path, &ctx->local_id);
 
-	struct election_manager_s *M = ctx->member->manager;
-	_thlocal_set_manager(M);
-	completion_do_or_defer(M, ctx);
+	_thlocal_set_manager(ctx->member->manager);
+	completion_do_or_defer(ctx->member->shard, ctx);
 }
 
 /* @private */
@@ -1576,8 +1656,7 @@ completion_WATCHING(int zrc, const struct Stat *s UNUSED, const void *d)
 	ctx->zrc = zrc;
 	ctx->member = (struct election_member_s*) d;
 
-	struct election_manager_s *M = ctx->member->manager;
-	completion_do_or_defer(M, ctx);
+	completion_do_or_defer(ctx->member->shard, ctx);
 }
 
 /* @private */
@@ -1623,14 +1702,14 @@ deferred_completion_ASKING(struct exec_later_ASKING_context_s *d)
 				int zrc2 = sqlx_sync_adelete(d->member->sync,
 						member_masterpath(d->member, path, sizeof(path)), -1,
 						completion_DeleteRogueNode, NULL);
-				TRACE_EXECUTION(d->member->manager);
+				TRACE_EXECUTION(d->member->shard);
 
 				if (zrc2 != ZOK) {
 					GRID_WARN("Failed to delete Rogue ZK node %s: %s", path, zerror(zrc2));
 				} else {
 					GRID_WARN("Rogue ZK node being deleted %s", path);
 				}
-				TRACE_EXECUTION(d->member->manager);
+				TRACE_EXECUTION(d->member->shard);
 
 				transition(d->member, EVT_MASTER_BAD, NULL);
 			} else if (!oio_strv_has(peers, d->master)) {
@@ -1669,8 +1748,7 @@ completion_ASKING(int zrc, const char *v, int vlen,
 	if (vlen)
 		memcpy(ctx->master, v, vlen);
 
-	struct election_manager_s *M = ctx->member->manager;
-	completion_do_or_defer(M, ctx);
+	completion_do_or_defer(ctx->member->shard, ctx);
 }
 
 /* @private */
@@ -1744,8 +1822,7 @@ completion_LISTING(int zrc, const struct String_vector *sv, const void *d)
 	ctx->member = member;
 	ctx->master_id = first;
 
-	struct election_manager_s *M = ctx->member->manager;
-	completion_do_or_defer(M, ctx);
+	completion_do_or_defer(ctx->member->shard, ctx);
 }
 
 /* @private */
@@ -1807,8 +1884,7 @@ completion_LEAVING(int zrc, const void *d)
 	ctx->zrc = zrc;
 	ctx->member = (struct election_member_s*) d;
 
-	struct election_manager_s *M = ctx->member->manager;
-	completion_do_or_defer(M, ctx);
+	completion_do_or_defer(ctx->member->shard, ctx);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -1832,8 +1908,9 @@ _find_member (struct election_manager_s *M, const char *path, guint gen)
 	memcpy(key, slash, len);
 	key[len] = 0;
 
-	_manager_lock(M);
-	struct election_member_s *member = _LOCKED_get_member(M, key);
+	struct election_shard_s *shard = _manager_get_shard(M, key, len);
+	_shard_lock(shard);
+	struct election_member_s *member = _LOCKED_get_member(shard, key);
 	if (member) {
 		if (member->generation_id == gen)
 			return member;
@@ -1845,7 +1922,7 @@ _find_member (struct election_manager_s *M, const char *path, guint gen)
 		 * that have already left. */
 		GRID_DEBUG("watcher: [%s] no election found", key);
 	}
-	_manager_unlock(M);
+	_shard_unlock(shard);
 	return NULL;
 }
 
@@ -1857,21 +1934,24 @@ _reset_matching_members(struct election_manager_s *M, zhandle_t *zh,
 		enum election_step_e step)
 {
 	guint count = 0;
-	_manager_lock(M);
-	struct deque_beacon_s *beacon = M->members_by_state + step;
-	struct election_member_s *member = beacon->front;
-	while (member != NULL) {
-		if (step == member->step && sqlx_sync_uses_handle(member->sync, zh)) {
-			count++;
-			member_reset(member);
-			member_log_change(member, EVT_DISCONNECTED,
-					member_set_status(member, STEP_NONE));
-			member = beacon->front;
-		} else {
-			member = member->next;
+	for (guint i = 0; i < ELECTION_SHARDS; i++) {
+		struct election_shard_s *shard = M->shards + i;
+		_shard_lock(shard);
+		struct deque_beacon_s *beacon = shard->members_by_state + step;
+		struct election_member_s *member = beacon->front;
+		while (member != NULL) {
+			if (step == member->step && sqlx_sync_uses_handle(member->sync, zh)) {
+				count++;
+				member_reset(member);
+				member_log_change(member, EVT_DISCONNECTED,
+						member_set_status(member, STEP_NONE));
+				member = beacon->front;
+			} else {
+				member = member->next;
+			}
 		}
+		_shard_unlock(shard);
 	}
-	_manager_unlock(M);
 	return count;
 }
 
@@ -1914,7 +1994,7 @@ deferred_watch_COMMON(struct deferred_watcher_context_s *d,
 			member_log_change(member, EVT_DISCONNECTED,
 					member_set_status(member, STEP_NONE));
 		// Not under lock but it's just a read operation
-		} else if (M->members_by_state[STEP_MASTER].count > 0) {
+		} else if (_NOLOCK_count_step(M, STEP_MASTER) > 0) {
 #if ZOO_35
 			GRID_WARN("Got ZK session event (-> %s) for an unknown election, "
 					"resetting all local elections using %s and "
@@ -1996,7 +2076,14 @@ watch_COMMON(zhandle_t *h, const int type, const int state,
 	if (slash && len)
 		memcpy(ctx->path, slash, len);
 
-	completion_do_or_defer(M, ctx);
+	/* Play the event in the shard of the election it is about (the key is
+	 * the part of the node name before the sequence number), so that it
+	 * is ordered with the completions of the same election. */
+	const char *stripe = slash ? strchr(slash, '-') : NULL;
+	struct election_shard_s *shard = M->shards;
+	if (stripe)
+		shard = _manager_get_shard(M, slash + 1, stripe - slash - 1);
+	completion_do_or_defer(shard, ctx);
 }
 
 static void
@@ -2062,7 +2149,7 @@ _worker_getpeers(struct election_member_s *m, struct election_manager_s *M)
 		transition(m, EVT_GETPEERS_DONE, peers);
 	}
 	member_unref(m);
-	TRACE_EXECUTION(m->manager);
+	TRACE_EXECUTION(m->shard);
 	member_unlock(m);
 
 	if (peers)
@@ -2148,15 +2235,16 @@ _election_make(struct election_manager_s *m, const struct sqlx_name_s *n,
 	gboolean peers_present = FALSE;
 
 	sqliterepo_hash_name(n, key, sizeof(key));
+	struct election_shard_s *shard = _manager_get_shard(m, key, strlen(key));
 
-	_manager_lock(m);
-	member = _LOCKED_get_member(m, key);
+	_shard_lock(shard);
+	member = _LOCKED_get_member(shard, key);
 	if (member != NULL) {
 		peers_present = member->peers != NULL && member->peers[0] != NULL;
 		member_unref(member);
 		member = NULL;
 	}
-	_manager_unlock(m);
+	_shard_unlock(shard);
 
 	if (op != ELOP_EXIT && !peers_present) {
 		if (oio_str_is_set(new_peers)) {
@@ -2178,8 +2266,8 @@ _election_make(struct election_manager_s *m, const struct sqlx_name_s *n,
 	if (peers_present && replicated)
 		*replicated = TRUE;
 
-	_manager_lock(m);
-	member = _LOCKED_init_member(m, n, key, op != ELOP_EXIT, &peers);
+	_shard_lock(shard);
+	member = _LOCKED_init_member(shard, n, key, op != ELOP_EXIT, &peers);
 	switch (op) {
 		case ELOP_NONE:
 			_election_atime(member);
@@ -2212,7 +2300,7 @@ _election_make(struct election_manager_s *m, const struct sqlx_name_s *n,
 			*out_status = member->step;
 		member_unref(member);
 	}
-	_manager_unlock(m);
+	_shard_unlock(shard);
 
 	g_strfreev(peers);
 	return NULL;
@@ -2357,11 +2445,11 @@ wait_for_final_status(struct election_member_s *m, const gint64 deadline,
 				m->when_unstable / G_TIME_SPAN_SECOND, now / G_TIME_SPAN_SECOND);
 
 		/* perform the real WAIT on the real clock. */
-		TRACE_EXECUTION(m->manager);
-		_manage_dump_activity(m->manager);
+		TRACE_EXECUTION(m->shard);
+		_shard_dump_activity(m->shard);
 		g_cond_wait_until(member_get_cond(m), member_get_lock(m),
 				g_get_monotonic_time() + oio_election_period_cond_wait);
-		_manager_save_locked(m->manager);
+		_shard_save_locked(m->shard);
 	}
 
 	m->last_atime = oio_ext_monotonic_time ();
@@ -2386,8 +2474,9 @@ _election_get_status(struct election_manager_s *mgr,
 	const gint64 local_deadline = start + oio_election_delay_wait;
 	deadline = (deadline <= 0) ? local_deadline : MIN(deadline, local_deadline);
 
-	_manager_lock(mgr);
-	struct election_member_s *m = _LOCKED_init_member(mgr, n, key, TRUE, NULL);
+	struct election_shard_s *shard = _manager_get_shard(mgr, key, strlen(key));
+	_shard_lock(shard);
+	struct election_member_s *m = _LOCKED_init_member(shard, n, key, TRUE, NULL);
 
 	if (!wait_for_final_status(m, deadline, err)) {  /* TIMEOUT! */
 		rc = STEP_FAILED;
@@ -2402,7 +2491,7 @@ _election_get_status(struct election_manager_s *mgr,
 	member_unref(m);
 	if (rc == STEP_NONE || STATUS_FINAL(rc))
 		member_signal(m);
-	_manager_unlock(mgr);
+	_shard_unlock(shard);
 
 	GRID_TRACE("STEP=%s/%d master=%s", _step2str(rc), rc, url);
 	switch (rc) {
@@ -2459,10 +2548,10 @@ defer_USE(struct election_member_s *member, const gboolean master)
 		gchar *all_peers = _member_all_peers(member);
 		member->last_USE = oio_ext_monotonic_time();
 		for (gchar **p = member->peers; *p; p++) {
-			member->manager->deferred_peering_notify |= sqlx_peering__use(
+			member->shard->deferred_peering_notify |= sqlx_peering__use(
 					member->manager->peering, *p, &member->inline_name,
 					all_peers, master);
-			TRACE_EXECUTION(member->manager);
+			TRACE_EXECUTION(member->shard);
 		}
 		g_free(all_peers);
 	}
@@ -2694,7 +2783,7 @@ _common_action_to_LEAVE(struct election_member_s *member,
 #endif
 	zrc = sqlx_sync_adelete(
 			member->sync, path, -1, completion_LEAVING, member);
-	TRACE_EXECUTION(member->manager);
+	TRACE_EXECUTION(member->shard);
 
 	if (unlikely(zrc != ZOK))
 		return member_fail_on_error(member, zrc);
@@ -2757,7 +2846,7 @@ member_action_to_CREATING(struct election_member_s *member)
 			myurl, strlen(myurl),
 			ZOO_EPHEMERAL|ZOO_SEQUENCE,
 			completion_CREATING, member);
-	TRACE_EXECUTION(member->manager);
+	TRACE_EXECUTION(member->shard);
 
 	if (unlikely(zrc != ZOK)) {
 		member_warn_failed_action(member, zrc, "CREATE");
@@ -2789,7 +2878,7 @@ member_action_to_WATCHING(struct election_member_s *member)
 			member_fullpath(member, path, sizeof(path)),
 			watch_SELF, GUINT_TO_POINTER(member->generation_id),
 			completion_WATCHING, member);
-	TRACE_EXECUTION(member->manager);
+	TRACE_EXECUTION(member->shard);
 
 	if (unlikely(zrc != ZOK)) {
 		member_warn_failed_action(member, zrc, "WATCH");
@@ -2814,7 +2903,7 @@ member_action_to_LISTING(struct election_member_s *member)
 	int zrc = sqlx_sync_awget_siblings(member->sync,
 			member_fullpath(member, path, sizeof(path)),
 			NULL, NULL, completion_LISTING, member);
-	TRACE_EXECUTION(member->manager);
+	TRACE_EXECUTION(member->shard);
 
 	if (unlikely(zrc != ZOK)) {
 		member_warn_failed_action(member, zrc, "LIST");
@@ -2844,7 +2933,7 @@ member_action_to_ASKING(struct election_member_s *member)
 			member_masterpath(member, path, sizeof(path)),
 			watch_MASTER, GUINT_TO_POINTER(member->generation_id),
 			completion_ASKING, member);
-	TRACE_EXECUTION(member->manager);
+	TRACE_EXECUTION(member->shard);
 
 	if (unlikely(zrc != ZOK)) {
 		member_warn_failed_action(member, zrc, "ASK");
@@ -2875,11 +2964,11 @@ member_action_to_SYNCING(struct election_member_s *member)
 	member->when_unstable = oio_ext_monotonic_time();
 
 	member_ref(member);
-	member->manager->deferred_peering_notify |= sqlx_peering__pipefrom(
+	member->shard->deferred_peering_notify |= sqlx_peering__pipefrom(
 			member->manager->peering, target, &member->inline_name, source,
 			member->db_check_type,
 			member, 0, _result_PIPEFROM);
-	TRACE_EXECUTION(member->manager);
+	TRACE_EXECUTION(member->shard);
 
 	return member_set_status(member, STEP_SYNCING);
 }
@@ -2948,10 +3037,10 @@ member_action_to_CHECKING_MASTER(struct election_member_s *m)
 
 	gchar *all_peers = _member_all_peers(m);
 	member_ref(m);
-	m->manager->deferred_peering_notify |= sqlx_peering__getvers(
+	m->shard->deferred_peering_notify |= sqlx_peering__getvers(
 			m->manager->peering, m->master_url, &m->inline_name, all_peers,
 			m, 0, _result_GETVERS);
-	TRACE_EXECUTION(m->manager);
+	TRACE_EXECUTION(m->shard);
 	g_free(all_peers);
 
 	return member_set_status(m, STEP_CHECKING_MASTER);
@@ -2984,10 +3073,10 @@ member_action_to_CHECKING_SLAVES(struct election_member_s *m)
 	gchar *all_peers = _member_all_peers(m);
 	for (gchar **p=m->peers; *p; p++) {
 		member_ref(m);
-		m->manager->deferred_peering_notify |= sqlx_peering__getvers(
+		m->shard->deferred_peering_notify |= sqlx_peering__getvers(
 				m->manager->peering, *p, &m->inline_name, all_peers,
 				m, 0, _result_GETVERS);
-		TRACE_EXECUTION(m->manager);
+		TRACE_EXECUTION(m->shard);
 	}
 	g_free(all_peers);
 
@@ -3511,12 +3600,12 @@ _member_react_PEERING(struct election_member_s *member,
 		case EVT_GETPEERS_DONE:
 			member_reset_peers(member);
 			member->peers = g_strdupv(peers);
-			TRACE_EXECUTION(member->manager);
+			TRACE_EXECUTION(member->shard);
 			if (!member->peers)
 				member_action_to_FAILED(member);
 			else
 				member_action_to_CREATING(member);
-			TRACE_EXECUTION(member->manager);
+			TRACE_EXECUTION(member->shard);
 			return;
 
 			/* Abnormal events */
@@ -4377,7 +4466,7 @@ transition(struct election_member_s *member, enum event_type_e evt,
 {
 	member_log_change(member, evt,
 			_member_react(member, evt, evt_arg);
-			TRACE_EXECUTION(member->manager));
+			TRACE_EXECUTION(member->shard));
 
 	/* re-kickoff elections marked as to be restarted, but only if without
 	 * activity and if the manager if not being exited. */
@@ -4386,7 +4475,7 @@ transition(struct election_member_s *member, enum event_type_e evt,
 			&& !member->manager->exiting) {
 		member_log_change(member, EVT_NONE,
 			_member_react(member, EVT_NONE, NULL);
-			TRACE_EXECUTION(member->manager));
+			TRACE_EXECUTION(member->shard));
 	}
 }
 
@@ -4407,35 +4496,42 @@ _member_expirable(struct election_member_s *m, const gint64 now)
 		&& _is_over(now, m->last_status, oio_election_delay_expire_NONE);
 }
 
-void
-election_manager_play_expirations(struct election_manager_s *M, const gint64 now)
+static void
+_shard_play_expirations(struct election_shard_s *S, const gint64 now)
 {
-	struct deque_beacon_s *beacon = M->members_by_state + STEP_NONE;
+	struct deque_beacon_s *beacon = S->members_by_state + STEP_NONE;
 
 	while (beacon->front) {
-		_manager_lock(M);
+		_shard_lock(S);
 		struct election_member_s *m = beacon->front;
 		if (!m || !_member_expirable(m, now)) {
-			_manager_unlock(M);
+			_shard_unlock(S);
 			break;
 		} else {
 			_DEQUE_remove (m);
-			g_tree_remove (M->members_by_key, m->key);
+			g_tree_remove (S->members_by_key, m->key);
 			member_unref (m);
 			member_destroy (m);
-			_manager_unlock(M);
+			_shard_unlock(S);
 		}
 	}
 }
 
+void
+election_manager_play_expirations(struct election_manager_s *M, const gint64 now)
+{
+	for (guint i = 0; i < ELECTION_SHARDS; i++)
+		_shard_play_expirations(M->shards + i, now);
+}
+
 static void
-_send_NONE_to_step(struct election_manager_s *M, struct deque_beacon_s *beacon,
+_send_NONE_to_step(struct election_shard_s *S, struct deque_beacon_s *beacon,
 		const gint64 now)
 {
 	gboolean stop = FALSE;
 
 	while (beacon->front && !stop) {
-		_manager_lock(M);
+		_shard_lock(S);
 		struct election_member_s *m = beacon->front;
 		if (!m) {
 			/* The queue emptied before the lock */
@@ -4456,7 +4552,7 @@ _send_NONE_to_step(struct election_manager_s *M, struct deque_beacon_s *beacon,
 				}
 			}
 		}
-		_manager_unlock(M);
+		_shard_unlock(S);
 	}
 }
 
@@ -4470,11 +4566,24 @@ election_manager_balance_masters(struct election_manager_s *M, guint max,
 	if (inactivity > 0)
 		pivot = OLDEST(oio_ext_monotonic_time(), inactivity);
 
-	for (gboolean running = TRUE; running && count < max;) {
-		_manager_lock(M);
-		struct election_member_s *current = M->members_by_state[STEP_MASTER].front;
+	/* Take one base per shard and per round, starting with the shard after
+	 * the last one of the previous call, so that the shards are evenly
+	 * balanced when <max> is small. */
+	gboolean running[ELECTION_SHARDS];
+	for (guint i = 0; i < ELECTION_SHARDS; i++)
+		running[i] = TRUE;
+	guint cursor = M->balance_cursor;
+
+	for (guint active = ELECTION_SHARDS; active > 0 && count < max;) {
+		const guint idx = cursor++ % ELECTION_SHARDS;
+		if (!running[idx])
+			continue;
+		struct election_shard_s *shard = M->shards + idx;
+		_shard_lock(shard);
+		struct election_member_s *current = shard->members_by_state[STEP_MASTER].front;
 		if (!current || (pivot > 0 && current->last_atime < pivot)) {
-			running = FALSE;
+			running[idx] = FALSE;
+			-- active;
 		} else {
 			/* Tell the first base to leave its MASTER position but to re-join
 			 * immediately after. */
@@ -4482,9 +4591,10 @@ election_manager_balance_masters(struct election_manager_s *M, guint max,
 			transition(current, EVT_LEAVE_REQ, NULL);
 			++ count;
 		}
-		_manager_unlock(M);
+		_shard_unlock(shard);
 	}
 
+	M->balance_cursor = cursor % ELECTION_SHARDS;
 	return count;
 }
 
@@ -4515,15 +4625,18 @@ election_manager_next_timer(struct election_manager_s *M)
 
 	gint64 latest = G_MAXINT64;
 
-	_manager_lock(M);
-	for (int i=0; steps[i] != -1 ;i++) {
-		const struct election_member_s *m = M->members_by_state[steps[i]].front;
-		if (!m)
-			continue;
-		const gint64 expiration = _member_next_timeout(m);
-		latest = MIN(latest, expiration);
+	for (guint s = 0; s < ELECTION_SHARDS; s++) {
+		struct election_shard_s *shard = M->shards + s;
+		_shard_lock(shard);
+		for (int i=0; steps[i] != -1 ;i++) {
+			const struct election_member_s *m = shard->members_by_state[steps[i]].front;
+			if (!m)
+				continue;
+			const gint64 expiration = _member_next_timeout(m);
+			latest = MIN(latest, expiration);
+		}
+		_shard_unlock(shard);
 	}
-	_manager_unlock(M);
 
 	return latest == G_MAXINT64 ? 0 : latest;
 }
@@ -4542,8 +4655,11 @@ election_manager_play_timers(struct election_manager_s *M, const gint64 now)
 	};
 
 	oio_ext_set_prefixed_random_reqid("eltimer-");
-	for (int i=0; steps[i] != -1 ;i++)
-		_send_NONE_to_step(M, M->members_by_state + steps[i], now);
+	for (guint s = 0; s < ELECTION_SHARDS; s++) {
+		struct election_shard_s *shard = M->shards + s;
+		for (int i=0; steps[i] != -1 ;i++)
+			_send_NONE_to_step(shard, shard->members_by_state + steps[i], now);
+	}
 }
 
 GError*
@@ -4557,8 +4673,9 @@ election_check_replication_allowed(struct election_manager_s *manager,
 	GError *err = NULL;
 	gchar key[OIO_ELECTION_KEY_LIMIT_LENGTH];
 	sqliterepo_hash_name(n, key, sizeof(key));
-	_manager_lock(manager);
-	struct election_member_s *member = _LOCKED_get_member(manager, key);
+	struct election_shard_s *shard = _manager_get_shard(manager, key, strlen(key));
+	_shard_lock(shard);
+	struct election_member_s *member = _LOCKED_get_member(shard, key);
 	if (member) {
 		if (member->step == STEP_MASTER
 				|| member->step == STEP_CHECKING_SLAVES) {
@@ -4574,7 +4691,7 @@ election_check_replication_allowed(struct election_manager_s *manager,
 		}
 		member_unref(member);
 	}
-	_manager_unlock(manager);
+	_shard_unlock(shard);
 	return err;
 }
 
@@ -4588,9 +4705,10 @@ election_get_status_nowait(struct election_manager_s *manager,
 	enum election_status_e status = 0;  // No status
 	gchar key[OIO_ELECTION_KEY_LIMIT_LENGTH];
 	sqliterepo_hash_name(n, key, sizeof(key));
+	struct election_shard_s *shard = _manager_get_shard(manager, key, strlen(key));
 
-	_manager_lock(manager);
-	struct election_member_s *member = _LOCKED_get_member(manager, key);
+	_shard_lock(shard);
+	struct election_member_s *member = _LOCKED_get_member(shard, key);
 	if (member) {
 		switch (member->step) {
 		case STEP_FAILED:
@@ -4613,7 +4731,7 @@ election_get_status_nowait(struct election_manager_s *manager,
 		}
 		member_unref(member);
 	}
-	_manager_unlock(manager);
+	_shard_unlock(shard);
 
 	return status;
 }
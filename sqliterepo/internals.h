@@ -49,7 +49,7 @@ License along with this library.
 	EXTRA_ASSERT((M)->vtable); \
 	EXTRA_ASSERT(((M)->sync_nb <= 0) || ((M)->sync_tab != NULL && (M)->sync_tab[0] != NULL)); \
 	EXTRA_ASSERT((M)->peering); \
-	EXTRA_ASSERT((M)->members_by_key != NULL);\
+	EXTRA_ASSERT((M)->shards[0].members_by_key != NULL);\
 	CONFIG_CHECK((M)->config); \
 } while (0)
 
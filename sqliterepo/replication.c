@@ -30,6 +30,8 @@ License along with this library.
 #include "election.h"
 #include "version.h"
 #include "sqlx_remote.h"
+#include "sqlx_macros.h"
+#include "cache.h"
 #include "internals.h"
 
 struct sqlx_repctx_s
@@ -49,6 +51,10 @@ struct sqlx_repctx_s
 
 	GString *errors;
 
+	// The peers the changes are replicated to, when the replication happens
+	// after the local commit.
+	gchar **peers;
+
 	// Count the explicit changes, those matched
 	int changes;
 	guint8 local_changes : 1;
@@ -63,8 +69,50 @@ struct sqlx_repctx_s
 	guint8 huge : 1;
 
 	guint8 any_change : 1;
+
+	// if set, the changes are left uncommitted in the transaction held by the
+	// group of the base, until they are replicated with those of the other
+	// transactions of the group.
+	guint8 grouped : 1;
+
+	// if set, the transaction runs in a savepoint of the transaction held by
+	// the group of the base.
+	guint8 nested : 1;
+};
+
+/* A transaction whose changes wait, uncommitted, to be replicated. */
+struct repli_ticket_s
+{
+	TableSequence_t *sequence;
+	gchar **peers;
+	gint64 deadline;
+	GError *err;
+	gboolean huge; // some changes were not captured, the peers need a resync
+	gboolean done;
+};
+
+/* The transactions of a base waiting to be replicated, in their order of
+ * execution. They all run in one SQLite transaction, held open until their
+ * replication. One thread at a time (the leader) takes the base back, sends
+ * the changes of all of them in one request, then commits or rolls back the
+ * whole transaction. The others wait for the outcome. */
+struct repli_group_s
+{
+	guint refcount;
+	GCond cond;
+	GPtrArray *queue; // <struct repli_ticket_s*>
+	gint64 first; // when the oldest transaction of the queue was queued
+	gboolean flushing;
 };
 
+/* Keyed by the handle of the base, that cannot be closed while some
+ * transactions wait for their replication. */
+static GMutex repli_groups_lock;
+static GHashTable *repli_groups = NULL; // <struct sqlx_sqlite3_s*,struct repli_group_s*>
+
+/* Delimits each transaction running within the one held by a group */
+#define GROUP_SAVEPOINT "sqlx_repli_group"
+
 static guint
 group_to_quorum(guint group_size)
 {
@@ -354,8 +402,11 @@ _leave_election(gchar **peers, struct sqlx_repctx_s *ctx, gboolean local,
 	gridd_clients_free(clients);
 }
 
+/* Send the sequences of changes in one request: a DB_REPLI if there is only
+ * one of them, a DB_REPLI_MANY otherwise. */
 static GError*
-_replicate_on_peers(gchar **peers, struct sqlx_repctx_s *ctx, gint64 deadline)
+_replicate_on_peers(gchar **peers, struct sqlx_repctx_s *ctx,
+		TableSequence_t **seqs, guint count, gint64 deadline)
 {
 	guint count_success = 0;
 	guint other_master = 0;
@@ -363,12 +414,23 @@ _replicate_on_peers(gchar **peers, struct sqlx_repctx_s *ctx, gint64 deadline)
 	guint slave_behind = 0;
 
 	NAME2CONST(n, ctx->sq3->name);
-	dump_request(__FUNCTION__, peers, "SQLX_REPLICATE", &n);
+	dump_request(__FUNCTION__, peers,
+			count > 1 ? "SQLX_REPLICATE_MANY" : "SQLX_REPLICATE", &n);
 
 	// Local address or service ID
 	const gchar *local_addr = election_manager_get_local(ctx->sq3->manager);
-	GByteArray *encoded = sqlx_pack_REPLICATE(
-			&n, &(ctx->sequence), local_addr, deadline);
+	GByteArray *encoded = NULL;
+	if (count > 1) {
+		GError *err = NULL;
+		encoded = sqlx_pack_REPLICATE_MANY(
+				&n, seqs, count, local_addr, deadline, &err);
+		if (!encoded) {
+			g_prefix_error(&err, "Failed to pack the replication request: ");
+			return err;
+		}
+	} else {
+		encoded = sqlx_pack_REPLICATE(&n, seqs[0], local_addr, deadline);
+	}
 	struct gridd_client_s **clients =
 		gridd_client_create_many(peers, encoded, NULL, NULL);
 	g_byte_array_unref(encoded);
@@ -558,7 +620,8 @@ _perform_REPLICATE(struct sqlx_repctx_s *ctx)
 		err = NEWERROR(
 				CODE_CONCURRENT, "Election status changed during transaction");
 	} else {
-		err = _replicate_on_peers(peers, ctx, oio_ext_get_deadline());
+		TableSequence_t *seq = &(ctx->sequence);
+		err = _replicate_on_peers(peers, ctx, &seq, 1, oio_ext_get_deadline());
 	}
 	g_strfreev(peers);
 	context_flush_rowsets(ctx);
@@ -636,28 +699,126 @@ hook_update(struct sqlx_repctx_s *ctx, int op, char const *bn, char const *tn,
 			GUINT_TO_POINTER(u));
 }
 
+/* Bring the peer up to date with only the extents of the base that differ
+ * on its side. On any error, the caller falls back on a whole DUMP. */
+static GError *
+_resync_delta(struct sqlx_repctx_s *ctx, const gchar *peer,
+		const gchar *local_addr)
+{
+	GByteArray *checksums = NULL, *delta = NULL;
+	NAME2CONST(n, ctx->sq3->name);
+
+	GError *err = peer_checksum(peer, &n, sqliterepo_dump_delta_extent,
+			&checksums, oio_ext_get_deadline());
+	if (!err) {
+		err = sqlx_repository_diff_base(ctx->sq3, sqliterepo_dump_check_type,
+				checksums->data, checksums->len, &delta);
+		g_byte_array_unref(checksums);
+	}
+	if (!err) {
+		const guint delta_size = delta->len;
+		err = peer_patch(peer, &n, delta, local_addr, oio_ext_get_deadline());
+		if (!err)
+			GRID_INFO("PATCHED on SLAVE %s [%s][%s] with %u bytes reqid=%s",
+					peer, ctx->sq3->name.base, ctx->sq3->name.type,
+					delta_size, oio_ext_get_reqid());
+	}
+	return err;
+}
+
+/* Dump the base with the chunked reader, as one zlib stream: only the
+ * compressed dump is held in memory. */
+static GError *
+_dump_compressed(struct sqlx_sqlite3_s *sq3, GByteArray **result)
+{
+	GByteArray *dump = g_byte_array_new();
+	GError *_append_part(GByteArray *part, gint64 remaining UNUSED,
+			gpointer u UNUSED) {
+		g_byte_array_append(dump, part->data, part->len);
+		g_byte_array_unref(part);
+		return NULL;
+	}
+
+	GError *err = sqlx_repository_dump_base_chunked(sq3,
+			sqliterepo_dump_chunk_size, sqliterepo_dump_check_type,
+			sqliterepo_dump_compression_level, _append_part, NULL);
+	if (err) {
+		g_byte_array_unref(dump);
+	} else {
+		GRID_DEBUG("[%s][%s] DUMP compressed into %u bytes",
+				sq3->name.base, sq3->name.type, dump->len);
+		*result = dump;
+	}
+	return err;
+}
+
 static GError *
 sqlx_synchronous_resync(struct sqlx_repctx_s *ctx, gchar **peers)
 {
 	GByteArray *dump;
 	GError *err;
+	GPtrArray *remaining = NULL;
+
+	if (sqliterepo_dump_delta_extent > 0) {
+		const gchar *local_addr = election_manager_get_local(ctx->sq3->manager);
+		remaining = g_ptr_array_new();
+		for (gchar **p = peers; *p; p++) {
+			if (!(err = _resync_delta(ctx, *p, local_addr)))
+				continue;
+			GRID_INFO("[%s][%s] Delta resync failed on %s, "
+					"sending the whole base: (%d) %s reqid=%s",
+					ctx->sq3->name.base, ctx->sq3->name.type, *p,
+					err->code, err->message, oio_ext_get_reqid());
+			g_clear_error(&err);
+			g_ptr_array_add(remaining, *p);
+		}
+		if (!remaining->len) {
+			g_ptr_array_free(remaining, TRUE);
+			return NULL;
+		}
+		g_ptr_array_add(remaining, NULL);
+		peers = (gchar**) remaining->pdata;
+	}
 
-	// Generate the DUMP
-	err = sqlx_repository_dump_base_gba(ctx->sq3, sqliterepo_dump_check_type,
-			&dump);
+	// Generate the DUMP, compressed unless disabled
+	const gchar *compression = NULL;
+	if (sqliterepo_dump_compression_level > 0) {
+		compression = SQLX_DUMP_COMPRESSION_ZLIB;
+		err = _dump_compressed(ctx->sq3, &dump);
+	} else {
+		err = sqlx_repository_dump_base_gba(ctx->sq3,
+				sqliterepo_dump_check_type, &dump);
+	}
 	if (err) {
 		GRID_WARN("[%s][%s] Synchronous COMMIT not possible: (%d) %s reqid=%s",
 				ctx->sq3->name.base, ctx->sq3->name.type,
 				err->code, err->message, oio_ext_get_reqid());
 		// We did not do the operation, but we still have the quorum.
 		g_clear_error(&err);
+		if (remaining)
+			g_ptr_array_free(remaining, TRUE);
 		return NULL;
 	}
 
 	// Now send it to the SLAVES
 	NAME2CONST(n, ctx->sq3->name);
 	const gchar *local_addr = election_manager_get_local(ctx->sq3->manager);
-	err = peers_restore(peers, &n, dump, local_addr, oio_ext_get_deadline());
+	err = peers_restore(peers, &n, dump, compression, local_addr,
+			oio_ext_get_deadline());
+	if (err && compression && err->code != CODE_IS_MASTER
+			&& !CODE_IS_NETWORK_ERROR(err->code)) {
+		/* Some peers may be too old to inflate the dump */
+		GRID_INFO("[%s][%s] Compressed RESTORE failed, "
+				"sending the raw base: (%d) %s reqid=%s",
+				ctx->sq3->name.base, ctx->sq3->name.type,
+				err->code, err->message, oio_ext_get_reqid());
+		g_clear_error(&err);
+		err = sqlx_repository_dump_base_gba(ctx->sq3,
+				sqliterepo_dump_check_type, &dump);
+		if (!err)
+			err = peers_restore(peers, &n, dump, NULL, local_addr,
+					oio_ext_get_deadline());
+	}
 	if (err) {
 		GRID_ERROR("%s reqid=%s", err->message, oio_ext_get_reqid());
 		if (err->code == CODE_IS_MASTER) {
@@ -673,6 +834,8 @@ sqlx_synchronous_resync(struct sqlx_repctx_s *ctx, gchar **peers)
 		GRID_INFO("RESTORED on SLAVES [%s][%s] reqid=%s",
 				ctx->sq3->name.base, ctx->sq3->name.type, oio_ext_get_reqid());
 	}
+	if (remaining)
+		g_ptr_array_free(remaining, TRUE);
 	return err;
 }
 
@@ -688,6 +851,8 @@ sqlx_replication_free_context(struct sqlx_repctx_s *ctx)
 		g_ptr_array_free(ctx->resync_todo, TRUE);
 	if (ctx->errors)
 		g_string_free (ctx->errors, TRUE);
+	if (ctx->peers)
+		g_strfreev(ctx->peers);
 	g_slice_free(struct sqlx_repctx_s, ctx);
 }
 
@@ -704,7 +869,14 @@ _sqlx_transaction_rollback(struct sqlx_repctx_s *ctx, GError *err)
 	}
 
 	ctx->any_change = 0;
-	rc = sqlx_exec(ctx->sq3->db, "ROLLBACK");
+	if (ctx->nested) {
+		/* Only undo this transaction, the group goes on */
+		rc = sqlx_exec(ctx->sq3->db, "ROLLBACK TO " GROUP_SAVEPOINT);
+		if (rc == SQLITE_OK || rc == SQLITE_DONE)
+			rc = sqlx_exec(ctx->sq3->db, "RELEASE " GROUP_SAVEPOINT);
+	} else {
+		rc = sqlx_exec(ctx->sq3->db, "ROLLBACK");
+	}
 	if (rc != SQLITE_OK && rc != SQLITE_DONE) {
 		GRID_WARN("ROLLBACK failed! (%d/%s) %s reqid=%s", rc,
 				sqlite_strerror(rc), sqlite3_errmsg(ctx->sq3->db),
@@ -716,6 +888,298 @@ _sqlx_transaction_rollback(struct sqlx_repctx_s *ctx, GError *err)
 	sqlx_admin_reload(ctx->sq3);
 }
 
+/* Group commit ------------------------------------------------------------ */
+
+static gboolean
+_group_commit_allowed(struct sqlx_sqlite3_s *sq3)
+{
+	/* The base is yielded to the other requests while the replication is
+	 * pending, so it must be managed by the cache. */
+	return sqliterepo_repli_group_commit_delay > 0
+		&& sq3->repo->cache != NULL;
+}
+
+static struct repli_group_s *
+_group_ref_LOCKED(struct sqlx_sqlite3_s *sq3)
+{
+	if (!repli_groups)
+		repli_groups = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+	struct repli_group_s *group = g_hash_table_lookup(repli_groups, sq3);
+	if (!group) {
+		group = g_malloc0(sizeof(struct repli_group_s));
+		g_cond_init(&group->cond);
+		group->queue = g_ptr_array_new();
+		g_hash_table_insert(repli_groups, sq3, group);
+	}
+	group->refcount ++;
+	return group;
+}
+
+static void
+_group_unref_LOCKED(struct sqlx_sqlite3_s *sq3, struct repli_group_s *group)
+{
+	if (-- group->refcount > 0)
+		return;
+	EXTRA_ASSERT(group->queue->len == 0);
+	EXTRA_ASSERT(!group->flushing);
+	g_hash_table_remove(repli_groups, sq3);
+	g_cond_clear(&group->cond);
+	g_ptr_array_free(group->queue, TRUE);
+	g_free(group);
+}
+
+static GError *
+_group_peers(struct sqlx_repctx_s *ctx)
+{
+	NAME2CONST(n, ctx->sq3->name);
+	gchar **peers = NULL;
+	GError *err = election_get_peers(ctx->sq3->manager, &n, FALSE, &peers);
+	if (!err && (!peers || !oio_str_is_set(*peers)))
+		err = NEWERROR(CODE_INTERNAL_ERROR, "No peer found");
+	if (err) {
+		g_strfreev(peers);
+		return err;
+	}
+	ctx->peers = peers;
+	return NULL;
+}
+
+/* Tell if the transaction may hold its changes for a group. If not, it is
+ * committed and replicated on its own, as usual. */
+static gboolean
+_group_start(struct sqlx_repctx_s *ctx)
+{
+	if (ctx->hollow || ctx->huge || ctx->sequence.list.count <= 0
+			|| !_group_commit_allowed(ctx->sq3))
+		return FALSE;
+
+	NAME2CONST(n, ctx->sq3->name);
+	if (election_get_status_nowait(ctx->sq3->manager, &n) != ELECTION_LEADER)
+		return FALSE;
+	GError *err = _group_peers(ctx);
+	if (err) {
+		/* The COMMIT will fail the same way */
+		g_clear_error(&err);
+		return FALSE;
+	}
+	ctx->grouped = 1;
+	return TRUE;
+}
+
+/* End the savepoint of a transaction that ran within the transaction held
+ * by the group of the base. Its changes join those of the group. */
+static GError *
+_group_release(struct sqlx_repctx_s *ctx)
+{
+	GError *err = NULL;
+	NAME2CONST(n, ctx->sq3->name);
+
+	if (!ctx->hollow && (ctx->huge || ctx->sequence.list.count > 0)) {
+		if (election_get_status_nowait(ctx->sq3->manager, &n)
+				!= ELECTION_LEADER)
+			err = NEWERROR(CODE_CONCURRENT,
+					"Election status changed during transaction");
+		else
+			err = _group_peers(ctx);
+		if (err) {
+			_sqlx_transaction_rollback(ctx, err);
+			return err;
+		}
+		ctx->grouped = 1;
+	}
+
+	int rc = sqlx_exec(ctx->sq3->db, "RELEASE " GROUP_SAVEPOINT);
+	if (rc != SQLITE_OK && rc != SQLITE_DONE) {
+		err = NEWERROR(CODE_UNAVAILABLE, "RELEASE failed: (%s) %s",
+				sqlite_strerror(rc), sqlite3_errmsg(ctx->sq3->db));
+		_sqlx_transaction_rollback(ctx, err);
+		ctx->grouped = 0;
+	}
+	return err;
+}
+
+/* Called by the leader, that owns the base: replicate the changes of the
+ * transactions then commit them, or roll them back altogether. The
+ * transactions are all those run within the transaction of the group. */
+static void
+_group_flush(struct sqlx_repctx_s *ctx,
+		struct repli_ticket_s **tickets, guint count)
+{
+	struct sqlx_sqlite3_s *sq3 = ctx->sq3;
+	TableSequence_t **seqs = g_alloca(count * sizeof(TableSequence_t*));
+	gboolean huge = FALSE;
+	gint64 deadline = 0;
+	GError *err = NULL;
+
+	for (guint i = 0; i < count; i++) {
+		seqs[i] = tickets[i]->sequence;
+		huge |= tickets[i]->huge;
+		if (tickets[i]->deadline > 0)
+			deadline = deadline > 0
+				? MIN(deadline, tickets[i]->deadline) : tickets[i]->deadline;
+	}
+
+	if (sqlite3_get_autocommit(sq3->db)) {
+		/* SQLite rolled it back after an error */
+		err = NEWERROR(CODE_UNAVAILABLE, "Transaction of the group lost");
+	} else if (huge) {
+		/* The whole base will be sent after the COMMIT */
+		for (gchar **p = tickets[0]->peers; *p; p++)
+			g_ptr_array_add(ctx->resync_todo, g_strdup(*p));
+	} else {
+		err = _replicate_on_peers(
+				tickets[0]->peers, ctx, seqs, count, deadline);
+	}
+
+	if (!err) {
+		int rc = sqlx_exec(sq3->db, "COMMIT");
+		if (rc != SQLITE_OK && rc != SQLITE_DONE) {
+			err = NEWERROR(CODE_UNAVAILABLE, "COMMIT failed: (%s) %s",
+					sqlite_strerror(rc), sqlite3_errmsg(sq3->db));
+			if (rc == SQLITE_NOTADB || rc == SQLITE_CORRUPT)
+				sq3->corrupted = TRUE;
+		}
+	}
+	if (err) {
+		GRID_WARN("Group of %u transactions not replicated [%s][%s]: "
+				"(%d) %s reqid=%s", count, sq3->name.base, sq3->name.type,
+				err->code, err->message, oio_ext_get_reqid());
+		if (!sqlite3_get_autocommit(sq3->db)) {
+			int rc = sqlx_exec(sq3->db, "ROLLBACK");
+			if (rc != SQLITE_OK && rc != SQLITE_DONE)
+				GRID_WARN("ROLLBACK failed! (%d/%s) %s reqid=%s", rc,
+						sqlite_strerror(rc), sqlite3_errmsg(sq3->db),
+						oio_ext_get_reqid());
+		}
+		sqlx_admin_reload(sq3);
+	} else if (ctx->resync_todo->len > 0) {
+		/* Done here for the whole group, while the base is still owned */
+		g_ptr_array_add(ctx->resync_todo, NULL);
+		err = sqlx_synchronous_resync(ctx, (gchar**)ctx->resync_todo->pdata);
+		g_ptr_array_set_size(ctx->resync_todo, 0);
+	}
+
+	for (guint i = 0; i < count; i++)
+		tickets[i]->err = err ? g_error_copy(err) : NULL;
+	g_clear_error(&err);
+}
+
+/* The changes of the transaction are left uncommitted, and the base is
+ * yielded to the other requests. Those that run a transaction meanwhile do
+ * it within the same SQLite transaction, and join the group. */
+static GError *
+_group_REPLICATE(struct sqlx_repctx_s *ctx)
+{
+	struct sqlx_sqlite3_s *sq3 = ctx->sq3;
+	const guint max = MAX(sqliterepo_repli_group_commit_max, 1);
+
+	struct repli_ticket_s ticket = {0};
+	ticket.sequence = &(ctx->sequence);
+	ticket.peers = ctx->peers;
+	ticket.deadline = oio_ext_get_deadline();
+	ticket.huge = BOOL(ctx->huge);
+
+	/* Queue while the base is still owned, so the transactions are queued
+	 * in their order of execution. */
+	g_mutex_lock(&repli_groups_lock);
+	struct repli_group_s *group = _group_ref_LOCKED(sq3);
+	if (group->queue->len <= 0)
+		group->first = g_get_monotonic_time();
+	g_ptr_array_add(group->queue, &ticket);
+	/* A full group is sent at once, by the owner of the base. Nothing can
+	 * join it anymore. */
+	gboolean lead = group->queue->len >= max && !group->flushing;
+	if (lead)
+		group->flushing = TRUE;
+	g_mutex_unlock(&repli_groups_lock);
+
+	/* The next transactions install their own hooks, and the COMMIT of the
+	 * group must not trigger any. */
+	sqlite3_commit_hook(sq3->db, NULL, NULL);
+	sqlite3_rollback_hook(sq3->db, NULL, NULL);
+	sqlite3_update_hook(sq3->db, NULL, NULL);
+
+	/* The requests borrowing the base reset its update queries */
+	const guint8 save_update_queries = sq3->save_update_queries;
+	GList *transaction_update_queries = sq3->transaction_update_queries;
+	GList *update_queries = sq3->update_queries;
+	sq3->save_update_queries = 0;
+	sq3->transaction_update_queries = sq3->update_queries = NULL;
+
+	guint32 count_open = 0;
+	gboolean yielded = FALSE;
+	GError *err = NULL;
+	if (!lead) {
+		err = sqlx_cache_yield_base(sq3->repo->cache, sq3->bd, &count_open);
+		yielded = (err == NULL);
+		if (err) {
+			GRID_WARN("Base not yielded during its replication [%s][%s]: "
+					"(%d) %s reqid=%s", sq3->name.base, sq3->name.type,
+					err->code, err->message, oio_ext_get_reqid());
+			g_clear_error(&err);
+		}
+	}
+
+	void _reclaim(void) {
+		sqlx_cache_reclaim_base(sq3->repo->cache, sq3->bd, count_open);
+		yielded = FALSE;
+		/* Reset by the requests that used the base meanwhile, and maybe
+		 * changed since the base was opened. */
+		NAME2CONST(n, sq3->name);
+		sq3->election = election_get_status_nowait(sq3->manager, &n);
+	}
+
+	g_mutex_lock(&repli_groups_lock);
+	while (!ticket.done) {
+		const gint64 until = group->first + sqliterepo_repli_group_commit_delay;
+		if (!lead && group->flushing) {
+			g_cond_wait(&group->cond, &repli_groups_lock);
+		} else if (!lead && yielded && group->queue->len < max
+				&& g_get_monotonic_time() < until) {
+			/* Give a chance to the next transactions */
+			g_cond_wait_until(&group->cond, &repli_groups_lock, until);
+		} else {
+			/* Become the leader. Once the base is back, nobody runs within
+			 * the transaction of the group anymore. */
+			group->flushing = TRUE;
+			lead = FALSE;
+			g_mutex_unlock(&repli_groups_lock);
+			if (yielded)
+				_reclaim();
+
+			g_mutex_lock(&repli_groups_lock);
+			const guint count = group->queue->len;
+			struct repli_ticket_s **batch =
+				g_memdup(group->queue->pdata, count * sizeof(gpointer));
+			g_ptr_array_set_size(group->queue, 0);
+			group->first = 0;
+			g_mutex_unlock(&repli_groups_lock);
+
+			_group_flush(ctx, batch, count);
+
+			g_mutex_lock(&repli_groups_lock);
+			for (guint i = 0; i < count; i++)
+				batch[i]->done = TRUE;
+			group->flushing = FALSE;
+			g_cond_broadcast(&group->cond);
+			g_free(batch);
+		}
+	}
+	err = ticket.err;
+	_group_unref_LOCKED(sq3, group);
+	g_mutex_unlock(&repli_groups_lock);
+
+	if (yielded)
+		_reclaim();
+	sq3->save_update_queries = save_update_queries;
+	sq3->transaction_update_queries = transaction_update_queries;
+	sq3->update_queries = update_queries;
+	if (!err)
+		ctx->any_change = 1;
+	return err;
+}
+
 static GError*
 _sqlx_transaction_validate(struct sqlx_repctx_s *ctx)
 {
@@ -762,17 +1226,27 @@ _sqlx_transaction_validate(struct sqlx_repctx_s *ctx)
 		context_flush_pending(ctx);
 	}
 
-	/* Apply the changes on the slaves. */
-	rc = sqlx_exec(ctx->sq3->db, "COMMIT");
-	if (rc != SQLITE_OK && rc != SQLITE_DONE) {
-		err = NEWERROR(CODE_UNAVAILABLE, "COMMIT failed: (%s) %s%s",
-				sqlite_strerror(rc), sqlite3_errmsg(ctx->sq3->db),
-				ctx->errors->str);
-		if (rc == SQLITE_NOTADB || rc == SQLITE_CORRUPT) {
-			ctx->sq3->corrupted = TRUE;
+	/* Apply the changes on the slaves. The transactions of a group are
+	 * committed together, once replicated. */
+	if (ctx->nested) {
+		err = _group_release(ctx);
+	} else if (!_group_start(ctx)) {
+		rc = sqlx_exec(ctx->sq3->db, "COMMIT");
+		if (rc != SQLITE_OK && rc != SQLITE_DONE) {
+			err = NEWERROR(CODE_UNAVAILABLE, "COMMIT failed: (%s) %s%s",
+					sqlite_strerror(rc), sqlite3_errmsg(ctx->sq3->db),
+					ctx->errors->str);
+			if (rc == SQLITE_NOTADB || rc == SQLITE_CORRUPT) {
+				ctx->sq3->corrupted = TRUE;
+			}
+			// Restore the in-RAM cache
+			sqlx_admin_reload(ctx->sq3);
 		}
-		// Restore the in-RAM cache
-		sqlx_admin_reload(ctx->sq3);
+	}
+	if (!err && ctx->grouped) {
+		gint64 start = oio_ext_monotonic_time();
+		err = _group_REPLICATE(ctx);
+		oio_ext_add_perfdata("db_commit", oio_ext_monotonic_time() - start);
 	}
 	if (ctx->errors->len > 0) {
 		GRID_WARN("COMMIT errors on [%s.%s]:%s reqid=%s",
@@ -917,7 +1391,14 @@ sqlx_transaction_begin(struct sqlx_sqlite3_s *sq3,
 
 	if (repctx->resync_todo)
 		g_ptr_array_set_size(repctx->resync_todo, 0);
-	sqlx_exec(sq3->db, "BEGIN");
+	if (!sqlite3_get_autocommit(sq3->db)) {
+		/* The transaction of a group is held open until its replication,
+		 * run within it. */
+		repctx->nested = 1;
+		sqlx_exec(sq3->db, "SAVEPOINT " GROUP_SAVEPOINT);
+	} else {
+		sqlx_exec(sq3->db, "BEGIN");
+	}
 	/*sqlx_admin_reload(sq3);*/
 	*result = repctx;
 	sq3->transaction = 1;
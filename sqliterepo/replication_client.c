@@ -32,20 +32,22 @@ License along with this library.
 #include <arpa/inet.h>
 
 #include <glib.h>
+#include <zlib.h>
 
 #include <metautils/lib/metautils.h>
 #include <sqliterepo/sqliterepo_remote_variables.h>
 
 #include "sqliterepo.h"
 #include "sqlx_remote.h"
+#include "sqlx_macros.h"
 #include "internals.h"
 
 static GByteArray*
 _pack_RESTORE(const struct sqlx_name_s *name, GByteArray *dump,
-		const gchar *local_addr, gint64 deadline)
+		const gchar *compression, const gchar *local_addr, gint64 deadline)
 {
 	GByteArray *encoded = sqlx_pack_RESTORE(
-			name, dump->data, dump->len, local_addr, deadline);
+			name, dump->data, dump->len, compression, local_addr, deadline);
 	g_byte_array_unref(dump);
 	return encoded;
 }
@@ -61,7 +63,7 @@ peer_restore(const gchar *target, struct sqlx_name_s *name,
 		return NULL;
 	}
 
-	GByteArray *encoded = _pack_RESTORE(name, dump, local_addr,
+	GByteArray *encoded = _pack_RESTORE(name, dump, NULL, local_addr,
 			oio_clamp_deadline(oio_election_replicate_timeout_req, deadline));
 	struct gridd_client_s *client = gridd_client_create(target, encoded, NULL, NULL);
 	g_byte_array_unref(encoded);
@@ -83,7 +85,8 @@ peer_restore(const gchar *target, struct sqlx_name_s *name,
 
 GError *
 peers_restore(gchar **targets, struct sqlx_name_s *name,
-		GByteArray *dump, const gchar *local_addr, gint64 deadline)
+		GByteArray *dump, const gchar *compression,
+		const gchar *local_addr, gint64 deadline)
 {
 	GError *err = NULL;
 
@@ -93,7 +96,7 @@ peers_restore(gchar **targets, struct sqlx_name_s *name,
 				name->base, name->type);
 	}
 
-	GByteArray *encoded = _pack_RESTORE(name, dump, local_addr,
+	GByteArray *encoded = _pack_RESTORE(name, dump, compression, local_addr,
 			oio_clamp_deadline(oio_election_replicate_timeout_req, deadline));
 	struct gridd_client_s **clients = gridd_client_create_many(
 			targets, encoded, NULL, NULL);
@@ -120,6 +123,96 @@ peers_restore(gchar **targets, struct sqlx_name_s *name,
 	return err;
 }
 
+GError *
+peer_checksum(const gchar *target, struct sqlx_name_s *name,
+		guint extent_pages, GByteArray **checksums, gint64 deadline)
+{
+	GError *err = NULL;
+	GByteArray *result = g_byte_array_new();
+
+	gboolean on_reply(gpointer ctx UNUSED, guint status UNUSED, MESSAGE reply) {
+		gsize bsize = 0;
+		void *b = metautils_message_get_BODY(reply, &bsize);
+		if (b && bsize)
+			g_byte_array_append(result, b, bsize);
+		return TRUE;
+	}
+
+	EXTRA_ASSERT(checksums != NULL);
+	*checksums = NULL;
+
+	if (!target) {
+		g_byte_array_unref(result);
+		return SYSERR("No target URL");
+	}
+
+	GByteArray *encoded = sqlx_pack_CHECKSUM(name, extent_pages,
+			oio_clamp_deadline(oio_election_resync_timeout_req, deadline));
+	struct gridd_client_s *client = gridd_client_create(
+			target, encoded, NULL, on_reply);
+	g_byte_array_unref(encoded);
+
+	if (!client) {
+		g_byte_array_unref(result);
+		return NEWERROR(CODE_INTERNAL_ERROR,
+				"Failed to create client to [%s], bad address?", target);
+	}
+
+	gridd_client_set_timeout_cnx(client,
+			oio_clamp_timeout(oio_election_resync_timeout_cnx, deadline));
+	gridd_client_set_timeout(client,
+			oio_clamp_timeout(oio_election_resync_timeout_req, deadline));
+
+	gridd_client_start(client);
+	if (!(err = gridd_client_loop(client)))
+		err = gridd_client_error(client);
+	gridd_client_free(client);
+
+	if (err)
+		g_byte_array_unref(result);
+	else
+		*checksums = result;
+	return err;
+}
+
+GError *
+peer_patch(const gchar *target, struct sqlx_name_s *name,
+		GByteArray *delta, const gchar *local_addr, gint64 deadline)
+{
+	GError *err = NULL;
+
+	if (!target) {
+		g_byte_array_unref(delta);
+		return SYSERR("No target URL");
+	}
+
+	GByteArray *encoded = sqlx_pack_PATCH(name, delta->data, delta->len,
+			local_addr,
+			oio_clamp_deadline(oio_election_replicate_timeout_req, deadline));
+	g_byte_array_unref(delta);
+	struct gridd_client_s *client = gridd_client_create(target, encoded, NULL, NULL);
+	g_byte_array_unref(encoded);
+
+	if (!client)
+		return NEWERROR(CODE_INTERNAL_ERROR, "Failed to create client to [%s], bad address?", target);
+
+	gridd_client_set_timeout_cnx(client,
+			oio_clamp_timeout(oio_election_replicate_timeout_cnx, deadline));
+	gridd_client_set_timeout(client,
+			oio_clamp_timeout(oio_election_replicate_timeout_req, deadline));
+
+	gridd_client_start(client);
+	if (!(err = gridd_client_loop(client)))
+		err = gridd_client_error(client);
+	gridd_client_free(client);
+
+	if (err) {
+		g_prefix_error(&err, "PATCH failed [%s][%s]: (%d) ",
+				name->base, name->type, err->code);
+	}
+	return err;
+}
+
 GError *
 peer_dump(const gchar *target, struct sqlx_name_s *name, gboolean chunked,
 		gint check_type, peer_dump_cb callback, gpointer cb_arg,
@@ -128,17 +221,62 @@ peer_dump(const gchar *target, struct sqlx_name_s *name, gboolean chunked,
 	struct gridd_client_s *client;
 	GByteArray *encoded;
 	GError *err = NULL;
+	z_stream zs = {0};
+	gboolean inflating = FALSE, inflated = FALSE;
+
+	/* Inflate the part as it comes, and hand the plain dump to the
+	 * callback in pieces of bounded size. */
+	GError *_inflate_part(guint8 *b, gsize bsize, gint64 remaining) {
+		GError *err2 = NULL;
+		if (!inflating) {
+			int rc = inflateInit(&zs);
+			if (rc != Z_OK)
+				return SYSERR("inflateInit error: (%d) %s", rc,
+						zs.msg ? zs.msg : "?");
+			inflating = TRUE;
+		}
+		zs.next_in = b;
+		zs.avail_in = bsize;
+		while (!err2 && zs.avail_in > 0 && !inflated) {
+			GByteArray *dump = g_byte_array_sized_new(SQLX_DUMP_BUFFER_SIZE);
+			g_byte_array_set_size(dump, SQLX_DUMP_BUFFER_SIZE);
+			zs.next_out = dump->data;
+			zs.avail_out = dump->len;
+			int rc = inflate(&zs, Z_NO_FLUSH);
+			g_byte_array_set_size(dump, dump->len - zs.avail_out);
+			if (rc == Z_STREAM_END) {
+				inflated = TRUE;
+			} else if (rc != Z_OK && rc != Z_BUF_ERROR) {
+				err2 = NEWERROR(CODE_CORRUPT_DATABASE,
+						"Invalid compressed dump: (%d) %s", rc,
+						zs.msg ? zs.msg : "?");
+			}
+			if (!err2 && dump->len > 0)
+				err2 = callback(dump, remaining, cb_arg);
+			else
+				g_byte_array_unref(dump);
+		}
+		return err2;
+	}
 
 	gboolean on_reply(gpointer ctx, guint status UNUSED, MESSAGE reply) {
 		GError *err2 = NULL;
 		gsize bsize = 0;
 		gint64 remaining = -1;
+		gchar compression[32] = {0};
 		(void) ctx;
 
 		err2 = metautils_message_extract_strint64(reply, "remaining", FALSE,
 				&remaining);
+		if (!err2)
+			err2 = metautils_message_extract_string(reply, "compression",
+					FALSE, compression, sizeof(compression));
+		if (!err2 && *compression
+				&& strcmp(compression, SQLX_DUMP_COMPRESSION_ZLIB))
+			err2 = NEWERROR(CODE_NOT_IMPLEMENTED,
+					"Unexpected compression '%s'", compression);
 		if (err2 != NULL) {
-			GRID_ERROR("Failed to extract 'remaining': (%d) %s (reqid=%s)",
+			GRID_ERROR("Failed to extract dump headers: (%d) %s (reqid=%s)",
 					err2->code, err2->message, oio_ext_get_reqid());
 			g_clear_error(&err2);
 			return FALSE;
@@ -146,9 +284,13 @@ peer_dump(const gchar *target, struct sqlx_name_s *name, gboolean chunked,
 
 		void *b = metautils_message_get_BODY(reply, &bsize);
 		if (b && bsize) {
-			GByteArray *dump = g_byte_array_new();
-			g_byte_array_append(dump, b, bsize);
-			err2 = callback(dump, remaining, cb_arg);
+			if (*compression) {
+				err2 = _inflate_part(b, bsize, remaining);
+			} else {
+				GByteArray *dump = g_byte_array_new();
+				g_byte_array_append(dump, b, bsize);
+				err2 = callback(dump, remaining, cb_arg);
+			}
 		}
 		if (err2 != NULL) {
 			GRID_ERROR("Failed to use result of dump: (%d) %s",
@@ -184,5 +326,11 @@ peer_dump(const gchar *target, struct sqlx_name_s *name, gboolean chunked,
 
 	gridd_client_free(client);
 
+	if (inflating) {
+		if (!err && !inflated)
+			err = NEWERROR(CODE_CORRUPT_DATABASE, "Truncated compressed dump");
+		inflateEnd(&zs);
+	}
+
 	return err;
 }
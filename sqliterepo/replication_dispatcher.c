@@ -330,41 +330,28 @@ _replicate_now(struct sqlx_sqlite3_s *sq3, TableSequence_t *seq)
 	return err;
 }
 
+/* Apply a sequence of changes in the current transaction, then check the
+ * versions of the tables are those the master had after the same changes. */
 static GError *
-replicate_body_manage(struct sqlx_sqlite3_s *sq3, TableSequence_t *seq)
+_replicate_and_check(struct sqlx_sqlite3_s *sq3, TableSequence_t *seq)
 {
-	gint rc;
 	GError *err = NULL;
-
-	if (!seq)
-		return NEWERROR(CODE_BAD_REQUEST, "Invalid tables sequence");
-
-	if (seq->list.count <= 0) {
-		GRID_DEBUG("Empty tables sequence, nothing to replicate");
-		return NULL;
-	}
-
 	GTree *oldvers, *expected_version, *postvers;
 
 	oldvers = version_extract_from_admin(sq3);
 	expected_version = version_extract_expected(oldvers, seq);
 	postvers = NULL;
 
-	sqlx_exec(sq3->db, "BEGIN");
 	err = _replicate_now(sq3, seq);
 
 	if (err) {
 		if (err->code == SQLITE_ERROR || err->code == SQLITE_SCHEMA) {
 			g_prefix_error(&err, "Schema error: ");
+			sqlx_sqlite3_clear_statements(sq3);
 			/* XXX This is the error returned to the peer, so we tell it
 			   to "pipe to" us. */
 			err->code = CODE_PIPETO;
 		}
-label_rollback:
-		rc = sqlx_exec(sq3->db, "ROLLBACK");
-		if (rc != SQLITE_OK && rc != SQLITE_DONE)
-			GRID_WARN("ROLLBACK failed!");
-		sqlx_admin_reload(sq3);
 	}
 	else {
 		/* keep the current version for later */
@@ -391,9 +378,52 @@ label_rollback:
 				);
 			}
 		}
-		if (err != NULL)
-			goto label_rollback;
+	}
 
+	if (postvers)
+		g_tree_destroy(postvers);
+	if (oldvers)
+		g_tree_destroy(oldvers);
+	if (expected_version)
+		g_tree_destroy(expected_version);
+	return err;
+}
+
+/* Apply the sequences in the order the master committed them, all in the
+ * same local transaction: either all of them are applied, or none. */
+static GError *
+replicate_body_manage(struct sqlx_sqlite3_s *sq3,
+		TableSequence_t **seqs, guint count)
+{
+	gint rc;
+	GError *err = NULL;
+	guint non_empty = 0;
+
+	for (guint i = 0; i < count; i++) {
+		if (!seqs[i])
+			return NEWERROR(CODE_BAD_REQUEST, "Invalid tables sequence");
+		if (seqs[i]->list.count > 0)
+			non_empty ++;
+	}
+
+	if (non_empty <= 0) {
+		GRID_DEBUG("Empty tables sequence, nothing to replicate");
+		return NULL;
+	}
+
+	sqlx_exec(sq3->db, "BEGIN");
+	for (guint i = 0; !err && i < count; i++) {
+		if (seqs[i]->list.count > 0)
+			err = _replicate_and_check(sq3, seqs[i]);
+	}
+
+	if (err) {
+		rc = sqlx_exec(sq3->db, "ROLLBACK");
+		if (rc != SQLITE_OK && rc != SQLITE_DONE)
+			GRID_WARN("ROLLBACK failed!");
+		sqlx_admin_reload(sq3);
+	}
+	else {
 		rc = sqlx_exec(sq3->db, "COMMIT");
 		if (rc != SQLITE_OK && rc != SQLITE_DONE) {
 			err = SQLITE_GERROR(sq3->db, rc);
@@ -410,37 +440,52 @@ label_rollback:
 		}
 	}
 
-	if (postvers)
-		g_tree_destroy(postvers);
-	if (oldvers)
-		g_tree_destroy(oldvers);
-	if (expected_version)
-		g_tree_destroy(expected_version);
 	return err;
 }
 
+/* The body of a DB_REPLI holds one BER-encoded sequence of changes, the
+ * body of a DB_REPLI_MANY holds several of them, one after the other. */
 static GError *
-replicate_body_parse(struct sqlx_sqlite3_s *sq3, guint8 *body, gsize bodysize)
+replicate_body_parse(struct sqlx_sqlite3_s *sq3, guint8 *body, gsize bodysize,
+		gboolean many)
 {
 	asn_dec_rval_t rv;
 	asn_codec_ctx_t ctx;
-	TableSequence_t *seq = NULL;
+	GPtrArray *seqs = g_ptr_array_new();
 	GError *err = NULL;
 
-	ctx.max_stack_size = ASN1C_MAX_STACK;
-	rv = ber_decode(&ctx, &asn_DEF_TableSequence, (void**)&seq,
-			body, bodysize);
-	if (rv.code != RC_OK)
-		return NEWERROR(CODE_BAD_REQUEST, "body decoding error");
+	do {
+		TableSequence_t *seq = NULL;
+		ctx.max_stack_size = ASN1C_MAX_STACK;
+		rv = ber_decode(&ctx, &asn_DEF_TableSequence, (void**)&seq,
+				body, bodysize);
+		if (rv.code != RC_OK || rv.consumed <= 0) {
+			if (seq)
+				asn_DEF_TableSequence.free_struct(
+						&asn_DEF_TableSequence, seq, FALSE);
+			err = NEWERROR(CODE_BAD_REQUEST, "body decoding error");
+		} else {
+			g_ptr_array_add(seqs, seq);
+			body += rv.consumed;
+			bodysize -= MIN(bodysize, rv.consumed);
+		}
+	} while (!err && many && bodysize > 0);
+
+	if (!err)
+		err = replicate_body_manage(sq3,
+				(TableSequence_t**) seqs->pdata, seqs->len);
 
-	err = replicate_body_manage(sq3, seq);
-	asn_DEF_TableSequence.free_struct(&asn_DEF_TableSequence, seq, FALSE);
+	for (guint i = 0; i < seqs->len; i++)
+		asn_DEF_TableSequence.free_struct(&asn_DEF_TableSequence,
+				seqs->pdata[i], FALSE);
+	g_ptr_array_free(seqs, TRUE);
 	return err;
 }
 
 static GError *
 _restore(struct sqlx_repository_s *repo, struct sqlx_name_s *name,
-		guint8 *dump, gsize dump_size, const gchar *source)
+		guint8 *dump, gsize dump_size, gboolean compressed,
+		const gchar *source)
 {
 	struct sqlx_sqlite3_s *sq3 = NULL;
 	GError *err = sqlx_repository_open_and_lock(repo, name,
@@ -452,7 +497,7 @@ _restore(struct sqlx_repository_s *repo, struct sqlx_name_s *name,
 	// Check the election without triggering it
 	if (!(err = election_check_replication_allowed(
 			repo->election_manager, name, source, "DB_RESTORE"))) {
-		err = sqlx_repository_restore_base(sq3, dump, dump_size);
+		err = sqlx_repository_restore_base(sq3, dump, dump_size, compressed);
 	}
 
 	if (!err) {
@@ -578,9 +623,54 @@ _dump(struct sqlx_repository_s *repo, struct sqlx_name_s *name,
 	return err;
 }
 
+static GError *
+_checksum(struct sqlx_repository_s *repo, struct sqlx_name_s *name,
+		guint extent_pages, GByteArray **result)
+{
+	struct sqlx_sqlite3_s *sq3 = NULL;
+	GError *err = sqlx_repository_open_and_lock(repo, name,
+			SQLX_OPEN_LOCAL|SQLX_OPEN_NOREFCHECK, &sq3, NULL);
+	if (NULL != err)
+		return err;
+
+	err = sqlx_repository_checksum_base(sq3, extent_pages, result);
+	sqlx_repository_unlock_and_close_noerror(sq3);
+	return err;
+}
+
+static GError *
+_patch(struct sqlx_repository_s *repo, struct sqlx_name_s *name,
+		guint8 *delta, gsize delta_size, const gchar *source)
+{
+	struct sqlx_sqlite3_s *sq3 = NULL;
+	GError *err = sqlx_repository_open_and_lock(repo, name,
+			SQLX_OPEN_LOCAL|SQLX_OPEN_NOREFCHECK, &sq3, NULL);
+	if (err) {
+		return err;
+	}
+
+	// Check the election without triggering it
+	if (!(err = election_check_replication_allowed(
+			repo->election_manager, name, source, "DB_PATCH"))) {
+		err = sqlx_repository_patch_base(sq3, delta, delta_size);
+	}
+
+	if (!err) {
+		GRID_TRACE("Patch done!");
+		/* See the comment in replicate_body_manage */
+		sqlx_admin_reload(sq3);
+		sqlx_repository_call_change_callback(sq3);
+	} else {
+		GRID_TRACE("Patch failed!");
+	}
+
+	sqlx_repository_unlock_and_close_noerror(sq3);
+	return err;
+}
+
 static GError *
 _dump_chunked(struct sqlx_repository_s *repo, struct sqlx_name_s *name,
-		gint check_type,
+		gint check_type, gint compression_level,
 		void (*_send_chunk)(GByteArray *chunk, gint64 remaining))
 {
 	guint64 sent = 0;
@@ -602,7 +692,12 @@ _dump_chunked(struct sqlx_repository_s *repo, struct sqlx_name_s *name,
 	}
 
 	err = sqlx_repository_dump_base_chunked(sq3, sqliterepo_dump_chunk_size,
-			check_type, _dump_chunked_cb, NULL);
+			check_type, compression_level, _dump_chunked_cb, NULL);
+	if (!err && compression_level > 0) {
+		GRID_INFO("DUMP [%s][%s] sent %"G_GUINT64_FORMAT
+				" compressed bytes reqid=%s", name->base, name->type,
+				sent, oio_ext_get_reqid());
+	}
 
 	sqlx_repository_unlock_and_close_noerror(sq3);
 	return err;
@@ -892,8 +987,8 @@ _handler_GETVERS(struct gridd_reply_ctx_s *reply,
 }
 
 static gboolean
-_handler_REPLICATE(struct gridd_reply_ctx_s *reply,
-		struct sqlx_repository_s *repo, gpointer ignored UNUSED)
+_replicate(struct gridd_reply_ctx_s *reply, struct sqlx_repository_s *repo,
+		const gchar *reqname, gboolean many)
 {
 	struct sqlx_sqlite3_s *sq3 = NULL;
 	struct sqlx_name_inline_s name;
@@ -937,9 +1032,9 @@ _handler_REPLICATE(struct gridd_reply_ctx_s *reply,
 
 	// Check the election without triggering it
 	if (!(err = election_check_replication_allowed(
-			repo->election_manager, &n0, source, "DB_REPLI"))) {
+			repo->election_manager, &n0, source, reqname))) {
 		/* Unpack the body from the message, decode it */
-		err = replicate_body_parse(sq3, b, bsize);
+		err = replicate_body_parse(sq3, b, bsize, many);
 	}
 
 	if (!err) {
@@ -953,6 +1048,20 @@ _handler_REPLICATE(struct gridd_reply_ctx_s *reply,
 	return TRUE;
 }
 
+static gboolean
+_handler_REPLICATE(struct gridd_reply_ctx_s *reply,
+		struct sqlx_repository_s *repo, gpointer ignored UNUSED)
+{
+	return _replicate(reply, repo, NAME_MSGNAME_SQLX_REPLICATE, FALSE);
+}
+
+static gboolean
+_handler_REPLICATE_MANY(struct gridd_reply_ctx_s *reply,
+		struct sqlx_repository_s *repo, gpointer ignored UNUSED)
+{
+	return _replicate(reply, repo, NAME_MSGNAME_SQLX_REPLICATE_MANY, TRUE);
+}
+
 static gboolean
 _handler_HAS(struct gridd_reply_ctx_s *reply,
 		struct sqlx_repository_s *repo, gpointer ignored UNUSED)
@@ -1204,6 +1313,18 @@ _handler_DUMP(struct gridd_reply_ctx_s *reply,
 	}
 	_maybe_override_check_type(reply, &check_type);
 
+	/* Compress only if the caller told it can inflate */
+	gint compression_level = 0;
+	gchar compression[32] = {0};
+	err = metautils_message_extract_string(reply->request,
+			NAME_MSGKEY_COMPRESSION, FALSE, compression, sizeof(compression));
+	if (err) {
+		reply->send_error(0, err);
+		return TRUE;
+	}
+	if (!strcmp(compression, SQLX_DUMP_COMPRESSION_ZLIB))
+		compression_level = sqliterepo_dump_compression_level;
+
 	void _send_part(GByteArray *part, gint64 remaining)
 	{
 		gchar tmp[32] = {0};
@@ -1213,11 +1334,15 @@ _handler_DUMP(struct gridd_reply_ctx_s *reply,
 				part->len, remaining);
 		reply->add_body(part);
 		reply->add_header("remaining", metautils_gba_from_string(tmp));
+		if (compression_level > 0)
+			reply->add_header("compression",
+					metautils_gba_from_string(SQLX_DUMP_COMPRESSION_ZLIB));
 		reply->send_reply(CODE_PARTIAL_CONTENT, "Partial content");
 	}
 
 	if (flags & FLAG_CHUNKED) {
-		err = _dump_chunked(repo, &n0, (gint)check_type, _send_part);
+		err = _dump_chunked(repo, &n0, (gint)check_type, compression_level,
+				_send_part);
 	} else {
 		GByteArray *dump = NULL;
 		/* Open and lock the base */
@@ -1236,6 +1361,70 @@ _handler_DUMP(struct gridd_reply_ctx_s *reply,
 	return TRUE;
 }
 
+static gboolean
+_handler_CHECKSUM(struct gridd_reply_ctx_s *reply,
+		struct sqlx_repository_s *repo, gpointer ignored UNUSED)
+{
+	GError *err;
+	gint64 extent_pages = 0;
+	struct sqlx_name_inline_s name;
+	NAME2CONST(n0, name);
+
+	if ((err = _load_sqlx_name(reply, &name, NULL))) {
+		reply->send_error(0, err);
+		return TRUE;
+	}
+	err = metautils_message_extract_strint64(reply->request,
+			NAME_MSGKEY_EXTENT, TRUE, &extent_pages);
+	if (!err && (extent_pages <= 0 || extent_pages > 65536))
+		err = BADREQ("Invalid extent size (%"G_GINT64_FORMAT")", extent_pages);
+	if (err) {
+		reply->send_error(0, err);
+		return TRUE;
+	}
+
+	GByteArray *checksums = NULL;
+	if ((err = _checksum(repo, &n0, (guint)extent_pages, &checksums))) {
+		reply->send_error(0, err);
+	} else {
+		reply->add_body(checksums);
+		reply->send_reply(CODE_FINAL_OK, "OK");
+	}
+	return TRUE;
+}
+
+static gboolean
+_handler_PATCH(struct gridd_reply_ctx_s *reply,
+		struct sqlx_repository_s *repo, gpointer ignored UNUSED)
+{
+	GError *err;
+	struct sqlx_name_inline_s name;
+	NAME2CONST(n0, name);
+	gchar source[LIMIT_LENGTH_SRVID];
+
+	if ((err = _load_sqlx_name(reply, &name, NULL))) {
+		reply->send_error(0, err);
+		return TRUE;
+	}
+	EXTRACT_STRING(NAME_MSGKEY_SRC, source);
+
+	/* The body is the header of the delta then the extents */
+	gsize delta_size = 0;
+	guint8 *delta = metautils_message_get_BODY(reply->request, &delta_size);
+	if (!delta) {
+		reply->send_error(0, NEWERROR(CODE_BAD_REQUEST, "Missing body"));
+		return TRUE;
+	}
+
+	err = _patch(repo, &n0, delta, delta_size, source);
+	if (err) {
+		reply->send_error(0, err);
+	} else {
+		reply->send_reply(CODE_FINAL_OK, "OK");
+	}
+	return TRUE;
+}
+
 static gboolean
 _handler_RESTORE(struct gridd_reply_ctx_s *reply,
 		struct sqlx_repository_s *repo, gpointer ignored UNUSED)
@@ -1257,20 +1446,29 @@ _handler_RESTORE(struct gridd_reply_ctx_s *reply,
 				oio_ext_get_reqid());
 	}
 
-	/* The body is the raw base */
+	/* The body is the raw base, or its zlib stream */
+	gchar compression[32] = {0};
+	EXTRACT_STRING2(NAME_MSGKEY_COMPRESSION, compression, TRUE);
+	const gboolean compressed = oio_str_is_set(compression);
+	if (compressed && strcmp(compression, SQLX_DUMP_COMPRESSION_ZLIB)) {
+		reply->send_error(0, NEWERROR(CODE_NOT_IMPLEMENTED,
+				"Unexpected compression '%s'", compression));
+		return TRUE;
+	}
+
 	gsize dump_size = 0;
 	guint8 *dump = metautils_message_get_BODY(reply->request, &dump_size);
 	if (!dump) {
 		reply->send_error(0, NEWERROR(CODE_BAD_REQUEST, "Missing body"));
 		return TRUE;
 	}
-	if (dump_size < 1024) {
+	if (!compressed && dump_size < 1024) {
 		reply->send_error(0, NEWERROR(CODE_BAD_REQUEST,
 				"Body too short (%zd bytes)", dump_size));
 		return TRUE;
 	}
 
-	err = _restore(repo, &n0, dump, dump_size, source);
+	err = _restore(repo, &n0, dump, dump_size, compressed, source);
 	if (err) {
 		reply->send_error(0, err);
 	} else {
@@ -2070,7 +2268,7 @@ _info_server(struct gridd_reply_ctx_s *reply, GString *gstr)
 {
 	g_string_append_static(gstr, "\"server\":{\"threads\":{");
 	oio_str_gstring_append_json_pair_int(gstr, "active",
-			g_thread_pool_get_num_threads(reply->client->server->pool_tcp));
+			network_server_count_threads(reply->client->server));
 	g_string_append_static(gstr, "},\"connections\":{");
 	oio_str_gstring_append_json_pair_int(gstr, "clients",
 			reply->client->server->cnx_clients);
@@ -2285,7 +2483,10 @@ sqlx_repli_gridd_get_requests(void)
 		{NAME_MSGNAME_SQLX_SNAPSHOT,     (hook) sqlx_dispatch_all, _handler_SNAPSHOT},
 		{NAME_MSGNAME_SQLX_DUMP,         (hook) sqlx_dispatch_all, _handler_DUMP},
 		{NAME_MSGNAME_SQLX_RESTORE,      (hook) sqlx_dispatch_all, _handler_RESTORE},
+		{NAME_MSGNAME_SQLX_CHECKSUM,     (hook) sqlx_dispatch_all, _handler_CHECKSUM},
+		{NAME_MSGNAME_SQLX_PATCH,        (hook) sqlx_dispatch_all, _handler_PATCH},
 		{NAME_MSGNAME_SQLX_REPLICATE,    (hook) sqlx_dispatch_all, _handler_REPLICATE},
+		{NAME_MSGNAME_SQLX_REPLICATE_MANY, (hook) sqlx_dispatch_all, _handler_REPLICATE_MANY},
 		{NAME_MSGNAME_SQLX_GETVERS,      (hook) sqlx_dispatch_all, _handler_GETVERS},
 		{NAME_MSGNAME_SQLX_RESYNC,       (hook) sqlx_dispatch_all, _handler_RESYNC},
 		{NAME_MSGNAME_SQLX_VACUUM,       (hook) sqlx_dispatch_all, _handler_VACUUM},
@@ -28,6 +28,7 @@ License along with this library.
 #include <sys/stat.h>
 
 #include <sqlite3.h>
+#include <zlib.h>
 
 #include <events/beanstalkd.h>
 #include <metautils/lib/metautils.h>
@@ -199,6 +200,9 @@ __close_base(struct sqlx_sqlite3_s *sq3)
 	GRID_TRACE2("DB being closed [%s][%s]", sq3->name.base,
 			sq3->name.type);
 
+	/* The cached statements would prevent sqlite3_close() */
+	sqlx_sqlite3_clear_statements(sq3);
+
 	/* send a vacuum */
 	if (sq3->repo && sq3->repo->flag_autovacuum && !sq3->deleted)
 		sqlx_exec(sq3->db, "VACUUM");
@@ -241,6 +245,8 @@ __close_base(struct sqlx_sqlite3_s *sq3)
 	if (sq3->admin)
 		g_tree_destroy(sq3->admin);
 	sq3->bd = -1;
+	if (sq3->statements)
+		g_hash_table_destroy(sq3->statements);
 	g_list_free_full(sq3->transaction_update_queries, g_free);
 	sq3->transaction_update_queries = NULL;
 	g_list_free_full(sq3->update_queries, g_free);
@@ -1757,6 +1763,11 @@ sqlx_repository_dump_base_fd_no_copy(struct sqlx_sqlite3_s *sq3,
 	EXTRA_ASSERT(read_file_cb != NULL);
 	const char *fallback_msg = "falling back on legacy dump function";
 
+	/* A group of replicated transactions holds its changes uncommitted,
+	 * the file may be inconsistent until the group ends. */
+	if (!sqlite3_get_autocommit(sq3->db))
+		return NEWERROR(CODE_UNAVAILABLE, "Transaction pending on the base");
+
 	/* Suggestion: dig in sqlite VFS, and duplicate the already open file
 	 * descriptor, instead of reopening it by path. This would allow
 	 * serving a base that is still open but has been removed
@@ -1877,9 +1888,65 @@ sqlx_repository_dump_base_gba(struct sqlx_sqlite3_s *sq3, gint check_type,
 			_monolytic_dump_cb, dump);
 }
 
+/* Compress the file as it is read, and send the compressed stream to the
+ * callback in parts of <chunk_size> bytes. Only one part and one read
+ * buffer are held at a time, whatever the size of the file. */
+static GError*
+_deflate_file(int fd, gint64 file_size, gint chunk_size, gint level,
+		dump_base_chunked_cb callback, gpointer callback_arg)
+{
+	z_stream zs = {0};
+	int rc = deflateInit(&zs, level);
+	if (rc != Z_OK)
+		return SYSERR("deflateInit error: (%d) %s", rc, zs.msg ? zs.msg : "?");
+
+	GError *err = NULL;
+	gint64 bytes_read = 0;
+	int flush = Z_NO_FLUSH;
+	guint8 *in = g_malloc(SQLX_DUMP_BUFFER_SIZE);
+	GByteArray *out = g_byte_array_sized_new(chunk_size);
+
+	do {
+		ssize_t r = read(fd, in, SQLX_DUMP_BUFFER_SIZE);
+		if (r < 0) {
+			err = NEWERROR(errno, "read error: %s", strerror(errno));
+			break;
+		}
+		bytes_read += r;
+		flush = r > 0 ? Z_NO_FLUSH : Z_FINISH;
+		zs.next_in = in;
+		zs.avail_in = r;
+		do {
+			const guint used = out->len;
+			g_byte_array_set_size(out, chunk_size);
+			zs.next_out = out->data + used;
+			zs.avail_out = chunk_size - used;
+			rc = deflate(&zs, flush);
+			g_byte_array_set_size(out, chunk_size - zs.avail_out);
+			if (rc == Z_STREAM_ERROR) {
+				err = SYSERR("deflate error: (%d) %s", rc,
+						zs.msg ? zs.msg : "?");
+			} else if (out->len >= (guint)chunk_size
+					|| (rc == Z_STREAM_END && out->len > 0)) {
+				/* The callback owns the part */
+				err = callback(out, MAX(file_size - bytes_read, 0),
+						callback_arg);
+				out = g_byte_array_sized_new(chunk_size);
+			}
+		} while (!err && zs.avail_out == 0);
+	} while (!err && flush != Z_FINISH);
+
+	GRID_DEBUG("DUMP deflated %"G_GINT64_FORMAT" bytes into %lu bytes",
+			bytes_read, zs.total_out);
+	deflateEnd(&zs);
+	g_byte_array_unref(out);
+	g_free(in);
+	return err;
+}
+
 GError*
 sqlx_repository_dump_base_chunked(struct sqlx_sqlite3_s *sq3,
-		gint chunk_size, gint check_type,
+		gint chunk_size, gint check_type, gint compression_level,
 		dump_base_chunked_cb callback, gpointer callback_arg)
 {
 	GError *_chunked_dump_cb(int fd, gpointer arg)
@@ -1894,6 +1961,9 @@ sqlx_repository_dump_base_chunked(struct sqlx_sqlite3_s *sq3,
 		if (rc < 0)
 			return NEWERROR(errno,
 					"Failed to stat the database file (fd=%d)", fd);
+		if (compression_level > 0)
+			return _deflate_file(fd, st.st_size, chunk_size,
+					compression_level, callback, callback_arg);
 		gint alloc_size = MIN(chunk_size, st.st_size);
 		do {
 			GByteArray *gba = g_byte_array_sized_new(alloc_size);
@@ -1928,6 +1998,7 @@ sqlx_repository_restore_from_file(struct sqlx_sqlite3_s *sq3,
 		g_prefix_error(&err, "Invalid raw SQLite base: ");
 	} else { /* Backup now! */
 		// TODO(FVE): we may want to unlink(path) now
+		sqlx_sqlite3_clear_statements(sq3);
 		err = _backup_main(src, sq3->db);
 		_close_handle(&src);
 		sqlx_admin_reload(sq3);
@@ -1937,15 +2008,16 @@ sqlx_repository_restore_from_file(struct sqlx_sqlite3_s *sq3,
 }
 
 GError*
-sqlx_repository_restore_base(struct sqlx_sqlite3_s *sq3, guint8 *raw, gsize rawsize)
+sqlx_repository_restore_base(struct sqlx_sqlite3_s *sq3, guint8 *raw, gsize rawsize,
+		gboolean compressed)
 {
 	gboolean try_slash_tmp = FALSE;
 	gchar path[LIMIT_LENGTH_VOLUMENAME+32] = {0};
 	GError *err = NULL;
 	struct restore_ctx_s *restore_ctx = NULL;
 
-	GRID_TRACE2("%s(%p,%p,%"G_GSIZE_FORMAT")", __FUNCTION__, sq3,
-			raw, rawsize);
+	GRID_TRACE2("%s(%p,%p,%"G_GSIZE_FORMAT",%d)", __FUNCTION__, sq3,
+			raw, rawsize, compressed);
 	EXTRA_ASSERT(sq3 != NULL);
 	EXTRA_ASSERT(raw != NULL);
 	EXTRA_ASSERT(rawsize > 0);
@@ -1960,14 +2032,17 @@ sqlx_repository_restore_base(struct sqlx_sqlite3_s *sq3, guint8 *raw, gsize raws
 			g_prefix_error(&err, "Failed to create restore context into %s: ",
 					path);
 		} else {
-			err = restore_ctx_append(restore_ctx, raw, rawsize);
+			err = compressed
+				? restore_ctx_inflate(restore_ctx, raw, rawsize)
+				: restore_ctx_append(restore_ctx, raw, rawsize);
 			if (err != NULL) {
 				g_prefix_error(&err, "Failed to fill temp file %s: ",
 						path);
 			}
 		}
 
-		if (err && !try_slash_tmp) {
+		/* /tmp won't help with a corrupted stream */
+		if (err && !try_slash_tmp && err->code != CODE_BAD_REQUEST) {
 			GRID_WARN("%s, will try with /tmp", err->message);
 			restore_ctx_clear(&restore_ctx);
 			g_clear_error(&err);
@@ -1991,6 +2066,378 @@ sqlx_repository_restore_base(struct sqlx_sqlite3_s *sq3, guint8 *raw, gsize raws
 	return err;
 }
 
+/* Delta resync ------------------------------------------------------------ */
+
+/* Both the checksums and the delta start with the same header: the page
+ * size, the number of pages per extent, the size of the file they describe
+ * and, for a delta, the MD5 of the whole file the patched copy must match.
+ * The checksums then hold one MD5 per extent, the delta holds the extents
+ * that differ, each prefixed with its offset and its length. Everything is
+ * big-endian. */
+#define DELTA_HEADER_SIZE 32
+#define DELTA_DIGEST_SIZE 16
+
+struct delta_header_s
+{
+	guint32 page_size;
+	guint32 extent_pages;
+	guint64 file_size;
+	guint8 digest[DELTA_DIGEST_SIZE];
+};
+
+static void
+_delta_append_u32(GByteArray *gba, guint32 u)
+{
+	u = GUINT32_TO_BE(u);
+	g_byte_array_append(gba, (guint8*)&u, sizeof(u));
+}
+
+static void
+_delta_append_u64(GByteArray *gba, guint64 u)
+{
+	u = GUINT64_TO_BE(u);
+	g_byte_array_append(gba, (guint8*)&u, sizeof(u));
+}
+
+static guint32
+_delta_read_u32(const guint8 *raw)
+{
+	guint32 u;
+	memcpy(&u, raw, sizeof(u));
+	return GUINT32_FROM_BE(u);
+}
+
+static guint64
+_delta_read_u64(const guint8 *raw)
+{
+	guint64 u;
+	memcpy(&u, raw, sizeof(u));
+	return GUINT64_FROM_BE(u);
+}
+
+static void
+_delta_append_header(GByteArray *gba, const struct delta_header_s *hdr)
+{
+	_delta_append_u32(gba, hdr->page_size);
+	_delta_append_u32(gba, hdr->extent_pages);
+	_delta_append_u64(gba, hdr->file_size);
+	g_byte_array_append(gba, hdr->digest, DELTA_DIGEST_SIZE);
+}
+
+static GError *
+_delta_parse_header(const guint8 *raw, gsize rawsize,
+		struct delta_header_s *hdr)
+{
+	if (rawsize < DELTA_HEADER_SIZE)
+		return BADREQ("Delta header too short (%"G_GSIZE_FORMAT" bytes)",
+				rawsize);
+	hdr->page_size = _delta_read_u32(raw);
+	hdr->extent_pages = _delta_read_u32(raw + 4);
+	hdr->file_size = _delta_read_u64(raw + 8);
+	memcpy(hdr->digest, raw + 16, DELTA_DIGEST_SIZE);
+	if (hdr->page_size < 512 || hdr->page_size > 65536 || !hdr->extent_pages)
+		return BADREQ("Invalid delta header (page_size=%"G_GUINT32_FORMAT
+				", extent_pages=%"G_GUINT32_FORMAT")",
+				hdr->page_size, hdr->extent_pages);
+	return NULL;
+}
+
+static GError *
+_pread_full(int fd, guint8 *buf, gsize len, off_t offset)
+{
+	while (len > 0) {
+		ssize_t r = pread(fd, buf, len, offset);
+		if (r < 0) {
+			if (errno == EINTR)
+				continue;
+			return NEWERROR(errno, "read error: %s", strerror(errno));
+		}
+		if (r == 0)
+			return SYSERR("read error: unexpected end of file");
+		buf += r;
+		len -= r;
+		offset += r;
+	}
+	return NULL;
+}
+
+static GError *
+_pwrite_full(int fd, const guint8 *buf, gsize len, off_t offset)
+{
+	while (len > 0) {
+		ssize_t w = pwrite(fd, buf, len, offset);
+		if (w < 0) {
+			if (errno == EINTR)
+				continue;
+			return NEWERROR(errno, "write error: %s", strerror(errno));
+		}
+		buf += w;
+		len -= w;
+		offset += w;
+	}
+	return NULL;
+}
+
+/* The page size is stored in the header of the database file, 1 meaning
+ * 65536 bytes. */
+static GError *
+_read_page_size(int fd, guint32 *page_size)
+{
+	guint8 hdr[18];
+	GError *err = _pread_full(fd, hdr, sizeof(hdr), 0);
+	if (err) {
+		g_prefix_error(&err, "Database header: ");
+		return err;
+	}
+	const guint32 ps = (hdr[16] << 8) | hdr[17];
+	*page_size = (ps == 1) ? 65536 : ps;
+	return NULL;
+}
+
+/* Call <on_extent> on each extent of the file, with its MD5, and compute
+ * the MD5 of the whole file meanwhile. */
+static GError *
+_delta_scan(int fd, struct delta_header_s *hdr,
+		GError* (*on_extent)(guint64 offset, const guint8 *data, gsize len,
+			const guint8 *digest, gpointer udata),
+		gpointer udata)
+{
+	struct stat st;
+	GError *err = NULL;
+
+	if (fstat(fd, &st) < 0)
+		return NEWERROR(errno, "Failed to stat the database file (fd=%d)", fd);
+	if ((err = _read_page_size(fd, &hdr->page_size)))
+		return err;
+	hdr->file_size = st.st_size;
+
+	const gsize extent_size = (gsize)hdr->page_size * hdr->extent_pages;
+	guint8 *buf = g_malloc(extent_size);
+	GChecksum *whole = g_checksum_new(G_CHECKSUM_MD5);
+	GChecksum *extent = g_checksum_new(G_CHECKSUM_MD5);
+	guint8 digest[DELTA_DIGEST_SIZE];
+	gsize digest_len;
+
+	for (guint64 offset = 0; !err && offset < hdr->file_size;
+			offset += extent_size) {
+		const gsize len = MIN(extent_size, hdr->file_size - offset);
+		if (!(err = _pread_full(fd, buf, len, offset))) {
+			g_checksum_update(whole, buf, len);
+			g_checksum_reset(extent);
+			g_checksum_update(extent, buf, len);
+			digest_len = sizeof(digest);
+			g_checksum_get_digest(extent, digest, &digest_len);
+			err = on_extent(offset, buf, len, digest, udata);
+		}
+	}
+
+	digest_len = sizeof(hdr->digest);
+	g_checksum_get_digest(whole, hdr->digest, &digest_len);
+	g_checksum_free(extent);
+	g_checksum_free(whole);
+	g_free(buf);
+	return err;
+}
+
+GError*
+sqlx_repository_checksum_base(struct sqlx_sqlite3_s *sq3, guint extent_pages,
+		GByteArray **result)
+{
+	EXTRA_ASSERT(sq3 != NULL);
+	EXTRA_ASSERT(result != NULL);
+
+	GByteArray *sums = g_byte_array_new();
+
+	GError *_on_extent(guint64 offset UNUSED, const guint8 *data UNUSED,
+			gsize len UNUSED, const guint8 *digest, gpointer udata UNUSED) {
+		g_byte_array_append(sums, digest, DELTA_DIGEST_SIZE);
+		return NULL;
+	}
+	GError *_checksum_cb(int fd, gpointer arg UNUSED) {
+		struct delta_header_s hdr = {0};
+		hdr.extent_pages = MAX(extent_pages, 1);
+		GError *_err = _delta_scan(fd, &hdr, _on_extent, NULL);
+		if (!_err) {
+			/* The checksums do not describe a target to reach */
+			memset(hdr.digest, 0, DELTA_DIGEST_SIZE);
+			GByteArray *header = g_byte_array_sized_new(DELTA_HEADER_SIZE);
+			_delta_append_header(header, &hdr);
+			g_byte_array_prepend(sums, header->data, header->len);
+			g_byte_array_free(header, TRUE);
+		}
+		return _err;
+	}
+
+	GError *err = sqlx_repository_dump_base_fd_no_copy(sq3, FALSE, 0,
+			_checksum_cb, NULL);
+	if (err)
+		g_byte_array_free(sums, TRUE);
+	else
+		*result = sums;
+	return err;
+}
+
+GError*
+sqlx_repository_diff_base(struct sqlx_sqlite3_s *sq3, gint check_type,
+		const guint8 *raw, gsize rawsize, GByteArray **result)
+{
+	struct delta_header_s remote = {0};
+	GError *err = NULL;
+
+	EXTRA_ASSERT(sq3 != NULL);
+	EXTRA_ASSERT(result != NULL);
+
+	if ((err = _delta_parse_header(raw, rawsize, &remote)))
+		return err;
+	if ((rawsize - DELTA_HEADER_SIZE) % DELTA_DIGEST_SIZE)
+		return BADREQ("Invalid checksums size (%"G_GSIZE_FORMAT" bytes)",
+				rawsize);
+	const guint8 *sums = raw + DELTA_HEADER_SIZE;
+	const guint64 nb_sums = (rawsize - DELTA_HEADER_SIZE) / DELTA_DIGEST_SIZE;
+	const gsize extent_size = (gsize)remote.page_size * remote.extent_pages;
+
+	GByteArray *delta = g_byte_array_new();
+	guint64 nb_extents = 0, nb_sent = 0;
+
+	GError *_on_extent(guint64 offset, const guint8 *data, gsize len,
+			const guint8 *digest, gpointer udata UNUSED) {
+		const guint64 idx = offset / extent_size;
+		nb_extents ++;
+		/* A partial extent has a different checksum on the peer anyway */
+		if (idx < nb_sums
+				&& !memcmp(sums + idx * DELTA_DIGEST_SIZE, digest,
+					DELTA_DIGEST_SIZE))
+			return NULL;
+		nb_sent ++;
+		_delta_append_u64(delta, offset);
+		_delta_append_u32(delta, len);
+		g_byte_array_append(delta, data, len);
+		if (delta->len > (guint64)sqliterepo_dump_max_size)
+			return NEWERROR(CODE_EXCESSIVE_LOAD, "Delta is more than %"
+					G_GINT64_FORMAT" bytes (sqliterepo.dump.max_size)",
+					sqliterepo_dump_max_size);
+		return NULL;
+	}
+	GError *_diff_cb(int fd, gpointer arg UNUSED) {
+		struct delta_header_s hdr = {0};
+		hdr.extent_pages = remote.extent_pages;
+		GError *_err = _delta_scan(fd, &hdr, _on_extent, NULL);
+		if (!_err && hdr.page_size != remote.page_size)
+			_err = BADREQ("Page size mismatch (local=%"G_GUINT32_FORMAT
+					", peer=%"G_GUINT32_FORMAT")",
+					hdr.page_size, remote.page_size);
+		if (!_err) {
+			GByteArray *header = g_byte_array_sized_new(DELTA_HEADER_SIZE);
+			_delta_append_header(header, &hdr);
+			g_byte_array_prepend(delta, header->data, header->len);
+			g_byte_array_free(header, TRUE);
+		}
+		return _err;
+	}
+
+	err = sqlx_repository_dump_base_fd_no_copy(sq3, FALSE, check_type,
+			_diff_cb, NULL);
+	if (err) {
+		g_byte_array_free(delta, TRUE);
+	} else {
+		GRID_DEBUG("DELTA [%s][%s] %"G_GUINT64_FORMAT"/%"G_GUINT64_FORMAT
+				" extents, %u bytes", sq3->name.base, sq3->name.type,
+				nb_sent, nb_extents, delta->len);
+		*result = delta;
+	}
+	return err;
+}
+
+/* Apply the delta on a copy of the database file, check the copy is now
+ * the same as the file of the peer, then restore the base from that copy
+ * in one transaction. */
+GError*
+sqlx_repository_patch_base(struct sqlx_sqlite3_s *sq3,
+		const guint8 *raw, gsize rawsize)
+{
+	struct delta_header_s hdr = {0}, patched = {0};
+	gchar path[LIMIT_LENGTH_VOLUMENAME+32] = {0};
+	GError *err = NULL;
+	int fd = -1, rc;
+
+	EXTRA_ASSERT(sq3 != NULL);
+
+	if ((err = _delta_parse_header(raw, rawsize, &hdr)))
+		return err;
+
+	/* Make sure the file holds everything, then copy it */
+	if ((rc = sqlite3_db_cacheflush(sq3->db)) != SQLITE_OK)
+		return SYSERR("Failed to flush cache: %s", sqlite_strerror(rc));
+	if ((err = sqlx_repository_flush_wal(sq3)))
+		return err;
+
+	g_snprintf(path, sizeof(path), "%s/tmp/patch.sqlite3.XXXXXX",
+			sq3->repo->basedir);
+	if (0 > (fd = g_mkstemp(path)))
+		return NEWERROR(errno, "Temporary file creation error: %s",
+				strerror(errno));
+	metautils_pclose(&fd);
+	unlink(path);
+	if ((err = metautils_syscall_copy_file(sq3->path_inline, path)))
+		goto end;
+	if (0 > (fd = open(path, O_RDWR)))  {
+		err = NEWERROR(errno, "Failed to open %s: %s", path, strerror(errno));
+		goto end;
+	}
+
+	guint32 page_size = 0;
+	if ((err = _read_page_size(fd, &page_size)))
+		goto end;
+	if (page_size != hdr.page_size) {
+		err = BADREQ("Page size mismatch (local=%"G_GUINT32_FORMAT
+				", peer=%"G_GUINT32_FORMAT")", page_size, hdr.page_size);
+		goto end;
+	}
+
+	const guint8 *p = raw + DELTA_HEADER_SIZE, *end = raw + rawsize;
+	while (!err && p < end) {
+		if (end - p < 12) {
+			err = BADREQ("Truncated delta");
+			break;
+		}
+		const guint64 offset = _delta_read_u64(p);
+		const guint32 len = _delta_read_u32(p + 8);
+		p += 12;
+		if ((guint64)(end - p) < len || offset + len > hdr.file_size) {
+			err = BADREQ("Invalid extent in delta");
+			break;
+		}
+		err = _pwrite_full(fd, p, len, offset);
+		p += len;
+	}
+	if (!err && ftruncate(fd, hdr.file_size) < 0)
+		err = NEWERROR(errno, "Failed to truncate %s: %s", path,
+				strerror(errno));
+
+	if (!err) {
+		GError *_on_extent(guint64 o UNUSED, const guint8 *d UNUSED,
+				gsize l UNUSED, const guint8 *dg UNUSED, gpointer u UNUSED) {
+			return NULL;
+		}
+		patched.extent_pages = hdr.extent_pages;
+		err = _delta_scan(fd, &patched, _on_extent, NULL);
+		if (!err && memcmp(patched.digest, hdr.digest, DELTA_DIGEST_SIZE))
+			err = NEWERROR(CODE_CORRUPT_DATABASE,
+					"Patched base differs from the peer's one");
+	}
+
+	if (!err)
+		err = sqlx_repository_restore_from_file(sq3, path);
+
+end:
+	if (fd >= 0)
+		metautils_pclose(&fd);
+	unlink(path);
+	if (err)
+		g_prefix_error(&err, "Delta restore failed: ");
+	return err;
+}
+
 GError*
 sqlx_repository_restore_from_master(struct sqlx_sqlite3_s *sq3,
 		const gint check_type)
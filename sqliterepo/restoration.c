@@ -21,8 +21,10 @@ License along with this library.
 #include <unistd.h>
 
 #include <glib.h>
+#include <zlib.h>
 
 #include <metautils/lib/metautils.h>
+#include "internals.h"
 #include "restoration.h"
 
 GError*
@@ -65,3 +67,33 @@ restore_ctx_append(struct restore_ctx_s *ctx, guint8 *raw, gsize rawsize)
 	}
 	return NULL;
 }
+
+GError*
+restore_ctx_inflate(struct restore_ctx_s *ctx, guint8 *raw, gsize rawsize)
+{
+	z_stream zs = {0};
+	int rc = inflateInit(&zs);
+	if (rc != Z_OK)
+		return SYSERR("inflateInit error: (%d) %s", rc, zs.msg ? zs.msg : "?");
+
+	GError *err = NULL;
+	guint8 *out = g_malloc(SQLX_DUMP_BUFFER_SIZE);
+	zs.next_in = raw;
+	zs.avail_in = rawsize;
+	do {
+		zs.next_out = out;
+		zs.avail_out = SQLX_DUMP_BUFFER_SIZE;
+		rc = inflate(&zs, Z_NO_FLUSH);
+		if (rc != Z_OK && rc != Z_STREAM_END) {
+			err = NEWERROR(CODE_BAD_REQUEST, "Invalid compressed dump: (%d) %s",
+					rc, zs.msg ? zs.msg : "?");
+		} else {
+			err = restore_ctx_append(ctx, out,
+					SQLX_DUMP_BUFFER_SIZE - zs.avail_out);
+		}
+	} while (!err && rc != Z_STREAM_END);
+
+	inflateEnd(&zs);
+	g_free(out);
+	return err;
+}
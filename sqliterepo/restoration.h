@@ -32,4 +32,7 @@ GError *restore_ctx_create(const gchar *path_pattern, struct restore_ctx_s **ctx
 void restore_ctx_clear(struct restore_ctx_s **ctx);
 GError *restore_ctx_append(struct restore_ctx_s *ctx, guint8 *raw, gsize rawsize);
 
+/* Inflate the zlib stream into the file, a bounded piece at a time */
+GError *restore_ctx_inflate(struct restore_ctx_s *ctx, guint8 *raw, gsize rawsize);
+
 #endif /*OIO_SDS__sqliterepo__restoration_h*/
\ No newline at end of file
@@ -20,6 +20,8 @@ License along with this library.
 
 #include <string.h>
 
+#include <sqliterepo/sqliterepo_variables.h>
+
 #include "sqliterepo.h"
 #include "version.h"
 
@@ -116,15 +118,13 @@ sqlx_set_page_size(sqlite3 *handle, guint page_size)
 	return rc;
 }
 
-int
-sqlx_sqlite3_finalize(struct sqlx_sqlite3_s *sq3, sqlite3_stmt *stmt,
+static void
+_save_update_query(struct sqlx_sqlite3_s *sq3, sqlite3_stmt *stmt,
 		GError *err)
 {
-	EXTRA_ASSERT(sq3 != NULL);
-
 	if (err || !sq3->save_update_queries
 			|| sqlite3_stmt_readonly(stmt))
-		goto end;
+		return;
 
 	gchar *expanded_sql = sqlite3_expanded_sql(stmt);
 	if (sq3->transaction) {
@@ -135,11 +135,121 @@ sqlx_sqlite3_finalize(struct sqlx_sqlite3_s *sq3, sqlite3_stmt *stmt,
 				g_strdup(expanded_sql));
 	}
 	sqlite3_free(expanded_sql);
+}
 
-end:
+int
+sqlx_sqlite3_finalize(struct sqlx_sqlite3_s *sq3, sqlite3_stmt *stmt,
+		GError *err)
+{
+	EXTRA_ASSERT(sq3 != NULL);
+	_save_update_query(sq3, stmt, err);
 	return sqlite3_finalize(stmt);
 }
 
+/* ------------------------------------------------------------------------- */
+
+/* Shared by all the bases of the process, thus only atomically updated */
+static volatile gsize stmt_cache_hits = 0;
+static volatile gsize stmt_cache_misses = 0;
+static volatile gsize stmt_cache_evictions = 0;
+
+int
+sqlx_sqlite3_prepare(struct sqlx_sqlite3_s *sq3, const gchar *sql,
+		int len, sqlite3_stmt **result)
+{
+	EXTRA_ASSERT(sq3 != NULL && sq3->db != NULL);
+	EXTRA_ASSERT(sql != NULL);
+	EXTRA_ASSERT(result != NULL);
+
+	if (sq3->statements && g_hash_table_size(sq3->statements) > 0) {
+		/* The keys are the SQL texts as returned by sqlite3_sql() */
+		gchar *copy = NULL;
+		const gchar *key = sql;
+		if (len >= 0 && sql[len] != '\0')
+			key = copy = g_strndup(sql, len);
+		GList *link = g_hash_table_lookup(sq3->statements, key);
+		g_free(copy);
+		if (link) {
+			sqlite3_stmt *stmt = link->data;
+			g_hash_table_remove(sq3->statements, sqlite3_sql(stmt));
+			g_queue_delete_link(&sq3->stmt_lru, link);
+			g_atomic_pointer_add(&stmt_cache_hits, 1);
+			*result = stmt;
+			return SQLITE_OK;
+		}
+	}
+
+	int rc;
+	sqlite3_prepare_debug(rc, sq3->db, sql, len, result, NULL);
+	if (rc == SQLITE_OK && sqliterepo_stmt_cache_max > 0)
+		g_atomic_pointer_add(&stmt_cache_misses, 1);
+	return rc;
+}
+
+int
+sqlx_sqlite3_release(struct sqlx_sqlite3_s *sq3, sqlite3_stmt *stmt,
+		GError *err)
+{
+	EXTRA_ASSERT(sq3 != NULL);
+
+	if (!stmt)
+		return SQLITE_OK;
+	_save_update_query(sq3, stmt, err);
+
+	const gchar *key = sqlite3_sql(stmt);
+	if (!sqliterepo_stmt_cache_max || !key)
+		return sqlite3_finalize(stmt);
+
+	/* Like sqlite3_finalize(), sqlite3_reset() returns the error of the
+	 * last evaluation of the statement. */
+	const int rc = sqlite3_reset(stmt);
+	sqlite3_clear_bindings(stmt);
+
+	if (rc == SQLITE_SCHEMA) {
+		/* The schema changed under the other statements too */
+		sqlx_sqlite3_clear_statements(sq3);
+	}
+
+	if (!sq3->statements)
+		sq3->statements = g_hash_table_new(g_str_hash, g_str_equal);
+	if (g_hash_table_contains(sq3->statements, key)) {
+		/* The same SQL has been run in a nested way, one copy is enough */
+		sqlite3_finalize(stmt);
+		return rc;
+	}
+
+	g_queue_push_head(&sq3->stmt_lru, stmt);
+	g_hash_table_insert(sq3->statements, (gpointer)key, sq3->stmt_lru.head);
+	while (sq3->stmt_lru.length > sqliterepo_stmt_cache_max) {
+		sqlite3_stmt *old = g_queue_pop_tail(&sq3->stmt_lru);
+		g_hash_table_remove(sq3->statements, sqlite3_sql(old));
+		sqlite3_finalize(old);
+		g_atomic_pointer_add(&stmt_cache_evictions, 1);
+	}
+	return rc;
+}
+
+void
+sqlx_sqlite3_clear_statements(struct sqlx_sqlite3_s *sq3)
+{
+	EXTRA_ASSERT(sq3 != NULL);
+
+	if (sq3->statements)
+		g_hash_table_remove_all(sq3->statements);
+	sqlite3_stmt *stmt;
+	while ((stmt = g_queue_pop_head(&sq3->stmt_lru)))
+		sqlite3_finalize(stmt);
+}
+
+void
+sqlx_sqlite3_stmt_cache_stats(struct sqlx_stmt_cache_stats_s *out)
+{
+	EXTRA_ASSERT(out != NULL);
+	out->hits = (gsize) g_atomic_pointer_get(&stmt_cache_hits);
+	out->misses = (gsize) g_atomic_pointer_get(&stmt_cache_misses);
+	out->evictions = (gsize) g_atomic_pointer_get(&stmt_cache_evictions);
+}
+
 #ifdef HAVE_EXTRA_DEBUG
 #define _dump_entry(tag,k,v) \
 	GRID_TRACE2("%s: %s <- {del:%d, changed:%d, %s}", tag, \
@@ -515,9 +625,10 @@ sqlx_admin_save_lazy_tnx (struct sqlx_sqlite3_s *sq3)
 {
 	if (!sq3 || !sq3->admin_dirty)
 		return 0;
-	sqlx_exec (sq3->db, "BEGIN");
+	/* A savepoint, to be nested in a transaction held by a group */
+	sqlx_exec (sq3->db, "SAVEPOINT admin_save");
 	guint rc = sqlx_admin_save (sq3);
-	sqlx_exec (sq3->db, "COMMIT");
+	sqlx_exec (sq3->db, "RELEASE admin_save");
 	sq3->admin_dirty = 0;
 	return rc;
 }
@@ -148,6 +148,32 @@ struct sqlx_sqlite3_s;
 int sqlx_sqlite3_finalize(struct sqlx_sqlite3_s *sq3, sqlite3_stmt *stmt,
 		GError *err);
 
+/* Like sqlite3_prepare_v2(), but reuses a statement previously given back
+ * with sqlx_sqlite3_release() on the same base, for the same SQL text.
+ * A statement obtained here is owned by the caller until it is released. */
+int sqlx_sqlite3_prepare(struct sqlx_sqlite3_s *sq3, const gchar *sql,
+		int len, sqlite3_stmt **result);
+
+/* Like sqlx_sqlite3_finalize(), but the statement is reset, its bindings
+ * are cleared, and it is kept in the statement cache of the base. */
+int sqlx_sqlite3_release(struct sqlx_sqlite3_s *sq3, sqlite3_stmt *stmt,
+		GError *err);
+
+/* Finalize all the statements kept in the cache of the base. Must be called
+ * when the schema changes, when the content is replaced and before the
+ * base is closed. */
+void sqlx_sqlite3_clear_statements(struct sqlx_sqlite3_s *sq3);
+
+/* Process-wide counters of the caches of prepared statements */
+struct sqlx_stmt_cache_stats_s
+{
+	guint64 hits;       /* statements reused from a cache */
+	guint64 misses;     /* statements that had to be prepared */
+	guint64 evictions;  /* cached statements finalized to make room */
+};
+
+void sqlx_sqlite3_stmt_cache_stats(struct sqlx_stmt_cache_stats_s *out);
+
 struct oio_url_s* sqlx_admin_get_url (struct sqlx_sqlite3_s *sq3);
 
 /* load the whole internal cached from the <admin> table. */
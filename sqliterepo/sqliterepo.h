@@ -129,6 +129,11 @@ struct sqlx_sqlite3_s
 	GList *transaction_update_queries;
 	GList *update_queries;
 
+	// Prepared statements kept for a later reuse, keyed by their SQL text.
+	// Only the statements not in use are there, and they are reset.
+	GHashTable *statements; // <const gchar*,GList*> the links of <stmt_lru>
+	GQueue stmt_lru; // <sqlite3_stmt*>, most recently released first
+
 	// Sharding
 	struct beanstalkd_s *sharding_queue;
 };
@@ -321,20 +326,40 @@ typedef GError*(*dump_base_chunked_cb)(GByteArray *gba, gint64 remaining_bytes,
 
 /** Open a dump of the base (with only the meaningful pages),
  *  and send parts of it to a callback, as GByteArrays (must be cleaned
- *  by caller). */
+ *  by caller). With a positive <compression_level>, the parts are the
+ *  successive pieces of one zlib stream of the dump. */
 GError* sqlx_repository_dump_base_chunked(struct sqlx_sqlite3_s *sq3,
-		gint chunk_size, gint check_type,
+		gint chunk_size, gint check_type, gint compression_level,
 		dump_base_chunked_cb callback, gpointer callback_arg);
 
 /** Flush the WAL of the database (does nothing if journal_mode!=WAL). */
 GError* sqlx_repository_flush_wal(struct sqlx_sqlite3_s *sq3);
 
+/** Restore the base from a raw dump, or from the zlib stream of a dump
+ *  if <compressed> is set. */
 GError* sqlx_repository_restore_base(struct sqlx_sqlite3_s *sq3,
-		guint8 *raw, gsize rawsize);
+		guint8 *raw, gsize rawsize, gboolean compressed);
 
 GError* sqlx_repository_restore_from_file(struct sqlx_sqlite3_s *sq3,
 		const gchar *path);
 
+/** Compute one checksum for each extent of <extent_pages> pages of the
+ *  database file, to be sent to a peer holding a more recent copy. */
+GError* sqlx_repository_checksum_base(struct sqlx_sqlite3_s *sq3,
+		guint extent_pages, GByteArray **checksums);
+
+/** Collect the extents of the database file that differ from the
+ *  checksums computed by a peer with sqlx_repository_checksum_base(). */
+GError* sqlx_repository_diff_base(struct sqlx_sqlite3_s *sq3,
+		gint check_type, const guint8 *checksums, gsize checksums_size,
+		GByteArray **delta);
+
+/** Apply a delta collected by sqlx_repository_diff_base() on a peer, so
+ *  that the base becomes a copy of the base of that peer. The base is left
+ *  untouched if it fails. */
+GError* sqlx_repository_patch_base(struct sqlx_sqlite3_s *sq3,
+		const guint8 *delta, gsize delta_size);
+
 GError* sqlx_repository_restore_from_master(struct sqlx_sqlite3_s *sq3,
 		const gint check_type);
 
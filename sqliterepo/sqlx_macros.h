@@ -37,16 +37,22 @@ License along with this library.
 #define NAME_MSGNAME_SQLX_USE                "DB_USE"
 #define NAME_MSGNAME_SQLX_GETVERS            "DB_VERS"
 #define NAME_MSGNAME_SQLX_REPLICATE          "DB_REPLI"
+#define NAME_MSGNAME_SQLX_REPLICATE_MANY     "DB_REPLI_MANY"
 #define NAME_MSGNAME_SQLX_PIPETO             "DB_PIPETO"
 #define NAME_MSGNAME_SQLX_PIPEFROM           "DB_PIPEFROM"
 #define NAME_MSGNAME_SQLX_REMOVE             "DB_REMOVE"
 #define NAME_MSGNAME_SQLX_SNAPSHOT           "DB_SNAPSHOT"
 #define NAME_MSGNAME_SQLX_DUMP               "DB_DUMP"
 #define NAME_MSGNAME_SQLX_RESTORE            "DB_RESTORE"
+#define NAME_MSGNAME_SQLX_CHECKSUM           "DB_CHECKSUM"
+#define NAME_MSGNAME_SQLX_PATCH              "DB_PATCH"
 #define NAME_MSGNAME_SQLX_RESYNC             "DB_RESYNC"
 #define NAME_MSGNAME_SQLX_VACUUM             "DB_VACUUM"
 #define NAME_MSGNAME_SQLX_LOCAL_COPY         "DB_LOCAL_COPY"
 
+/* Compression of the parts of a chunked DB_DUMP */
+#define SQLX_DUMP_COMPRESSION_ZLIB           "zlib"
+
 /* repository-wide */
 #define NAME_MSGNAME_SQLX_INFO               "DB_INFO"
 #define NAME_MSGNAME_SQLX_LEANIFY            "DB_LEAN"
@@ -215,6 +215,12 @@ sqlx_pack_DUMP(const struct sqlx_name_s *name, gboolean chunked,
 {
 	MESSAGE req = make_request(NAME_MSGNAME_SQLX_DUMP, NULL, name, deadline);
 	metautils_message_add_field(req, NAME_MSGKEY_CHUNKED, &chunked, 1);
+	/* The parts of a chunked dump may come compressed, if the server
+	 * is configured so. Older servers just ignore this. */
+	if (chunked) {
+		metautils_message_add_field_str(req, NAME_MSGKEY_COMPRESSION,
+				SQLX_DUMP_COMPRESSION_ZLIB);
+	}
 	/* If < 0, keep the server default. */
 	if (check_type >= 0) {
 		metautils_message_add_field_strint64(
@@ -225,11 +231,34 @@ sqlx_pack_DUMP(const struct sqlx_name_s *name, gboolean chunked,
 
 GByteArray*
 sqlx_pack_RESTORE(const struct sqlx_name_s *name,
-		const guint8 *raw, gsize rawsize,
+		const guint8 *raw, gsize rawsize, const gchar *compression,
 		const gchar *local_addr, gint64 deadline)
 {
 	MESSAGE req = make_request(NAME_MSGNAME_SQLX_RESTORE, NULL, name, deadline);
 	metautils_message_add_field_str(req, NAME_MSGKEY_SRC, local_addr);
+	if (compression)
+		metautils_message_add_field_str(req, NAME_MSGKEY_COMPRESSION,
+				compression);
+	metautils_message_set_BODY(req, raw, rawsize);
+	return message_marshall_gba_and_clean(req);
+}
+
+GByteArray*
+sqlx_pack_CHECKSUM(const struct sqlx_name_s *name, guint extent_pages,
+		gint64 deadline)
+{
+	MESSAGE req = make_request(NAME_MSGNAME_SQLX_CHECKSUM, NULL, name, deadline);
+	metautils_message_add_field_strint64(req, NAME_MSGKEY_EXTENT, extent_pages);
+	return message_marshall_gba_and_clean(req);
+}
+
+GByteArray*
+sqlx_pack_PATCH(const struct sqlx_name_s *name,
+		const guint8 *raw, gsize rawsize,
+		const gchar *local_addr, gint64 deadline)
+{
+	MESSAGE req = make_request(NAME_MSGNAME_SQLX_PATCH, NULL, name, deadline);
+	metautils_message_add_field_str(req, NAME_MSGKEY_SRC, local_addr);
 	metautils_message_set_BODY(req, raw, rawsize);
 	return message_marshall_gba_and_clean(req);
 }
@@ -247,6 +276,38 @@ sqlx_pack_REPLICATE(const struct sqlx_name_s *name,
 	return message_marshall_gba_and_clean(req);
 }
 
+GByteArray*
+sqlx_pack_REPLICATE_MANY(const struct sqlx_name_s *name,
+		struct TableSequence **tabseqs, guint count,
+		const gchar *local_addr, gint64 deadline, GError **err)
+{
+	EXTRA_ASSERT(name != NULL);
+	EXTRA_ASSERT(tabseqs != NULL);
+
+	GByteArray *body = g_byte_array_sized_new(2048 * count);
+	for (guint i = 0; i < count; i++) {
+		GError *e = NULL;
+		GByteArray *encoded = sqlx_encode_TableSequence(tabseqs[i], &e);
+		if (!encoded) {
+			/* The slave applies all the sequences or none of them */
+			if (err)
+				*err = SYSERR("Sequence %u/%u: %s",
+						i + 1, count, e ? e->message : "encoding error");
+			g_clear_error(&e);
+			g_byte_array_unref(body);
+			return NULL;
+		}
+		g_byte_array_append(body, encoded->data, encoded->len);
+		g_byte_array_unref(encoded);
+	}
+
+	MESSAGE req = make_request(NAME_MSGNAME_SQLX_REPLICATE_MANY, NULL, name,
+			deadline);
+	metautils_message_add_field_str(req, NAME_MSGKEY_SRC, local_addr);
+	metautils_message_add_body_unref(req, body);
+	return message_marshall_gba_and_clean(req);
+}
+
 GByteArray*
 sqlx_pack_GETVERS(const struct sqlx_name_s *name, const gchar *peers,
 		gint64 deadline)
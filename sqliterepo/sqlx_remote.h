@@ -114,7 +114,14 @@ GByteArray* sqlx_pack_REMOVE(const struct sqlx_name_s *name, gint64 deadline);
 GByteArray* sqlx_pack_RESYNC(const struct sqlx_name_s *name, const gint check_type, gint64 deadline);
 GByteArray* sqlx_pack_VACUUM(const struct sqlx_name_s *name, gboolean local, gint64 deadline);
 GByteArray* sqlx_pack_DUMP(const struct sqlx_name_s *name, gboolean chunked, gint check_type, gint64 deadline);
+/* <compression> is NULL for a raw dump */
 GByteArray* sqlx_pack_RESTORE(
+		const struct sqlx_name_s *name, const guint8 *raw, gsize rawsize,
+		const gchar *compression, const gchar *local_addr, gint64 deadline);
+
+GByteArray* sqlx_pack_CHECKSUM(const struct sqlx_name_s *name,
+		guint extent_pages, gint64 deadline);
+GByteArray* sqlx_pack_PATCH(
 		const struct sqlx_name_s *name, const guint8 *raw, gsize rawsize,
 		const gchar *local_addr, gint64 deadline);
 
@@ -122,6 +129,13 @@ GByteArray* sqlx_pack_REPLICATE(
 		const struct sqlx_name_s *name, struct TableSequence *tabseq,
 		const gchar *local_addr, gint64 deadline);
 
+/* Pack several sequences of changes, to be applied in that order and in the
+ * same transaction by the slave. Returns NULL and sets <err> if any of the
+ * sequences cannot be encoded. */
+GByteArray* sqlx_pack_REPLICATE_MANY(
+		const struct sqlx_name_s *name, struct TableSequence **tabseqs,
+		guint count, const gchar *local_addr, gint64 deadline, GError **err);
+
 // service-wide requests
 GByteArray* sqlx_pack_LEANIFY(gint64 deadline);
 GByteArray* sqlx_pack_INFO(gint64 deadline);
@@ -134,11 +148,20 @@ GByteArray* sqlx_encode_TableSequence(struct TableSequence *tabseq,
 // replication handy functions -------------------------------------------------
 
 GError * peers_restore(gchar **targets, struct sqlx_name_s *name,
-		GByteArray *dump, const gchar *local_addr, gint64 deadline);
+		GByteArray *dump, const gchar *compression,
+		const gchar *local_addr, gint64 deadline);
 
 GError * peer_restore(const gchar *target, struct sqlx_name_s *name,
 		GByteArray *dump, const gchar *local_addr, gint64 deadline);
 
+/* Ask the peer for the checksums of the extents of its copy of the base. */
+GError * peer_checksum(const gchar *target, struct sqlx_name_s *name,
+		guint extent_pages, GByteArray **checksums, gint64 deadline);
+
+/* Send the extents that differ on the peer. <delta> is consumed. */
+GError * peer_patch(const gchar *target, struct sqlx_name_s *name,
+		GByteArray *delta, const gchar *local_addr, gint64 deadline);
+
 typedef GError* (*peer_dump_cb)(GByteArray *part, gint64 remaining, gpointer arg);
 
 GError * peer_dump(const gchar *target, struct sqlx_name_s *name, gboolean chunked,
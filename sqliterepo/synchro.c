@@ -73,6 +73,60 @@ struct sqlx_sync_s
 	guint hash_depth;
 
 	struct grid_single_rrd_s *conn_attempts;
+
+	/* The node creations, deletions and listings issued by the elections
+	 * are queued for at most sqliterepo.zk.batch.delay, then sent by the
+	 * batch thread (see _batch_flush()).
+	 * The completions are called from the ZK thread, as usual, except for
+	 * the calls failing when they are sent (e.g. the session expired in
+	 * the meantime): those are completed by the batch thread, or by the
+	 * thread closing the connection, as zookeeper_close() itself does.
+	 * This is safe for the completions of the elections: they only defer
+	 * their work to the pool of the shard (see completion_do_or_defer()),
+	 * or log. */
+	GMutex batch_lock;
+	GCond batch_cond;
+	GThread *batch_thread;
+	/* <struct zk_batch_item_s*> */
+	GPtrArray *batch_pending;
+	/* When the oldest pending item has been queued */
+	gint64 batch_first;
+	gboolean batch_stopping;
+};
+
+/* @private */
+enum zk_batch_op_e { ZKOP_CREATE, ZKOP_DELETE, ZKOP_LIST };
+
+/* @private */
+struct zk_batch_item_s
+{
+	/* Next item sharing the same listing */
+	struct zk_batch_item_s *next;
+	enum zk_batch_op_e type;
+	union {
+		string_completion_t create;
+		void_completion_t delete;
+		strings_completion_t list;
+	} on;
+	const void *data;
+	int flags;
+	int version;
+	int vlen;
+	gchar *value;
+	/* The real path of the node (or of its parent, for a listing) */
+	gchar path[PATH_MAXLEN];
+	/* The path of the node actually created (for a sequential node) */
+	gchar created[PATH_MAXLEN];
+};
+
+/* @private */
+struct zk_batch_multi_s
+{
+	struct sqlx_sync_s *ss;
+	zoo_op_t *ops;
+	zoo_op_result_t *results;
+	guint count;
+	struct zk_batch_item_s *items[];
 };
 
 static void _clear(struct sqlx_sync_s *ss);
@@ -161,6 +215,9 @@ sqlx_sync_create(const char *url)
 	ss->zk_url = shuffled;
 	ss->conn_attempts = grid_single_rrd_create(
 			oio_ext_monotonic_seconds(), disconnection_rrd_window + 1);
+	g_mutex_init(&ss->batch_lock);
+	g_cond_init(&ss->batch_cond);
+	ss->batch_pending = g_ptr_array_new();
 	return ss;
 }
 
@@ -318,6 +375,258 @@ zk_main_watch(zhandle_t *zh, int type, int state, const char *path UNUSED,
 	}
 }
 
+//------------------------------------------------------------------------------
+
+static void
+_batch_item_free(struct zk_batch_item_s *item)
+{
+	g_free(item->value);
+	g_free(item);
+}
+
+/* Call the completion of the item with the given result, then free it. */
+static void
+_batch_item_complete(struct zk_batch_item_s *item, int zrc)
+{
+	switch (item->type) {
+		case ZKOP_CREATE:
+			item->on.create(zrc, zrc == ZOK ? item->created : NULL, item->data);
+			break;
+		case ZKOP_DELETE:
+			item->on.delete(zrc, item->data);
+			break;
+		case ZKOP_LIST:
+			item->on.list(zrc, NULL, item->data);
+			break;
+	}
+	_batch_item_free(item);
+}
+
+/* Send a creation or a deletion on its own */
+static void
+_batch_send_one(struct sqlx_sync_s *ss, struct zk_batch_item_s *item)
+{
+	int zrc;
+	if (item->type == ZKOP_CREATE) {
+		zrc = zoo_acreate(ss->zh, item->path, item->value, item->vlen,
+				&ZOO_OPEN_ACL_UNSAFE, item->flags, item->on.create, item->data);
+	} else {
+		zrc = zoo_adelete(ss->zh, item->path, item->version,
+				item->on.delete, item->data);
+	}
+	if (zrc != ZOK)
+		return _batch_item_complete(item, zrc);
+	_batch_item_free(item);
+}
+
+static void
+_batch_multi_free(struct zk_batch_multi_s *multi)
+{
+	g_free(multi->ops);
+	g_free(multi->results);
+	g_free(multi);
+}
+
+static void
+_batch_on_multi(int rc, const void *data)
+{
+	struct zk_batch_multi_s *multi = (struct zk_batch_multi_s *) data;
+	for (guint i = 0; i < multi->count; i++) {
+		struct zk_batch_item_s *item = multi->items[i];
+		const int zrc = multi->results[i].err;
+		if (rc == ZOK) {
+			_batch_item_complete(item, zrc);
+		} else if (rc > ZAPIERROR) {
+			/* System error (connection loss, timeout...): the results
+			 * are not set, all the operations failed the same way. */
+			_batch_item_complete(item, rc);
+		} else if (zrc != ZOK && zrc != ZRUNTIMEINCONSISTENCY) {
+			/* The operation that made the whole transaction fail */
+			_batch_item_complete(item, zrc);
+		} else {
+			/* Rolled back because of another operation, it has to be
+			 * replayed alone. */
+			_batch_send_one(multi->ss, item);
+		}
+	}
+	_batch_multi_free(multi);
+}
+
+static void
+_batch_send_multi(struct sqlx_sync_s *ss, struct zk_batch_item_s **items,
+		const guint count)
+{
+	if (count == 1)
+		return _batch_send_one(ss, items[0]);
+
+	struct zk_batch_multi_s *multi =
+		g_malloc0(sizeof(*multi) + count * sizeof(struct zk_batch_item_s *));
+	multi->ss = ss;
+	multi->count = count;
+	multi->ops = g_malloc0(count * sizeof(zoo_op_t));
+	multi->results = g_malloc0(count * sizeof(zoo_op_result_t));
+	for (guint i = 0; i < count; i++) {
+		struct zk_batch_item_s *item = items[i];
+		multi->items[i] = item;
+		if (item->type == ZKOP_CREATE) {
+			zoo_create_op_init(multi->ops + i, item->path,
+					item->value, item->vlen, &ZOO_OPEN_ACL_UNSAFE, item->flags,
+					item->created, sizeof(item->created));
+		} else {
+			zoo_delete_op_init(multi->ops + i, item->path, item->version);
+		}
+	}
+
+	int zrc = zoo_amulti(ss->zh, count, multi->ops, multi->results,
+			_batch_on_multi, multi);
+	if (zrc != ZOK) {
+		for (guint i = 0; i < count; i++)
+			_batch_item_complete(multi->items[i], zrc);
+		_batch_multi_free(multi);
+	}
+}
+
+/* Fan the result of a shared listing out to all the items waiting for it */
+static void
+_batch_on_list(int rc, const struct String_vector *strings, const void *data)
+{
+	struct zk_batch_item_s *item = (struct zk_batch_item_s *) data;
+	while (item) {
+		struct zk_batch_item_s *next = item->next;
+		item->on.list(rc, strings, item->data);
+		_batch_item_free(item);
+		item = next;
+	}
+}
+
+static void
+_batch_flush(struct sqlx_sync_s *ss, GPtrArray *items)
+{
+	const guint max = MAX(sqliterepo_zk_batch_max, 1);
+	struct zk_batch_item_s **changes =
+		g_malloc0(items->len * sizeof(struct zk_batch_item_s *));
+	guint nb_changes = 0;
+	/* <gchar*,struct zk_batch_item_s*>, the first waiter for each listing */
+	GHashTable *listings = g_hash_table_new(g_str_hash, g_str_equal);
+	GPtrArray *heads = g_ptr_array_new();
+
+	for (guint i = 0; i < items->len; i++) {
+		struct zk_batch_item_s *item = items->pdata[i];
+		if (item->type != ZKOP_LIST) {
+			changes[nb_changes++] = item;
+			continue;
+		}
+		struct zk_batch_item_s *head = g_hash_table_lookup(listings, item->path);
+		if (!head) {
+			g_hash_table_insert(listings, item->path, item);
+			g_ptr_array_add(heads, item);
+		} else {
+			item->next = head->next;
+			head->next = item;
+		}
+	}
+
+	/* Creations and deletions first, in the order they have been queued,
+	 * so that the listings see their effects. */
+	for (guint i = 0; i < nb_changes; i += max)
+		_batch_send_multi(ss, changes + i, MIN(max, nb_changes - i));
+
+	for (guint i = 0; i < heads->len; i++) {
+		struct zk_batch_item_s *head = heads->pdata[i];
+		int zrc = zoo_awget_children(ss->zh, head->path, NULL, NULL,
+				_batch_on_list, head);
+		if (zrc != ZOK)
+			_batch_on_list(zrc, NULL, head);
+	}
+
+	GRID_TRACE("Zookeeper: batch of %u changes and %u listings (%u items)",
+			nb_changes, heads->len, items->len);
+
+	g_ptr_array_free(heads, TRUE);
+	g_hash_table_destroy(listings);
+	g_free(changes);
+	g_ptr_array_free(items, TRUE);
+}
+
+static gpointer
+_batch_worker(gpointer p)
+{
+	struct sqlx_sync_s *ss = p;
+	metautils_ignore_signals();
+
+	g_mutex_lock(&ss->batch_lock);
+	while (!ss->batch_stopping) {
+		if (ss->batch_pending->len == 0) {
+			g_cond_wait(&ss->batch_cond, &ss->batch_lock);
+			continue;
+		}
+		const gint64 deadline = ss->batch_first + sqliterepo_zk_batch_delay;
+		if (ss->batch_pending->len < sqliterepo_zk_batch_max
+				&& g_get_monotonic_time() < deadline) {
+			g_cond_wait_until(&ss->batch_cond, &ss->batch_lock, deadline);
+			continue;
+		}
+		GPtrArray *items = ss->batch_pending;
+		ss->batch_pending = g_ptr_array_new();
+		g_mutex_unlock(&ss->batch_lock);
+		_batch_flush(ss, items);
+		g_mutex_lock(&ss->batch_lock);
+	}
+	g_mutex_unlock(&ss->batch_lock);
+	return NULL;
+}
+
+static gboolean
+_batch_enabled(struct sqlx_sync_s *ss)
+{
+	return ss->batch_thread != NULL && sqliterepo_zk_batch_delay > 0;
+}
+
+static int
+_batch_push(struct sqlx_sync_s *ss, struct zk_batch_item_s *item)
+{
+	/* Fail at once when zoo_acreate() and co. would, so that the caller
+	 * handles the error in place, and not in its completion. */
+	const int state = zoo_state(ss->zh);
+
+	if (state == ZOO_EXPIRED_SESSION_STATE || state == ZOO_AUTH_FAILED_STATE) {
+		_batch_item_free(item);
+		return ZINVALIDSTATE;
+	}
+
+	g_mutex_lock(&ss->batch_lock);
+	if (ss->batch_pending->len == 0)
+		ss->batch_first = g_get_monotonic_time();
+	g_ptr_array_add(ss->batch_pending, item);
+	if (ss->batch_pending->len == 1
+			|| ss->batch_pending->len >= sqliterepo_zk_batch_max)
+		g_cond_signal(&ss->batch_cond);
+	g_mutex_unlock(&ss->batch_lock);
+	return ZOK;
+}
+
+static void
+_batch_stop(struct sqlx_sync_s *ss)
+{
+	if (!ss->batch_thread)
+		return;
+
+	g_mutex_lock(&ss->batch_lock);
+	ss->batch_stopping = TRUE;
+	g_cond_signal(&ss->batch_cond);
+	g_mutex_unlock(&ss->batch_lock);
+	g_thread_join(ss->batch_thread);
+	ss->batch_thread = NULL;
+
+	/* Send what is still pending, e.g. the deletions of the nodes of the
+	 * elections exited at shutdown. */
+	if (ss->batch_pending->len > 0) {
+		GPtrArray *items = ss->batch_pending;
+		ss->batch_pending = g_ptr_array_new();
+		_batch_flush(ss, items);
+	}
+}
+
 static GError*
 _open(struct sqlx_sync_s *ss)
 {
@@ -331,6 +640,8 @@ _open(struct sqlx_sync_s *ss)
 			ss, ZOO_NO_LOG_CLIENTENV);
 	if (NULL == ss->zh)
 		return NEWERROR(CODE_INTERNAL_ERROR, "ZK connection failure");
+	ss->batch_stopping = FALSE;
+	ss->batch_thread = g_thread_new("zk-batch", _batch_worker, ss);
 	return NULL;
 }
 
@@ -339,6 +650,7 @@ _close(struct sqlx_sync_s *ss)
 {
 	EXTRA_ASSERT(ss != NULL);
 	EXTRA_ASSERT(ss->vtable == &VTABLE);
+	_batch_stop(ss);
 	if (ss->zh) {
 		zookeeper_close(ss->zh);
 		ss->zh = NULL;
@@ -354,6 +666,9 @@ _clear(struct sqlx_sync_s *ss)
 	oio_str_clean (&ss->zk_prefix);
 	oio_str_clean (&ss->zk_url);
 	grid_single_rrd_destroy(ss->conn_attempts);
+	g_ptr_array_free(ss->batch_pending, TRUE);
+	g_cond_clear(&ss->batch_cond);
+	g_mutex_clear(&ss->batch_lock);
 	memset(ss, 0, sizeof(*ss));
 	g_free(ss);
 }
@@ -368,6 +683,17 @@ _acreate (struct sqlx_sync_s *ss, const char *path, const char *v,
 	if (oio_sync_failure_threshold_action >= oio_ext_rand_int_range(1,100))
 		return ZOPERATIONTIMEOUT;
 #endif
+	if (_batch_enabled(ss)) {
+		struct zk_batch_item_s *item = g_malloc0(sizeof(*item));
+		item->type = ZKOP_CREATE;
+		item->on.create = completion;
+		item->data = data;
+		item->flags = flags;
+		item->vlen = vlen;
+		item->value = (v && vlen > 0) ? g_memdup(v, vlen) : NULL;
+		_realpath(ss, path, item->path, sizeof(item->path));
+		return _batch_push(ss, item);
+	}
 	gchar p[PATH_MAXLEN];
 	int rc = zoo_acreate(ss->zh, _realpath(ss, path, p, sizeof(p)),
 			v, vlen, &ZOO_OPEN_ACL_UNSAFE,
@@ -385,6 +711,15 @@ _adelete (struct sqlx_sync_s *ss, const char *path, int version,
 	if (oio_sync_failure_threshold_action >= oio_ext_rand_int_range(1,100))
 		return ZOPERATIONTIMEOUT;
 #endif
+	if (_batch_enabled(ss)) {
+		struct zk_batch_item_s *item = g_malloc0(sizeof(*item));
+		item->type = ZKOP_DELETE;
+		item->on.delete = completion;
+		item->data = data;
+		item->version = version;
+		_realpath(ss, path, item->path, sizeof(item->path));
+		return _batch_push(ss, item);
+	}
 	gchar p[PATH_MAXLEN];
 	int rc = zoo_adelete(ss->zh, _realpath(ss, path, p, sizeof(p)),
 			version, completion, data);
@@ -453,6 +788,16 @@ _awget_siblings (struct sqlx_sync_s *ss, const char *path,
 	if (oio_sync_failure_threshold_action >= oio_ext_rand_int_range(1,100))
 		return ZOPERATIONTIMEOUT;
 #endif
+	/* A watched listing cannot be shared, each caller expects its
+	 * own watcher to be set. */
+	if (!watcher && _batch_enabled(ss)) {
+		struct zk_batch_item_s *item = g_malloc0(sizeof(*item));
+		item->type = ZKOP_LIST;
+		item->on.list = completion;
+		item->data = data;
+		_realdirname(ss, path, item->path, sizeof(item->path));
+		return _batch_push(ss, item);
+	}
 	gchar p[PATH_MAXLEN];
 	int rc = zoo_awget_children(ss->zh, _realdirname(ss, path, p, sizeof(p)),
 			watcher, watcherCtx, completion, data);
@@ -64,6 +64,7 @@ static void sqlx_service_specific_stop(void);
 
 // Periodic tasks & thread's workers
 static void _task_read_memory_usage(gpointer p);
+static void _task_export_stmt_cache(gpointer p);
 static void _task_probe_repository(gpointer p);
 static void _task_malloc_trim(gpointer p);
 static void _task_expire_bases(gpointer p);
@@ -371,8 +372,11 @@ _reconfigure_on_SIGHUP(void)
 static gboolean
 _init_configless_structures(struct sqlx_service_s *ss)
 {
+	g_mutex_init(&ss->lb_sync_lock);
 	if (!(ss->lb_world = oio_lb_local__create_world())
 			|| !(ss->lb = oio_lb__create())
+			|| !(ss->lb_sync = g_hash_table_new_full(g_str_hash, g_str_equal,
+					g_free, (GDestroyNotify)service_sync_destroy))
 			|| !(ss->server = network_server_init())
 			|| !(ss->dispatcher = transport_gridd_build_empty_dispatcher())
 			|| !(ss->clients_pool = gridd_client_pool_create())
@@ -642,6 +646,7 @@ _configure_tasks(struct sqlx_service_s *ss)
 	grid_task_queue_register(ss->gtq_admin, 1, _task_expire_resolver, NULL, ss);
 	grid_task_queue_register(ss->gtq_admin, 1, _task_malloc_trim, NULL, ss);
 	grid_task_queue_register(ss->gtq_admin, 1, _task_read_memory_usage, NULL, ss);
+	grid_task_queue_register(ss->gtq_admin, 1, _task_export_stmt_cache, NULL, ss);
 	grid_task_queue_register(ss->gtq_admin, 5, _task_probe_repository, NULL, ss);
 
 	return TRUE;
@@ -947,6 +952,12 @@ sqlx_service_specific_fini(void)
 		SRV.lb_world = NULL;
 	}
 
+	if (SRV.lb_sync) {
+		g_hash_table_destroy(SRV.lb_sync);
+		SRV.lb_sync = NULL;
+	}
+	g_mutex_clear(&SRV.lb_sync_lock);
+
 	if (SRV.nsinfo) {
 		namespace_info_free(SRV.nsinfo);
 		SRV.nsinfo = NULL;
@@ -1135,6 +1146,26 @@ _task_read_memory_usage(gpointer p)
 	}
 }
 
+static void
+_task_export_stmt_cache(gpointer p UNUSED)
+{
+	static GQuark gq_hits = 0, gq_misses = 0, gq_evictions = 0;
+	if (!gq_hits) {
+		gq_hits = g_quark_from_static_string("counter stmt_cache.hits");
+		gq_misses = g_quark_from_static_string("counter stmt_cache.misses");
+		gq_evictions =
+			g_quark_from_static_string("counter stmt_cache.evictions");
+	}
+
+	struct sqlx_stmt_cache_stats_s stats = {0};
+	sqlx_sqlite3_stmt_cache_stats(&stats);
+	oio_stats_set(
+			gq_hits, stats.hits,
+			gq_misses, stats.misses,
+			gq_evictions, stats.evictions,
+			0, 0);
+}
+
 static void
 _task_malloc_trim(gpointer p)
 {
@@ -1231,9 +1262,21 @@ _task_reload_peers(gpointer p)
 	g_slist_free_full(allsrv, (GDestroyNotify)service_info_clean);
 }
 
+static struct service_sync_s *
+_lb_sync_get(const char *srvtype)
+{
+	struct service_sync_s *sync = g_hash_table_lookup(SRV.lb_sync, srvtype);
+	if (!sync) {
+		sync = service_sync_create();
+		g_hash_table_insert(SRV.lb_sync, g_strdup(srvtype), sync);
+	}
+	return sync;
+}
+
 static void
 _reload_lb_service_types(struct oio_lb_world_s *lbw, struct oio_lb_s *lb,
-		gchar **srvtypes, GPtrArray *tabsrv, GPtrArray *taberr)
+		gchar **srvtypes, GPtrArray *tabchanged, GPtrArray *tabgone,
+		GPtrArray *taberr, gboolean everything)
 {
 	struct service_update_policies_s *pols = service_update_policies_create();
 	gchar *pols_cfg = oio_var_get_string(oio_ns_service_update_policy);
@@ -1248,8 +1291,17 @@ _reload_lb_service_types(struct oio_lb_world_s *lbw, struct oio_lb_s *lb,
 					oio_lb_pool__from_service_policy( lbw, srvtype, pols));
 		}
 
-		if (!taberr->pdata[i])
-			oio_lb_world__feed_service_info_list(lbw, tabsrv->pdata[i]);
+		if (taberr->pdata[i])
+			continue;
+		if (tabgone->pdata[i])
+			oio_lb_world__remove_service_info_list(lbw, tabgone->pdata[i]);
+		if (everything) {
+			GSList *all = service_sync_list(_lb_sync_get(srvtype));
+			oio_lb_world__feed_service_info_list(lbw, all);
+			g_slist_free(all);
+		} else if (tabchanged->pdata[i]) {
+			oio_lb_world__feed_service_info_list(lbw, tabchanged->pdata[i]);
+		}
 	}
 
 	service_update_policies_destroy(pols);
@@ -1263,6 +1315,12 @@ _free_list_of_services(gpointer p)
 	g_slist_free_full((GSList*)p, (GDestroyNotify)service_info_clean);
 }
 
+static void
+_free_list(gpointer p)
+{
+	g_slist_free((GSList*)p);
+}
+
 static void
 _free_error(gpointer p)
 {
@@ -1275,8 +1333,9 @@ static GError*
 _reload_lb_world(struct oio_lb_world_s *lbw, struct oio_lb_s *lb)
 {
 	gchar **srvtypes = NULL;
-	GPtrArray *tabsrv = NULL, *taberr = NULL;
+	GPtrArray *tabchanged = NULL, *tabgone = NULL, *taberr = NULL;
 	gboolean any_loading_error = FALSE;
+	gboolean everything = FALSE;
 
 	/* Load the list of service types */
 	if (SRV.srvtypes[0] && SRV.srvtypes[0] != '!') {
@@ -1315,18 +1374,32 @@ _reload_lb_world(struct oio_lb_world_s *lbw, struct oio_lb_s *lb)
 		return NULL;
 	}
 
-	/* Now preload all the service of these types */
-	tabsrv = g_ptr_array_new_full(8, _free_list_of_services);
+	/* The synchronization state is only used by one reload at a time */
+	g_mutex_lock(&SRV.lb_sync_lock);
+
+	/* Now preload the changes of the services of these types, since the
+	 * last reload */
+	tabchanged = g_ptr_array_new_full(8, _free_list);
+	tabgone = g_ptr_array_new_full(8, _free_list_of_services);
 	taberr = g_ptr_array_new_full(8, _free_error);
 	for (char **pst=srvtypes; *pst ;++pst) {
 		const char * srvtype = *pst;
-		GSList *srv = NULL;
-		GError *e = conscience_get_services(SRV.ns_name, srvtype, FALSE, &srv, 0);
+		struct service_sync_s *sync = _lb_sync_get(srvtype);
+		struct service_delta_s delta = {0};
+		GSList *changed = NULL, *gone = NULL;
+		GError *e = conscience_get_services_since(SRV.ns_name, srvtype, FALSE,
+				sync->epoch, sync->generation, &delta);
 		if (e) {
 			GRID_WARN("Failed to load the list of [%s] in NS=%s", srvtype, SRV.ns_name);
 			any_loading_error = TRUE;
+		} else {
+			if (delta.complete)
+				everything = TRUE;
+			service_sync_apply(sync, &delta, &changed, &gone);
 		}
-		g_ptr_array_add(tabsrv, srv);
+		service_delta_clean(&delta);
+		g_ptr_array_add(tabchanged, changed);
+		g_ptr_array_add(tabgone, gone);
 		g_ptr_array_add(taberr, e);
 	}
 
@@ -1334,22 +1407,29 @@ _reload_lb_world(struct oio_lb_world_s *lbw, struct oio_lb_s *lb)
 	 * encountered any error while loading the list of services, because
 	 * the world exposes a global generation number to manage expirations,
 	 * and because without service, we have no way (yet) to find *all* the
-	 * slots concerned by any service of a given type. */
+	 * slots concerned by any service of a given type. Without any complete
+	 * list, only the changes are applied and nothing is purged: the
+	 * services left untouched would not be spared. */
 	if (*srvtypes) {
-		if (!any_loading_error)
+		const gboolean purge = everything && !any_loading_error;
+		if (purge)
 			oio_lb_world__increment_generation(lbw);
 		oio_lb_world__reload_pools(lbw, lb, SRV.nsinfo);
-		_reload_lb_service_types(lbw, lb, srvtypes, tabsrv, taberr);
+		_reload_lb_service_types(lbw, lb, srvtypes, tabchanged, tabgone,
+				taberr, everything);
 		oio_lb_world__reload_storage_policies(lbw, lb, SRV.nsinfo);
-		if (!any_loading_error) {
+		if (purge) {
 			oio_lb_world__purge_old_generations(lbw);
 		} else {
 			oio_lb_world__rehash_all_slots(lbw);
 		}
 	}
 
+	g_mutex_unlock(&SRV.lb_sync_lock);
+
 	if (taberr) g_ptr_array_free(taberr, TRUE);
-	if (tabsrv) g_ptr_array_free(tabsrv, TRUE);
+	if (tabgone) g_ptr_array_free(tabgone, TRUE);
+	if (tabchanged) g_ptr_array_free(tabchanged, TRUE);
 	g_strfreev(srvtypes);
 	return NULL;
 }
@@ -1388,6 +1468,9 @@ _dispatch_RELOAD (struct gridd_reply_ctx_s *reply, gpointer pss, gpointer i)
 	g_assert (ss != NULL);
 
 	oio_lb_world__flush(ss->lb_world);
+	g_mutex_lock(&ss->lb_sync_lock);
+	g_hash_table_remove_all(ss->lb_sync);
+	g_mutex_unlock(&ss->lb_sync_lock);
 
 	GError *err = _reload_lb_world(ss->lb_world, ss->lb);
 	if (err)
@@ -97,6 +97,11 @@ struct sqlx_service_s
 	struct oio_lb_s *lb;
 	struct oio_lb_world_s *lb_world;
 
+	/* <gchar*,struct service_sync_s*>, the services of each type as last
+	 * synchronized with the conscience, to only ask the changes. */
+	GHashTable *lb_sync;
+	GMutex lb_sync_lock;
+
 	/* The tasks under this queue always follow a reload of the nsinfo field,
 	   and can safely play with it. This is the place for LB reloading,
 	   reconfiguration, etc. */
@@ -629,6 +629,46 @@ class TestConscienceFunctional(BaseTestCase):
             expected_status=503,
         )
 
+    def _list_echo_since(self, cs, since, epoch=None):
+        params = {"type": "echo", "since": since, "cs": cs}
+        if epoch:
+            params["epoch"] = epoch
+        resp = self.request("GET", self._url_cs("list"), params=params)
+        self.assertEqual(200, resp.status)
+        return (
+            self.json_loads(resp.data),
+            resp.headers.get("x-oio-cs-epoch"),
+            int(resp.headers["x-oio-cs-generation"]),
+            resp.headers.get("x-oio-cs-delta"),
+        )
+
+    def test_list_services_since_identical_push(self):
+        cs = random.choice(self.conf["services"]["conscience"])["addr"]
+        srv = self._srv("echo", ip="127.0.0.3")
+        self._register_srv(srv, cs=cs)
+        services, epoch, generation, _ = self._list_echo_since(cs, 0)
+        self.assertIn(srv["addr"], [s["addr"] for s in services])
+
+        # Nothing the load balancers read has changed
+        self._register_srv(srv, cs=cs, deregister=False)
+        services, epoch2, generation2, delta = self._list_echo_since(
+            cs, generation, epoch
+        )
+        self.assertEqual(epoch, epoch2)
+        self.assertEqual("1", delta)
+        self.assertListEqual([], services)
+        self.assertEqual(generation, generation2)
+
+        # A change of the location is in the delta
+        srv["tags"]["tag.loc"] = "test.delta.127-0-0-3"
+        self._register_srv(srv, cs=cs, deregister=False)
+        services, _, generation3, delta = self._list_echo_since(
+            cs, generation, epoch
+        )
+        self.assertEqual("1", delta)
+        self.assertListEqual([srv["addr"]], [s["addr"] for s in services])
+        self.assertGreater(generation3, generation)
+
     def _service_types(self):
         params = {"what": "types"}
         resp = self.request("GET", self._url_cs("info"), params=params)
@@ -0,0 +1,238 @@
+/*
+OpenIO SDS unit tests
+Copyright (C) 2024 OVH SAS
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 3.0 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+*/
+
+#include <math.h>
+#include <string.h>
+
+#include <metautils/lib/metautils.h>
+#include <cluster/module/expr.h>
+
+#define ASSERT_EQFLOAT(V0,V1) do { \
+	gdouble _v0 = (V0), _v1 = (V1); \
+	g_assert_cmpfloat(_v0, <=, _v1); \
+	g_assert_cmpfloat(_v0, >=, _v1); \
+} while (0)
+
+/* The score expressions of the sample configurations */
+static const char *expressions[] = {
+	"((num stat.cpu)>0) * ((num stat.io)>0) * ((num stat.space)>1) * root(3,((num stat.cpu)*(num stat.space)*(num stat.io)))",
+	"((num stat.space)>1) * root(3,((num stat.cpu)*(num stat.space)*(num stat.io)))",
+	"((num stat.space)>1) * root(3,((1 + (num stat.cpu))*(num stat.space)*(1 + (num stat.io))))",
+	"(num tag.up) * root(4, (pow(2, (clamp((((num stat.space) - 1) * 1.010101), 0, 100))) * clamp((((num stat.cpu) - 5) * 6.666667), 1, 100) * clamp((((num stat.io) - 5) * 1.333333), 1, 100)))",
+	"(num tag.up) * root(2, (clamp((((num stat.cpu) - 5) * 6.666667), 0, 100) * clamp((((num stat.io) - 5) * 1.333333), 0, 100)))",
+	"root(4, (pow(2, (clamp((((num stat.space) - 20) * 1.25), 0, 100))) * clamp((((num stat.cpu) - 5) * 6.666667), 1, 100) * clamp((((num stat.io) - 5) * 1.333333), 1, 100))) * (num stat.unknown_stat:\"1\")",
+	"root(2, (clamp((((num stat.cpu) - 5) * 6.666667), 0, 100) * clamp((((num stat.io) - 5) * 1.333333), 0, 100))) * (num stat.unknown_stat:\"1\")",
+	"root(3, (num stat.cpu) * (num stat.space) * (100 - root(3, (num stat.jobs_ready))))",
+	"(1 + (num stat.cpu))",
+	"((num stat.cpu)>5) * (num stat.cpu)",
+	/* division by zero */
+	"(num stat.cpu) / (num stat.io)",
+	"1 + ((num stat.cpu) / 0)",
+	"(num stat.space) / ((num stat.io) - (num stat.io))",
+	/* comparisons */
+	"((num stat.cpu) <N> (num stat.io)) + ((num stat.cpu) < 50)",
+	"((num stat.cpu) == 50) + ((num stat.cpu) != 50) + ((num stat.io) >= 40)",
+	/* missing fields, with or without a fallback */
+	"(num stat.missing)",
+	"(num stat.missing:\"5\") + 1",
+	"(num stat.missing:\"abc\") + 1",
+	"(num stat.cpu:\"7\") * 2",
+	/* unknown bases, with or without a fallback */
+	"(num nowhere.cpu)",
+	"1 + (num nowhere.cpu:\"5\")",
+	"(num nowhere.cpu:\"5\")",
+	/* constants */
+	"(num \"12.5\") + (num 3)",
+	"pow(0, (num stat.cpu))",
+	"root(2, 0)",
+};
+
+/* The tags of the services the expressions are evaluated against, as
+ * "name", "value" pairs. */
+static const char *services[][16] = {
+	{"stat.cpu", "50", "stat.io", "40", "stat.space", "90",
+		"stat.jobs_ready", "8", "tag.up", "1", NULL},
+	{"stat.cpu", "0", "stat.io", "0", "stat.space", "0",
+		"stat.jobs_ready", "0", "tag.up", "0", NULL},
+	{"stat.cpu", "3.5", "stat.io", "2", "stat.space", "1",
+		"stat.jobs_ready", "1000000", "tag.up", "1", NULL},
+	{"stat.cpu", "100", "stat.io", "100", "stat.space", "100",
+		"stat.unknown_stat", "0.5", "tag.up", "1", NULL},
+	{"stat.cpu", "-10", "stat.io", "25", "stat.space", "-3", NULL},
+	{"stat.cpu", "abc", "stat.io", "40", "stat.space", "90",
+		"tag.up", "1", NULL},
+	{"stat.cpu", "50", "stat.space", "90", NULL},
+	{NULL},
+};
+
+static const char * const bases[] = {"stat", "tag", NULL};
+
+static const char **current = NULL;
+
+static const char *
+_lookup(const char *name)
+{
+	for (const char **p = current; *p; p += 2) {
+		if (!strcmp(*p, name))
+			return *(p+1);
+	}
+	return NULL;
+}
+
+static char *
+_get_field(const char *base, const char *field)
+{
+	gchar *name = g_strconcat(base, ".", field, NULL);
+	const char *value = _lookup(name);
+	g_free(name);
+	return value ? g_strdup(value) : NULL;
+}
+
+static char * _get_stat(const char *f) { return _get_field("stat", f); }
+
+static char * _get_tag(const char *f) { return _get_field("tag", f); }
+
+static accessor_f *
+_get_acc(const char *b)
+{
+	if (!strcmp(b, "stat"))
+		return _get_stat;
+	if (!strcmp(b, "tag"))
+		return _get_tag;
+	return NULL;
+}
+
+/* As conscience_srv_load_env() does with the tags of a service */
+static void
+_load_env(const struct expr_program_s *prog, struct expr_env_s *env)
+{
+	env->present = env->invalid = 0;
+	for (guint i = 0; i < expr_program_count_slots(prog); i++) {
+		const char *str = _lookup(expr_program_get_slot(prog, i));
+		if (!str)
+			continue;
+		env->present |= 1u << i;
+		gchar *end = NULL;
+		env->values[i] = strtod(str, &end);
+		if (end == str)
+			env->invalid |= 1u << i;
+	}
+}
+
+static void
+_check_same(const char *str)
+{
+	struct expr_s *pE = NULL;
+	g_assert_cmpint(expr_parse(str, &pE), ==, 0);
+	g_assert_nonnull(pE);
+	struct expr_program_s *prog = expr_compile(pE, bases);
+	g_assert_nonnull(prog);
+
+	for (guint i = 0; i < G_N_ELEMENTS(services); i++) {
+		current = services[i];
+
+		double d0 = 0.0, d1 = 0.0;
+		struct expr_env_s env;
+		_load_env(prog, &env);
+		int rc0 = expr_evaluate(&d0, pE, _get_acc);
+		int rc1 = expr_program_evaluate(&d1, prog, &env);
+		GRID_DEBUG("[%s] service %u: %d/%f %d/%f", str, i, rc0, d0, rc1, d1);
+		g_assert_cmpint(rc0, ==, rc1);
+		if (isnan(d0))
+			g_assert_true(isnan(d1));
+		else
+			ASSERT_EQFLOAT(d0, d1);
+	}
+
+	expr_program_clean(prog);
+	expr_clean(pE);
+}
+
+static void
+test_same_results(void)
+{
+	for (guint i = 0; i < G_N_ELEMENTS(expressions); i++)
+		_check_same(expressions[i]);
+}
+
+static void
+test_results(void)
+{
+	void _check(const char *str, int rc, double expected) {
+		struct expr_s *pE = NULL;
+		g_assert_cmpint(expr_parse(str, &pE), ==, 0);
+		struct expr_program_s *prog = expr_compile(pE, bases);
+		g_assert_nonnull(prog);
+		struct expr_env_s env;
+		_load_env(prog, &env);
+		double d = 0.0;
+		g_assert_cmpint(expr_program_evaluate(&d, prog, &env), ==, rc);
+		if (rc == EXPR_EVAL_DEF)
+			ASSERT_EQFLOAT(d, expected);
+		expr_program_clean(prog);
+		expr_clean(pE);
+	}
+
+	current = services[0];
+	_check("1 + ((num stat.cpu) / 0)", EXPR_EVAL_DEF, 1.0);
+	_check("(num stat.cpu) / 0", EXPR_EVAL_DEF, 0.0);
+	_check("(num stat.missing)", EXPR_EVAL_UNDEF, 0.0);
+	_check("(num stat.missing:\"5\") + 1", EXPR_EVAL_DEF, 6.0);
+	_check("(num stat.missing:\"abc\") + 1", EXPR_EVAL_UNDEF, 0.0);
+	_check("(num nowhere.cpu)", EXPR_EVAL_UNDEF, 0.0);
+	_check("1 + (num nowhere.cpu:\"5\")", EXPR_EVAL_DEF, 1.0);
+	_check("(num tag.up) * (num stat.cpu)", EXPR_EVAL_DEF, 50.0);
+
+	current = services[5];
+	_check("(num stat.cpu) + 1", EXPR_EVAL_UNDEF, 0.0);
+}
+
+static void
+test_errors(void)
+{
+	struct expr_env_s env = {};
+	double d0 = 0.0, d1 = 0.0;
+	current = services[0];
+	g_assert_cmpint(expr_evaluate(&d0, NULL, _get_acc), ==, EXPR_EVAL_ERROR);
+	g_assert_cmpint(expr_program_evaluate(&d1, NULL, &env), ==,
+			EXPR_EVAL_ERROR);
+
+	/* The expressions on strings are left to the interpreter */
+	static const char *strings[] = {
+		"stat.cpu",
+		"\"abc\"",
+		"(num stat.cpu) + stat.io",
+		"(num \"abc\") + 1",
+	};
+	for (guint i = 0; i < G_N_ELEMENTS(strings); i++) {
+		struct expr_s *pE = NULL;
+		g_assert_cmpint(expr_parse(strings[i], &pE), ==, 0);
+		g_assert_null(expr_compile(pE, bases));
+		expr_clean(pE);
+	}
+}
+
+int
+main(int argc, char **argv)
+{
+	HC_TEST_INIT(argc,argv);
+	g_test_add_func("/cluster/expr/same_results", test_same_results);
+	g_test_add_func("/cluster/expr/results", test_results);
+	g_test_add_func("/cluster/expr/errors", test_errors);
+	return g_test_run();
+}
@@ -18,11 +18,14 @@ License along with this library.
 */
 
 #include <glib.h>
+#include <glib/gstdio.h>
 #include <zmq.h>
 
 #include <core/oio_core.h>
+#include <core/internals.h>
 #include <events/events_variables.h>
 #include <events/oio_events_queue.h>
+#include <events/oio_events_spool.h>
 
 static void
 test_queue_stalled (void)
@@ -63,11 +66,190 @@ test_queue_init (void)
 	g_slist_free_full (l, (GDestroyNotify)oio_events_queue__destroy);
 }
 
+static guint
+_spool_count_segments(const gchar *dir)
+{
+	guint count = 0;
+	GDir *gd = g_dir_open(dir, 0, NULL);
+	for (const gchar *name; (name = g_dir_read_name(gd));)
+		count += g_str_has_suffix(name, ".seg");
+	g_dir_close(gd);
+	return count;
+}
+
+static void
+_spool_remove(gchar *dir)
+{
+	GDir *gd = g_dir_open(dir, 0, NULL);
+	for (const gchar *name; (name = g_dir_read_name(gd));) {
+		gchar *path = g_build_filename(dir, name, NULL);
+		g_unlink(path);
+		g_free(path);
+	}
+	g_dir_close(gd);
+	g_rmdir(dir);
+	g_free(dir);
+}
+
+static guint64
+_spool_check_next(struct oio_events_spool_s *sp, guint i)
+{
+	guint64 seq = 0;
+	gchar *key = NULL, *msg = NULL;
+	gchar expected[64];
+	g_assert_true(oio_events_spool_read(sp, &seq, &key, &msg));
+	g_assert_cmpuint(seq, !=, 0);
+	g_snprintf(expected, sizeof(expected), "k%u", i);
+	g_assert_cmpstr(key, ==, expected);
+	g_snprintf(expected, sizeof(expected), "{\"i\":%u}", i);
+	g_assert_cmpstr(msg, ==, expected);
+	g_free(key);
+	g_free(msg);
+	return seq;
+}
+
+static void
+_spool_append(struct oio_events_spool_s *sp, guint i)
+{
+	gchar key[64], msg[64];
+	g_snprintf(key, sizeof(key), "k%u", i);
+	g_snprintf(msg, sizeof(msg), "{\"i\":%u}", i);
+	g_assert_no_error(oio_events_spool_append(sp, key, msg));
+}
+
+static void
+test_spool_replay (void)
+{
+	gchar *dir = g_dir_make_tmp("oio-spool-XXXXXX", NULL);
+	struct oio_events_spool_s *sp = NULL;
+	g_assert_no_error(oio_events_spool_open(dir, &sp));
+	for (guint i=0; i<10 ;++i)
+		_spool_append(sp, i);
+
+	/* The directory belongs to one spool only */
+	struct oio_events_spool_s *sp2 = NULL;
+	GError *err = oio_events_spool_open(dir, &sp2);
+	g_assert_error(err, GQ(), CODE_UNAVAILABLE);
+	g_assert_null(sp2);
+	g_clear_error(&err);
+
+	for (guint i=0; i<4 ;++i)
+		oio_events_spool_ack(sp, _spool_check_next(sp, i));
+	/* Read but not acknowledged: replayed */
+	_spool_check_next(sp, 4);
+
+	guint64 bytes = 0;
+	oio_events_spool_get_backlog(sp, &bytes, NULL);
+	g_assert_cmpuint(bytes, >, 0);
+	oio_events_spool_close(sp);
+
+	/* Something torn at the end, as after a crash */
+	gchar *path = g_build_filename(dir, "0000000000000000.seg", NULL);
+	FILE *f = fopen(path, "a");
+	g_assert_nonnull(f);
+	fwrite("\x40\x00\x00\x00garbage", 1, 11, f);
+	fclose(f);
+	g_free(path);
+
+	g_assert_no_error(oio_events_spool_open(dir, &sp));
+	_spool_append(sp, 10);
+	for (guint i=4; i<=10 ;++i)
+		oio_events_spool_ack(sp, _spool_check_next(sp, i));
+	guint64 seq = 0;
+	gchar *msg = NULL;
+	g_assert_false(oio_events_spool_read(sp, &seq, NULL, &msg));
+	oio_events_spool_get_backlog(sp, &bytes, NULL);
+	g_assert_cmpuint(bytes, ==, 0);
+	oio_events_spool_close(sp);
+
+	_spool_remove(dir);
+}
+
+static void
+test_spool_segments (void)
+{
+	const gint64 segment_size = oio_events_spool_segment_size;
+	oio_events_spool_segment_size = 1024;
+
+	gchar *dir = g_dir_make_tmp("oio-spool-XXXXXX", NULL);
+	struct oio_events_spool_s *sp = NULL;
+	g_assert_no_error(oio_events_spool_open(dir, &sp));
+	for (guint i=0; i<1000 ;++i)
+		_spool_append(sp, i);
+	g_assert_cmpuint(_spool_count_segments(dir), >, 1);
+
+	/* The drained segments are deleted */
+	for (guint i=0; i<1000 ;++i)
+		oio_events_spool_ack(sp, _spool_check_next(sp, i));
+	guint64 seq = 0;
+	gchar *msg = NULL;
+	g_assert_false(oio_events_spool_read(sp, &seq, NULL, &msg));
+	g_assert_cmpuint(_spool_count_segments(dir), ==, 1);
+	oio_events_spool_close(sp);
+
+	oio_events_spool_segment_size = segment_size;
+	_spool_remove(dir);
+}
+
+static void
+test_spool_inflight (void)
+{
+	const gint64 segment_size = oio_events_spool_segment_size;
+	oio_events_spool_segment_size = 1024;
+
+	gchar *dir = g_dir_make_tmp("oio-spool-XXXXXX", NULL);
+	struct oio_events_spool_s *sp = NULL;
+	g_assert_no_error(oio_events_spool_open(dir, &sp));
+	for (guint i=0; i<100 ;++i)
+		_spool_append(sp, i);
+
+	/* Several events in flight, acknowledged out of order */
+	guint64 seqs[100];
+	for (guint i=0; i<100 ;++i)
+		seqs[i] = _spool_check_next(sp, i);
+	g_assert_cmpuint(oio_events_spool_inflight(sp), ==, 100);
+	g_assert_cmpuint(_spool_count_segments(dir), >, 1);
+	for (guint i=99; i>=10 ;--i)
+		oio_events_spool_ack(sp, seqs[i]);
+	/* Kept for the oldest one */
+	g_assert_cmpuint(oio_events_spool_inflight(sp), ==, 10);
+	g_assert_cmpuint(_spool_count_segments(dir), >, 1);
+	for (guint i=1; i<10 ;++i)
+		oio_events_spool_ack(sp, seqs[i]);
+	guint64 bytes = 0;
+	oio_events_spool_get_backlog(sp, &bytes, NULL);
+	g_assert_cmpuint(bytes, >, 0);
+	oio_events_spool_close(sp);
+
+	/* Everything is replayed from the oldest one not acknowledged */
+	g_assert_no_error(oio_events_spool_open(dir, &sp));
+	guint64 seq = _spool_check_next(sp, 0);
+	/* Read again after a rewind, the former reads are forgotten */
+	_spool_check_next(sp, 1);
+	oio_events_spool_rewind(sp);
+	g_assert_cmpuint(oio_events_spool_inflight(sp), ==, 0);
+	oio_events_spool_ack(sp, seq);
+	for (guint i=0; i<100 ;++i)
+		oio_events_spool_ack(sp, _spool_check_next(sp, i));
+	gchar *msg = NULL;
+	g_assert_false(oio_events_spool_read(sp, &seq, NULL, &msg));
+	oio_events_spool_get_backlog(sp, &bytes, NULL);
+	g_assert_cmpuint(bytes, ==, 0);
+	g_assert_cmpuint(_spool_count_segments(dir), ==, 1);
+	oio_events_spool_close(sp);
+
+	oio_events_spool_segment_size = segment_size;
+	_spool_remove(dir);
+}
+
 int
 main(int argc, char **argv)
 {
 	HC_TEST_INIT(argc,argv);
 	g_test_add_func("/events/queue/init", test_queue_init);
 	g_test_add_func("/events/queue/clogged", test_queue_stalled);
+	g_test_add_func("/events/spool/replay", test_spool_replay);
+	g_test_add_func("/events/spool/segments", test_spool_segments);
+	g_test_add_func("/events/spool/inflight", test_spool_inflight);
 	return g_test_run();
 }
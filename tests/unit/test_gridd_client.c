@@ -22,6 +22,7 @@ License along with this library.
 #include <errno.h>
 #include <string.h>
 #include <stdio.h>
+#include <sys/socket.h>
 #include <arpa/inet.h>
 #include <netinet/in.h>
 
@@ -261,6 +262,203 @@ test_down_peer(void)
 	metautils_pclose(&fd);
 }
 
+static gboolean
+_read_exactly(int fd, guint8 *buf, gsize len)
+{
+	while (len > 0) {
+		ssize_t r = read(fd, buf, len);
+		if (r <= 0)
+			return FALSE;
+		buf += r;
+		len -= r;
+	}
+	return TRUE;
+}
+
+static gboolean
+_read_request(int fd)
+{
+	guint8 hdr[4];
+	if (!_read_exactly(fd, hdr, 4))
+		return FALSE;
+	guint32 len = g_ntohl(*((guint32*)hdr));
+	guint8 *body = g_malloc(len);
+	gboolean ok = _read_exactly(fd, body, len);
+	g_free(body);
+	return ok;
+}
+
+static gboolean
+_write_final_ok(int fd)
+{
+	MESSAGE reply = metautils_message_create_named(NAME_MSGNAME_METAREPLY, 0);
+	metautils_message_add_field_strint(reply, NAME_MSGKEY_STATUS, CODE_FINAL_OK);
+	metautils_message_add_field_str(reply, NAME_MSGKEY_MESSAGE, "OK");
+	GByteArray *encoded = message_marshall_gba_and_clean(reply);
+	ssize_t w = write(fd, encoded->data, encoded->len);
+	g_byte_array_unref(encoded);
+	return w >= 0;
+}
+
+/* Serves the connections one after the other, answering a final "200"
+ * to each request. Returns the number of connections accepted. */
+static gpointer
+_serve_requests(gpointer p)
+{
+	int fd_listen = GPOINTER_TO_INT(p);
+	guint accepted = 0;
+	int fd;
+
+	while ((fd = accept(fd_listen, NULL, NULL)) >= 0) {
+		accepted ++;
+		while (_read_request(fd) && _write_final_ok(fd)) {}
+		metautils_pclose(&fd);
+	}
+	return GUINT_TO_POINTER(accepted);
+}
+
+static void
+test_cnx_pool(void)
+{
+	gchar url[STRLEN_ADDRINFO] = "127.0.0.1:0";
+	struct sockaddr_storage ss = {};
+	socklen_t ss_len = sizeof(ss);
+	gsize sz = sizeof(ss);
+	GError *err = NULL;
+	int rc;
+
+	int fd = sock_build_for_url(url, &err, &ss, &sz);
+	g_assert_no_error(err);
+	g_assert_cmpint(fd, >=, 0);
+	rc = bind(fd, (struct sockaddr*)&ss, sz);
+	g_assert_cmpint(rc, ==, 0);
+	rc = listen(fd, 8);
+	g_assert_cmpint(rc, ==, 0);
+	rc = getsockname(fd, (struct sockaddr*)&ss, &ss_len);
+	g_assert_cmpint(rc, ==, 0);
+	rc = grid_sockaddr_to_string((struct sockaddr*)&ss, url, sizeof(url));
+	g_assert_cmpint(rc, >, 0);
+
+	GThread *th = g_thread_new("server", _serve_requests, GINT_TO_POINTER(fd));
+
+	oio_var_value_one("client.down_cache.avoid", "false");
+	oio_var_value_one("client.cnx_pool.enabled", "true");
+	gridd_client_cnx_pool_purge(TRUE);
+
+	struct gridd_client_cnx_pool_stats_s before = {0}, after = {0};
+	gridd_client_cnx_pool_stats(&before);
+	for (int i = 0; i < 4; i++) {
+		GByteArray *req = message_marshall_gba_and_clean(
+				metautils_message_create_named("REQ_PING", 0));
+		err = gridd_client_exec(url, 5.0, req);
+		g_assert_no_error(err);
+		g_byte_array_unref(req);
+	}
+	gridd_client_cnx_pool_stats(&after);
+	g_assert_cmpuint(after.hits - before.hits, ==, 3);
+	g_assert_cmpuint(after.idle, ==, 1);
+
+	/* Closing the pooled connection lets the server accept the next one */
+	gridd_client_cnx_pool_purge(TRUE);
+	gridd_client_cnx_pool_stats(&after);
+	g_assert_cmpuint(after.idle, ==, 0);
+
+	shutdown(fd, SHUT_RDWR);
+	guint accepted = GPOINTER_TO_UINT(g_thread_join(th));
+	g_assert_cmpuint(accepted, ==, 1);
+	metautils_pclose(&fd);
+}
+
+/* Answers the first request of each connection, then reads the second one
+ * and closes the connection without replying, as a peer would do if it
+ * executed the request and died. Returns the number of requests read. */
+static gpointer
+_serve_then_drop(gpointer p)
+{
+	int fd_listen = GPOINTER_TO_INT(p);
+	guint requests = 0;
+	int fd;
+
+	while ((fd = accept(fd_listen, NULL, NULL)) >= 0) {
+		if (_read_request(fd)) {
+			requests ++;
+			if (_write_final_ok(fd) && _read_request(fd))
+				requests ++;
+		}
+		metautils_pclose(&fd);
+	}
+	return GUINT_TO_POINTER(requests);
+}
+
+static GError *
+_exec_ping(const char *url, gboolean idempotent)
+{
+	GByteArray *req = message_marshall_gba_and_clean(
+			metautils_message_create_named("REQ_PING", 0));
+	struct gridd_client_s *client = gridd_client_create_empty();
+	GError *err = gridd_client_connect_url(client, url);
+	g_assert_no_error(err);
+	err = gridd_client_request(client, req, NULL, NULL);
+	g_assert_no_error(err);
+	gridd_client_set_idempotent(client, idempotent);
+	gridd_client_set_timeout(client, 5.0);
+	gridd_client_start(client);
+	if (!(err = gridd_client_loop(client)))
+		err = gridd_client_error(client);
+	gridd_client_free(client);
+	g_byte_array_unref(req);
+	return err;
+}
+
+static void
+test_cnx_pool_no_resend(void)
+{
+	gchar url[STRLEN_ADDRINFO] = "127.0.0.1:0";
+	struct sockaddr_storage ss = {};
+	socklen_t ss_len = sizeof(ss);
+	gsize sz = sizeof(ss);
+	GError *err = NULL;
+	int rc;
+
+	int fd = sock_build_for_url(url, &err, &ss, &sz);
+	g_assert_no_error(err);
+	g_assert_cmpint(fd, >=, 0);
+	rc = bind(fd, (struct sockaddr*)&ss, sz);
+	g_assert_cmpint(rc, ==, 0);
+	rc = listen(fd, 8);
+	g_assert_cmpint(rc, ==, 0);
+	rc = getsockname(fd, (struct sockaddr*)&ss, &ss_len);
+	g_assert_cmpint(rc, ==, 0);
+	rc = grid_sockaddr_to_string((struct sockaddr*)&ss, url, sizeof(url));
+	g_assert_cmpint(rc, >, 0);
+
+	GThread *th = g_thread_new("server", _serve_then_drop, GINT_TO_POINTER(fd));
+
+	oio_var_value_one("client.down_cache.avoid", "false");
+	oio_var_value_one("client.cnx_pool.enabled", "true");
+	gridd_client_cnx_pool_purge(TRUE);
+
+	/* The pooled connection breaks once the request has been written: the
+	 * peer may have executed it, it is not sent again. */
+	err = _exec_ping(url, FALSE);
+	g_assert_no_error(err);
+	err = _exec_ping(url, FALSE);
+	g_assert_nonnull(err);
+	g_clear_error(&err);
+
+	/* ... unless the request has been declared idempotent */
+	err = _exec_ping(url, FALSE);
+	g_assert_no_error(err);
+	err = _exec_ping(url, TRUE);
+	g_assert_no_error(err);
+
+	gridd_client_cnx_pool_purge(TRUE);
+	shutdown(fd, SHUT_RDWR);
+	guint requests = GPOINTER_TO_UINT(g_thread_join(th));
+	g_assert_cmpuint(requests, ==, 5);
+	metautils_pclose(&fd);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -275,6 +473,10 @@ main(int argc, char **argv)
 			test_failed_start_on_ignored_connect_error);
 	g_test_add_func("/metautils/gridd_client/ignored_connect_loop",
 			test_loop_on_ignored_start_error);
+	g_test_add_func("/metautils/gridd_client/cnx_pool",
+			test_cnx_pool);
+	g_test_add_func("/metautils/gridd_client/cnx_pool_no_resend",
+			test_cnx_pool_no_resend);
 	return g_test_run();
 }
 
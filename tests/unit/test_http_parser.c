@@ -0,0 +1,294 @@
+/*
+OpenIO SDS unit tests
+Copyright (C) 2024 OVH SAS
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 3.0 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+*/
+
+#include <string.h>
+
+#include <metautils/lib/metautils.h>
+#include <proxy/http_parser.h>
+
+/* Requests as sent by the python SDK and the S3 gateway to the proxy */
+static const gchar *captured[] = {
+	"GET /v3.0/OPENIO/conscience/list?type=rawx&full=1 HTTP/1.1\r\n"
+	"Host: 127.0.0.1:6000\r\n"
+	"Accept-Encoding: identity\r\n"
+	"User-Agent: oio-sds/python\r\n"
+	"X-oio-req-id: 5F2C1A7B9E0D4C3B8A6F1E2D3C4B5A69\r\n"
+	"Connection: keep-alive\r\n"
+	"\r\n",
+
+	"POST /v3.0/OPENIO/content/prepare2?acct=ACCT&ref=JFS&path=obj HTTP/1.1\r\n"
+	"Host: 127.0.0.1:6000\r\n"
+	"Accept-Encoding: identity\r\n"
+	"Content-Length: 39\r\n"
+	"Content-Type: application/json\r\n"
+	"User-Agent: oio-sds/python\r\n"
+	"X-oio-req-id: 0A1B2C3D4E5F60718293A4B5C6D7E8F9\r\n"
+	"X-oio-action-mode: autocreate\r\n"
+	"Connection: keep-alive\r\n"
+	"\r\n"
+	"{\"size\":1048576,\"policy\":\"THREECOPIES\"}",
+
+	"POST /v3.0/OPENIO/container/list?acct=ACCT&ref=JFS&max=1000&prefix=a%2F"
+	" HTTP/1.1\r\n"
+	"Host: 127.0.0.1:6000\r\n"
+	"Transfer-Encoding: chunked\r\n"
+	"X-oio-req-id: 11112222333344445555666677778888\r\n"
+	"\r\n"
+	"4\r\nWiki\r\n5;ext=1\r\npedia\r\n0\r\nX-Trailer: yes\r\n\r\n",
+};
+
+struct parsed_s
+{
+	gchar *cmd, *selector, *version;
+	GTree *headers;
+	GString *body;
+};
+
+static struct parsed_s parsed = {};
+
+static void
+_command(const gchar *c, gsize cl, const gchar *s, gsize sl,
+		const gchar *v, gsize vl)
+{
+	parsed.cmd = g_strndup(c, cl);
+	parsed.selector = g_strndup(s, sl);
+	parsed.version = g_strndup(v, vl);
+}
+
+static void
+_header(const gchar *k, gsize kl, const gchar *v, gsize vl)
+{
+	g_tree_replace(parsed.headers, g_ascii_strdown(k, kl), g_strndup(v, vl));
+}
+
+static void
+_body(const guint8 *data, gsize len)
+{
+	g_string_append_len(parsed.body, (const gchar*)data, len);
+}
+
+static void
+_parsed_reset(void)
+{
+	oio_str_clean(&parsed.cmd);
+	oio_str_clean(&parsed.selector);
+	oio_str_clean(&parsed.version);
+	if (parsed.headers)
+		g_tree_destroy(parsed.headers);
+	parsed.headers = g_tree_new_full(metautils_strcmp3, NULL, g_free, g_free);
+	if (!parsed.body)
+		parsed.body = g_string_new("");
+	g_string_set_size(parsed.body, 0);
+}
+
+static struct http_parser_s *
+_parser(void)
+{
+	struct http_parser_s *parser = http_parser_create();
+	parser->command_provider = _command;
+	parser->header_provider = _header;
+	parser->body_provider = _body;
+	_parsed_reset();
+	return parser;
+}
+
+static void
+test_pipelined(void)
+{
+	GString *all = g_string_new("");
+	for (guint i = 0; i < G_N_ELEMENTS(captured); i++)
+		g_string_append(all, captured[i]);
+
+	struct http_parser_s *parser = _parser();
+	const guint8 *data = (guint8*) all->str;
+	gsize remaining = all->len;
+
+	for (guint i = 0; i < G_N_ELEMENTS(captured); i++) {
+		gsize consumed = 0;
+		enum http_parser_rc_e rc =
+			http_parser_feed(parser, data, remaining, &consumed);
+		g_assert_cmpint(rc, ==, HPRC_SUCCESS);
+		g_assert_cmpuint(consumed, ==, strlen(captured[i]));
+		g_assert_nonnull(g_tree_lookup(parsed.headers, "x-oio-req-id"));
+		data += consumed;
+		remaining -= consumed;
+
+		switch (i) {
+			case 0:
+				g_assert_cmpstr(parsed.cmd, ==, "GET");
+				g_assert_cmpstr(parsed.version, ==, "HTTP/1.1");
+				g_assert_cmpuint(parsed.body->len, ==, 0);
+				break;
+			case 1:
+				g_assert_cmpstr(parsed.cmd, ==, "POST");
+				g_assert_cmpstr(g_tree_lookup(parsed.headers, "content-type"),
+						==, "application/json");
+				g_assert_cmpuint(parsed.body->len, ==, 39);
+				break;
+			case 2:
+				g_assert_cmpstr(parsed.body->str, ==, "Wikipedia");
+				break;
+		}
+		http_parser_reset(parser);
+		_parsed_reset();
+	}
+	g_assert_cmpuint(remaining, ==, 0);
+
+	http_parser_destroy(parser);
+	g_string_free(all, TRUE);
+}
+
+/* Every request is given one byte at a time, the result must not change */
+static void
+test_fragmented(void)
+{
+	struct http_parser_s *parser = _parser();
+	for (guint i = 0; i < G_N_ELEMENTS(captured); i++) {
+		const gsize len = strlen(captured[i]);
+		enum http_parser_rc_e rc = HPRC_MORE;
+		for (gsize off = 0; off < len; off++) {
+			gsize consumed = 0;
+			g_assert_cmpint(rc, ==, HPRC_MORE);
+			rc = http_parser_feed(parser,
+					(const guint8*) captured[i] + off, 1, &consumed);
+			g_assert_cmpuint(consumed, ==, 1);
+		}
+		g_assert_cmpint(rc, ==, HPRC_SUCCESS);
+		g_assert_cmpstr(g_tree_lookup(parsed.headers, "host"),
+				==, "127.0.0.1:6000");
+		if (i == 2)
+			g_assert_cmpstr(parsed.body->str, ==, "Wikipedia");
+		http_parser_reset(parser);
+		_parsed_reset();
+	}
+	http_parser_destroy(parser);
+}
+
+static void
+test_errors(void)
+{
+	void _check(const gchar *req, int code) {
+		struct http_parser_s *parser = _parser();
+		enum http_parser_rc_e rc = http_parser_feed(parser,
+				(const guint8*) req, strlen(req), NULL);
+		g_assert_cmpint(rc, ==, HPRC_ERROR);
+		g_assert_nonnull(parser->error);
+		g_assert_cmpint(parser->error->code, ==, code);
+		http_parser_destroy(parser);
+	}
+
+	_check("GET\r\n\r\n", HTTP_CODE_BAD_REQUEST);
+	_check("GET /\r\n\r\n", HTTP_CODE_BAD_REQUEST);
+	_check("GET / HTTP/1.1\r\nHost : x\r\n\r\n", HTTP_CODE_BAD_REQUEST);
+	_check("GET / HTTP/1.1\r\n folded: x\r\n\r\n", HTTP_CODE_BAD_REQUEST);
+	_check("GET / HTTP/1.1\r\nNoColon\r\n\r\n", HTTP_CODE_BAD_REQUEST);
+	_check("GET / HTTP/1.1\r\nContent-Length: -1\r\n\r\n",
+			HTTP_CODE_BAD_REQUEST);
+	_check("GET / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nZZ\r\n",
+			HTTP_CODE_BAD_REQUEST);
+	_check("GET / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+			"1\r\nab\r\n", HTTP_CODE_BAD_REQUEST);
+
+	/* Only "chunked" alone is decoded */
+	_check("GET / HTTP/1.1\r\nTransfer-Encoding: gzip\r\n\r\n",
+			HTTP_CODE_NOT_IMPLEMENTED);
+	_check("GET / HTTP/1.1\r\nTransfer-Encoding: xchunked\r\n\r\n",
+			HTTP_CODE_NOT_IMPLEMENTED);
+	_check("GET / HTTP/1.1\r\nTransfer-Encoding: gzip, chunked\r\n\r\n",
+			HTTP_CODE_NOT_IMPLEMENTED);
+	_check("GET / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n"
+			"Transfer-Encoding: chunked\r\n\r\n", HTTP_CODE_NOT_IMPLEMENTED);
+
+	/* Request smuggling, whatever the order of the headers */
+	_check("POST / HTTP/1.1\r\nContent-Length: 4\r\n"
+			"Transfer-Encoding: chunked\r\n\r\n0\r\n\r\n",
+			HTTP_CODE_BAD_REQUEST);
+	_check("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n"
+			"Content-Length: 4\r\n\r\n0\r\n\r\n", HTTP_CODE_BAD_REQUEST);
+
+	gchar *long_line = g_strnfill(HTTP_PARSER_MAX_LINE + 1, 'a');
+	_check(long_line, HTTP_CODE_BAD_REQUEST);
+	g_free(long_line);
+
+	/* Empty elements of the list are ignored, the case too */
+	struct http_parser_s *parser = _parser();
+	const gchar *req = "POST / HTTP/1.1\r\nTransfer-Encoding: , Chunked ,\r\n"
+		"\r\n3\r\nabc\r\n0\r\n\r\n";
+	g_assert_cmpint(http_parser_feed(parser, (const guint8*) req, strlen(req),
+				NULL), ==, HPRC_SUCCESS);
+	g_assert_cmpstr(parsed.body->str, ==, "abc");
+	http_parser_destroy(parser);
+}
+
+/* Replay the captured requests, back to back as on a keep-alive connection,
+ * and report the throughput of the parser. */
+static void
+test_benchmark(void)
+{
+	const guint rounds = 200000;
+	GString *all = g_string_new("");
+	for (guint i = 0; i < G_N_ELEMENTS(captured); i++)
+		g_string_append(all, captured[i]);
+
+	struct http_parser_s *parser = _parser();
+	/* Measure the parser alone, not the test callbacks */
+	parser->command_provider = NULL;
+	parser->header_provider = NULL;
+	parser->body_provider = NULL;
+
+	g_test_timer_start();
+	for (guint r = 0; r < rounds; r++) {
+		const guint8 *data = (guint8*) all->str;
+		gsize remaining = all->len;
+		while (remaining > 0) {
+			gsize consumed = 0;
+			enum http_parser_rc_e rc =
+				http_parser_feed(parser, data, remaining, &consumed);
+			g_assert_cmpint(rc, ==, HPRC_SUCCESS);
+			data += consumed;
+			remaining -= consumed;
+			http_parser_reset(parser);
+		}
+	}
+	const gdouble elapsed = g_test_timer_elapsed();
+
+	const gdouble nb = (gdouble) rounds * G_N_ELEMENTS(captured);
+	g_test_minimized_result(elapsed * G_USEC_PER_SEC / nb,
+			"%.3f us per request", elapsed * G_USEC_PER_SEC / nb);
+	g_test_maximized_result(rounds * all->len / elapsed / (1024 * 1024),
+			"%.1f MiB/s", rounds * all->len / elapsed / (1024 * 1024));
+
+	http_parser_destroy(parser);
+	g_string_free(all, TRUE);
+}
+
+int
+main(int argc, char **argv)
+{
+	HC_TEST_INIT(argc,argv);
+	g_test_add_func("/proxy/http_parser/pipelined", test_pipelined);
+	g_test_add_func("/proxy/http_parser/fragmented", test_fragmented);
+	g_test_add_func("/proxy/http_parser/errors", test_errors);
+	if (g_test_perf())
+		g_test_add_func("/proxy/http_parser/benchmark", test_benchmark);
+	int rc = g_test_run();
+	_parsed_reset();
+	g_tree_destroy(parsed.headers);
+	g_string_free(parsed.body, TRUE);
+	return rc;
+}
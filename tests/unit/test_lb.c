@@ -400,6 +400,48 @@ test_uniform_level_repartition(gconstpointer raw_test_data)
 }
 
 
+static void
+test_local_poll_many(void)
+{
+	const char *locations[] = {
+		"rack0.srv0", "rack0.srv1", "rack1.srv2", "rack1.srv3",
+		"rack2.srv4", "rack2.srv5", "rack3.srv6", "rack3.srv7",
+		NULL
+	};
+	struct oio_lb_world_s *world = _world_from_loc_strings(locations);
+	struct oio_lb_pool_s *pool = _create_test_pool(world, 3, FALSE);
+	oio_lb_world__set_pool_option(pool, OIO_LB_OPT_SOFT_MAX, "3.3.1.1");
+	struct oio_lb_s *lb = oio_lb__create();
+	oio_lb__force_pool(lb, pool);
+
+	GPtrArray *out = NULL;
+	gboolean flawed = FALSE;
+	GError *err = oio_lb__poll_pool_many(lb, "pool-test", 64, 0, 0,
+			&out, &flawed);
+	g_assert_no_error(err);
+	g_assert_nonnull(out);
+	g_assert_cmpuint(out->len, ==, 64 * 3);
+
+	/* Each placement is made of different services */
+	for (guint i = 0; i < out->len; i += 3) {
+		struct oio_lb_selected_item_s **sel =
+				(struct oio_lb_selected_item_s **) out->pdata + i;
+		g_assert_cmpstr(sel[0]->item->id, !=, sel[1]->item->id);
+		g_assert_cmpstr(sel[0]->item->id, !=, sel[2]->item->id);
+		g_assert_cmpstr(sel[1]->item->id, !=, sel[2]->item->id);
+	}
+	g_ptr_array_free(out, TRUE);
+
+	out = NULL;
+	err = oio_lb__poll_pool_many(lb, "no-such-pool", 4, 0, 0, &out, NULL);
+	g_assert_error(err, GQ(), CODE_BAD_REQUEST);
+	g_assert_null(out);
+	g_clear_error(&err);
+
+	oio_lb__clear(&lb);
+	oio_lb_world__destroy(world);
+}
+
 static void
 test_local_feed_twice(void)
 {
@@ -425,6 +467,90 @@ test_local_feed_twice(void)
 	oio_lb_world__destroy(world);
 }
 
+static void
+test_local_remove(void)
+{
+	struct oio_lb_world_s *world = oio_lb_local__create_world();
+	struct oio_lb_item_s *srv0 = g_malloc0(sizeof(struct oio_lb_item_s));
+	struct oio_lb_item_s *srv1 = g_malloc0(sizeof(struct oio_lb_item_s));
+	srv0->location = 42 + 65536;
+	srv0->put_weight = 42;
+	g_sprintf(srv0->id, "ID-%d", 42);
+	srv1->location = 43 + 65536;
+	srv1->put_weight = 42;
+	g_sprintf(srv1->id, "ID-%d", 43);
+
+	oio_lb_world__create_slot(world, "0");
+	oio_lb_world__create_slot(world, "1");
+	oio_lb_world__feed_slot(world, "0", srv0);
+	oio_lb_world__feed_slot(world, "0", srv1);
+	oio_lb_world__feed_slot(world, "1", srv0);
+
+	oio_lb_world__remove_item(world, srv0->id);
+	oio_lb_world__rehash_all_slots(world);
+	g_assert_cmpuint(1, ==, oio_lb_world__count_slot_items(world, "0"));
+	g_assert_cmpuint(0, ==, oio_lb_world__count_slot_items(world, "1"));
+
+	/* unknown items are ignored, removed items may come back */
+	oio_lb_world__remove_item(world, "ID-44");
+	oio_lb_world__feed_slot(world, "1", srv0);
+	g_assert_cmpuint(1, ==, oio_lb_world__count_slot_items(world, "0"));
+	g_assert_cmpuint(1, ==, oio_lb_world__count_slot_items(world, "1"));
+
+	g_free(srv0);
+	g_free(srv1);
+	oio_lb_world__destroy(world);
+}
+
+static void
+test_local_poll_snapshot(void)
+{
+	struct oio_lb_world_s *world = oio_lb_local__create_world();
+	struct oio_lb_item_s *srv0 = g_malloc0(sizeof(struct oio_lb_item_s));
+	struct oio_lb_item_s *srv1 = g_malloc0(sizeof(struct oio_lb_item_s));
+	srv0->location = 42 + 65536;
+	srv0->put_weight = 42;
+	g_sprintf(srv0->id, "ID-%d", 42);
+	srv1->location = 43 + 65536;
+	srv1->put_weight = 42;
+	g_sprintf(srv1->id, "ID-%d", 43);
+
+	oio_lb_world__create_slot(world, "0");
+	oio_lb_world__feed_slot(world, "0", srv0);
+	oio_lb_world__rehash_all_slots(world);
+
+	struct oio_lb_pool_s *pool = oio_lb_world__create_pool(world, "pool-test");
+	oio_lb_world__add_pool_target(pool, "0");
+
+	guint polled[2] = {0, 0};
+	void _on_item(struct oio_lb_selected_item_s *sel, gpointer u UNUSED) {
+		polled[g_str_equal(sel->item->id, srv1->id)] ++;
+	}
+	void _poll_many(void) {
+		for (int i = 0; i < 128; i++) {
+			GError *err = oio_lb_pool__poll(pool, NULL, _on_item, NULL);
+			g_assert_no_error(err);
+		}
+	}
+
+	/* The pollers keep using the previous state of the slot
+	 * until the new items are hashed. */
+	oio_lb_world__feed_slot(world, "0", srv1);
+	_poll_many();
+	g_assert_cmpuint(polled[0], ==, 128);
+	g_assert_cmpuint(polled[1], ==, 0);
+
+	oio_lb_world__rehash_all_slots(world);
+	_poll_many();
+	g_assert_cmpuint(polled[0], >, 128);
+	g_assert_cmpuint(polled[1], >, 0);
+
+	oio_lb_pool__destroy(pool);
+	g_free(srv0);
+	g_free(srv1);
+	oio_lb_world__destroy(world);
+}
+
 static void
 test_local_feed (void)
 {
@@ -762,11 +888,15 @@ main(int argc, char **argv)
 	g_test_add_func("/core/lb/local/weird_pool", test_weird_pool_configurations);
 	g_test_add_func("/core/lb/local/feed", test_local_feed);
 	g_test_add_func("/core/lb/local/feed_twice", test_local_feed_twice);
+	g_test_add_func("/core/lb/local/remove", test_local_remove);
 	g_test_add_func("/core/lb/local/feed_zero_scored",
 			test_local_feed_zero_scored);
 	g_test_add_func("/core/lb/local/poll", test_local_poll);
 	g_test_add_func("/core/lb/local/poll_same_low",
 			test_local_poll_same_low_bits);
+	g_test_add_func("/core/lb/local/poll_snapshot",
+			test_local_poll_snapshot);
+	g_test_add_func("/core/lb/local/poll_many", test_local_poll_many);
 
 	_add_repartition_test(30, 1, 1);
 	_add_repartition_test(30, 1, 3);
@@ -0,0 +1,197 @@
+/*
+OpenIO SDS unit tests
+Copyright (C) 2025 OVH SAS
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 3.0 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+*/
+
+#include <stdlib.h>
+
+#include <core/oio_core.h>
+#include <core/lruhash.h>
+
+static struct lru_hash_s *
+_create(guint shards)
+{
+	return lru_hash_create(g_str_hash, g_str_equal, g_free, g_free,
+			LTO_NONE, shards);
+}
+
+static void
+_fill(struct lru_hash_s *lh, guint count)
+{
+	for (guint i = 0; i < count; i++)
+		lru_hash_insert(lh, g_strdup_printf("k%u", i),
+				g_strdup_printf("v%u", i));
+}
+
+static void
+test_basic(void)
+{
+	struct lru_hash_s *lh = _create(4);
+
+	lru_hash_insert(lh, g_strdup("plop"), g_strdup("1"));
+	lru_hash_insert(lh, g_strdup("plop"), g_strdup("2"));
+	lru_hash_insert(lh, g_strdup("plip"), g_strdup("3"));
+	g_assert_cmpint(lru_hash_count(lh), ==, 2);
+
+	gchar *v = lru_hash_get(lh, "plop", (GBoxedCopyFunc)g_strdup);
+	g_assert_cmpstr(v, ==, "2");
+	g_free(v);
+	g_assert_null(lru_hash_get(lh, "plup", (GBoxedCopyFunc)g_strdup));
+
+	g_assert_true(lru_hash_remove(lh, "plop"));
+	g_assert_false(lru_hash_remove(lh, "plop"));
+	g_assert_cmpint(lru_hash_count(lh), ==, 1);
+
+	lru_hash_destroy(lh);
+}
+
+static void
+test_merge(void)
+{
+	void _merge(gpointer v, gconstpointer previous) {
+		((gchar*)v)[0] = ((const gchar*)previous)[0];
+	}
+
+	struct lru_hash_s *lh = _create(1);
+	lru_hash_insert_merge(lh, g_strdup("k"), g_strdup("ab"), _merge);
+	lru_hash_insert_merge(lh, g_strdup("k"), g_strdup("cd"), _merge);
+	gchar *v = lru_hash_get(lh, "k", (GBoxedCopyFunc)g_strdup);
+	g_assert_cmpstr(v, ==, "ad");
+	g_free(v);
+	lru_hash_destroy(lh);
+}
+
+/* With one shard, the CLOCK gives a second chance to the items read since
+ * the last sweep, and evicts the oldest of the others. */
+static void
+test_exceeding(void)
+{
+	struct lru_hash_s *lh = _create(1);
+	_fill(lh, 10);
+	lru_hash_get(lh, "k0", NULL);
+	lru_hash_get(lh, "k1", NULL);
+
+	g_assert_cmpuint(lru_hash_remove_exceeding(lh, 5), ==, 5);
+	g_assert_cmpint(lru_hash_count(lh), ==, 5);
+	g_assert_nonnull(lru_hash_get(lh, "k0", NULL));
+	g_assert_nonnull(lru_hash_get(lh, "k1", NULL));
+	g_assert_nonnull(lru_hash_get(lh, "k9", NULL));
+	g_assert_null(lru_hash_get(lh, "k2", NULL));
+
+	g_assert_cmpuint(lru_hash_remove_exceeding(lh, 0), ==, 5);
+	g_assert_cmpint(lru_hash_count(lh), ==, 0);
+	lru_hash_destroy(lh);
+
+	lh = _create(8);
+	_fill(lh, 1000);
+	lru_hash_remove_exceeding(lh, 100);
+	g_assert_cmpint(lru_hash_count(lh), <=, 100);
+	lru_hash_destroy(lh);
+}
+
+static void
+test_older(void)
+{
+	struct lru_hash_s *lh = _create(8);
+	_fill(lh, 100);
+	g_assert_cmpuint(lru_hash_remove_older(lh, 0), ==, 0);
+	g_usleep(1000);
+	const gint64 limit = oio_ext_monotonic_time();
+	g_usleep(1000);
+	lru_hash_insert(lh, g_strdup("k0"), g_strdup("v0"));
+	lru_hash_get(lh, "k1", NULL);
+	g_assert_cmpuint(lru_hash_remove_older(lh, limit), ==, 98);
+	g_assert_cmpint(lru_hash_count(lh), ==, 2);
+	lru_hash_destroy(lh);
+}
+
+static void
+test_matching(void)
+{
+	gboolean _even(gpointer k, gpointer v, gpointer u) {
+		(void) v, (void) u;
+		return (atoi(((gchar*)k) + 1) % 2) == 0;
+	}
+	gboolean _count(gpointer k, gpointer v, gpointer u) {
+		(void) k, (void) v;
+		++ *((guint*)u);
+		return FALSE;
+	}
+	gboolean _steal(gpointer k, gpointer v, gpointer u) {
+		++ *((guint*)u);
+		g_free(k);
+		g_free(v);
+		return FALSE;
+	}
+
+	struct lru_hash_s *lh = _create(8);
+	_fill(lh, 100);
+	g_assert_cmpuint(lru_hash_remove_matching(lh, _even, NULL), ==, 50);
+
+	guint count = 0;
+	lru_hash_foreach(lh, _count, &count);
+	g_assert_cmpuint(count, ==, 50);
+
+	count = 0;
+	lru_hash_foreach_steal(lh, _steal, &count);
+	g_assert_cmpuint(count, ==, 50);
+	g_assert_cmpint(lru_hash_count(lh), ==, 0);
+	lru_hash_destroy(lh);
+}
+
+static void
+test_concurrency(void)
+{
+	struct lru_hash_s *lh = _create(16);
+
+	gpointer _worker(gpointer p) {
+		const guint id = GPOINTER_TO_UINT(p);
+		for (guint i = 0; i < 10000; i++) {
+			gchar *k = g_strdup_printf("k%u", (i * 7 + id) % 512);
+			lru_hash_insert(lh, g_strdup(k), g_strdup(k));
+			gchar *v = lru_hash_get(lh, k, (GBoxedCopyFunc)g_strdup);
+			if (v)
+				g_assert_cmpstr(v, ==, k);
+			g_free(v);
+			if (!(i % 64))
+				lru_hash_remove_exceeding(lh, 256);
+			g_free(k);
+		}
+		return NULL;
+	}
+
+	GThread *threads[8];
+	for (guint i = 0; i < G_N_ELEMENTS(threads); i++)
+		threads[i] = g_thread_new("lru", _worker, GUINT_TO_POINTER(i));
+	for (guint i = 0; i < G_N_ELEMENTS(threads); i++)
+		g_thread_join(threads[i]);
+
+	g_assert_cmpint(lru_hash_count(lh), <=, 512);
+	lru_hash_destroy(lh);
+}
+
+int
+main(int argc, char **argv)
+{
+	HC_TEST_INIT(argc,argv);
+	g_test_add_func("/core/lru_hash/basic", test_basic);
+	g_test_add_func("/core/lru_hash/merge", test_merge);
+	g_test_add_func("/core/lru_hash/exceeding", test_exceeding);
+	g_test_add_func("/core/lru_hash/older", test_older);
+	g_test_add_func("/core/lru_hash/matching", test_matching);
+	g_test_add_func("/core/lru_hash/concurrency", test_concurrency);
+	return g_test_run();
+}
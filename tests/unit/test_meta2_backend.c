@@ -27,6 +27,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <meta2v2/meta2_backend_internals.h>
 #include <meta2v2/generic.h>
 #include <meta2v2/autogen.h>
+#include <sqliterepo/sqlx_remote.h>
 #include <resolver/hc_resolver.h>
 #include <cluster/lib/gridcluster.h>
 
@@ -205,6 +206,91 @@ check_list_count(struct meta2_backend_s *m2, struct oio_url_s *url,
 	g_assert(counter == expected);
 }
 
+/* List all the versions with the headers, the chunks and the properties,
+ * that are loaded by batches, and check each alias comes right after its
+ * own header, chunks and properties. */
+static void
+check_list_details(struct meta2_backend_s *m2, struct oio_url_s *url,
+		guint expected)
+{
+	struct list_params_s lp = {0};
+	lp.flag_allversion = ~0;
+	lp.flag_headers = ~0;
+	lp.flag_properties = ~0;
+	lp.flag_recursion = ~0;
+
+	GPtrArray *tmp = g_ptr_array_new();
+	GError *err = meta2_backend_list_aliases(m2, url, &lp, NULL,
+			_bean_buffer_cb, tmp, NULL, NULL);
+	g_assert_no_error(err);
+	_debug_beans_array(tmp);
+	g_assert_cmpuint(tmp->len, ==, expected);
+	g_assert_true(DESCR(tmp->pdata[tmp->len - 1]) == &descr_struct_ALIASES);
+
+	guint first = 0;
+	for (guint i = 0; i < tmp->len; i++) {
+		struct bean_ALIASES_s *alias = tmp->pdata[i];
+		if (DESCR(alias) != &descr_struct_ALIASES)
+			continue;
+		GByteArray *content = ALIASES_get_content(alias);
+		guint headers = 0, chunks = 0;
+		for (guint j = first; j < i; j++) {
+			gpointer bean = tmp->pdata[j];
+			if (DESCR(bean) == &descr_struct_CONTENTS_HEADERS) {
+				g_assert_cmpint(metautils_gba_cmp(content,
+						CONTENTS_HEADERS_get_id(bean)), ==, 0);
+				headers ++;
+			} else if (DESCR(bean) == &descr_struct_CHUNKS) {
+				g_assert_cmpint(metautils_gba_cmp(content,
+						CHUNKS_get_content(bean)), ==, 0);
+				chunks ++;
+			} else {
+				g_assert_true(DESCR(bean) == &descr_struct_PROPERTIES);
+				g_assert_cmpstr(ALIASES_get_alias(alias)->str, ==,
+						PROPERTIES_get_alias(bean)->str);
+				g_assert_cmpint(ALIASES_get_version(alias), ==,
+						PROPERTIES_get_version(bean));
+			}
+		}
+		g_assert_cmpuint(headers, ==, 1);
+		g_assert_cmpuint(chunks, ==, chunks_count);
+		first = i + 1;
+	}
+	_bean_cleanv2(tmp);
+}
+
+/* Add an alias of the same content as the latest version of <url>, as a
+ * copy of the object would do. */
+static void
+_link_alias(struct meta2_backend_s *m2, struct oio_url_s *url,
+		const gchar *path)
+{
+	GPtrArray *tmp = g_ptr_array_new();
+	GError *err = meta2_backend_get_alias(m2, url, M2V2_FLAG_NOPROPS,
+			_bean_buffer_cb, tmp);
+	g_assert_no_error(err);
+	struct bean_ALIASES_s *alias = NULL;
+	for (guint i = 0; i < tmp->len; i++) {
+		if (DESCR(tmp->pdata[i]) == &descr_struct_ALIASES)
+			alias = _bean_dup(tmp->pdata[i]);
+	}
+	_bean_cleanv2(tmp);
+	g_assert_nonnull(alias);
+	ALIASES_set2_alias(alias, path);
+
+	struct sqlx_name_inline_s n0;
+	sqlx_inline_name_fill(&n0, url, NAME_SRVTYPE_META2, 1, NULL);
+	NAME2CONST(n, n0);
+	struct sqlx_sqlite3_s *sq3 = NULL;
+	err = sqlx_repository_open_and_lock(m2->repo, &n, SQLX_OPEN_LOCAL,
+			&sq3, NULL);
+	g_assert_no_error(err);
+	err = _db_insert_bean(sq3, alias);
+	g_assert_no_error(err);
+	sqlx_repository_unlock_and_close_noerror(sq3);
+	_bean_clean(alias);
+}
+
 static struct namespace_info_s *
 _init_nsinfo(const gchar *ns, gint64 maxvers)
 {
@@ -985,6 +1071,7 @@ test_content_put_prop_get(void)
 		CHECK_ALIAS_VERSION(m2,u,CLOCK_START);
 		check_list_count(m2,u,1);
 		CLOCK ++;
+		check_list_details(m2, u, 10 + 2 + chunks_count);
 
 		/* check we got our beans, without the properties */
 		tmp = g_ptr_array_new();
@@ -1036,6 +1123,62 @@ test_content_put_prop_get(void)
 	_container_wraper_allversions("NS", test);
 }
 
+static void
+test_content_list_details(void)
+{
+	void test(struct meta2_backend_s *m2, struct oio_url_s *u, gint64 maxver) {
+		/* More aliases than a batch of the listing (256) */
+		const guint nb_aliases = 300;
+		/* Versioned, this alias has its 2 versions listed in 2 batches */
+		const guint straddling = 255;
+		const guint nb_props = 2;
+		const guint nb_linked = 3;
+		guint expected = 0;
+		GError *err;
+
+		CLOCK_START = CLOCK = oio_ext_rand_int();
+
+		void _put(void) {
+			_set_content_id(u);
+			GSList *beans = _create_alias(m2, u, NULL);
+			err = meta2_backend_put_alias(m2, u, beans, NULL, NULL, NULL, NULL);
+			g_assert_no_error(err);
+			_bean_cleanl2(beans);
+			CLOCK ++;
+
+			GSList *modified = NULL;
+			beans = _props_generate(u, 1, nb_props);
+			err = meta2_backend_set_properties(m2, u, TRUE, beans, &modified);
+			g_assert_no_error(err);
+			_bean_cleanl2(beans);
+			_bean_cleanl2(modified);
+			CLOCK ++;
+			expected += 2 + chunks_count + nb_props;
+		}
+
+		for (guint i = 0; i < nb_aliases; i++) {
+			gchar path[32];
+			g_snprintf(path, sizeof(path), "content-%04u", i);
+			oio_url_set(u, OIOURL_PATH, path);
+			_put();
+			if (i == straddling && VERSIONS_ENABLED(maxver))
+				_put();
+		}
+
+		/* Several aliases of the same content, in the same batch */
+		oio_url_set(u, OIOURL_PATH, "content-0000");
+		for (guint i = 0; i < nb_linked; i++) {
+			gchar path[32];
+			g_snprintf(path, sizeof(path), "linked-%u", i);
+			_link_alias(m2, u, path);
+			expected += 2 + chunks_count;
+		}
+
+		check_list_details(m2, u, expected);
+	}
+	_container_wraper_allversions("NS", test);
+}
+
 static void
 test_content_put_get_delete(void)
 {
@@ -1490,6 +1633,8 @@ main(int argc, char **argv)
 			test_content_put_lower_version);
 	g_test_add_func("/meta2v2/backend/content/put_prop_get",
 			test_content_put_prop_get);
+	g_test_add_func("/meta2v2/backend/content/list_details",
+			test_content_list_details);
 	g_test_add_func("/meta2v2/backend/content/append_empty",
 			test_content_append_empty);
 	g_test_add_func("/meta2v2/backend/props/set_simple",
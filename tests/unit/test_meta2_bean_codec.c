@@ -0,0 +1,243 @@
+/*
+OpenIO SDS unit tests
+Copyright (C) 2025 OVH SAS
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 3.0 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+*/
+
+#include <string.h>
+#include <glib.h>
+
+#include <metautils/lib/metautils.h>
+#include <meta2v2/generic.h>
+#include <meta2v2/autogen.h>
+#include <meta2v2/meta2_bean.h>
+
+/* What a page of a listing looks like: an alias and its header per object,
+ * with policies, mime-types and chunk methods shared by many objects. */
+static GSList *
+_listing(guint count)
+{
+	static const char *policies[] = {"SINGLE", "THREECOPIES", "EC"};
+	static const guint8 hash[16] = {
+		0xd4, 0x1d, 0x8c, 0xd9, 0x8f, 0x00, 0xb2, 0x04,
+		0xe9, 0x80, 0x09, 0x98, 0xec, 0xf8, 0x42, 0x7e,
+	};
+	GSList *beans = NULL;
+
+	for (guint i = 0; i < count; i++) {
+		gchar name[64];
+		guint8 id[16];
+		g_snprintf(name, sizeof(name), "photos/2025/%08u.jpg", i);
+		oio_buf_randomize(id, sizeof(id));
+
+		struct bean_ALIASES_s *alias = _bean_create(&descr_struct_ALIASES);
+		ALIASES_set2_alias(alias, name);
+		ALIASES_set_version(alias, 1700000000000000 + i);
+		ALIASES_set2_content(alias, id, sizeof(id));
+		ALIASES_set_deleted(alias, i % 7 == 0);
+		ALIASES_set_ctime(alias, 1700000000 + i);
+		ALIASES_set_mtime(alias, 1700000000 + i);
+
+		struct bean_CONTENTS_HEADERS_s *header =
+			_bean_create(&descr_struct_CONTENTS_HEADERS);
+		CONTENTS_HEADERS_set2_id(header, id, sizeof(id));
+		CONTENTS_HEADERS_set2_hash(header, hash, sizeof(hash));
+		CONTENTS_HEADERS_set_size(header, i * 1024);
+		CONTENTS_HEADERS_set_ctime(header, 1700000000 + i);
+		CONTENTS_HEADERS_set_mtime(header, 1700000000 + i);
+		CONTENTS_HEADERS_set2_mime_type(header, "image/jpeg");
+		CONTENTS_HEADERS_set2_chunk_method(header, "plain/nb_copy=3");
+		CONTENTS_HEADERS_set2_policy(header, policies[i % 3]);
+
+		beans = g_slist_prepend(beans, alias);
+		beans = g_slist_prepend(beans, header);
+		if (i % 10 == 0) {
+			struct bean_PROPERTIES_s *prop =
+				_bean_create(&descr_struct_PROPERTIES);
+			PROPERTIES_set2_alias(prop, name);
+			PROPERTIES_set_version(prop, 1700000000000000 + i);
+			PROPERTIES_set2_key(prop, "user.color");
+			PROPERTIES_set2_value(prop, (guint8*)"blue", 4);
+			beans = g_slist_prepend(beans, prop);
+		}
+	}
+	return g_slist_reverse(beans);
+}
+
+static GString *
+_debug(GSList *beans)
+{
+	GString *gs = g_string_sized_new(1024);
+	for (GSList *l = beans; l; l = l->next) {
+		gs = _bean_debug(gs, l->data);
+		g_string_append_c(gs, '\n');
+	}
+	return gs;
+}
+
+static void
+test_roundtrip (void)
+{
+	GSList *beans = _listing(100);
+
+	GByteArray *der = bean_sequence_marshall(beans);
+	GByteArray *compact = bean_sequence_marshall_compact(beans);
+	g_assert_nonnull(der);
+	g_assert_nonnull(compact);
+	g_assert_false(bean_sequence_is_compact(der->data, der->len));
+	g_assert_true(bean_sequence_is_compact(compact->data, compact->len));
+	g_assert_cmpuint(compact->len, <, der->len);
+
+	/* The same decoder accepts both, and gives the same beans */
+	GSList *l0 = NULL, *l1 = NULL;
+	GError *err = NULL;
+	g_assert_cmpint(bean_sequence_decoder(&l0, der->data, der->len, &err),
+			>, 0);
+	g_assert_no_error(err);
+	g_assert_cmpint(
+			bean_sequence_decoder(&l1, compact->data, compact->len, &err),
+			>, 0);
+	g_assert_no_error(err);
+
+	GString *d0 = _debug(l0), *d1 = _debug(l1);
+	g_assert_cmpstr(d0->str, ==, d1->str);
+	g_string_free(d0, TRUE);
+	g_string_free(d1, TRUE);
+
+	_bean_cleanl2(l0);
+	_bean_cleanl2(l1);
+	g_byte_array_unref(der);
+	g_byte_array_unref(compact);
+	_bean_cleanl2(beans);
+}
+
+static void
+test_empty (void)
+{
+	GByteArray *compact = bean_sequence_marshall_compact(NULL);
+	GSList *l = NULL;
+	GError *err = NULL;
+	g_assert_cmpint(
+			bean_sequence_decoder(&l, compact->data, compact->len, &err),
+			>, 0);
+	g_assert_no_error(err);
+	g_assert_null(l);
+	g_byte_array_unref(compact);
+}
+
+static void
+test_truncated (void)
+{
+	GSList *beans = _listing(10);
+	GByteArray *compact = bean_sequence_marshall_compact(beans);
+
+	for (guint len = 4; len < compact->len; len++) {
+		GSList *l = NULL;
+		GError *err = NULL;
+		gint rc = bean_sequence_decoder(&l, compact->data, len, &err);
+		g_assert_cmpint(rc, <, 0);
+		g_assert_nonnull(err);
+		g_assert_null(l);
+		g_clear_error(&err);
+	}
+
+	g_byte_array_unref(compact);
+	_bean_cleanl2(beans);
+}
+
+static void
+test_pool (void)
+{
+	oio_ext_enable_perfdata(TRUE);
+	_bean_pool_begin();
+
+	struct bean_ALIASES_s *a0 = _bean_create(&descr_struct_ALIASES);
+	ALIASES_set2_alias(a0, "plop");
+	g_assert_cmpstr(ALIASES_get_alias(a0)->str, ==, "plop");
+	ALIASES_set_version(a0, 1);
+	_bean_clean(a0);
+
+	/* The shell is reused, blank */
+	struct bean_ALIASES_s *a1 = _bean_create(&descr_struct_ALIASES);
+	g_assert_true(a0 == a1);
+	g_assert_cmpuint(HDR(a1)->fields, ==, 0);
+	g_assert_cmpuint(ALIASES_get_alias(a1)->len, ==, 0);
+	g_assert_cmpint(ALIASES_get_version(a1), ==, 0);
+
+	/* ... but not by another type */
+	struct bean_PROPERTIES_s *p = _bean_create(&descr_struct_PROPERTIES);
+	g_assert_true((gpointer)p != (gpointer)a0);
+
+	_bean_pool_report();
+	GHashTable *perfdata = oio_ext_get_perfdata();
+	g_assert_cmpint(GPOINTER_TO_INT(
+			g_hash_table_lookup(perfdata, "bean_reuse_count")), ==, 1);
+	g_assert_cmpint(GPOINTER_TO_INT(
+			g_hash_table_lookup(perfdata, "bean_malloc_count")), >, 2);
+	g_assert_true(oio_ext_is_perfdata_count("bean_reuse_count"));
+	g_assert_true(oio_ext_is_perfdata_count("bean_malloc_count"));
+
+	_bean_clean(a1);
+	_bean_clean(p);
+	_bean_pool_end();
+	oio_ext_enable_perfdata(FALSE);
+}
+
+static void
+_bench(const char *tag, GSList *beans, GByteArray* (*marshall)(GSList*))
+{
+	const guint rounds = 200;
+	gsize size = 0;
+
+	g_test_timer_start();
+	for (guint r = 0; r < rounds; r++) {
+		GByteArray *gba = marshall(beans);
+		size = gba->len;
+		GSList *l = NULL;
+		GError *err = NULL;
+		g_assert_cmpint(bean_sequence_decoder(&l, gba->data, gba->len, &err),
+				>, 0);
+		_bean_cleanl2(l);
+		g_byte_array_unref(gba);
+	}
+	const gdouble elapsed = g_test_timer_elapsed();
+
+	g_test_minimized_result(elapsed * G_USEC_PER_SEC / rounds,
+			"%s: %.1f us per page of %u beans, %"G_GSIZE_FORMAT" bytes",
+			tag, elapsed * G_USEC_PER_SEC / rounds,
+			g_slist_length(beans), size);
+}
+
+static void
+test_benchmark (void)
+{
+	GSList *beans = _listing(1000);
+	_bench("DER", beans, bean_sequence_marshall);
+	_bench("compact", beans, bean_sequence_marshall_compact);
+	_bean_cleanl2(beans);
+}
+
+int
+main(int argc, char **argv)
+{
+	HC_TEST_INIT(argc,argv);
+	g_test_add_func("/meta2v2/bean/codec/roundtrip", test_roundtrip);
+	g_test_add_func("/meta2v2/bean/codec/empty", test_empty);
+	g_test_add_func("/meta2v2/bean/codec/truncated", test_truncated);
+	g_test_add_func("/meta2v2/bean/pool", test_pool);
+	if (g_test_perf())
+		g_test_add_func("/meta2v2/bean/codec/benchmark", test_benchmark);
+	return g_test_run();
+}
@@ -24,6 +24,7 @@ License along with this library.
 #include <core/internals.h>
 
 #include <server/network_server.h>
+#include <server/server_variables.h>
 
 #define GQ_SERVER() g_quark_from_static_string("oio.srv")
 
@@ -70,6 +71,32 @@ test_bad_bind_address_empty_brackets(void)
 	_test_bad_bind_address("[]:12345");
 }
 
+static void
+test_reactors_share_port(void)
+{
+	const guint saved = server_reactors;
+	server_reactors = 4;
+
+	struct network_server_s *srv = network_server_init();
+	g_assert_nonnull(srv);
+	network_server_bind_host(srv, "127.0.0.1:0", NULL, _do_nothing);
+	g_assert_no_error(network_server_open_servers(srv));
+
+	/* All the reactors listen on the same address, only one is exposed */
+	gchar **endpoints = network_server_endpoints(srv);
+	g_assert_nonnull(endpoints);
+	g_assert_cmpuint(1, ==, g_strv_length(endpoints));
+	g_assert_false(g_str_has_suffix(endpoints[0], ":0"));
+	g_strfreev(endpoints);
+
+	g_assert_cmpuint(0, ==, network_server_count_threads(srv));
+	g_assert_false(network_server_has_connections(srv));
+
+	network_server_close_servers(srv);
+	network_server_clean(srv);
+	server_reactors = saved;
+}
+
 int
 main(int argc, char **argv)
 {
@@ -82,5 +109,7 @@ main(int argc, char **argv)
 			test_bad_bind_address_quotes);
 	g_test_add_func("/server/core/bad_bind_address/257",
 			test_bad_bind_address_257);
+	g_test_add_func("/server/core/reactors/share_port",
+			test_reactors_share_port);
 	return g_test_run();
 }
@@ -0,0 +1,342 @@
+/*
+OpenIO SDS unit tests
+Copyright (C) 2025 OVH SAS
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 3.0 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+*/
+
+#include <glib.h>
+
+#include <metautils/lib/metautils.h>
+#include <meta2v2/meta2_bean.h>
+#include <meta2v2/autogen.h>
+#include <proxy/common.h>
+#include <proxy/actions.h>
+
+/* The listing loop talks to a fake sharded container, whose shards are all
+ * known by a fake shard resolver. */
+static GError * _fake_request(struct req_args_s *args,
+		struct client_ctx_s *ctx, request_packer_f pack);
+static gpointer _fake_get_cached(struct shard_resolver_s *resolver,
+		struct oio_url_s *url);
+static GSList * _fake_get_cached_range(struct shard_resolver_s *resolver,
+		struct oio_url_s *url, guint max);
+static gboolean _fake_is_running(void);
+
+#define gridd_request_replicated_with_retry _fake_request
+#define shard_resolver_get_cached _fake_get_cached
+#define shard_resolver_get_cached_range _fake_get_cached_range
+#define grid_main_is_running _fake_is_running
+
+/* The globals of the proxy, as is */
+#define main proxy_main
+#include "../../proxy/metacd_http.c"
+#undef main
+
+#include "../../proxy/m2_actions.c"
+
+/* Each shard manages the objects after its lower bound, up to its upper
+ * bound (included). The last shard has no upper bound. */
+static const gchar *bounds[] = {"", "a9", "b9", "", NULL};
+#define NB_SHARDS 3
+
+static const gchar *names[] = {
+	"a0", "a1", "b0", "b1", "b2", "b3", "b4", "c0", "c1", NULL
+};
+
+/* How many objects a shard returns at most per page */
+static gint64 page_size = 1000;
+
+/* The version marker returned with the pages exhausting a shard */
+static const gchar *shard_version_marker = NULL;
+
+/* The prefetch worker waits for the first page started with this marker to
+ * be cancelled (or for a second) before running it. */
+static const gchar *hold_marker = NULL;
+
+static GMutex requests_lock = {0};
+/* The requests sent, as "<loop|prefetch>:<marker>|<version marker>" */
+static GPtrArray *requests = NULL;
+static guint nb_cancelled = 0;
+static GThread *loop_thread = NULL;
+static struct oio_url_s *list_url = NULL;
+
+static gboolean
+_fake_is_running(void)
+{
+	return TRUE;
+}
+
+static gpointer
+_fake_get_cached(struct shard_resolver_s *resolver UNUSED,
+		struct oio_url_s *url UNUSED)
+{
+	/* The requests are never redirected, the fake container answers for
+	 * all its shards. */
+	return NULL;
+}
+
+static guint
+_shard_of(const gchar *path)
+{
+	guint i = 0;
+	while (*bounds[i+1] && g_strcmp0(path, bounds[i+1]) >= 0)
+		i++;
+	return i;
+}
+
+static gpointer
+_shard_range(guint i)
+{
+	struct bean_SHARD_RANGE_s *shard = _bean_create(&descr_struct_SHARD_RANGE);
+	SHARD_RANGE_set2_lower(shard, bounds[i]);
+	SHARD_RANGE_set2_upper(shard, bounds[i+1]);
+	return shard;
+}
+
+static GSList *
+_fake_get_cached_range(struct shard_resolver_s *resolver UNUSED,
+		struct oio_url_s *url, guint max)
+{
+	GSList *shards = NULL;
+	for (guint i = _shard_of(oio_url_get(url, OIOURL_PATH));
+			i < NB_SHARDS && max > 0; i++, max--)
+		shards = g_slist_prepend(shards, _shard_range(i));
+	return g_slist_reverse(shards);
+}
+
+static GError *
+_fake_request(struct req_args_s *args UNUSED, struct client_ctx_s *ctx,
+		request_packer_f pack)
+{
+	GByteArray *gba = pack(NULL, NULL);
+	MESSAGE request = message_unmarshall(gba->data, gba->len, NULL);
+	g_byte_array_unref(gba);
+	g_assert_nonnull(request);
+	gchar *marker = metautils_message_extract_string_copy(
+			request, NAME_MSGKEY_MARKER);
+	gchar *version_marker = metautils_message_extract_string_copy(
+			request, NAME_MSGKEY_VERSIONMARKER);
+	gint64 max = 0;
+	GError *err = metautils_message_extract_strint64(
+			request, NAME_MSGKEY_MAX_KEYS, FALSE, &max);
+	g_assert_no_error(err);
+	metautils_message_destroy(request);
+
+	g_mutex_lock(&requests_lock);
+	g_ptr_array_add(requests, g_strdup_printf("%s:%s|%s",
+			g_thread_self() == loop_thread ? "loop" : "prefetch",
+			marker ?: "", version_marker ?: ""));
+	g_mutex_unlock(&requests_lock);
+
+	/* List the objects of the shard managing the marker */
+	const guint shard = _shard_of(marker ?: "");
+	const gchar *upper = bounds[shard+1];
+	if (max <= 0 || max > page_size)
+		max = page_size;
+	GSList *beans = NULL;
+	const gchar *last = NULL;
+	gboolean truncated = FALSE;
+	for (const gchar **pn = names; *pn; pn++) {
+		if (g_strcmp0(*pn, marker) <= 0)
+			continue;
+		if (*upper && g_strcmp0(*pn, upper) > 0)
+			break;
+		if (max-- <= 0) {
+			truncated = TRUE;
+			break;
+		}
+		struct bean_ALIASES_s *alias = _bean_create(&descr_struct_ALIASES);
+		ALIASES_set2_alias(alias, *pn);
+		ALIASES_set_version(alias, 1);
+		ALIASES_set2_content(alias, (guint8*)*pn, strlen(*pn));
+		beans = g_slist_prepend(beans, alias);
+		last = *pn;
+	}
+	beans = g_slist_reverse(beans);
+
+	MESSAGE reply = metautils_message_create_named("RP", 0);
+	metautils_message_add_body_unref(reply, bean_sequence_marshall(beans));
+	_bean_cleanl2(beans);
+	if (truncated) {
+		metautils_message_add_field_str(reply, NAME_MSGKEY_NEXTMARKER, last);
+	} else if (*upper) {
+		/* The shard is exhausted, the listing goes on in the next one */
+		truncated = TRUE;
+		metautils_message_add_field_str(reply, NAME_MSGKEY_NEXTMARKER, upper);
+		metautils_message_add_field_str(reply, NAME_MSGKEY_NEXTVERSIONMARKER,
+				shard_version_marker);
+	}
+	metautils_message_add_field_str(reply, NAME_MSGKEY_TRUNCATED,
+			truncated ? "true" : "false");
+	metautils_message_add_field_str(reply,
+			NAME_MSGKEY_PREFIX_PROPERTY "sys.m2.objects", "9");
+	g_assert_true(ctx->decoder(ctx->decoder_data, CODE_FINAL_OK, reply));
+	metautils_message_destroy(reply);
+
+	g_free(marker);
+	g_free(version_marker);
+	return NULL;
+}
+
+static void
+_test_prefetch_worker(gpointer data, gpointer udata)
+{
+	struct list_prefetch_s *pf = data;
+	if (hold_marker && !g_strcmp0(pf->in.marker_start, hold_marker)) {
+		/* Let the listing loop decide about this page first */
+		const gint64 deadline = g_get_monotonic_time() + G_TIME_SPAN_SECOND;
+		while (!g_atomic_int_get(&pf->cancelled)
+				&& g_get_monotonic_time() < deadline)
+			g_usleep(1000);
+		hold_marker = NULL;
+	}
+	if (g_atomic_int_get(&pf->cancelled))
+		nb_cancelled++;
+	list_prefetch_worker(data, udata);
+}
+
+static GByteArray *
+_pack(struct list_params_s *in)
+{
+	return m2v2_remote_pack_LIST(list_url, in, oio_ext_get_deadline());
+}
+
+/* List the whole container, check the objects are listed once and in
+ * order, then check the requests sent. */
+static void
+_check_list(const gchar **expected_requests)
+{
+	g_ptr_array_set_size(requests, 0);
+	nb_cancelled = 0;
+	loop_thread = g_thread_self();
+	oio_ext_set_deadline(g_get_monotonic_time() + 10 * G_TIME_SPAN_SECOND);
+
+	struct oio_requri_s req_uri = {0};
+	struct http_request_s rq = {0};
+	rq.tree_headers = g_tree_new_full(metautils_strcmp3, NULL, g_free, g_free);
+	struct req_args_s args = {0};
+	args.req_uri = &req_uri;
+	args.url = list_url;
+	args.rq = &rq;
+
+	struct list_params_s in = {0};
+	struct list_result_s out = {0};
+	m2v2_list_result_init(&out);
+	GTree *tree_prefixes = g_tree_new_full(
+			metautils_strcmp3, NULL, g_free, NULL);
+	GQueue objects = G_QUEUE_INIT;
+
+	GError *err = _list_loop(&args, &in, &out, tree_prefixes, &objects,
+			_pack, TRUE);
+	g_assert_no_error(err);
+	g_assert_false(out.truncated);
+
+	GString *json = g_string_new("");
+	GBytes *page;
+	while ((page = g_queue_pop_head(&objects))) {
+		g_string_append_len(json, g_bytes_get_data(page, NULL),
+				g_bytes_get_size(page));
+		g_bytes_unref(page);
+	}
+	const gchar *cursor = json->str;
+	for (const gchar **pn = names; *pn; pn++) {
+		gchar *needle = g_strdup_printf("\"name\":\"%s\"", *pn);
+		const gchar *found = strstr(cursor, needle);
+		g_assert_nonnull(found);
+		cursor = found + strlen(needle);
+		g_assert_null(strstr(cursor, needle));
+		g_free(needle);
+	}
+	g_string_free(json, TRUE);
+
+	/* The pages are requested in order by a single thread: the prefetches
+	 * cancelled have been run before the last page was received. */
+	g_mutex_lock(&requests_lock);
+	g_assert_cmpuint(requests->len, ==,
+			g_strv_length((gchar**)expected_requests));
+	for (guint i = 0; i < requests->len; i++)
+		g_assert_cmpstr(requests->pdata[i], ==, expected_requests[i]);
+	g_mutex_unlock(&requests_lock);
+
+	g_tree_destroy(tree_prefixes);
+	m2v2_list_result_clean(&out);
+	g_tree_destroy(rq.tree_headers);
+}
+
+static void
+test_prefetch_reused(void)
+{
+	page_size = 1000;
+	shard_version_marker = NULL;
+	hold_marker = NULL;
+	/* Only the first shard is listed by the loop, the pages of the others
+	 * have been prefetched while the first was received. */
+	const gchar *expected[] = {
+		"loop:|", "prefetch:a9|", "prefetch:b9|", NULL
+	};
+	_check_list(expected);
+	g_assert_cmpuint(nb_cancelled, ==, 0);
+}
+
+static void
+test_prefetch_version_marker(void)
+{
+	page_size = 1000;
+	shard_version_marker = "7";
+	hold_marker = NULL;
+	/* The prefetched pages carry the version marker the loop would send */
+	const gchar *expected[] = {
+		"loop:|", "prefetch:a9|7", "prefetch:b9|7", NULL
+	};
+	_check_list(expected);
+	g_assert_cmpuint(nb_cancelled, ==, 0);
+}
+
+static void
+test_prefetch_cancelled(void)
+{
+	page_size = 3;
+	shard_version_marker = NULL;
+	hold_marker = "b9";
+	/* The second shard does not fit in a page: the loop must go on in it,
+	 * the page prefetched from the third shard is dropped before being
+	 * requested, then requested again once the second shard is exhausted. */
+	const gchar *expected[] = {
+		"loop:|", "prefetch:a9|", "loop:b2|", "prefetch:b9|", NULL
+	};
+	_check_list(expected);
+	g_assert_cmpuint(nb_cancelled, ==, 1);
+}
+
+int
+main(int argc, char **argv)
+{
+	HC_TEST_INIT(argc,argv);
+	requests = g_ptr_array_new_with_free_func(g_free);
+	list_url = oio_url_init("NS/ACCT/JFS//");
+	proxy_list_prefetch_shards = NB_SHARDS;
+	/* A single thread: the prefetched pages are requested in order */
+	list_prefetch_pool = g_thread_pool_new(_test_prefetch_worker, NULL,
+			1, FALSE, NULL);
+	g_test_add_func("/proxy/list/prefetch_reused", test_prefetch_reused);
+	g_test_add_func("/proxy/list/prefetch_version_marker",
+			test_prefetch_version_marker);
+	g_test_add_func("/proxy/list/prefetch_cancelled", test_prefetch_cancelled);
+	int rc = g_test_run();
+	g_thread_pool_free(list_prefetch_pool, FALSE, TRUE);
+	oio_url_clean(list_url);
+	g_ptr_array_free(requests, TRUE);
+	return rc;
+}
@@ -168,6 +168,188 @@ test_limit (void)
 	}
 }
 
+/* The soft limit applies to the whole cache, whatever the shards of the
+ * bases, and the idle bases of the other shards are recycled. */
+static void
+test_limit_shards(void)
+{
+	const guint hard0 = sqliterepo_repo_max_bases_hard;
+	const guint soft0 = sqliterepo_repo_max_bases_soft;
+	sqliterepo_repo_max_bases_hard = 1024;
+	sqliterepo_repo_max_bases_soft = 2;
+	sqlx_cache_t *cache = sqlx_cache_init();
+	g_assert_nonnull(cache);
+	sqlx_cache_set_close_hook(cache, sqlite_close);
+
+	/* Leaves 2 idle bases */
+	_test_cache_limit(cache, sqliterepo_repo_max_bases_soft);
+
+	for (guint i = 0; i < 64; i++) {
+		gchar name[16];
+		g_snprintf(name, sizeof(name), "other-%u", i);
+		hashstr_t *hname = hashstr_create(name);
+		gint id = -1;
+		GError *err = sqlx_cache_open_and_lock_base(
+				cache, hname, FALSE, &id, 0);
+		g_assert_no_error(err);
+		err = sqlx_cache_unlock_and_close_base(cache, id, 0);
+		g_assert_no_error(err);
+		g_free(hname);
+
+		struct cache_counts_s count = sqlx_cache_count(cache);
+		g_assert_cmpuint(count.used + count.cold + count.hot, <=,
+				sqliterepo_repo_max_bases_soft);
+	}
+
+	sqlx_cache_expire(cache, 0, 0);
+	sqlx_cache_clean(cache);
+	sqliterepo_repo_max_bases_hard = hard0;
+	sqliterepo_repo_max_bases_soft = soft0;
+}
+
+static gpointer
+_yield_worker(gpointer p)
+{
+	sqlx_cache_t *cache = p;
+	hashstr_t *hn0 = NULL;
+	HASHSTR_ALLOCA(hn0, name0);
+
+	gint id = -1;
+	GError *err = sqlx_cache_open_and_lock_base(cache, hn0, FALSE, &id, 0);
+	g_assert_no_error(err);
+	err = sqlx_cache_unlock_and_close_base(cache, id, 0);
+	g_assert_no_error(err);
+	return GINT_TO_POINTER(id);
+}
+
+static volatile gint count_unlocks = 0;
+
+static void
+sqlite_unlock(gpointer handle)
+{
+	g_debug("Unlocking base with handle %p", handle);
+	g_atomic_int_inc(&count_unlocks);
+}
+
+/* A base yielded by its owner can be locked by another thread, and stays
+ * open until the owner reclaims then closes it. */
+static void
+test_yield(void)
+{
+	sqlx_cache_t *cache = sqlx_cache_init();
+	g_assert_nonnull(cache);
+	sqlx_cache_set_close_hook(cache, sqlite_close);
+	sqlx_cache_set_unlock_hook(cache, sqlite_unlock);
+	count_unlocks = 0;
+
+	hashstr_t *hn0 = NULL;
+	HASHSTR_ALLOCA(hn0, name0);
+
+	gint id0 = -1, id1 = -1;
+	GError *err = sqlx_cache_open_and_lock_base(cache, hn0, FALSE, &id0, 0);
+	g_assert_no_error(err);
+	err = sqlx_cache_open_and_lock_base(cache, hn0, FALSE, &id1, 0);
+	g_assert_no_error(err);
+	g_assert_cmpint(id0, ==, id1);
+
+	guint32 count_open = 0;
+	err = sqlx_cache_yield_base(cache, id0, &count_open);
+	g_assert_no_error(err);
+	g_assert_cmpuint(count_open, ==, 2);
+
+	/* Not owned anymore */
+	err = sqlx_cache_yield_base(cache, id0, &count_open);
+	g_assert_error(err, GQ(), CODE_INTERNAL_ERROR);
+	g_clear_error(&err);
+
+	for (int i = 0; i < 3; i++) {
+		GThread *th = g_thread_new("yield", _yield_worker, cache);
+		g_assert_cmpint(GPOINTER_TO_INT(g_thread_join(th)), ==, id0);
+	}
+	/* Each borrower released the base, though it stays open */
+	g_assert_cmpint(g_atomic_int_get(&count_unlocks), ==, 3);
+
+	sqlx_cache_reclaim_base(cache, id0, count_open);
+	for (int i = 0; i < 2; i++) {
+		err = sqlx_cache_unlock_and_close_base(cache, id0, 0);
+		g_assert_no_error(err);
+	}
+	g_assert_cmpint(g_atomic_int_get(&count_unlocks), ==, 4);
+	err = sqlx_cache_unlock_and_close_base(cache, id0, 0);
+	g_assert_error(err, GQ(), CODE_INTERNAL_ERROR);
+	g_clear_error(&err);
+
+	sqlx_cache_expire(cache, 0, 0);
+	sqlx_cache_clean(cache);
+}
+
+#define BENCH_NAMES 4096
+
+struct contention_s
+{
+	sqlx_cache_t *cache;
+	hashstr_t **names;
+	guint rounds;
+};
+
+static gpointer
+_contention_worker(gpointer p)
+{
+	struct contention_s *ctx = p;
+	GRand *r = g_rand_new();
+	for (guint i = 0; i < ctx->rounds; i++) {
+		hashstr_t *hn = ctx->names[g_rand_int_range(r, 0, BENCH_NAMES)];
+		gint bd = -1;
+		GError *err = sqlx_cache_open_and_lock_base(
+				ctx->cache, hn, FALSE, &bd, 0);
+		g_assert_no_error(err);
+		err = sqlx_cache_unlock_and_close_base(ctx->cache, bd, 0);
+		g_assert_no_error(err);
+	}
+	g_rand_free(r);
+	return NULL;
+}
+
+/* Several threads open and close random bases, once with a single shard
+ * (i.e. a cache-wide lock) then with the default number of shards. */
+static void
+test_contention(void)
+{
+	const guint nb_threads = 8;
+	const guint shards[] = {1, _cache_shards};
+	hashstr_t *names[BENCH_NAMES];
+	for (guint i = 0; i < BENCH_NAMES; i++)
+		names[i] = hashstr_printf("base-%u", i);
+
+	/* All the names fit in the cache, no open may fail */
+	sqliterepo_repo_max_bases_hard = 8192;
+	sqliterepo_repo_max_bases_soft = 8192;
+	for (guint i = 0; i < G_N_ELEMENTS(shards); i++) {
+		_cache_shards = shards[i];
+		struct contention_s ctx = {
+			.cache = sqlx_cache_init(), .names = names, .rounds = 50000,
+		};
+		sqlx_cache_set_close_hook(ctx.cache, sqlite_close);
+
+		GThread *threads[nb_threads];
+		g_test_timer_start();
+		for (guint t = 0; t < nb_threads; t++)
+			threads[t] = g_thread_new("bench", _contention_worker, &ctx);
+		for (guint t = 0; t < nb_threads; t++)
+			g_thread_join(threads[t]);
+		const gdouble elapsed = g_test_timer_elapsed();
+
+		const gdouble rate = nb_threads * ctx.rounds / elapsed;
+		g_test_maximized_result(rate, "%.0f open+close/s with %u shard(s)",
+				rate, shards[i]);
+		sqlx_cache_clean(ctx.cache);
+	}
+	_cache_shards = shards[G_N_ELEMENTS(shards) - 1];
+
+	for (guint i = 0; i < BENCH_NAMES; i++)
+		g_free(names[i]);
+}
+
 int
 main(int argc, char ** argv)
 {
@@ -175,6 +357,10 @@ main(int argc, char ** argv)
 	g_test_add_func("/sqliterepo/cache/init", test_init);
 	g_test_add_func("/sqliterepo/cache/lock", test_lock);
 	g_test_add_func("/sqliterepo/cache/limit", test_limit);
+	g_test_add_func("/sqliterepo/cache/limit_shards", test_limit_shards);
+	g_test_add_func("/sqliterepo/cache/yield", test_yield);
+	if (g_test_perf())
+		g_test_add_func("/sqliterepo/cache/contention", test_contention);
 	return g_test_run();
 }
 
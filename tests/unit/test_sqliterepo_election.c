@@ -43,9 +43,10 @@ static gint64 _get_real (void) { return CLOCK; }
 static struct election_member_s *
 manager_get_member (struct election_manager_s *m, const char *k)
 {
-	_manager_lock(m);
-	struct election_member_s *member = _LOCKED_get_member (m, k);
-	_manager_unlock(m);
+	struct election_shard_s *shard = _manager_get_shard(m, k, strlen(k));
+	_shard_lock(shard);
+	struct election_member_s *member = _LOCKED_get_member (shard, k);
+	_shard_unlock(shard);
 	return member;
 }
 
@@ -521,6 +522,47 @@ test_election_init(void)
 	sqlx_sync_clear (sync);
 }
 
+static void
+test_election_shards(void)
+{
+	struct replication_config_s cfg = {
+		_get_id, _get_peers, _get_vers, NULL, ELECTION_MODE_GROUP};
+	struct sqlx_sync_s *sync = _sync_factory__noop ();
+	struct sqlx_peering_s *peering = _peering_noop ();
+	struct election_manager_s *m = NULL;
+
+	g_assert_no_error(election_manager_create(&cfg, &m));
+	election_manager_add_sync(m, sync);
+	election_manager_set_peering (m, peering);
+
+	for (int i=0; i<64 ;++i) {
+		struct sqlx_name_inline_s n0 = {.ns="NS", .base="", .type="type",
+				.suffix=""};
+		g_snprintf(n0.base, sizeof(n0.base), "base-%d", i);
+		NAME2CONST(n, n0);
+		g_assert_no_error(_election_init(m, &n, NULL, NULL, NULL));
+
+		/* The member is held by the shard its key maps to */
+		gchar k[OIO_ELECTION_KEY_LIMIT_LENGTH];
+		sqliterepo_hash_name(&n, k, sizeof(k));
+		struct election_member_s *member = manager_get_member(m, k);
+		g_assert_nonnull(member);
+		g_assert_true(member->shard == _manager_get_shard(m, k, strlen(k)));
+		member_unref(member);
+	}
+
+	struct election_counts_s count = election_manager_count(m);
+	g_assert_cmpuint(count.total, ==, 64);
+	guint total = 0;
+	for (guint i=0; i<ELECTION_SHARDS ;++i)
+		total += g_tree_nnodes(m->shards[i].members_by_key);
+	g_assert_cmpuint(total, ==, 64);
+
+	election_manager_clean (m);
+	sqlx_peering__destroy (peering);
+	sqlx_sync_clear (sync);
+}
+
 static void
 test_create_ok(void)
 {
@@ -2078,6 +2120,7 @@ main(int argc, char **argv)
 	g_test_add_func("/sqlx/election/create_bad_config", test_create_bad_config);
 	g_test_add_func("/sqlx/election/create_ok", test_create_ok);
 	g_test_add_func("/sqlx/election/election_init", test_election_init);
+	g_test_add_func("/sqlx/election/shards", test_election_shards);
 	g_test_add_func("/sqlx/election/step/NONE", test_STEP_NONE);
 	g_test_add_func("/sqlx/election/step/PEERING", test_STEP_PEERING);
 	g_test_add_func("/sqlx/election/step/CREATING", test_STEP_CREATING);
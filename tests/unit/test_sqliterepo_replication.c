@@ -0,0 +1,729 @@
+/*
+OpenIO SDS unit tests
+Copyright (C) 2025 OVH SAS
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 3.0 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+*/
+
+#include <glib.h>
+
+#include <metautils/lib/metautils.h>
+#include <sqliterepo/sqliterepo.h>
+#include <sqliterepo/election.h>
+#include <sqliterepo/sqlx_remote.h>
+
+/* The slave side, as is */
+#include "../../sqliterepo/replication_dispatcher.c"
+
+/* The master side sends its changes to fake peers, and never leaves a
+ * real election. */
+static const char * _fake_get_local(const struct election_manager_s *m);
+static enum election_mode_e _fake_get_mode(const struct election_manager_s *m);
+static enum election_status_e _fake_get_status_nowait(
+		struct election_manager_s *manager, const struct sqlx_name_s *n);
+static GError * _fake_exit(struct election_manager_s *manager,
+		const struct sqlx_name_s *n);
+static GError * _fake_has_peers(struct election_manager_s *m,
+		const struct sqlx_name_s *n, gboolean nocache, gboolean *ppresent);
+static GError * _fake_get_peers(struct election_manager_s *m,
+		const struct sqlx_name_s *n, guint32 flags, gchar ***result);
+static gboolean _fake_replication_configured(
+		const struct sqlx_repository_s *r);
+static GError * _fake_restore(gchar **targets, struct sqlx_name_s *name,
+		GByteArray *dump, const gchar *compression, const gchar *local_addr,
+		gint64 deadline);
+static GError * _fake_dump(struct sqlx_sqlite3_s *sq3, gint check_type,
+		GByteArray **dump);
+static GByteArray * _fake_pack_REPLICATE(const struct sqlx_name_s *name,
+		struct TableSequence *tabseq, const gchar *local_addr,
+		gint64 deadline);
+static GByteArray * _fake_pack_REPLICATE_MANY(const struct sqlx_name_s *name,
+		struct TableSequence **tabseqs, guint count, const gchar *local_addr,
+		gint64 deadline, GError **err);
+static struct gridd_client_s ** _fake_create_many(gchar **targets,
+		GByteArray *request, gpointer ctx, client_on_reply cb);
+static void _fake_clients_noop(struct gridd_client_s **clients);
+static void _fake_clients_timeout(struct gridd_client_s **clients,
+		gdouble seconds);
+static GError * _fake_clients_loop(struct gridd_client_s **clients);
+static GError * _fake_client_error(struct gridd_client_s *self);
+static const gchar * _fake_client_url(struct gridd_client_s *self);
+
+#undef election_exit
+#define election_manager_get_local _fake_get_local
+#define election_manager_get_mode _fake_get_mode
+#define election_get_status_nowait _fake_get_status_nowait
+#define election_exit _fake_exit
+#define election_has_peers _fake_has_peers
+#define election_get_peers _fake_get_peers
+#define sqlx_repository_replication_configured _fake_replication_configured
+#define peers_restore _fake_restore
+#define sqlx_repository_dump_base_gba _fake_dump
+#define sqlx_pack_REPLICATE _fake_pack_REPLICATE
+#define sqlx_pack_REPLICATE_MANY _fake_pack_REPLICATE_MANY
+#define gridd_client_create_many _fake_create_many
+#define gridd_clients_free _fake_clients_noop
+#define gridd_clients_start _fake_clients_noop
+#define gridd_clients_set_timeout _fake_clients_timeout
+#define gridd_clients_set_timeout_cnx _fake_clients_timeout
+#define gridd_clients_loop _fake_clients_loop
+#define gridd_client_error _fake_client_error
+#define gridd_client_url _fake_client_url
+#include "../../sqliterepo/replication.c"
+
+#define SCHEMA \
+	"CREATE TABLE IF NOT EXISTS admin (k TEXT PRIMARY KEY, v NOT NULL);" \
+	"CREATE TABLE IF NOT EXISTS content (" \
+	" path TEXT NOT NULL PRIMARY KEY," \
+	" size INTEGER NOT NULL" \
+	")"
+
+static const gchar nsname[] = "NS";
+static const gchar type[] = NAME_SRVTYPE_META2;
+static const gchar name[] =
+		"0123456789ABCDEF"
+		"0123456789ABCDEF"
+		"0123456789ABCDEF"
+		"0123456789ABCDEF";
+
+static GMutex lock = {0};
+
+/* What the fake peers do */
+static gchar *peer_urls[] = {"127.0.0.1:6001", "127.0.0.1:6002", NULL};
+static guint nb_peers = 1;
+static gint peer_codes[2] = {0};
+static gboolean pack_fails = FALSE;
+static gulong peer_delay = 0;
+
+/* What the fake peers have seen */
+static GArray *batches = NULL;
+static gint64 last_deadline = 0;
+static guint nb_exits = 0;
+static guint nb_restores = 0;
+static gchar *last_restored = NULL;
+
+static const char *
+_fake_get_local(const struct election_manager_s *m UNUSED)
+{
+	return "127.0.0.1:6000";
+}
+
+static enum election_mode_e
+_fake_get_mode(const struct election_manager_s *m UNUSED)
+{
+	return ELECTION_MODE_QUORUM;
+}
+
+static enum election_status_e
+_fake_get_status_nowait(struct election_manager_s *manager UNUSED,
+		const struct sqlx_name_s *n UNUSED)
+{
+	return ELECTION_LEADER;
+}
+
+static GError *
+_fake_exit(struct election_manager_s *manager UNUSED,
+		const struct sqlx_name_s *n UNUSED)
+{
+	g_mutex_lock(&lock);
+	nb_exits ++;
+	g_mutex_unlock(&lock);
+	return NULL;
+}
+
+static GError *
+_fake_has_peers(struct election_manager_s *m UNUSED,
+		const struct sqlx_name_s *n UNUSED, gboolean nocache UNUSED,
+		gboolean *ppresent)
+{
+	*ppresent = TRUE;
+	return NULL;
+}
+
+static GError *
+_fake_get_peers(struct election_manager_s *m UNUSED,
+		const struct sqlx_name_s *n UNUSED, guint32 flags UNUSED,
+		gchar ***result)
+{
+	gchar **peers = g_malloc0((nb_peers + 1) * sizeof(gchar*));
+	for (guint i = 0; i < nb_peers; i++)
+		peers[i] = g_strdup(peer_urls[i]);
+	*result = peers;
+	return NULL;
+}
+
+static gboolean
+_fake_replication_configured(const struct sqlx_repository_s *r UNUSED)
+{
+	return TRUE;
+}
+
+static GError *
+_fake_restore(gchar **targets, struct sqlx_name_s *n UNUSED,
+		GByteArray *dump, const gchar *compression UNUSED,
+		const gchar *local_addr UNUSED, gint64 deadline UNUSED)
+{
+	g_mutex_lock(&lock);
+	nb_restores ++;
+	g_free(last_restored);
+	last_restored = g_strjoinv(",", targets);
+	g_mutex_unlock(&lock);
+	g_byte_array_unref(dump);
+	return NULL;
+}
+
+static GError *
+_fake_dump(struct sqlx_sqlite3_s *sq3 UNUSED, gint check_type UNUSED,
+		GByteArray **dump)
+{
+	*dump = g_byte_array_new();
+	return NULL;
+}
+
+static void
+_record_batch(guint count, gint64 deadline)
+{
+	g_mutex_lock(&lock);
+	g_array_append_val(batches, count);
+	last_deadline = deadline;
+	g_mutex_unlock(&lock);
+}
+
+static GByteArray *
+_fake_pack_REPLICATE(const struct sqlx_name_s *n UNUSED,
+		struct TableSequence *tabseq UNUSED, const gchar *local_addr UNUSED,
+		gint64 deadline)
+{
+	_record_batch(1, deadline);
+	return g_byte_array_new();
+}
+
+static GByteArray *
+_fake_pack_REPLICATE_MANY(const struct sqlx_name_s *n UNUSED,
+		struct TableSequence **tabseqs UNUSED, guint count,
+		const gchar *local_addr UNUSED, gint64 deadline, GError **err)
+{
+	if (pack_fails) {
+		*err = SYSERR("Sequence 1/%u: TableSequence encoding error", count);
+		return NULL;
+	}
+	_record_batch(count, deadline);
+	return g_byte_array_new();
+}
+
+/* One fake client per peer, pointing to the code it replies */
+static struct gridd_client_s ** _fake_create_many(gchar **targets,
+		GByteArray *request UNUSED, gpointer ctx UNUSED,
+		client_on_reply cb UNUSED)
+{
+	static struct gridd_client_s *clients[3] = {NULL};
+	const guint count = g_strv_length(targets);
+	g_assert_cmpuint(count, <=, G_N_ELEMENTS(peer_codes));
+	for (guint i = 0; i < count; i++)
+		clients[i] = (struct gridd_client_s*) &peer_codes[i];
+	clients[count] = NULL;
+	return clients;
+}
+
+static void _fake_clients_noop(struct gridd_client_s **clients UNUSED) {}
+
+static void _fake_clients_timeout(struct gridd_client_s **clients UNUSED,
+		gdouble seconds UNUSED) {}
+
+static GError *
+_fake_clients_loop(struct gridd_client_s **clients UNUSED)
+{
+	if (peer_delay > 0)
+		g_usleep(peer_delay);
+	return NULL;
+}
+
+static GError *
+_fake_client_error(struct gridd_client_s *self)
+{
+	const gint code = *(gint*)self;
+	return code ? NEWERROR(code, "peer failed") : NULL;
+}
+
+static const gchar *
+_fake_client_url(struct gridd_client_s *self)
+{
+	return peer_urls[(gint*)self - peer_codes];
+}
+
+static void
+_locator(gpointer u UNUSED, const struct sqlx_name_s *n UNUSED,
+		GString *file_name)
+{
+	g_string_assign(file_name, ":memory:");
+}
+
+static sqlx_repository_t *
+_repo_init(void)
+{
+	struct sqlx_repo_config_s cfg = {0};
+	sqlx_repository_t *repo = NULL;
+	GError *err = sqlx_repository_init("/tmp", &cfg, &repo);
+	g_assert_no_error(err);
+	err = sqlx_repository_configure_type(repo, type, SCHEMA);
+	g_assert_no_error(err);
+	sqlx_repository_set_locator(repo, _locator, NULL);
+	return repo;
+}
+
+static struct sqlx_sqlite3_s *
+_open(sqlx_repository_t *repo)
+{
+	struct sqlx_sqlite3_s *sq3 = NULL;
+	struct sqlx_name_s n = {.base=name, .type=type, .ns=nsname, .suffix=""};
+	GError *err = sqlx_repository_open_and_lock(
+			repo, &n, SQLX_OPEN_LOCAL, &sq3, NULL);
+	g_assert_no_error(err);
+	g_assert_nonnull(sq3);
+	return sq3;
+}
+
+static void
+_reset_peers(void)
+{
+	nb_peers = 1;
+	memset(peer_codes, 0, sizeof(peer_codes));
+	pack_fails = FALSE;
+	peer_delay = 0;
+	last_deadline = 0;
+	nb_exits = nb_restores = 0;
+	g_free(last_restored);
+	last_restored = NULL;
+	if (batches)
+		g_array_free(batches, TRUE);
+	batches = g_array_new(FALSE, TRUE, sizeof(guint));
+}
+
+/* Slave side -------------------------------------------------------------- */
+
+static Table_t *
+_add_table(TableSequence_t *seq, const gchar *tname,
+		const gchar *c0, const gchar *c1)
+{
+	Table_t *t = ASN1C_CALLOC(1, sizeof(*t));
+	OCTET_STRING_fromBuf(&(t->name), tname, strlen(tname));
+	const gchar *columns[] = {c0, c1};
+	for (guint i = 0; i < G_N_ELEMENTS(columns); i++) {
+		struct RowName *rname = ASN1C_CALLOC(1, sizeof(*rname));
+		metautils_asn_uint32_to_INTEGER(&(rname->pos), i);
+		OCTET_STRING_fromBuf(&(rname->name), columns[i], strlen(columns[i]));
+		asn_sequence_add(&(t->header.list), rname);
+	}
+	asn_sequence_add(&(seq->list), t);
+	return t;
+}
+
+static void
+_add_row(Table_t *t, gint64 rowid, const gchar *s, const gchar *b, gint64 i)
+{
+	struct Row *row = ASN1C_CALLOC(1, sizeof(*row));
+	metautils_asn_int64_to_INTEGER(&(row->rowid), rowid);
+	row->fields = ASN1C_CALLOC(1, sizeof(struct RowFieldSequence));
+
+	struct RowField *rf = ASN1C_CALLOC(1, sizeof(*rf));
+	metautils_asn_uint32_to_INTEGER(&(rf->pos), 0);
+	rf->value.present = RowFieldValue_PR_s;
+	OCTET_STRING_fromBuf(&(rf->value.choice.s), s, strlen(s));
+	asn_sequence_add(&(row->fields->list), rf);
+
+	rf = ASN1C_CALLOC(1, sizeof(*rf));
+	metautils_asn_uint32_to_INTEGER(&(rf->pos), 1);
+	if (b) {
+		rf->value.present = RowFieldValue_PR_b;
+		OCTET_STRING_fromBuf(&(rf->value.choice.b), b, strlen(b));
+	} else {
+		rf->value.present = RowFieldValue_PR_i;
+		metautils_asn_int64_to_INTEGER(&(rf->value.choice.i), i);
+	}
+	asn_sequence_add(&(row->fields->list), rf);
+
+	asn_sequence_add(&(t->rows.list), row);
+}
+
+static gint64
+_admin_rowid(struct sqlx_sqlite3_s *sq3, const gchar *k)
+{
+	sqlite3_stmt *stmt = NULL;
+	int rc = sqlite3_prepare_v2(sq3->db,
+			"SELECT ROWID FROM admin WHERE k = ?", -1, &stmt, NULL);
+	g_assert_cmpint(rc, ==, SQLITE_OK);
+	sqlite3_bind_text(stmt, 1, k, -1, NULL);
+	g_assert_cmpint(sqlite3_step(stmt), ==, SQLITE_ROW);
+	const gint64 rowid = sqlite3_column_int64(stmt, 0);
+	sqlite3_finalize(stmt);
+	return rowid;
+}
+
+static gint64
+_count_contents(struct sqlx_sqlite3_s *sq3)
+{
+	sqlite3_stmt *stmt = NULL;
+	int rc = sqlite3_prepare_v2(sq3->db,
+			"SELECT COUNT(*) FROM content", -1, &stmt, NULL);
+	g_assert_cmpint(rc, ==, SQLITE_OK);
+	g_assert_cmpint(sqlite3_step(stmt), ==, SQLITE_ROW);
+	const gint64 count = sqlite3_column_int64(stmt, 0);
+	sqlite3_finalize(stmt);
+	return count;
+}
+
+/* The changes of one transaction of the master: a content and the new
+ * versions of the tables it touched. */
+static void
+_append_encoded_seq(struct sqlx_sqlite3_s *sq3, GByteArray *body,
+		gint64 rowid, gint64 version)
+{
+	TableSequence_t seq = {{0}};
+	gchar path[32], v[32];
+	g_snprintf(path, sizeof(path), "path-%"G_GINT64_FORMAT, rowid);
+	g_snprintf(v, sizeof(v), "%"G_GINT64_FORMAT":0", version);
+
+	Table_t *t = _add_table(&seq, "main.content", "path", "size");
+	_add_row(t, rowid, path, NULL, rowid);
+	t = _add_table(&seq, "main.admin", "k", "v");
+	_add_row(t, _admin_rowid(sq3, "version:main.admin"),
+			"version:main.admin", v, 0);
+	_add_row(t, _admin_rowid(sq3, "version:main.content"),
+			"version:main.content", v, 0);
+
+	GByteArray *encoded = sqlx_encode_TableSequence(&seq, NULL);
+	g_assert_nonnull(encoded);
+	g_byte_array_append(body, encoded->data, encoded->len);
+	g_byte_array_unref(encoded);
+	asn_DEF_TableSequence.free_struct(&asn_DEF_TableSequence, &seq, TRUE);
+}
+
+static void
+_check_version(struct sqlx_sqlite3_s *sq3, const gchar *expected)
+{
+	gchar *v = sqlx_admin_get_str(sq3, "version:main.content");
+	g_assert_cmpstr(v, ==, expected);
+	g_free(v);
+}
+
+/* The sequences of a DB_REPLI_MANY are all applied, in order */
+static void
+test_parse_many(void)
+{
+	sqlx_repository_t *repo = _repo_init();
+	struct sqlx_sqlite3_s *sq3 = _open(repo);
+	_check_version(sq3, "1:0");
+
+	GByteArray *body = g_byte_array_new();
+	for (gint64 i = 1; i <= 3; i++)
+		_append_encoded_seq(sq3, body, i, 1 + i);
+
+	GError *err = replicate_body_parse(sq3, body->data, body->len, TRUE);
+	g_assert_no_error(err);
+	g_assert_cmpint(_count_contents(sq3), ==, 3);
+	_check_version(sq3, "4:0");
+
+	/* A DB_REPLI only considers the first sequence */
+	g_byte_array_set_size(body, 0);
+	_append_encoded_seq(sq3, body, 4, 5);
+	_append_encoded_seq(sq3, body, 5, 6);
+	err = replicate_body_parse(sq3, body->data, body->len, FALSE);
+	g_assert_no_error(err);
+	g_assert_cmpint(_count_contents(sq3), ==, 4);
+	_check_version(sq3, "5:0");
+
+	g_byte_array_unref(body);
+	sqlx_repository_unlock_and_close_noerror(sq3);
+	sqlx_repository_clean(repo);
+}
+
+/* If one sequence does not apply, none of them is */
+static void
+test_parse_many_mismatch(void)
+{
+	sqlx_repository_t *repo = _repo_init();
+	struct sqlx_sqlite3_s *sq3 = _open(repo);
+
+	GByteArray *body = g_byte_array_new();
+	_append_encoded_seq(sq3, body, 1, 2);
+	_append_encoded_seq(sq3, body, 2, 3);
+	/* The master went on without telling us */
+	_append_encoded_seq(sq3, body, 3, 6);
+
+	GError *err = replicate_body_parse(sq3, body->data, body->len, TRUE);
+	g_assert_error(err, GQ(), CODE_PIPEFROM);
+	g_clear_error(&err);
+	g_assert_cmpint(_count_contents(sq3), ==, 0);
+	_check_version(sq3, "1:0");
+
+	/* A truncated body is rejected as a whole */
+	g_byte_array_set_size(body, 0);
+	_append_encoded_seq(sq3, body, 1, 2);
+	_append_encoded_seq(sq3, body, 2, 3);
+	err = replicate_body_parse(sq3, body->data, body->len - 4, TRUE);
+	g_assert_error(err, GQ(), CODE_BAD_REQUEST);
+	g_clear_error(&err);
+	g_assert_cmpint(_count_contents(sq3), ==, 0);
+	_check_version(sq3, "1:0");
+
+	g_byte_array_unref(body);
+	sqlx_repository_unlock_and_close_noerror(sq3);
+	sqlx_repository_clean(repo);
+}
+
+/* Master side ------------------------------------------------------------- */
+
+struct worker_s
+{
+	sqlx_repository_t *repo;
+	guint index;
+};
+
+static gint next_path = 0;
+static guint rollback_index = G_MAXUINT;
+
+/* As a request does: open the base, run a transaction then close. The
+ * transactions run meanwhile are replicated then committed together. */
+static gpointer
+_group_worker(gpointer p)
+{
+	struct worker_s *w = p;
+	struct sqlx_sqlite3_s *sq3 = _open(w->repo);
+	/* As a MASTERONLY opening does */
+	sq3->election = ELECTION_LEADER;
+
+	struct sqlx_repctx_s *ctx = NULL;
+	GError *err = sqlx_transaction_begin(sq3, &ctx);
+	g_assert_no_error(err);
+	gchar sql[128];
+	g_snprintf(sql, sizeof(sql),
+			"INSERT INTO content (path, size) VALUES ('path-%d', %u)",
+			g_atomic_int_add(&next_path, 1), w->index);
+	g_assert_cmpint(sqlx_exec(sq3->db, sql), ==, SQLITE_OK);
+	if (w->index == rollback_index)
+		err = sqlx_transaction_rollback(ctx, NULL);
+	else
+		err = sqlx_transaction_end(ctx, NULL);
+
+	/* The requests that borrowed the base reset it */
+	g_assert_cmpint(sq3->election, ==, ELECTION_LEADER);
+	sqlx_repository_unlock_and_close_noerror(sq3);
+	return err;
+}
+
+static void
+_run_workers(sqlx_repository_t *repo, guint nb, GError **errors)
+{
+	GThread *threads[nb];
+	struct worker_s workers[nb];
+	for (guint i = 0; i < nb; i++) {
+		workers[i].repo = repo;
+		workers[i].index = i;
+		threads[i] = g_thread_new("repli", _group_worker, &workers[i]);
+	}
+	for (guint i = 0; i < nb; i++)
+		errors[i] = g_thread_join(threads[i]);
+}
+
+static gint64
+_count_contents_of(sqlx_repository_t *repo)
+{
+	struct sqlx_sqlite3_s *sq3 = _open(repo);
+	g_assert_true(sqlite3_get_autocommit(sq3->db));
+	const gint64 count = _count_contents(sq3);
+	sqlx_repository_unlock_and_close_noerror(sq3);
+	return count;
+}
+
+/* The transactions run meanwhile are sent together by one of their
+ * threads, the others wait for the outcome. */
+static void
+test_group_leader(void)
+{
+	const guint nb = 8;
+	GError *errors[nb];
+
+	_reset_peers();
+	peer_delay = 20 * G_TIME_SPAN_MILLISECOND;
+	sqliterepo_repli_group_commit_delay = G_TIME_SPAN_SECOND;
+	sqliterepo_repli_group_commit_max = 4;
+	rollback_index = 1;
+
+	sqlx_repository_t *repo = _repo_init();
+	_run_workers(repo, nb, errors);
+
+	guint total = 0;
+	for (guint i = 0; i < batches->len; i++) {
+		const guint count = g_array_index(batches, guint, i);
+		g_assert_cmpuint(count, >, 0);
+		total += count;
+	}
+	/* The rolled back transaction is not sent */
+	g_assert_cmpuint(total, ==, nb - 1);
+	g_assert_cmpuint(batches->len, <, nb - 1);
+	for (guint i = 0; i < nb; i++)
+		g_assert_no_error(errors[i]);
+	g_assert_cmpint(_count_contents_of(repo), ==, nb - 1);
+	g_assert_cmpuint(nb_exits, ==, 0);
+	/* The group is gone with its last transaction */
+	g_assert_cmpuint(g_hash_table_size(repli_groups), ==, 0);
+
+	/* Alone, a transaction waits for the others until the delay */
+	_reset_peers();
+	rollback_index = G_MAXUINT;
+	sqliterepo_repli_group_commit_delay = 50 * G_TIME_SPAN_MILLISECOND;
+	const gint64 start = g_get_monotonic_time();
+	_run_workers(repo, 1, errors);
+	g_assert_no_error(errors[0]);
+	g_assert_cmpint(g_get_monotonic_time() - start, >=,
+			sqliterepo_repli_group_commit_delay);
+	g_assert_cmpuint(batches->len, ==, 1);
+	g_assert_cmpuint(g_array_index(batches, guint, 0), ==, 1);
+	g_assert_cmpint(_count_contents_of(repo), ==, nb);
+
+	sqlx_repository_clean(repo);
+}
+
+/* The transactions of a group without quorum are all rolled back, and
+ * each of them gets the error. */
+static void
+test_group_errors(void)
+{
+	const guint nb = 4;
+	GError *errors[nb];
+
+	_reset_peers();
+	peer_codes[0] = CODE_UNAVAILABLE;
+	sqliterepo_repli_group_commit_delay = G_TIME_SPAN_SECOND;
+	sqliterepo_repli_group_commit_max = 4;
+	rollback_index = G_MAXUINT;
+
+	sqlx_repository_t *repo = _repo_init();
+	_run_workers(repo, nb, errors);
+	for (guint i = 0; i < nb; i++) {
+		g_assert_error(errors[i], GQ(), CODE_UNAVAILABLE);
+		g_clear_error(&errors[i]);
+	}
+	g_assert_cmpint(_count_contents_of(repo), ==, 0);
+	g_assert_cmpuint(nb_exits, ==, 0);
+
+	sqlx_repository_clean(repo);
+}
+
+/* A slave that missed some changes gets the whole base, once the group
+ * is committed, and every transaction of the group succeeds. */
+static void
+test_group_resync(void)
+{
+	const guint nb = 4;
+	GError *errors[nb];
+
+	_reset_peers();
+	nb_peers = 2;
+	peer_codes[1] = CODE_PIPEFROM;
+	sqliterepo_dump_delta_extent = 0;
+	sqliterepo_dump_compression_level = 0;
+	sqliterepo_repli_group_commit_delay = G_TIME_SPAN_SECOND;
+	sqliterepo_repli_group_commit_max = 4;
+	rollback_index = G_MAXUINT;
+
+	sqlx_repository_t *repo = _repo_init();
+	_run_workers(repo, nb, errors);
+	for (guint i = 0; i < nb; i++)
+		g_assert_no_error(errors[i]);
+	g_assert_cmpint(_count_contents_of(repo), ==, nb);
+	g_assert_cmpuint(nb_restores, ==, batches->len);
+	g_assert_cmpstr(last_restored, ==, "127.0.0.1:6002");
+
+	sqlx_repository_clean(repo);
+}
+
+/* The changes of the group are committed once replicated, and rolled back
+ * if they cannot be sent. */
+static void
+test_group_flush(void)
+{
+	_reset_peers();
+	sqlx_repository_t *repo = _repo_init();
+	struct sqlx_sqlite3_s *sq3 = _open(repo);
+	struct sqlx_repctx_s ctx = {0};
+	ctx.sq3 = sq3;
+	ctx.errors = g_string_sized_new(64);
+	ctx.resync_todo = g_ptr_array_new_with_free_func(g_free);
+
+	TableSequence_t seqs[3] = {{{0}}};
+	struct repli_ticket_s tickets[3] = {{0}};
+	struct repli_ticket_s *batch[3];
+	const gint64 deadlines[3] = {0, 300, 200};
+	for (guint i = 0; i < 3; i++) {
+		tickets[i].sequence = &seqs[i];
+		tickets[i].peers = peer_urls;
+		tickets[i].deadline = deadlines[i];
+		batch[i] = &tickets[i];
+	}
+
+	/* The earliest deadline applies to the group */
+	sqlx_exec(sq3->db, "BEGIN");
+	sqlx_exec(sq3->db, "INSERT INTO content (path, size) VALUES ('a', 1)");
+	_group_flush(&ctx, batch, 3);
+	g_assert_cmpuint(batches->len, ==, 1);
+	g_assert_cmpuint(g_array_index(batches, guint, 0), ==, 3);
+	g_assert_cmpint(last_deadline, ==, 200);
+	for (guint i = 0; i < 3; i++)
+		g_assert_no_error(tickets[i].err);
+	g_assert_true(sqlite3_get_autocommit(sq3->db));
+	g_assert_cmpint(_count_contents(sq3), ==, 1);
+
+	/* A group whose sequences cannot be packed is not sent at all */
+	pack_fails = TRUE;
+	sqlx_exec(sq3->db, "BEGIN");
+	sqlx_exec(sq3->db, "INSERT INTO content (path, size) VALUES ('b', 1)");
+	_group_flush(&ctx, batch, 3);
+	g_assert_cmpuint(batches->len, ==, 1);
+	g_assert_cmpuint(nb_exits, ==, 0);
+	for (guint i = 0; i < 3; i++) {
+		g_assert_error(tickets[i].err, GQ(), CODE_INTERNAL_ERROR);
+		g_clear_error(&tickets[i].err);
+	}
+	g_assert_true(sqlite3_get_autocommit(sq3->db));
+	g_assert_cmpint(_count_contents(sq3), ==, 1);
+
+	/* Nothing is sent once the transaction of the group is lost */
+	pack_fails = FALSE;
+	_group_flush(&ctx, batch, 3);
+	g_assert_cmpuint(batches->len, ==, 1);
+	for (guint i = 0; i < 3; i++) {
+		g_assert_error(tickets[i].err, GQ(), CODE_UNAVAILABLE);
+		g_clear_error(&tickets[i].err);
+	}
+
+	g_string_free(ctx.errors, TRUE);
+	g_ptr_array_free(ctx.resync_todo, TRUE);
+	sqlx_repository_unlock_and_close_noerror(sq3);
+	sqlx_repository_clean(repo);
+}
+
+int
+main(int argc, char **argv)
+{
+	HC_TEST_INIT(argc,argv);
+	g_test_add_func("/sqliterepo/replication/parse_many", test_parse_many);
+	g_test_add_func("/sqliterepo/replication/parse_many_mismatch",
+			test_parse_many_mismatch);
+	g_test_add_func("/sqliterepo/replication/group_leader", test_group_leader);
+	g_test_add_func("/sqliterepo/replication/group_errors", test_group_errors);
+	g_test_add_func("/sqliterepo/replication/group_resync", test_group_resync);
+	g_test_add_func("/sqliterepo/replication/group_flush", test_group_flush);
+	return g_test_run();
+}
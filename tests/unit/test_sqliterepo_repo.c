@@ -20,6 +20,7 @@ License along with this library.
 
 #include <unistd.h>
 #include <stdio.h>
+#include <zlib.h>
 
 #include <metautils/lib/metautils.h>
 
@@ -134,11 +135,243 @@ test_open_close (void)
 		_round_open_close ();
 }
 
+static gint64
+_count_contents(struct sqlx_sqlite3_s *sq3, const gchar *path)
+{
+	sqlite3_stmt *stmt = NULL;
+	int rc = sqlx_sqlite3_prepare(sq3,
+			"SELECT COUNT(*) FROM content WHERE path = ?", -1, &stmt);
+	g_assert_cmpint(rc, ==, SQLITE_OK);
+	if (path)
+		sqlite3_bind_text(stmt, 1, path, -1, NULL);
+	rc = sqlite3_step(stmt);
+	g_assert_cmpint(rc, ==, SQLITE_ROW);
+	const gint64 count = sqlite3_column_int64(stmt, 0);
+	sqlx_sqlite3_release(sq3, stmt, NULL);
+	return count;
+}
+
+static void
+test_statements (void)
+{
+	struct sqlx_repo_config_s cfg = {0};
+	sqlx_repository_t *repo = NULL;
+	struct sqlx_sqlite3_s *sq3 = NULL;
+	struct sqlx_name_s n = { .base=name, .type=type, .ns=nsname, .suffix=""};
+	struct sqlx_stmt_cache_stats_s before = {0}, after = {0};
+
+	GError *err = sqlx_repository_init("/tmp", &cfg, &repo);
+	g_assert_no_error (err);
+	err = sqlx_repository_configure_type(repo, type, SCHEMA);
+	g_assert_no_error (err);
+	sqlx_repository_set_locator (repo, _locator, NULL);
+	err = sqlx_repository_open_and_lock(repo, &n, SQLX_OPEN_LOCAL, &sq3, NULL);
+	g_assert_no_error (err);
+
+	sqlx_sqlite3_stmt_cache_stats(&before);
+	for (int i=0; i<8 ;i++) {
+		gchar path[32];
+		g_snprintf(path, sizeof(path), "path-%d", i);
+		sqlite3_stmt *stmt = NULL;
+		int rc = sqlx_sqlite3_prepare(sq3,
+				"INSERT INTO content (path,size) VALUES (?,?)", -1, &stmt);
+		g_assert_cmpint(rc, ==, SQLITE_OK);
+		sqlite3_bind_text(stmt, 1, path, -1, NULL);
+		sqlite3_bind_int64(stmt, 2, i);
+		g_assert_cmpint(sqlite3_step(stmt), ==, SQLITE_DONE);
+		sqlx_sqlite3_release(sq3, stmt, NULL);
+		g_assert_cmpint(_count_contents(sq3, path), ==, 1);
+	}
+	sqlx_sqlite3_stmt_cache_stats(&after);
+	g_assert_cmpuint(after.misses - before.misses, ==, 2);
+	g_assert_cmpuint(after.hits - before.hits, ==, 14);
+
+	/* The bindings of a reused statement have been cleared */
+	g_assert_cmpint(_count_contents(sq3, NULL), ==, 0);
+
+	/* A statement in use is never given twice */
+	sqlite3_stmt *s0 = NULL, *s1 = NULL;
+	g_assert_cmpint(sqlx_sqlite3_prepare(sq3, "SELECT 1", -1, &s0), ==, SQLITE_OK);
+	g_assert_cmpint(sqlx_sqlite3_prepare(sq3, "SELECT 1", -1, &s1), ==, SQLITE_OK);
+	g_assert_true(s0 != s1);
+	sqlx_sqlite3_release(sq3, s1, NULL);
+	sqlx_sqlite3_release(sq3, s0, NULL);
+	g_assert_cmpuint(g_hash_table_size(sq3->statements), ==, 3);
+	g_assert_cmpuint(sq3->stmt_lru.length, ==, 3);
+
+	sqlx_sqlite3_clear_statements(sq3);
+	g_assert_cmpuint(g_hash_table_size(sq3->statements), ==, 0);
+	g_assert_cmpuint(sq3->stmt_lru.length, ==, 0);
+
+	err = sqlx_repository_unlock_and_close(sq3);
+	g_assert_no_error (err);
+	sqlx_repository_clean(repo);
+}
+
+static void
+_file_locator (gpointer u, const struct sqlx_name_s *n, GString *file_name)
+{
+	g_string_printf (file_name, "%s/%s.%s", (const gchar*)u, n->base, n->type);
+}
+
+static void
+_insert_contents(struct sqlx_sqlite3_s *sq3, const gchar *prefix, int count)
+{
+	for (int i=0; i<count ;i++) {
+		gchar path[64];
+		g_snprintf(path, sizeof(path), "%s-%d", prefix, i);
+		sqlite3_stmt *stmt = NULL;
+		int rc = sqlx_sqlite3_prepare(sq3,
+				"INSERT INTO content (path,size) VALUES (?,?)", -1, &stmt);
+		g_assert_cmpint(rc, ==, SQLITE_OK);
+		sqlite3_bind_text(stmt, 1, path, -1, NULL);
+		sqlite3_bind_int64(stmt, 2, i);
+		g_assert_cmpint(sqlite3_step(stmt), ==, SQLITE_DONE);
+		sqlx_sqlite3_release(sq3, stmt, NULL);
+	}
+}
+
+static void
+test_delta (void)
+{
+	struct sqlx_repo_config_s cfg = {0};
+	sqlx_repository_t *repo = NULL;
+	struct sqlx_sqlite3_s *src = NULL, *dst = NULL;
+	struct sqlx_name_s n0 = { .base=name, .type=type, .ns=nsname, .suffix=""};
+	struct sqlx_name_s n1 = { .base="FEDCBA9876543210", .type=type,
+			.ns=nsname, .suffix=""};
+	GByteArray *sums = NULL, *delta = NULL;
+
+	gchar *basedir = g_dir_make_tmp("sqlx-delta-XXXXXX", NULL);
+	g_assert_nonnull (basedir);
+	gchar *tmpdir = g_strdup_printf("%s/tmp", basedir);
+	g_assert_cmpint(g_mkdir(tmpdir, 0755), ==, 0);
+
+	GError *err = sqlx_repository_init(basedir, &cfg, &repo);
+	g_assert_no_error (err);
+	err = sqlx_repository_configure_type(repo, type, SCHEMA);
+	g_assert_no_error (err);
+	sqlx_repository_set_locator (repo, _file_locator, basedir);
+
+	err = sqlx_repository_open_and_lock(repo, &n0, SQLX_OPEN_LOCAL, &src, NULL);
+	g_assert_no_error (err);
+	err = sqlx_repository_open_and_lock(repo, &n1, SQLX_OPEN_LOCAL, &dst, NULL);
+	g_assert_no_error (err);
+
+	/* Both bases share a prefix, then diverge */
+	_insert_contents(src, "common", 512);
+	_insert_contents(dst, "common", 512);
+	_insert_contents(src, "source", 256);
+	_insert_contents(dst, "stale", 16);
+
+	err = sqlx_repository_checksum_base(dst, 4, &sums);
+	g_assert_no_error (err);
+	err = sqlx_repository_diff_base(src, 0, sums->data, sums->len, &delta);
+	g_assert_no_error (err);
+
+	/* A truncated delta is refused and leaves the base untouched */
+	err = sqlx_repository_patch_base(dst, delta->data, delta->len - 1);
+	g_assert_nonnull (err);
+	g_clear_error (&err);
+	g_assert_cmpint(_count_contents(dst, "stale-0"), ==, 1);
+
+	err = sqlx_repository_patch_base(dst, delta->data, delta->len);
+	g_assert_no_error (err);
+	g_assert_cmpint(_count_contents(dst, "stale-0"), ==, 0);
+	g_assert_cmpint(_count_contents(dst, "source-255"), ==, 1);
+	g_assert_cmpint(_count_contents(dst, "common-511"), ==, 1);
+
+	g_byte_array_unref(delta);
+	g_byte_array_unref(sums);
+	sqlx_repository_unlock_and_close_noerror(dst);
+	sqlx_repository_unlock_and_close_noerror(src);
+	sqlx_repository_clean(repo);
+	g_free(tmpdir);
+	g_free(basedir);
+}
+
+static void
+test_dump_compressed (void)
+{
+	struct sqlx_repo_config_s cfg = {0};
+	sqlx_repository_t *repo = NULL;
+	struct sqlx_sqlite3_s *sq3 = NULL, *dst = NULL;
+	struct sqlx_name_s n = { .base=name, .type=type, .ns=nsname, .suffix=""};
+	struct sqlx_name_s n1 = { .base="FEDCBA9876543210", .type=type,
+			.ns=nsname, .suffix=""};
+	GByteArray *plain = g_byte_array_new(), *packed = g_byte_array_new();
+	guint parts = 0;
+
+	GError *_collect(GByteArray *gba, gint64 remaining UNUSED, gpointer u) {
+		g_byte_array_append((GByteArray*)u, gba->data, gba->len);
+		g_byte_array_unref(gba);
+		parts ++;
+		return NULL;
+	}
+
+	gchar *basedir = g_dir_make_tmp("sqlx-dump-XXXXXX", NULL);
+	g_assert_nonnull (basedir);
+	gchar *tmpdir = g_strdup_printf("%s/tmp", basedir);
+	g_assert_cmpint(g_mkdir(tmpdir, 0755), ==, 0);
+	GError *err = sqlx_repository_init(basedir, &cfg, &repo);
+	g_assert_no_error (err);
+	err = sqlx_repository_configure_type(repo, type, SCHEMA);
+	g_assert_no_error (err);
+	sqlx_repository_set_locator (repo, _file_locator, basedir);
+	err = sqlx_repository_open_and_lock(repo, &n, SQLX_OPEN_LOCAL, &sq3, NULL);
+	g_assert_no_error (err);
+	_insert_contents(sq3, "content", 1024);
+
+	err = sqlx_repository_dump_base_chunked(sq3, 65536, 0, 0,
+			_collect, plain);
+	g_assert_no_error (err);
+	parts = 0;
+	err = sqlx_repository_dump_base_chunked(sq3, 4096, 0, 6,
+			_collect, packed);
+	g_assert_no_error (err);
+	g_assert_cmpuint(parts, >, 1);
+	g_assert_cmpuint(packed->len, <, plain->len);
+
+	/* The concatenated parts form one zlib stream of the whole dump */
+	uLongf len = plain->len;
+	guint8 *inflated = g_malloc(len);
+	g_assert_cmpint(uncompress(inflated, &len, packed->data, packed->len),
+			==, Z_OK);
+	g_assert_cmpuint(len, ==, plain->len);
+	g_assert_cmpint(memcmp(inflated, plain->data, len), ==, 0);
+
+	/* As a DB_RESTORE of a compressed dump does */
+	err = sqlx_repository_open_and_lock(repo, &n1, SQLX_OPEN_LOCAL, &dst, NULL);
+	g_assert_no_error (err);
+	_insert_contents(dst, "stale", 16);
+	err = sqlx_repository_restore_base(dst, packed->data, packed->len - 8,
+			TRUE);
+	g_assert_error (err, GQ(), CODE_BAD_REQUEST);
+	g_clear_error (&err);
+	g_assert_cmpint(_count_contents(dst, "stale-0"), ==, 1);
+	err = sqlx_repository_restore_base(dst, packed->data, packed->len, TRUE);
+	g_assert_no_error (err);
+	g_assert_cmpint(_count_contents(dst, "stale-0"), ==, 0);
+	g_assert_cmpint(_count_contents(dst, "content-1023"), ==, 1);
+
+	g_free(inflated);
+	g_byte_array_unref(packed);
+	g_byte_array_unref(plain);
+	sqlx_repository_unlock_and_close_noerror(dst);
+	sqlx_repository_unlock_and_close_noerror(sq3);
+	sqlx_repository_clean(repo);
+	g_free(tmpdir);
+	g_free(basedir);
+}
+
 int
 main(int argc, char **argv)
 {
 	HC_TEST_INIT(argc,argv);
 	g_test_add_func("/sqliterepo/init", test_init);
 	g_test_add_func("/sqliterepo/open", test_open_close);
+	g_test_add_func("/sqliterepo/statements", test_statements);
+	g_test_add_func("/sqliterepo/delta", test_delta);
+	g_test_add_func("/sqliterepo/dump/compressed", test_dump_compressed);
 	return g_test_run();
 }
@@ -0,0 +1,362 @@
+/*
+OpenIO SDS unit tests
+Copyright (C) 2025 OVH SAS
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 3.0 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+*/
+
+#include <glib.h>
+#include <zookeeper.h>
+
+#include <metautils/lib/metautils.h>
+
+/* The batches are checked against a fake ZK client */
+static int _fake_state(zhandle_t *zh);
+static int _fake_acreate(zhandle_t *zh, const char *path, const char *value,
+		int valuelen, const struct ACL_vector *acl, int mode,
+		string_completion_t completion, const void *data);
+static int _fake_adelete(zhandle_t *zh, const char *path, int version,
+		void_completion_t completion, const void *data);
+static int _fake_awget_children(zhandle_t *zh, const char *path,
+		watcher_fn watcher, void* watcherCtx,
+		strings_completion_t completion, const void *data);
+static int _fake_amulti(zhandle_t *zh, int count, const zoo_op_t *ops,
+		zoo_op_result_t *results, void_completion_t completion,
+		const void *data);
+
+#define zoo_state _fake_state
+#define zoo_acreate _fake_acreate
+#define zoo_adelete _fake_adelete
+#define zoo_awget_children _fake_awget_children
+#define zoo_amulti _fake_amulti
+#include "../../sqliterepo/synchro.c"
+
+#define NB_RESULTS 64
+
+static GMutex lock = {0};
+static GCond cond = {0};
+
+/* What the fake ZK client does */
+static int state = ZOO_CONNECTED_STATE;
+static int multi_rc = ZOK;
+static int multi_culprit = -1;
+
+/* What the fake ZK client has seen */
+static GArray *multi_sizes = NULL;
+static gint64 multi_when = 0;
+static guint nb_single = 0;
+static guint nb_list = 0;
+
+/* The results of the completions, indexed by their data */
+static int results[NB_RESULTS];
+static guint nb_completed = 0;
+
+static void
+_record(const void *data, int zrc)
+{
+	const guint i = GPOINTER_TO_UINT(data);
+	g_assert_cmpuint(i, <, NB_RESULTS);
+	g_mutex_lock(&lock);
+	results[i] = zrc;
+	nb_completed ++;
+	g_cond_broadcast(&cond);
+	g_mutex_unlock(&lock);
+}
+
+static void
+_on_create(int zrc, const char *path UNUSED, const void *data)
+{
+	_record(data, zrc);
+}
+
+static void
+_on_delete(int zrc, const void *data)
+{
+	_record(data, zrc);
+}
+
+static void
+_on_list(int zrc, const struct String_vector *sv UNUSED, const void *data)
+{
+	_record(data, zrc);
+}
+
+static gboolean
+_wait_completed(guint expected)
+{
+	const gint64 deadline = g_get_monotonic_time() + 5 * G_TIME_SPAN_SECOND;
+	g_mutex_lock(&lock);
+	while (nb_completed < expected) {
+		if (!g_cond_wait_until(&cond, &lock, deadline))
+			break;
+	}
+	const gboolean rc = nb_completed >= expected;
+	g_mutex_unlock(&lock);
+	return rc;
+}
+
+static int
+_fake_state(zhandle_t *zh UNUSED)
+{
+	return state;
+}
+
+static int
+_fake_acreate(zhandle_t *zh UNUSED, const char *path, const char *value UNUSED,
+		int valuelen UNUSED, const struct ACL_vector *acl UNUSED,
+		int mode UNUSED, string_completion_t completion, const void *data)
+{
+	g_mutex_lock(&lock);
+	nb_single ++;
+	g_mutex_unlock(&lock);
+	completion(ZOK, path, data);
+	return ZOK;
+}
+
+static int
+_fake_adelete(zhandle_t *zh UNUSED, const char *path UNUSED,
+		int version UNUSED, void_completion_t completion, const void *data)
+{
+	g_mutex_lock(&lock);
+	nb_single ++;
+	g_mutex_unlock(&lock);
+	completion(ZOK, data);
+	return ZOK;
+}
+
+static int
+_fake_awget_children(zhandle_t *zh UNUSED, const char *path UNUSED,
+		watcher_fn watcher UNUSED, void* watcherCtx UNUSED,
+		strings_completion_t completion, const void *data)
+{
+	struct String_vector sv = {0, NULL};
+	g_mutex_lock(&lock);
+	nb_list ++;
+	g_mutex_unlock(&lock);
+	completion(ZOK, &sv, data);
+	return ZOK;
+}
+
+/* As the ZK server does, the operations before the one failing are rolled
+ * back with ZOK, those after it with ZRUNTIMEINCONSISTENCY. */
+static int
+_fake_amulti(zhandle_t *zh UNUSED, int count, const zoo_op_t *ops,
+		zoo_op_result_t *res, void_completion_t completion, const void *data)
+{
+	int rc = multi_rc;
+	for (int i = 0; i < count; i++) {
+		res[i].err = ZOK;
+		if (ops[i].type == ZOO_CREATE_OP)
+			g_strlcpy(ops[i].create_op.buf, ops[i].create_op.path,
+					ops[i].create_op.buflen);
+		if (multi_culprit >= 0 && i == multi_culprit)
+			res[i].err = rc = ZNODEEXISTS;
+		else if (multi_culprit >= 0 && i > multi_culprit)
+			res[i].err = ZRUNTIMEINCONSISTENCY;
+	}
+	g_mutex_lock(&lock);
+	g_array_append_val(multi_sizes, count);
+	multi_when = g_get_monotonic_time();
+	g_mutex_unlock(&lock);
+	completion(rc, data);
+	return ZOK;
+}
+
+static struct sqlx_sync_s *
+_setup(gint64 delay, guint max)
+{
+	state = ZOO_CONNECTED_STATE;
+	multi_rc = ZOK;
+	multi_culprit = -1;
+	if (multi_sizes)
+		g_array_free(multi_sizes, TRUE);
+	multi_sizes = g_array_new(FALSE, FALSE, sizeof(int));
+	nb_single = nb_list = nb_completed = 0;
+	for (guint i = 0; i < NB_RESULTS; i++)
+		results[i] = ZSYSTEMERROR;
+
+	sqliterepo_zk_batch_delay = delay;
+	sqliterepo_zk_batch_max = max;
+
+	struct sqlx_sync_s *ss = sqlx_sync_create("127.0.0.1:2181");
+	g_assert_nonnull(ss);
+	sqlx_sync_set_prefix(ss, "/test");
+	sqlx_sync_set_hash(ss, 1, 1);
+	/* Never used, but the batches are enabled with a connection */
+	ss->zh = (zhandle_t *) ss;
+	ss->batch_thread = g_thread_new("zk-batch", _batch_worker, ss);
+	return ss;
+}
+
+static void
+_teardown(struct sqlx_sync_s *ss)
+{
+	_batch_stop(ss);
+	ss->zh = NULL;
+	sqlx_sync_clear(ss);
+}
+
+static void
+_create(struct sqlx_sync_s *ss, const char *path, guint id)
+{
+	int zrc = sqlx_sync_acreate(ss, path, "x", 1, ZOO_EPHEMERAL|ZOO_SEQUENCE,
+			_on_create, GUINT_TO_POINTER(id));
+	g_assert_cmpint(zrc, ==, ZOK);
+}
+
+static void
+_delete(struct sqlx_sync_s *ss, const char *path, guint id)
+{
+	int zrc = sqlx_sync_adelete(ss, path, -1, _on_delete, GUINT_TO_POINTER(id));
+	g_assert_cmpint(zrc, ==, ZOK);
+}
+
+static void
+_list(struct sqlx_sync_s *ss, const char *path, guint id)
+{
+	int zrc = sqlx_sync_awget_siblings(ss, path, NULL, NULL, _on_list,
+			GUINT_TO_POINTER(id));
+	g_assert_cmpint(zrc, ==, ZOK);
+}
+
+static void
+test_flush_on_max(void)
+{
+	struct sqlx_sync_s *ss = _setup(G_TIME_SPAN_HOUR, 4);
+	_create(ss, "A1", 1);
+	_create(ss, "A2", 2);
+	_delete(ss, "A3", 3);
+	_create(ss, "A4", 4);
+	g_assert_true(_wait_completed(4));
+	g_assert_cmpuint(multi_sizes->len, ==, 1);
+	g_assert_cmpint(g_array_index(multi_sizes, int, 0), ==, 4);
+	for (guint i = 1; i <= 4; i++)
+		g_assert_cmpint(results[i], ==, ZOK);
+
+	/* Below the max, nothing is sent before the delay... */
+	_delete(ss, "A1", 5);
+	_delete(ss, "A2", 6);
+	g_usleep(100 * G_TIME_SPAN_MILLISECOND);
+	g_mutex_lock(&lock);
+	g_assert_cmpuint(nb_completed, ==, 4);
+	g_assert_cmpuint(multi_sizes->len, ==, 1);
+	g_mutex_unlock(&lock);
+
+	/* ... or the close of the connection */
+	_teardown(ss);
+	g_assert_cmpuint(nb_completed, ==, 6);
+	g_assert_cmpuint(multi_sizes->len, ==, 2);
+	g_assert_cmpint(g_array_index(multi_sizes, int, 1), ==, 2);
+	g_assert_cmpint(results[5], ==, ZOK);
+	g_assert_cmpint(results[6], ==, ZOK);
+	g_assert_cmpuint(nb_single, ==, 0);
+}
+
+static void
+test_flush_on_delay(void)
+{
+	const gint64 delay = 50 * G_TIME_SPAN_MILLISECOND;
+	struct sqlx_sync_s *ss = _setup(delay, 100);
+	const gint64 start = g_get_monotonic_time();
+	_create(ss, "A1", 1);
+	_create(ss, "B1", 2);
+	_delete(ss, "C1", 3);
+	g_assert_true(_wait_completed(3));
+	g_assert_cmpuint(multi_sizes->len, ==, 1);
+	g_assert_cmpint(g_array_index(multi_sizes, int, 0), ==, 3);
+	g_assert_cmpint(multi_when - start, >=, delay);
+	_teardown(ss);
+	g_assert_cmpuint(multi_sizes->len, ==, 1);
+}
+
+static void
+test_replay_rolled_back(void)
+{
+	struct sqlx_sync_s *ss = _setup(G_TIME_SPAN_HOUR, 4);
+
+	/* The culprit fails, the others are replayed one by one */
+	multi_culprit = 1;
+	_create(ss, "A1", 1);
+	_create(ss, "A2", 2);
+	_delete(ss, "A3", 3);
+	_create(ss, "A4", 4);
+	g_assert_true(_wait_completed(4));
+	g_assert_cmpuint(multi_sizes->len, ==, 1);
+	g_assert_cmpint(results[1], ==, ZOK);
+	g_assert_cmpint(results[2], ==, ZNODEEXISTS);
+	g_assert_cmpint(results[3], ==, ZOK);
+	g_assert_cmpint(results[4], ==, ZOK);
+	g_assert_cmpuint(nb_single, ==, 3);
+
+	/* A system error fails the whole transaction, nothing is replayed */
+	multi_culprit = -1;
+	multi_rc = ZCONNECTIONLOSS;
+	_create(ss, "B1", 5);
+	_delete(ss, "B2", 6);
+	_create(ss, "B3", 7);
+	_delete(ss, "B4", 8);
+	g_assert_true(_wait_completed(8));
+	g_assert_cmpuint(multi_sizes->len, ==, 2);
+	for (guint i = 5; i <= 8; i++)
+		g_assert_cmpint(results[i], ==, ZCONNECTIONLOSS);
+	g_assert_cmpuint(nb_single, ==, 3);
+
+	_teardown(ss);
+}
+
+static void
+test_shared_listings(void)
+{
+	struct sqlx_sync_s *ss = _setup(G_TIME_SPAN_HOUR, 4);
+	_list(ss, "A1", 1);
+	_list(ss, "A2", 2);
+	_list(ss, "B1", 3);
+	_list(ss, "A3", 4);
+	g_assert_true(_wait_completed(4));
+	g_assert_cmpuint(nb_list, ==, 2);
+	g_assert_cmpuint(multi_sizes->len, ==, 0);
+	for (guint i = 1; i <= 4; i++)
+		g_assert_cmpint(results[i], ==, ZOK);
+	_teardown(ss);
+}
+
+static void
+test_sync_errors(void)
+{
+	struct sqlx_sync_s *ss = _setup(G_TIME_SPAN_HOUR, 4);
+
+	/* Errors known when queueing are returned, not completed */
+	state = ZOO_EXPIRED_SESSION_STATE;
+	g_assert_cmpint(ZINVALIDSTATE, ==, sqlx_sync_acreate(ss, "A1", "x", 1,
+			ZOO_EPHEMERAL, _on_create, GUINT_TO_POINTER(1)));
+	g_assert_cmpint(ZINVALIDSTATE, ==, sqlx_sync_adelete(ss, "A1", -1,
+			_on_delete, GUINT_TO_POINTER(2)));
+	state = ZOO_CONNECTED_STATE;
+
+	_teardown(ss);
+	g_assert_cmpuint(nb_completed, ==, 0);
+	g_assert_cmpuint(multi_sizes->len, ==, 0);
+}
+
+int
+main(int argc, char **argv)
+{
+	HC_TEST_INIT(argc,argv);
+	g_test_add_func("/sqliterepo/synchro/flush_on_max", test_flush_on_max);
+	g_test_add_func("/sqliterepo/synchro/flush_on_delay", test_flush_on_delay);
+	g_test_add_func("/sqliterepo/synchro/replay", test_replay_rolled_back);
+	g_test_add_func("/sqliterepo/synchro/listings", test_shared_listings);
+	g_test_add_func("/sqliterepo/synchro/sync_errors", test_sync_errors);
+	return g_test_run();
+}
@@ -17,6 +17,8 @@ You should have received a copy of the GNU Lesser General Public
 License along with this library.
 */
 
+#include <string.h>
+
 #include <metautils/lib/metautils.h>
 
 static void
@@ -187,6 +189,42 @@ test_prefix (void)
 	g_assert (!oio_str_caseprefixed("X", "Xa"));
 }
 
+static void
+_check_json(const char *in, int len, const char *expected)
+{
+	GString *gs = g_string_new("");
+	oio_str_gstring_append_json_blob(gs, in, len);
+	g_assert_cmpstr(gs->str, ==, expected);
+	g_string_free(gs, TRUE);
+}
+
+static void
+test_json (void)
+{
+	_check_json("", -1, "");
+	_check_json("plain", -1, "plain");
+	_check_json("a\"b\\c/d", -1, "a\\\"b\\\\c\\/d");
+	_check_json("\b\t\n\f\r\x01\x1f", -1, "\\b\\t\\n\\f\\r\\u0001\\u001f");
+	_check_json("h\xc3\xa9h\xc3\xa9", -1, "h\xc3\xa9h\xc3\xa9");
+	/* Invalid UTF-8 sequences are left to the client */
+	_check_json("\xff\xfe", -1, "\xff\xfe");
+	/* A bounded blob may hold NUL bytes, and end before the NUL */
+	_check_json("ab\0cd", 5, "ab\\u0000cd");
+	_check_json("abcdef", 3, "abc");
+
+	/* The escapes at any position of the words scanned at once */
+	for (guint i = 0; i < 24; i++) {
+		gchar in[32], expected[64];
+		memset(in, 'x', sizeof(in));
+		in[sizeof(in) - 1] = '\0';
+		in[i] = '"';
+		memset(expected, 'x', sizeof(expected));
+		memcpy(expected + i, "\\\"", 2);
+		expected[sizeof(in)] = '\0';
+		_check_json(in, -1, expected);
+	}
+}
+
 #define test_V_cycle(Kind,Input,Expected) do { \
 	GString *encoded = Kind##_encode_gstr(Input); \
 	g_assert_nonnull (encoded); \
@@ -245,6 +283,7 @@ main(int argc, char **argv)
 	g_test_add_func("/core/str/kv", test_KV_ok);
 	g_test_add_func("/core/str/strv", test_STRV_ok);
 	g_test_add_func("/core/str/autocontainer", test_autocontainer);
+	g_test_add_func("/core/str/json", test_json);
 
 	g_test_add_func("/metautils/str/gba", test_via_gba);
 	g_test_add_func("/metautils/str/message", test_via_message);
@@ -31,6 +31,8 @@ static void grid_main_specific_stop(void);
 // send_events.c
 extern enum event_type_e event_type;
 extern gint64 max_waiting;
+extern gboolean local_sink;
+extern gint local_events;
 
 static struct oio_directory_s *dir = NULL;
 static struct oio_url_s *rdir_rawx_url = NULL;
@@ -187,6 +189,15 @@ grid_main_get_options(void)
 			"MaxWaiting", OT_INT64, {.i64 = &max_waiting},
 			"Maximum waiting to receive a event (microseconds)"
 		},
+		{
+			"LocalSink", OT_BOOL, {.b = &local_sink},
+			"Publish to an in-process Kafka cluster instead of the namespace, "
+			"and report the rate and the latency of the delivery"
+		},
+		{
+			"LocalEvents", OT_INT, {.i = &local_events},
+			"Number of events sent with LocalSink"
+		},
 		{NULL, 0, {.i=0}, NULL}
 	};
 
@@ -205,6 +216,8 @@ static void
 grid_main_set_defaults(void)
 {
 	max_waiting = 10000000;
+	local_sink = FALSE;
+	local_events = 100000;
 }
 
 static gboolean
@@ -229,6 +242,13 @@ grid_main_configure(int argc, char **argv)
 static void
 grid_main_action(void)
 {
+	if (local_sink) {
+		if (!event_sender_run_local()) {
+			grid_main_set_status(EXIT_FAILURE);
+		}
+		return;
+	}
+
 	if (event_type == CHUNK_NEW || event_type == CHUNK_DELETED) {
 		printf("Linking fake rawx address with the fake service address...\n");
 		if (!link_rawx_fake_service()) {
@@ -312,7 +332,9 @@ grid_main_specific_fini(void)
 
 	g_usleep(G_TIME_SPAN_SECOND);
 	fake_service_stop();
-	g_thread_join(fake_service_thread);
+	if (fake_service_thread) {
+		g_thread_join(fake_service_thread);
+	}
 
 	printf("Cleaning...\n");
 
@@ -59,6 +59,8 @@ gint64 reception_time = 0;
 gint errors = 0;
 gdouble speed = 0.0;
 gint64 max_waiting = 10000000;
+gboolean local_sink = FALSE;
+gint local_events = 100000;
 
 enum event_type_e event_type = CHUNK_NEW;
 static const char *type = STORAGE_CHUNK_NEW;
@@ -305,6 +307,50 @@ event_sender_run(void)
 	}
 }
 
+gboolean
+event_sender_run_local(void)
+{
+	/* librdkafka starts a mock cluster, the address is ignored */
+	oio_var_value_one("events.kafka.options", "test.mock.num.brokers=1");
+	GError *err = event_worker_init("kafka://127.0.0.1:9092");
+	if (err) {
+		GRID_ERROR("Failed to initialize event context: (%d) %s", err->code,
+				err->message);
+		g_clear_error(&err);
+		return FALSE;
+	}
+
+	printf("Sending %d fake events to a local sink\n", local_events);
+	errors = 0;
+	const gint64 start = g_get_monotonic_time();
+	for (gint i = 0; i < local_events; i++) {
+		if (!grid_main_is_running()) {
+			return TRUE;
+		}
+		send_event();
+	}
+
+	guint64 delivered = 0;
+	gint64 now = g_get_monotonic_time();
+	while (grid_main_is_running() && now - start < max_waiting) {
+		delivered = event_worker_get_sent_events();
+		if (delivered >= (guint64) local_events) {
+			break;
+		}
+		g_usleep(10 * G_TIME_SPAN_MILLISECOND);
+		now = g_get_monotonic_time();
+	}
+
+	const gdouble elapsed = (gdouble) (now - start) / G_TIME_SPAN_SECOND;
+	printf("%"G_GUINT64_FORMAT" events delivered in %.3fs (%d errors): "
+			"%.1f events/s, %.1f us of average latency\n",
+			delivered, elapsed, errors,
+			elapsed > 0.0 ? delivered / elapsed : 0.0,
+			delivered > 0 ?
+				(gdouble) event_worker_get_send_time() / delivered : 0.0);
+	return delivered >= (guint64) local_events;
+}
+
 void
 event_sender_fini(void)
 {
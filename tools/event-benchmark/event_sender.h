@@ -25,6 +25,10 @@ gboolean event_sender_configure(char *event_type_str);
 
 gboolean event_sender_run(void);
 
+/* Send events to an in-process Kafka cluster, without any consumer, and
+ * print the rate and the latency of the publication. */
+gboolean event_sender_run_local(void);
+
 void event_sender_fini(void);
 
 #endif /* OIO_SDS__tools__benchmark_event__event_sender_h */
@@ -85,3 +85,15 @@ event_worker_send(const char *event_type, struct oio_url_s *url,
 
 	return NULL;
 }
+
+guint64
+event_worker_get_sent_events(void)
+{
+	return q ? oio_events_queue__get_total_sent_events(q) : 0;
+}
+
+guint64
+event_worker_get_send_time(void)
+{
+	return q ? oio_events_queue__get_total_send_time(q) : 0;
+}
@@ -46,4 +46,12 @@ void event_worker_destroy(void);
 GError* event_worker_send(const char *event_type, struct oio_url_s *url,
 		GString *data_json);
 
+/**
+ * Get the number of events delivered so far, and the total time they waited
+ * for their delivery (microseconds).
+ */
+guint64 event_worker_get_sent_events(void);
+
+guint64 event_worker_get_send_time(void);
+
 #endif /* OIO_SDS__tools__benchmark_event__event_worker_h */
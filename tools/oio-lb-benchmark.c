@@ -21,9 +21,80 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 
 static guint iterations = 50000;
+static guint threads = 1;
+static guint reload_period = 0;
 static const char *input_path = NULL;
 static const char *pool_descr = NULL;
 
+/* Poll from several threads while the world is reloaded in the background,
+ * and report the throughput and the worst latency of the polls. */
+static void
+_poll_concurrently(struct oio_lb_world_s *world, struct oio_lb_pool_s *pool,
+		GHashTable *counts, int *unbalanced)
+{
+	volatile gboolean running = TRUE;
+	GMutex lock;
+	g_mutex_init(&lock);
+	gint64 worst = 0;
+
+	gpointer _poller(gpointer p UNUSED) {
+		GHashTable *local = g_hash_table_new_full(
+				g_str_hash, g_str_equal, g_free, NULL);
+		int local_unbalanced = 0;
+		gint64 local_worst = 0;
+		for (guint i = 0; i < iterations / threads; i++) {
+			const gint64 pre = oio_ext_monotonic_time();
+			oio_lb_pool__poll_many(pool, 1, local, &local_unbalanced);
+			local_worst = MAX(local_worst, oio_ext_monotonic_time() - pre);
+		}
+		void _merge(gchar *id, gpointer count, gpointer u UNUSED) {
+			gint total = GPOINTER_TO_INT(g_hash_table_lookup(counts, id));
+			g_hash_table_replace(counts, g_strdup(id),
+					GINT_TO_POINTER(total + GPOINTER_TO_INT(count)));
+		}
+		g_mutex_lock(&lock);
+		g_hash_table_foreach(local, (GHFunc)_merge, NULL);
+		*unbalanced += local_unbalanced;
+		worst = MAX(worst, local_worst);
+		g_mutex_unlock(&lock);
+		g_hash_table_destroy(local);
+		return NULL;
+	}
+
+	gpointer _reloader(gpointer p UNUSED) {
+		guint reloads = 0;
+		while (running) {
+			g_usleep(reload_period * G_TIME_SPAN_MILLISECOND);
+			oio_lb_world__increment_generation(world);
+			GError *err = oio_lb_world__feed_from_file(world, "rawx", input_path);
+			if (err) {
+				GRID_WARN("Reload failure: %s", err->message);
+				g_clear_error(&err);
+			}
+			oio_lb_world__purge_old_generations(world);
+			reloads ++;
+		}
+		GRID_INFO("%u reloads", reloads);
+		return NULL;
+	}
+
+	GThread *reloader = NULL;
+	if (reload_period > 0)
+		reloader = g_thread_new("reload", _reloader, NULL);
+	GThread *pollers[threads];
+	for (guint i = 0; i < threads; i++)
+		pollers[i] = g_thread_new("poll", _poller, NULL);
+	for (guint i = 0; i < threads; i++)
+		g_thread_join(pollers[i]);
+	running = FALSE;
+	if (reloader)
+		g_thread_join(reloader);
+
+	g_mutex_clear(&lock);
+	GRID_NOTICE("%u threads, worst poll took %"G_GINT64_FORMAT"us",
+			threads, worst);
+}
+
 static void
 cli_action(void)
 {
@@ -43,7 +114,10 @@ cli_action(void)
 		GHashTable *counts = g_hash_table_new_full(
 				g_str_hash, g_str_equal, g_free, NULL);
 		gint64 start = oio_ext_monotonic_time();
-		oio_lb_pool__poll_many(pool, iterations, counts, &unbalanced);
+		if (threads > 1 || reload_period > 0)
+			_poll_concurrently(world, pool, counts, &unbalanced);
+		else
+			oio_lb_pool__poll_many(pool, iterations, counts, &unbalanced);
 		gint64 end = oio_ext_monotonic_time();
 		GRID_INFO("%d unbalanced situations on %d shots",
 				unbalanced, iterations);
@@ -51,8 +125,10 @@ cli_action(void)
 		oio_lb_world__check_repartition(world, targets, iterations, counts);
 		g_hash_table_destroy(counts);
 		double duration_seconds = (end - start) / (double) G_TIME_SPAN_SECOND;
-		GRID_NOTICE("%.3fs, %"G_GINT64_FORMAT"us per iteration",
-				duration_seconds, (end - start) / iterations);
+		GRID_NOTICE("%.3fs, %"G_GINT64_FORMAT"us per iteration, "
+				"%.0f iterations per second",
+				duration_seconds, (end - start) / iterations,
+				iterations / duration_seconds);
 	}
 	g_clear_error(&err);
 	oio_lb_pool__destroy(pool);
@@ -65,6 +141,11 @@ cli_get_options(void)
 	static struct grid_main_option_s cli_options[] = {
 		{"iterations", OT_UINT, {.u=&iterations},
 			"Number of iterations for the benchmark."},
+		{"threads", OT_UINT, {.u=&threads},
+			"Number of threads sharing the iterations."},
+		{"reload", OT_UINT, {.u=&reload_period},
+			"Reload the world from the service file every N milliseconds "
+			"while polling (0 to disable)."},
 		{NULL, 0, {.i=0}, NULL}
 	};
 
@@ -116,6 +197,7 @@ cli_configure(int argc, char **argv)
 	}
 	input_path = argv[0];
 	pool_descr = argv[1];
+	threads = MAX(threads, 1);
 	return TRUE;
 }
 